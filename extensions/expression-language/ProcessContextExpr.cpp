@@ -40,20 +40,34 @@ bool ProcessContextExpr::getProperty(const Property &property, std::string &valu
   return true;
 }
 
+expression::Expression &ProcessContextExpr::getDynamicPropertyExpression(const std::string &name) {
+  auto expression = dynamic_property_expressions_.find(name);
+  if (expression == dynamic_property_expressions_.end()) {
+    std::string expression_str;
+    ProcessContext::getDynamicProperty(name, expression_str);
+    logger_->log_debug("Compiling expression for %s/%s: %s", getProcessorNode()->getName(), name, expression_str);
+    expression = dynamic_property_expressions_.emplace(name, expression::compile(expression_str)).first;
+  }
+  return expression->second;
+}
+
 bool ProcessContextExpr::getDynamicProperty(const Property &property, std::string &value, const std::shared_ptr<FlowFile> &flow_file) {
 
   if (!property.supportsExpressionLangauge()) {
     return ProcessContext::getDynamicProperty(property.getName(), value);
   }
-  auto name = property.getName();
-  if (dynamic_property_expressions_.find(name) == dynamic_property_expressions_.end()) {
-    std::string expression_str;
-    ProcessContext::getDynamicProperty(name, expression_str);
-    logger_->log_debug("Compiling expression for %s/%s: %s", getProcessorNode()->getName(), name, expression_str);
-    dynamic_property_expressions_.emplace(name, expression::compile(expression_str));
+  minifi::expression::Parameters p(shared_from_this(), flow_file);
+  value = getDynamicPropertyExpression(property.getName())(p).asString();
+  return true;
+}
+
+bool ProcessContextExpr::getDynamicProperty(const Property &property, bool &value, const std::shared_ptr<FlowFile> &flow_file) {
+  if (!property.supportsExpressionLangauge()) {
+    return ProcessContext::getDynamicProperty(property, value, flow_file);
   }
   minifi::expression::Parameters p(shared_from_this(), flow_file);
-  value = dynamic_property_expressions_[name](p).asString();
+  auto result = getDynamicPropertyExpression(property.getName())(p);
+  value = result.isBool() ? result.asBoolean() : result.isString() && result.asString() == "true";
   return true;
 }
 
@@ -62,8 +62,15 @@ class ProcessContextExpr : public core::ProcessContext {
   virtual bool getProperty(const Property &property, std::string &value, const std::shared_ptr<FlowFile> &flow_file) override;
 
   virtual bool getDynamicProperty(const Property &property, std::string &value, const std::shared_ptr<FlowFile> &flow_file) override;
+
+  /**
+   * Evaluates the compiled expression without converting boolean results to a string.
+   */
+  virtual bool getDynamicProperty(const Property &property, bool &value, const std::shared_ptr<FlowFile> &flow_file) override;
  protected:
 
+  org::apache::nifi::minifi::expression::Expression &getDynamicPropertyExpression(const std::string &name);
+
   std::map<std::string, org::apache::nifi::minifi::expression::Expression> expressions_;
   std::map<std::string, org::apache::nifi::minifi::expression::Expression> dynamic_property_expressions_;
 
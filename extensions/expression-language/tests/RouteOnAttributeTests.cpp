@@ -15,13 +15,95 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <atomic>
+#include <chrono>
+#include <iostream>
 #include <memory>
+#include <string>
 #include "TestBase.h"
 #include <RouteOnAttribute.h>
 #include "processors/LogAttribute.h"
 #include "processors/UpdateAttribute.h"
 #include "processors/GenerateFlowFile.h"
 
+namespace {
+
+/**
+ * Takes the flow files of the routes it is connected to.
+ */
+class CountingProcessor : public core::Processor {
+ public:
+  CountingProcessor()
+      : core::Processor("CountingProcessor"),
+        count_(0) {
+  }
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override {
+    while (auto flowFile = session->get()) {
+      session->remove(flowFile);
+      count_++;
+    }
+  }
+
+  size_t count() const {
+    return count_;
+  }
+
+ private:
+  std::atomic<size_t> count_;
+};
+
+struct RouteFlow {
+  std::shared_ptr<TestPlan> plan;
+  std::shared_ptr<CountingProcessor> counter;
+};
+
+/**
+ * GenerateFlowFile -> UpdateAttribute -> RouteOnAttribute with the routes a and b matching every
+ * flow file and c none of them -> CountingProcessor taking all three routes.
+ */
+RouteFlow createFlow(TestController &testController, size_t flow_files, const std::string &strategy, size_t batch_size) {
+  RouteFlow flow;
+  flow.plan = testController.createPlan();
+  auto generate = flow.plan->addProcessor("GenerateFlowFile", "generate");
+  flow.plan->setProperty(generate, minifi::processors::GenerateFlowFile::BatchSize.getName(), std::to_string(flow_files));
+  flow.plan->setProperty(generate, minifi::processors::GenerateFlowFile::FileSize.getName(), "0 B");
+
+  auto update = flow.plan->addProcessor("UpdateAttribute", "update", core::Relationship("success", "description"), true);
+  flow.plan->setProperty(update, minifi::processors::UpdateAttribute::BatchSize.getName(), std::to_string(batch_size));
+  flow.plan->setProperty(update, "flag", "true", true);
+
+  auto route = flow.plan->addProcessor("RouteOnAttribute", "route", core::Relationship("success", "description"), true);
+  route->setAutoTerminatedRelationships({ core::Relationship("unmatched", "description") });
+  flow.plan->setProperty(route, minifi::processors::RouteOnAttribute::RoutingStrategy.getName(), strategy);
+  flow.plan->setProperty(route, minifi::processors::RouteOnAttribute::BatchSize.getName(), std::to_string(batch_size));
+  flow.plan->setProperty(route, "a", "${flag}", true);
+  flow.plan->setProperty(route, "b", "${flag:equals('true')}", true);
+  flow.plan->setProperty(route, "c", "${flag:equals('false')}", true);
+
+  flow.counter = std::make_shared<CountingProcessor>();
+  flow.plan->addProcessor(flow.counter, "counter", { core::Relationship("a", "description"), core::Relationship("b", "description"), core::Relationship("c", "description") }, true);
+  return flow;
+}
+
+/**
+ * Runs the flow until the counter took expected flow files and returns how long it took.
+ */
+double runFlow(RouteFlow &flow, size_t expected) {
+  auto start = std::chrono::steady_clock::now();
+  flow.plan->runNextProcessor();  // GenerateFlowFile
+  for (size_t i = 0; i <= expected && flow.counter->count() < expected; i++) {
+    flow.plan->runNextProcessor();  // UpdateAttribute
+    flow.plan->runNextProcessor();  // RouteOnAttribute
+    flow.plan->runNextProcessor();  // CountingProcessor
+    flow.plan->reset();
+    flow.plan->runNextProcessor([](const std::shared_ptr<core::ProcessContext>, const std::shared_ptr<core::ProcessSession>) {});  // skip GenerateFlowFile
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
 TEST_CASE("RouteOnAttributeMatchedTest", "[routeOnAttributeMatchedTest]") {
   TestController testController;
 
@@ -90,3 +172,33 @@ TEST_CASE("RouteOnAttributeUnmatchedTest", "[routeOnAttributeUnmatchedTest]") {
 
   LogTestController::getInstance().reset();
 }
+
+TEST_CASE("RouteOnAttributeRoutesToEveryMatch", "[routeOnAttributeEveryMatch]") {
+  TestController testController;
+  auto flow = createFlow(testController, 10, minifi::processors::RouteOnAttribute::ROUTE_TO_PROPERTY_NAME, 100);
+
+  runFlow(flow, 20);
+  // the flow files and one clone of each go to a and b
+  REQUIRE(20U == flow.counter->count());
+}
+
+TEST_CASE("RouteOnAttributeRoutesToFirstMatch", "[routeOnAttributeFirstMatch]") {
+  TestController testController;
+  auto flow = createFlow(testController, 10, minifi::processors::RouteOnAttribute::ROUTE_TO_FIRST_MATCH, 3);
+
+  // batches smaller than the flow files generated at once
+  runFlow(flow, 10);
+  REQUIRE(10U == flow.counter->count());
+}
+
+TEST_CASE("RouteOnAttributeBenchmark", "[routeOnAttributeBenchmark][.][benchmark]") {
+  LogTestController::getInstance().setError<minifi::processors::UpdateAttribute>();
+  const size_t count = 5000;
+  for (size_t batch_size : {1, 100}) {
+    TestController testController;
+    auto flow = createFlow(testController, count, minifi::processors::RouteOnAttribute::ROUTE_TO_FIRST_MATCH, batch_size);
+    const double time = runFlow(flow, count);
+    REQUIRE(count == flow.counter->count());
+    std::cout << "UpdateAttribute and RouteOnAttribute with batches of " << batch_size << ": " << count / time << " flow files/s" << std::endl;
+  }
+}
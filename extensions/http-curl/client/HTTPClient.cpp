@@ -32,6 +32,30 @@ namespace nifi {
 namespace minifi {
 namespace utils {
 
+HTTPConnectionCache::HTTPConnectionCache() {
+  share_ = curl_share_init();
+  curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &HTTPConnectionCache::lock);
+  curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &HTTPConnectionCache::unlock);
+  curl_share_setopt(share_, CURLSHOPT_USERDATA, static_cast<void*>(this));
+#if CURL_AT_LEAST_VERSION(7, 57, 0)
+  curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+  curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+  curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+}
+
+HTTPConnectionCache::~HTTPConnectionCache() {
+  curl_share_cleanup(share_);
+}
+
+void HTTPConnectionCache::lock(CURL *handle, curl_lock_data data, curl_lock_access access, void *cache) {
+  static_cast<HTTPConnectionCache*>(cache)->mutexes_[data].lock();
+}
+
+void HTTPConnectionCache::unlock(CURL *handle, curl_lock_data data, void *cache) {
+  static_cast<HTTPConnectionCache*>(cache)->mutexes_[data].unlock();
+}
+
 HTTPClient::HTTPClient(const std::string &url, const std::shared_ptr<minifi::controllers::SSLContextService> ssl_context_service)
     : core::Connectable("HTTPClient"),
       ssl_context_service_(ssl_context_service),
@@ -46,6 +70,8 @@ HTTPClient::HTTPClient(const std::string &url, const std::shared_ptr<minifi::con
       read_callback_(INT_MAX),
       header_response_(-1),
       res(CURLE_OK),
+      multi_(nullptr),
+      streaming_download_(false),
       keep_alive_probe_(-1),
       keep_alive_idle_(-1),
       logger_(logging::LoggerFactory<HTTPClient>::getLogger()) {
@@ -66,6 +92,8 @@ HTTPClient::HTTPClient(std::string name, utils::Identifier uuid)
       read_callback_(INT_MAX),
       header_response_(-1),
       res(CURLE_OK),
+      multi_(nullptr),
+      streaming_download_(false),
       keep_alive_probe_(-1),
       keep_alive_idle_(-1),
       logger_(logging::LoggerFactory<HTTPClient>::getLogger()) {
@@ -86,6 +114,8 @@ HTTPClient::HTTPClient()
       read_callback_(INT_MAX),
       header_response_(-1),
       res(CURLE_OK),
+      multi_(nullptr),
+      streaming_download_(false),
       keep_alive_probe_(-1),
       keep_alive_idle_(-1),
       logger_(logging::LoggerFactory<HTTPClient>::getLogger()) {
@@ -93,6 +123,11 @@ HTTPClient::HTTPClient()
 }
 
 HTTPClient::~HTTPClient() {
+  if (multi_ != nullptr) {
+    curl_multi_remove_handle(multi_, http_session_);
+    curl_multi_cleanup(multi_);
+    multi_ = nullptr;
+  }
   if (nullptr != headers_) {
     curl_slist_free_all(headers_);
     headers_ = nullptr;
@@ -275,7 +310,7 @@ void HTTPClient::setUseChunkedEncoding() {
   headers_ = curl_slist_append(headers_, "Transfer-Encoding: chunked");
 }
 
-bool HTTPClient::submit() {
+bool HTTPClient::prepareRequest() {
   if (IsNullOrEmpty(url_))
     return false;
   if (connect_timeout_ > 0) {
@@ -289,7 +324,7 @@ bool HTTPClient::submit() {
 
   curl_easy_setopt(http_session_, CURLOPT_URL, url_.c_str());
   logger_->log_debug("Submitting to %s", url_);
-  if (callback == nullptr) {
+  if (callback == nullptr && !streaming_download_) {
     content_.ptr = &read_callback_;
     curl_easy_setopt(http_session_, CURLOPT_WRITEFUNCTION, &utils::HTTPRequestResponse::recieve_write);
     curl_easy_setopt(http_session_, CURLOPT_WRITEDATA, static_cast<void*>(&content_));
@@ -307,7 +342,10 @@ bool HTTPClient::submit() {
     logger_->log_debug("Not using keep alive");
     curl_easy_setopt(http_session_, CURLOPT_TCP_KEEPALIVE, 0L);
   }
-  res = curl_easy_perform(http_session_);
+  return true;
+}
+
+bool HTTPClient::finishRequest() {
   if (callback == nullptr) {
     read_callback_.close();
   }
@@ -322,6 +360,83 @@ bool HTTPClient::submit() {
   return true;
 }
 
+bool HTTPClient::submit() {
+  if (!prepareRequest()) {
+    return false;
+  }
+  res = curl_easy_perform(http_session_);
+  return finishRequest();
+}
+
+bool HTTPClient::start() {
+  if (multi_ != nullptr || !prepareRequest()) {
+    return false;
+  }
+  multi_ = curl_multi_init();
+  if (multi_ == nullptr || curl_multi_add_handle(multi_, http_session_) != CURLM_OK) {
+    logger_->log_error("Could not start request to %s", url_);
+    if (multi_ != nullptr) {
+      curl_multi_cleanup(multi_);
+      multi_ = nullptr;
+    }
+    return false;
+  }
+  return true;
+}
+
+bool HTTPClient::poll(int timeout_ms) {
+  if (multi_ == nullptr) {
+    return false;
+  }
+  int running = 0;
+  CURLMcode multi_result = curl_multi_perform(multi_, &running);
+  if (multi_result == CURLM_OK && running > 0) {
+    multi_result = curl_multi_wait(multi_, nullptr, 0, timeout_ms, nullptr);
+    if (multi_result == CURLM_OK) {
+      multi_result = curl_multi_perform(multi_, &running);
+    }
+  }
+  if (multi_result == CURLM_OK && running > 0) {
+    return true;
+  }
+
+  res = CURLE_FAILED_INIT;
+  if (multi_result != CURLM_OK) {
+    logger_->log_error("Request to %s failed: %s", url_, curl_multi_strerror(multi_result));
+  }
+  int queued = 0;
+  while (CURLMsg *message = curl_multi_info_read(multi_, &queued)) {
+    if (message->msg == CURLMSG_DONE && message->easy_handle == http_session_) {
+      res = message->data.result;
+    }
+  }
+  curl_multi_remove_handle(multi_, http_session_);
+  curl_multi_cleanup(multi_);
+  multi_ = nullptr;
+  finishRequest();
+  return false;
+}
+
+void HTTPClient::resume() {
+  curl_easy_pause(http_session_, CURLPAUSE_CONT);
+}
+
+void HTTPClient::setUploadFunction(curl_read_callback function, void *data) {
+  curl_easy_setopt(http_session_, CURLOPT_READFUNCTION, function);
+  curl_easy_setopt(http_session_, CURLOPT_READDATA, data);
+}
+
+void HTTPClient::setDownloadFunction(curl_write_callback function, void *data) {
+  streaming_download_ = true;
+  curl_easy_setopt(http_session_, CURLOPT_WRITEFUNCTION, function);
+  curl_easy_setopt(http_session_, CURLOPT_WRITEDATA, data);
+}
+
+void HTTPClient::setConnectionCache(const std::shared_ptr<HTTPConnectionCache> &connection_cache) {
+  connection_cache_ = connection_cache;
+  curl_easy_setopt(http_session_, CURLOPT_SHARE, connection_cache_ != nullptr ? connection_cache_->getHandle() : nullptr);
+}
+
 CURLcode HTTPClient::getResponseResult() {
   return res;
 }
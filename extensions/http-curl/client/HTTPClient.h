@@ -40,6 +40,8 @@
 #include <regex.h>
 #endif
 #include <vector>
+#include <memory>
+#include <mutex>
 
 #include "utils/ByteArrayCallback.h"
 #include "controllers/SSLContextService.h"
@@ -54,6 +56,33 @@ namespace nifi {
 namespace minifi {
 namespace utils {
 
+/**
+ * Purpose: Shares connections, DNS lookups and TLS sessions between the HTTPClients it is set on,
+ * so that consecutive requests to the same host reuse a kept alive connection instead of
+ * connecting again for every request.
+ */
+class HTTPConnectionCache {
+ public:
+  HTTPConnectionCache();
+
+  ~HTTPConnectionCache();
+
+  CURLSH *getHandle() {
+    return share_;
+  }
+
+ private:
+  static void lock(CURL *handle, curl_lock_data data, curl_lock_access access, void *cache);
+
+  static void unlock(CURL *handle, curl_lock_data data, void *cache);
+
+  CURLSH *share_;
+  std::mutex mutexes_[CURL_LOCK_DATA_LAST];
+
+  HTTPConnectionCache(const HTTPConnectionCache &other) = delete;
+  HTTPConnectionCache &operator=(const HTTPConnectionCache &other) = delete;
+};
+
 /**
  * Purpose and Justification: Pull the basics for an HTTPClient into a self contained class. Simply provide
  * the URL and an SSLContextService ( can be null).
@@ -105,6 +134,40 @@ class HTTPClient : public BaseHTTPClient, public core::Connectable {
 
   bool submit() override;
 
+  /**
+   * Starts the request without blocking. The request only makes progress while poll() is called,
+   * on the calling thread.
+   * @return false if the request could not be started
+   */
+  bool start();
+
+  /**
+   * Runs the started request until the transfer blocks or timeout_ms elapses.
+   * @return true while the request is running, false once it has finished
+   */
+  bool poll(int timeout_ms);
+
+  /**
+   * Resumes a transfer paused by an upload or download function returning CURL_READFUNC_PAUSE
+   * or CURL_WRITEFUNC_PAUSE.
+   */
+  void resume();
+
+  /**
+   * Sets the function libcurl pulls the request body from, instead of an HTTPUploadCallback.
+   */
+  void setUploadFunction(curl_read_callback function, void *data);
+
+  /**
+   * Sets the function libcurl pushes the response body to, instead of an HTTPReadCallback.
+   */
+  void setDownloadFunction(curl_write_callback function, void *data);
+
+  /**
+   * Shares connections with the other clients using the cache.
+   */
+  void setConnectionCache(const std::shared_ptr<HTTPConnectionCache> &connection_cache);
+
   CURLcode getResponseResult();
 
   int64_t &getResponseCode() override;
@@ -224,6 +287,10 @@ class HTTPClient : public BaseHTTPClient, public core::Connectable {
 
   void configure_secure_connection(CURL *http_session);
 
+  bool prepareRequest();
+
+  bool finishRequest();
+
   bool isSecure(const std::string &url);
 
   HTTPReadCallback content_;
@@ -246,6 +313,13 @@ class HTTPClient : public BaseHTTPClient, public core::Connectable {
 
   CURL *http_session_;
 
+  // set while a request started by start() is running
+  CURLM *multi_;
+
+  bool streaming_download_;
+
+  std::shared_ptr<HTTPConnectionCache> connection_cache_;
+
   std::string method_;
 
   long keep_alive_probe_;
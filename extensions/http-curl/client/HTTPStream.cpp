@@ -18,34 +18,59 @@
 
 #include "HTTPStream.h"
 
-#include <fstream>
+#include <algorithm>
+#include <cstring>
 #include <vector>
 #include <memory>
 #include <string>
 
-#include "HTTPCallback.h"
 #include "io/validation.h"
-#include "io/NonConvertingStream.h"
 namespace org {
 namespace apache {
 namespace nifi {
 namespace minifi {
 namespace io {
 
+namespace {
+
+// writes smaller than this are gathered in the staging buffer
+const size_t DIRECT_WRITE_SIZE = 4096;
+const size_t STAGING_BUFFER_SIZE = 64 * 1024;
+// the download is paused while this much received data has not been read
+const size_t RECEIVE_BUFFER_SIZE = 66560;
+const int POLL_TIMEOUT_MS = 1000;
+
+}  // namespace
+
 HttpStream::HttpStream(std::shared_ptr<utils::HTTPClient> client)
     : http_client_(client),
       written(0),
-      // given the nature of the stream we don't want to slow libCURL, we will produce
-      // a warning instead allowing us to adjust it server side or through the local configuration.
-      http_read_callback_(66560, true),
       started_(false),
+      finished_(false),
+      uploading_(false),
+      upload_closed_(false),
+      pending_(nullptr),
+      pending_size_(0),
+      received_pos_(0),
       logger_(logging::LoggerFactory<HttpStream>::getLogger()) {
-  // submit early on
+  staging_.reserve(STAGING_BUFFER_SIZE);
 }
 
 void HttpStream::closeStream() {
-  http_callback_.close();
-  http_read_callback_.close();
+  if (!uploading_ || upload_closed_) {
+    return;
+  }
+  flush();
+  upload_closed_ = true;
+  if (!started_) {
+    // nothing was written, send an empty body
+    started_ = http_client_->start();
+  } else {
+    http_client_->resume();
+  }
+  while (started_ && !finished_ && http_client_->poll(POLL_TIMEOUT_MS)) {
+  }
+  finished_ = true;
 }
 
 void HttpStream::seek(uint64_t offset) {
@@ -63,22 +88,121 @@ int HttpStream::writeData(std::vector<uint8_t> &buf, int buflen) {
 // data stream overrides
 
 int HttpStream::writeData(uint8_t *value, int size) {
-  if (!IsNullOrEmpty(value)) {
-    if (!started_) {
-      std::lock_guard<std::mutex> lock(mutex_);
-      if (!started_) {
-        callback_.ptr = &http_callback_;
-        callback_.pos = 0;
-        http_client_->setUploadCallback(&callback_);
-        http_client_future_ = std::async(std::launch::async, submit_client, http_client_);
-        started_ = true;
-      }
+  if (IsNullOrEmpty(value) || size < 0 || upload_closed_ || finished_) {
+    return -1;
+  }
+  if (!uploading_) {
+    uploading_ = true;
+    http_client_->setUploadFunction(&HttpStream::upload, static_cast<void*>(this));
+  }
+  if (static_cast<size_t>(size) < DIRECT_WRITE_SIZE) {
+    if (staging_.size() + size > STAGING_BUFFER_SIZE && !flush()) {
+      return -1;
     }
-    http_callback_.process(value, size);
-    return size;
-  } else {
+    staging_.insert(staging_.end(), value, value + size);
+  } else if (!flush() || !send(value, size)) {
     return -1;
   }
+  written += size;
+  return size;
+}
+
+bool HttpStream::flush() {
+  if (staging_.empty()) {
+    return true;
+  }
+  bool sent = send(staging_.data(), staging_.size());
+  staging_.clear();
+  return sent;
+}
+
+bool HttpStream::send(const uint8_t *data, size_t size) {
+  pending_ = data;
+  pending_size_ = size;
+  if (!started_) {
+    if (!http_client_->start()) {
+      finished_ = true;
+    }
+    started_ = true;
+  } else {
+    http_client_->resume();
+  }
+  while (pending_size_ > 0 && !finished_) {
+    if (!http_client_->poll(POLL_TIMEOUT_MS)) {
+      finished_ = true;
+    }
+  }
+  bool sent = pending_size_ == 0;
+  if (!sent) {
+    logger_->log_warn("Request to %s finished before its body was sent", http_client_->getURL());
+  }
+  pending_ = nullptr;
+  pending_size_ = 0;
+  return sent;
+}
+
+size_t HttpStream::upload(char *buffer, size_t size, size_t nitems, void *stream) {
+  HttpStream *http_stream = static_cast<HttpStream*>(stream);
+  if (http_stream->pending_size_ == 0) {
+    // a zero length read ends the body
+    return http_stream->upload_closed_ ? 0 : CURL_READFUNC_PAUSE;
+  }
+  size_t len = std::min(size * nitems, http_stream->pending_size_);
+  std::memcpy(buffer, http_stream->pending_, len);
+  http_stream->pending_ += len;
+  http_stream->pending_size_ -= len;
+  return len;
+}
+
+size_t HttpStream::download(char *data, size_t size, size_t nmemb, void *stream) {
+  HttpStream *http_stream = static_cast<HttpStream*>(stream);
+  if (http_stream->available() >= RECEIVE_BUFFER_SIZE) {
+    // libcurl keeps the data and delivers it again once resumed
+    return CURL_WRITEFUNC_PAUSE;
+  }
+  if (http_stream->received_pos_ == http_stream->received_.size()) {
+    http_stream->received_.clear();
+    http_stream->received_pos_ = 0;
+  }
+  http_stream->received_.insert(http_stream->received_.end(), data, data + size * nmemb);
+  return size * nmemb;
+}
+
+bool HttpStream::startDownload() {
+  if (!started_) {
+    http_client_->setDownloadFunction(&HttpStream::download, static_cast<void*>(this));
+    if (!http_client_->start()) {
+      finished_ = true;
+    }
+    started_ = true;
+  }
+  return !finished_ || available() > 0;
+}
+
+void HttpStream::receive(int timeout_ms) {
+  if (finished_) {
+    return;
+  }
+  http_client_->resume();
+  if (!http_client_->poll(timeout_ms)) {
+    finished_ = true;
+  }
+}
+
+bool HttpStream::isFinished(int seconds) {
+  if (startDownload() && available() == 0) {
+    receive(seconds * 1000);
+  }
+  return finished_ && available() == 0;
+}
+
+bool HttpStream::waitForDataAvailable() {
+  startDownload();
+  while (available() == 0 && !finished_) {
+    logger_->log_trace("Waiting for more data");
+    receive(POLL_TIMEOUT_MS);
+  }
+  return available() > 0;
 }
 
 template<typename T>
@@ -102,22 +226,25 @@ int HttpStream::readData(std::vector<uint8_t> &buf, int buflen) {
 }
 
 int HttpStream::readData(uint8_t *buf, int buflen) {
-  if (!IsNullOrEmpty(buf)) {
-    if (!started_) {
-      std::lock_guard<std::mutex> lock(mutex_);
-      if (!started_) {
-        read_callback_.ptr = &http_read_callback_;
-        read_callback_.pos = 0;
-        http_client_->setReadCallback(&read_callback_);
-        http_client_future_ = std::async(std::launch::async, submit_read_client, http_client_, &http_read_callback_);
-        started_ = true;
+  if (IsNullOrEmpty(buf) || buflen < 0) {
+    return -1;
+  }
+  startDownload();
+  size_t read = 0;
+  while (read < static_cast<size_t>(buflen)) {
+    if (available() == 0) {
+      if (finished_) {
+        break;
       }
+      receive(POLL_TIMEOUT_MS);
+      continue;
     }
-    return http_read_callback_.readFully((char*) buf, buflen);
-
-  } else {
-    return -1;
+    size_t len = std::min(available(), buflen - read);
+    std::memcpy(buf + read, received_.data() + received_pos_, len);
+    received_pos_ += len;
+    read += len;
   }
+  return read;
 }
 
 } /* namespace io */
@@ -125,4 +252,3 @@ int HttpStream::readData(uint8_t *buf, int buflen) {
 } /* namespace nifi */
 } /* namespace apache */
 } /* namespace org */
-
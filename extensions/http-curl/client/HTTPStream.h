@@ -19,12 +19,8 @@
 #define EXTENSIONS_HTTP_CURL_CLIENT_HTTPSTREAM_H_
 
 #include <memory>
-#include <thread>
-#include <mutex>
-#include <future>
 #include <vector>
 
-#include "HTTPCallback.h"
 #include "io/BaseStream.h"
 #include "HTTPClient.h"
 
@@ -34,6 +30,15 @@ namespace nifi {
 namespace minifi {
 namespace io {
 
+/**
+ * Purpose: Streams the body of a request to, or the body of a response from, an HTTPClient.
+ *
+ * Design: The request runs on the thread using the stream. Writes hand their buffer to libcurl
+ * and drive the request until libcurl has taken all of it, so large writes are not copied before
+ * being sent; small writes are gathered into a staging buffer first so that they do not each
+ * become a chunk on the wire. Reads drive the request until libcurl has delivered data. Between
+ * calls the transfer is paused, which keeps the connection open without a thread waiting on it.
+ */
 class HttpStream : public io::BaseStream {
  public:
   /**
@@ -46,32 +51,31 @@ class HttpStream : public io::BaseStream {
     forceClose();
   }
 
+  /**
+   * Finishes the request body of an upload and waits for the response.
+   */
   virtual void closeStream() override;
 
   const std::shared_ptr<utils::HTTPClient> &getClientRef() {
     return http_client_;
   }
 
+  /**
+   * Returns the client, whose response is available once closeStream() returned or the
+   * response was read completely.
+   */
   const std::shared_ptr<utils::HTTPClient> &getClient() {
-    http_client_future_.get();
     return http_client_;
   }
 
+  /**
+   * Abandons a running request.
+   */
   void forceClose() {
-    if (started_) {
-      // lock shouldn't be needed here as call paths currently guarantee
-      // flow, but we should be safe anyway.
-      std::lock_guard<std::mutex> lock(mutex_);
-      closeStream();
-      http_client_->forceClose();
-      if (http_client_future_.valid()) {
-        http_client_future_.get();
-      } else {
-        logger_->log_warn("Future status already cleared for %s, continuing", http_client_->getURL());
-      }
-
-      started_ = false;
+    if (started_ && !finished_) {
+      logger_->log_debug("Abandoning request to %s", http_client_->getURL());
     }
+    finished_ = true;
   }
   /**
    * Skip to the specified offset.
@@ -120,39 +124,16 @@ class HttpStream : public io::BaseStream {
     throw std::runtime_error("Stream does not support this operation");
   }
 
-  static bool submit_client(std::shared_ptr<utils::HTTPClient> client) {
-    if (client == nullptr)
-      return false;
-    bool submit_status = client->submit();
-    return submit_status;
-  }
-
-  static bool submit_read_client(std::shared_ptr<utils::HTTPClient> client, utils::ByteOutputCallback *callback) {
-    if (client == nullptr)
-      return false;
-    bool submit_status = client->submit();
-    callback->close();
-    return submit_status;
-  }
-
-  inline bool isFinished(int seconds = 0) {
-    if (http_client_future_.wait_for(std::chrono::seconds(seconds)) == std::future_status::ready && (http_read_callback_.getSize() == 0 && http_read_callback_.waitingOps())) {
-      return true;
-    } else {
-      return false;
-    }
-  }
+  /**
+   * Returns true once the response has been received completely and read.
+   * @param seconds time to wait for the response to make progress
+   */
+  bool isFinished(int seconds = 0);
 
   /**
    * Waits for more data to become available.
    */
-  bool waitForDataAvailable() {
-    do {
-      logger_->log_trace("Waiting for more data");
-    } while (http_client_future_.wait_for(std::chrono::seconds(0)) != std::future_status::ready && http_read_callback_.getSize() == 0);
-
-    return http_read_callback_.getSize() > 0;
-  }
+  bool waitForDataAvailable();
 
  protected:
 
@@ -165,26 +146,42 @@ class HttpStream : public io::BaseStream {
   template<typename T>
   std::vector<uint8_t> readBuffer(const T&);
 
-  void reset();
+  // libcurl read function handing out the pending buffer of the current write
+  static size_t upload(char *buffer, size_t size, size_t nitems, void *stream);
 
-  std::vector<uint8_t> array;
+  // libcurl write function appending to the received buffer
+  static size_t download(char *data, size_t size, size_t nmemb, void *stream);
 
-  std::shared_ptr<utils::HTTPClient> http_client_;
-  std::future<bool> http_client_future_;
+  // drives the request until libcurl has taken size bytes of data
+  bool send(const uint8_t *data, size_t size);
 
-  size_t written;
+  bool flush();
+
+  bool startDownload();
+
+  // drives the request until it delivers data, finishes or timeout_ms elapses
+  void receive(int timeout_ms);
 
-  std::mutex mutex_;
+  size_t available() const {
+    return received_.size() - received_pos_;
+  }
 
-  utils::HttpStreamingCallback http_callback_;
+  std::shared_ptr<utils::HTTPClient> http_client_;
 
-  utils::HTTPUploadCallback callback_;
+  size_t written;
 
-  utils::ByteOutputCallback http_read_callback_;
+  bool started_;
+  bool finished_;
+  bool uploading_;
+  // set once the request body is complete
+  bool upload_closed_;
 
-  utils::HTTPReadCallback read_callback_;
+  std::vector<uint8_t> staging_;
+  const uint8_t *pending_;
+  size_t pending_size_;
 
-  std::atomic<bool> started_;
+  std::vector<uint8_t> received_;
+  size_t received_pos_;
 
  private:
 
@@ -21,6 +21,7 @@
 #include <stdio.h>
 #include <sys/types.h>
 #include <string>
+#include <memory>
 #include <errno.h>
 #include <chrono>
 #include <set>
@@ -68,6 +69,7 @@ class HttpSiteToSiteClient : public sitetosite::SiteToSiteClient {
   HttpSiteToSiteClient(std::string name, utils::Identifier uuid = utils::Identifier())
       : SiteToSiteClient(),
         current_code(UNRECOGNIZED_RESPONSE_CODE),
+        connection_cache_(std::make_shared<utils::HTTPConnectionCache>()),
         logger_(logging::LoggerFactory<HttpSiteToSiteClient>::getLogger()) {
     peer_state_ = READY;
   }
@@ -78,6 +80,7 @@ class HttpSiteToSiteClient : public sitetosite::SiteToSiteClient {
   HttpSiteToSiteClient(std::unique_ptr<SiteToSitePeer> peer)
       : SiteToSiteClient(),
         current_code(UNRECOGNIZED_RESPONSE_CODE),
+        connection_cache_(std::make_shared<utils::HTTPConnectionCache>()),
         logger_(logging::LoggerFactory<HttpSiteToSiteClient>::getLogger()) {
     peer_ = std::move(peer);
     peer_state_ = READY;
@@ -163,6 +166,8 @@ class HttpSiteToSiteClient : public sitetosite::SiteToSiteClient {
   std::unique_ptr<utils::HTTPClient> create_http_client(const std::string &uri, const std::string &method = "POST", bool setPropertyHeaders = false) {
     std::unique_ptr<utils::HTTPClient> http_client_ = std::unique_ptr<utils::HTTPClient>(new minifi::utils::HTTPClient(uri, ssl_context_service_));
     http_client_->initialize(method, uri, ssl_context_service_);
+    // transactions, their flow files and confirmations go over the same kept alive connection
+    http_client_->setConnectionCache(connection_cache_);
     if (setPropertyHeaders) {
       if (_currentVersion >= 5) {
         // batch count, size, and duratin don't appear to be set through the interfaces.
@@ -182,6 +187,7 @@ class HttpSiteToSiteClient : public sitetosite::SiteToSiteClient {
  private:
 
   RespondCode current_code;
+  std::shared_ptr<utils::HTTPConnectionCache> connection_cache_;
   std::shared_ptr<logging::Logger> logger_;
   // Prevent default copy constructor and assignment operation
   // Only support pass by reference or pointer
@@ -0,0 +1,225 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include "TestBase.h"
+#include "client/HTTPClient.h"
+#include "client/HTTPStream.h"
+#include "CivetServer.h"
+
+namespace {
+
+/**
+ * Counts the uploaded bytes and answers with their count and sum, remembering the client
+ * ports so that tests can tell how many connections were opened.
+ */
+class CountingResponder : public CivetHandler {
+ public:
+  explicit CountingResponder(size_t download_size = 0)
+      : download_size_(download_size) {
+  }
+
+  bool handlePost(CivetServer *server, struct mg_connection *conn) {
+    recordConnection(conn);
+    const char *expect = mg_get_header(conn, "Expect");
+    if (expect != nullptr && std::string(expect) == "100-continue") {
+      mg_printf(conn, "HTTP/1.1 100 Continue\r\n\r\n");
+    }
+    std::array<uint8_t, 16384U> buf;
+    uint64_t size = 0;
+    uint64_t sum = 0;
+    int read;
+    while ((read = mg_read(conn, buf.data(), buf.size())) > 0) {
+      for (int i = 0; i < read; i++) {
+        sum += buf[i];
+      }
+      size += read;
+    }
+    const std::string response = std::to_string(size) + " " + std::to_string(sum);
+    mg_printf(conn, "HTTP/1.1 202 Accepted\r\nContent-Type: text/plain\r\nContent-Length: %zu\r\n\r\n%s", response.length(), response.c_str());
+    return true;
+  }
+
+  bool handleGet(CivetServer *server, struct mg_connection *conn) {
+    recordConnection(conn);
+    mg_printf(conn, "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nTransfer-Encoding: chunked\r\n\r\n");
+    std::vector<char> chunk(8192);
+    for (size_t sent = 0; sent < download_size_; sent += chunk.size()) {
+      const size_t len = std::min(chunk.size(), download_size_ - sent);
+      for (size_t i = 0; i < len; i++) {
+        chunk[i] = static_cast<char>((sent + i) % 251);
+      }
+      mg_send_chunk(conn, chunk.data(), len);
+    }
+    mg_send_chunk(conn, nullptr, 0U);
+    return true;
+  }
+
+  bool handleDelete(CivetServer *server, struct mg_connection *conn) {
+    recordConnection(conn);
+    mg_printf(conn, "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n");
+    return true;
+  }
+
+  size_t connections() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ports_.size();
+  }
+
+ private:
+  void recordConnection(struct mg_connection *conn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ports_.insert(mg_get_request_info(conn)->remote_port);
+  }
+
+  size_t download_size_;
+  std::mutex mutex_;
+  std::set<int> ports_;
+};
+
+std::vector<std::string> serverOptions() {
+  std::vector<std::string> options;
+  options.emplace_back("enable_keep_alive");
+  options.emplace_back("yes");
+  options.emplace_back("keep_alive_timeout_ms");
+  options.emplace_back("15000");
+  options.emplace_back("num_threads");
+  options.emplace_back("1");
+  options.emplace_back("listening_ports");
+  options.emplace_back("0");
+  return options;
+}
+
+std::shared_ptr<utils::HTTPClient> createClient(const std::string &method, const std::string &url, const std::shared_ptr<utils::HTTPConnectionCache> &cache) {
+  auto client = std::make_shared<utils::HTTPClient>();
+  client->initialize(method, url);
+  if (cache != nullptr) {
+    client->setConnectionCache(cache);
+  }
+  return client;
+}
+
+/**
+ * Uploads size bytes in writes of write_size through an HttpStream and returns the response body.
+ */
+std::string upload(const std::string &url, const std::shared_ptr<utils::HTTPConnectionCache> &cache, size_t size, size_t write_size) {
+  auto client = createClient("POST", url, cache);
+  client->setContentType("application/octet-stream");
+  client->setUseChunkedEncoding();
+  minifi::io::HttpStream stream(client);
+  std::vector<uint8_t> data(write_size);
+  for (size_t written = 0; written < size; written += write_size) {
+    const size_t len = std::min(write_size, size - written);
+    for (size_t i = 0; i < len; i++) {
+      data[i] = static_cast<uint8_t>((written + i) % 251);
+    }
+    if (stream.writeData(data.data(), len) != static_cast<int>(len)) {
+      return "";
+    }
+  }
+  stream.closeStream();
+  if (client->getResponseCode() != 202) {
+    return "";
+  }
+  const std::vector<char> &response = client->getResponseBody();
+  return std::string(response.begin(), response.end());
+}
+
+std::string expectedResponse(size_t size) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < size; i++) {
+    sum += i % 251;
+  }
+  return std::to_string(size) + " " + std::to_string(sum);
+}
+
+}  // namespace
+
+TEST_CASE("HTTPStreamUploadReusesConnection", "[httpstream1]") {
+  CivetServer server(serverOptions());
+  CountingResponder responder;
+  server.addHandler("**", responder);
+  const std::string url = "http://localhost:" + std::to_string(server.getListeningPorts().at(0)) + "/transaction";
+
+  auto cache = std::make_shared<utils::HTTPConnectionCache>();
+  // small writes are gathered, large ones are handed to libcurl as they are
+  REQUIRE(expectedResponse(100000) == upload(url, cache, 100000, 10));
+  REQUIRE(expectedResponse(300000) == upload(url, cache, 300000, 65536));
+  REQUIRE(expectedResponse(1) == upload(url, cache, 1, 1));
+
+  auto client = createClient("DELETE", url, cache);
+  REQUIRE(client->submit());
+  REQUIRE(200 == client->getResponseCode());
+
+  REQUIRE(1U == responder.connections());
+}
+
+TEST_CASE("HTTPStreamDownload", "[httpstream2]") {
+  const size_t size = 1024 * 1024 + 17;
+  CivetServer server(serverOptions());
+  CountingResponder responder(size);
+  server.addHandler("**", responder);
+  const std::string url = "http://localhost:" + std::to_string(server.getListeningPorts().at(0)) + "/flow-files";
+
+  minifi::io::HttpStream stream(createClient("GET", url, nullptr));
+  REQUIRE(false == stream.isFinished());
+  std::vector<uint8_t> buffer(10000);
+  size_t received = 0;
+  bool matches = true;
+  int read;
+  while ((read = stream.readData(buffer, buffer.size())) > 0) {
+    for (int i = 0; i < read; i++) {
+      matches &= buffer[i] == static_cast<uint8_t>((received + i) % 251);
+    }
+    received += read;
+  }
+  REQUIRE(size == received);
+  REQUIRE(matches);
+  REQUIRE(true == stream.isFinished());
+  REQUIRE(200 == stream.getClient()->getResponseCode());
+}
+
+TEST_CASE("HTTPStreamUploadBenchmark", "[httpstream3][.][benchmark]") {
+  CivetServer server(serverOptions());
+  CountingResponder responder;
+  server.addHandler("**", responder);
+  const std::string url = "http://localhost:" + std::to_string(server.getListeningPorts().at(0)) + "/transaction";
+  const size_t transfers = 50;
+  const size_t size = 1024 * 1024;
+
+  auto report = [&](const std::string &name, const std::shared_ptr<utils::HTTPConnectionCache> &cache) {
+    const size_t connections = responder.connections();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < transfers; i++) {
+      REQUIRE(expectedResponse(size) == upload(url, cache, size, 16384));
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << transfers * size / (1024.0 * 1024.0) / elapsed << " MB/s, " << transfers / elapsed << " transfers/s, "
+              << responder.connections() - connections << " connections" << std::endl;
+  };
+
+  report("without connection cache", nullptr);
+  report("with connection cache", std::make_shared<utils::HTTPConnectionCache>());
+}
@@ -69,6 +69,25 @@ class FieldMapping {
   std::map<std::string, std::map<std::string, jfieldID>> map_;
 };
 
+/**
+ * Purpose and Justification: Caches the classes and method IDs of the Java types
+ * that native methods construct. Global class references and method IDs remain valid
+ * for the lifetime of the JVM, so they are resolved once instead of on every call.
+ */
+struct JavaTypes {
+  JavaTypes()
+      : string_class_(nullptr),
+        array_list_class_(nullptr),
+        array_list_init_(nullptr),
+        array_list_add_(nullptr) {
+  }
+
+  jclass string_class_;
+  jclass array_list_class_;
+  jmethodID array_list_init_;
+  jmethodID array_list_add_;
+};
+
 typedef jint (*registerNatives_t)(JNIEnv* env, jclass clazz);
 
 jfieldID getPtrField(JNIEnv *env, jobject obj);
@@ -259,20 +278,35 @@ class JVMLoader {
       return field;
     }
 
+    // field IDs remain valid as long as the class is loaded, so the lookup is only done once per class
     jclass c = env->GetObjectClass(obj);
-    return env->GetFieldID(c, "nativePtr", "J");
+    field = env->GetFieldID(c, fn.c_str(), args.c_str());
+    env->DeleteLocalRef(c);
+    if (field != nullptr) {
+      getClassMapping().putField(className, lookup, field);
+    }
+    return field;
   }
 
   template<typename T>
   static T *getPtr(JNIEnv *env, jobject obj) {
-    jlong handle = env->GetLongField(obj, getPtrField(minifi::core::getClassName<T>(), env, obj));
+    static const std::string className = minifi::core::getClassName<T>();
+    jlong handle = env->GetLongField(obj, getPtrField(className, env, obj));
     return reinterpret_cast<T *>(handle);
   }
 
   template<typename T>
   static void setPtr(JNIEnv *env, jobject obj, T *t) {
+    static const std::string className = minifi::core::getClassName<T>();
     jlong handle = reinterpret_cast<jlong>(t);
-    env->SetLongField(obj, getPtrField(minifi::core::getClassName<T>(), env, obj), handle);
+    env->SetLongField(obj, getPtrField(className, env, obj), handle);
+  }
+
+  /**
+   * Returns the Java types native methods construct, resolved when the JVM was created.
+   */
+  const JavaTypes &getJavaTypes() const {
+    return java_types_;
   }
 
   void setBaseServicer(std::shared_ptr<JavaServicer> servicer) {
@@ -480,6 +514,11 @@ class JVMLoader {
     gClassLoader = env_->NewGlobalRef(refclazz);
     gFindClassMethod = env_->GetMethodID(classLoaderClass, "findClass", "(Ljava/lang/String;)Ljava/lang/Class;");
     minifi::jni::ThrowIf(env_);
+    java_types_.string_class_ = find_class_global(env_, "java/lang/String");
+    java_types_.array_list_class_ = find_class_global(env_, "java/util/ArrayList");
+    java_types_.array_list_init_ = env_->GetMethodID(java_types_.array_list_class_, "<init>", "(I)V");
+    java_types_.array_list_add_ = env_->GetMethodID(java_types_.array_list_class_, "add", "(Ljava/lang/Object;)Z");
+    minifi::jni::ThrowIf(env_);
     initialized_ = true;
   }
 
@@ -499,6 +538,8 @@ class JVMLoader {
   jobject gClassLoader;
   jmethodID gFindClassMethod;
 
+  JavaTypes java_types_;
+
   std::shared_ptr<JavaServicer> java_servicer_;
 
   JVMLoader()
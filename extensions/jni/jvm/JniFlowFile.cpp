@@ -102,7 +102,9 @@ JNIEXPORT jstring JNICALL Java_org_apache_nifi_processor_JniFlowFile_getAttribut
   auto ff = ptr->get();
   THROW_IF_NULL(ff, env, NO_FF_OBJECT);
   std::string value;
-  ff->getAttribute(JniStringToUTF(env, key), value);
+  if (!ff->getAttribute(JniStringToUTF(env, key), value)) {
+    return nullptr;
+  }
   return env->NewStringUTF(value.c_str());
 }
 JNIEXPORT jlong JNICALL  Java_org_apache_nifi_processor_JniFlowFile_getSize(JNIEnv *env, jobject obj) {
@@ -120,29 +122,34 @@ JNIEXPORT jstring JNICALL  Java_org_apache_nifi_processor_JniFlowFile_getUUIDStr
   return env->NewStringUTF(ff->getUUIDStr().c_str());
 }
 
-JNIEXPORT jobject JNICALL Java_org_apache_nifi_processor_JniFlowFile_getAttributes(JNIEnv *env, jobject obj) {
-
+JNIEXPORT jint JNICALL Java_org_apache_nifi_processor_JniFlowFile_getAttributeCount(JNIEnv *env, jobject obj) {
   minifi::jni::JniFlowFile *ptr = minifi::jni::JVMLoader::getInstance()->getReference<minifi::jni::JniFlowFile>(env, obj);
 
   auto ff = ptr->get();
-  jclass mapClass = env->FindClass("java/util/HashMap");
-  if (mapClass == nullptr) {
-    return nullptr;
-  }
-
-  jsize map_len = ff->getAttributes().size();
-
-  jmethodID init = env->GetMethodID(mapClass, "<init>", "(I)V");
-  jobject hashMap = env->NewObject(mapClass, init, map_len);
+  THROW_IF_NULL(ff, env, NO_FF_OBJECT);
+  return (jint) ff->getAttributes().size();
+}
 
-  jmethodID put = env->GetMethodID(mapClass, "put", "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
+JNIEXPORT jobjectArray JNICALL Java_org_apache_nifi_processor_JniFlowFile_getAttributePairs(JNIEnv *env, jobject obj) {
+  minifi::jni::JniFlowFile *ptr = minifi::jni::JVMLoader::getInstance()->getReference<minifi::jni::JniFlowFile>(env, obj);
 
-  for (auto kf : ff->getAttributes()) {
-    env->CallObjectMethod(hashMap, put, env->NewStringUTF(kf.first.c_str()), env->NewStringUTF(kf.second.c_str()));
-    minifi::jni::ThrowIf(env);
+  auto ff = ptr->get();
+  THROW_IF_NULL(ff, env, NO_FF_OBJECT);
+  const auto attributes = ff->getAttributes();
+  // keys and values alternate, so the attributes cross the boundary in a single array
+  jobjectArray pairs = env->NewObjectArray((jsize) (attributes.size() * 2), minifi::jni::JVMLoader::getInstance()->getJavaTypes().string_class_, nullptr);
+  minifi::jni::ThrowIf(env);
+  jsize index = 0;
+  for (const auto &kf : attributes) {
+    jstring key = env->NewStringUTF(kf.first.c_str());
+    jstring value = env->NewStringUTF(kf.second.c_str());
+    env->SetObjectArrayElement(pairs, index++, key);
+    env->SetObjectArrayElement(pairs, index++, value);
+    env->DeleteLocalRef(key);
+    env->DeleteLocalRef(value);
   }
 
-  return hashMap;
+  return pairs;
 }
 
 #ifdef __cplusplus
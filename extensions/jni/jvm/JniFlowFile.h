@@ -43,7 +43,8 @@ JNIEXPORT jlong JNICALL Java_org_apache_nifi_processor_JniFlowFile_getQueueDateI
 JNIEXPORT jstring JNICALL Java_org_apache_nifi_processor_JniFlowFile_getAttribute(JNIEnv *env, jobject obj, jstring key);
 JNIEXPORT jstring JNICALL Java_org_apache_nifi_processor_JniFlowFile_getUUIDStr(JNIEnv *env, jobject obj);
 JNIEXPORT jlong JNICALL Java_org_apache_nifi_processor_JniFlowFile_getSize(JNIEnv *env, jobject obj);
-JNIEXPORT jobject JNICALL Java_org_apache_nifi_processor_JniFlowFile_getAttributes(JNIEnv *env, jobject obj);
+JNIEXPORT jint JNICALL Java_org_apache_nifi_processor_JniFlowFile_getAttributeCount(JNIEnv *env, jobject obj);
+JNIEXPORT jobjectArray JNICALL Java_org_apache_nifi_processor_JniFlowFile_getAttributePairs(JNIEnv *env, jobject obj);
 
 #ifdef __cplusplus
 }
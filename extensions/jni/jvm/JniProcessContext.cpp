@@ -54,14 +54,12 @@ JNIEXPORT jobject JNICALL Java_org_apache_nifi_processor_JniProcessContext_getPr
   minifi::jni::JniProcessContext *context = minifi::jni::JVMLoader::getPtr<minifi::jni::JniProcessContext>(env, obj);
   auto cppProcessor = context->processor_;
   auto keys = cppProcessor->getProperties();
-  jclass arraylist = env->FindClass("java/util/ArrayList");
-  jmethodID init_method = env->GetMethodID(arraylist, "<init>", "(I)V");
-  jmethodID add_method = env->GetMethodID(arraylist, "add", "(Ljava/lang/Object;)Z");
-  jobject result = env->NewObject(arraylist, init_method, keys.size());
+  const auto &types = minifi::jni::JVMLoader::getInstance()->getJavaTypes();
+  jobject result = env->NewObject(types.array_list_class_, types.array_list_init_, (jint) keys.size());
   for (const auto &s : keys) {
     if (s.second.isTransient()) {
       jstring element = env->NewStringUTF(s.first.c_str());
-      env->CallBooleanMethod(result, add_method, element);
+      env->CallBooleanMethod(result, types.array_list_add_, element);
       minifi::jni::ThrowIf(env);
       env->DeleteLocalRef(element);
     }
@@ -80,7 +80,7 @@ JNIEXPORT jobject JNICALL Java_org_apache_nifi_processor_JniProcessSession_readF
 
     minifi::jni::ThrowIf(env);
 
-    std::unique_ptr<minifi::jni::JniByteInputStream> callback = std::unique_ptr<minifi::jni::JniByteInputStream>(new minifi::jni::JniByteInputStream(4096));
+    std::unique_ptr<minifi::jni::JniByteInputStream> callback = std::unique_ptr<minifi::jni::JniByteInputStream>(new minifi::jni::JniByteInputStream());
 
     session->getSession()->read(ptr->get(), callback.get());
 
@@ -97,46 +97,44 @@ JNIEXPORT jobject JNICALL Java_org_apache_nifi_processor_JniProcessSession_readF
 
 }
 
-JNIEXPORT jint JNICALL Java_org_apache_nifi_processor_JniInputStream_read(JNIEnv *env, jobject obj) {
-  minifi::jni::JniInputStream *jin = minifi::jni::JVMLoader::getPtr<minifi::jni::JniInputStream>(env, obj);
+JNIEXPORT jint JNICALL Java_org_apache_nifi_processor_JniInputStream_readDirect(JNIEnv *env, jobject obj, jobject buffer, jint length) {
   if (obj == nullptr) {
     // this technically can't happen per JNI specs
     return -1;
   }
-  char value = 0;
-  if (jin->read(value) > 0)
-    return value;
-  else
-    return -1;
-}
-
-JNIEXPORT jint JNICALL  Java_org_apache_nifi_processor_JniInputStream_readWithOffset(JNIEnv *env, jobject obj, jbyteArray arr, jint offset, jint length) {
+  THROW_IF_NULL(buffer, env, "No buffer to read into");
   minifi::jni::JniInputStream *jin = minifi::jni::JVMLoader::getPtr<minifi::jni::JniInputStream>(env, obj);
-  if (obj == nullptr) {
-    // this technically can't happen per JNI specs
+  uint8_t *address = static_cast<uint8_t*>(env->GetDirectBufferAddress(buffer));
+  if (address == nullptr || length < 0 || length > env->GetDirectBufferCapacity(buffer)) {
+    minifi::jni::ThrowJava(env, "Content can only be read into a direct buffer");
     return -1;
   }
-  return jin->read(env, arr, (int) offset, (int) length);
+  return (jint) jin->read(address, (int) length);
 }
 
-JNIEXPORT jboolean JNICALL Java_org_apache_nifi_processor_JniProcessSession_write(JNIEnv *env, jobject obj, jobject ff, jbyteArray byteArray) {
+JNIEXPORT jboolean JNICALL Java_org_apache_nifi_processor_JniProcessSession_writeDirect(JNIEnv *env, jobject obj, jobject ff, jobject buffer, jint length, jboolean append) {
   if (obj == nullptr) {
     return false;
   }
 
-  THROW_IF((ff == nullptr || byteArray == nullptr), env, "No flowfile to write");
+  THROW_IF((ff == nullptr || buffer == nullptr), env, "No flowfile to write");
 
   minifi::jni::JniSession *session = minifi::jni::JVMLoader::getPtr<minifi::jni::JniSession>(env, obj);
   minifi::jni::JniFlowFile *ptr = minifi::jni::JVMLoader::getInstance()->getReference<minifi::jni::JniFlowFile>(env, ff);
 
   if (ptr->get()) {
-    jbyte* buffer = env->GetByteArrayElements(byteArray, 0);
-    jsize length = env->GetArrayLength(byteArray);
-
-    minifi::jni::JniByteOutStream outStream(buffer, (size_t) length);
-    session->getSession()->write(ptr->get(), &outStream);
+    jbyte *address = static_cast<jbyte*>(env->GetDirectBufferAddress(buffer));
+    if (address == nullptr || length < 0 || length > env->GetDirectBufferCapacity(buffer)) {
+      minifi::jni::ThrowJava(env, "Content can only be written from a direct buffer");
+      return false;
+    }
 
-    env->ReleaseByteArrayElements(byteArray, buffer, 0);
+    minifi::jni::JniByteOutStream outStream(address, (size_t) length);
+    if (!append) {
+      session->getSession()->write(ptr->get(), &outStream);
+    } else if (length > 0) {
+      session->getSession()->append(ptr->get(), &outStream);
+    }
 
     return true;
   }
@@ -435,34 +433,6 @@ JNIEXPORT jobject JNICALL  Java_org_apache_nifi_processor_JniProcessSession_clon
 
 }
 
-JNIEXPORT jboolean JNICALL Java_org_apache_nifi_processor_JniProcessSession_append(JNIEnv *env, jobject obj, jobject ff, jbyteArray byteArray) {
-  if (obj == nullptr) {
-    // does not mean an error should be thrown, rather we will let
-    // Java do its thing as this is a condition of GC most likely
-    return false;
-  }
-  THROW_IF((ff == nullptr || byteArray == nullptr), env, NO_FF_OBJECT);
-  minifi::jni::JniSession *session = minifi::jni::JVMLoader::getPtr<minifi::jni::JniSession>(env, obj);
-  minifi::jni::JniFlowFile *ptr = minifi::jni::JVMLoader::getInstance()->getReference<minifi::jni::JniFlowFile>(env, ff);
-
-  if (ptr->get()) {
-    jbyte* buffer = env->GetByteArrayElements(byteArray, 0);
-    jsize length = env->GetArrayLength(byteArray);
-
-    if (length > 0) {
-      minifi::jni::JniByteOutStream outStream(buffer, (size_t) length);
-      session->getSession()->append(ptr->get(), &outStream);
-    }
-
-    env->ReleaseByteArrayElements(byteArray, buffer, 0);
-
-    return true;
-  }
-
-  return false;
-
-}
-
 #ifdef __cplusplus
 }
 #endif
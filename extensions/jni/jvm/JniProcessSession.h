@@ -55,7 +55,7 @@ JNIEXPORT jobject JNICALL Java_org_apache_nifi_processor_JniProcessSession_creat
 
 JNIEXPORT jobject JNICALL Java_org_apache_nifi_processor_JniProcessSession_clone(JNIEnv *env, jobject obj, jobject ff);
 
-JNIEXPORT jboolean JNICALL Java_org_apache_nifi_processor_JniProcessSession_write(JNIEnv *env, jobject obj, jobject ff, jbyteArray byteArray);
+JNIEXPORT jboolean JNICALL Java_org_apache_nifi_processor_JniProcessSession_writeDirect(JNIEnv *env, jobject obj, jobject ff, jobject buffer, jint length, jboolean append);
 
 JNIEXPORT void JNICALL Java_org_apache_nifi_processor_JniProcessSession_transfer(JNIEnv *env, jobject obj, jobject ff, jstring relationship);
 
@@ -77,11 +77,7 @@ JNIEXPORT jobject JNICALL Java_org_apache_nifi_processor_JniProcessSession_remov
 
 JNIEXPORT jobject JNICALL Java_org_apache_nifi_processor_JniProcessSession_clonePortion(JNIEnv *env, jobject obj, jobject ff, jlong offset, jlong size);
 
-JNIEXPORT jboolean JNICALL Java_org_apache_nifi_processor_JniProcessSession_append(JNIEnv *env, jobject obj, jobject ff, jbyteArray byteArray);
-
-JNIEXPORT jint JNICALL Java_org_apache_nifi_processor_JniInputStream_read(JNIEnv *env, jobject obj);
-
-JNIEXPORT jint JNICALL Java_org_apache_nifi_processor_JniInputStream_readWithOffset(JNIEnv *env, jobject obj, jbyteArray, jint offset, jint length);
+JNIEXPORT jint JNICALL Java_org_apache_nifi_processor_JniInputStream_readDirect(JNIEnv *env, jobject obj, jobject buffer, jint length);
 
 #ifdef __cplusplus
 }
@@ -116,37 +116,28 @@ class JniByteOutStream : public minifi::OutputStreamCallback {
 };
 
 /**
- * Jni byte input stream
+ * Jni byte input stream. Reads the content straight into memory Java provides
+ * as a direct ByteBuffer, so no byte array is copied across the boundary.
  */
 class JniByteInputStream : public minifi::InputStreamCallback {
  public:
-  JniByteInputStream(uint64_t size)
-      : read_size_(0),
-        stream_(nullptr) {
-    buffer_size_ = size;
-    buffer_ = new uint8_t[buffer_size_];
-  }
-  ~JniByteInputStream() {
-    if (buffer_)
-      delete[] buffer_;
+  JniByteInputStream()
+      : stream_(nullptr) {
   }
+
   int64_t process(std::shared_ptr<minifi::io::BaseStream> stream) {
     stream_ = stream;
     return 0;
   }
 
-  int64_t read(JNIEnv *env, jbyteArray arr, int offset, int size) {
+  int64_t read(uint8_t *buffer, int size) {
     if (stream_ == nullptr) {
       return -1;
     }
 
-    // seek to offset
-    int remaining = size;
-    int writtenOffset = 0;
     int read = 0;
-    do {
-
-      int actual = (int) stream_->read(buffer_, remaining <= buffer_size_ ? remaining : buffer_size_);
+    while (read < size) {
+      int actual = (int) stream_->read(buffer + read, size - read);
       if (actual <= 0) {
         if (read == 0) {
           stream_ = nullptr;
@@ -154,26 +145,13 @@ class JniByteInputStream : public minifi::InputStreamCallback {
         }
         break;
       }
-
       read += actual;
-      env->SetByteArrayRegion(arr, offset + writtenOffset, actual, (jbyte*) buffer_);
-      writtenOffset += (int) actual;
-
-      remaining -= actual;
-
-    } while (remaining > 0);
+    }
 
     return read;
   }
 
-  int64_t read(char &arr) {
-    return stream_->read(arr);
-  }
-
   std::shared_ptr<minifi::io::BaseStream> stream_;
-  uint8_t *buffer_;
-  uint64_t buffer_size_;
-  uint64_t read_size_;
 };
 
 class JniInputStream : public core::WeakReference {
@@ -196,16 +174,9 @@ class JniInputStream : public core::WeakReference {
 
   }
 
-  int64_t read(char &arr) {
-    if (!removed_) {
-      return jbi_->read(arr);
-    }
-    return -1;
-  }
-
-  int64_t read(JNIEnv *env, jbyteArray arr, int offset, int size) {
+  int64_t read(uint8_t *buffer, int size) {
     if (!removed_) {
-      return jbi_->read(env, arr, offset, size);
+      return jbi_->read(buffer, size);
     }
     return -1;
   }
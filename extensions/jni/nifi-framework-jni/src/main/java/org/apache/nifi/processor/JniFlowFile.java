@@ -43,7 +43,13 @@ public class JniFlowFile implements FlowFile {
     public native long getSize();
 
     @Override
-    public native Map<String, String> getAttributes();
+    public Map<String, String> getAttributes(){
+        return new JniFlowFileAttributes(this);
+    }
+
+    native int getAttributeCount();
+
+    native String[] getAttributePairs();
 
     @Override
     public int compareTo(FlowFile o) {
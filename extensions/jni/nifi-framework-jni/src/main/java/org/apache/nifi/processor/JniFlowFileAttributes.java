@@ -0,0 +1,53 @@
+package org.apache.nifi.processor;
+
+import java.util.AbstractMap;
+import java.util.Collections;
+import java.util.LinkedHashSet;
+import java.util.Set;
+
+/**
+ * Read only view of the attributes of a JniFlowFile. Lookups go to the native flow file,
+ * so attributes are not copied into a new map whenever a processor asks for them; they are
+ * only copied, in a single native call, when the entries are iterated.
+ */
+class JniFlowFileAttributes extends AbstractMap<String, String> {
+
+    private final JniFlowFile flowFile;
+
+    JniFlowFileAttributes(JniFlowFile flowFile){
+        this.flowFile = flowFile;
+    }
+
+    @Override
+    public String get(Object key) {
+        if (!(key instanceof String)) {
+            return null;
+        }
+        return flowFile.getAttribute((String) key);
+    }
+
+    @Override
+    public boolean containsKey(Object key) {
+        return get(key) != null;
+    }
+
+    @Override
+    public int size() {
+        return flowFile.getAttributeCount();
+    }
+
+    @Override
+    public boolean isEmpty() {
+        return size() == 0;
+    }
+
+    @Override
+    public Set<Entry<String, String>> entrySet() {
+        final String[] pairs = flowFile.getAttributePairs();
+        final Set<Entry<String, String>> entries = new LinkedHashSet<>(pairs.length);
+        for (int i = 0; i + 1 < pairs.length; i += 2) {
+            entries.add(new SimpleImmutableEntry<>(pairs[i], pairs[i + 1]));
+        }
+        return Collections.unmodifiableSet(entries);
+    }
+}
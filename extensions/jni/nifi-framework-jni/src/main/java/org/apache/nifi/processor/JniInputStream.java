@@ -2,18 +2,73 @@ package org.apache.nifi.processor;
 
 import java.io.IOException;
 import java.io.InputStream;
+import java.nio.ByteBuffer;
 
+/**
+ * Reads the content of a flow file. The native session fills a direct buffer, so content
+ * is not copied through a byte array on its way into the JVM, and single byte reads are
+ * served from the buffer rather than crossing into native code.
+ */
 public class JniInputStream extends InputStream {
 
+    private static final int BUFFER_SIZE = 64 * 1024;
+
     private long nativePtr;
 
+    private final ByteBuffer buffer = ByteBuffer.allocateDirect(BUFFER_SIZE);
+
+    private boolean exhausted = false;
+
+    public JniInputStream(){
+        buffer.limit(0);
+    }
+
     @Override
-    public native int read() throws IOException;
-/*
+    public int read() throws IOException {
+        if (!fill()) {
+            return -1;
+        }
+        return buffer.get() & 0xFF;
+    }
+
+    @Override
+    public int read(byte[] copyTo, int offset, int length) throws IOException {
+        if (offset < 0 || length < 0 || length > copyTo.length - offset) {
+            throw new IndexOutOfBoundsException();
+        }
+        if (length == 0) {
+            return 0;
+        }
+        if (!fill()) {
+            return -1;
+        }
+        final int count = Math.min(length, buffer.remaining());
+        buffer.get(copyTo, offset, count);
+        return count;
+    }
+
     @Override
-    public int read(byte[] copyTo, int offset, int length) throws IOException{
-        return readWithOffset(copyTo,offset,length);
-    }*/
+    public int available() throws IOException {
+        return buffer.remaining();
+    }
+
+    private boolean fill() throws IOException {
+        if (buffer.hasRemaining()) {
+            return true;
+        }
+        if (exhausted) {
+            return false;
+        }
+        buffer.clear();
+        final int read = readDirect(buffer, BUFFER_SIZE);
+        if (read <= 0) {
+            exhausted = true;
+            buffer.limit(0);
+            return false;
+        }
+        buffer.limit(read);
+        return true;
+    }
 
-    public native int readWithOffset(byte[] copyTo, int offset, int length) throws IOException;
+    private native int readDirect(ByteBuffer buffer, int length) throws IOException;
 }
@@ -0,0 +1,84 @@
+package org.apache.nifi.processor;
+
+import org.apache.nifi.flowfile.FlowFile;
+
+import java.io.IOException;
+import java.io.OutputStream;
+import java.nio.ByteBuffer;
+
+/**
+ * Writes the content of a flow file. Bytes are staged in a direct buffer the native session
+ * writes from, so content is not copied through a byte array on its way out of the JVM.
+ * Unless the stream appends, the first flush replaces the content and later flushes append to it.
+ */
+class JniOutputStream extends OutputStream {
+
+    private static final int BUFFER_SIZE = 64 * 1024;
+
+    private final JniProcessSession session;
+
+    private final FlowFile flowFile;
+
+    private final ByteBuffer buffer = ByteBuffer.allocateDirect(BUFFER_SIZE);
+
+    private boolean append;
+
+    private boolean closed = false;
+
+    JniOutputStream(JniProcessSession session, FlowFile flowFile, boolean append){
+        this.session = session;
+        this.flowFile = flowFile;
+        this.append = append;
+    }
+
+    @Override
+    public void write(int b) throws IOException {
+        if (!buffer.hasRemaining()) {
+            flushBuffer();
+        }
+        buffer.put((byte) b);
+    }
+
+    @Override
+    public void write(byte[] bytes, int offset, int length) throws IOException {
+        if (offset < 0 || length < 0 || length > bytes.length - offset) {
+            throw new IndexOutOfBoundsException();
+        }
+        while (length > 0) {
+            if (!buffer.hasRemaining()) {
+                flushBuffer();
+            }
+            final int count = Math.min(length, buffer.remaining());
+            buffer.put(bytes, offset, count);
+            offset += count;
+            length -= count;
+        }
+    }
+
+    @Override
+    public void flush() throws IOException {
+        if (buffer.position() > 0) {
+            flushBuffer();
+        }
+    }
+
+    @Override
+    public void close() throws IOException {
+        if (closed) {
+            return;
+        }
+        closed = true;
+        // writing nothing still replaces the content
+        if (buffer.position() > 0 || !append) {
+            flushBuffer();
+        }
+    }
+
+    private void flushBuffer() throws IOException {
+        if (!session.writeDirect(flowFile, buffer, buffer.position(), append)) {
+            throw new IOException("Could not write the content of " + flowFile);
+        }
+        append = true;
+        buffer.clear();
+    }
+}
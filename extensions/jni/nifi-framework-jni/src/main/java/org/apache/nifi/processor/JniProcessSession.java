@@ -10,6 +10,7 @@ import org.apache.nifi.processor.io.StreamCallback;
 import org.apache.nifi.provenance.ProvenanceReporter;
 
 import java.io.*;
+import java.nio.ByteBuffer;
 import java.nio.file.Files;
 import java.nio.file.Path;
 import java.util.*;
@@ -222,89 +223,51 @@ public class JniProcessSession implements ProcessSession {
 
     @Override
     public FlowFile write(FlowFile source, OutputStreamCallback writer) throws FlowFileAccessException {
-        // must write data.
-        ByteArrayOutputStream bos = new ByteArrayOutputStream();
-        try {
-            writer.process(bos);
+        try (OutputStream out = new JniOutputStream(this, source, false)) {
+            writer.process(out);
         }catch(IOException os){
             throw new FlowFileAccessException("IOException while processing ff data");
         }
-        write(source, bos.toByteArray());
 
         return source;
     }
 
     protected native JniInputStream readFlowFile(FlowFile source);
 
-    protected native boolean write(FlowFile source, byte [] array);
-
-    protected native boolean append(FlowFile source , byte [] array);
+    /**
+     * Writes length bytes of a direct buffer to the content of source, replacing it unless append is set.
+     */
+    protected native boolean writeDirect(FlowFile source, ByteBuffer buffer, int length, boolean append);
 
     @Override
     public OutputStream write(final FlowFile source) {
-        return new OutputStream() {
-            ByteArrayOutputStream bin = new ByteArrayOutputStream();
-            @Override
-            public void write(int b) throws IOException {
-                synchronized (this) {
-                    bin.write(b);
-                    // better suited to writing pages of memory
-                    if (bin.size() > 4096) {
-                        flushByterArray();
-                    }
-                }
-            }
-
-            @Override
-            public void flush() throws IOException {
-                synchronized (this) {
-                    // flush as an append.
-                    flushByterArray();
-                }
-            }
-
-
-            @Override
-            public void close() throws IOException {
-                synchronized (this) {
-                    // flush as an append.
-                    flushByterArray();
-                }
-            }
-
-            private void flushByterArray(){
-                append(source,bin.toByteArray());
-                bin = new ByteArrayOutputStream();
-            }
-
-        };
+        // flushes as an append.
+        return new JniOutputStream(this, source, true);
     }
 
     @Override
     public FlowFile write(FlowFile source, StreamCallback writer) throws FlowFileAccessException {
-        // must write data.
+        // the source is read while its content is replaced, so the new content is staged first
         ByteArrayOutputStream bos = new ByteArrayOutputStream();
         try {
             writer.process(read(source),bos);
+            try (OutputStream out = new JniOutputStream(this, source, false)) {
+                bos.writeTo(out);
+            }
         }catch(IOException os){
             throw new FlowFileAccessException("IOException while processing ff data");
         }
-        write(source, bos.toByteArray());
 
         return source;
     }
 
     @Override
     public FlowFile append(FlowFile source, OutputStreamCallback writer) throws FlowFileAccessException {
-        // must write data.
-        ByteArrayOutputStream bos = new ByteArrayOutputStream();
-        try {
-            writer.process(bos);
-            append(source,bos.toByteArray());
+        try (OutputStream out = new JniOutputStream(this, source, true)) {
+            writer.process(out);
         }catch(IOException os){
             throw new FlowFileAccessException("IOException while processing ff data");
         }
-        write(source, bos.toByteArray());
 
         return source;
     }
@@ -317,7 +280,7 @@ public class JniProcessSession implements ProcessSession {
      * @throws IOException
      */
     private static void copyData(InputStream in, OutputStream out) throws IOException {
-        byte[] buffer = new byte[1 * 1024];
+        byte[] buffer = new byte[64 * 1024];
         int len;
         while ((len = in.read(buffer)) > 0) {
             out.write(buffer, 0, len);
@@ -0,0 +1,497 @@
+/**
+ * @file ConsumeKafka.cpp
+ * ConsumeKafka class implementation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ConsumeKafka.h"
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "utils/StringUtils.h"
+#include "utils/ScopeGuard.h"
+#include "core/ProcessContext.h"
+#include "core/ProcessSession.h"
+#include "PublishKafka.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+core::Property ConsumeKafka::SeedBrokers(
+    core::PropertyBuilder::createProperty("Known Brokers")->withDescription("A comma-separated list of known Kafka Brokers in the format <host>:<port>")
+        ->isRequired(true)->build());
+
+core::Property ConsumeKafka::TopicNames(
+    core::PropertyBuilder::createProperty("Topic Names")->withDescription("A comma-separated list of the Kafka Topics to consume from")
+        ->isRequired(true)->build());
+
+core::Property ConsumeKafka::GroupID(
+    core::PropertyBuilder::createProperty("Group ID")->withDescription("The consumer group the processor is a member of. "
+                                                                       "The partitions of the topics are balanced between the members of the group.")
+        ->isRequired(true)->build());
+
+core::Property ConsumeKafka::OffsetReset(
+    core::PropertyBuilder::createProperty("Offset Reset")->withDescription("Where to start consuming a partition that has no committed offset for the group yet, "
+                                                                           "or whose committed offset no longer exists on the broker")
+        ->isRequired(true)->withAllowableValues<std::string>({OFFSET_RESET_EARLIEST, OFFSET_RESET_LATEST, OFFSET_RESET_NONE})
+        ->withDefaultValue(OFFSET_RESET_LATEST)->build());
+
+core::Property ConsumeKafka::ClientName(
+    core::PropertyBuilder::createProperty("Client Name")->withDescription("Client Name to use when communicating with Kafka")
+        ->isRequired(false)->build());
+
+core::Property ConsumeKafka::MaxPollRecords(
+    core::PropertyBuilder::createProperty("Max Poll Records")->withDescription("The maximum number of messages polled in a single batch")
+        ->isRequired(false)->withDefaultValue<uint64_t>(10000)->build());
+
+core::Property ConsumeKafka::MaxPollTime(
+    core::PropertyBuilder::createProperty("Max Poll Time")->withDescription("The maximum time to wait for a batch to fill up")
+        ->isRequired(false)->withDefaultValue<core::TimePeriodValue>("1 sec")->build());
+
+core::Property ConsumeKafka::MessageDemarcator(
+    core::PropertyBuilder::createProperty("Message Demarcator")->withDescription("If set, the messages of a batch coming from the same partition are written into a single "
+                                                                                 "FlowFile, separated by this string. Otherwise every message becomes a FlowFile of its own.")
+        ->isRequired(false)->build());
+
+core::Property ConsumeKafka::HeadersToAddAsAttributes("Headers To Add As Attributes", "Any message header whose name matches the regex is added to the FlowFile "
+                                                      "as an attribute. Only used if every message becomes a FlowFile of its own.", "");
+core::Property ConsumeKafka::SecurityProtocol("Security Protocol", "Protocol used to communicate with brokers", "");
+core::Property ConsumeKafka::SecurityCA("Security CA", "File or directory path to CA certificate(s) for verifying the broker's key", "");
+core::Property ConsumeKafka::SecurityCert("Security Cert", "Path to client's public key (PEM) used for authentication", "");
+core::Property ConsumeKafka::SecurityPrivateKey("Security Private Key", "Path to client's private key (PEM) used for authentication", "");
+core::Property ConsumeKafka::SecurityPrivateKeyPassWord("Security Pass Phrase", "Private key passphrase", "");
+core::Property ConsumeKafka::DebugContexts("Debug contexts", "A comma-separated list of debug contexts to enable."
+                                           "Including: generic, broker, topic, metadata, feature, queue, msg, protocol, cgrp, security, fetch, interceptor, plugin, consumer, admin, eos, all", "");
+
+core::Relationship ConsumeKafka::Success("success", "Every FlowFile created from the consumed messages is routed to this Relationship");
+
+void ConsumeKafka::initialize() {
+  // Set the supported properties
+  std::set<core::Property> properties;
+  properties.insert(SeedBrokers);
+  properties.insert(TopicNames);
+  properties.insert(GroupID);
+  properties.insert(OffsetReset);
+  properties.insert(ClientName);
+  properties.insert(MaxPollRecords);
+  properties.insert(MaxPollTime);
+  properties.insert(MessageDemarcator);
+  properties.insert(HeadersToAddAsAttributes);
+  properties.insert(SecurityProtocol);
+  properties.insert(SecurityCA);
+  properties.insert(SecurityCert);
+  properties.insert(SecurityPrivateKey);
+  properties.insert(SecurityPrivateKeyPassWord);
+  properties.insert(DebugContexts);
+  setSupportedProperties(properties);
+  // Set the supported relationships
+  std::set<core::Relationship> relationships;
+  relationships.insert(Success);
+  setSupportedRelationships(relationships);
+}
+
+void ConsumeKafka::onSchedule(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) {
+  std::lock_guard<std::mutex> lock(consumer_mutex_);
+  closeConsumer();
+
+  std::string value;
+  int64_t valInt;
+
+  max_poll_records_ = 10000;
+  value = "";
+  if (context->getProperty(MaxPollRecords.getName(), value) && !value.empty() && core::Property::StringToInt(value, valInt) && valInt > 0) {
+    max_poll_records_ = valInt;
+  }
+  // allocated once, every trigger polls into it
+  messages_.assign(max_poll_records_, nullptr);
+  max_poll_time_ms_ = 1000;
+  value = "";
+  if (context->getProperty(MaxPollTime.getName(), value) && !value.empty()) {
+    core::TimeUnit unit;
+    if (core::Property::StringToTime(value, valInt, unit) && core::Property::ConvertTimeUnitToMS(valInt, unit, valInt)) {
+      max_poll_time_ms_ = valInt;
+    }
+  }
+  demarcator_ = "";
+  context->getProperty(MessageDemarcator.getName(), demarcator_);
+  value = "";
+  add_headers_ = context->getProperty(HeadersToAddAsAttributes.getName(), value) && !value.empty();
+  if (add_headers_) {
+    header_name_regex_ = utils::Regex(value);
+  }
+
+  if (!createConsumer(context)) {
+    logger_->log_error("Could not create Kafka consumer");
+  }
+}
+
+void ConsumeKafka::notifyStop() {
+  logger_->log_debug("notifyStop called");
+  std::lock_guard<std::mutex> lock(consumer_mutex_);
+  closeConsumer();
+}
+
+void ConsumeKafka::closeConsumer() {
+  if (queue_ != nullptr) {
+    rd_kafka_queue_destroy(queue_);
+    queue_ = nullptr;
+  }
+  if (consumer_ != nullptr) {
+    // leaves the group, so that the partitions are assigned to the other members right away
+    rd_kafka_resp_err_t err = rd_kafka_consumer_close(consumer_);
+    if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+      logger_->log_warn("Failed to close Kafka consumer: %s", rd_kafka_err2str(err));
+    }
+    rd_kafka_destroy(consumer_);
+    consumer_ = nullptr;
+  }
+}
+
+void ConsumeKafka::logCallback(const rd_kafka_t *rk, int level, const char* /*fac*/, const char *buf) {
+  ConsumeKafka *processor = static_cast<ConsumeKafka*>(rd_kafka_opaque(rk));
+  if (processor == nullptr) {
+    return;
+  }
+  switch (level) {
+    case 0:  // LOG_EMERG
+    case 1:  // LOG_ALERT
+    case 2:  // LOG_CRIT
+    case 3:  // LOG_ERR
+      logging::LOG_ERROR(processor->logger_) << buf;
+      break;
+    case 4:  // LOG_WARNING
+      logging::LOG_WARN(processor->logger_) << buf;
+      break;
+    case 5:  // LOG_NOTICE
+    case 6:  // LOG_INFO
+      logging::LOG_INFO(processor->logger_) << buf;
+      break;
+    case 7:  // LOG_DEBUG
+      logging::LOG_DEBUG(processor->logger_) << buf;
+      break;
+  }
+}
+
+/**
+ * Called while polling, when the group assigns partitions to this member or takes them away.
+ */
+void ConsumeKafka::rebalanceCallback(rd_kafka_t *rk, rd_kafka_resp_err_t err, rd_kafka_topic_partition_list_t *partitions, void *opaque) {
+  ConsumeKafka *processor = static_cast<ConsumeKafka*>(opaque);
+  for (int i = 0; i < partitions->cnt; i++) {
+    processor->logger_->log_debug("%s partition %s [%d]", err == RD_KAFKA_RESP_ERR__ASSIGN_PARTITIONS ? "Assigned" : "Revoked",
+                                  partitions->elems[i].topic, partitions->elems[i].partition);
+  }
+  switch (err) {
+    case RD_KAFKA_RESP_ERR__ASSIGN_PARTITIONS:
+      processor->logger_->log_info("Rebalance assigned %d partitions", partitions->cnt);
+      rd_kafka_assign(rk, partitions);
+      break;
+    case RD_KAFKA_RESP_ERR__REVOKE_PARTITIONS:
+      processor->logger_->log_info("Rebalance revoked %d partitions", partitions->cnt);
+      rd_kafka_assign(rk, nullptr);
+      break;
+    default:
+      processor->logger_->log_error("Rebalance failed: %s", rd_kafka_err2str(err));
+      rd_kafka_assign(rk, nullptr);
+      break;
+  }
+}
+
+bool ConsumeKafka::createConsumer(const std::shared_ptr<core::ProcessContext> &context) {
+  std::string value;
+  std::array<char, 512U> errstr;
+  rd_kafka_conf_res_t result;
+
+  rd_kafka_conf_t* conf_ = rd_kafka_conf_new();
+  if (conf_ == nullptr) {
+    logger_->log_error("Failed to create rd_kafka_conf_t object");
+    return false;
+  }
+  utils::ScopeGuard confGuard([conf_](){
+    rd_kafka_conf_destroy(conf_);
+  });
+
+  auto set = [&](const char *name, const std::string &conf_value) {
+    result = rd_kafka_conf_set(conf_, name, conf_value.c_str(), errstr.data(), errstr.size());
+    logger_->log_debug("ConsumeKafka: %s [%s]", name, conf_value);
+    if (result != RD_KAFKA_CONF_OK) {
+      logger_->log_error("ConsumeKafka: configure %s error result [%s]", name, errstr.data());
+      return false;
+    }
+    return true;
+  };
+
+  value = "";
+  if (!context->getProperty(SeedBrokers.getName(), value) || value.empty()) {
+    logger_->log_error("There are no brokers");
+    return false;
+  }
+  if (!set("bootstrap.servers", value)) {
+    return false;
+  }
+  value = "";
+  if (!context->getProperty(GroupID.getName(), value) || value.empty()) {
+    logger_->log_error("Group ID is empty");
+    return false;
+  }
+  if (!set("group.id", value)) {
+    return false;
+  }
+  value = "";
+  if (context->getProperty(ClientName.getName(), value) && !value.empty() && !set("client.id", value)) {
+    return false;
+  }
+  value = "";
+  if (context->getProperty(OffsetReset.getName(), value) && !value.empty() && !set("auto.offset.reset", value == OFFSET_RESET_NONE ? "error" : value)) {
+    return false;
+  }
+  // offsets are committed by onTrigger once the session holding the messages is committed
+  if (!set("enable.auto.commit", "false") || !set("enable.auto.offset.store", "false")) {
+    return false;
+  }
+  // end of partition events are of no use here
+  if (!set("enable.partition.eof", "false")) {
+    return false;
+  }
+  value = "";
+  if (context->getProperty(DebugContexts.getName(), value) && !value.empty() && !set("debug", value)) {
+    return false;
+  }
+  value = "";
+  if (context->getProperty(SecurityProtocol.getName(), value) && !value.empty()) {
+    if (value != SECURITY_PROTOCOL_SSL) {
+      logger_->log_error("ConsumeKafka: unknown Security Protocol: %s", value);
+      return false;
+    }
+    if (!set("security.protocol", value)) {
+      return false;
+    }
+    const std::vector<std::pair<core::Property*, const char*>> ssl_properties = {
+        {&SecurityCA, "ssl.ca.location"},
+        {&SecurityCert, "ssl.certificate.location"},
+        {&SecurityPrivateKey, "ssl.key.location"},
+        {&SecurityPrivateKeyPassWord, "ssl.key.password"}};
+    for (const auto &ssl_property : ssl_properties) {
+      value = "";
+      if (context->getProperty(ssl_property.first->getName(), value) && !value.empty() && !set(ssl_property.second, value)) {
+        return false;
+      }
+    }
+  }
+
+  // Add all of the dynamic properties as librdkafka configurations
+  const auto &dynamic_prop_keys = context->getDynamicPropertyKeys();
+  logger_->log_info("ConsumeKafka registering %d librdkafka dynamic properties", dynamic_prop_keys.size());
+
+  for (const auto &key : dynamic_prop_keys) {
+    value = "";
+    if (context->getDynamicProperty(key, value) && !value.empty()) {
+      if (!set(key.c_str(), value)) {
+        return false;
+      }
+    } else {
+      logger_->log_warn("ConsumeKafka Dynamic Property '%s' is empty and therefore will not be configured", key);
+    }
+  }
+
+  rd_kafka_conf_set_opaque(conf_, this);
+  rd_kafka_conf_set_rebalance_cb(conf_, &ConsumeKafka::rebalanceCallback);
+  rd_kafka_conf_set_log_cb(conf_, &ConsumeKafka::logCallback);
+
+  rd_kafka_t *consumer = rd_kafka_new(RD_KAFKA_CONSUMER, conf_, errstr.data(), errstr.size());
+  if (consumer == nullptr) {
+    logger_->log_error("Failed to create Kafka consumer %s", errstr.data());
+    return false;
+  }
+
+  // The consumer took ownership of the configuration, we must not free it
+  confGuard.disable();
+
+  value = "";
+  context->getProperty(TopicNames.getName(), value);
+  auto topics = utils::StringUtils::split(value, ",");
+  rd_kafka_topic_partition_list_t *subscription = rd_kafka_topic_partition_list_new(topics.size());
+  for (auto &topic : topics) {
+    topic = utils::StringUtils::trim(topic);
+    if (!topic.empty()) {
+      rd_kafka_topic_partition_list_add(subscription, topic.c_str(), RD_KAFKA_PARTITION_UA);
+    }
+  }
+  rd_kafka_resp_err_t err = subscription->cnt > 0 ? rd_kafka_subscribe(consumer, subscription) : RD_KAFKA_RESP_ERR__INVALID_ARG;
+  rd_kafka_topic_partition_list_destroy(subscription);
+  if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+    logger_->log_error("Failed to subscribe to topics %s: %s", value, rd_kafka_err2str(err));
+    rd_kafka_destroy(consumer);
+    return false;
+  }
+
+  // serve the rebalance events from the queue the messages are polled from
+  rd_kafka_poll_set_consumer(consumer);
+  consumer_ = consumer;
+  queue_ = rd_kafka_queue_get_consumer(consumer_);
+  return true;
+}
+
+void ConsumeKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) {
+  std::lock_guard<std::mutex> lock(consumer_mutex_);
+  if (consumer_ == nullptr) {
+    logger_->log_error("Kafka consumer is not available, yielding");
+    context->yield();
+    return;
+  }
+
+  ssize_t count = rd_kafka_consume_batch_queue(queue_, static_cast<int>(max_poll_time_ms_), messages_.data(), messages_.size());
+  if (count < 0) {
+    logger_->log_error("Failed to poll messages: %s", rd_kafka_err2str(rd_kafka_last_error()));
+    context->yield();
+    return;
+  }
+  auto polled_end = messages_.begin() + count;
+  utils::ScopeGuard messagesGuard([this, polled_end]() {
+    for (auto it = messages_.begin(); it != polled_end; ++it) {
+      rd_kafka_message_destroy(*it);
+    }
+  });
+
+  std::vector<rd_kafka_message_t*> consumed;
+  consumed.reserve(count);
+  for (auto it = messages_.begin(); it != polled_end; ++it) {
+    rd_kafka_message_t *message = *it;
+    if (message->err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+      logger_->log_warn("Failed to consume from %s [%d]: %s", message->rkt != nullptr ? rd_kafka_topic_name(message->rkt) : "", message->partition, rd_kafka_message_errstr(message));
+      continue;
+    }
+    consumed.push_back(message);
+  }
+  if (consumed.empty()) {
+    context->yield();
+    return;
+  }
+  logger_->log_debug("Polled %zu messages", consumed.size());
+
+  auto session = sessionFactory->createSession();
+  try {
+    transferMessages(consumed, session);
+    session->commit();
+  } catch (std::exception &exception) {
+    logger_->log_debug("Caught Exception %s", exception.what());
+    session->rollback();
+    rewind(consumed);
+    throw;
+  } catch (...) {
+    logger_->log_debug("Caught Exception ConsumeKafka::onTrigger");
+    session->rollback();
+    rewind(consumed);
+    throw;
+  }
+
+  commitOffsets(consumed);
+}
+
+void ConsumeKafka::transferMessages(const std::vector<rd_kafka_message_t*> &messages, const std::shared_ptr<core::ProcessSession> &session) {
+  if (!demarcator_.empty()) {
+    // keeps the order of the messages within a partition
+    std::map<std::pair<std::string, int32_t>, std::vector<const rd_kafka_message_t*>> bundles;
+    for (auto message : messages) {
+      bundles[std::make_pair(std::string(rd_kafka_topic_name(message->rkt)), message->partition)].push_back(message);
+    }
+    for (const auto &bundle : bundles) {
+      auto flowFile = session->create();
+      flowFile->addAttribute(KAFKA_TOPIC_ATTRIBUTE, bundle.first.first);
+      flowFile->addAttribute(KAFKA_PARTITION_ATTRIBUTE, std::to_string(bundle.first.second));
+      flowFile->addAttribute(KAFKA_OFFSET_ATTRIBUTE, std::to_string(bundle.second.front()->offset));
+      flowFile->addAttribute(KAFKA_COUNT_ATTRIBUTE, std::to_string(bundle.second.size()));
+      ConsumeKafka::WriteCallback callback(bundle.second, demarcator_);
+      session->write(flowFile, &callback);
+      session->transfer(flowFile, Success);
+    }
+    return;
+  }
+
+  std::vector<const rd_kafka_message_t*> single(1);
+  for (auto message : messages) {
+    auto flowFile = session->create();
+    flowFile->addAttribute(KAFKA_TOPIC_ATTRIBUTE, rd_kafka_topic_name(message->rkt));
+    flowFile->addAttribute(KAFKA_PARTITION_ATTRIBUTE, std::to_string(message->partition));
+    flowFile->addAttribute(KAFKA_OFFSET_ATTRIBUTE, std::to_string(message->offset));
+    if (message->key_len > 0) {
+      flowFile->addAttribute(KAFKA_KEY_ATTRIBUTE, std::string(static_cast<const char*>(message->key), message->key_len));
+    }
+    rd_kafka_headers_t *headers = nullptr;
+    if (add_headers_ && rd_kafka_message_headers(message, &headers) == RD_KAFKA_RESP_ERR_NO_ERROR) {
+      const char *name;
+      const void *header_value;
+      size_t size;
+      for (size_t index = 0; rd_kafka_header_get_all(headers, index, &name, &header_value, &size) == RD_KAFKA_RESP_ERR_NO_ERROR; index++) {
+        if (header_name_regex_.match(name)) {
+          flowFile->addAttribute(name, header_value != nullptr ? std::string(static_cast<const char*>(header_value), size) : "");
+        }
+      }
+    }
+    single[0] = message;
+    ConsumeKafka::WriteCallback callback(single, demarcator_);
+    session->write(flowFile, &callback);
+    session->transfer(flowFile, Success);
+  }
+}
+
+bool ConsumeKafka::commitOffsets(const std::vector<rd_kafka_message_t*> &messages) {
+  std::map<std::pair<std::string, int32_t>, int64_t> next_offsets;
+  for (auto message : messages) {
+    auto &offset = next_offsets[std::make_pair(std::string(rd_kafka_topic_name(message->rkt)), message->partition)];
+    offset = std::max(offset, message->offset + 1);
+  }
+  rd_kafka_topic_partition_list_t *offsets = rd_kafka_topic_partition_list_new(next_offsets.size());
+  for (const auto &next_offset : next_offsets) {
+    rd_kafka_topic_partition_list_add(offsets, next_offset.first.first.c_str(), next_offset.first.second)->offset = next_offset.second;
+  }
+  rd_kafka_resp_err_t err = rd_kafka_commit(consumer_, offsets, 0 /* synchronous */);
+  rd_kafka_topic_partition_list_destroy(offsets);
+  if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+    // the partitions may have been revoked meanwhile, their new owner consumes the messages again
+    logger_->log_warn("Failed to commit the offsets of %zu messages: %s", messages.size(), rd_kafka_err2str(err));
+    return false;
+  }
+  return true;
+}
+
+void ConsumeKafka::rewind(const std::vector<rd_kafka_message_t*> &messages) {
+  std::map<std::pair<std::string, int32_t>, const rd_kafka_message_t*> first_messages;
+  for (auto message : messages) {
+    first_messages.insert(std::make_pair(std::make_pair(std::string(rd_kafka_topic_name(message->rkt)), message->partition), message));
+  }
+  for (const auto &first_message : first_messages) {
+    const rd_kafka_message_t *message = first_message.second;
+    rd_kafka_resp_err_t err = rd_kafka_seek(message->rkt, message->partition, message->offset, 1000);
+    if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+      logger_->log_warn("Failed to seek %s [%d] back to %lld: %s", first_message.first.first, message->partition, message->offset, rd_kafka_err2str(err));
+    }
+  }
+}
+
+} /* namespace processors */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,199 @@
+/**
+ * @file ConsumeKafka.h
+ * ConsumeKafka class declaration
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __CONSUME_KAFKA_H__
+#define __CONSUME_KAFKA_H__
+
+#include "FlowFileRecord.h"
+#include "core/Processor.h"
+#include "core/ProcessSession.h"
+#include "core/Core.h"
+#include "core/Resource.h"
+#include "core/Property.h"
+#include "core/logging/LoggerConfiguration.h"
+#include "core/logging/Logger.h"
+#include "utils/RegexUtils.h"
+#include "rdkafka.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+#define OFFSET_RESET_EARLIEST "earliest"
+#define OFFSET_RESET_LATEST "latest"
+#define OFFSET_RESET_NONE "none"
+#define KAFKA_TOPIC_ATTRIBUTE "kafka.topic"
+#define KAFKA_PARTITION_ATTRIBUTE "kafka.partition"
+#define KAFKA_OFFSET_ATTRIBUTE "kafka.offset"
+#define KAFKA_COUNT_ATTRIBUTE "kafka.count"
+
+// ConsumeKafka Class
+class ConsumeKafka : public core::Processor {
+ public:
+  // Constructor
+  /*!
+   * Create a new processor
+   */
+  explicit ConsumeKafka(std::string name, utils::Identifier uuid = utils::Identifier())
+      : core::Processor(name, uuid),
+        logger_(logging::LoggerFactory<ConsumeKafka>::getLogger()),
+        consumer_(nullptr),
+        queue_(nullptr),
+        max_poll_records_(10000),
+        max_poll_time_ms_(1000),
+        add_headers_(false) {
+  }
+  // Destructor
+  virtual ~ConsumeKafka() {
+    closeConsumer();
+  }
+  // Processor Name
+  static constexpr char const* ProcessorName = "ConsumeKafka";
+  // Supported Properties
+  static core::Property SeedBrokers;
+  static core::Property TopicNames;
+  static core::Property GroupID;
+  static core::Property OffsetReset;
+  static core::Property ClientName;
+  static core::Property MaxPollRecords;
+  static core::Property MaxPollTime;
+  static core::Property MessageDemarcator;
+  static core::Property HeadersToAddAsAttributes;
+  static core::Property SecurityProtocol;
+  static core::Property SecurityCA;
+  static core::Property SecurityCert;
+  static core::Property SecurityPrivateKey;
+  static core::Property SecurityPrivateKeyPassWord;
+  static core::Property DebugContexts;
+
+  // Supported Relationships
+  static core::Relationship Success;
+
+  // Nest Callback Class for write stream
+  class WriteCallback : public OutputStreamCallback {
+   public:
+    WriteCallback(const std::vector<const rd_kafka_message_t*> &messages, const std::string &demarcator)
+        : messages_(messages),
+          demarcator_(demarcator) {
+    }
+    int64_t process(std::shared_ptr<io::BaseStream> stream) {
+      int64_t written = 0;
+      for (const auto message : messages_) {
+        if (written > 0 && !demarcator_.empty()) {
+          if (stream->write(reinterpret_cast<uint8_t*>(const_cast<char*>(demarcator_.data())), demarcator_.size()) < 0) {
+            return -1;
+          }
+          written += demarcator_.size();
+        }
+        if (message->len > 0) {
+          if (stream->write(static_cast<uint8_t*>(message->payload), message->len) < 0) {
+            return -1;
+          }
+          written += message->len;
+        }
+      }
+      return written;
+    }
+   private:
+    const std::vector<const rd_kafka_message_t*> &messages_;
+    const std::string &demarcator_;
+  };
+
+ public:
+
+  virtual bool supportsDynamicProperties() override {
+    return true;
+  }
+
+  /**
+   * Function that's executed when the processor is scheduled.
+   * @param context process context.
+   * @param sessionFactory process session factory that is used when creating
+   * ProcessSession objects.
+   */
+  virtual void onSchedule(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) override;
+  /**
+   * Polls a batch of messages into a session of its own, so that the offsets of the
+   * messages are only committed to Kafka once the session is committed.
+   */
+  virtual void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) override;
+  virtual void initialize() override;
+  virtual void notifyStop() override;
+
+ protected:
+
+  bool createConsumer(const std::shared_ptr<core::ProcessContext> &context);
+
+  /**
+   * Turns the polled messages into flow files. Messages of the same partition are merged
+   * into one flow file when a demarcator is configured.
+   */
+  void transferMessages(const std::vector<rd_kafka_message_t*> &messages, const std::shared_ptr<core::ProcessSession> &session);
+
+  /**
+   * Commits the offsets following the given messages for their partitions.
+   */
+  bool commitOffsets(const std::vector<rd_kafka_message_t*> &messages);
+
+  /**
+   * Moves the partitions of the given messages back to the first of them, so that they are
+   * consumed again after the session failed.
+   */
+  void rewind(const std::vector<rd_kafka_message_t*> &messages);
+
+ private:
+  static void rebalanceCallback(rd_kafka_t *rk, rd_kafka_resp_err_t err, rd_kafka_topic_partition_list_t *partitions, void *opaque);
+  static void logCallback(const rd_kafka_t *rk, int level, const char *fac, const char *buf);
+
+  void closeConsumer();
+
+  std::shared_ptr<logging::Logger> logger_;
+
+  // guards the consumer against stopping while a batch is processed
+  std::mutex consumer_mutex_;
+  rd_kafka_t *consumer_;
+  rd_kafka_queue_t *queue_;
+
+  uint64_t max_poll_records_;
+  // the messages polled by the current trigger, only used under the consumer mutex
+  std::vector<rd_kafka_message_t*> messages_;
+  uint64_t max_poll_time_ms_;
+  std::string demarcator_;
+  utils::Regex header_name_regex_;
+  bool add_headers_;
+};
+
+REGISTER_RESOURCE(ConsumeKafka, "Consumes messages from Apache Kafka topics as a member of a consumer group. The messages polled in one batch are turned into FlowFiles "
+                  "of a single session, optionally merging the messages of a partition into one FlowFile, and their offsets are committed once that session is committed.");
+
+} /* namespace processors */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif
@@ -38,6 +38,11 @@ class KafkaPool {
     return map_.erase(key) == 1;
   }
 
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    map_.clear();
+  }
+
   std::unique_ptr<KafkaLease> getOrCreateConnection(const KafkaConnectionKey &key) {
     std::lock_guard<std::mutex> lock(mutex_);
     auto connection = map_.find(key);
@@ -20,10 +20,12 @@
 #include "PublishKafka.h"
 #include <stdio.h>
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <string>
 #include <map>
 #include <set>
+#include <vector>
 #include "utils/TimeUtil.h"
 #include "utils/StringUtils.h"
 #include "utils/ScopeGuard.h"
@@ -99,6 +101,19 @@ core::Property PublishKafka::MessageKeyField("Message Key Field", "The name of a
                                              "");
 core::Property PublishKafka::DebugContexts("Debug contexts", "A comma-separated list of debug contexts to enable."
                                            "Including: generic, broker, topic, metadata, feature, queue, msg, protocol, cgrp, security, fetch, interceptor, plugin, consumer, admin, eos, all", "");
+core::Property PublishKafka::EnableIdempotence(
+    core::PropertyBuilder::createProperty("Enable Idempotence")->withDescription("Whether the producer makes sure that every message is written exactly once and in order, "
+                                                                                 "even if it has to be retried. Requires the Delivery Guarantee to wait for all in sync replicas.")
+        ->isRequired(false)->withDefaultValue<bool>(false)->build());
+core::Property PublishKafka::UseTransactions(
+    core::PropertyBuilder::createProperty("Use Transactions")->withDescription("Whether the messages of a batch are published in a Kafka transaction, which is committed "
+                                                                               "before the flow files are routed to success. Consumers reading committed messages only "
+                                                                               "see each flow file exactly once. Implies Enable Idempotence.")
+        ->isRequired(false)->withDefaultValue<bool>(false)->build());
+core::Property PublishKafka::TransactionalIDPrefix(
+    core::PropertyBuilder::createProperty("Transactional ID Prefix")->withDescription("Prefix of the transactional.id of the producer, which is followed by the UUID of the processor. "
+                                                                                      "Only used if Use Transactions is true.")
+        ->isRequired(false)->build());
 
 core::Relationship PublishKafka::Success("success", "Any FlowFile that is successfully sent to Kafka will be routed to this Relationship");
 core::Relationship PublishKafka::Failure("failure", "Any FlowFile that cannot be sent to Kafka will be routed to this Relationship");
@@ -131,6 +146,9 @@ void PublishKafka::initialize() {
   properties.insert(KerberosKeytabPath);
   properties.insert(MessageKeyField);
   properties.insert(DebugContexts);
+  properties.insert(EnableIdempotence);
+  properties.insert(UseTransactions);
+  properties.insert(TransactionalIDPrefix);
   setSupportedProperties(properties);
   // Set the supported relationships
   std::set<core::Relationship> relationships;
@@ -141,6 +159,22 @@ void PublishKafka::initialize() {
 
 void PublishKafka::onSchedule(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) {
   interrupted_ = false;
+
+  std::string value;
+  idempotence_ = false;
+  if (context->getProperty(EnableIdempotence.getName(), value)) {
+    utils::StringUtils::StringToBool(value, idempotence_);
+  }
+  use_transactions_ = false;
+  transactional_id_ = "";
+  value = "";
+  if (context->getProperty(UseTransactions.getName(), value)) {
+    utils::StringUtils::StringToBool(value, use_transactions_);
+  }
+  context->getProperty(TransactionalIDPrefix.getName(), transactional_id_);
+  transactional_id_ += getUUIDStr();
+  // connections configured by the previous schedule may not match the properties anymore
+  connection_pool_.clear();
 }
 
 void PublishKafka::notifyStop() {
@@ -375,6 +409,22 @@ bool PublishKafka::configureNewConnection(const std::shared_ptr<KafkaConnection>
     }
   }
 
+  if (use_transactions_) {
+    result = rd_kafka_conf_set(conf_, "transactional.id", transactional_id_.c_str(), errstr.data(), errstr.size());
+    logger_->log_debug("PublishKafka: transactional.id [%s]", transactional_id_);
+    if (result != RD_KAFKA_CONF_OK) {
+      logger_->log_error("PublishKafka: configure transactional.id error result [%s]", errstr.data());
+      return false;
+    }
+  } else if (idempotence_) {
+    result = rd_kafka_conf_set(conf_, "enable.idempotence", "true", errstr.data(), errstr.size());
+    logger_->log_debug("PublishKafka: enable.idempotence [true]");
+    if (result != RD_KAFKA_CONF_OK) {
+      logger_->log_error("PublishKafka: configure enable.idempotence error result [%s]", errstr.data());
+      return false;
+    }
+  }
+
   // Set the delivery callback
   rd_kafka_conf_set_dr_msg_cb(conf_, &PublishKafka::messageDeliveryCallback);
 
@@ -391,6 +441,17 @@ bool PublishKafka::configureNewConnection(const std::shared_ptr<KafkaConnection>
   // The producer took ownership of the configuration, we must not free it
   confGuard.disable();
 
+  if (use_transactions_) {
+    // fences the earlier instances of this producer and aborts their open transactions
+    rd_kafka_error_t *error = rd_kafka_init_transactions(producer, 30 * 1000);
+    if (error != nullptr) {
+      logger_->log_error("Failed to initialize transactions: %s", rd_kafka_error_string(error));
+      rd_kafka_error_destroy(error);
+      rd_kafka_destroy(producer);
+      return false;
+    }
+  }
+
   conn->setConnection(producer);
 
   return true;
@@ -507,6 +568,7 @@ void PublishKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
   key.brokers_ = brokers;
   key.client_id_ = client_id;
 
+  // The lease is held until the delivery reports of the batch arrived, so there is one transaction per producer
   std::unique_ptr<KafkaLease> lease = connection_pool_.getOrCreateConnection(key);
   if (lease == nullptr) {
     logger_->log_info("This connection is used by another thread.");
@@ -515,6 +577,12 @@ void PublishKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
   }
 
   std::shared_ptr<KafkaConnection> conn = lease->getConn();
+  std::array<char, 512U> errstr;
+  if (conn->initialized() && rd_kafka_fatal_error(conn->getConnection(), errstr.data(), errstr.size()) != RD_KAFKA_RESP_ERR_NO_ERROR) {
+    // the idempotent producer can not go on, e.g. because another instance with the same transactional.id fenced it
+    logger_->log_error("Kafka producer of %s, %s failed: %s, recreating it", client_id, brokers, errstr.data());
+    conn->remove();
+  }
   if (!conn->initialized()) {
     logger_->log_trace("Connection not initialized to %s, %s", client_id, brokers);
     if (!configureNewConnection(conn, context)) {
@@ -582,7 +650,22 @@ void PublishKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
   }
   logger_->log_debug("Processing %lu flow files with a total size of %llu B", flowFiles.size(), actual_bytes);
 
+  rd_kafka_t *rk = conn->getConnection();
+  if (use_transactions_) {
+    rd_kafka_error_t *error = rd_kafka_begin_transaction(rk);
+    if (error != nullptr) {
+      logger_->log_error("Failed to begin transaction: %s", rd_kafka_error_string(error));
+      rd_kafka_error_destroy(error);
+      session->rollback();
+      context->yield();
+      return;
+    }
+  }
+
   auto messages = std::make_shared<Messages>();
+  for (size_t index = 0; index < flowFiles.size(); index++) {
+    messages->addFlowFile();
+  }
   // We must add this to the messages set, so that it will be interrupted when notifyStop is called
   {
     std::lock_guard<std::mutex> lock(messages_mutex_);
@@ -595,56 +678,58 @@ void PublishKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
   });
 
   // Process FlowFiles
-  for (auto& flowFile : flowFiles) {
-    size_t flow_file_index = messages->addFlowFile();
-
-    // Get Topic (FlowFile-dependent EL property)
-    std::string topic;
-    if (!context->getProperty(Topic, topic, flowFile)) {
-      logger_->log_error("Flow file %s does not have a valid Topic", flowFile->getUUIDStr());
+  for (size_t flow_file_index = 0; flow_file_index < flowFiles.size(); flow_file_index++) {
+    auto& flowFile = flowFiles[flow_file_index];
+    auto markFailed = [&messages, flow_file_index]() {
       messages->modifyResult(flow_file_index, [](FlowFileResult& flow_file_result) {
         flow_file_result.flow_file_error = true;
       });
-      continue;
-    }
-
-    // Add topic to the connection if needed
-    if (!conn->hasTopic(topic)) {
-      if (!createNewTopic(conn, context, topic)) {
-        logger_->log_error("Failed to add topic %s", topic);
-        messages->modifyResult(flow_file_index, [](FlowFileResult& flow_file_result) {
-          flow_file_result.flow_file_error = true;
-        });
+    };
+
+    try {
+      // Get Topic (FlowFile-dependent EL property)
+      std::string topic;
+      if (!context->getProperty(Topic, topic, flowFile)) {
+        logger_->log_error("Flow file %s does not have a valid Topic", flowFile->getUUIDStr());
+        markFailed();
         continue;
       }
-    }
 
-    std::string kafkaKey;
-    kafkaKey = "";
-    if (context->getDynamicProperty(MessageKeyField, kafkaKey, flowFile) && !kafkaKey.empty()) {
-      logger_->log_debug("PublishKafka: Message Key Field [%s]", kafkaKey);
-    } else {
-      kafkaKey = flowFile->getUUIDStr();
-    }
+      // Add topic to the connection if needed
+      if (!conn->hasTopic(topic)) {
+        if (!createNewTopic(conn, context, topic)) {
+          logger_->log_error("Failed to add topic %s", topic);
+          markFailed();
+          continue;
+        }
+      }
 
-    auto thisTopic = conn->getTopic(topic);
-    if (thisTopic == nullptr) {
-      logger_->log_error("Topic %s is invalid", topic);
-      messages->modifyResult(flow_file_index, [](FlowFileResult& flow_file_result) {
-        flow_file_result.flow_file_error = true;
-      });
-      continue;
-    }
+      std::string kafkaKey;
+      kafkaKey = "";
+      if (context->getDynamicProperty(MessageKeyField, kafkaKey, flowFile) && !kafkaKey.empty()) {
+        logger_->log_debug("PublishKafka: Message Key Field [%s]", kafkaKey);
+      } else {
+        kafkaKey = flowFile->getUUIDStr();
+      }
 
-    PublishKafka::ReadCallback callback(max_flow_seg_size, kafkaKey, thisTopic->getTopic(), conn->getConnection(), flowFile,
-                                        attributeNameRegex, messages, flow_file_index);
-    session->read(flowFile, &callback);
-    if (callback.status_ < 0) {
-      logger_->log_error("Failed to send flow to kafka topic %s, error: %s", topic, callback.error_);
-      messages->modifyResult(flow_file_index, [](FlowFileResult& flow_file_result) {
-        flow_file_result.flow_file_error = true;
-      });
-      continue;
+      auto thisTopic = conn->getTopic(topic);
+      if (thisTopic == nullptr) {
+        logger_->log_error("Topic %s is invalid", topic);
+        markFailed();
+        continue;
+      }
+
+      PublishKafka::ReadCallback callback(max_flow_seg_size, kafkaKey, thisTopic->getTopic(), rk, flowFile,
+                                          attributeNameRegex, messages, flow_file_index);
+      session->read(flowFile, &callback);
+      if (callback.status_ < 0) {
+        logger_->log_error("Failed to send flow to kafka topic %s, error: %s", topic, callback.error_);
+        markFailed();
+        continue;
+      }
+    } catch (std::exception &exception) {
+      logger_->log_error("Failed to send flow file %s: %s", flowFile->getUUIDStr(), exception.what());
+      markFailed();
     }
   }
 
@@ -655,6 +740,14 @@ void PublishKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
   }
   logger_->log_trace("PublishKafka::onTrigger waitForCompletion finish");
 
+  completeBatch(messages, flowFiles, session, rk);
+}
+
+void PublishKafka::completeBatch(const std::shared_ptr<Messages> &messages, const std::vector<std::shared_ptr<core::FlowFile>> &flowFiles,
+                                 const std::shared_ptr<core::ProcessSession> &session, rd_kafka_t *rk) {
+  std::vector<bool> delivered(flowFiles.size(), false);
+  // whether messages of a failed flow file may have reached Kafka, they must not be committed
+  bool partially_delivered = false;
   messages->iterateFlowFiles([&](size_t index, const FlowFileResult& flow_file) {
     bool success;
     if (flow_file.flow_file_error) {
@@ -669,7 +762,7 @@ void PublishKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
         switch (message.status) {
           case MessageStatus::MESSAGESTATUS_UNCOMPLETE:
             success = false;
-            logger_->log_error("Waiting for delivery confirmation was interrupted for flow file %s segment %zu",
+            logger_->log_error("No delivery confirmation for flow file %s segment %zu",
                 flowFiles[index]->getUUIDStr(),
                 segment_num);
           break;
@@ -688,12 +781,48 @@ void PublishKafka::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
         }
       }
     }
-    if (success) {
-      session->transfer(flowFiles[index], Success);
-    } else {
-      session->transfer(flowFiles[index], Failure);
+    if (!success && std::any_of(flow_file.messages.begin(), flow_file.messages.end(), [](const MessageResult& message) {
+      return message.status != MessageStatus::MESSAGESTATUS_ERROR;
+    })) {
+      partially_delivered = true;
     }
+    delivered[index] = success;
   });
+
+  if (use_transactions_) {
+    if (partially_delivered) {
+      logger_->log_error("Aborting the transaction of %zu flow files, some flow files were only partially delivered", flowFiles.size());
+    }
+    if (!endTransaction(rk, !partially_delivered)) {
+      // nothing of the batch is visible to consumers reading committed messages
+      std::fill(delivered.begin(), delivered.end(), false);
+    }
+  }
+
+  for (size_t index = 0; index < flowFiles.size(); index++) {
+    session->transfer(flowFiles[index], delivered[index] ? Success : Failure);
+  }
+}
+
+bool PublishKafka::endTransaction(rd_kafka_t *rk, bool commit) {
+  // every message of the batch got its delivery report, so this takes a single round trip to the coordinator
+  rd_kafka_error_t *error = commit ? rd_kafka_commit_transaction(rk, -1) : rd_kafka_abort_transaction(rk, -1);
+  for (int retries = 0; error != nullptr && rd_kafka_error_is_retriable(error) && retries < 3; retries++) {
+    logger_->log_warn("Retrying to %s transaction: %s", commit ? "commit" : "abort", rd_kafka_error_string(error));
+    rd_kafka_error_destroy(error);
+    error = commit ? rd_kafka_commit_transaction(rk, -1) : rd_kafka_abort_transaction(rk, -1);
+  }
+  if (error == nullptr) {
+    logger_->log_debug("%s transaction", commit ? "Committed" : "Aborted");
+    return commit;
+  }
+  logger_->log_error("Failed to %s transaction: %s", commit ? "commit" : "abort", rd_kafka_error_string(error));
+  const bool requires_abort = commit && rd_kafka_error_txn_requires_abort(error);
+  rd_kafka_error_destroy(error);
+  if (requires_abort) {
+    endTransaction(rk, false);
+  }
+  return false;
 }
 
 } /* namespace processors */
@@ -70,7 +70,9 @@ class PublishKafka : public core::Processor {
       : core::Processor(name, uuid),
         connection_pool_(5),
         logger_(logging::LoggerFactory<PublishKafka>::getLogger()),
-        interrupted_(false) {
+        interrupted_(false),
+        idempotence_(false),
+        use_transactions_(false) {
   }
   // Destructor
   virtual ~PublishKafka() {
@@ -103,6 +105,9 @@ class PublishKafka : public core::Processor {
   static core::Property KerberosKeytabPath;
   static core::Property MessageKeyField;
   static core::Property DebugContexts;
+  static core::Property EnableIdempotence;
+  static core::Property UseTransactions;
+  static core::Property TransactionalIDPrefix;
 
   // Supported Relationships
   static core::Relationship Failure;
@@ -268,13 +273,13 @@ class PublishKafka : public core::Processor {
             rd_kafka_headers_t *hdrs_copy;
             hdrs_copy = rd_kafka_headers_copy(hdrs);
             err = rd_kafka_producev(rk_, RD_KAFKA_V_RKT(rkt_), RD_KAFKA_V_PARTITION(RD_KAFKA_PARTITION_UA), RD_KAFKA_V_MSGFLAGS(RD_KAFKA_MSG_F_COPY), RD_KAFKA_V_VALUE(&buffer[0], readRet),
-                                    RD_KAFKA_V_HEADERS(hdrs_copy), RD_KAFKA_V_KEY(key_.c_str(), key_.size()), RD_KAFKA_V_OPAQUE(callback.release()), RD_KAFKA_V_END);
+                                    RD_KAFKA_V_HEADERS(hdrs_copy), RD_KAFKA_V_KEY(key_.c_str(), key_.size()), RD_KAFKA_V_OPAQUE(callback.get()), RD_KAFKA_V_END);
             if (err) {
               rd_kafka_headers_destroy(hdrs_copy);
             }
           } else {
             err = rd_kafka_producev(rk_, RD_KAFKA_V_RKT(rkt_), RD_KAFKA_V_PARTITION(RD_KAFKA_PARTITION_UA), RD_KAFKA_V_MSGFLAGS(RD_KAFKA_MSG_F_COPY), RD_KAFKA_V_VALUE(&buffer[0], readRet),
-                                    RD_KAFKA_V_KEY(key_.c_str(), key_.size()), RD_KAFKA_V_OPAQUE(callback.release()), RD_KAFKA_V_END);
+                                    RD_KAFKA_V_KEY(key_.c_str(), key_.size()), RD_KAFKA_V_OPAQUE(callback.get()), RD_KAFKA_V_END);
           }
           if (err) {
             messages_->modifyResult(flow_file_index_, [segment_num, err](FlowFileResult& flow_file) {
@@ -286,6 +291,8 @@ class PublishKafka : public core::Processor {
             error_ = rd_kafka_err2str(err);
             return read_size_;
           }
+          // the delivery report owns the callback from now on
+          callback.release();
           read_size_ += readRet;
         } else {
           break;
@@ -335,6 +342,18 @@ class PublishKafka : public core::Processor {
  private:
   static void messageDeliveryCallback(rd_kafka_t* rk, const rd_kafka_message_t* rkmessage, void* opaque);
 
+  /**
+   * Routes the flow files of a finished batch by their delivery results. In transactional mode the
+   * flow files are only routed to success if the transaction could be committed.
+   */
+  void completeBatch(const std::shared_ptr<Messages> &messages, const std::vector<std::shared_ptr<core::FlowFile>> &flowFiles,
+                     const std::shared_ptr<core::ProcessSession> &session, rd_kafka_t *rk);
+
+  /**
+   * Commits or aborts the transaction of the producer, returns whether it was committed.
+   */
+  bool endTransaction(rd_kafka_t *rk, bool commit);
+
   std::shared_ptr<logging::Logger> logger_;
 
   KafkaPool connection_pool_;
@@ -342,6 +361,9 @@ class PublishKafka : public core::Processor {
   std::atomic<bool> interrupted_;
   std::mutex messages_mutex_;
   std::set<std::shared_ptr<Messages>> messages_set_;
+  bool idempotence_;
+  bool use_transactions_;
+  std::string transactional_id_;
 };
 
 REGISTER_RESOURCE(PublishKafka, "This Processor puts the contents of a FlowFile to a Topic in Apache Kafka. The content of a FlowFile becomes the contents of a Kafka message. "
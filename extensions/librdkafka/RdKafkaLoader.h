@@ -19,6 +19,7 @@
 #define EXTENSION_RDKAFKALOADER_H
 
 #include "PublishKafka.h"
+#include "ConsumeKafka.h"
 #include "core/ClassLoader.h"
 
 class RdKafkaFactory : public core::ObjectFactory {
@@ -45,12 +46,15 @@ class RdKafkaFactory : public core::ObjectFactory {
   virtual std::vector<std::string> getClassNames() {
     std::vector<std::string> class_names;
     class_names.push_back("PublishKafka");
+    class_names.push_back("ConsumeKafka");
     return class_names;
   }
 
   virtual std::unique_ptr<ObjectFactory> assign(const std::string &class_name) {
     if (utils::StringUtils::equalsIgnoreCase(class_name, "PublishKafka")) {
       return std::unique_ptr<ObjectFactory>(new core::DefautObjectFactory<minifi::processors::PublishKafka>());
+    } else if (utils::StringUtils::equalsIgnoreCase(class_name, "ConsumeKafka")) {
+      return std::unique_ptr<ObjectFactory>(new core::DefautObjectFactory<minifi::processors::ConsumeKafka>());
     } else {
       return nullptr;
     }
@@ -158,6 +158,7 @@ bool AbstractMQTTProcessor::reconnect() {
   MQTTClient_connectOptions conn_opts = MQTTClient_connectOptions_initializer;
   conn_opts.keepAliveInterval = keepAliveInterval_;
   conn_opts.cleansession = cleanSession_;
+  conn_opts.reliable = reliable_;
   if (!userName_.empty()) {
     conn_opts.username = userName_.c_str();
     conn_opts.password = passWord_.c_str();
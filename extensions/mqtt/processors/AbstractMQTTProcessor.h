@@ -57,6 +57,7 @@ class AbstractMQTTProcessor : public core::Processor {
     connectionTimeOut_ = 30;
     qos_ = 0;
     isSubscriber_ = false;
+    reliable_ = true;
   }
   // Destructor
   virtual ~AbstractMQTTProcessor() {
@@ -100,6 +101,7 @@ class AbstractMQTTProcessor : public core::Processor {
   static void msgDelivered(void *context, MQTTClient_deliveryToken dt) {
     AbstractMQTTProcessor *processor = (AbstractMQTTProcessor *) context;
     processor->delivered_token_ = dt;
+    processor->onMessageDelivered(dt);
   }
   static int msgReceived(void *context, char *topicName, int topicLen, MQTTClient_message *message) {
     AbstractMQTTProcessor *processor = (AbstractMQTTProcessor *) context;
@@ -114,9 +116,16 @@ class AbstractMQTTProcessor : public core::Processor {
   }
   static void connectionLost(void *context, char *cause) {
     AbstractMQTTProcessor *processor = (AbstractMQTTProcessor *) context;
+    processor->onConnectionLost();
     processor->reconnect();
   }
   bool reconnect();
+  // called by the client thread once the broker acknowledged a message of QoS 1 or 2
+  virtual void onMessageDelivered(MQTTClient_deliveryToken token) {
+  }
+  // called by the client thread before it reconnects
+  virtual void onConnectionLost() {
+  }
   // enqueue receive MQTT message
   virtual bool enqueueReceiveMQTTMsg(MQTTClient_message *message) {
     return false;
@@ -137,6 +146,8 @@ class AbstractMQTTProcessor : public core::Processor {
   std::string userName_;
   std::string passWord_;
   bool isSubscriber_;
+  // whether to wait for the acknowledgement of a message before publishing the next one
+  bool reliable_;
 
  private:
   std::shared_ptr<logging::Logger> logger_;
@@ -51,12 +51,19 @@ void ConsumeMQTT::initialize() {
 }
 
 bool ConsumeMQTT::enqueueReceiveMQTTMsg(MQTTClient_message *message) {
-  if (queue_.size_approx() >= maxQueueSize_) {
+  if (getScheduledState() == core::STOPPED) {
+    logger_->log_debug("ConsumeMQTT is stopped, dropping MQTT message");
+    return false;
+  } else if (queue_.size_approx() >= maxQueueSize_) {
     logger_->log_warn("MQTT queue full");
     return false;
   } else {
     if (message->payloadlen > maxSegSize_)
       message->payloadlen = maxSegSize_;
+    if (!core::MemoryGovernor::getInstance().tryReserve(message->payloadlen)) {
+      logger_->log_warn("Not enough memory to queue MQTT message");
+      return false;
+    }
     queue_.enqueue(message);
     logger_->log_debug("enqueue MQTT message length %d", message->payloadlen);
     return true;
@@ -79,6 +86,13 @@ void ConsumeMQTT::onSchedule(const std::shared_ptr<core::ProcessContext> &contex
   }
 }
 
+void ConsumeMQTT::notifyStop() {
+  const size_t dropped = freeQueuedMessages();
+  if (dropped > 0) {
+    logger_->log_warn("ConsumeMQTT stopped with %zu MQTT messages queued, dropping them", dropped);
+  }
+}
+
 void ConsumeMQTT::onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
   // reconnect if necessary
   if(!reconnect()) {
@@ -101,6 +115,7 @@ void ConsumeMQTT::onTrigger(const std::shared_ptr<core::ProcessContext> &context
       logger_->log_debug("ConsumeMQTT processing success for the flow with UUID %s topic %s", processFlowFile->getUUIDStr(), topic_);
       session->transfer(processFlowFile, Success);
     }
+    core::MemoryGovernor::getInstance().release(message->payloadlen);
     MQTTClient_freeMessage(&message);
     msg_queue.pop_front();
   }
@@ -26,6 +26,7 @@
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
 #include "core/Core.h"
+#include "core/MemoryGovernor.h"
 #include "core/Resource.h"
 #include "core/Property.h"
 #include "core/logging/LoggerConfiguration.h"
@@ -58,10 +59,7 @@ class ConsumeMQTT : public processors::AbstractMQTTProcessor {
   }
   // Destructor
   virtual ~ConsumeMQTT() {
-    MQTTClient_message *message;
-    while (queue_.try_dequeue(message)) {
-      MQTTClient_freeMessage(&message);
-    }
+    freeQueuedMessages();
   }
   // Processor Name
   static constexpr char const* ProcessorName = "ConsumeMQTT";
@@ -103,6 +101,9 @@ class ConsumeMQTT : public processors::AbstractMQTTProcessor {
   bool enqueueReceiveMQTTMsg(MQTTClient_message *message) override;
 
  protected:
+  // drops the messages queued while the processor ran, so that they no longer hold memory
+  void notifyStop() override;
+
   void getReceivedMQTTMsg(std::deque<MQTTClient_message *> &msg_queue) {
     MQTTClient_message *message;
     while (queue_.try_dequeue(message)) {
@@ -111,6 +112,18 @@ class ConsumeMQTT : public processors::AbstractMQTTProcessor {
   }
 
  private:
+  // frees the queued messages and releases their memory reservations
+  size_t freeQueuedMessages() {
+    size_t freed = 0;
+    MQTTClient_message *message;
+    while (queue_.try_dequeue(message)) {
+      core::MemoryGovernor::getInstance().release(message->payloadlen);
+      MQTTClient_freeMessage(&message);
+      freed++;
+    }
+    return freed;
+  }
+
   std::shared_ptr<logging::Logger> logger_;
   std::mutex mutex_;
   uint64_t maxQueueSize_;
@@ -20,14 +20,18 @@
 #include "PublishMQTT.h"
 #include <stdio.h>
 #include <algorithm>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <map>
 #include <set>
+#include <utility>
+#include <vector>
 #include "utils/TimeUtil.h"
 #include "utils/StringUtils.h"
 #include "core/ProcessContext.h"
 #include "core/ProcessSession.h"
+#include "core/TypedValues.h"
 
 namespace org {
 namespace apache {
@@ -37,15 +41,53 @@ namespace processors {
 
 core::Property PublishMQTT::Retain("Retain", "Retain MQTT published record in broker", "false");
 core::Property PublishMQTT::MaxFlowSegSize("Max Flow Segment Size", "Maximum flow content payload segment size for the MQTT record", "");
+core::Property PublishMQTT::MaxInFlight(
+    core::PropertyBuilder::createProperty("Max In-Flight Messages")->withDescription("The maximum number of messages of QoS 1 or 2 published without acknowledgement, at most 10")
+        ->withDefaultValue<uint64_t>(10)->build());
+core::Property PublishMQTT::BatchSize(
+    core::PropertyBuilder::createProperty("Batch Size")->withDescription("The maximum number of FlowFiles published per trigger")->withDefaultValue<uint64_t>(100)->build());
+core::Property PublishMQTT::DeliveryTimeout(
+    core::PropertyBuilder::createProperty("Delivery Timeout")->withDescription("How long to wait for the broker to acknowledge a message before the FlowFile is routed to failure")
+        ->withDefaultValue<core::TimePeriodValue>("10 sec")->build());
 
 core::Relationship PublishMQTT::Success("success", "FlowFiles that are sent successfully to the destination are transferred to this relationship");
 core::Relationship PublishMQTT::Failure("failure", "FlowFiles that failed to send to the destination are transferred to this relationship");
 
+const uint64_t PublishMQTT::MAX_IN_FLIGHT_LIMIT;
+
+int64_t PublishMQTT::ReadCallback::process(std::shared_ptr<io::BaseStream> stream) {
+  if (flow_size_ < max_seg_size_)
+    max_seg_size_ = flow_size_;
+  std::vector<uint8_t> buffer(max_seg_size_);
+  read_size_ = 0;
+  status_ = 0;
+  while (read_size_ < flow_size_) {
+    int readRet = stream->read(buffer.data(), max_seg_size_);
+    if (readRet < 0) {
+      status_ = -1;
+      return read_size_;
+    }
+    if (readRet > 0) {
+      if (!processor_->publishSegment(buffer.data(), readRet, tokens_)) {
+        status_ = -2;
+        return read_size_;
+      }
+      read_size_ += readRet;
+    } else {
+      break;
+    }
+  }
+  return read_size_;
+}
+
 void PublishMQTT::initialize() {
   // Set the supported properties
   std::set<core::Property> properties(AbstractMQTTProcessor::getSupportedProperties());
   properties.insert(Retain);
   properties.insert(MaxFlowSegSize);
+  properties.insert(MaxInFlight);
+  properties.insert(BatchSize);
+  properties.insert(DeliveryTimeout);
   setSupportedProperties(properties);
   // Set the supported relationships
   setSupportedRelationships({Success, Failure});
@@ -64,6 +106,61 @@ void PublishMQTT::onSchedule(const std::shared_ptr<core::ProcessContext> &contex
   if (context->getProperty(Retain.getName(), value) && !value.empty() && org::apache::nifi::minifi::utils::StringUtils::StringToBool(value, retain_)) {
     logger_->log_debug("PublishMQTT: Retain [%d]", retain_);
   }
+  if (!context->getProperty(MaxInFlight.getName(), max_in_flight_) || max_in_flight_ == 0 || max_in_flight_ > MAX_IN_FLIGHT_LIMIT) {
+    logger_->log_warn("PublishMQTT: Max In-Flight Messages must be between 1 and %llu, using %llu", MAX_IN_FLIGHT_LIMIT, MAX_IN_FLIGHT_LIMIT);
+    max_in_flight_ = MAX_IN_FLIGHT_LIMIT;
+  }
+  if (!context->getProperty(BatchSize.getName(), batch_size_) || batch_size_ == 0) {
+    batch_size_ = 1;
+  }
+  if (!context->getProperty(DeliveryTimeout.getName(), delivery_timeout_ms_)) {
+    delivery_timeout_ms_ = 10000;
+  }
+  logger_->log_debug("PublishMQTT: batches of %llu with %llu messages in flight", batch_size_, max_in_flight_);
+}
+
+void PublishMQTT::onMessageDelivered(MQTTClient_deliveryToken token) {
+  std::lock_guard<std::mutex> lock(delivery_mutex_);
+  if (pending_tokens_.erase(token) == 0) {
+    early_deliveries_.insert(token);
+  }
+  delivery_condition_.notify_all();
+}
+
+void PublishMQTT::onConnectionLost() {
+  std::lock_guard<std::mutex> lock(delivery_mutex_);
+  connection_losses_++;
+  delivery_condition_.notify_all();
+}
+
+bool PublishMQTT::waitForDeliveries(size_t max_pending) {
+  std::unique_lock<std::mutex> lock(delivery_mutex_);
+  return delivery_condition_.wait_for(lock, std::chrono::milliseconds(delivery_timeout_ms_), [&] {
+    return pending_tokens_.size() <= max_pending || connection_losses_ != batch_connection_losses_;
+  }) && connection_losses_ == batch_connection_losses_;
+}
+
+bool PublishMQTT::publishSegment(uint8_t *payload, int size, std::vector<MQTTClient_deliveryToken> &tokens) {
+  if (qos_ > 0 && !waitForDeliveries(max_in_flight_ - 1)) {
+    return false;
+  }
+  MQTTClient_message pubmsg = MQTTClient_message_initializer;
+  pubmsg.payload = payload;
+  pubmsg.payloadlen = size;
+  pubmsg.qos = qos_;
+  pubmsg.retained = retain_;
+  MQTTClient_deliveryToken token = 0;
+  if (MQTTClient_publishMessage(client_, topic_.c_str(), &pubmsg, &token) != MQTTCLIENT_SUCCESS) {
+    return false;
+  }
+  if (qos_ > 0) {
+    std::lock_guard<std::mutex> lock(delivery_mutex_);
+    if (early_deliveries_.erase(token) == 0) {
+      pending_tokens_.insert(token);
+      tokens.push_back(token);
+    }
+  }
+  return true;
 }
 
 void PublishMQTT::onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
@@ -72,22 +169,61 @@ void PublishMQTT::onTrigger(const std::shared_ptr<core::ProcessContext> &context
     yield();
     return;
   }
-	
-  std::shared_ptr<core::FlowFile> flowFile = session->get();
 
-  if (!flowFile) {
-    return;
+  std::lock_guard<std::mutex> publish_lock(publish_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(delivery_mutex_);
+    pending_tokens_.clear();
+    early_deliveries_.clear();
+    batch_connection_losses_ = connection_losses_;
+  }
+
+  std::vector<std::pair<std::shared_ptr<core::FlowFile>, std::vector<MQTTClient_deliveryToken>>> published;
+  bool publishing = true;
+  for (uint64_t i = 0; i < batch_size_ && publishing; i++) {
+    std::shared_ptr<core::FlowFile> flowFile = session->get();
+    if (!flowFile) {
+      break;
+    }
+    PublishMQTT::ReadCallback callback(this, flowFile->getSize(), max_seg_size_);
+    session->read(flowFile, &callback);
+    if (callback.status_ == -1) {
+      logger_->log_error("Failed to read flow %s for MQTT topic %s", flowFile->getUUIDStr(), topic_);
+      session->transfer(flowFile, Failure);
+    } else if (callback.status_ < 0) {
+      // the window did not drain or the connection broke, the rest of the batch stays queued
+      logger_->log_error("Failed to send flow %s to MQTT topic %s", flowFile->getUUIDStr(), topic_);
+      session->transfer(flowFile, Failure);
+      publishing = false;
+    } else {
+      logger_->log_debug("Sent flow with length %d to MQTT topic %s", callback.read_size_, topic_);
+      published.emplace_back(flowFile, std::move(callback.tokens_));
+    }
   }
 
-  PublishMQTT::ReadCallback callback(flowFile->getSize(), max_seg_size_, topic_, client_, qos_, retain_, delivered_token_);
-  session->read(flowFile, &callback);
-  if (callback.status_ < 0) {
-    logger_->log_error("Failed to send flow to MQTT topic %s", topic_);
-    session->transfer(flowFile, Failure);
-  } else {
-    logger_->log_debug("Sent flow with length %d to MQTT topic %s", callback.read_size_, topic_);
-    session->transfer(flowFile, Success);
+  if (publishing) {
+    waitForDeliveries(0);
+  }
+  std::lock_guard<std::mutex> lock(delivery_mutex_);
+  const bool connection_lost = connection_losses_ != batch_connection_losses_;
+  size_t unacknowledged = 0;
+  for (auto &flow : published) {
+    // messages of QoS 0 are not acknowledged
+    bool delivered = true;
+    for (auto token : flow.second) {
+      delivered = delivered && pending_tokens_.find(token) == pending_tokens_.end();
+    }
+    if (delivered) {
+      session->transfer(flow.first, Success);
+    } else {
+      session->transfer(flow.first, Failure);
+      unacknowledged++;
+    }
+  }
+  if (unacknowledged > 0) {
+    logger_->log_error("%zu flows were not acknowledged by MQTT topic %s%s", unacknowledged, topic_, connection_lost ? " before the connection was lost" : "");
   }
+  pending_tokens_.clear();
 }
 
 } /* namespace processors */
@@ -20,6 +20,13 @@
 #ifndef __PUBLISH_MQTT_H__
 #define __PUBLISH_MQTT_H__
 
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
 #include "FlowFileRecord.h"
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
@@ -37,6 +44,14 @@ namespace minifi {
 namespace processors {
 
 // PublishMQTT Class
+/**
+ * Publishes a batch of FlowFiles per trigger. Messages of QoS 1 and 2 are published without
+ * waiting for each acknowledgement, up to Max In-Flight Messages unacknowledged at a time, and a
+ * FlowFile is transferred to success only once the broker acknowledged all of its segments.
+ * FlowFiles that were not acknowledged within the delivery timeout, or whose messages were lost
+ * with the connection, go to failure, and the FlowFiles after them stay queued. The client holds
+ * one window, so batches are published one at a time.
+ */
 class PublishMQTT : public processors::AbstractMQTTProcessor {
  public:
   // Constructor
@@ -48,15 +63,26 @@ class PublishMQTT : public processors::AbstractMQTTProcessor {
         logger_(logging::LoggerFactory<PublishMQTT>::getLogger()) {
     retain_ = false;
     max_seg_size_ = ULLONG_MAX;
+    max_in_flight_ = MAX_IN_FLIGHT_LIMIT;
+    batch_size_ = 100;
+    delivery_timeout_ms_ = 10000;
+    connection_losses_ = 0;
+    batch_connection_losses_ = 0;
+    reliable_ = false;
   }
   // Destructor
   virtual ~PublishMQTT() {
   }
   // Processor Name
   static constexpr char const* ProcessorName = "PublishMQTT";
+  // the client keeps at most this many messages unacknowledged
+  static const uint64_t MAX_IN_FLIGHT_LIMIT = 10;
   // Supported Properties
   static core::Property Retain;
   static core::Property MaxFlowSegSize;
+  static core::Property MaxInFlight;
+  static core::Property BatchSize;
+  static core::Property DeliveryTimeout;
 
   static core::Relationship Failure;
   static core::Relationship Success;
@@ -64,59 +90,23 @@ class PublishMQTT : public processors::AbstractMQTTProcessor {
   // Nest Callback Class for read stream
   class ReadCallback : public InputStreamCallback {
    public:
-    ReadCallback(uint64_t flow_size, uint64_t max_seg_size, const std::string &key, MQTTClient client, int qos, bool retain, MQTTClient_deliveryToken &token)
-        : flow_size_(flow_size),
-          max_seg_size_(max_seg_size),
-          key_(key),
-          client_(client),
-          qos_(qos),
-          retain_(retain),
-          token_(token) {
+    ReadCallback(PublishMQTT *processor, uint64_t flow_size, uint64_t max_seg_size)
+        : processor_(processor),
+          flow_size_(flow_size),
+          max_seg_size_(max_seg_size) {
       status_ = 0;
       read_size_ = 0;
     }
     ~ReadCallback() {
     }
-    int64_t process(std::shared_ptr<io::BaseStream> stream) {
-      if (flow_size_ < max_seg_size_)
-        max_seg_size_ = flow_size_;
-      std::vector<unsigned char> buffer;
-      buffer.reserve(max_seg_size_);
-      read_size_ = 0;
-      status_ = 0;
-      while (read_size_ < flow_size_) {
-        int readRet = stream->read(&buffer[0], max_seg_size_);
-        if (readRet < 0) {
-          status_ = -1;
-          return read_size_;
-        }
-        if (readRet > 0) {
-          MQTTClient_message pubmsg = MQTTClient_message_initializer;
-          pubmsg.payload = &buffer[0];
-          pubmsg.payloadlen = readRet;
-          pubmsg.qos = qos_;
-          pubmsg.retained = retain_;
-          if (MQTTClient_publishMessage(client_, key_.c_str(), &pubmsg, &token_) != MQTTCLIENT_SUCCESS) {
-            status_ = -1;
-            return -1;
-          }
-          read_size_ += readRet;
-        } else {
-          break;
-        }
-      }
-      return read_size_;
-    }
+    int64_t process(std::shared_ptr<io::BaseStream> stream);
+    PublishMQTT *processor_;
     uint64_t flow_size_;
     uint64_t max_seg_size_;
-    std::string key_;
-    MQTTClient client_;
-    ;
     int status_;
     size_t read_size_;
-    int qos_;
-    int retain_;
-    MQTTClient_deliveryToken &token_;
+    // the messages awaiting acknowledgement
+    std::vector<MQTTClient_deliveryToken> tokens_;
   };
 
  public:
@@ -132,11 +122,40 @@ class PublishMQTT : public processors::AbstractMQTTProcessor {
   // Initialize, over write by NiFi PublishMQTT
   void initialize(void) override;
 
+  void onMessageDelivered(MQTTClient_deliveryToken token) override;
+  void onConnectionLost() override;
+
  protected:
 
  private:
+  /**
+   * Publishes one segment. Waits until the window has room first.
+   * @return false if the segment could not be published
+   */
+  bool publishSegment(uint8_t *payload, int size, std::vector<MQTTClient_deliveryToken> &tokens);
+
+  /**
+   * Waits until at most max_pending messages are unacknowledged.
+   * @return false if the delivery timeout passed or the connection was lost first
+   */
+  bool waitForDeliveries(size_t max_pending);
+
   uint64_t max_seg_size_;
   bool retain_;
+  uint64_t max_in_flight_;
+  uint64_t batch_size_;
+  uint64_t delivery_timeout_ms_;
+  // one batch at a time, they share the window of the client
+  std::mutex publish_mutex_;
+  std::mutex delivery_mutex_;
+  std::condition_variable delivery_condition_;
+  // tokens of the messages awaiting acknowledgement
+  std::set<MQTTClient_deliveryToken> pending_tokens_;
+  // acknowledgements that arrived before publishing returned their token
+  std::set<MQTTClient_deliveryToken> early_deliveries_;
+  uint64_t connection_losses_;
+  // connection_losses_ when the batch started
+  uint64_t batch_connection_losses_;
   std::shared_ptr<logging::Logger> logger_;
 };
 
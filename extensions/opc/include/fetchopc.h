@@ -53,13 +53,16 @@ public:
   static core::Property NodeID;
   static core::Property NameSpaceIndex;
   static core::Property MaxDepth;
+  static core::Property FetchMode;
+  static core::Property PublishingInterval;
+  static core::Property MaxNodesPerRequest;
 
   // Supported Relationships
   static core::Relationship Success;
   static core::Relationship Failure;
 
   FetchOPCProcessor(std::string name, utils::Identifier uuid = utils::Identifier())
-  : BaseOPCProcessor(name, uuid), nameSpaceIdx_(0), nodesFound_(0), variablesFound_(0), maxDepth_(0) {
+  : BaseOPCProcessor(name, uuid), nameSpaceIdx_(0), nodesFound_(0), maxDepth_(0), subscribe_(false), publishingInterval_(1000), maxNodesPerRequest_(1000) {
     logger_ = logging::LoggerFactory<FetchOPCProcessor>::getLogger();
   }
 
@@ -70,8 +73,12 @@ public:
   virtual void initialize(void) override;
 
 protected:
-  bool nodeFoundCallBack(opc::Client& client, const UA_ReferenceDescription *ref, const std::string& path,
-                         const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session);
+  bool nodeFoundCallBack(opc::Client& client, const UA_ReferenceDescription *ref, const std::string& path);
+
+  /**
+   * Traverses the address space from the configured node and caches the variable nodes found.
+   */
+  bool browse();
 
   void OPCData2FlowFile(const opc::NodeData& opcnode, const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session);
 
@@ -89,12 +96,15 @@ protected:
   int32_t nameSpaceIdx_;
   opc::OPCNodeIDType idType_;
   uint32_t nodesFound_;
-  uint32_t variablesFound_;
   uint64_t maxDepth_;
+  bool subscribe_;
+  uint64_t publishingInterval_;
+  uint64_t maxNodesPerRequest_;
 
 private:
   std::mutex onTriggerMutex_;
   std::vector<UA_NodeId> translatedNodeIDs_;  // Only used when user provides path, path->nodeid translation is only done once
+  std::vector<opc::NodeReference> variableNodes_;  // Browse result, kept until the next reconnect or schedule
 
 };
 
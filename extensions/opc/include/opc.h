@@ -21,12 +21,15 @@
 
 #include "open62541/client.h"
 #include "open62541/client_highlevel.h"
+#include "open62541/client_subscriptions.h"
 #include "open62541/client_config_default.h"
 #include "logging/Logger.h"
 #include "Exception.h"
 
 #include <string>
 #include <functional>
+#include <memory>
+#include <vector>
 
 namespace org {
 namespace apache {
@@ -51,12 +54,40 @@ class Client;
 
 using nodeFoundCallBackFunc = bool(Client& client, const UA_ReferenceDescription*, const std::string&);
 
+// A node reference kept beyond the browse response it was found in
+using NodeReference = std::shared_ptr<UA_ReferenceDescription>;
+
+NodeReference copyNodeReference(const UA_ReferenceDescription *ref);
+
 class Client {
  public:
   bool isConnected();
   UA_StatusCode connect(const std::string& url, const std::string& username = "", const std::string& password = "");
   ~Client();
   NodeData getNodeData(const UA_ReferenceDescription *ref, const std::string& basePath = "");
+
+  /**
+   * Reads the values of the given variable nodes using one Read service call per
+   * maxNodesPerRead nodes instead of one call per node. Nodes whose value cannot be
+   * read are logged and left out of the result.
+   */
+  std::vector<NodeData> readNodeData(const std::vector<NodeReference>& nodes, const std::string& basePath = "", size_t maxNodesPerRead = 1000);
+
+  /**
+   * Creates a subscription with a data change monitored item for each of the given
+   * variable nodes. The server samples the values and only publishes the changed ones.
+   * If the subscription or all of its monitored items cannot be created, nothing stays subscribed.
+   */
+  UA_StatusCode subscribe(const std::vector<NodeReference>& nodes, double publishingInterval, size_t maxNodesPerRequest = 1000);
+  void unsubscribe();
+  bool isSubscribed() const;
+
+  /**
+   * Processes the publish responses arriving within timeoutMs and returns the values
+   * changed since the previous call. The first notification of each monitored item
+   * carries its current value.
+   */
+  std::vector<NodeData> getChangedNodeData(uint16_t timeoutMs);
   UA_ReferenceDescription * getNodeReference(UA_NodeId nodeId);
   void traverse(UA_NodeId nodeId, std::function<nodeFoundCallBackFunc> cb, const std::string& basePath = "", uint64_t maxDepth = 0, bool fetchRoot = true);
   bool exists(UA_NodeId nodeId);
@@ -77,8 +108,18 @@ class Client {
       const std::vector<char>& certBuffer, const std::vector<char>& keyBuffer,
       const std::vector<std::vector<char>>& trustBuffers);
 
+  static NodeData createNodeData(const UA_ReferenceDescription *ref, const std::string& basePath);
+  static bool addValue(NodeData& nodedata, UA_Variant *var);
+  static void dataChangeNotification(UA_Client *client, UA_UInt32 subId, void *subContext, UA_UInt32 monId, void *monContext, UA_DataValue *value);
+  static void subscriptionDeleted(UA_Client *client, UA_UInt32 subId, void *subContext);
+
   UA_Client *client_;
   std::shared_ptr<core::logging::Logger> logger_;
+
+  UA_UInt32 subscriptionId_;
+  // the monitored items refer to these by index
+  std::vector<NodeReference> monitoredNodes_;
+  std::vector<NodeData> changedNodes_;
 };
 
 using ClientPtr = std::unique_ptr<Client>;
@@ -98,7 +139,7 @@ struct NodeData {
   NodeData& operator= (const NodeData &) = delete;
   NodeData& operator= (NodeData &&) = delete;
 
-  NodeData(NodeData&& rhs) : data(rhs.data), attributes(rhs.attributes)
+  NodeData(NodeData&& rhs) : data(std::move(rhs.data)), attributes(std::move(rhs.attributes))
   {
     dataTypeID = rhs.dataTypeID;
     this->var_ = rhs.var_;
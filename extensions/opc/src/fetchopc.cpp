@@ -17,6 +17,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <list>
@@ -65,13 +67,30 @@ namespace processors {
       ->withDescription("Specifiec the max depth of browsing. 0 means unlimited.")
       ->withDefaultValue<uint64_t>(0)->build());
 
+  core::Property FetchOPCProcessor::FetchMode(
+      core::PropertyBuilder::createProperty("Fetch mode")
+      ->withDescription("Read reads the value of every variable node on each trigger. "
+                        "Subscribe monitors the variable nodes and only emits the values changed since the previous trigger.")
+      ->withAllowableValues<std::string>({"Read", "Subscribe"})
+      ->withDefaultValue("Read")->build());
+
+  core::Property FetchOPCProcessor::PublishingInterval(
+      core::PropertyBuilder::createProperty("Publishing interval")
+      ->withDescription("The interval the server samples and publishes the monitored values at. Used only if fetch mode is Subscribe.")
+      ->withDefaultValue<core::TimePeriodValue>("1 sec")->build());
+
+  core::Property FetchOPCProcessor::MaxNodesPerRequest(
+      core::PropertyBuilder::createProperty("Max nodes per request")
+      ->withDescription("The max number of nodes read or monitored in a single request to the server.")
+      ->withDefaultValue<uint64_t>(1000)->build());
+
   core::Relationship FetchOPCProcessor::Success("success", "Successfully retrieved OPC-UA nodes");
   core::Relationship FetchOPCProcessor::Failure("failure", "Retrieved OPC-UA nodes where value cannot be extracted (only if enabled)");
 
 
   void FetchOPCProcessor::initialize() {
     // Set the supported properties
-    std::set<core::Property> fetchOPCProperties = {OPCServerEndPoint, NodeID, NodeIDType, NameSpaceIndex, MaxDepth};
+    std::set<core::Property> fetchOPCProperties = {OPCServerEndPoint, NodeID, NodeIDType, NameSpaceIndex, MaxDepth, FetchMode, PublishingInterval, MaxNodesPerRequest};
     std::set<core::Property> baseOPCProperties = BaseOPCProcessor::getSupportedProperties();
     fetchOPCProperties.insert(baseOPCProperties.begin(), baseOPCProperties.end());
     setSupportedProperties(fetchOPCProperties);
@@ -84,6 +103,7 @@ namespace processors {
     logger_->log_trace("FetchOPCProcessor::onSchedule");
 
     translatedNodeIDs_.clear();  // Path might has changed during restart
+    variableNodes_.clear();
 
     BaseOPCProcessor::onSchedule(context, factory);
 
@@ -100,6 +120,16 @@ namespace processors {
     maxDepth_ = 0;
     context->getProperty(MaxDepth.getName(), maxDepth_);
 
+    std::string fetchMode;
+    context->getProperty(FetchMode.getName(), fetchMode);
+    subscribe_ = fetchMode == "Subscribe";
+    context->getProperty(PublishingInterval.getName(), publishingInterval_);
+    context->getProperty(MaxNodesPerRequest.getName(), maxNodesPerRequest_);
+    if (maxNodesPerRequest_ == 0) {
+      logger_->log_error("%s must be greater than zero", MaxNodesPerRequest.getName());
+      return;
+    }
+
     if (value == "String") {
       idType_ = opc::OPCNodeIDType::String;
     } else if (value == "Int") {
@@ -144,15 +174,61 @@ namespace processors {
       return;
     }
 
+    // a new session might see a different address space
+    if (connection_ == nullptr || !connection_->isConnected()) {
+      variableNodes_.clear();
+    }
+
     if (!reconnect()) {
       yield();
       return;
     }
 
+    const bool browsed = variableNodes_.empty();
+    if (browsed) {
+      if (!browse()) {
+        yield();
+        return;
+      }
+      if(nodesFound_ == 0) {
+        logger_->log_warn("Connected to OPC server, but no variable nodes were not found. Configuration might be incorrect! Yielding...");
+        yield();
+        return;
+      } else if (variableNodes_.empty()) {
+        logger_->log_warn("Found no variables when traversing the specified node. No flowfiles are generated. Yielding...");
+        yield();
+        return;
+      }
+      logger_->log_debug("Found %zu variables out of %u nodes", variableNodes_.size(), nodesFound_);
+    }
+
+    if (subscribe_) {
+      if (browsed || !connection_->isSubscribed()) {
+        auto sc = connection_->subscribe(variableNodes_, static_cast<double>(publishingInterval_), maxNodesPerRequest_);
+        if (sc != UA_STATUSCODE_GOOD) {
+          logger_->log_error("Failed to subscribe to the variables of %s: %s", nodeID_.c_str(), UA_StatusCode_name(sc));
+          yield();
+          return;
+        }
+      }
+      const uint16_t timeout = static_cast<uint16_t>(std::min<uint64_t>(publishingInterval_, UINT16_MAX));
+      for (const auto& nodedata : connection_->getChangedNodeData(timeout)) {
+        OPCData2FlowFile(nodedata, context, session);
+      }
+    } else {
+      if (connection_->isSubscribed()) {
+        connection_->unsubscribe();
+      }
+      for (const auto& nodedata : connection_->readNodeData(variableNodes_, "", maxNodesPerRequest_)) {
+        OPCData2FlowFile(nodedata, context, session);
+      }
+    }
+  }
+
+  bool FetchOPCProcessor::browse() {
     nodesFound_ = 0;
-    variablesFound_ = 0;
 
-    std::function<opc::nodeFoundCallBackFunc> f = std::bind(&FetchOPCProcessor::nodeFoundCallBack, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, context, session);
+    std::function<opc::nodeFoundCallBackFunc> f = std::bind(&FetchOPCProcessor::nodeFoundCallBack, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
     if(idType_ != opc::OPCNodeIDType::Path) {
       UA_NodeId myID;
       myID.namespaceIndex = nameSpaceIdx_;
@@ -164,42 +240,27 @@ namespace processors {
         myID.identifier.string = UA_STRING_ALLOC(nodeID_.c_str());
       }
       connection_->traverse(myID, f, "", maxDepth_);
+      UA_NodeId_deleteMembers(&myID);
     } else {
       if(translatedNodeIDs_.empty()) {
         auto sc = connection_->translateBrowsePathsToNodeIdsRequest(nodeID_, translatedNodeIDs_, logger_);
         if(sc != UA_STATUSCODE_GOOD) {
           logger_->log_error("Failed to translate %s to node id, no flow files will be generated (%s)", nodeID_.c_str(), UA_StatusCode_name(sc));
-          yield();
-          return;
+          return false;
         }
       }
       for(auto& nodeID: translatedNodeIDs_) {
         connection_->traverse(nodeID, f, nodeID_, maxDepth_);
       }
     }
-    if(nodesFound_ == 0) {
-      logger_->log_warn("Connected to OPC server, but no variable nodes were not found. Configuration might be incorrect! Yielding...");
-      yield();
-    } else if (variablesFound_ == 0) {
-      logger_->log_warn("Found no variables when traversing the specified node. No flowfiles are generated. Yielding...");
-      yield();
-    }
-
+    return true;
   }
 
-  bool FetchOPCProcessor::nodeFoundCallBack(opc::Client& client, const UA_ReferenceDescription *ref, const std::string& path,
-      const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
+  bool FetchOPCProcessor::nodeFoundCallBack(opc::Client& client, const UA_ReferenceDescription *ref, const std::string& path) {
     nodesFound_++;
     if(ref->nodeClass == UA_NODECLASS_VARIABLE)
     {
-      try {
-        opc::NodeData nodedata = connection_->getNodeData(ref);
-        OPCData2FlowFile(nodedata, context, session);
-        variablesFound_++;
-      } catch (const std::exception& exception) {
-        std::string browsename((char*)ref->browseName.name.data, ref->browseName.name.length);
-        logger_->log_warn("Caught Exception while trying to get data from node &s: %s", path + "/" + browsename,  exception.what());
-      }
+      variableNodes_.push_back(opc::copyNodeReference(ref));
     }
     return true;
   }
@@ -26,6 +26,8 @@
 
 //Standard includes
 #include <stdlib.h>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -115,7 +117,8 @@ namespace {
 
 Client::Client(std::shared_ptr<core::logging::Logger> logger, const std::string& applicationURI,
                const std::vector<char>& certBuffer, const std::vector<char>& keyBuffer,
-               const std::vector<std::vector<char>>& trustBuffers) {
+               const std::vector<std::vector<char>>& trustBuffers)
+  : subscriptionId_(0) {
 
   client_ = UA_Client_new();
   if (certBuffer.empty()) {
@@ -193,6 +196,10 @@ bool Client::isConnected() {
 }
 
 UA_StatusCode Client::connect(const std::string& url, const std::string& username, const std::string& password) {
+  // subscriptions do not survive the session they were created in
+  subscriptionId_ = 0;
+  monitoredNodes_.clear();
+  changedNodes_.clear();
   if (username.empty()) {
     return UA_Client_connect(client_, url.c_str());
   } else {
@@ -200,49 +207,237 @@ UA_StatusCode Client::connect(const std::string& url, const std::string& usernam
   }
 }
 
+NodeData Client::createNodeData(const UA_ReferenceDescription *ref, const std::string& basePath) {
+  opc::NodeData nodedata;
+  std::string browsename(reinterpret_cast<const char*>(ref->browseName.name.data), ref->browseName.name.length);
+
+  if(ref->nodeId.nodeId.identifierType == UA_NODEIDTYPE_STRING) {
+    std::string nodeidstr(reinterpret_cast<const char*>(ref->nodeId.nodeId.identifier.string.data),
+                          ref->nodeId.nodeId.identifier.string.length);
+    nodedata.attributes["NodeID"] = nodeidstr;
+    nodedata.attributes["NodeID type"] = "string";
+  } else if(ref->nodeId.nodeId.identifierType == UA_NODEIDTYPE_BYTESTRING) {
+    std::string nodeidstr(reinterpret_cast<const char*>(ref->nodeId.nodeId.identifier.byteString.data), ref->nodeId.nodeId.identifier.byteString.length);
+    nodedata.attributes["NodeID"] = nodeidstr;
+    nodedata.attributes["NodeID type"] = "bytestring";
+  } else if (ref->nodeId.nodeId.identifierType == UA_NODEIDTYPE_NUMERIC) {
+    nodedata.attributes["NodeID"] = std::to_string(ref->nodeId.nodeId.identifier.numeric);
+    nodedata.attributes["NodeID type"] = "numeric";
+  }
+  nodedata.attributes["Browsename"] = browsename;
+  nodedata.attributes["Full path"] = basePath + "/" + browsename;
+  nodedata.dataTypeID = UA_TYPES_COUNT;
+  return nodedata;
+}
+
+bool Client::addValue(NodeData& nodedata, UA_Variant *var) {
+  if (var->type == NULL || var->data == NULL) {
+    return false;
+  }
+  nodedata.dataTypeID = var->type->typeIndex;
+  nodedata.addVariant(var);
+  if(var->type->typeName) {
+    nodedata.attributes["Typename"] = std::string(var->type->typeName);
+  }
+  if(var->type->memSize) {
+    nodedata.attributes["Datasize"] = std::to_string(var->type->memSize);
+    nodedata.data = std::vector<uint8_t>(var->type->memSize);
+    memcpy(nodedata.data.data(), var->data, var->type->memSize);
+  }
+  return true;
+}
+
 NodeData Client::getNodeData(const UA_ReferenceDescription *ref, const std::string& basePath) {
   if(ref->nodeClass == UA_NODECLASS_VARIABLE)
   {
-    opc::NodeData nodedata;
-    std::string browsename(reinterpret_cast<const char*>(ref->browseName.name.data), ref->browseName.name.length);
-
-    if(ref->nodeId.nodeId.identifierType == UA_NODEIDTYPE_STRING) {
-      std::string nodeidstr(reinterpret_cast<const char*>(ref->nodeId.nodeId.identifier.string.data),
-                            ref->nodeId.nodeId.identifier.string.length);
-      nodedata.attributes["NodeID"] = nodeidstr;
-      nodedata.attributes["NodeID type"] = "string";
-    } else if(ref->nodeId.nodeId.identifierType == UA_NODEIDTYPE_BYTESTRING) {
-      std::string nodeidstr(reinterpret_cast<const char*>(ref->nodeId.nodeId.identifier.byteString.data), ref->nodeId.nodeId.identifier.byteString.length);
-      nodedata.attributes["NodeID"] = nodeidstr;
-      nodedata.attributes["NodeID type"] = "bytestring";
-    } else if (ref->nodeId.nodeId.identifierType == UA_NODEIDTYPE_NUMERIC) {
-      nodedata.attributes["NodeID"] = std::to_string(ref->nodeId.nodeId.identifier.numeric);
-      nodedata.attributes["NodeID type"] = "numeric";
-    }
-    nodedata.attributes["Browsename"] = browsename;
-    nodedata.attributes["Full path"] = basePath + "/" + browsename;
-    nodedata.dataTypeID = UA_TYPES_COUNT;
+    opc::NodeData nodedata = createNodeData(ref, basePath);
     UA_Variant* var = UA_Variant_new();
-    if(UA_Client_readValueAttribute(client_, ref->nodeId.nodeId, var) == UA_STATUSCODE_GOOD && var->type != NULL && var->data != NULL) {
-      nodedata.dataTypeID = var->type->typeIndex;
-      nodedata.addVariant(var);
-      if(var->type->typeName) {
-        nodedata.attributes["Typename"] = std::string(var->type->typeName);
-      }
-      if(var->type->memSize) {
-        nodedata.attributes["Datasize"] = std::to_string(var->type->memSize);
-        nodedata.data = std::vector<uint8_t>(var->type->memSize);
-        memcpy(nodedata.data.data(), var->data, var->type->memSize);
-      }
+    if(UA_Client_readValueAttribute(client_, ref->nodeId.nodeId, var) == UA_STATUSCODE_GOOD && addValue(nodedata, var)) {
       return nodedata;
     }
     UA_Variant_delete(var);
-    throw OPCException(GENERAL_EXCEPTION, "Failed to read value of node: " + browsename);
+    throw OPCException(GENERAL_EXCEPTION, "Failed to read value of node: " + nodedata.attributes["Browsename"]);
   } else {
     throw OPCException(GENERAL_EXCEPTION, "Only variable nodes are supported!");
   }
 }
 
+std::vector<NodeData> Client::readNodeData(const std::vector<NodeReference>& nodes, const std::string& basePath, size_t maxNodesPerRead) {
+  std::vector<NodeData> result;
+  result.reserve(nodes.size());
+  std::vector<UA_ReadValueId> nodesToRead;
+  for (size_t first = 0; first < nodes.size(); first += maxNodesPerRead) {
+    const size_t count = std::min(maxNodesPerRead, nodes.size() - first);
+    nodesToRead.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+      UA_ReadValueId_init(&nodesToRead[i]);
+      // shallow copy, the references outlive the request
+      nodesToRead[i].nodeId = nodes[first + i]->nodeId.nodeId;
+      nodesToRead[i].attributeId = UA_ATTRIBUTEID_VALUE;
+    }
+    UA_ReadRequest request;
+    UA_ReadRequest_init(&request);
+    request.nodesToRead = nodesToRead.data();
+    request.nodesToReadSize = count;
+
+    UA_ReadResponse response = UA_Client_Service_read(client_, request);
+    utils::ScopeGuard guard([&response]() {
+      UA_ReadResponse_deleteMembers(&response);
+    });
+    if (response.responseHeader.serviceResult != UA_STATUSCODE_GOOD || response.resultsSize != count) {
+      logger_->log_warn("Failed to read the values of %zu nodes: %s", count, UA_StatusCode_name(response.responseHeader.serviceResult));
+      continue;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      const UA_ReferenceDescription *ref = nodes[first + i].get();
+      UA_DataValue &value = response.results[i];
+      opc::NodeData nodedata = createNodeData(ref, basePath);
+      if (value.hasStatus && value.status != UA_STATUSCODE_GOOD) {
+        logger_->log_warn("Failed to read value of node %s: %s", nodedata.attributes["Browsename"], UA_StatusCode_name(value.status));
+        continue;
+      }
+      // take the value over from the response instead of copying it
+      UA_Variant* var = UA_Variant_new();
+      *var = value.value;
+      UA_Variant_init(&value.value);
+      if (!addValue(nodedata, var)) {
+        UA_Variant_delete(var);
+        logger_->log_warn("Failed to read value of node %s", nodedata.attributes["Browsename"]);
+        continue;
+      }
+      result.push_back(std::move(nodedata));
+    }
+  }
+  return result;
+}
+
+UA_StatusCode Client::subscribe(const std::vector<NodeReference>& nodes, double publishingInterval, size_t maxNodesPerRequest) {
+  unsubscribe();
+  monitoredNodes_ = nodes;
+
+  UA_CreateSubscriptionRequest request = UA_CreateSubscriptionRequest_default();
+  request.requestedPublishingInterval = publishingInterval;
+  UA_CreateSubscriptionResponse response = UA_Client_Subscriptions_create(client_, request, this, nullptr, &Client::subscriptionDeleted);
+  if (response.responseHeader.serviceResult != UA_STATUSCODE_GOOD) {
+    unsubscribe();
+    return response.responseHeader.serviceResult;
+  }
+  subscriptionId_ = response.subscriptionId;
+  logger_->log_debug("Created subscription %u with a publishing interval of %f ms", subscriptionId_, response.revisedPublishingInterval);
+
+  std::vector<UA_MonitoredItemCreateRequest> items;
+  std::vector<void*> contexts;
+  std::vector<UA_Client_DataChangeNotificationCallback> callbacks;
+  std::vector<UA_Client_DeleteMonitoredItemCallback> deleteCallbacks;
+  size_t monitored = 0;
+  UA_StatusCode itemStatus = UA_STATUSCODE_GOOD;
+  for (size_t first = 0; first < monitoredNodes_.size(); first += maxNodesPerRequest) {
+    const size_t count = std::min(maxNodesPerRequest, monitoredNodes_.size() - first);
+    items.clear();
+    contexts.clear();
+    for (size_t i = first; i < first + count; ++i) {
+      items.push_back(UA_MonitoredItemCreateRequest_default(monitoredNodes_[i]->nodeId.nodeId));
+      items.back().requestedParameters.samplingInterval = publishingInterval;
+      contexts.push_back(reinterpret_cast<void*>(static_cast<uintptr_t>(i)));
+    }
+    callbacks.assign(count, &Client::dataChangeNotification);
+    deleteCallbacks.assign(count, nullptr);
+
+    UA_CreateMonitoredItemsRequest itemsRequest;
+    UA_CreateMonitoredItemsRequest_init(&itemsRequest);
+    itemsRequest.subscriptionId = subscriptionId_;
+    itemsRequest.timestampsToReturn = UA_TIMESTAMPSTORETURN_SOURCE;
+    itemsRequest.itemsToCreate = items.data();
+    itemsRequest.itemsToCreateSize = count;
+
+    UA_CreateMonitoredItemsResponse itemsResponse = UA_Client_MonitoredItems_createDataChanges(client_, itemsRequest, contexts.data(), callbacks.data(), deleteCallbacks.data());
+    utils::ScopeGuard guard([&itemsResponse]() {
+      UA_CreateMonitoredItemsResponse_deleteMembers(&itemsResponse);
+    });
+    if (itemsResponse.responseHeader.serviceResult != UA_STATUSCODE_GOOD) {
+      // a subscription without its monitored items would report isSubscribed but never deliver changes
+      const UA_StatusCode sc = itemsResponse.responseHeader.serviceResult;
+      unsubscribe();
+      return sc;
+    }
+    for (size_t i = 0; i < itemsResponse.resultsSize; ++i) {
+      if (itemsResponse.results[i].statusCode == UA_STATUSCODE_GOOD) {
+        monitored++;
+      } else {
+        itemStatus = itemsResponse.results[i].statusCode;
+        std::string browsename(reinterpret_cast<const char*>(monitoredNodes_[first + i]->browseName.name.data), monitoredNodes_[first + i]->browseName.name.length);
+        logger_->log_warn("Failed to monitor node %s: %s", browsename, UA_StatusCode_name(itemsResponse.results[i].statusCode));
+      }
+    }
+  }
+  logger_->log_debug("Monitoring %zu of %zu nodes", monitored, monitoredNodes_.size());
+  if (monitored == 0 && itemStatus != UA_STATUSCODE_GOOD) {
+    unsubscribe();
+    return itemStatus;
+  }
+  return UA_STATUSCODE_GOOD;
+}
+
+void Client::unsubscribe() {
+  if (subscriptionId_ != 0) {
+    auto sc = UA_Client_Subscriptions_deleteSingle(client_, subscriptionId_);
+    if (sc != UA_STATUSCODE_GOOD) {
+      logger_->log_warn("Failed to delete subscription %u: %s", subscriptionId_, UA_StatusCode_name(sc));
+    }
+    subscriptionId_ = 0;
+  }
+  monitoredNodes_.clear();
+  changedNodes_.clear();
+}
+
+bool Client::isSubscribed() const {
+  return subscriptionId_ != 0;
+}
+
+std::vector<NodeData> Client::getChangedNodeData(uint16_t timeoutMs) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+  // a publish response is processed per iteration, keep going until something changed
+  while (changedNodes_.empty()) {
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+    if (remaining <= 0) {
+      break;
+    }
+    auto sc = UA_Client_run_iterate(client_, static_cast<UA_UInt16>(remaining));
+    if (sc != UA_STATUSCODE_GOOD) {
+      logger_->log_warn("Failed to process publish responses: %s", UA_StatusCode_name(sc));
+      break;
+    }
+  }
+  std::vector<NodeData> changed;
+  changed.swap(changedNodes_);
+  return changed;
+}
+
+void Client::dataChangeNotification(UA_Client *client, UA_UInt32 subId, void *subContext, UA_UInt32 monId, void *monContext, UA_DataValue *value) {
+  Client *self = static_cast<Client*>(subContext);
+  const size_t index = static_cast<size_t>(reinterpret_cast<uintptr_t>(monContext));
+  if (index >= self->monitoredNodes_.size() || !value->hasValue) {
+    return;
+  }
+  opc::NodeData nodedata = createNodeData(self->monitoredNodes_[index].get(), "");
+  // the notification is released by the client library once this returns
+  UA_Variant* var = UA_Variant_new();
+  if (UA_Variant_copy(&value->value, var) != UA_STATUSCODE_GOOD || !addValue(nodedata, var)) {
+    UA_Variant_delete(var);
+    self->logger_->log_warn("Failed to extract the changed value of node %s", nodedata.attributes["Browsename"]);
+    return;
+  }
+  self->changedNodes_.push_back(std::move(nodedata));
+}
+
+void Client::subscriptionDeleted(UA_Client *client, UA_UInt32 subId, void *subContext) {
+  Client *self = static_cast<Client*>(subContext);
+  if (self->subscriptionId_ == subId) {
+    self->logger_->log_debug("Subscription %u was deleted", subId);
+    self->subscriptionId_ = 0;
+  }
+}
+
 UA_ReferenceDescription * Client::getNodeReference(UA_NodeId nodeId) {
   UA_ReferenceDescription *ref = UA_ReferenceDescription_new();
   UA_ReferenceDescription_init(ref);
@@ -404,6 +599,14 @@ UA_StatusCode Client::update_node(const UA_NodeId nodeId, T value) {
   return sc;
 };
 
+NodeReference copyNodeReference(const UA_ReferenceDescription *ref) {
+  NodeReference copy(UA_ReferenceDescription_new(), [](UA_ReferenceDescription *reference) {
+    UA_ReferenceDescription_delete(reference);
+  });
+  UA_ReferenceDescription_copy(ref, copy.get());
+  return copy;
+}
+
 std::unique_ptr<Client> Client::createClient(std::shared_ptr<core::logging::Logger> logger, const std::string& applicationURI,
                                              const std::vector<char>& certBuffer, const std::vector<char>& keyBuffer,
                                              const std::vector<std::vector<char>>& trustBuffers) {
@@ -19,6 +19,7 @@
 #include "DatabaseContentRepository.h"
 #include <memory>
 #include <string>
+#include "RocksDbEnvironment.h"
 #include "RocksDbStream.h"
 #include "rocksdb/merge_operator.h"
 
@@ -36,10 +37,7 @@ bool DatabaseContentRepository::initialize(const std::shared_ptr<minifi::Configu
   } else {
     directory_ = configuration->getHome() + "/dbcontentrepository";
   }
-  rocksdb::Options options;
-  options.create_if_missing = true;
-  options.use_direct_io_for_flush_and_compaction = true;
-  options.use_direct_reads = true;
+  rocksdb::Options options = RocksDbEnvironment::getInstance().createOptions(configuration, Configure::nifi_dbcontent_repository_rocksdb_options);
   options.merge_operator = std::make_shared<StringAppender>();
   options.error_if_exists = false;
   options.max_successive_merges = 0;
@@ -17,8 +17,13 @@
  */
 #include "FlowFileRepository.h"
 #include "rocksdb/write_batch.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 #include "FlowFileRecord.h"
@@ -37,6 +42,7 @@ void FlowFileRepository::flush() {
   rocksdb::ReadOptions options;
 
   std::vector<std::shared_ptr<FlowFileRecord>> purgeList;
+  std::vector<std::shared_ptr<ResourceClaim>> releaseList;
 
   uint64_t decrement_total = 0;
   while (keys_to_delete.size_approx() > 0) {
@@ -51,6 +57,14 @@ void FlowFileRepository::flush() {
       batch.Delete(key);
     }
   }
+  std::pair<std::string, std::shared_ptr<ResourceClaim>> released;
+  while (claims_to_release_.try_dequeue(released)) {
+    db_->Get(options, released.first, &value);
+    decrement_total += value.size();
+    releaseList.push_back(released.second);
+    logger_->log_debug("Issuing batch delete, including %s, Content path %s", released.first, released.second->getContentFullPath());
+    batch.Delete(released.first);
+  }
   if (db_->Write(rocksdb::WriteOptions(), &batch).ok()) {
     logger_->log_trace("Decrementing %u from a repo size of %u", decrement_total, repo_size_.load());
     if (decrement_total > repo_size_.load()) {
@@ -67,6 +81,10 @@ void FlowFileRepository::flush() {
         content_repo_->removeIfOrphaned(claim);
       }
     }
+    // claims still owned are removed by their last owner, which no longer finds its record
+    for (const auto &claim : releaseList) {
+      content_repo_->removeIfOrphaned(claim);
+    }
   }
 }
 
@@ -90,52 +108,153 @@ void FlowFileRepository::run() {
   }
 }
 
+void FlowFileRepository::stop() {
+  if (!running_)
+    return;
+  Repository::stop();
+  flush();
+  // flow files left in the database can be recovered without a checkpoint on the next start
+  std::ofstream marker(directory_ + "/" + FLOWFILE_REPOSITORY_CLEAN_SHUTDOWN_MARKER);
+}
+
 void FlowFileRepository::prune_stored_flowfiles() {
-  rocksdb::DB* stored_database_;
-  bool corrupt_checkpoint = false;
-  if (nullptr != checkpoint_) {
-    rocksdb::Options options;
-    options.create_if_missing = true;
-    options.use_direct_io_for_flush_and_compaction = true;
-    options.use_direct_reads = true;
-    rocksdb::Status status = rocksdb::DB::OpenForReadOnly(options, FLOWFILE_CHECKPOINT_DIRECTORY, &stored_database_);
-    if (!status.ok()) {
-      stored_database_ = db_;
+  std::unique_ptr<rocksdb::DB> checkpoint_database;
+  rocksdb::DB *stored_database = db_;
+  if (nullptr != recovery_snapshot_) {
+    logger_->log_debug("Repository was closed cleanly, recovering without a checkpoint");
+  } else if (nullptr != checkpoint_) {
+    rocksdb::DB *database = nullptr;
+    rocksdb::Status status = rocksdb::DB::OpenForReadOnly(options_, FLOWFILE_CHECKPOINT_DIRECTORY, &database);
+    if (status.ok()) {
+      checkpoint_database.reset(database);
+      stored_database = database;
     }
   } else {
     logger_->log_trace("Could not open checkpoint as object doesn't exist. Likely not needed or file system error.");
     return;
   }
 
-  rocksdb::Iterator* it = stored_database_->NewIterator(rocksdb::ReadOptions());
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+  uint64_t expected = 0;
+  stored_database->GetIntProperty("rocksdb.estimate-num-keys", &expected);
+  recovery_expected_ = expected;
+  recovered_count_ = 0;
+  recovery_start_ms_ = getTimeMillis();
+  recovering_ = true;
+
+  // keys are flow file UUIDs, so the key space is split on the leading hex digit. The first and
+  // last ranges are unbounded so that every key falls into exactly one range.
+  static const char hex_digits[] = "0123456789abcdef";
+  const unsigned int ranges = std::min(16U, recovery_threads_);
+  std::vector<std::string> bounds;
+  bounds.push_back("");
+  for (unsigned int i = 1; i < ranges; i++) {
+    bounds.push_back(std::string(1, hex_digits[i * 16 / ranges]));
+  }
+  bounds.push_back("");
+
+  std::vector<std::vector<std::shared_ptr<ResourceClaim>>> orphaned_claims(ranges);
+  std::vector<std::thread> workers;
+  for (unsigned int i = 1; i < ranges; i++) {
+    workers.emplace_back(&FlowFileRepository::recover_range, this, stored_database, std::cref(bounds[i]), std::cref(bounds[i + 1]), std::ref(orphaned_claims[i]));
+  }
+  recover_range(stored_database, bounds[0], bounds[1], orphaned_claims[0]);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  for (const auto &claims : orphaned_claims) {
+    for (const auto &claim : claims) {
+      content_repo_->removeIfOrphaned(claim);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(recovered_claims_mutex_);
+    recovered_claims_.clear();
+  }
+
+  if (nullptr != recovery_snapshot_) {
+    db_->ReleaseSnapshot(recovery_snapshot_);
+    recovery_snapshot_ = nullptr;
+  }
+  recovery_end_ms_ = getTimeMillis();
+  recovering_ = false;
+  logger_->log_info("Recovered %llu flow files in %llu ms using %u threads", recovered_count_.load(), recovery_end_ms_ - recovery_start_ms_, ranges);
+}
+
+void FlowFileRepository::recover_range(rocksdb::DB *database, const std::string &lower, const std::string &upper, std::vector<std::shared_ptr<ResourceClaim>> &orphaned_claims) {
+  rocksdb::ReadOptions options;
+  if (database == db_) {
+    options.snapshot = recovery_snapshot_;
+  }
+  rocksdb::Slice upper_bound(upper);
+  if (!upper.empty()) {
+    options.iterate_upper_bound = &upper_bound;
+  }
+  std::unique_ptr<rocksdb::Iterator> it(database->NewIterator(options));
+  if (lower.empty()) {
+    it->SeekToFirst();
+  } else {
+    it->Seek(lower);
+  }
+
+  std::map<std::string, std::vector<std::shared_ptr<core::FlowFile>>> recovered;
+  size_t buffered = 0;
+  for (; it->Valid(); it->Next()) {
     std::shared_ptr<FlowFileRecord> eventRead = std::make_shared<FlowFileRecord>(shared_from_this(), content_repo_);
-    std::string key = it->key().ToString();
     repo_size_ += it->value().size();
     if (eventRead->DeSerialize(reinterpret_cast<const uint8_t *>(it->value().data()), it->value().size())) {
-      logger_->log_debug("Found connection for %s, path %s ", eventRead->getConnectionUuid(), eventRead->getContentFullPath());
-      auto search = connectionMap.find(eventRead->getConnectionUuid());
-      if (!corrupt_checkpoint && search != connectionMap.end()) {
-        // we find the connection for the persistent flowfile, create the flowfile and enqueue that
-        std::shared_ptr<core::FlowFile> flow_file_ref = std::static_pointer_cast<core::FlowFile>(eventRead);
+      if (connectionMap.find(eventRead->getConnectionUuid()) != connectionMap.end()) {
+        // we find the connection for the persistent flowfile, enqueue it with the rest of its batch
+        if (nullptr != eventRead->getResourceClaim()) {
+          std::shared_ptr<ResourceClaim> claim = intern_recovered_claim(eventRead->getResourceClaim());
+          claim->increaseFlowFileRecordOwnedCount();
+          eventRead->setResourceClaim(claim);
+        }
         eventRead->setStoredToRepository(true);
-        search->second->put(eventRead);
-      } else {
-        logger_->log_warn("Could not find connection for %s, path %s ", eventRead->getConnectionUuid(), eventRead->getContentFullPath());
-        if (eventRead->getContentFullPath().length() > 0) {
-          if (nullptr != eventRead->getResourceClaim()) {
-            content_repo_->remove(eventRead->getResourceClaim());
-          }
+        recovered[eventRead->getConnectionUuid()].push_back(eventRead);
+        if (++buffered >= FLOWFILE_REPOSITORY_RECOVERY_BATCH_SIZE) {
+          enqueue_recovered(recovered);
+          buffered = 0;
         }
-        keys_to_delete.enqueue(key);
+        continue;
+      }
+      logger_->log_warn("Could not find connection for %s, path %s ", eventRead->getConnectionUuid(), eventRead->getContentFullPath());
+      if (eventRead->getContentFullPath().length() > 0 && nullptr != eventRead->getResourceClaim()) {
+        std::shared_ptr<ResourceClaim> claim = intern_recovered_claim(eventRead->getResourceClaim());
+        orphaned_claims.push_back(claim);
+        // recovered flow files may share the content, so the record is not read back on deletion
+        Delete(it->key().ToString(), claim);
+        continue;
       }
-    } else {
-      keys_to_delete.enqueue(key);
     }
+    keys_to_delete.enqueue(it->key().ToString());
   }
+  enqueue_recovered(recovered);
+}
 
-  delete it;
+std::shared_ptr<ResourceClaim> FlowFileRepository::intern_recovered_claim(const std::shared_ptr<ResourceClaim> &claim) {
+  std::lock_guard<std::mutex> lock(recovered_claims_mutex_);
+  auto interned = recovered_claims_.insert(std::make_pair(claim->getContentFullPath(), claim));
+  return interned.first->second;
+}
 
+void FlowFileRepository::enqueue_recovered(std::map<std::string, std::vector<std::shared_ptr<core::FlowFile>>> &recovered) {
+  for (auto &entry : recovered) {
+    if (entry.second.empty()) {
+      continue;
+    }
+    auto search = connectionMap.find(entry.first);
+    auto connection = std::dynamic_pointer_cast<minifi::Connection>(search->second);
+    if (nullptr != connection) {
+      connection->multiPut(entry.second);
+    } else {
+      for (const auto &flow_file : entry.second) {
+        search->second->put(flow_file);
+      }
+    }
+    recovered_count_ += entry.second.size();
+    entry.second.clear();
+  }
 }
 
 /**
@@ -150,11 +269,21 @@ bool FlowFileRepository::need_checkpoint(){
   return false;
 }
 void FlowFileRepository::initialize_repository() {
+  if (nullptr != recovery_snapshot_) {
+    db_->ReleaseSnapshot(recovery_snapshot_);
+    recovery_snapshot_ = nullptr;
+  }
   // first we need to establish a checkpoint iff it is needed.
   if (!need_checkpoint()){
     logger_->log_trace("Do not need checkpoint");
     return;
   }
+  if (clean_shutdown_) {
+    // the database is consistent, so a snapshot isolates recovery from new flow files
+    recovery_snapshot_ = db_->GetSnapshot();
+    logger_->log_trace("Using snapshot instead of checkpoint");
+    return;
+  }
   rocksdb::Checkpoint *checkpoint;
   // delete any previous copy
   if (utils::file::FileUtils::delete_dir(FLOWFILE_CHECKPOINT_DIRECTORY) >= 0 && rocksdb::Checkpoint::Create(db_, &checkpoint).ok()) {
@@ -18,6 +18,15 @@
 #ifndef LIBMINIFI_INCLUDE_CORE_REPOSITORY_FLOWFILEREPOSITORY_H_
 #define LIBMINIFI_INCLUDE_CORE_REPOSITORY_FLOWFILEREPOSITORY_H_
 
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 #include "utils/file/FileUtils.h"
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
@@ -28,6 +37,7 @@
 #include "Connection.h"
 #include "core/logging/LoggerConfiguration.h"
 #include "concurrentqueue.h"
+#include "RocksDbEnvironment.h"
 
 namespace org {
 namespace apache {
@@ -46,6 +56,8 @@ namespace repository {
 #define MAX_FLOWFILE_REPOSITORY_STORAGE_SIZE (10*1024*1024) // 10M
 #define MAX_FLOWFILE_REPOSITORY_ENTRY_LIFE_TIME (600000) // 10 minute
 #define FLOWFILE_REPOSITORY_PURGE_PERIOD (2000) // 2000 msec
+#define FLOWFILE_REPOSITORY_CLEAN_SHUTDOWN_MARKER "CLEAN_SHUTDOWN"
+#define FLOWFILE_REPOSITORY_RECOVERY_BATCH_SIZE 1000
 
 /**
  * Flow File repository
@@ -65,14 +77,20 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
         Repository(repo_name.length() > 0 ? repo_name : core::getClassName<FlowFileRepository>(), directory, maxPartitionMillis, maxPartitionBytes, purgePeriod),
         content_repo_(nullptr),
         checkpoint_(nullptr),
+        recovery_snapshot_(nullptr),
+        clean_shutdown_(false),
+        recovery_threads_(std::max(1U, std::min(16U, std::thread::hardware_concurrency()))),
         logger_(logging::LoggerFactory<FlowFileRepository>::getLogger()) {
     db_ = NULL;
   }
 
   // Destructor
   ~FlowFileRepository() {
-    if (db_)
+    if (db_) {
+      if (recovery_snapshot_)
+        db_->ReleaseSnapshot(recovery_snapshot_);
       delete db_;
+    }
   }
 
   virtual void flush();
@@ -95,13 +113,17 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
       }
     }
     logger_->log_debug("NiFi FlowFile Max Storage Time: [%d] ms", max_partition_millis_);
-    rocksdb::Options options;
-    options.create_if_missing = true;
-    options.use_direct_io_for_flush_and_compaction = true;
-    options.use_direct_reads = true;
-    rocksdb::Status status = rocksdb::DB::Open(options, directory_, &db_);
+    int recovery_threads = configure->getInt(Configure::nifi_flowfile_repository_recovery_threads, 0);
+    if (recovery_threads > 0) {
+      recovery_threads_ = recovery_threads;
+    }
+    options_ = RocksDbEnvironment::getInstance().createOptions(configure, Configure::nifi_flowfile_repository_rocksdb_options);
+    rocksdb::Status status = rocksdb::DB::Open(options_, directory_, &db_);
     if (status.ok()) {
       logger_->log_debug("NiFi FlowFile Repository database open %s success", directory_);
+      // the marker is only valid for the run that wrote it
+      const std::string marker = directory_ + "/" + FLOWFILE_REPOSITORY_CLEAN_SHUTDOWN_MARKER;
+      clean_shutdown_ = std::remove(marker.c_str()) == 0;
     } else {
       logger_->log_error("NiFi FlowFile Repository database open %s fail", directory_);
       return false;
@@ -111,6 +133,11 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
 
   virtual void run();
 
+  /**
+   * Stops the repository, recording that the database was closed cleanly.
+   */
+  virtual void stop();
+
   virtual bool Put(std::string key, const uint8_t *buf, size_t bufLen) {
     // persistent to the DB
     rocksdb::Slice value((const char *) buf, bufLen);
@@ -131,6 +158,18 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
     keys_to_delete.enqueue(key);
     return true;
   }
+  /**
+   * Deletes the key and removes the content of the claim after the deletion is written,
+   * unless a flow file owns the claim by then. Unlike Delete(key), this does not read the
+   * record back, so content shared with clones of the flow file is kept.
+   */
+  virtual bool Delete(std::string key, const std::shared_ptr<minifi::ResourceClaim> &claim) {
+    if (nullptr == claim) {
+      return Delete(key);
+    }
+    claims_to_release_.enqueue(std::make_pair(key, claim));
+    return true;
+  }
   /**
    * Sets the value from the provided key
    * @return status of the get operation.
@@ -155,6 +194,8 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
     if (running_) {
       return;
     }
+    // the marker only describes the database while the repository is stopped
+    std::remove((directory_ + "/" + FLOWFILE_REPOSITORY_CLEAN_SHUTDOWN_MARKER).c_str());
     running_ = true;
     thread_ = std::thread(&FlowFileRepository::run, shared_from_this());
     logger_->log_debug("%s Repository Monitor Thread Start", getName());
@@ -178,10 +219,38 @@ class FlowFileRepository : public core::Repository, public std::enable_shared_fr
    */
   void prune_stored_flowfiles();
 
+  /**
+   * Recovers the flow files with keys in [lower, upper). Empty bounds are unbounded.
+   * @param orphaned_claims claims of flow files whose connection no longer exists
+   */
+  void recover_range(rocksdb::DB *database, const std::string &lower, const std::string &upper, std::vector<std::shared_ptr<ResourceClaim>> &orphaned_claims);
+
+  /**
+   * Returns the claim recovered first for the path of claim, so that flow files cloned before
+   * the restart share one owned count again.
+   */
+  std::shared_ptr<ResourceClaim> intern_recovered_claim(const std::shared_ptr<ResourceClaim> &claim);
+
+  /**
+   * Enqueues recovered flow files into their connections.
+   */
+  void enqueue_recovered(std::map<std::string, std::vector<std::shared_ptr<core::FlowFile>>> &recovered);
+
   moodycamel::ConcurrentQueue<std::string> keys_to_delete;
+  moodycamel::ConcurrentQueue<std::pair<std::string, std::shared_ptr<ResourceClaim>>> claims_to_release_;
   std::shared_ptr<core::ContentRepository> content_repo_;
   rocksdb::DB* db_;
+  rocksdb::Options options_;
   std::unique_ptr<rocksdb::Checkpoint> checkpoint_;
+  // view of the database at load time, used instead of a checkpoint after a clean shutdown
+  const rocksdb::Snapshot *recovery_snapshot_;
+  // whether the previous run closed the database cleanly
+  bool clean_shutdown_;
+  // threads decoding stored flow files at startup
+  unsigned int recovery_threads_;
+  // claims recovered so far by content path, only populated while recovering
+  std::mutex recovered_claims_mutex_;
+  std::map<std::string, std::shared_ptr<ResourceClaim>> recovered_claims_;
   std::shared_ptr<logging::Logger> logger_;
 };
 
@@ -18,6 +18,8 @@
 
 #include "ProvenanceRepository.h"
 #include "rocksdb/write_batch.h"
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 #include "rocksdb/options.h"
@@ -28,6 +30,9 @@ namespace nifi {
 namespace minifi {
 namespace provenance {
 
+const char *ProvenanceRepository::CursorColumnFamily = "cursor";
+const char *ProvenanceRepository::CursorKey = "minifi.provenance.cursor";
+
 void ProvenanceRepository::flush() {
   rocksdb::WriteBatch batch;
   std::string key;
@@ -85,6 +90,55 @@ void ProvenanceRepository::run() {
       repo_full_ = false;
   }
 }
+size_t ProvenanceRepository::DeSerializeFromCursor(size_t max_size, const std::shared_ptr<core::SerializableComponent> &record,
+                                                   const std::function<bool(const std::string &key)> &visitor) {
+  std::string cursor;
+  if (!db_->Get(rocksdb::ReadOptions(), cursor_handle_, CursorKey, &cursor).ok()) {
+    cursor.clear();
+  }
+
+  std::unique_ptr<rocksdb::Iterator> it(db_->NewIterator(rocksdb::ReadOptions()));
+  size_t visited = 0;
+  // the first pass covers the keys after the cursor, the second wraps around to those before it
+  for (int pass = 0; pass < 2 && visited < max_size; pass++) {
+    if (pass == 0 && !cursor.empty()) {
+      it->Seek(cursor);
+    } else if (pass == 0 || !cursor.empty()) {
+      it->SeekToFirst();
+    } else {
+      break;
+    }
+    for (; it->Valid() && visited < max_size; it->Next()) {
+      rocksdb::Slice key = it->key();
+      if (pass == 1 && key.compare(cursor) >= 0) {
+        break;
+      }
+      if (pass == 0 && key == cursor) {
+        continue;
+      }
+      if (record->DeSerialize(reinterpret_cast<const uint8_t*>(it->value().data()), it->value().size())) {
+        visited++;
+        if (!visitor(key.ToString())) {
+          return visited;
+        }
+      }
+    }
+  }
+  return visited;
+}
+
+bool ProvenanceRepository::DeleteAndAdvanceCursor(const std::vector<std::string> &keys, const std::string &cursor) {
+  // one write, so the records and the position past them can never disagree
+  rocksdb::WriteBatch batch;
+  for (const auto &key : keys) {
+    batch.Delete(key);
+  }
+  if (!cursor.empty()) {
+    batch.Put(cursor_handle_, CursorKey, cursor);
+  }
+  return db_->Write(rocksdb::WriteOptions(), &batch).ok();
+}
+
 } /* namespace provenance */
 } /* namespace minifi */
 } /* namespace nifi */
@@ -17,6 +17,7 @@
 #ifndef LIBMINIFI_INCLUDE_PROVENANCE_PROVENANCEREPOSITORY_H_
 #define LIBMINIFI_INCLUDE_PROVENANCE_PROVENANCEREPOSITORY_H_
 
+#include <vector>
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
 #include "rocksdb/slice.h"
@@ -25,6 +26,7 @@
 #include "provenance/Provenance.h"
 #include "core/logging/LoggerConfiguration.h"
 #include "concurrentqueue.h"
+#include "RocksDbEnvironment.h"
 namespace org {
 namespace apache {
 namespace nifi {
@@ -54,12 +56,12 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
         Repository(repo_name.length() > 0 ? repo_name : core::getClassName<ProvenanceRepository>(), directory, maxPartitionMillis, maxPartitionBytes, purgePeriod),
         logger_(logging::LoggerFactory<ProvenanceRepository>::getLogger()) {
     db_ = NULL;
+    cursor_handle_ = NULL;
   }
 
   // Destructor
   virtual ~ProvenanceRepository() {
-    if (db_)
-      delete db_;
+    destroy();
   }
 
   virtual void flush();
@@ -91,12 +93,17 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
       }
     }
     logger_->log_debug("NiFi Provenance Max Storage Time: [%d] ms", max_partition_millis_);
-    rocksdb::Options options;
-    options.create_if_missing = true;
-    options.use_direct_io_for_flush_and_compaction = true;
-    options.use_direct_reads = true;
-    rocksdb::Status status = rocksdb::DB::Open(options, directory_, &db_);
+    rocksdb::Options options = core::repository::RocksDbEnvironment::getInstance().createOptions(config, Configure::nifi_provenance_repository_rocksdb_options);
+    options.create_missing_column_families = true;
+    // the events are kept in the default column family, the reporting cursor in a family of its own
+    std::vector<rocksdb::ColumnFamilyDescriptor> column_families;
+    column_families.emplace_back(rocksdb::kDefaultColumnFamilyName, rocksdb::ColumnFamilyOptions(options));
+    column_families.emplace_back(CursorColumnFamily, rocksdb::ColumnFamilyOptions(options));
+    std::vector<rocksdb::ColumnFamilyHandle*> handles;
+    rocksdb::Status status = rocksdb::DB::Open(rocksdb::DBOptions(options), directory_, column_families, &handles, &db_);
     if (status.ok()) {
+      column_family_handles_ = handles;
+      cursor_handle_ = handles[1];
       logger_->log_debug("NiFi Provenance Repository database open %s success", directory_);
     } else {
       logger_->log_error("NiFi Provenance Repository database open %s fail", directory_);
@@ -183,6 +190,10 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
       return false;
     }
   }
+  virtual size_t DeSerializeFromCursor(size_t max_size, const std::shared_ptr<core::SerializableComponent> &record, const std::function<bool(const std::string &key)> &visitor);
+
+  virtual bool DeleteAndAdvanceCursor(const std::vector<std::string> &keys, const std::string &cursor);
+
   //! get record
   void getProvenanceRecord(std::vector<std::shared_ptr<ProvenanceEventRecord>> &records, int maxSize) {
     rocksdb::Iterator* it = db_->NewIterator(rocksdb::ReadOptions());
@@ -227,6 +238,11 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
   }
   // destroy
   void destroy() {
+    for (auto handle : column_family_handles_) {
+      delete handle;
+    }
+    column_family_handles_.clear();
+    cursor_handle_ = NULL;
     if (db_) {
       delete db_;
       db_ = NULL;
@@ -241,8 +257,15 @@ class ProvenanceRepository : public core::Repository, public std::enable_shared_
   ProvenanceRepository &operator=(const ProvenanceRepository &parent) = delete;
 
  private:
+  // column family holding the scan position of DeSerializeFromCursor, apart from the events
+  static const char *CursorColumnFamily;
+  // key of the scan position in the cursor column family
+  static const char *CursorKey;
+
   moodycamel::ConcurrentQueue<std::string> keys_to_delete;
   rocksdb::DB* db_;
+  std::vector<rocksdb::ColumnFamilyHandle*> column_family_handles_;
+  rocksdb::ColumnFamilyHandle* cursor_handle_;
   std::shared_ptr<logging::Logger> logger_;
 };
 
@@ -0,0 +1,164 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RocksDbEnvironment.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "rocksdb/convenience.h"
+#include "rocksdb/env.h"
+#include "rocksdb/filter_policy.h"
+#include "rocksdb/table.h"
+#include "core/MemoryGovernor.h"
+#include "core/Property.h"
+#include "core/logging/LoggerConfiguration.h"
+#include "utils/StringUtils.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+namespace repository {
+
+RocksDbEnvironment::RocksDbEnvironment()
+    : configured_(false),
+      background_jobs_(2),
+      logger_(logging::LoggerFactory<RocksDbEnvironment>::getLogger()) {
+}
+
+void RocksDbEnvironment::configure(const std::shared_ptr<Configure> &configure) {
+  std::string value;
+  uint64_t memory_limit = 0;
+  if (configure->get(Configure::nifi_rocksdb_memory_limit, value) && !core::Property::StringToInt(value, memory_limit)) {
+    logger_->log_error("Invalid RocksDB memory limit %s, memory is not limited", value);
+    memory_limit = 0;
+  }
+  if (memory_limit > 0) {
+    // memtables are charged to the cache, so the limit covers both
+    block_cache_ = rocksdb::NewLRUCache(memory_limit);
+    write_buffer_manager_ = std::make_shared<rocksdb::WriteBufferManager>(memory_limit / 2, block_cache_);
+  } else {
+    // without a limit each database keeps its own memtable budget, as without a shared environment
+    block_cache_ = rocksdb::NewLRUCache(ROCKSDB_DEFAULT_BLOCK_CACHE_SIZE);
+    write_buffer_manager_ = nullptr;
+  }
+  // cached blocks can be read again, so the cache gives memory back to the agent under pressure
+  auto cache = block_cache_;
+  const size_t capacity = cache->GetCapacity();
+  core::MemoryGovernor::getInstance().registerReclaimer([cache, capacity](uint64_t excess) {
+    if (excess == 0) {
+      cache->SetCapacity(capacity);
+      return;
+    }
+    const size_t usage = cache->GetUsage();
+    cache->SetCapacity(std::max<size_t>(usage > excess ? usage - excess : 0, ROCKSDB_MIN_BLOCK_CACHE_SIZE));
+  });
+
+  auto env = rocksdb::Env::Default();
+  const int compaction_threads = configure->getInt(Configure::nifi_rocksdb_compaction_threads, 0);
+  if (compaction_threads > 0) {
+    env->SetBackgroundThreads(compaction_threads, rocksdb::Env::LOW);
+  }
+  const int flush_threads = configure->getInt(Configure::nifi_rocksdb_flush_threads, 0);
+  if (flush_threads > 0) {
+    env->SetBackgroundThreads(flush_threads, rocksdb::Env::HIGH);
+  }
+  if (compaction_threads > 0 || flush_threads > 0) {
+    // every database may use all of the shared threads
+    background_jobs_ = std::max(1, compaction_threads) + std::max(1, flush_threads);
+  }
+
+  bool statistics = false;
+  if (configure->get(Configure::nifi_rocksdb_statistics, value) && utils::StringUtils::StringToBool(value, statistics) && statistics) {
+    statistics_ = rocksdb::CreateDBStatistics();
+  }
+  logger_->log_debug("RocksDB memory limit %llu, %d background jobs, statistics %s", memory_limit, background_jobs_, statistics ? "enabled" : "disabled");
+}
+
+rocksdb::Options RocksDbEnvironment::createOptions(const std::shared_ptr<Configure> &configure, const std::string &options_prefix) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!configured_) {
+      this->configure(configure);
+      configured_ = true;
+    }
+  }
+
+  rocksdb::Options options;
+  options.create_if_missing = true;
+  options.use_direct_io_for_flush_and_compaction = true;
+  options.use_direct_reads = true;
+  options.env = rocksdb::Env::Default();
+  options.max_background_jobs = background_jobs_;
+  options.write_buffer_manager = write_buffer_manager_;
+  options.statistics = statistics_;
+
+  std::string value;
+  uint64_t write_buffer_size = 0;
+  if (configure->get(options_prefix + "write.buffer.size", value) && core::Property::StringToInt(value, write_buffer_size) && write_buffer_size > 0) {
+    options.write_buffer_size = write_buffer_size;
+  }
+
+  if (configure->get(options_prefix + "compaction.style", value)) {
+    static const std::map<std::string, rocksdb::CompactionStyle> styles = { { "level", rocksdb::kCompactionStyleLevel }, { "universal", rocksdb::kCompactionStyleUniversal }, { "fifo",
+        rocksdb::kCompactionStyleFIFO } };
+    auto style = styles.find(utils::StringUtils::trim(value));
+    if (style != styles.end()) {
+      options.compaction_style = style->second;
+    } else {
+      logger_->log_error("Unknown compaction style %s for %s, using level compaction", value, options_prefix);
+    }
+  }
+
+  // the default depends on the libraries RocksDB was built with
+  if (configure->get(options_prefix + "compression", value)) {
+    static const std::map<std::string, rocksdb::CompressionType> compressions = { { "none", rocksdb::kNoCompression }, { "snappy", rocksdb::kSnappyCompression }, { "zlib",
+        rocksdb::kZlibCompression }, { "bzip2", rocksdb::kBZip2Compression }, { "lz4", rocksdb::kLZ4Compression }, { "lz4hc", rocksdb::kLZ4HCCompression }, { "zstd", rocksdb::kZSTD } };
+    auto compression = compressions.find(utils::StringUtils::trim(value));
+    if (compression == compressions.end()) {
+      logger_->log_error("Unknown compression %s for %s", value, options_prefix);
+    } else {
+      const auto supported = rocksdb::GetSupportedCompressions();
+      if (compression->second == rocksdb::kNoCompression || std::find(supported.begin(), supported.end(), compression->second) != supported.end()) {
+        options.compression = compression->second;
+      } else {
+        logger_->log_error("Compression %s for %s is not available in this build, storing uncompressed", value, options_prefix);
+        options.compression = rocksdb::kNoCompression;
+      }
+    }
+  }
+
+  rocksdb::BlockBasedTableOptions table_options;
+  table_options.block_cache = block_cache_;
+  int bloom_filter_bits = configure->getInt(options_prefix + "bloom.filter.bits", 0);
+  if (bloom_filter_bits > 0) {
+    table_options.filter_policy.reset(rocksdb::NewBloomFilterPolicy(bloom_filter_bits, false));
+  }
+  options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+  return options;
+}
+
+} /* namespace repository */
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
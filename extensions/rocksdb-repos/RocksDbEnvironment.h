@@ -0,0 +1,109 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_ROCKSDB_REPOS_ROCKSDBENVIRONMENT_H_
+#define EXTENSIONS_ROCKSDB_REPOS_ROCKSDBENVIRONMENT_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "rocksdb/cache.h"
+#include "rocksdb/options.h"
+#include "rocksdb/statistics.h"
+#include "rocksdb/write_buffer_manager.h"
+#include "properties/Configure.h"
+#include "core/logging/Logger.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+namespace repository {
+
+#define ROCKSDB_DEFAULT_BLOCK_CACHE_SIZE (8*1024*1024) // 8M
+#define ROCKSDB_MIN_BLOCK_CACHE_SIZE (1024*1024) // 1M
+
+/**
+ * Purpose: The RocksDB resources every repository database of the agent shares: the background
+ * threads of the default Env, one block cache, one write buffer manager and, when enabled, one
+ * statistics object.
+ *
+ * Justification: Each database would otherwise size its own cache and memtables, which wastes memory
+ * on small devices and can't be bounded as a whole. With nifi.rocksdb.memory.limit the memtables are
+ * charged to the block cache, so that both together stay within the limit.
+ *
+ * The first repository to initialize configures the environment; later configurations are ignored.
+ * While the MemoryGovernor is under pressure the block cache is shrunk by the excess.
+ */
+class RocksDbEnvironment {
+ public:
+  static RocksDbEnvironment &getInstance() {
+    static RocksDbEnvironment environment;
+    return environment;
+  }
+
+  /**
+   * Creates the options for a database of a repository. The shared resources are set up from the
+   * nifi.rocksdb.* properties on the first call. Compaction style, compression, bloom filters and
+   * the memtable size are read from the properties starting with options_prefix.
+   */
+  rocksdb::Options createOptions(const std::shared_ptr<Configure> &configure, const std::string &options_prefix);
+
+  std::shared_ptr<rocksdb::Cache> getBlockCache() const {
+    return block_cache_;
+  }
+
+  /**
+   * Returns the manager charging the memtables to the block cache, or nullptr if
+   * nifi.rocksdb.memory.limit is not set.
+   */
+  std::shared_ptr<rocksdb::WriteBufferManager> getWriteBufferManager() const {
+    return write_buffer_manager_;
+  }
+
+  /**
+   * Returns the statistics of all databases, or nullptr if nifi.rocksdb.statistics is not enabled.
+   */
+  std::shared_ptr<rocksdb::Statistics> getStatistics() const {
+    return statistics_;
+  }
+
+ protected:
+  RocksDbEnvironment();
+
+  void configure(const std::shared_ptr<Configure> &configure);
+
+ private:
+  std::mutex mutex_;
+  bool configured_;
+  int background_jobs_;
+  std::shared_ptr<rocksdb::Cache> block_cache_;
+  std::shared_ptr<rocksdb::WriteBufferManager> write_buffer_manager_;
+  std::shared_ptr<rocksdb::Statistics> statistics_;
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+} /* namespace repository */
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_ROCKSDB_REPOS_ROCKSDBENVIRONMENT_H_ */
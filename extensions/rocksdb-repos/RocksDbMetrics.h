@@ -0,0 +1,115 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_ROCKSDB_REPOS_ROCKSDBMETRICS_H_
+#define EXTENSIONS_ROCKSDB_REPOS_ROCKSDBMETRICS_H_
+
+#include <string>
+#include <vector>
+#include "core/Resource.h"
+#include "core/state/nodes/MetricsBase.h"
+#include "RocksDbEnvironment.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace state {
+namespace response {
+
+/**
+ * Justification and Purpose: Provides the memory use of the RocksDB databases backing the repositories
+ * and, when nifi.rocksdb.statistics is enabled, the RocksDB tickers that have counted anything.
+ */
+class RocksDbMetrics : public ResponseNode {
+ public:
+
+  RocksDbMetrics(const std::string &name, utils::Identifier &uuid)
+      : ResponseNode(name, uuid) {
+  }
+
+  RocksDbMetrics(const std::string &name)
+      : ResponseNode(name) {
+  }
+
+  RocksDbMetrics()
+      : ResponseNode("RocksDbMetrics") {
+  }
+
+  virtual std::string getName() const {
+    return "RocksDbMetrics";
+  }
+
+  std::vector<SerializedResponseNode> serialize() {
+    std::vector<SerializedResponseNode> serialized;
+    auto &environment = core::repository::RocksDbEnvironment::getInstance();
+
+    auto cache = environment.getBlockCache();
+    if (cache != nullptr) {
+      SerializedResponseNode usage;
+      usage.name = "blockCacheUsage";
+      usage.value = static_cast<uint64_t>(cache->GetUsage());
+      serialized.push_back(usage);
+
+      SerializedResponseNode capacity;
+      capacity.name = "blockCacheCapacity";
+      capacity.value = static_cast<uint64_t>(cache->GetCapacity());
+      serialized.push_back(capacity);
+    }
+
+    auto write_buffer_manager = environment.getWriteBufferManager();
+    if (write_buffer_manager != nullptr && write_buffer_manager->enabled()) {
+      SerializedResponseNode usage;
+      usage.name = "memtableUsage";
+      usage.value = static_cast<uint64_t>(write_buffer_manager->memory_usage());
+      serialized.push_back(usage);
+
+      SerializedResponseNode limit;
+      limit.name = "memtableLimit";
+      limit.value = static_cast<uint64_t>(write_buffer_manager->buffer_size());
+      serialized.push_back(limit);
+    }
+
+    auto statistics = environment.getStatistics();
+    if (statistics != nullptr) {
+      SerializedResponseNode tickers;
+      tickers.name = "statistics";
+      for (const auto &ticker : rocksdb::TickersNameMap) {
+        const uint64_t count = statistics->getTickerCount(ticker.first);
+        if (count > 0) {
+          SerializedResponseNode node;
+          node.name = ticker.second;
+          node.value = count;
+          tickers.children.push_back(node);
+        }
+      }
+      serialized.push_back(tickers);
+    }
+    return serialized;
+  }
+};
+
+REGISTER_RESOURCE(RocksDbMetrics, "Node part of an AST that defines the memory use and statistics of the RocksDB repositories");
+
+} /* namespace response */
+} /* namespace state */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_ROCKSDB_REPOS_ROCKSDBMETRICS_H_ */
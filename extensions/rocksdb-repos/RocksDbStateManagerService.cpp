@@ -0,0 +1,206 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "RocksDbStateManagerService.h"
+#include <set>
+#include <string>
+#include <unordered_map>
+#include "core/Property.h"
+#include "utils/StringUtils.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+core::Property RocksDbStateManagerService::Directory(
+    core::PropertyBuilder::createProperty("Directory")->withDescription("Path to a directory for the database")->isRequired(true)->withDefaultValue("corecomponentstate")->build());
+
+core::Property RocksDbStateManagerService::AlwaysPersist(
+    core::PropertyBuilder::createProperty("Always Persist")->withDescription("Sync every change to disk instead of syncing periodically. "
+                                                                             "Every change then waits for the write ahead log to be synced.")
+        ->isRequired(false)->withDefaultValue<bool>(false)->build());
+
+core::Property RocksDbStateManagerService::AutoPersistenceInterval(
+    core::PropertyBuilder::createProperty("Auto Persistence Interval")->withDescription("The interval of the periodic task syncing the changes written since the last run to disk. "
+                                                                                        "Has no effect when Always Persist is set.")
+        ->isRequired(false)->withDefaultValue("1 min")->build());
+
+void RocksDbStateManagerService::initialize() {
+  ControllerService::initialize();
+  std::set<core::Property> supportedProperties;
+  supportedProperties.insert(Directory);
+  supportedProperties.insert(AlwaysPersist);
+  supportedProperties.insert(AutoPersistenceInterval);
+  setSupportedProperties(supportedProperties);
+}
+
+void RocksDbStateManagerService::onEnable() {
+  notifyStop();
+
+  std::string value;
+  if (!getProperty(Directory.getName(), directory_) || directory_.empty()) {
+    directory_ = "corecomponentstate";
+  }
+  always_persist_ = false;
+  if (getProperty(AlwaysPersist.getName(), value)) {
+    utils::StringUtils::StringToBool(value, always_persist_);
+  }
+  if (getProperty(AutoPersistenceInterval.getName(), value)) {
+    int64_t interval;
+    core::TimeUnit unit;
+    if (core::Property::StringToTime(value, interval, unit) && core::Property::ConvertTimeUnitToMS(interval, unit, interval) && interval > 0) {
+      auto_persistence_interval_ms_ = interval;
+    } else {
+      logger_->log_warn("Invalid Auto Persistence Interval %s, using %llu ms", value, auto_persistence_interval_ms_);
+    }
+  }
+
+  rocksdb::Options options;
+  options.create_if_missing = true;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rocksdb::Status status = rocksdb::DB::Open(options, directory_, &db_);
+    if (!status.ok()) {
+      logger_->log_error("Failed to open component state database %s: %s", directory_, status.ToString());
+      db_ = nullptr;
+      return;
+    }
+  }
+  // every update is written to the WAL right away; it is only synced on every write when requested
+  write_options_ = rocksdb::WriteOptions();
+  write_options_.sync = always_persist_;
+  unsynced_ = false;
+  logger_->log_debug("Component state database %s open, always persist: %s", directory_, always_persist_ ? "true" : "false");
+
+  if (!always_persist_) {
+    std::lock_guard<std::mutex> lock(persistence_mutex_);
+    running_ = true;
+    persistence_thread_ = std::thread(&RocksDbStateManagerService::persistenceLoop, this);
+  }
+}
+
+void RocksDbStateManagerService::notifyStop() {
+  {
+    std::lock_guard<std::mutex> lock(persistence_mutex_);
+    running_ = false;
+  }
+  persistence_condition_.notify_all();
+  if (persistence_thread_.joinable()) {
+    persistence_thread_.join();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (db_ != nullptr) {
+    persistLocked();
+    delete db_;
+    db_ = nullptr;
+  }
+}
+
+bool RocksDbStateManagerService::set(const std::string &component_id, const std::unordered_map<std::string, std::string> &state) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (db_ == nullptr) {
+    return false;
+  }
+  rocksdb::Status status = db_->Put(write_options_, component_id, serialize(state));
+  if (!status.ok()) {
+    logger_->log_error("Failed to write state of %s: %s", component_id, status.ToString());
+    return false;
+  }
+  unsynced_ = !always_persist_;
+  return true;
+}
+
+bool RocksDbStateManagerService::get(const std::string &component_id, std::unordered_map<std::string, std::string> &state) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (db_ == nullptr) {
+    return false;
+  }
+  std::string value;
+  rocksdb::Status status = db_->Get(rocksdb::ReadOptions(), component_id, &value);
+  if (!status.ok()) {
+    if (!status.IsNotFound()) {
+      logger_->log_error("Failed to read state of %s: %s", component_id, status.ToString());
+    }
+    return false;
+  }
+  if (!deserialize(value, state)) {
+    logger_->log_error("Invalid state stored for %s", component_id);
+    return false;
+  }
+  return true;
+}
+
+bool RocksDbStateManagerService::clear(const std::string &component_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (db_ == nullptr) {
+    return false;
+  }
+  rocksdb::Status status = db_->Delete(write_options_, component_id);
+  if (!status.ok()) {
+    logger_->log_error("Failed to clear state of %s: %s", component_id, status.ToString());
+    return false;
+  }
+  unsynced_ = !always_persist_;
+  return true;
+}
+
+bool RocksDbStateManagerService::persist() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (db_ == nullptr) {
+    return false;
+  }
+  return persistLocked();
+}
+
+bool RocksDbStateManagerService::persistLocked() {
+  if (!unsynced_) {
+    return true;
+  }
+  rocksdb::Status status = db_->SyncWAL();
+  if (!status.ok()) {
+    logger_->log_error("Failed to sync the component state write ahead log: %s", status.ToString());
+    return false;
+  }
+  // moving the updates out of the log is left to the background threads
+  rocksdb::FlushOptions options;
+  options.wait = false;
+  status = db_->Flush(options);
+  if (!status.ok()) {
+    logger_->log_warn("Failed to flush component state: %s", status.ToString());
+  }
+  logger_->log_trace("Synced the component state write ahead log");
+  unsynced_ = false;
+  return true;
+}
+
+void RocksDbStateManagerService::persistenceLoop() {
+  std::unique_lock<std::mutex> lock(persistence_mutex_);
+  while (running_) {
+    persistence_condition_.wait_for(lock, std::chrono::milliseconds(auto_persistence_interval_ms_), [this] {return !running_;});
+    if (running_) {
+      persist();
+    }
+  }
+}
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
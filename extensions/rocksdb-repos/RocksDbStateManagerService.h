@@ -0,0 +1,122 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_ROCKSDB_REPOS_ROCKSDBSTATEMANAGERSERVICE_H_
+#define EXTENSIONS_ROCKSDB_REPOS_ROCKSDBSTATEMANAGERSERVICE_H_
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include "rocksdb/db.h"
+#include "rocksdb/options.h"
+#include "core/Resource.h"
+#include "controllers/StateManagerService.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+/**
+ * Purpose: Stores component state in a RocksDB database.
+ *
+ * Design: Every update is written to the database, and so to its write ahead log, before
+ * it returns, so that it survives a crash of the agent. With Always Persist the log is also
+ * synced before the update returns; otherwise a background thread syncs it periodically,
+ * so that only a crash of the host loses the updates since the last run.
+ */
+class RocksDbStateManagerService : public StateManagerService {
+ public:
+  explicit RocksDbStateManagerService(const std::string &name, const std::string &id)
+      : StateManagerService(name, id),
+        always_persist_(false),
+        auto_persistence_interval_ms_(60000),
+        unsynced_(false),
+        running_(false),
+        db_(nullptr),
+        logger_(logging::LoggerFactory<RocksDbStateManagerService>::getLogger()) {
+  }
+
+  explicit RocksDbStateManagerService(const std::string &name, utils::Identifier uuid = utils::Identifier())
+      : StateManagerService(name, uuid),
+        always_persist_(false),
+        auto_persistence_interval_ms_(60000),
+        unsynced_(false),
+        running_(false),
+        db_(nullptr),
+        logger_(logging::LoggerFactory<RocksDbStateManagerService>::getLogger()) {
+  }
+
+  virtual ~RocksDbStateManagerService() {
+    notifyStop();
+  }
+
+  static core::Property Directory;
+  static core::Property AlwaysPersist;
+  static core::Property AutoPersistenceInterval;
+
+  virtual void initialize();
+
+  virtual void onEnable();
+
+  virtual void notifyStop();
+
+  virtual bool set(const std::string &component_id, const std::unordered_map<std::string, std::string> &state);
+
+  virtual bool get(const std::string &component_id, std::unordered_map<std::string, std::string> &state);
+
+  virtual bool clear(const std::string &component_id);
+
+  virtual bool persist();
+
+ private:
+  bool persistLocked();
+
+  void persistenceLoop();
+
+  std::string directory_;
+  bool always_persist_;
+  uint64_t auto_persistence_interval_ms_;
+
+  // guards db_ and unsynced_
+  std::mutex mutex_;
+  // true if updates were written since the write ahead log was last synced
+  bool unsynced_;
+
+  std::mutex persistence_mutex_;
+  std::condition_variable persistence_condition_;
+  bool running_;
+  std::thread persistence_thread_;
+
+  rocksdb::DB *db_;
+  rocksdb::WriteOptions write_options_;
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+REGISTER_RESOURCE(RocksDbStateManagerService, "Stores the state of processors in a RocksDB database so that they resume where they left off after a restart.");
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_ROCKSDB_REPOS_ROCKSDBSTATEMANAGERSERVICE_H_ */
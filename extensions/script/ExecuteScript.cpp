@@ -66,10 +66,6 @@ void ExecuteScript::initialize() {
   relationships.insert(Success);
   relationships.insert(Failure);
   setSupportedRelationships(std::move(relationships));
-
-#ifdef PYTHON_SUPPORT
-  python::PythonScriptEngine::initialize();
-#endif  // PYTHON_SUPPORT
 }
 
 void ExecuteScript::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
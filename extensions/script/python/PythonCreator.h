@@ -64,10 +64,6 @@ class PythonCreator : public minifi::core::CoreComponent {
   }
 
   virtual void configure(const std::shared_ptr<Configure> &configuration) override {
-
-    python::PythonScriptEngine::initialize();
-
-    auto engine = std::make_shared<python::PythonScriptEngine>();
     std::string pathListings;
 
     // assuming we have the options set and can access the PythonCreator
@@ -92,50 +88,64 @@ class PythonCreator : public minifi::core::CoreComponent {
 
       core::ClassLoader::getDefaultClassLoader().registerResource("", "createPyProcFactory");
 
-      for (const auto &path : classpaths_) {
-        const auto &scriptName = getScriptName(path);
-
-        utils::Identifier uuid;
+      if (core::ClassLoader::getDefaultClassLoader().isLazyInitialization()) {
+        // describing a processor loads its script, so leave it until the manifest is built
+        const auto classpaths = classpaths_;
+        const auto logger = logger_;
+        minifi::ExternalBuildDescription::addDeferredDescriber([classpaths, pathListings, logger]() {
+          describe(classpaths, pathListings, logger);
+        });
+      } else {
+        describe(classpaths_, pathListings, logger_);
+      }
+    }
 
-        std::string loadName = scriptName;
-        const auto &package = getPackage(pathListings, path);
+  }
 
-        if (!package.empty())
-          loadName = "org.apache.nifi.minifi.processors." + package + "." + scriptName;
-
-        auto processor = std::dynamic_pointer_cast<core::Processor>(core::ClassLoader::getDefaultClassLoader().instantiate(loadName, uuid));
-        if (processor) {
-          try {
-            processor->initialize();
-            auto proc = std::dynamic_pointer_cast<python::processors::ExecutePythonProcessor>(processor);
-            minifi::BundleDetails details;
-            const auto &package = getPackage(pathListings, path);
-            std::string script_with_package = "org.apache.nifi.minifi.processors.";
-            if (!package.empty()) {
-              script_with_package += package + ".";
-            }
-            script_with_package += scriptName;
-            details.artifact = getFileName(path);
-            details.version = minifi::AgentBuild::VERSION;
-            details.group = "python";
-
-            minifi::ClassDescription description(script_with_package);
-            description.dynamic_properties_ = proc->getPythonSupportDynamicProperties();
-            auto properties = proc->getPythonProperties();
-
-            minifi::AgentDocs::putDescription(scriptName, proc->getDescription());
-            for (const auto &prop : properties) {
-              description.class_properties_.insert(std::make_pair(prop.getName(), prop));
-            }
-
-            for (const auto &rel : proc->getSupportedRelationships()) {
-              description.class_relationships_.push_back(rel);
-            }
-            minifi::ExternalBuildDescription::addExternalComponent(details, description);
-          } catch (const std::exception &e) {
-            logger_->log_warn("Cannot load %s because of %s", scriptName, e.what());
+ private:
+  static void describe(const std::vector<std::string> &classpaths, const std::string &pathListings, const std::shared_ptr<logging::Logger> &logger) {
+    for (const auto &path : classpaths) {
+      const auto &scriptName = getScriptName(path);
+
+      utils::Identifier uuid;
+
+      std::string loadName = scriptName;
+      const auto &package = getPackage(pathListings, path);
+
+      if (!package.empty())
+        loadName = "org.apache.nifi.minifi.processors." + package + "." + scriptName;
+
+      auto processor = std::dynamic_pointer_cast<core::Processor>(core::ClassLoader::getDefaultClassLoader().instantiate(loadName, uuid));
+      if (processor) {
+        try {
+          processor->initialize();
+          auto proc = std::dynamic_pointer_cast<python::processors::ExecutePythonProcessor>(processor);
+          minifi::BundleDetails details;
+          const auto &package = getPackage(pathListings, path);
+          std::string script_with_package = "org.apache.nifi.minifi.processors.";
+          if (!package.empty()) {
+            script_with_package += package + ".";
+          }
+          script_with_package += scriptName;
+          details.artifact = getFileName(path);
+          details.version = minifi::AgentBuild::VERSION;
+          details.group = "python";
+
+          minifi::ClassDescription description(script_with_package);
+          description.dynamic_properties_ = proc->getPythonSupportDynamicProperties();
+          auto properties = proc->getPythonProperties();
+
+          minifi::AgentDocs::putDescription(scriptName, proc->getDescription());
+          for (const auto &prop : properties) {
+            description.class_properties_.insert(std::make_pair(prop.getName(), prop));
           }
 
+          for (const auto &rel : proc->getSupportedRelationships()) {
+            description.class_relationships_.push_back(rel);
+          }
+          minifi::ExternalBuildDescription::addExternalComponent(details, description);
+        } catch (const std::exception &e) {
+          logger->log_warn("Cannot load %s because of %s", scriptName, e.what());
         }
 
       }
@@ -144,8 +154,7 @@ class PythonCreator : public minifi::core::CoreComponent {
 
   }
 
- private:
-  std::string getPackage(const std::string &basePath, const std::string pythonscript) {
+  static std::string getPackage(const std::string &basePath, const std::string pythonscript) {
     const auto script_directory = getPath(pythonscript);
     const auto loc = script_directory.find_first_of(basePath);
     if (loc != 0 || script_directory.size() <= basePath.size()) {
@@ -162,17 +171,17 @@ class PythonCreator : public minifi::core::CoreComponent {
     return python_package;
   }
 
-  std::string getPath(const std::string &pythonscript) {
+  static std::string getPath(const std::string &pythonscript) {
     std::string path = pythonscript.substr(0, pythonscript.find_last_of("/\\"));
     return path;
   }
 
-  std::string getFileName(const std::string &pythonscript) {
+  static std::string getFileName(const std::string &pythonscript) {
     std::string path = pythonscript.substr(pythonscript.find_last_of("/\\") + 1);
     return path;
   }
 
-  std::string getScriptName(const std::string &pythonscript) {
+  static std::string getScriptName(const std::string &pythonscript) {
     std::string path = pythonscript.substr(pythonscript.find_last_of("/\\") + 1);
     size_t dot_i = path.find_last_of('.');
     return path.substr(0, dot_i);
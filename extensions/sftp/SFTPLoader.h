@@ -53,6 +53,8 @@ class SFTPFactory : public core::ObjectFactory {
   virtual std::vector<std::string> getClassNames() {
     std::vector<std::string> class_names;
     class_names.push_back("PutSFTP");
+    class_names.push_back("FetchSFTP");
+    class_names.push_back("ListSFTP");
     return class_names;
   }
 
@@ -29,6 +29,7 @@
 #include <map>
 #include <set>
 #include <list>
+#include <unordered_map>
 #include <string>
 #include <utility>
 #include <vector>
@@ -50,6 +51,7 @@
 #include "rapidjson/document.h"
 #include "rapidjson/ostreamwrapper.h"
 #include "rapidjson/istreamwrapper.h"
+#include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 
 namespace org {
@@ -129,6 +131,10 @@ core::Property ListSFTP::StateFile(
     core::PropertyBuilder::createProperty("State File")->withDescription("Specifies the file that should be used for storing state about"
                                                                          " what data has been ingested so that upon restart MiNiFi can resume from where it left off")
         ->isRequired(true)->withDefaultValue("ListSFTP")->build());
+core::Property ListSFTP::StateManager(
+    core::PropertyBuilder::createProperty("State Manager")->withDescription("Name of the state manager controller service used to store what data has been listed. "
+                                                                           "If not set, the state is stored in the State File.")
+        ->isRequired(false)->build());
 
 core::Relationship ListSFTP::Success("success", "All FlowFiles that are received are routed to success");
 
@@ -158,6 +164,7 @@ void ListSFTP::initialize() {
   properties.insert(MinimumFileSize);
   properties.insert(MaximumFileSize);
   properties.insert(StateFile);
+  properties.insert(StateManager);
   setSupportedProperties(properties);
 
   // Set the supported relationships
@@ -257,6 +264,17 @@ void ListSFTP::onSchedule(const std::shared_ptr<core::ProcessContext> &context,
       logger_->log_error("Maximum File Size attribute is invalid");
     }
   }
+  std::shared_ptr<controllers::StateManagerService> state_manager;
+  if (context->getProperty(StateManager.getName(), value) && !value.empty()) {
+    state_manager = std::dynamic_pointer_cast<controllers::StateManagerService>(context->getControllerService(value));
+    if (state_manager == nullptr) {
+      throw minifi::Exception(ExceptionType::PROCESSOR_EXCEPTION, "State Manager " + value + " is not a state manager controller service");
+    }
+  }
+  if (state_manager != state_manager_) {
+    invalidateCache();
+  }
+  state_manager_ = state_manager;
   context->getProperty(StateFile.getName(), value);
   if (listing_strategy_ == LISTING_STRATEGY_TRACKING_TIMESTAMPS) {
     std::stringstream ss;
@@ -508,46 +526,86 @@ ListSFTP::ListedEntity::ListedEntity(uint64_t timestamp_, uint64_t size_)
 }
 
 bool ListSFTP::persistTrackingTimestampsCache(const std::string& hostname, const std::string& username, const std::string& remote_path) {
+  std::unordered_map<std::string, std::string> state;
+  state["listing_strategy"] = LISTING_STRATEGY_TRACKING_TIMESTAMPS;
+  state["hostname"] = hostname;
+  state["username"] = username;
+  state["remote_path"] = remote_path;
+  state["listing.timestamp"] = std::to_string(last_listed_latest_entry_timestamp_);
+  state["processed.timestamp"] = std::to_string(last_processed_latest_entry_timestamp_);
+  size_t i = 0;
+  for (const auto& identifier : latest_identifiers_processed_) {
+    state["id." + std::to_string(i)] = identifier;
+    ++i;
+  }
+
+  if (state_manager_ != nullptr) {
+    if (!state_manager_->set(getUUIDStr(), state)) {
+      logger_->log_error("Failed to store Tracking Timestamps state in \"%s\"", state_manager_->getName());
+      return false;
+    }
+    return true;
+  }
+
   std::ofstream file(tracking_timestamps_state_filename_);
   if (!file.is_open()) {
     logger_->log_error("Failed to store state to Tracking Timestamps state file \"%s\"", tracking_timestamps_state_filename_.c_str());
     return false;
   }
-  file << "hostname=" << hostname << "\n";
-  file << "username=" << username << "\n";
-  file << "remote_path=" << remote_path << "\n";
-  file << "listing.timestamp=" << last_listed_latest_entry_timestamp_ << "\n";
-  file << "processed.timestamp=" << last_processed_latest_entry_timestamp_ << "\n";
-  size_t i = 0;
-  for (const auto& identifier : latest_identifiers_processed_) {
-    file << "id." << i << "=" << identifier << "\n";
-    ++i;
+  state.erase("listing_strategy");
+  for (const auto& kv : state) {
+    file << kv.first << "=" << kv.second << "\n";
   }
   return true;
 }
 
-bool ListSFTP::updateFromTrackingTimestampsCache(const std::string& hostname, const std::string& username, const std::string& remote_path) {
-  std::ifstream file(tracking_timestamps_state_filename_);
+bool ListSFTP::loadState(const std::string& state_filename, std::unordered_map<std::string, std::string>& state) {
+  if (state_manager_ != nullptr) {
+    if (!state_manager_->get(getUUIDStr(), state)) {
+      logger_->log_debug("No state stored for %s in \"%s\"", getUUIDStr(), state_manager_->getName());
+      return false;
+    }
+    return true;
+  }
+
+  std::ifstream file(state_filename);
   if (!file.is_open()) {
-    logger_->log_error("Failed to open Tracking Timestamps state file \"%s\"", tracking_timestamps_state_filename_.c_str());
+    logger_->log_error("Failed to open state file \"%s\"", state_filename.c_str());
     return false;
   }
-  std::string state_hostname;
-  std::string state_username;
-  std::string state_remote_path;
-  uint64_t state_listing_timestamp;
-  uint64_t state_processed_timestamp;
-  std::set<std::string> state_ids;
-
   std::string line;
   while (std::getline(file, line)) {
     size_t separator_pos = line.find('=');
     if (separator_pos == std::string::npos) {
-      logger_->log_warn("None key-value line found in Tracking Timestamps state file \"%s\": \"%s\"", tracking_timestamps_state_filename_.c_str(), line.c_str());
+      logger_->log_warn("None key-value line found in state file \"%s\": \"%s\"", state_filename.c_str(), line.c_str());
+      continue;
     }
-    std::string key = line.substr(0, separator_pos);
-    std::string value = line.substr(separator_pos + 1);
-    if (key == "hostname") {
+    state[line.substr(0, separator_pos)] = line.substr(separator_pos + 1);
+  }
+  return true;
+}
+
+bool ListSFTP::updateFromTrackingTimestampsCache(const std::string& hostname, const std::string& username, const std::string& remote_path) {
+  std::unordered_map<std::string, std::string> state;
+  if (!loadState(tracking_timestamps_state_filename_, state)) {
+    return false;
+  }
+  std::string state_hostname;
+  std::string state_username;
+  std::string state_remote_path;
+  uint64_t state_listing_timestamp = 0U;
+  uint64_t state_processed_timestamp = 0U;
+  std::set<std::string> state_ids;
+
+  for (auto& kv : state) {
+    const std::string& key = kv.first;
+    std::string& value = kv.second;
+    if (key == "listing_strategy") {
+      if (value != LISTING_STRATEGY_TRACKING_TIMESTAMPS) {
+        logger_->log_error("Tracking Timestamps state was stored by the \"%s\" listing strategy, ignoring", value);
+        return false;
+      }
+    } else if (key == "hostname") {
       state_hostname = std::move(value);
     } else if (key == "username") {
       state_username = std::move(value);
@@ -557,32 +615,30 @@ bool ListSFTP::updateFromTrackingTimestampsCache(const std::string& hostname, co
       try {
         state_listing_timestamp = stoull(value);
       } catch (...) {
-        logger_->log_error("listing.timestamp is not an uint64 in Tracking Timestamps state file \"%s\"", tracking_timestamps_state_filename_.c_str());
+        logger_->log_error("listing.timestamp is not an uint64 in Tracking Timestamps state");
         return false;
       }
     } else if (key == "processed.timestamp") {
       try {
         state_processed_timestamp = stoull(value);
       } catch (...) {
-        logger_->log_error("processed.timestamp is not an uint64 in Tracking Timestamps state file \"%s\"", tracking_timestamps_state_filename_.c_str());
+        logger_->log_error("processed.timestamp is not an uint64 in Tracking Timestamps state");
         return false;
       }
     } else if (key.compare(0, strlen("id."), "id.") == 0) {
       state_ids.emplace(std::move(value));
     } else {
-      logger_->log_warn("Unknown key found in Tracking Timestamps state file \"%s\": \"%s\"", tracking_timestamps_state_filename_.c_str(), key.c_str());
+      logger_->log_warn("Unknown key found in Tracking Timestamps state: \"%s\"", key.c_str());
     }
   }
-  file.close();
 
   if (state_hostname != hostname ||
       state_username != username ||
       state_remote_path != remote_path) {
-    logger_->log_error("Tracking Timestamps state file \"%s\" was created with different settings than the current ones, ignoring. "
+    logger_->log_error("Tracking Timestamps state was created with different settings than the current ones, ignoring. "
                        "Hostname: \"%s\" vs. \"%s\", "
                        "Username: \"%s\" vs. \"%s\", "
                        "Remote Path: \"%s\" vs. \"%s\"",
-                       tracking_timestamps_state_filename_.c_str(),
                        state_hostname, hostname,
                        state_username, username,
                        state_remote_path, remote_path);
@@ -761,6 +817,33 @@ void ListSFTP::listByTrackingTimestamps(
 }
 
 bool ListSFTP::persistTrackingEntitiesCache(const std::string& hostname, const std::string& username, const std::string& remote_path) {
+  rapidjson::Document entities(rapidjson::kObjectType);
+  rapidjson::Document::AllocatorType& alloc = entities.GetAllocator();
+  for (const auto& already_listed_entity : already_listed_entities_) {
+    rapidjson::Value entity(rapidjson::kObjectType);
+    entity.AddMember("timestamp", already_listed_entity.second.timestamp, alloc);
+    entity.AddMember("size", already_listed_entity.second.size, alloc);
+    entities.AddMember(rapidjson::Value(already_listed_entity.first.c_str(), alloc), std::move(entity), alloc);
+  }
+
+  if (state_manager_ != nullptr) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    entities.Accept(writer);
+
+    std::unordered_map<std::string, std::string> state;
+    state["listing_strategy"] = LISTING_STRATEGY_TRACKING_ENTITIES;
+    state["hostname"] = hostname;
+    state["username"] = username;
+    state["remote_path"] = remote_path;
+    state["entities"] = std::string(buffer.GetString(), buffer.GetSize());
+    if (!state_manager_->set(getUUIDStr(), state)) {
+      logger_->log_error("Failed to store Tracking Entities state in \"%s\"", state_manager_->getName());
+      return false;
+    }
+    return true;
+  }
+
   std::ofstream file(tracking_entities_state_filename_);
   if (!file.is_open()) {
     logger_->log_error("Failed to store Tracking Entities state to state file \"%s\"", tracking_entities_state_filename_.c_str());
@@ -778,15 +861,6 @@ bool ListSFTP::persistTrackingEntitiesCache(const std::string& hostname, const s
     return false;
   }
 
-  rapidjson::Document entities(rapidjson::kObjectType);
-  rapidjson::Document::AllocatorType& alloc = entities.GetAllocator();
-  for (const auto& already_listed_entity : already_listed_entities_) {
-    rapidjson::Value entity(rapidjson::kObjectType);
-    entity.AddMember("timestamp", already_listed_entity.second.timestamp, alloc);
-    entity.AddMember("size", already_listed_entity.second.size, alloc);
-    entities.AddMember(rapidjson::Value(already_listed_entity.first.c_str(), alloc), std::move(entity), alloc);
-  }
-
   rapidjson::OStreamWrapper osw(json_file);
   rapidjson::Writer<rapidjson::OStreamWrapper> writer(osw);
   entities.Accept(writer);
@@ -795,26 +869,25 @@ bool ListSFTP::persistTrackingEntitiesCache(const std::string& hostname, const s
 }
 
 bool ListSFTP::updateFromTrackingEntitiesCache(const std::string& hostname, const std::string& username, const std::string& remote_path) {
-  std::ifstream file(tracking_entities_state_filename_);
-  if (!file.is_open()) {
-    logger_->log_error("Failed to open Tracking Entities state file \"%s\"", tracking_entities_state_filename_.c_str());
+  std::unordered_map<std::string, std::string> state;
+  if (!loadState(tracking_entities_state_filename_, state)) {
     return false;
   }
   std::string state_hostname;
   std::string state_username;
   std::string state_remote_path;
   std::string state_json_state_file;
-
-  std::string line;
-  while (std::getline(file, line)) {
-    size_t separator_pos = line.find('=');
-    if (separator_pos == std::string::npos) {
-      logger_->log_warn("None key-value line found in Tracking Entities state file \"%s\": \"%s\"", tracking_entities_state_filename_.c_str(), line.c_str());
-      continue;
-    }
-    std::string key = line.substr(0, separator_pos);
-    std::string value = line.substr(separator_pos + 1);
-    if (key == "hostname") {
+  std::string state_entities;
+
+  for (auto& kv : state) {
+    const std::string& key = kv.first;
+    std::string& value = kv.second;
+    if (key == "listing_strategy") {
+      if (value != LISTING_STRATEGY_TRACKING_ENTITIES) {
+        logger_->log_error("Tracking Entities state was stored by the \"%s\" listing strategy, ignoring", value);
+        return false;
+      }
+    } else if (key == "hostname") {
       state_hostname = std::move(value);
     } else if (key == "username") {
       state_username = std::move(value);
@@ -822,47 +895,49 @@ bool ListSFTP::updateFromTrackingEntitiesCache(const std::string& hostname, cons
       state_remote_path = std::move(value);
     } else if (key == "json_state_file") {
       state_json_state_file = std::move(value);
+    } else if (key == "entities") {
+      state_entities = std::move(value);
     } else {
-      logger_->log_warn("Unknown key found in Tracking Entities state file \"%s\": \"%s\"", tracking_entities_state_filename_.c_str(), key.c_str());
+      logger_->log_warn("Unknown key found in Tracking Entities state: \"%s\"", key.c_str());
     }
   }
-  file.close();
 
   if (state_hostname != hostname ||
       state_username != username ||
       state_remote_path != remote_path) {
-    logger_->log_error("Tracking Entities state file \"%s\" was created with different settings than the current ones, ignoring. "
+    logger_->log_error("Tracking Entities state was created with different settings than the current ones, ignoring. "
                        "Hostname: \"%s\" vs. \"%s\", "
                        "Username: \"%s\" vs. \"%s\", "
                        "Remote Path: \"%s\" vs. \"%s\"",
-                       tracking_entities_state_filename_.c_str(),
                        state_hostname, hostname,
                        state_username, username,
                        state_remote_path, remote_path);
     return false;
   }
 
-  if (state_json_state_file.empty()) {
-    logger_->log_error("Could not found json state file path in Tracking Entities state file \"%s\"", tracking_entities_state_filename_.c_str());
-    return false;
-  }
+  if (state_manager_ == nullptr) {
+    if (state_json_state_file.empty()) {
+      logger_->log_error("Could not found json state file path in Tracking Entities state file \"%s\"", tracking_entities_state_filename_.c_str());
+      return false;
+    }
 
-  std::ifstream json_file(state_json_state_file);
-  if (!json_file.is_open()) {
-    logger_->log_error("Failed to open entities Tracking Entities state json file \"%s\"", state_json_state_file.c_str());
-    return false;
+    std::ifstream json_file(state_json_state_file);
+    if (!json_file.is_open()) {
+      logger_->log_error("Failed to open entities Tracking Entities state json file \"%s\"", state_json_state_file.c_str());
+      return false;
+    }
+    state_entities.assign(std::istreambuf_iterator<char>(json_file), std::istreambuf_iterator<char>());
   }
 
   try {
-    rapidjson::IStreamWrapper isw(json_file);
     rapidjson::Document d;
-    rapidjson::ParseResult res = d.ParseStream(isw);
+    rapidjson::ParseResult res = d.Parse(state_entities.c_str(), state_entities.size());
     if (!res) {
-      logger_->log_error("Failed to parse Tracking Entities state json file \"%s\"", state_json_state_file.c_str());
+      logger_->log_error("Failed to parse Tracking Entities state json");
       return false;
     }
     if (!d.IsObject()) {
-      logger_->log_error("Tracking Entities state json file \"%s\" root is not an object", state_json_state_file.c_str());
+      logger_->log_error("Tracking Entities state json root is not an object");
       return false;
     }
 
@@ -870,16 +945,14 @@ bool ListSFTP::updateFromTrackingEntitiesCache(const std::string& hostname, cons
     for (const auto &already_listed_entity : d.GetObject()) {
       auto it = already_listed_entity.value.FindMember("timestamp");
       if (it == already_listed_entity.value.MemberEnd() || !it->value.IsUint64()) {
-        logger_->log_error("Tracking Entities state json file \"%s\" timestamp missing or malformatted for entity \"%s\"",
-            state_json_state_file.c_str(),
+        logger_->log_error("Tracking Entities state json timestamp missing or malformatted for entity \"%s\"",
             already_listed_entity.name.GetString());
         continue;
       }
       uint64_t timestamp = it->value.GetUint64();
       it = already_listed_entity.value.FindMember("size");
       if (it == already_listed_entity.value.MemberEnd() || !it->value.IsUint64()) {
-        logger_->log_error("Tracking Entities state json file \"%s\" size missing or malformatted for entity \"%s\"",
-                           state_json_state_file.c_str(),
+        logger_->log_error("Tracking Entities state json size missing or malformatted for entity \"%s\"",
                            already_listed_entity.name.GetString());
         continue;
       }
@@ -890,7 +963,7 @@ bool ListSFTP::updateFromTrackingEntitiesCache(const std::string& hostname, cons
     }
     already_listed_entities_ = std::move(new_already_listed_entities);
   } catch (std::exception& e) {
-    logger_->log_error("Exception while parsing Tracking Entities state json file \"%s\": %s", state_json_state_file.c_str(), e.what());
+    logger_->log_error("Exception while parsing Tracking Entities state json: %s", e.what());
     return false;
   }
 
@@ -22,6 +22,7 @@
 #include <map>
 #include <chrono>
 #include <cstdint>
+#include <unordered_map>
 
 #include "SFTPProcessorBase.h"
 #include "utils/ByteArrayCallback.h"
@@ -32,6 +33,7 @@
 #include "core/Property.h"
 #include "core/Resource.h"
 #include "core/logging/LoggerConfiguration.h"
+#include "controllers/StateManagerService.h"
 #include "utils/Id.h"
 #include "utils/RegexUtils.h"
 #include "../client/SFTPClient.h"
@@ -81,6 +83,7 @@ class ListSFTP : public SFTPProcessorBase {
   static core::Property MinimumFileSize;
   static core::Property MaximumFileSize;
   static core::Property StateFile;
+  static core::Property StateManager;
 
   // Supported Relationships
   static core::Relationship Success;
@@ -137,6 +140,8 @@ class ListSFTP : public SFTPProcessorBase {
   };
 
   bool already_loaded_from_cache_;
+  // Service storing the state instead of the state files, if configured
+  std::shared_ptr<controllers::StateManagerService> state_manager_;
 
   std::string tracking_timestamps_state_filename_;
   std::chrono::time_point<std::chrono::steady_clock> last_run_time_;
@@ -169,6 +174,11 @@ class ListSFTP : public SFTPProcessorBase {
       const std::string& username,
       const Child& child);
 
+  /**
+   * Loads the stored state from the state manager, or from the state file if no state manager is configured.
+   */
+  bool loadState(const std::string& state_filename, std::unordered_map<std::string, std::string>& state);
+
   bool persistTrackingTimestampsCache(const std::string& hostname, const std::string& username, const std::string& remote_path);
   bool updateFromTrackingTimestampsCache(const std::string& hostname, const std::string& username, const std::string& remote_path);
 
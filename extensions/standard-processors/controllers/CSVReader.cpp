@@ -0,0 +1,207 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CSVReader.h"
+#include <cstring>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "core/Property.h"
+#include "utils/StringUtils.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+namespace {
+
+class CSVRecordReader : public RecordReader {
+ public:
+  CSVRecordReader(const std::shared_ptr<io::BaseStream> &stream, uint64_t size, char separator, char quote, bool header)
+      : RecordReader(stream, size),
+        separator_(separator),
+        quote_(quote),
+        header_(header) {
+  }
+
+ protected:
+  virtual size_t findRecordEnd(const char *begin, const char *end) {
+    const char *position = begin;
+    while (position < end) {
+      const char *line_feed = static_cast<const char*>(std::memchr(position, '\n', end - position));
+      if (line_feed == nullptr) {
+        return 0;
+      }
+      const char *quote = static_cast<const char*>(std::memchr(position, quote_, line_feed - position));
+      if (quote == nullptr) {
+        return line_feed - begin + 1;
+      }
+      // a doubled quote closes and reopens the quoted value
+      const char *closing_quote = static_cast<const char*>(std::memchr(quote + 1, quote_, end - quote - 1));
+      if (closing_quote == nullptr) {
+        return 0;
+      }
+      position = closing_quote + 1;
+    }
+    return 0;
+  }
+
+  virtual bool parse(char *begin, size_t length, Record &record) {
+    if (length == 0) {
+      return false;
+    }
+    char *position = begin;
+    char *const end = begin + length;
+    while (true) {
+      if (position < end && *position == quote_) {
+        // unescape in place, the value moves over its opening quote
+        char *value = position;
+        char *out = position;
+        bool closed = false;
+        position++;
+        while (position < end) {
+          if (*position == quote_) {
+            if (position + 1 < end && position[1] == quote_) {
+              *out++ = quote_;
+              position += 2;
+              continue;
+            }
+            position++;
+            closed = true;
+            break;
+          }
+          *out++ = *position++;
+        }
+        if (!closed) {
+          setError("Record " + std::to_string(getRecordCount() + 1) + " has a quoted value without closing quote");
+          return false;
+        }
+        if (position < end && *position != separator_) {
+          setError("Record " + std::to_string(getRecordCount() + 1) + " has characters between a closing quote and the next separator");
+          return false;
+        }
+        record.addField(value, out - value, RecordFieldType::STRING);
+      } else {
+        char *separator = static_cast<char*>(std::memchr(position, separator_, end - position));
+        char *value_end = separator != nullptr ? separator : end;
+        record.addField(position, value_end - position, RecordFieldType::STRING);
+        position = value_end;
+      }
+      if (position >= end) {
+        break;
+      }
+      // skip the separator, a separator at the end is followed by an empty value
+      position++;
+    }
+
+    if (header_ && schema_ == nullptr) {
+      std::vector<std::string> names;
+      names.reserve(record.size());
+      for (size_t i = 0; i < record.size(); i++) {
+        names.push_back(record.getField(i).toString());
+      }
+      schema_ = std::make_shared<RecordSchema>(std::move(names));
+      return false;
+    }
+    if (schema_ == nullptr || (!header_ && record.size() > schema_->size())) {
+      std::vector<std::string> names;
+      names.reserve(record.size());
+      for (size_t i = 0; i < record.size(); i++) {
+        names.push_back("field_" + std::to_string(i));
+      }
+      schema_ = std::make_shared<RecordSchema>(std::move(names));
+    }
+    if (record.size() > schema_->size()) {
+      setError("Record " + std::to_string(getRecordCount() + 1) + " has " + std::to_string(record.size()) + " values but the header names " + std::to_string(schema_->size()) + " fields");
+      return false;
+    }
+    while (record.size() < schema_->size()) {
+      record.addField("", 0, RecordFieldType::NULL_VALUE);
+    }
+    record.setSchema(schema_);
+    return true;
+  }
+
+ private:
+  const char separator_;
+  const char quote_;
+  const bool header_;
+  std::shared_ptr<RecordSchema> schema_;
+};
+
+}  // namespace
+
+bool parseCSVCharacter(const std::string &value, char &character) {
+  if (value == "\\t") {
+    character = '\t';
+    return true;
+  }
+  if (value.size() != 1) {
+    return false;
+  }
+  character = value[0];
+  return true;
+}
+
+core::Property CSVReader::ValueSeparator(
+    core::PropertyBuilder::createProperty("Value Separator")->withDescription("The character separating the values of a record. \\t stands for a tab.")->isRequired(true)
+        ->withDefaultValue(",")->build());
+
+core::Property CSVReader::QuoteCharacter(
+    core::PropertyBuilder::createProperty("Quote Character")->withDescription("The character quoting values that contain separators, line feeds or quotes. "
+                                                                          "A quote within a quoted value is doubled.")->isRequired(true)->withDefaultValue("\"")->build());
+
+core::Property CSVReader::FirstLineIsHeader(
+    core::PropertyBuilder::createProperty("Treat First Line as Header")->withDescription("Whether the first line names the fields. "
+                                                                                      "Otherwise the fields are named field_0, field_1 and so on.")
+        ->isRequired(true)->withDefaultValue<bool>(true)->build());
+
+void CSVReader::initialize() {
+  ControllerService::initialize();
+  std::set<core::Property> supportedProperties;
+  supportedProperties.insert(ValueSeparator);
+  supportedProperties.insert(QuoteCharacter);
+  supportedProperties.insert(FirstLineIsHeader);
+  setSupportedProperties(supportedProperties);
+}
+
+void CSVReader::onEnable() {
+  std::string value;
+  if (getProperty(ValueSeparator.getName(), value) && !parseCSVCharacter(value, separator_)) {
+    logger_->log_error("Invalid Value Separator %s, using %c", value, separator_);
+  }
+  if (getProperty(QuoteCharacter.getName(), value) && !parseCSVCharacter(value, quote_)) {
+    logger_->log_error("Invalid Quote Character %s, using %c", value, quote_);
+  }
+  if (getProperty(FirstLineIsHeader.getName(), value)) {
+    utils::StringUtils::StringToBool(value, header_);
+  }
+}
+
+std::unique_ptr<RecordReader> CSVReader::createRecordReader(const std::shared_ptr<io::BaseStream> &stream, uint64_t size) {
+  return std::unique_ptr<RecordReader>(new CSVRecordReader(stream, size, separator_, quote_, header_));
+}
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
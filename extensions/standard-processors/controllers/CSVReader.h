@@ -0,0 +1,86 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_STANDARD_PROCESSORS_CONTROLLERS_CSVREADER_H_
+#define EXTENSIONS_STANDARD_PROCESSORS_CONTROLLERS_CSVREADER_H_
+
+#include <memory>
+#include <string>
+#include "core/Resource.h"
+#include "core/logging/LoggerConfiguration.h"
+#include "RecordSet.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+/**
+ * Parses the value of a separator or quote character property. "\\t" stands for a tab.
+ * @return false unless the value is a single character
+ */
+bool parseCSVCharacter(const std::string &value, char &character);
+
+/**
+ * Purpose: Reads records from comma separated values. Quoted values may contain separators, line
+ * feeds and doubled quotes. Values are unescaped in the read buffer, so no value is copied.
+ */
+class CSVReader : public RecordReaderFactory {
+ public:
+  explicit CSVReader(const std::string &name, const std::string &id)
+      : RecordReaderFactory(name, id),
+        separator_(','),
+        quote_('"'),
+        header_(true),
+        logger_(logging::LoggerFactory<CSVReader>::getLogger()) {
+  }
+
+  explicit CSVReader(const std::string &name, utils::Identifier uuid = utils::Identifier())
+      : RecordReaderFactory(name, uuid),
+        separator_(','),
+        quote_('"'),
+        header_(true),
+        logger_(logging::LoggerFactory<CSVReader>::getLogger()) {
+  }
+
+  static core::Property ValueSeparator;
+  static core::Property QuoteCharacter;
+  static core::Property FirstLineIsHeader;
+
+  virtual void initialize();
+
+  virtual void onEnable();
+
+  virtual std::unique_ptr<RecordReader> createRecordReader(const std::shared_ptr<io::BaseStream> &stream, uint64_t size);
+
+ private:
+  char separator_;
+  char quote_;
+  bool header_;
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+REGISTER_RESOURCE(CSVReader, "Reads records from comma separated values, taking the field names from the header line.");
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_STANDARD_PROCESSORS_CONTROLLERS_CSVREADER_H_ */
@@ -0,0 +1,158 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CSVRecordSetWriter.h"
+#include <memory>
+#include <set>
+#include <string>
+#include "core/Property.h"
+#include "utils/StringUtils.h"
+#include "CSVReader.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+namespace {
+
+class CSVWriter : public RecordSetWriter {
+ public:
+  CSVWriter(const std::shared_ptr<io::BaseStream> &stream, char separator, char quote, bool header)
+      : RecordSetWriter(stream),
+        separator_(separator),
+        quote_(quote),
+        header_(header) {
+  }
+
+ protected:
+  virtual void writeRecord(const Record &record, std::string &out) {
+    if (columns_ == nullptr) {
+      columns_ = record.getSchema();
+      if (header_ && columns_ != nullptr) {
+        const auto &names = columns_->getFieldNames();
+        for (size_t i = 0; i < names.size(); i++) {
+          if (i > 0) {
+            out += separator_;
+          }
+          appendValue(names[i].data(), names[i].size(), out);
+        }
+        out += '\n';
+      }
+    }
+
+    if (columns_ == nullptr || record.getSchema() == columns_) {
+      for (size_t i = 0; i < record.size(); i++) {
+        if (i > 0) {
+          out += separator_;
+        }
+        appendField(record.getField(i), out);
+      }
+    } else {
+      const auto &names = columns_->getFieldNames();
+      for (size_t i = 0; i < names.size(); i++) {
+        if (i > 0) {
+          out += separator_;
+        }
+        const RecordField *field = record.getField(names[i]);
+        if (field != nullptr) {
+          appendField(*field, out);
+        }
+      }
+    }
+    out += '\n';
+  }
+
+ private:
+  void appendField(const RecordField &field, std::string &out) {
+    if (field.type != RecordFieldType::NULL_VALUE) {
+      appendValue(field.data, field.size, out);
+    }
+  }
+
+  void appendValue(const char *data, size_t size, std::string &out) {
+    bool needs_quotes = false;
+    for (size_t i = 0; i < size && !needs_quotes; i++) {
+      const char c = data[i];
+      needs_quotes = c == separator_ || c == quote_ || c == '\n' || c == '\r';
+    }
+    if (!needs_quotes) {
+      out.append(data, size);
+      return;
+    }
+    out += quote_;
+    for (size_t i = 0; i < size; i++) {
+      if (data[i] == quote_) {
+        out += quote_;
+      }
+      out += data[i];
+    }
+    out += quote_;
+  }
+
+  const char separator_;
+  const char quote_;
+  const bool header_;
+  std::shared_ptr<RecordSchema> columns_;
+};
+
+}  // namespace
+
+core::Property CSVRecordSetWriter::ValueSeparator(
+    core::PropertyBuilder::createProperty("Value Separator")->withDescription("The character separating the values of a record. \\t stands for a tab.")->isRequired(true)
+        ->withDefaultValue(",")->build());
+
+core::Property CSVRecordSetWriter::QuoteCharacter(
+    core::PropertyBuilder::createProperty("Quote Character")->withDescription("The character quoting values that contain separators, line feeds or quotes. "
+                                                                          "A quote within a quoted value is doubled.")->isRequired(true)->withDefaultValue("\"")->build());
+
+core::Property CSVRecordSetWriter::IncludeHeaderLine(
+    core::PropertyBuilder::createProperty("Include Header Line")->withDescription("Whether the first line names the fields")->isRequired(true)->withDefaultValue<bool>(true)->build());
+
+void CSVRecordSetWriter::initialize() {
+  ControllerService::initialize();
+  std::set<core::Property> supportedProperties;
+  supportedProperties.insert(ValueSeparator);
+  supportedProperties.insert(QuoteCharacter);
+  supportedProperties.insert(IncludeHeaderLine);
+  setSupportedProperties(supportedProperties);
+}
+
+void CSVRecordSetWriter::onEnable() {
+  std::string value;
+  if (getProperty(ValueSeparator.getName(), value) && !parseCSVCharacter(value, separator_)) {
+    logger_->log_error("Invalid Value Separator %s, using %c", value, separator_);
+  }
+  if (getProperty(QuoteCharacter.getName(), value) && !parseCSVCharacter(value, quote_)) {
+    logger_->log_error("Invalid Quote Character %s, using %c", value, quote_);
+  }
+  if (getProperty(IncludeHeaderLine.getName(), value)) {
+    utils::StringUtils::StringToBool(value, header_);
+  }
+}
+
+std::unique_ptr<RecordSetWriter> CSVRecordSetWriter::createRecordSetWriter(const std::shared_ptr<io::BaseStream> &stream) {
+  return std::unique_ptr<RecordSetWriter>(new CSVWriter(stream, separator_, quote_, header_));
+}
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
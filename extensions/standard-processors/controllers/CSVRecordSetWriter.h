@@ -0,0 +1,84 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_STANDARD_PROCESSORS_CONTROLLERS_CSVRECORDSETWRITER_H_
+#define EXTENSIONS_STANDARD_PROCESSORS_CONTROLLERS_CSVRECORDSETWRITER_H_
+
+#include <memory>
+#include <string>
+#include "core/Resource.h"
+#include "core/logging/LoggerConfiguration.h"
+#include "RecordSet.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+/**
+ * Purpose: Writes records as comma separated values. The columns are the fields of the first record;
+ * later records with other fields are matched to the columns by field name.
+ */
+class CSVRecordSetWriter : public RecordSetWriterFactory {
+ public:
+  explicit CSVRecordSetWriter(const std::string &name, const std::string &id)
+      : RecordSetWriterFactory(name, id),
+        separator_(','),
+        quote_('"'),
+        header_(true),
+        logger_(logging::LoggerFactory<CSVRecordSetWriter>::getLogger()) {
+  }
+
+  explicit CSVRecordSetWriter(const std::string &name, utils::Identifier uuid = utils::Identifier())
+      : RecordSetWriterFactory(name, uuid),
+        separator_(','),
+        quote_('"'),
+        header_(true),
+        logger_(logging::LoggerFactory<CSVRecordSetWriter>::getLogger()) {
+  }
+
+  static core::Property ValueSeparator;
+  static core::Property QuoteCharacter;
+  static core::Property IncludeHeaderLine;
+
+  virtual void initialize();
+
+  virtual void onEnable();
+
+  virtual std::unique_ptr<RecordSetWriter> createRecordSetWriter(const std::shared_ptr<io::BaseStream> &stream);
+
+  virtual std::string getMimeType() const {
+    return "text/csv";
+  }
+
+ private:
+  char separator_;
+  char quote_;
+  bool header_;
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+REGISTER_RESOURCE(CSVRecordSetWriter, "Writes records as comma separated values with an optional header line.");
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_STANDARD_PROCESSORS_CONTROLLERS_CSVRECORDSETWRITER_H_ */
@@ -0,0 +1,246 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JsonLinesReader.h"
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "rapidjson/error/en.h"
+#include "rapidjson/reader.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+namespace {
+
+/**
+ * Turns the members of the top level object into fields. Nested values are written back to JSON.
+ */
+class RecordHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, RecordHandler> {
+ public:
+  RecordHandler()
+      : record_(nullptr),
+        depth_(0) {
+  }
+
+  void reset(Record *record) {
+    record_ = record;
+    depth_ = 0;
+    keys_.clear();
+    error_.clear();
+  }
+
+  const std::vector<std::pair<const char*, size_t>> &getKeys() const {
+    return keys_;
+  }
+
+  const std::string &getError() const {
+    return error_;
+  }
+
+  bool Null() {
+    if (depth_ > 1) {
+      return nested_writer_.Null();
+    }
+    return addField("", 0, RecordFieldType::NULL_VALUE);
+  }
+
+  bool Bool(bool b) {
+    if (depth_ > 1) {
+      return nested_writer_.Bool(b);
+    }
+    return b ? addField("true", 4, RecordFieldType::BOOLEAN) : addField("false", 5, RecordFieldType::BOOLEAN);
+  }
+
+  bool RawNumber(const char *str, rapidjson::SizeType length, bool) {
+    if (depth_ > 1) {
+      return nested_writer_.RawValue(str, length, rapidjson::kNumberType);
+    }
+    return addField(str, length, RecordFieldType::NUMBER);
+  }
+
+  bool String(const char *str, rapidjson::SizeType length, bool) {
+    if (depth_ > 1) {
+      return nested_writer_.String(str, length);
+    }
+    return addField(str, length, RecordFieldType::STRING);
+  }
+
+  bool Key(const char *str, rapidjson::SizeType length, bool) {
+    if (depth_ > 1) {
+      return nested_writer_.Key(str, length);
+    }
+    keys_.push_back(std::make_pair(str, static_cast<size_t>(length)));
+    return true;
+  }
+
+  bool StartObject() {
+    if (depth_ == 0) {
+      depth_++;
+      return true;
+    }
+    startNested();
+    return nested_writer_.StartObject();
+  }
+
+  bool EndObject(rapidjson::SizeType count) {
+    if (depth_ == 1) {
+      depth_--;
+      return true;
+    }
+    return nested_writer_.EndObject(count) && endNested();
+  }
+
+  bool StartArray() {
+    if (depth_ == 0) {
+      error_ = "is not a JSON object";
+      return false;
+    }
+    startNested();
+    return nested_writer_.StartArray();
+  }
+
+  bool EndArray(rapidjson::SizeType count) {
+    return nested_writer_.EndArray(count) && endNested();
+  }
+
+  bool Default() {
+    error_ = "is not a JSON object";
+    return false;
+  }
+
+ private:
+  bool addField(const char *data, size_t size, RecordFieldType type) {
+    if (depth_ == 0) {
+      return Default();
+    }
+    record_->addField(data, size, type);
+    return true;
+  }
+
+  void startNested() {
+    if (depth_ == 1) {
+      nested_.Clear();
+      nested_writer_.Reset(nested_);
+    }
+    depth_++;
+  }
+
+  bool endNested() {
+    if (--depth_ == 1) {
+      const std::string &copy = record_->copy(std::string(nested_.GetString(), nested_.GetSize()));
+      record_->addField(copy.data(), copy.size(), RecordFieldType::RAW);
+    }
+    return true;
+  }
+
+  Record *record_;
+  int depth_;
+  std::vector<std::pair<const char*, size_t>> keys_;
+  rapidjson::StringBuffer nested_;
+  rapidjson::Writer<rapidjson::StringBuffer> nested_writer_;
+  std::string error_;
+};
+
+class JsonRecordReader : public RecordReader {
+ public:
+  JsonRecordReader(const std::shared_ptr<io::BaseStream> &stream, uint64_t size)
+      : RecordReader(stream, size) {
+  }
+
+ protected:
+  virtual size_t findRecordEnd(const char *begin, const char *end) {
+    const char *line_feed = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+    return line_feed != nullptr ? line_feed - begin + 1 : 0;
+  }
+
+  virtual bool parse(char *begin, size_t length, Record &record) {
+    size_t start = 0;
+    while (start < length && (begin[start] == ' ' || begin[start] == '\t')) {
+      start++;
+    }
+    if (start == length) {
+      return false;
+    }
+    begin[length] = '\0';
+    handler_.reset(&record);
+    rapidjson::InsituStringStream stream(begin + start);
+    rapidjson::ParseResult result = reader_.Parse<rapidjson::kParseInsituFlag | rapidjson::kParseNumbersAsStringsFlag | rapidjson::kParseStopWhenDoneFlag>(stream, handler_);
+    if (!result) {
+      if (!handler_.getError().empty()) {
+        setError("Record " + std::to_string(getRecordCount() + 1) + " " + handler_.getError());
+      } else {
+        setError("Record " + std::to_string(getRecordCount() + 1) + " is invalid JSON: " + rapidjson::GetParseError_En(result.Code()));
+      }
+      return false;
+    }
+
+    const auto &keys = handler_.getKeys();
+    if (!hasSchema(keys)) {
+      std::vector<std::string> names;
+      names.reserve(keys.size());
+      for (const auto &key : keys) {
+        names.emplace_back(key.first, key.second);
+      }
+      schema_ = std::make_shared<RecordSchema>(std::move(names));
+    }
+    record.setSchema(schema_);
+    return true;
+  }
+
+ private:
+  bool hasSchema(const std::vector<std::pair<const char*, size_t>> &keys) const {
+    if (schema_ == nullptr || schema_->size() != keys.size()) {
+      return false;
+    }
+    const auto &names = schema_->getFieldNames();
+    for (size_t i = 0; i < keys.size(); i++) {
+      if (names[i].size() != keys[i].second || std::memcmp(names[i].data(), keys[i].first, keys[i].second) != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  rapidjson::Reader reader_;
+  RecordHandler handler_;
+  std::shared_ptr<RecordSchema> schema_;
+};
+
+}  // namespace
+
+void JsonLinesReader::initialize() {
+  ControllerService::initialize();
+}
+
+std::unique_ptr<RecordReader> JsonLinesReader::createRecordReader(const std::shared_ptr<io::BaseStream> &stream, uint64_t size) {
+  return std::unique_ptr<RecordReader>(new JsonRecordReader(stream, size));
+}
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,65 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_STANDARD_PROCESSORS_CONTROLLERS_JSONLINESREADER_H_
+#define EXTENSIONS_STANDARD_PROCESSORS_CONTROLLERS_JSONLINESREADER_H_
+
+#include <memory>
+#include <string>
+#include "core/Resource.h"
+#include "RecordSet.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+/**
+ * Purpose: Reads records from JSON Lines, one object per line. The members of an object become the
+ * fields of the record; nested objects and arrays are kept as their JSON text.
+ *
+ * Design: Lines are parsed in situ with the rapidjson SAX reader, so strings are unescaped in the
+ * read buffer and numbers keep their text. Consecutive records with the same members share a schema.
+ */
+class JsonLinesReader : public RecordReaderFactory {
+ public:
+  explicit JsonLinesReader(const std::string &name, const std::string &id)
+      : RecordReaderFactory(name, id) {
+  }
+
+  explicit JsonLinesReader(const std::string &name, utils::Identifier uuid = utils::Identifier())
+      : RecordReaderFactory(name, uuid) {
+  }
+
+  virtual void initialize();
+
+  virtual void onEnable() {
+  }
+
+  virtual std::unique_ptr<RecordReader> createRecordReader(const std::shared_ptr<io::BaseStream> &stream, uint64_t size);
+};
+
+REGISTER_RESOURCE(JsonLinesReader, "Reads records from JSON Lines, one JSON object per line.");
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_STANDARD_PROCESSORS_CONTROLLERS_JSONLINESREADER_H_ */
@@ -0,0 +1,155 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "JsonLinesRecordSetWriter.h"
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "core/Property.h"
+#include "utils/StringUtils.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+namespace {
+
+void appendJsonString(const char *data, size_t size, std::string &out) {
+  static const char hex[] = "0123456789abcdef";
+  out += '"';
+  size_t start = 0;
+  for (size_t i = 0; i < size; i++) {
+    const unsigned char c = static_cast<unsigned char>(data[i]);
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+    out.append(data + start, i - start);
+    start = i + 1;
+    switch (c) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      case '\r':
+        out += "\\r";
+        break;
+      case '\t':
+        out += "\\t";
+        break;
+      default:
+        out += "\\u00";
+        out += hex[c >> 4];
+        out += hex[c & 0xf];
+    }
+  }
+  out.append(data + start, size - start);
+  out += '"';
+}
+
+class JsonWriter : public RecordSetWriter {
+ public:
+  JsonWriter(const std::shared_ptr<io::BaseStream> &stream, bool suppress_nulls)
+      : RecordSetWriter(stream),
+        suppress_nulls_(suppress_nulls) {
+  }
+
+ protected:
+  virtual void writeRecord(const Record &record, std::string &out) {
+    if (record.getSchema() != schema_) {
+      // the quoted names are reused for every record of the schema
+      schema_ = record.getSchema();
+      keys_.clear();
+      if (schema_ != nullptr) {
+        for (const auto &name : schema_->getFieldNames()) {
+          std::string key;
+          appendJsonString(name.data(), name.size(), key);
+          key += ':';
+          keys_.push_back(key);
+        }
+      }
+    }
+
+    out += '{';
+    bool first = true;
+    for (size_t i = 0; i < record.size() && i < keys_.size(); i++) {
+      const RecordField &field = record.getField(i);
+      if (field.type == RecordFieldType::NULL_VALUE && suppress_nulls_) {
+        continue;
+      }
+      if (!first) {
+        out += ',';
+      }
+      first = false;
+      out += keys_[i];
+      switch (field.type) {
+        case RecordFieldType::STRING:
+          appendJsonString(field.data, field.size, out);
+          break;
+        case RecordFieldType::NULL_VALUE:
+          out += "null";
+          break;
+        default:
+          out.append(field.data, field.size);
+      }
+    }
+    out += "}\n";
+  }
+
+ private:
+  const bool suppress_nulls_;
+  std::shared_ptr<RecordSchema> schema_;
+  std::vector<std::string> keys_;
+};
+
+}  // namespace
+
+core::Property JsonLinesRecordSetWriter::SuppressNullValues(
+    core::PropertyBuilder::createProperty("Suppress Null Values")->withDescription("Whether fields without a value are left out of the objects instead of being written as null")
+        ->isRequired(true)->withDefaultValue<bool>(false)->build());
+
+void JsonLinesRecordSetWriter::initialize() {
+  ControllerService::initialize();
+  std::set<core::Property> supportedProperties;
+  supportedProperties.insert(SuppressNullValues);
+  setSupportedProperties(supportedProperties);
+}
+
+void JsonLinesRecordSetWriter::onEnable() {
+  std::string value;
+  if (getProperty(SuppressNullValues.getName(), value)) {
+    utils::StringUtils::StringToBool(value, suppress_nulls_);
+  }
+}
+
+std::unique_ptr<RecordSetWriter> JsonLinesRecordSetWriter::createRecordSetWriter(const std::shared_ptr<io::BaseStream> &stream) {
+  return std::unique_ptr<RecordSetWriter>(new JsonWriter(stream, suppress_nulls_));
+}
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,72 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_STANDARD_PROCESSORS_CONTROLLERS_JSONLINESRECORDSETWRITER_H_
+#define EXTENSIONS_STANDARD_PROCESSORS_CONTROLLERS_JSONLINESRECORDSETWRITER_H_
+
+#include <memory>
+#include <string>
+#include "core/Resource.h"
+#include "RecordSet.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+/**
+ * Purpose: Writes records as JSON Lines, one object per record. Numbers, booleans, nulls and nested
+ * values read from JSON keep their type; values read from CSV are written as strings.
+ */
+class JsonLinesRecordSetWriter : public RecordSetWriterFactory {
+ public:
+  explicit JsonLinesRecordSetWriter(const std::string &name, const std::string &id)
+      : RecordSetWriterFactory(name, id),
+        suppress_nulls_(false) {
+  }
+
+  explicit JsonLinesRecordSetWriter(const std::string &name, utils::Identifier uuid = utils::Identifier())
+      : RecordSetWriterFactory(name, uuid),
+        suppress_nulls_(false) {
+  }
+
+  static core::Property SuppressNullValues;
+
+  virtual void initialize();
+
+  virtual void onEnable();
+
+  virtual std::unique_ptr<RecordSetWriter> createRecordSetWriter(const std::shared_ptr<io::BaseStream> &stream);
+
+  virtual std::string getMimeType() const {
+    return "application/json";
+  }
+
+ private:
+  bool suppress_nulls_;
+};
+
+REGISTER_RESOURCE(JsonLinesRecordSetWriter, "Writes records as JSON Lines, one JSON object per line.");
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_STANDARD_PROCESSORS_CONTROLLERS_JSONLINESRECORDSETWRITER_H_ */
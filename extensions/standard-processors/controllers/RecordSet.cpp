@@ -0,0 +1,162 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "RecordSet.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+#define RECORD_READ_BUFFER_SIZE (64*1024)
+#define RECORD_WRITE_BUFFER_SIZE (64*1024)
+
+const size_t RecordSchema::npos = static_cast<size_t>(-1);
+
+RecordSchema::RecordSchema(std::vector<std::string> field_names)
+    : field_names_(std::move(field_names)) {
+  for (size_t i = 0; i < field_names_.size(); i++) {
+    // the first of duplicate names wins
+    field_indices_.insert(std::make_pair(field_names_[i], i));
+  }
+}
+
+size_t RecordSchema::getFieldIndex(const std::string &name) const {
+  auto index = field_indices_.find(name);
+  return index != field_indices_.end() ? index->second : npos;
+}
+
+const RecordField *Record::getField(const std::string &name) const {
+  if (schema_ == nullptr) {
+    return nullptr;
+  }
+  const size_t index = schema_->getFieldIndex(name);
+  return index < fields_.size() ? &fields_[index] : nullptr;
+}
+
+RecordReader::RecordReader(const std::shared_ptr<io::BaseStream> &stream, uint64_t size)
+    : stream_(stream),
+      remaining_(size),
+      buffer_(RECORD_READ_BUFFER_SIZE),
+      position_(0),
+      limit_(0),
+      record_count_(0) {
+}
+
+bool RecordReader::read(Record &record) {
+  while (error_.empty()) {
+    size_t length = 0;
+    while (true) {
+      if (position_ < limit_) {
+        length = findRecordEnd(buffer_.data() + position_, buffer_.data() + limit_);
+        if (length > 0) {
+          break;
+        }
+      }
+      if (!fill()) {
+        // the last record needs no line feed
+        length = limit_ - position_;
+        break;
+      }
+    }
+    if (length == 0) {
+      return false;
+    }
+
+    char *begin = buffer_.data() + position_;
+    position_ += length;
+    if (begin[length - 1] == '\n') {
+      length--;
+    }
+    if (length > 0 && begin[length - 1] == '\r') {
+      length--;
+    }
+    record.clear();
+    if (parse(begin, length, record)) {
+      record_count_++;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool RecordReader::fill() {
+  if (remaining_ == 0 || stream_ == nullptr) {
+    return false;
+  }
+  if (position_ > 0) {
+    std::memmove(buffer_.data(), buffer_.data() + position_, limit_ - position_);
+    limit_ -= position_;
+    position_ = 0;
+  }
+  // one byte stays free behind the content, for parse to terminate the last record
+  if (limit_ + 1 >= buffer_.size()) {
+    buffer_.resize(buffer_.size() * 2);
+  }
+  const uint64_t space = std::min<uint64_t>(buffer_.size() - 1 - limit_, INT_MAX);
+  const int ret = stream_->readData(reinterpret_cast<uint8_t*>(buffer_.data() + limit_), static_cast<int>(std::min(space, remaining_)));
+  if (ret <= 0) {
+    remaining_ = 0;
+    return false;
+  }
+  limit_ += ret;
+  remaining_ -= ret;
+  return true;
+}
+
+RecordSetWriter::RecordSetWriter(const std::shared_ptr<io::BaseStream> &stream)
+    : stream_(stream),
+      record_count_(0) {
+  buffer_.reserve(RECORD_WRITE_BUFFER_SIZE + 4096);
+}
+
+bool RecordSetWriter::write(const Record &record) {
+  writeRecord(record, buffer_);
+  record_count_++;
+  return buffer_.size() < RECORD_WRITE_BUFFER_SIZE || flush();
+}
+
+bool RecordSetWriter::finish() {
+  return flush();
+}
+
+bool RecordSetWriter::flush() {
+  if (buffer_.empty()) {
+    return true;
+  }
+  const int ret = stream_->writeData(reinterpret_cast<uint8_t*>(&buffer_[0]), static_cast<int>(buffer_.size()));
+  if (ret < 0 || static_cast<size_t>(ret) != buffer_.size()) {
+    return false;
+  }
+  buffer_.clear();
+  return true;
+}
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,307 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_STANDARD_PROCESSORS_CONTROLLERS_RECORDSET_H_
+#define EXTENSIONS_STANDARD_PROCESSORS_CONTROLLERS_RECORDSET_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "core/controller/ControllerService.h"
+#include "io/BaseStream.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+enum class RecordFieldType {
+  STRING,
+  NUMBER,
+  BOOLEAN,
+  NULL_VALUE,
+  // nested JSON object or array, kept as its JSON text
+  RAW
+};
+
+/**
+ * A value of a record. The value is not copied out of the buffer it was parsed from and is not
+ * null terminated.
+ */
+struct RecordField {
+  const char *data;
+  size_t size;
+  RecordFieldType type;
+
+  std::string toString() const {
+    return std::string(data, size);
+  }
+};
+
+/**
+ * The field names of records. Readers share one schema between all records with the same
+ * fields, so that writers can tell whether they have to match fields by name.
+ */
+class RecordSchema {
+ public:
+  static const size_t npos;
+
+  explicit RecordSchema(std::vector<std::string> field_names);
+
+  const std::vector<std::string> &getFieldNames() const {
+    return field_names_;
+  }
+
+  size_t size() const {
+    return field_names_.size();
+  }
+
+  /**
+   * @return the index of the field or npos if the schema has no such field
+   */
+  size_t getFieldIndex(const std::string &name) const;
+
+ private:
+  std::vector<std::string> field_names_;
+  std::unordered_map<std::string, size_t> field_indices_;
+};
+
+/**
+ * A record holds one value per field of its schema. Records are reused by the readers, so reading
+ * a record does not allocate once the vectors have grown to the number of fields.
+ */
+class Record {
+ public:
+  const std::shared_ptr<RecordSchema> &getSchema() const {
+    return schema_;
+  }
+
+  size_t size() const {
+    return fields_.size();
+  }
+
+  const RecordField &getField(size_t index) const {
+    return fields_[index];
+  }
+
+  /**
+   * @return the value of the field or nullptr if the schema has no such field
+   */
+  const RecordField *getField(const std::string &name) const;
+
+  void clear() {
+    schema_ = nullptr;
+    fields_.clear();
+    copies_.clear();
+  }
+
+  void setSchema(const std::shared_ptr<RecordSchema> &schema) {
+    schema_ = schema;
+  }
+
+  void addField(const char *data, size_t size, RecordFieldType type) {
+    fields_.push_back(RecordField { data, size, type });
+  }
+
+  /**
+   * Keeps a value the reader could not leave in its buffer, such as a nested object.
+   * @return the copy, valid until the record is cleared
+   */
+  const std::string &copy(std::string value) {
+    // a deque does not move its elements, so short strings keep their address
+    copies_.push_back(std::move(value));
+    return copies_.back();
+  }
+
+ private:
+  std::shared_ptr<RecordSchema> schema_;
+  std::vector<RecordField> fields_;
+  std::deque<std::string> copies_;
+};
+
+/**
+ * Purpose: Reads the records of one content stream.
+ *
+ * Design: The content is read in chunks into a buffer that grows to the largest record. Records end
+ * with a line feed; implementations may allow line feeds within a record. Records are parsed in
+ * place, so their values point into the buffer and stay valid until the next call to read.
+ * Implementations find where a record ends and parse it.
+ */
+class RecordReader {
+ public:
+  /**
+   * @param stream content stream
+   * @param size number of bytes of the stream belonging to the content
+   */
+  RecordReader(const std::shared_ptr<io::BaseStream> &stream, uint64_t size);
+
+  virtual ~RecordReader() {
+  }
+
+  /**
+   * Reads the next record.
+   * @return false at the end of the content or if the content is malformed, see getError
+   */
+  bool read(Record &record);
+
+  /**
+   * @return the reason reading stopped, or an empty string at the end of the content
+   */
+  const std::string &getError() const {
+    return error_;
+  }
+
+  uint64_t getRecordCount() const {
+    return record_count_;
+  }
+
+ protected:
+  /**
+   * Finds the end of the record starting at begin.
+   * @return the length of the record including its line feed, or 0 if no line feed ends the record
+   * within [begin, end)
+   */
+  virtual size_t findRecordEnd(const char *begin, const char *end) = 0;
+
+  /**
+   * Parses a complete record in place. The line feed ending the record, and a carriage return before
+   * it, are not part of length. begin[length] may be overwritten.
+   * @return false if the data did not hold a record, or an error was set
+   */
+  virtual bool parse(char *begin, size_t length, Record &record) = 0;
+
+  void setError(const std::string &error) {
+    error_ = error;
+  }
+
+ private:
+  bool fill();
+
+  std::shared_ptr<io::BaseStream> stream_;
+  uint64_t remaining_;
+  std::vector<char> buffer_;
+  size_t position_;
+  size_t limit_;
+  std::string error_;
+  uint64_t record_count_;
+};
+
+/**
+ * Purpose: Writes records to one content stream. Records are serialized into a buffer that is
+ * written to the stream in large blocks.
+ */
+class RecordSetWriter {
+ public:
+  explicit RecordSetWriter(const std::shared_ptr<io::BaseStream> &stream);
+
+  virtual ~RecordSetWriter() {
+  }
+
+  /**
+   * @return false if the stream could not be written
+   */
+  bool write(const Record &record);
+
+  /**
+   * Writes what is left in the buffer. Must be called after the last record.
+   * @return false if the stream could not be written
+   */
+  bool finish();
+
+  uint64_t getRecordCount() const {
+    return record_count_;
+  }
+
+ protected:
+  virtual void writeRecord(const Record &record, std::string &out) = 0;
+
+ private:
+  bool flush();
+
+  std::shared_ptr<io::BaseStream> stream_;
+  std::string buffer_;
+  uint64_t record_count_;
+};
+
+/**
+ * Controller service creating the readers of a record format.
+ */
+class RecordReaderFactory : public core::controller::ControllerService {
+ public:
+  explicit RecordReaderFactory(const std::string &name, const std::string &id)
+      : ControllerService(name, id) {
+  }
+
+  explicit RecordReaderFactory(const std::string &name, utils::Identifier uuid = utils::Identifier())
+      : ControllerService(name, uuid) {
+  }
+
+  virtual void yield() {
+  }
+
+  virtual bool isRunning() {
+    return getState() == core::controller::ControllerServiceState::ENABLED;
+  }
+
+  virtual bool isWorkAvailable() {
+    return false;
+  }
+
+  virtual std::unique_ptr<RecordReader> createRecordReader(const std::shared_ptr<io::BaseStream> &stream, uint64_t size) = 0;
+};
+
+/**
+ * Controller service creating the writers of a record format.
+ */
+class RecordSetWriterFactory : public core::controller::ControllerService {
+ public:
+  explicit RecordSetWriterFactory(const std::string &name, const std::string &id)
+      : ControllerService(name, id) {
+  }
+
+  explicit RecordSetWriterFactory(const std::string &name, utils::Identifier uuid = utils::Identifier())
+      : ControllerService(name, uuid) {
+  }
+
+  virtual void yield() {
+  }
+
+  virtual bool isRunning() {
+    return getState() == core::controller::ControllerServiceState::ENABLED;
+  }
+
+  virtual bool isWorkAvailable() {
+    return false;
+  }
+
+  virtual std::unique_ptr<RecordSetWriter> createRecordSetWriter(const std::shared_ptr<io::BaseStream> &stream) = 0;
+
+  virtual std::string getMimeType() const = 0;
+};
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_STANDARD_PROCESSORS_CONTROLLERS_RECORDSET_H_ */
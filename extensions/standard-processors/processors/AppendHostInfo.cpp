@@ -67,6 +67,14 @@ void AppendHostInfo::initialize() {
   setSupportedRelationships(relationships);
 }
 
+void AppendHostInfo::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
+  core::PropertySnapshot::Builder builder(*context);
+  interface_name_ = builder.bind<std::string>(InterfaceName);
+  host_attribute_ = builder.bind<std::string>(HostAttribute);
+  ip_attribute_ = builder.bind<std::string>(IPAttribute);
+  properties_ = builder.build();
+}
+
 void AppendHostInfo::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
   std::shared_ptr<core::FlowFile> flow = session->get();
   if (!flow)
@@ -74,13 +82,11 @@ void AppendHostInfo::onTrigger(core::ProcessContext *context, core::ProcessSessi
 
   // Get Hostname
 
-  std::string hostAttribute = "";
-  context->getProperty(HostAttribute.getName(), hostAttribute);
-  flow->addAttribute(hostAttribute.c_str(), org::apache::nifi::minifi::io::Socket::getMyHostName());
+  const std::string &hostAttribute = properties_->get(host_attribute_);
+  flow->addAttribute(hostAttribute, org::apache::nifi::minifi::io::Socket::getMyHostName());
 
   // Get IP address for the specified interface
-  std::string iface;
-  context->getProperty(InterfaceName.getName(), iface);
+  const std::string &iface = properties_->get(interface_name_);
   // Confirm the specified interface name exists on this device
 #ifndef WIN32
   if (if_nametoindex(iface.c_str()) != 0) {
@@ -93,9 +99,7 @@ void AppendHostInfo::onTrigger(core::ProcessContext *context, core::ProcessSessi
     ioctl(fd, SIOCGIFADDR, &ifr);
     close(fd);
 
-    std::string ipAttribute;
-    context->getProperty(IPAttribute.getName(), ipAttribute);
-    flow->addAttribute(ipAttribute.c_str(), inet_ntoa(((struct sockaddr_in *) &ifr.ifr_addr)->sin_addr));
+    flow->addAttribute(properties_->get(ip_attribute_), inet_ntoa(((struct sockaddr_in *) &ifr.ifr_addr)->sin_addr));
   }
 #endif
 
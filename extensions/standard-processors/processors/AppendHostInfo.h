@@ -24,6 +24,7 @@
 #include "FlowFileRecord.h"
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
+#include "core/PropertySnapshot.h"
 #include "core/Core.h"
 #include "core/Resource.h"
 #include "core/logging/LoggerConfiguration.h"
@@ -59,6 +60,8 @@ class AppendHostInfo : public core::Processor {
   static core::Relationship Success;
 
  public:
+  // OnSchedule method, implemented by NiFi AppendHostInfo
+  virtual void onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory);
   // OnTrigger method, implemented by NiFi AppendHostInfo
   virtual void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
   // Initialize, over write by NiFi AppendHostInfo
@@ -67,6 +70,11 @@ class AppendHostInfo : public core::Processor {
  protected:
 
  private:
+  // properties bound at onSchedule
+  std::shared_ptr<const core::PropertySnapshot> properties_;
+  core::PropertyHandle<std::string> interface_name_;
+  core::PropertyHandle<std::string> host_attribute_;
+  core::PropertyHandle<std::string> ip_attribute_;
   // Logger
   std::shared_ptr<logging::Logger> logger_;
 };
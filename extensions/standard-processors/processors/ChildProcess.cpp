@@ -0,0 +1,475 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ChildProcess.h"
+#ifndef WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern char **environ;
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+const size_t ChildProcess::MAX_ERROR_SIZE = 4000;
+
+namespace {
+
+const size_t BUFFER_SIZE = 64 * 1024;
+
+// how long the error stream may stay open after the output closed, a descendant may hold it
+const uint64_t ERROR_DRAIN_MS = 1000;
+
+// how long a terminated process may take to exit before it is killed
+const uint64_t TERMINATE_GRACE_MS = 2000;
+
+const uint64_t TERMINATE_POLL_MS = 10;
+
+uint64_t getSteadyMillis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool createPipe(int fds[2]) {
+  if (pipe(fds) != 0) {
+    return false;
+  }
+  // the ends the process uses are duplicated into it, so no other process inherits the pipe
+  fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+  return true;
+}
+
+void setNonBlocking(int fd) {
+  if (fd >= 0) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  }
+}
+
+void closeFd(int &fd) {
+  if (fd >= 0) {
+    close(fd);
+    fd = -1;
+  }
+}
+
+// runs the command with posix_spawnp, optionally in directory, and stores its pid
+int spawn(std::vector<char*> &argv, int stdin_fd, int stdout_fd, int stderr_fd, pid_t *pid, const char *directory = nullptr) {
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  if (stdin_fd >= 0) {
+    posix_spawn_file_actions_adddup2(&actions, stdin_fd, STDIN_FILENO);
+  } else {
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+  }
+  posix_spawn_file_actions_adddup2(&actions, stdout_fd, STDOUT_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, stderr_fd, STDERR_FILENO);
+  int ret = 0;
+  if (directory != nullptr) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+    ret = posix_spawn_file_actions_addchdir_np(&actions, directory);
+#else
+    ret = ENOTSUP;
+#endif
+  }
+  if (ret == 0) {
+    ret = posix_spawnp(pid, argv[0], &actions, nullptr, argv.data(), environ);
+  }
+  posix_spawn_file_actions_destroy(&actions);
+  return ret;
+}
+
+// forks to change into directory before running the command, where posix_spawn cannot
+int forkInDirectory(std::vector<char*> &argv, int stdin_fd, int stdout_fd, int stderr_fd, pid_t *pid, const char *directory) {
+  // the child reports why it could not run the command through this pipe, exec closes it otherwise
+  int status[2];
+  if (!createPipe(status)) {
+    return errno;
+  }
+  const pid_t child = fork();
+  if (child < 0) {
+    const int fork_errno = errno;
+    close(status[0]);
+    close(status[1]);
+    return fork_errno;
+  }
+  if (child == 0) {
+    // only async-signal-safe calls until exec
+    int child_errno = 0;
+    if (stdin_fd < 0) {
+      stdin_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    }
+    if (stdin_fd < 0 || dup2(stdin_fd, STDIN_FILENO) < 0 || dup2(stdout_fd, STDOUT_FILENO) < 0 || dup2(stderr_fd, STDERR_FILENO) < 0 || chdir(directory) != 0) {
+      child_errno = errno;
+    } else {
+      execvp(argv[0], argv.data());
+      child_errno = errno;
+    }
+    while (write(status[1], &child_errno, sizeof(child_errno)) < 0 && errno == EINTR) {
+    }
+    _exit(127);
+  }
+  close(status[1]);
+  int child_errno = 0;
+  ssize_t count;
+  while ((count = read(status[0], &child_errno, sizeof(child_errno))) < 0 && errno == EINTR) {
+  }
+  close(status[0]);
+  if (count == sizeof(child_errno)) {
+    while (waitpid(child, nullptr, 0) < 0 && errno == EINTR) {
+    }
+    return child_errno;
+  }
+  *pid = child;
+  return 0;
+}
+
+}  // namespace
+
+ChildProcess::ChildProcess()
+    : pid_(0),
+      exit_status_(-1),
+      input_fd_(-1),
+      output_fd_(-1),
+      error_fd_(-1),
+      transferred_size_(0) {
+}
+
+ChildProcess::~ChildProcess() {
+  terminate();
+}
+
+std::vector<std::string> ChildProcess::splitArguments(const std::string &command_line) {
+  std::vector<std::string> arguments;
+  std::string argument;
+  bool in_argument = false;
+  bool quoted = false;
+  for (const char c : command_line) {
+    if (c == '"') {
+      quoted = !quoted;
+      in_argument = true;
+    } else if (!quoted && std::isspace(static_cast<unsigned char>(c))) {
+      if (in_argument) {
+        arguments.push_back(argument);
+        argument.clear();
+        in_argument = false;
+      }
+    } else {
+      argument += c;
+      in_argument = true;
+    }
+  }
+  if (in_argument) {
+    arguments.push_back(argument);
+  }
+  return arguments;
+}
+
+bool ChildProcess::start(const std::vector<std::string> &arguments, const std::string &working_directory, bool pipe_input, bool redirect_error_stream) {
+  if (arguments.empty()) {
+    error_ = "No command to run";
+    return false;
+  }
+  int input[2] = { -1, -1 };
+  int output[2] = { -1, -1 };
+  int error[2] = { -1, -1 };
+  if ((pipe_input && !createPipe(input)) || !createPipe(output) || (!redirect_error_stream && !createPipe(error))) {
+    error_ = std::string("Could not create pipes: ") + std::strerror(errno);
+    for (int *fd : { &input[0], &input[1], &output[0], &output[1], &error[0], &error[1] }) {
+      closeFd(*fd);
+    }
+    return false;
+  }
+
+  std::vector<char*> argv;
+  for (const auto &argument : arguments) {
+    argv.push_back(const_cast<char*>(argument.c_str()));
+  }
+  argv.push_back(nullptr);
+  const int stdin_fd = pipe_input ? input[0] : -1;
+  const int stderr_fd = redirect_error_stream ? output[1] : error[1];
+  const char *directory = working_directory.empty() ? nullptr : working_directory.c_str();
+  int ret = spawn(argv, stdin_fd, output[1], stderr_fd, &pid_, directory);
+  if (ret == ENOTSUP && directory != nullptr) {
+    ret = forkInDirectory(argv, stdin_fd, output[1], stderr_fd, &pid_, directory);
+  }
+
+  closeFd(input[0]);
+  closeFd(output[1]);
+  closeFd(error[1]);
+  input_fd_ = input[1];
+  output_fd_ = output[0];
+  error_fd_ = error[0];
+  if (ret != 0) {
+    pid_ = 0;
+    closePipes();
+    error_ = "Could not run " + arguments[0] + ": " + std::strerror(ret);
+    return false;
+  }
+  setNonBlocking(input_fd_);
+  setNonBlocking(output_fd_);
+  setNonBlocking(error_fd_);
+  exit_status_ = -1;
+  pending_output_.clear();
+  return true;
+}
+
+ChildProcess::Result ChildProcess::transfer(const std::shared_ptr<io::BaseStream> &input, uint64_t input_size, bool close_input, const std::shared_ptr<io::BaseStream> &output,
+                                            uint64_t timeout_ms, bool line_mode) {
+  transferred_size_ = 0;
+  // one byte more for the line feed ending the last line of input
+  std::vector<uint8_t> input_buffer(input != nullptr && input_size > 0 ? BUFFER_SIZE + 1 : 0);
+  size_t input_position = 0;
+  size_t input_limit = 0;
+  uint64_t input_remaining = input != nullptr && input_fd_ >= 0 ? input_size : 0;
+  uint64_t input_lines = 0;
+  uint64_t output_lines = 0;
+
+  // writes output up to the line answering the last line of input and keeps the rest
+  auto consume = [&](const char *data, size_t size) {
+    size_t length = size;
+    if (line_mode) {
+      const bool input_done = input_position == input_limit && input_remaining == 0;
+      const char *position = data;
+      const char *end = data + size;
+      const char *line_end;
+      while (position < end && (line_end = static_cast<const char*>(std::memchr(position, '\n', end - position))) != nullptr) {
+        output_lines++;
+        position = line_end + 1;
+        if (input_done && output_lines >= input_lines) {
+          length = position - data;
+          pending_output_.append(position, end - position);
+          break;
+        }
+      }
+    }
+    if (length > 0 && output->writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(data)), static_cast<int>(length)) != static_cast<int>(length)) {
+      return false;
+    }
+    transferred_size_ += length;
+    return true;
+  };
+
+  std::vector<char> output_buffer(BUFFER_SIZE);
+  if (!pending_output_.empty()) {
+    std::string pending;
+    pending.swap(pending_output_);
+    if (!consume(pending.data(), pending.size())) {
+      return Result::FAILED;
+    }
+  }
+
+  const uint64_t start = getSteadyMillis();
+  uint64_t output_closed_at = 0;
+  while (true) {
+    if (input_position == input_limit && input_remaining > 0) {
+      const int ret = input->readData(input_buffer.data(), static_cast<int>(std::min<uint64_t>(BUFFER_SIZE, input_remaining)));
+      if (ret <= 0) {
+        return Result::FAILED;
+      }
+      input_position = 0;
+      input_limit = ret;
+      input_remaining -= ret;
+      if (line_mode) {
+        if (input_remaining == 0 && input_buffer[input_limit - 1] != '\n') {
+          input_buffer[input_limit++] = '\n';
+        }
+        input_lines += std::count(input_buffer.begin(), input_buffer.begin() + input_limit, '\n');
+      }
+    }
+    const bool input_done = input_position == input_limit && input_remaining == 0;
+    if (input_done && close_input) {
+      closeFd(input_fd_);
+    }
+    if (line_mode && input_done && output_lines >= input_lines) {
+      return Result::LINES_READ;
+    }
+
+    const uint64_t now = getSteadyMillis();
+    int wait_ms = -1;
+    if (timeout_ms > 0) {
+      if (now - start >= timeout_ms) {
+        return Result::TIMED_OUT;
+      }
+      wait_ms = static_cast<int>(timeout_ms - (now - start));
+    }
+    if (output_fd_ < 0) {
+      if (error_fd_ < 0 || now - output_closed_at >= ERROR_DRAIN_MS) {
+        return Result::OUTPUT_CLOSED;
+      }
+      const int drain_ms = static_cast<int>(ERROR_DRAIN_MS - (now - output_closed_at));
+      wait_ms = wait_ms < 0 ? drain_ms : std::min(wait_ms, drain_ms);
+    }
+
+    struct pollfd fds[3];
+    nfds_t count = 0;
+    int input_index = -1;
+    int output_index = -1;
+    int error_index = -1;
+    if (input_fd_ >= 0 && input_position < input_limit) {
+      input_index = count;
+      fds[count++] = { input_fd_, POLLOUT, 0 };
+    }
+    if (output_fd_ >= 0) {
+      output_index = count;
+      fds[count++] = { output_fd_, POLLIN, 0 };
+    }
+    if (error_fd_ >= 0) {
+      error_index = count;
+      fds[count++] = { error_fd_, POLLIN, 0 };
+    }
+    if (poll(fds, count, wait_ms) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return Result::FAILED;
+    }
+
+    if (input_index >= 0 && fds[input_index].revents != 0) {
+      const ssize_t written = writeInput(&input_buffer[input_position], input_limit - input_position);
+      if (written >= 0) {
+        input_position += written;
+      } else if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        // the process stopped reading, the rest of the input is dropped
+        closeFd(input_fd_);
+        input_position = input_limit;
+        input_remaining = 0;
+      }
+    }
+    if (output_index >= 0 && fds[output_index].revents != 0) {
+      const ssize_t read_count = read(output_fd_, output_buffer.data(), output_buffer.size());
+      if (read_count > 0) {
+        if (!consume(output_buffer.data(), read_count)) {
+          return Result::FAILED;
+        }
+      } else if (read_count == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        closeFd(output_fd_);
+        output_closed_at = getSteadyMillis();
+      }
+    }
+    if (error_index >= 0 && fds[error_index].revents != 0) {
+      readError();
+    }
+  }
+}
+
+bool ChildProcess::isRunning() {
+  if (pid_ <= 0) {
+    return false;
+  }
+  int status = 0;
+  if (waitpid(pid_, &status, WNOHANG) == 0) {
+    return true;
+  }
+  exit_status_ = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+  pid_ = 0;
+  return false;
+}
+
+int ChildProcess::wait() {
+  closeFd(input_fd_);
+  if (pid_ > 0) {
+    int status = 0;
+    pid_t ret;
+    while ((ret = waitpid(pid_, &status, 0)) < 0 && errno == EINTR) {
+    }
+    if (ret == pid_) {
+      exit_status_ = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    }
+    pid_ = 0;
+  }
+  closePipes();
+  return exit_status_;
+}
+
+void ChildProcess::terminate() {
+  if (isRunning()) {
+    kill(pid_, SIGTERM);
+    const uint64_t start = getSteadyMillis();
+    while (isRunning() && getSteadyMillis() - start < TERMINATE_GRACE_MS) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(TERMINATE_POLL_MS));
+    }
+    if (isRunning()) {
+      kill(pid_, SIGKILL);
+    }
+    wait();
+  }
+  closePipes();
+}
+
+void ChildProcess::closePipes() {
+  closeFd(input_fd_);
+  closeFd(output_fd_);
+  closeFd(error_fd_);
+}
+
+ssize_t ChildProcess::writeInput(const uint8_t *data, size_t size) {
+  sigset_t pipe_signal;
+  sigset_t previous;
+  sigemptyset(&pipe_signal);
+  sigaddset(&pipe_signal, SIGPIPE);
+  pthread_sigmask(SIG_BLOCK, &pipe_signal, &previous);
+  const ssize_t written = write(input_fd_, data, size);
+  const int write_errno = errno;
+  if (written < 0 && write_errno == EPIPE) {
+    // take the signal the write raised before unblocking it
+    const struct timespec no_wait = { 0, 0 };
+    sigtimedwait(&pipe_signal, nullptr, &no_wait);
+  }
+  pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+  errno = write_errno;
+  return written;
+}
+
+bool ChildProcess::readError() {
+  char buffer[4096];
+  const ssize_t count = read(error_fd_, buffer, sizeof(buffer));
+  if (count > 0) {
+    if (error_.size() < MAX_ERROR_SIZE) {
+      error_.append(buffer, std::min<size_t>(count, MAX_ERROR_SIZE - error_.size()));
+    }
+    return true;
+  }
+  if (count == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+    closeFd(error_fd_);
+  }
+  return false;
+}
+
+} /* namespace processors */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+#endif
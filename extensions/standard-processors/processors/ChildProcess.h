@@ -0,0 +1,155 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_CHILDPROCESS_H_
+#define EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_CHILDPROCESS_H_
+
+#ifndef WIN32
+#include <sys/types.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "io/BaseStream.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+/**
+ * Purpose: Runs a command with pipes to its standard streams.
+ *
+ * Design: The process is started with posix_spawn, so the agent is not copied as a fork would.
+ * Only where posix_spawn cannot change the working directory does it fall back to fork and exec.
+ * transfer multiplexes writing the input with reading the output and error streams through poll,
+ * so a process that fills its output pipe before it read all of its input does not block. Data
+ * moves in 64 KB blocks straight between the pipes and the content streams.
+ */
+class ChildProcess {
+ public:
+  enum class Result {
+    // the process closed its standard output
+    OUTPUT_CLOSED,
+    // the timeout passed before the output closed
+    TIMED_OUT,
+    // the process answered every line of input with a line of output
+    LINES_READ,
+    // reading the input or writing the output failed
+    FAILED
+  };
+
+  // at most this much of the error stream is kept
+  static const size_t MAX_ERROR_SIZE;
+
+  ChildProcess();
+
+  ChildProcess(const ChildProcess &other) = delete;
+  ChildProcess &operator=(const ChildProcess &other) = delete;
+
+  // terminates the process if it still runs
+  ~ChildProcess();
+
+  /**
+   * Splits a command line at white space. Double quotes group white space into an argument.
+   */
+  static std::vector<std::string> splitArguments(const std::string &command_line);
+
+  /**
+   * Starts the process.
+   * @param arguments the command, found in PATH unless it contains a slash, and its arguments
+   * @param working_directory directory to run in, or empty for the directory of the agent
+   * @param pipe_input whether to write to its standard input; otherwise it reads /dev/null
+   * @param redirect_error_stream whether its error stream goes to its standard output
+   * @return false if the process could not be started, see getError
+   */
+  bool start(const std::vector<std::string> &arguments, const std::string &working_directory, bool pipe_input, bool redirect_error_stream);
+
+  /**
+   * Writes input to the process while copying its standard output to output and keeping its
+   * error stream.
+   * @param input stream to write to the process, or nullptr
+   * @param input_size bytes of the input to write
+   * @param close_input whether to close the standard input once the input is written
+   * @param output stream receiving the standard output
+   * @param timeout_ms how long to transfer at most, or 0 to transfer until the output closes
+   * @param line_mode whether to stop once the process wrote a line for every line of input
+   */
+  Result transfer(const std::shared_ptr<io::BaseStream> &input, uint64_t input_size, bool close_input, const std::shared_ptr<io::BaseStream> &output, uint64_t timeout_ms, bool line_mode);
+
+  /**
+   * @return bytes written to the output by the last transfer
+   */
+  uint64_t getTransferredSize() const {
+    return transferred_size_;
+  }
+
+  /**
+   * @return the error stream of the process since the last clearError, or why starting failed
+   */
+  const std::string &getError() const {
+    return error_;
+  }
+
+  void clearError() {
+    error_.clear();
+  }
+
+  /**
+   * @return whether the process was started and has not exited
+   */
+  bool isRunning();
+
+  /**
+   * Closes the standard input and waits for the process to exit.
+   * @return the exit status, 128 plus the signal if a signal ended it, or -1 if it was not started
+   */
+  int wait();
+
+  /**
+   * Sends SIGTERM to the process and SIGKILL if it did not exit within a grace period, then reaps it.
+   */
+  void terminate();
+
+ private:
+  void closePipes();
+
+  // writes to the standard input without raising SIGPIPE if the process closed it
+  ssize_t writeInput(const uint8_t *data, size_t size);
+
+  bool readError();
+
+  pid_t pid_;
+  int exit_status_;
+  int input_fd_;
+  int output_fd_;
+  int error_fd_;
+  // output read beyond the last expected line, for the next transfer
+  std::string pending_output_;
+  std::string error_;
+  uint64_t transferred_size_;
+};
+
+} /* namespace processors */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif
+#endif /* EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_CHILDPROCESS_H_ */
@@ -0,0 +1,101 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ConvertRecord.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include "RecordCallbacks.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+core::Property ConvertRecord::RecordReader(
+    core::PropertyBuilder::createProperty("Record Reader")->withDescription("The controller service reading the records of incoming FlowFiles")->isRequired(true)
+        ->asType<controllers::RecordReaderFactory>()->build());
+
+core::Property ConvertRecord::RecordWriter(
+    core::PropertyBuilder::createProperty("Record Writer")->withDescription("The controller service writing the records of outgoing FlowFiles")->isRequired(true)
+        ->asType<controllers::RecordSetWriterFactory>()->build());
+
+core::Relationship ConvertRecord::Success("success", "FlowFiles holding the converted records");
+core::Relationship ConvertRecord::Failure("failure", "FlowFiles whose records could not be read or written");
+
+void ConvertRecord::initialize() {
+  std::set<core::Property> properties;
+  properties.insert(RecordReader);
+  properties.insert(RecordWriter);
+  setSupportedProperties(properties);
+  std::set<core::Relationship> relationships;
+  relationships.insert(Success);
+  relationships.insert(Failure);
+  setSupportedRelationships(relationships);
+}
+
+void ConvertRecord::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
+  reader_factory_ = getRecordService<controllers::RecordReaderFactory>(context, RecordReader);
+  writer_factory_ = getRecordService<controllers::RecordSetWriterFactory>(context, RecordWriter);
+}
+
+void ConvertRecord::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
+  auto flow_file = session->get();
+  if (!flow_file) {
+    return;
+  }
+
+  std::string error;
+  RecordWriteCallback write_callback(writer_factory_, [&](controllers::RecordSetWriter &writer) {
+    bool written = true;
+    RecordReadCallback read_callback(reader_factory_, flow_file->getSize(), [&](controllers::RecordReader &reader) {
+      controllers::Record record;
+      while (written && reader.read(record)) {
+        written = writer.write(record);
+      }
+    });
+    session->read(flow_file, &read_callback);
+    error = read_callback.getError();
+    return written && error.empty();
+  });
+  auto converted = session->create(flow_file);
+  session->write(converted, &write_callback);
+
+  if (!write_callback.isSuccess()) {
+    if (error.empty()) {
+      error = "the records could not be written";
+    }
+    logger_->log_error("Failed to convert the records of %s: %s", flow_file->getUUIDStr(), error);
+    session->remove(converted);
+    session->transfer(flow_file, Failure);
+    return;
+  }
+  session->putAttribute(converted, "record.count", std::to_string(write_callback.getRecordCount()));
+  session->putAttribute(converted, FlowAttributeKey(MIME_TYPE), writer_factory_->getMimeType());
+  logger_->log_debug("Converted %llu records of %s", write_callback.getRecordCount(), flow_file->getUUIDStr());
+  session->remove(flow_file);
+  session->transfer(converted, Success);
+}
+
+} /* namespace processors */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
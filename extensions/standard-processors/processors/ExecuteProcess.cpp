@@ -18,10 +18,10 @@
  * limitations under the License.
  */
 #include "ExecuteProcess.h"
-#include <cstring>
 #include <memory>
 #include <string>
 #include <set>
+#include <vector>
 #include "core/ProcessContext.h"
 #include "core/ProcessSession.h"
 #include "utils/StringUtils.h"
@@ -80,164 +80,91 @@ void ExecuteProcess::initialize() {
   setSupportedRelationships(relationships);
 }
 
+void ExecuteProcess::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
+  core::PropertySnapshot::Builder builder(*context);
+  command_ = builder.bind<std::string>(Command);
+  command_argument_ = builder.bind<std::string>(CommandArguments);
+  working_dir_ = builder.bind<std::string>(WorkingDir);
+  batch_duration_ = builder.bind<std::chrono::milliseconds>(BatchDuration, std::chrono::milliseconds(0));
+  redirect_error_stream_ = builder.bind<bool>(RedirectErrorStream, false);
+  properties_ = builder.build();
+
+  _batchDuration = properties_->get(batch_duration_).count();
+  stopping_ = false;
+  _redirectErrorStream = properties_->get(redirect_error_stream_);
+}
+
 void ExecuteProcess::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
   std::string value;
   std::shared_ptr<core::FlowFile> flow_file;
-  if (context->getProperty(Command, value, flow_file)) {
+  // expression language properties are evaluated by the context on each trigger
+  if (properties_->getProperty(*context, command_, value, flow_file)) {
     this->_command = value;
   }
-  if (context->getProperty(CommandArguments, value, flow_file)) {
+  if (properties_->getProperty(*context, command_argument_, value, flow_file)) {
     this->_commandArgument = value;
   }
-  if (context->getProperty(WorkingDir, value, flow_file)) {
+  if (properties_->getProperty(*context, working_dir_, value, flow_file)) {
     this->_workingDir = value;
   }
-  if (context->getProperty(BatchDuration.getName(), value)) {
-    core::TimeUnit unit;
-    if (core::Property::StringToTime(value, _batchDuration, unit) && core::Property::ConvertTimeUnitToMS(_batchDuration, unit, _batchDuration)) {
-      logger_->log_debug("Setting _batchDuration");
-    }
-  }
-  if (context->getProperty(RedirectErrorStream.getName(), value)) {
-    org::apache::nifi::minifi::utils::StringUtils::StringToBool(value, _redirectErrorStream);
-  }
   this->_fullCommand = _command + " " + _commandArgument;
-  if (_fullCommand.length() == 0) {
+  const std::vector<std::string> arguments = ChildProcess::splitArguments(_fullCommand);
+  if (arguments.empty()) {
     yield();
     return;
   }
-  if (_workingDir.length() > 0 && _workingDir != ".") {
-    // change to working directory
-    if (chdir(_workingDir.c_str()) != 0) {
-      logger_->log_error("Execute Command can not chdir %s", _workingDir);
-      yield();
-      return;
-    }
-  }
   logger_->log_info("Execute Command %s", _fullCommand);
-  // split the command into array
-  char *p = std::strtok(const_cast<char*>(_fullCommand.c_str()), " ");
-  int argc = 0;
-  char *argv[64];
-  while (p != 0 && argc < 64) {
-    argv[argc] = p;
-    p = std::strtok(NULL, " ");
-    argc++;
+  // the process changes into the working directory, the agent stays where it is
+  ChildProcess process;
+  if (!process.start(arguments, _workingDir != "." ? _workingDir : "", false, _redirectErrorStream)) {
+    logger_->log_error("Execute Command %s failed: %s", _fullCommand, process.getError());
+    yield();
+    return;
   }
-  argv[argc] = NULL;
-  int status;
-  if (!_processRunning) {
-    _processRunning = true;
-    // if the process has not launched yet
-    // create the pipe
-    if (pipe(_pipefd) == -1) {
-      _processRunning = false;
-      yield();
-      return;
-    }
-    switch (_pid = fork()) {
-      case -1:
-        logger_->log_error("Execute Process fork failed");
-        _processRunning = false;
-        close(_pipefd[0]);
-        close(_pipefd[1]);
-        yield();
-        break;
-      case 0:  // this is the code the child runs
-        close(1);      // close stdout
-        dup(_pipefd[1]);  // points pipefd at file descriptor
-        if (_redirectErrorStream)
-          // redirect stderr
-          dup2(_pipefd[1], 2);
-        close(_pipefd[0]);
-        execvp(argv[0], argv);
-        exit(1);
-        break;
-      default:  // this is the code the parent runs
-        // the parent isn't going to write to the pipe
-        close(_pipefd[1]);
-        if (_batchDuration > 0) {
-          while (1) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(_batchDuration));
-            char buffer[4096];
-            int numRead = read(_pipefd[0], buffer, sizeof(buffer));
-            if (numRead <= 0)
-              break;
-            logger_->log_debug("Execute Command Respond %d", numRead);
-            ExecuteProcess::WriteCallback callback(buffer, numRead);
-            std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast<FlowFileRecord>(session->create());
-            if (!flowFile)
-              continue;
-            flowFile->addAttribute("command", _command);
-            flowFile->addAttribute("command.arguments", _commandArgument);
-            session->write(flowFile, &callback);
-            session->transfer(flowFile, Success);
-            session->commit();
-          }
-        } else {
-          char buffer[4096];
-          char *bufPtr = buffer;
-          int totalRead = 0;
-          std::shared_ptr<FlowFileRecord> flowFile = nullptr;
-          while (1) {
-            int numRead = read(_pipefd[0], bufPtr, (sizeof(buffer) - totalRead));
-            if (numRead <= 0) {
-              if (totalRead > 0) {
-                logger_->log_debug("Execute Command Respond %d", totalRead);
-                // child exits and close the pipe
-                ExecuteProcess::WriteCallback callback(buffer, totalRead);
-                if (!flowFile) {
-                  flowFile = std::static_pointer_cast<FlowFileRecord>(session->create());
-                  if (!flowFile)
-                    break;
-                  flowFile->addAttribute("command", _command);
-                  flowFile->addAttribute("command.arguments", _commandArgument);
-                  session->write(flowFile, &callback);
-                } else {
-                  session->append(flowFile, &callback);
-                }
-                session->transfer(flowFile, Success);
-              }
-              break;
-            } else {
-              if (numRead == static_cast<int>((sizeof(buffer) - totalRead))) {
-                // we reach the max buffer size
-                logger_->log_debug("Execute Command Max Respond %d", sizeof(buffer));
-                ExecuteProcess::WriteCallback callback(buffer, sizeof(buffer));
-                if (!flowFile) {
-                  flowFile = std::static_pointer_cast<FlowFileRecord>(session->create());
-                  if (!flowFile)
-                    continue;
-                  flowFile->addAttribute("command", _command);
-                  flowFile->addAttribute("command.arguments", _commandArgument);
-                  session->write(flowFile, &callback);
-                } else {
-                  session->append(flowFile, &callback);
-                }
-                // Rewind
-                totalRead = 0;
-                bufPtr = buffer;
-              } else {
-                totalRead += numRead;
-                bufPtr += numRead;
-              }
-            }
-          }
-        }
-
-        wait(&status);
-        if (WIFEXITED(status)) {
-          logger_->log_info("Execute Command Complete %s status %d pid %d", _fullCommand, WEXITSTATUS(status), _pid);
-        } else {
-          logger_->log_info("Execute Command Complete %s status %d pid %d", _fullCommand, WTERMSIG(status), _pid);
-        }
 
-        close(_pipefd[0]);
-        _processRunning = false;
-        break;
+  // without a batch duration all of the output goes to one FlowFile
+  ChildProcess::Result result = ChildProcess::Result::FAILED;
+  do {
+    std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast<FlowFileRecord>(session->create());
+    if (!flowFile) {
+      break;
+    }
+    ExecuteProcess::WriteCallback callback(process, _batchDuration > 0 ? _batchDuration : 0);
+    session->write(flowFile, &callback);
+    result = callback.getResult();
+    if (result == ChildProcess::Result::FAILED) {
+      // the session was rolled back
+      logger_->log_error("Execute Command %s could not write its output", _fullCommand);
+      break;
+    }
+    if (flowFile->getSize() == 0) {
+      session->remove(flowFile);
+    } else {
+      logger_->log_debug("Execute Command Respond %llu", flowFile->getSize());
+      flowFile->addAttribute("command", _command);
+      flowFile->addAttribute("command.arguments", _commandArgument);
+      session->transfer(flowFile, Success);
+    }
+    if (_batchDuration > 0) {
+      session->commit();
     }
+  } while (result == ChildProcess::Result::TIMED_OUT && !stopping_);
+
+  if (result == ChildProcess::Result::OUTPUT_CLOSED) {
+    const int status = process.wait();
+    logger_->log_info("Execute Command Complete %s status %d", _fullCommand, status);
+  } else {
+    process.terminate();
+    logger_->log_info("Execute Command %s terminated", _fullCommand);
+  }
+  if (!process.getError().empty()) {
+    logger_->log_warn("Execute Command %s error stream: %s", _fullCommand, process.getError());
   }
 }
+
+void ExecuteProcess::notifyStop() {
+  stopping_ = true;
+}
 #endif
 } /* namespace processors */
 } /* namespace minifi */
@@ -20,23 +20,15 @@
 #ifndef __EXECUTE_PROCESS_H__
 #define __EXECUTE_PROCESS_H__
 
-#include <stdio.h>
+#include <atomic>
+#include <memory>
 #include <string>
-#include <errno.h>
-#include <chrono>
-#include <thread>
-#include <iostream>
-#include <sys/types.h>
-#include <signal.h>
-#ifndef WIN32
-#include <sys/wait.h>
-#include <sys/types.h>
-#include <signal.h>
-#endif
+#include "ChildProcess.h"
 #include "io/BaseStream.h"
 #include "FlowFileRecord.h"
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
+#include "core/PropertySnapshot.h"
 #include "core/Core.h"
 #include "core/Resource.h"
 #include "core/logging/LoggerConfiguration.h"
@@ -61,13 +53,10 @@ class ExecuteProcess : public core::Processor {
     _redirectErrorStream = false;
     _batchDuration = 0;
     _workingDir = ".";
-    _processRunning = false;
-    _pid = 0;
+    stopping_ = false;
   }
   // Destructor
   virtual ~ExecuteProcess() {
-    if (_processRunning && _pid > 0)
-      kill(_pid, SIGTERM);
   }
   // Processor Name
   static constexpr char const* ProcessorName = "ExecuteProcess";
@@ -80,35 +69,49 @@ class ExecuteProcess : public core::Processor {
   // Supported Relationships
   static core::Relationship Success;
 
-  // Nest Callback Class for write stream
+  // Nest Callback Class streaming the output of the process into the content
   class WriteCallback : public OutputStreamCallback {
    public:
-    WriteCallback(char *data, uint64_t size)
-        : _data(data),
-          _dataSize(size) {
+    WriteCallback(ChildProcess &process, uint64_t timeout_ms)
+        : process_(process),
+          timeout_ms_(timeout_ms),
+          result_(ChildProcess::Result::FAILED) {
     }
-    char *_data;
-    uint64_t _dataSize;
-    //void process(std::ofstream *stream) {
     int64_t process(std::shared_ptr<io::BaseStream> stream) {
-      int64_t ret = 0;
-      if (_data && _dataSize > 0)
-        ret = stream->write(reinterpret_cast<uint8_t*>(_data), _dataSize);
-      return ret;
+      result_ = process_.transfer(nullptr, 0, true, stream, timeout_ms_, false);
+      return result_ == ChildProcess::Result::FAILED ? -1 : static_cast<int64_t>(process_.getTransferredSize());
+    }
+    ChildProcess::Result getResult() const {
+      return result_;
     }
+   private:
+    ChildProcess &process_;
+    uint64_t timeout_ms_;
+    ChildProcess::Result result_;
   };
 
  public:
+  // OnSchedule method, implemented by NiFi ExecuteProcess
+  virtual void onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory);
   // OnTrigger method, implemented by NiFi ExecuteProcess
   virtual void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
   // Initialize, over write by NiFi ExecuteProcess
   virtual void initialize(void);
+  // Ends a process running in batches
+  virtual void notifyStop();
 
  protected:
 
  private:
   // Logger
   std::shared_ptr<logging::Logger> logger_;
+  // properties bound at onSchedule
+  std::shared_ptr<const core::PropertySnapshot> properties_;
+  core::PropertyHandle<std::string> command_;
+  core::PropertyHandle<std::string> command_argument_;
+  core::PropertyHandle<std::string> working_dir_;
+  core::PropertyHandle<std::chrono::milliseconds> batch_duration_;
+  core::PropertyHandle<bool> redirect_error_stream_;
   // Property
   std::string _command;
   std::string _commandArgument;
@@ -117,10 +120,8 @@ class ExecuteProcess : public core::Processor {
   bool _redirectErrorStream;
   // Full command
   std::string _fullCommand;
-  // whether the process is running
-  bool _processRunning;
-  int _pipefd[2];
-  pid_t _pid;
+  // set while the processor stops, so that a long-running process is ended
+  std::atomic<bool> stopping_;
 };
 
 REGISTER_RESOURCE(ExecuteProcess, "Runs an operating system command specified by the user and writes the output of that command to a FlowFile. If the command is expected to be long-running,"
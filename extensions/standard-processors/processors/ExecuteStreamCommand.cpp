@@ -0,0 +1,311 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "ExecuteStreamCommand.h"
+#ifndef WIN32
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "core/ProcessContext.h"
+#include "core/TypedValues.h"
+#include "utils/StringUtils.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+core::Property ExecuteStreamCommand::CommandPath(
+    core::PropertyBuilder::createProperty("Command Path")->withDescription("The command to run; if just the name of an executable is provided, it must be in the user's environment PATH.")
+        ->isRequired(true)->supportsExpressionLanguage(true)->build());
+
+core::Property ExecuteStreamCommand::CommandArguments(
+    core::PropertyBuilder::createProperty("Command Arguments")->withDescription("The arguments to supply to the command, separated by the Argument Delimiter")
+        ->supportsExpressionLanguage(true)->withDefaultValue("")->build());
+
+core::Property ExecuteStreamCommand::ArgumentDelimiter(
+    core::PropertyBuilder::createProperty("Argument Delimiter")->withDescription("The character separating the Command Arguments. If empty, the arguments are separated by white space, "
+                                                                                 "which can be escaped by enclosing it in double-quotes.")->withDefaultValue(";")->build());
+
+core::Property ExecuteStreamCommand::WorkingDir(
+    core::PropertyBuilder::createProperty("Working Directory")->withDescription("The directory to run the command in, the directory of the agent if empty")
+        ->supportsExpressionLanguage(true)->withDefaultValue("")->build());
+
+core::Property ExecuteStreamCommand::IgnoreStdin(
+    core::PropertyBuilder::createProperty("Ignore STDIN")->withDescription("If true, the content of the FlowFile is not written to the standard input of the command")
+        ->withDefaultValue<bool>(false)->build());
+
+core::Property ExecuteStreamCommand::KeepProcessRunning(
+    core::PropertyBuilder::createProperty("Keep Process Running")->withDescription(
+        "If true, the command is expected to answer every line of input with one line of output, such as sed -u, and is kept running between FlowFiles. "
+        "Expression language is then evaluated once, without FlowFile attributes.")->withDefaultValue<bool>(false)->build());
+
+core::Property ExecuteStreamCommand::ResponseTimeout(
+    core::PropertyBuilder::createProperty("Response Timeout")->withDescription("How long the command may take for one FlowFile before it is terminated, 0 sec waits indefinitely")
+        ->withDefaultValue<core::TimePeriodValue>("30 sec")->build());
+
+core::Relationship ExecuteStreamCommand::OutputStream("output stream", "The standard output of commands that succeeded");
+core::Relationship ExecuteStreamCommand::Original("original", "The incoming FlowFiles, with the execution attributes");
+core::Relationship ExecuteStreamCommand::NonzeroStatus("nonzero status", "The standard output of commands that exited with a nonzero status, failed or timed out");
+
+namespace {
+
+/**
+ * Transfers the content of a FlowFile from the input stream to the process.
+ */
+class InputCallback : public InputStreamCallback {
+ public:
+  InputCallback(ChildProcess &process, const std::shared_ptr<io::BaseStream> &output, uint64_t size, bool keep_running, uint64_t timeout_ms)
+      : process_(process),
+        output_(output),
+        size_(size),
+        keep_running_(keep_running),
+        timeout_ms_(timeout_ms),
+        result_(ChildProcess::Result::FAILED) {
+  }
+
+  int64_t process(std::shared_ptr<io::BaseStream> stream) {
+    result_ = process_.transfer(stream, size_, !keep_running_, output_, timeout_ms_, keep_running_);
+    // a failure rolls back the session once, in the output callback
+    return 0;
+  }
+
+  ChildProcess::Result getResult() const {
+    return result_;
+  }
+
+ private:
+  ChildProcess &process_;
+  std::shared_ptr<io::BaseStream> output_;
+  uint64_t size_;
+  bool keep_running_;
+  uint64_t timeout_ms_;
+  ChildProcess::Result result_;
+};
+
+/**
+ * Writes the output of the process to the content of the new FlowFile, reading the content of the
+ * incoming FlowFile at the same time.
+ */
+class OutputCallback : public OutputStreamCallback {
+ public:
+  OutputCallback(core::ProcessSession *session, const std::shared_ptr<core::FlowFile> &flow_file, ChildProcess &process, bool pipe_input, bool keep_running, uint64_t timeout_ms)
+      : session_(session),
+        flow_file_(flow_file),
+        process_(process),
+        pipe_input_(pipe_input),
+        keep_running_(keep_running),
+        timeout_ms_(timeout_ms),
+        result_(ChildProcess::Result::FAILED) {
+  }
+
+  int64_t process(std::shared_ptr<io::BaseStream> stream) {
+    if (pipe_input_ && flow_file_->getSize() > 0) {
+      InputCallback callback(process_, stream, flow_file_->getSize(), keep_running_, timeout_ms_);
+      session_->read(flow_file_, &callback);
+      result_ = callback.getResult();
+    } else {
+      result_ = process_.transfer(nullptr, 0, !keep_running_, stream, timeout_ms_, keep_running_);
+    }
+    return result_ == ChildProcess::Result::FAILED ? -1 : static_cast<int64_t>(process_.getTransferredSize());
+  }
+
+  ChildProcess::Result getResult() const {
+    return result_;
+  }
+
+ private:
+  core::ProcessSession *session_;
+  std::shared_ptr<core::FlowFile> flow_file_;
+  ChildProcess &process_;
+  bool pipe_input_;
+  bool keep_running_;
+  uint64_t timeout_ms_;
+  ChildProcess::Result result_;
+};
+
+}  // namespace
+
+void ExecuteStreamCommand::initialize() {
+  std::set<core::Property> properties;
+  properties.insert(CommandPath);
+  properties.insert(CommandArguments);
+  properties.insert(ArgumentDelimiter);
+  properties.insert(WorkingDir);
+  properties.insert(IgnoreStdin);
+  properties.insert(KeepProcessRunning);
+  properties.insert(ResponseTimeout);
+  setSupportedProperties(properties);
+  std::set<core::Relationship> relationships;
+  relationships.insert(OutputStream);
+  relationships.insert(Original);
+  relationships.insert(NonzeroStatus);
+  setSupportedRelationships(relationships);
+}
+
+void ExecuteStreamCommand::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
+  if (!context->getProperty(ArgumentDelimiter.getName(), delimiter_)) {
+    delimiter_ = ";";
+  }
+  context->getProperty(IgnoreStdin.getName(), ignore_stdin_);
+  context->getProperty(KeepProcessRunning.getName(), keep_running_);
+  if (!context->getProperty(ResponseTimeout.getName(), timeout_ms_)) {
+    timeout_ms_ = 30000;
+  }
+  if (keep_running_) {
+    arguments_ = getArguments(context, nullptr);
+    context->getProperty(WorkingDir, working_dir_, nullptr);
+    if (timeout_ms_ == 0) {
+      // a process that stopped answering would block its task forever
+      logger_->log_warn("A Response Timeout is required to keep processes running, using 30 sec");
+      timeout_ms_ = 30000;
+    }
+  }
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  idle_processes_.clear();
+}
+
+void ExecuteStreamCommand::notifyStop() {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  idle_processes_.clear();
+}
+
+std::vector<std::string> ExecuteStreamCommand::getArguments(core::ProcessContext *context, const std::shared_ptr<core::FlowFile> &flow_file) {
+  std::string command;
+  std::string arguments;
+  context->getProperty(CommandPath, command, flow_file);
+  context->getProperty(CommandArguments, arguments, flow_file);
+  std::vector<std::string> result;
+  command = utils::StringUtils::trim(command);
+  if (command.empty()) {
+    return result;
+  }
+  result.push_back(command);
+  for (const auto &argument : delimiter_.empty() ? ChildProcess::splitArguments(arguments) : utils::StringUtils::split(arguments, delimiter_)) {
+    result.push_back(argument);
+  }
+  return result;
+}
+
+std::unique_ptr<ChildProcess> ExecuteStreamCommand::acquireProcess(const std::vector<std::string> &arguments, const std::string &working_dir, std::string &error) {
+  if (keep_running_) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    while (!idle_processes_.empty()) {
+      std::unique_ptr<ChildProcess> process = std::move(idle_processes_.back());
+      idle_processes_.pop_back();
+      if (process->isRunning()) {
+        return process;
+      }
+      logger_->log_warn("Command %s exited while idle with status %d: %s", arguments[0], process->wait(), process->getError());
+    }
+  }
+  std::unique_ptr<ChildProcess> process(new ChildProcess());
+  if (!process->start(arguments, working_dir, !ignore_stdin_, false)) {
+    error = process->getError();
+    return nullptr;
+  }
+  return process;
+}
+
+void ExecuteStreamCommand::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
+  auto flow_file = session->get();
+  if (!flow_file) {
+    return;
+  }
+
+  std::vector<std::string> arguments;
+  std::string working_dir;
+  if (keep_running_) {
+    arguments = arguments_;
+    working_dir = working_dir_;
+  } else {
+    arguments = getArguments(context, flow_file);
+    context->getProperty(WorkingDir, working_dir, flow_file);
+  }
+  if (arguments.empty()) {
+    logger_->log_error("No command to run for %s", flow_file->getUUIDStr());
+    session->transfer(flow_file, NonzeroStatus);
+    return;
+  }
+
+  std::string error;
+  std::unique_ptr<ChildProcess> process = acquireProcess(arguments, working_dir, error);
+  auto output = session->create(flow_file);
+  ChildProcess::Result result = ChildProcess::Result::FAILED;
+  if (process) {
+    process->clearError();
+    OutputCallback callback(session, flow_file, *process, !ignore_stdin_, keep_running_, timeout_ms_);
+    session->write(output, &callback);
+    result = callback.getResult();
+    if (result == ChildProcess::Result::FAILED) {
+      // the session was rolled back
+      logger_->log_error("Could not stream %s through %s", flow_file->getUUIDStr(), arguments[0]);
+      return;
+    }
+    error = process->getError();
+  } else {
+    logger_->log_error("Could not run %s for %s: %s", arguments[0], flow_file->getUUIDStr(), error);
+  }
+
+  int status = -1;
+  switch (result) {
+    case ChildProcess::Result::LINES_READ: {
+      status = 0;
+      std::lock_guard<std::mutex> lock(pool_mutex_);
+      idle_processes_.push_back(std::move(process));
+      break;
+    }
+    case ChildProcess::Result::OUTPUT_CLOSED:
+      status = process->wait();
+      if (keep_running_) {
+        error = "the command exited before it answered every line: " + error;
+        status = -1;
+      }
+      break;
+    case ChildProcess::Result::TIMED_OUT:
+      process->terminate();
+      error = "the command timed out: " + error;
+      break;
+    default:
+      break;
+  }
+
+  std::string joined_arguments;
+  for (size_t i = 1; i < arguments.size(); i++) {
+    joined_arguments += (i > 1 ? (delimiter_.empty() ? " " : delimiter_) : "") + arguments[i];
+  }
+  for (const auto &flow : { flow_file, output }) {
+    session->putAttribute(flow, "execution.command", arguments[0]);
+    session->putAttribute(flow, "execution.command.args", joined_arguments);
+    session->putAttribute(flow, "execution.status", std::to_string(status));
+    session->putAttribute(flow, "execution.error", error);
+  }
+  logger_->log_debug("Command %s exited with status %d for %s", arguments[0], status, flow_file->getUUIDStr());
+  session->transfer(output, status == 0 ? OutputStream : NonzeroStatus);
+  session->transfer(flow_file, Original);
+}
+
+} /* namespace processors */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+#endif
@@ -0,0 +1,115 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_EXECUTESTREAMCOMMAND_H_
+#define EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_EXECUTESTREAMCOMMAND_H_
+
+#ifndef WIN32
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ChildProcess.h"
+#include "core/Processor.h"
+#include "core/ProcessSession.h"
+#include "core/Resource.h"
+#include "core/logging/LoggerConfiguration.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+/**
+ * Purpose: Runs a command for every FlowFile, with the content as its standard input and its
+ * standard output as the content of a new FlowFile.
+ *
+ * Design: Input and output stream between the content repository and the pipes of the process,
+ * so neither is held in memory. Starting a process per FlowFile costs more than processing small
+ * FlowFiles; with Keep Process Running the processes stay up and answer one line of output per
+ * line of input, and idle processes wait in a pool for the next trigger.
+ */
+class ExecuteStreamCommand : public core::Processor {
+ public:
+
+  explicit ExecuteStreamCommand(std::string name, utils::Identifier uuid = utils::Identifier())
+      : core::Processor(name, uuid),
+        ignore_stdin_(false),
+        keep_running_(false),
+        timeout_ms_(0),
+        logger_(logging::LoggerFactory<ExecuteStreamCommand>::getLogger()) {
+  }
+
+  virtual ~ExecuteStreamCommand() {
+  }
+
+  /**
+   * Properties
+   */
+
+  static core::Property CommandPath;
+  static core::Property CommandArguments;
+  static core::Property ArgumentDelimiter;
+  static core::Property WorkingDir;
+  static core::Property IgnoreStdin;
+  static core::Property KeepProcessRunning;
+  static core::Property ResponseTimeout;
+
+  /**
+   * Relationships
+   */
+
+  static core::Relationship OutputStream;
+  static core::Relationship Original;
+  static core::Relationship NonzeroStatus;
+
+  virtual void onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory);
+  virtual void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
+  virtual void initialize(void);
+  // Terminates the idle processes
+  virtual void notifyStop();
+
+ private:
+  std::vector<std::string> getArguments(core::ProcessContext *context, const std::shared_ptr<core::FlowFile> &flow_file);
+
+  // takes an idle process or starts one, returns nullptr with the error if it could not be started
+  std::unique_ptr<ChildProcess> acquireProcess(const std::vector<std::string> &arguments, const std::string &working_dir, std::string &error);
+
+  std::string delimiter_;
+  bool ignore_stdin_;
+  bool keep_running_;
+  uint64_t timeout_ms_;
+  // evaluated once when processes are kept running
+  std::vector<std::string> arguments_;
+  std::string working_dir_;
+  std::mutex pool_mutex_;
+  std::vector<std::unique_ptr<ChildProcess>> idle_processes_;
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+REGISTER_RESOURCE(ExecuteStreamCommand, "Runs an operating system command for every FlowFile, writing the content of the FlowFile to its standard input "
+                  "and its standard output to a new FlowFile. The command may be kept running for line-oriented commands.");
+
+} /* namespace processors */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif
+#endif /* EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_EXECUTESTREAMCOMMAND_H_ */
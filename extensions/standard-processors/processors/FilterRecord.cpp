@@ -0,0 +1,216 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FilterRecord.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <string>
+#include "utils/StringUtils.h"
+#include "RecordCallbacks.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+namespace {
+
+bool toNumber(const controllers::RecordField &field, double &number) {
+  // values are not null terminated
+  char buffer[64];
+  if (field.size == 0 || field.size >= sizeof(buffer)) {
+    return false;
+  }
+  std::memcpy(buffer, field.data, field.size);
+  buffer[field.size] = '\0';
+  char *end = nullptr;
+  number = std::strtod(buffer, &end);
+  return end == buffer + field.size;
+}
+
+}  // namespace
+
+const char *FilterRecord::EQUALS = "equals";
+const char *FilterRecord::NOT_EQUALS = "not equals";
+const char *FilterRecord::CONTAINS = "contains";
+const char *FilterRecord::MATCHES = "matches";
+const char *FilterRecord::LESS_THAN = "less than";
+const char *FilterRecord::GREATER_THAN = "greater than";
+
+core::Property FilterRecord::RecordReader(
+    core::PropertyBuilder::createProperty("Record Reader")->withDescription("The controller service reading the records of incoming FlowFiles")->isRequired(true)
+        ->asType<controllers::RecordReaderFactory>()->build());
+
+core::Property FilterRecord::RecordWriter(
+    core::PropertyBuilder::createProperty("Record Writer")->withDescription("The controller service writing the records of outgoing FlowFiles")->isRequired(true)
+        ->asType<controllers::RecordSetWriterFactory>()->build());
+
+core::Property FilterRecord::FieldName(
+    core::PropertyBuilder::createProperty("Field Name")->withDescription("The field of the records the condition is evaluated on")->isRequired(true)->build());
+
+core::Property FilterRecord::Operator(
+    core::PropertyBuilder::createProperty("Operator")->withDescription("How the field is compared to the value. matches requires the whole field to match the value as a regular expression; "
+                                                                       "less than and greater than compare numbers and never match fields that are not numbers.")
+        ->isRequired(true)->withAllowableValue<std::string>(EQUALS)->withAllowableValue(NOT_EQUALS)->withAllowableValue(CONTAINS)->withAllowableValue(MATCHES)->withAllowableValue(LESS_THAN)
+        ->withAllowableValue(GREATER_THAN)->withDefaultValue(EQUALS)->build());
+
+core::Property FilterRecord::Value(
+    core::PropertyBuilder::createProperty("Value")->withDescription("The value the field is compared to")->isRequired(false)->build());
+
+core::Property FilterRecord::IncludeZeroRecordFlowFiles(
+    core::PropertyBuilder::createProperty("Include Zero Record FlowFiles")->withDescription("Whether a FlowFile is routed to success when none of its records satisfy the condition")
+        ->isRequired(true)->withDefaultValue<bool>(true)->build());
+
+core::Relationship FilterRecord::Success("success", "FlowFiles holding the records that satisfy the condition");
+core::Relationship FilterRecord::Original("original", "The FlowFiles the records were read from");
+core::Relationship FilterRecord::Failure("failure", "FlowFiles whose records could not be read or written");
+
+void FilterRecord::initialize() {
+  std::set<core::Property> properties;
+  properties.insert(RecordReader);
+  properties.insert(RecordWriter);
+  properties.insert(FieldName);
+  properties.insert(Operator);
+  properties.insert(Value);
+  properties.insert(IncludeZeroRecordFlowFiles);
+  setSupportedProperties(properties);
+  std::set<core::Relationship> relationships;
+  relationships.insert(Success);
+  relationships.insert(Original);
+  relationships.insert(Failure);
+  setSupportedRelationships(relationships);
+}
+
+void FilterRecord::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
+  reader_factory_ = getRecordService<controllers::RecordReaderFactory>(context, RecordReader);
+  writer_factory_ = getRecordService<controllers::RecordSetWriterFactory>(context, RecordWriter);
+  if (!context->getProperty(FieldName.getName(), field_name_) || field_name_.empty()) {
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, "Field Name must be set");
+  }
+  value_.clear();
+  context->getProperty(Value.getName(), value_);
+
+  std::string value;
+  context->getProperty(Operator.getName(), value);
+  if (value == NOT_EQUALS) {
+    comparison_ = Comparison::NOT_EQUALS;
+  } else if (value == CONTAINS) {
+    comparison_ = Comparison::CONTAINS;
+  } else if (value == MATCHES) {
+    comparison_ = Comparison::MATCHES;
+    try {
+      regex_ = std::regex(value_);
+    } catch (const std::regex_error &e) {
+      throw Exception(PROCESS_SCHEDULE_EXCEPTION, "Invalid regular expression " + value_ + ": " + e.what());
+    }
+  } else if (value == LESS_THAN || value == GREATER_THAN) {
+    comparison_ = value == LESS_THAN ? Comparison::LESS_THAN : Comparison::GREATER_THAN;
+    controllers::RecordField number { value_.data(), value_.size(), controllers::RecordFieldType::STRING };
+    if (!toNumber(number, number_)) {
+      throw Exception(PROCESS_SCHEDULE_EXCEPTION, "Value must be a number to compare with " + value);
+    }
+  } else {
+    comparison_ = Comparison::EQUALS;
+  }
+
+  include_empty_ = true;
+  if (context->getProperty(IncludeZeroRecordFlowFiles.getName(), value)) {
+    utils::StringUtils::StringToBool(value, include_empty_);
+  }
+}
+
+bool FilterRecord::matches(const controllers::Record &record) const {
+  const controllers::RecordField *field = record.getField(field_name_);
+  if (field == nullptr || field->type == controllers::RecordFieldType::NULL_VALUE) {
+    return comparison_ == Comparison::NOT_EQUALS;
+  }
+  switch (comparison_) {
+    case Comparison::EQUALS:
+      return field->size == value_.size() && std::memcmp(field->data, value_.data(), field->size) == 0;
+    case Comparison::NOT_EQUALS:
+      return field->size != value_.size() || std::memcmp(field->data, value_.data(), field->size) != 0;
+    case Comparison::CONTAINS:
+      return value_.empty() || std::search(field->data, field->data + field->size, value_.begin(), value_.end()) != field->data + field->size;
+    case Comparison::MATCHES:
+      return std::regex_match(field->data, field->data + field->size, regex_);
+    case Comparison::LESS_THAN:
+    case Comparison::GREATER_THAN: {
+      double number;
+      if (!toNumber(*field, number)) {
+        return false;
+      }
+      return comparison_ == Comparison::LESS_THAN ? number < number_ : number > number_;
+    }
+  }
+  return false;
+}
+
+void FilterRecord::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
+  auto flow_file = session->get();
+  if (!flow_file) {
+    return;
+  }
+
+  std::string error;
+  RecordWriteCallback write_callback(writer_factory_, [&](controllers::RecordSetWriter &writer) {
+    bool written = true;
+    RecordReadCallback read_callback(reader_factory_, flow_file->getSize(), [&](controllers::RecordReader &reader) {
+      controllers::Record record;
+      while (written && reader.read(record)) {
+        if (matches(record)) {
+          written = writer.write(record);
+        }
+      }
+    });
+    session->read(flow_file, &read_callback);
+    error = read_callback.getError();
+    return written && error.empty();
+  });
+  auto filtered = session->create(flow_file);
+  session->write(filtered, &write_callback);
+
+  if (!write_callback.isSuccess()) {
+    if (error.empty()) {
+      error = "the records could not be written";
+    }
+    logger_->log_error("Failed to filter the records of %s: %s", flow_file->getUUIDStr(), error);
+    session->remove(filtered);
+    session->transfer(flow_file, Failure);
+    return;
+  }
+  logger_->log_debug("%llu records of %s satisfy the condition", write_callback.getRecordCount(), flow_file->getUUIDStr());
+  if (write_callback.getRecordCount() == 0 && !include_empty_) {
+    session->remove(filtered);
+  } else {
+    session->putAttribute(filtered, "record.count", std::to_string(write_callback.getRecordCount()));
+    session->putAttribute(filtered, FlowAttributeKey(MIME_TYPE), writer_factory_->getMimeType());
+    session->transfer(filtered, Success);
+  }
+  session->transfer(flow_file, Original);
+}
+
+} /* namespace processors */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
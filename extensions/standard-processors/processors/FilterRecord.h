@@ -0,0 +1,115 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_FILTERRECORD_H_
+#define EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_FILTERRECORD_H_
+
+#include <memory>
+#include <regex>
+#include <string>
+#include "core/Processor.h"
+#include "core/ProcessSession.h"
+#include "core/Resource.h"
+#include "core/logging/LoggerConfiguration.h"
+#include "../controllers/RecordSet.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+/**
+ * Keeps the records of a FlowFile that satisfy a condition on one of their fields. It covers the
+ * filtering part of QueryRecord without a query language.
+ */
+class FilterRecord : public core::Processor {
+ public:
+
+  explicit FilterRecord(std::string name, utils::Identifier uuid = utils::Identifier())
+      : core::Processor(name, uuid),
+        logger_(logging::LoggerFactory<FilterRecord>::getLogger()),
+        comparison_(Comparison::EQUALS),
+        number_(0),
+        include_empty_(true) {
+  }
+
+  static const char *EQUALS;
+  static const char *NOT_EQUALS;
+  static const char *CONTAINS;
+  static const char *MATCHES;
+  static const char *LESS_THAN;
+  static const char *GREATER_THAN;
+
+  /**
+   * Properties
+   */
+
+  static core::Property RecordReader;
+  static core::Property RecordWriter;
+  static core::Property FieldName;
+  static core::Property Operator;
+  static core::Property Value;
+  static core::Property IncludeZeroRecordFlowFiles;
+
+  /**
+   * Relationships
+   */
+
+  static core::Relationship Success;
+  static core::Relationship Original;
+  static core::Relationship Failure;
+
+  virtual void onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory);
+  virtual void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
+  virtual void initialize(void);
+
+  /**
+   * @return whether the record satisfies the condition. Missing and null fields only satisfy not equals.
+   */
+  bool matches(const controllers::Record &record) const;
+
+ private:
+  enum class Comparison {
+    EQUALS,
+    NOT_EQUALS,
+    CONTAINS,
+    MATCHES,
+    LESS_THAN,
+    GREATER_THAN
+  };
+
+  std::shared_ptr<logging::Logger> logger_;
+  std::shared_ptr<controllers::RecordReaderFactory> reader_factory_;
+  std::shared_ptr<controllers::RecordSetWriterFactory> writer_factory_;
+  std::string field_name_;
+  Comparison comparison_;
+  std::string value_;
+  std::regex regex_;
+  double number_;
+  bool include_empty_;
+};
+
+REGISTER_RESOURCE(FilterRecord, "Writes the records of a FlowFile that satisfy a condition on one of their fields to a new FlowFile.");
+
+} /* namespace processors */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_FILTERRECORD_H_ */
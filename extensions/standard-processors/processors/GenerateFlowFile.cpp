@@ -77,26 +77,21 @@ void GenerateFlowFile::initialize() {
   setSupportedRelationships(relationships);
 }
 
-void GenerateFlowFile::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
-  uint64_t batchSize = 1;
-  bool uniqueFlowFile = true;
-  uint64_t fileSize = 1024;
-  bool textData = false;
-
-  std::string value;
-  if (context->getProperty(FileSize.getName(), fileSize)) {
-    logger_->log_trace("File size is configured to be %d", fileSize);
-  }
+void GenerateFlowFile::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
+  core::PropertySnapshot::Builder builder(*context);
+  file_size_ = builder.bind<uint64_t>(FileSize, 1024);
+  batch_size_ = builder.bind<uint64_t>(BatchSize, 1);
+  data_format_ = builder.bind<std::string>(DataFormat, DATA_FORMAT_BINARY);
+  unique_flow_files_ = builder.bind<bool>(UniqueFlowFiles, true);
+  properties_ = builder.build();
+  logger_->log_trace("File size is configured to be %d, batch size to be %d", properties_->get(file_size_), properties_->get(batch_size_));
+}
 
-  if (context->getProperty(BatchSize.getName(), batchSize)) {
-    logger_->log_trace("Batch size is configured to be %d", batchSize);
-  }
-  if (context->getProperty(DataFormat.getName(), value)) {
-    textData = (value == GenerateFlowFile::DATA_FORMAT_TEXT);
-  }
-  if (context->getProperty(UniqueFlowFiles.getName(), uniqueFlowFile)) {
-    logger_->log_trace("Unique Flow files is configured to be %i", uniqueFlowFile);
-  }
+void GenerateFlowFile::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
+  const uint64_t batchSize = properties_->get(batch_size_);
+  const bool uniqueFlowFile = properties_->get(unique_flow_files_);
+  const uint64_t fileSize = properties_->get(file_size_);
+  const bool textData = properties_->get(data_format_) == GenerateFlowFile::DATA_FORMAT_TEXT;
 
   if (uniqueFlowFile) {
     char *data;
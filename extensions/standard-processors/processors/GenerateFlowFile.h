@@ -23,6 +23,7 @@
 #include "FlowFileRecord.h"
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
+#include "core/PropertySnapshot.h"
 #include "core/Core.h"
 #include "core/Resource.h"
 
@@ -77,6 +78,8 @@ class GenerateFlowFile : public core::Processor {
   };
 
  public:
+  // OnSchedule method, implemented by NiFi GenerateFlowFile
+  virtual void onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory);
   // OnTrigger method, implemented by NiFi GenerateFlowFile
   virtual void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
   // Initialize, over write by NiFi GenerateFlowFile
@@ -89,6 +92,12 @@ class GenerateFlowFile : public core::Processor {
   char * _data;
   // Size of the generated data
   uint64_t _dataSize;
+  // properties bound at onSchedule
+  std::shared_ptr<const core::PropertySnapshot> properties_;
+  core::PropertyHandle<uint64_t> file_size_;
+  core::PropertyHandle<uint64_t> batch_size_;
+  core::PropertyHandle<std::string> data_format_;
+  core::PropertyHandle<bool> unique_flow_files_;
   // logger instance
   std::shared_ptr<logging::Logger> logger_;
 };
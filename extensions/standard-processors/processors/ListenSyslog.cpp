@@ -187,7 +187,7 @@ void ListenSyslog::runThread() {
         struct sockaddr_in cli_addr;
         clilen = sizeof(cli_addr);
         int recvlen = recvfrom(_serverSocket, _buffer, sizeof(_buffer), 0, (struct sockaddr *) &cli_addr, &clilen);
-        if (recvlen > 0 && (uint64_t) (recvlen + getEventQueueByteSize()) <= _recvBufSize) {
+        if (recvlen > 0 && (uint64_t) (recvlen + getEventQueueByteSize()) <= (uint64_t) _recvBufSize && core::MemoryGovernor::getInstance().tryReserve(recvlen)) {
           uint8_t *payload = new uint8_t[recvlen];
           memcpy(payload, _buffer, recvlen);
           putEvent(payload, recvlen);
@@ -204,7 +204,7 @@ void ListenSyslog::runThread() {
           logger_->log_debug("ListenSysLog client socket %d close", clientSocket);
           it = _clientSockets.erase(it);
         } else {
-          if ((uint64_t) (recvlen + getEventQueueByteSize()) <= _recvBufSize) {
+          if ((uint64_t) (recvlen + getEventQueueByteSize()) <= (uint64_t) _recvBufSize && core::MemoryGovernor::getInstance().tryReserve(recvlen)) {
             uint8_t *payload = new uint8_t[recvlen];
             memcpy(payload, _buffer, recvlen);
             putEvent(payload, recvlen);
@@ -248,42 +248,33 @@ int ListenSyslog::readline(int fd, char *bufptr, size_t len) {
   return -1;
 }
 
-void ListenSyslog::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
-  std::string value;
-  bool needResetServerSocket = false;
-  if (context->getProperty(Protocol.getName(), value)) {
-    if (_protocol != value)
-      needResetServerSocket = true;
-    _protocol = value;
-  }
-  if (context->getProperty(RecvBufSize.getName(), value)) {
-    core::Property::StringToInt(value, _recvBufSize);
-  }
-  if (context->getProperty(MaxSocketBufSize.getName(), value)) {
-    core::Property::StringToInt(value, _maxSocketBufSize);
-  }
-  if (context->getProperty(MaxConnections.getName(), value)) {
-    core::Property::StringToInt(value, _maxConnections);
-  }
-  if (context->getProperty(MessageDelimiter.getName(), value)) {
-    _messageDelimiter = value;
-  }
-  if (context->getProperty(ParseMessages.getName(), value)) {
-    org::apache::nifi::minifi::utils::StringUtils::StringToBool(value, _parseMessages);
-  }
-  if (context->getProperty(Port.getName(), value)) {
-    int64_t oldPort = _port;
-    core::Property::StringToInt(value, _port);
-    if (_port != oldPort)
-      needResetServerSocket = true;
-  }
-  if (context->getProperty(MaxBatchSize.getName(), value)) {
-    core::Property::StringToInt(value, _maxBatchSize);
-  }
+void ListenSyslog::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
+  core::PropertySnapshot::Builder builder(*context);
+  recv_buf_size_ = builder.bind<int64_t>(RecvBufSize, 65507);
+  max_socket_buf_size_ = builder.bind<int64_t>(MaxSocketBufSize, 1024 * 1024);
+  max_connections_ = builder.bind<int64_t>(MaxConnections, 2);
+  max_batch_size_ = builder.bind<int64_t>(MaxBatchSize, 1);
+  message_delimiter_ = builder.bind<std::string>(MessageDelimiter, "\n");
+  parse_messages_ = builder.bind<bool>(ParseMessages, false);
+  protocol_ = builder.bind<std::string>(Protocol, "UDP");
+  port_ = builder.bind<int64_t>(Port, 514);
+  properties_ = builder.build();
+
+  bool needResetServerSocket = _protocol != properties_->get(protocol_) || _port != properties_->get(port_);
+  _protocol = properties_->get(protocol_);
+  _recvBufSize = properties_->get(recv_buf_size_);
+  _maxSocketBufSize = properties_->get(max_socket_buf_size_);
+  _maxConnections = properties_->get(max_connections_);
+  _messageDelimiter = properties_->get(message_delimiter_);
+  _parseMessages = properties_->get(parse_messages_);
+  _port = properties_->get(port_);
+  _maxBatchSize = properties_->get(max_batch_size_);
 
   if (needResetServerSocket)
     _resetServerSocket = true;
+}
 
+void ListenSyslog::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
   startSocketThread();
 
   // read from the event queue
@@ -293,7 +284,7 @@ void ListenSyslog::onTrigger(core::ProcessContext *context, core::ProcessSession
   }
 
   std::queue<SysLogEvent> eventQueue;
-  pollEvent(eventQueue, _maxBatchSize);
+  pollEvent(eventQueue, properties_->get(max_batch_size_));
   bool firstEvent = true;
   std::shared_ptr<FlowFileRecord> flowFile = NULL;
   while (!eventQueue.empty()) {
@@ -306,15 +297,17 @@ void ListenSyslog::onTrigger(core::ProcessContext *context, core::ProcessSession
       ListenSyslog::WriteCallback callback(event.payload, event.len);
       session->write(flowFile, &callback);
       delete[] event.payload;
+      core::MemoryGovernor::getInstance().release(event.len);
       firstEvent = false;
     } else {
       ListenSyslog::WriteCallback callback(event.payload, event.len);
       session->append(flowFile, &callback);
       delete[] event.payload;
+      core::MemoryGovernor::getInstance().release(event.len);
     }
   }
-  flowFile->addAttribute("syslog.protocol", _protocol);
-  flowFile->addAttribute("syslog.port", std::to_string(_port));
+  flowFile->addAttribute("syslog.protocol", properties_->get(protocol_));
+  flowFile->addAttribute("syslog.port", std::to_string(properties_->get(port_)));
   session->transfer(flowFile, Success);
 }
 #endif
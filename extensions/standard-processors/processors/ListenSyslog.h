@@ -38,7 +38,9 @@
 #include "FlowFileRecord.h"
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
+#include "core/PropertySnapshot.h"
 #include "core/Core.h"
+#include "core/MemoryGovernor.h"
 #include "core/Resource.h"
 #include "core/logging/LoggerConfiguration.h"
 
@@ -96,6 +98,11 @@ class ListenSyslog : public core::Processor {
       close(clientSocket);
     }
     _clientSockets.clear();
+    while (!_eventQueue.empty()) {
+      delete[] _eventQueue.front().payload;
+      core::MemoryGovernor::getInstance().release(_eventQueue.front().len);
+      _eventQueue.pop();
+    }
     if (_serverSocket > 0) {
       logger_->log_debug("ListenSysLog Server socket %d close", _serverSocket);
       close(_serverSocket);
@@ -134,6 +141,8 @@ class ListenSyslog : public core::Processor {
   };
 
  public:
+  // OnSchedule method, implemented by NiFi ListenSyslog
+  virtual void onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory);
   // OnTrigger method, implemented by NiFi ListenSyslog
   virtual void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
   // Initialize, over write by NiFi ListenSyslog
@@ -144,6 +153,16 @@ class ListenSyslog : public core::Processor {
  private:
   // Logger
   std::shared_ptr<logging::Logger> logger_;
+  // properties bound at onSchedule
+  std::shared_ptr<const core::PropertySnapshot> properties_;
+  core::PropertyHandle<int64_t> recv_buf_size_;
+  core::PropertyHandle<int64_t> max_socket_buf_size_;
+  core::PropertyHandle<int64_t> max_connections_;
+  core::PropertyHandle<int64_t> max_batch_size_;
+  core::PropertyHandle<std::string> message_delimiter_;
+  core::PropertyHandle<bool> parse_messages_;
+  core::PropertyHandle<std::string> protocol_;
+  core::PropertyHandle<int64_t> port_;
   // Run function for the thread
   static void run(ListenSyslog *process);
   // Run Thread
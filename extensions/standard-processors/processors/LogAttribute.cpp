@@ -98,20 +98,29 @@ void LogAttribute::onSchedule(const std::shared_ptr<core::ProcessContext> &conte
     flowfiles_to_log_ = flowsToLog.getValue();
   }
 
-  std::string value;
-  if (context->getProperty(HexencodePayload.getName(), value)) {
-    utils::StringUtils::StringToBool(value, hexencode_);
-  }
-  if (context->getProperty(MaxPayloadLineLength.getName(), value)) {
-    core::Property::StringToInt(value, max_line_length_);
-  }
+  core::PropertySnapshot::Builder builder(*context);
+  auto hexencode = builder.bind<bool>(HexencodePayload, false);
+  auto max_line_length = builder.bind<uint64_t>(MaxPayloadLineLength, 80);
+  log_level_ = builder.bind<std::string>(LogLevel);
+  log_prefix_ = builder.bind<std::string>(LogPrefix);
+  log_payload_ = builder.bind<bool>(LogPayload, false);
+  properties_ = builder.build();
+
+  hexencode_ = properties_->get(hexencode);
+  max_line_length_ = static_cast<uint32_t>(properties_->get(max_line_length));
 }
 // OnTrigger method, implemented by NiFi LogAttribute
 void LogAttribute::onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
   logger_->log_trace("enter log attribute, attempting to retrieve %u flow files", flowfiles_to_log_);
   std::string dashLine = "--------------------------------------------------";
   LogAttrLevel level = LogAttrLevelInfo;
-  bool logPayload = false;
+  if (properties_->isSet(log_level_)) {
+    logLevelStringToEnum(properties_->get(log_level_), level);
+  }
+  if (properties_->isSet(log_prefix_)) {
+    dashLine = "-----" + properties_->get(log_prefix_) + "-----";
+  }
+  const bool logPayload = properties_->get(log_payload_);
 
   uint64_t i = 0;
   const auto max = flowfiles_to_log_ == 0 ? UINT64_MAX : flowfiles_to_log_;
@@ -122,16 +131,6 @@ void LogAttribute::onTrigger(const std::shared_ptr<core::ProcessContext> &contex
       break;
     }
 
-    std::string value;
-    if (context->getProperty(LogLevel.getName(), value)) {
-      logLevelStringToEnum(value, level);
-    }
-    if (context->getProperty(LogPrefix.getName(), value)) {
-      dashLine = "-----" + value + "-----";
-    }
-
-    context->getProperty(LogPayload.getName(), logPayload);
-
     std::ostringstream message;
     message << "Logging for flow file " << "\n";
     message << dashLine;
@@ -23,6 +23,7 @@
 #include "FlowFileRecord.h"
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
+#include "core/PropertySnapshot.h"
 #include "core/Core.h"
 #include "core/Resource.h"
 #include "core/logging/LoggerConfiguration.h"
@@ -125,6 +126,11 @@ class LogAttribute : public core::Processor {
   uint64_t flowfiles_to_log_;
   bool hexencode_;
   uint32_t max_line_length_;
+  // properties bound at onSchedule
+  std::shared_ptr<const core::PropertySnapshot> properties_;
+  core::PropertyHandle<std::string> log_level_;
+  core::PropertyHandle<std::string> log_prefix_;
+  core::PropertyHandle<bool> log_payload_;
   // Logger
   std::shared_ptr<logging::Logger> logger_;
 };
@@ -0,0 +1,154 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MergeRecord.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "RecordCallbacks.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+core::Property MergeRecord::RecordReader(
+    core::PropertyBuilder::createProperty("Record Reader")->withDescription("The controller service reading the records of incoming FlowFiles")->isRequired(true)
+        ->asType<controllers::RecordReaderFactory>()->build());
+
+core::Property MergeRecord::RecordWriter(
+    core::PropertyBuilder::createProperty("Record Writer")->withDescription("The controller service writing the records of outgoing FlowFiles")->isRequired(true)
+        ->asType<controllers::RecordSetWriterFactory>()->build());
+
+core::Property MergeRecord::TargetNumberOfRecords(
+    core::PropertyBuilder::createProperty("Target Number of Records")->withDescription("A merged FlowFile takes no further FlowFiles once it holds this many records. "
+                                                                                       "FlowFiles are not split, so a merged FlowFile may hold more.")
+        ->isRequired(true)->withDefaultValue<uint64_t>(1000)->build());
+
+core::Property MergeRecord::MaxFlowFiles(
+    core::PropertyBuilder::createProperty("Maximum Number of FlowFiles")->withDescription("The maximum number of queued FlowFiles merged in each invocation")->isRequired(true)
+        ->withDefaultValue<uint64_t>(1000)->build());
+
+core::Relationship MergeRecord::Merged("merged", "The FlowFiles holding the merged records");
+core::Relationship MergeRecord::Original("original", "The FlowFiles whose records were merged");
+core::Relationship MergeRecord::Failure("failure", "FlowFiles whose records could not be read or written");
+
+void MergeRecord::initialize() {
+  std::set<core::Property> properties;
+  properties.insert(RecordReader);
+  properties.insert(RecordWriter);
+  properties.insert(TargetNumberOfRecords);
+  properties.insert(MaxFlowFiles);
+  setSupportedProperties(properties);
+  std::set<core::Relationship> relationships;
+  relationships.insert(Merged);
+  relationships.insert(Original);
+  relationships.insert(Failure);
+  setSupportedRelationships(relationships);
+}
+
+void MergeRecord::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
+  reader_factory_ = getRecordService<controllers::RecordReaderFactory>(context, RecordReader);
+  writer_factory_ = getRecordService<controllers::RecordSetWriterFactory>(context, RecordWriter);
+  if (!context->getProperty(TargetNumberOfRecords.getName(), target_records_) || target_records_ == 0) {
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, "Target Number of Records must be a positive number");
+  }
+  if (!context->getProperty(MaxFlowFiles.getName(), max_flow_files_) || max_flow_files_ == 0) {
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, "Maximum Number of FlowFiles must be a positive number");
+  }
+}
+
+void MergeRecord::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
+  std::vector<std::shared_ptr<core::FlowFile>> inputs;
+  while (inputs.size() < max_flow_files_) {
+    auto flow_file = session->get();
+    if (!flow_file) {
+      break;
+    }
+    inputs.push_back(flow_file);
+  }
+  if (inputs.empty()) {
+    return;
+  }
+
+  const std::string mime_type = writer_factory_->getMimeType();
+  size_t begin = 0;
+  while (begin < inputs.size()) {
+    // the FlowFiles from begin to end are merged
+    size_t end = begin;
+    bool read = true;
+    RecordWriteCallback write_callback(writer_factory_, [&](controllers::RecordSetWriter &writer) {
+      while (end < inputs.size() && writer.getRecordCount() < target_records_) {
+        bool written = true;
+        RecordReadCallback read_callback(reader_factory_, inputs[end]->getSize(), [&](controllers::RecordReader &reader) {
+          controllers::Record record;
+          while (written && reader.read(record)) {
+            written = writer.write(record);
+          }
+        });
+        session->read(inputs[end], &read_callback);
+        if (!read_callback.getError().empty()) {
+          logger_->log_error("Failed to read the records of %s: %s", inputs[end]->getUUIDStr(), read_callback.getError());
+          read = false;
+          return false;
+        }
+        end++;
+        if (!written) {
+          return false;
+        }
+      }
+      return true;
+    });
+    auto merged = session->create();
+    session->write(merged, &write_callback);
+
+    if (!write_callback.isSuccess()) {
+      session->remove(merged);
+      if (!read) {
+        // merge again without the unreadable FlowFile
+        session->transfer(inputs[end], Failure);
+        inputs.erase(inputs.begin() + end);
+      } else {
+        logger_->log_error("Failed to write the merged records of %llu FlowFiles", end - begin);
+        for (size_t i = begin; i < end; i++) {
+          session->transfer(inputs[i], Failure);
+        }
+        begin = end;
+      }
+      continue;
+    }
+
+    session->putAttribute(merged, "record.count", std::to_string(write_callback.getRecordCount()));
+    session->putAttribute(merged, FlowAttributeKey(MIME_TYPE), mime_type);
+    session->transfer(merged, Merged);
+    for (size_t i = begin; i < end; i++) {
+      session->transfer(inputs[i], Original);
+    }
+    logger_->log_debug("Merged %llu records of %llu FlowFiles", write_callback.getRecordCount(), end - begin);
+    begin = end;
+  }
+}
+
+} /* namespace processors */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
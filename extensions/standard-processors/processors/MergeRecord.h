@@ -0,0 +1,87 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_MERGERECORD_H_
+#define EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_MERGERECORD_H_
+
+#include <memory>
+#include <string>
+#include "core/Processor.h"
+#include "core/ProcessSession.h"
+#include "core/Resource.h"
+#include "core/logging/LoggerConfiguration.h"
+#include "../controllers/RecordSet.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+/**
+ * Merges the records of the queued FlowFiles into FlowFiles of about a target number of records.
+ * Records are streamed from the inputs to the merged FlowFile, so a merge never holds more than a
+ * read buffer of records in memory.
+ */
+class MergeRecord : public core::Processor {
+ public:
+
+  explicit MergeRecord(std::string name, utils::Identifier uuid = utils::Identifier())
+      : core::Processor(name, uuid),
+        logger_(logging::LoggerFactory<MergeRecord>::getLogger()),
+        target_records_(1000),
+        max_flow_files_(1000) {
+  }
+
+  /**
+   * Properties
+   */
+
+  static core::Property RecordReader;
+  static core::Property RecordWriter;
+  static core::Property TargetNumberOfRecords;
+  static core::Property MaxFlowFiles;
+
+  /**
+   * Relationships
+   */
+
+  static core::Relationship Merged;
+  static core::Relationship Original;
+  static core::Relationship Failure;
+
+  virtual void onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory);
+  virtual void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
+  virtual void initialize(void);
+
+ private:
+  std::shared_ptr<logging::Logger> logger_;
+  std::shared_ptr<controllers::RecordReaderFactory> reader_factory_;
+  std::shared_ptr<controllers::RecordSetWriterFactory> writer_factory_;
+  uint64_t target_records_;
+  uint64_t max_flow_files_;
+};
+
+REGISTER_RESOURCE(MergeRecord, "Merges the records of many FlowFiles into FlowFiles holding about a target number of records.");
+
+} /* namespace processors */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_MERGERECORD_H_ */
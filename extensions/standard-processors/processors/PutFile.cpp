@@ -21,19 +21,32 @@
 #include "PutFile.h"
 #include <sys/stat.h>
 #include <uuid/uuid.h>
+#include <cerrno>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <set>
+#include <vector>
 #ifdef WIN32
 #include <Windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
 #endif
 #include "utils/file/FileUtils.h"
 #ifndef S_ISDIR
 #define S_ISDIR(mode)  (((mode) & S_IFMT) == S_IFDIR)
 #endif
+#ifndef RENAME_NOREPLACE
+#define RENAME_NOREPLACE (1 << 0)
+#endif
 
 namespace org {
 namespace apache {
@@ -58,9 +71,101 @@ core::Property PutFile::CreateDirs("Create Missing Directories", "If true, then
 core::Property PutFile::MaxDestFiles(
     core::PropertyBuilder::createProperty("Maximum File Count")->withDescription("Specifies the maximum number of files that can exist in the output directory")->withDefaultValue<int>(-1)->build());
 
+core::Property PutFile::BatchSize(
+    core::PropertyBuilder::createProperty("Batch Size")->withDescription("The maximum number of FlowFiles written in each invocation")->withDefaultValue<uint64_t>(100)->build());
+
+core::Property PutFile::Durability(
+    core::PropertyBuilder::createProperty("Durability")->withDescription("When written files are synced to disk before the FlowFiles are routed to success: "
+                                                                         "none leaves it to the operating system, file syncs the data of every file before it is renamed "
+                                                                         "into place and the directories at the end of the batch, batch syncs the file systems "
+                                                                         "written to once at the end of the batch")
+        ->withAllowableValue<std::string>(DURABILITY_NONE)->withAllowableValue(DURABILITY_FILE)->withAllowableValue(DURABILITY_BATCH)->withDefaultValue(DURABILITY_NONE)->build());
+
 core::Relationship PutFile::Success("success", "All files are routed to success");
 core::Relationship PutFile::Failure("failure", "Failed files (conflict, write failure, etc.) are transferred to failure");
 
+#ifndef WIN32
+namespace {
+
+// cached directory handles are dropped all at once beyond this, e.g. when the directory changes per FlowFile
+const size_t MAX_DIRECTORY_HANDLES = 64;
+
+int syncData(int fd) {
+#ifdef __APPLE__
+  return fsync(fd);
+#else
+  return fdatasync(fd);
+#endif
+}
+
+int syncFileSystem(int fd) {
+#ifdef __linux__
+  return syncfs(fd);
+#else
+  sync();
+  return 0;
+#endif
+}
+
+/**
+ * Renames from to to within directory unless to exists, in which case it fails with EEXIST.
+ * Falls back to a hard link where renameat2 is not supported by the kernel or file system.
+ */
+int renameNoReplace(int directory, const char *from, const char *to) {
+#if defined(__linux__) && defined(SYS_renameat2)
+  if (syscall(SYS_renameat2, directory, from, directory, to, RENAME_NOREPLACE) == 0) {
+    return 0;
+  }
+  if (errno != ENOSYS && errno != EINVAL) {
+    return -1;
+  }
+#endif
+  if (linkat(directory, from, directory, to, 0) != 0) {
+    return -1;
+  }
+  unlinkat(directory, from, 0);
+  return 0;
+}
+
+// Counts the entries of directory that are not directories, stopping at max
+int64_t countFiles(int directory, int64_t max) {
+  int fd = openat(directory, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    return -1;
+  }
+  DIR *dir = fdopendir(fd);
+  if (dir == nullptr) {
+    close(fd);
+    return -1;
+  }
+  int64_t count = 0;
+  struct dirent *entry;
+  while (count < max && (entry = readdir(dir)) != nullptr) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+      continue;
+    }
+    bool is_dir = entry->d_type == DT_DIR;
+    if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK) {
+      struct stat entry_stat;
+      is_dir = fstatat(fd, entry->d_name, &entry_stat, 0) == 0 && S_ISDIR(entry_stat.st_mode);
+    }
+    if (!is_dir) {
+      count++;
+    }
+  }
+  closedir(dir);
+  return count;
+}
+
+}  // namespace
+
+PutFile::DirectoryHandle::~DirectoryHandle() {
+  if (fd >= 0) {
+    close(fd);
+  }
+}
+#endif
+
 void PutFile::initialize() {
   // Set the supported properties
   std::set<core::Property> properties;
@@ -68,6 +173,8 @@ void PutFile::initialize() {
   properties.insert(ConflictResolution);
   properties.insert(CreateDirs);
   properties.insert(MaxDestFiles);
+  properties.insert(BatchSize);
+  properties.insert(Durability);
   setSupportedProperties(properties);
   // Set the supported relationships
   std::set<core::Relationship> relationships;
@@ -88,6 +195,22 @@ void PutFile::onSchedule(core::ProcessContext *context, core::ProcessSessionFact
   if (context->getProperty(MaxDestFiles.getName(), value)) {
     core::Property::StringToInt(value, max_dest_files_);
   }
+
+  context->getProperty(BatchSize.getName(), batch_size_);
+  if (batch_size_ == 0) {
+    batch_size_ = 1;
+  }
+
+  if (!context->getProperty(Durability.getName(), durability_) || durability_.empty()) {
+    durability_ = DURABILITY_NONE;
+  }
+}
+
+void PutFile::notifyStop() {
+#ifndef WIN32
+  std::lock_guard<std::mutex> lock(directory_handles_mutex_);
+  directory_handles_.clear();
+#endif
 }
 
 void PutFile::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
@@ -97,25 +220,269 @@ void PutFile::onTrigger(core::ProcessContext *context, core::ProcessSession *ses
     return;
   }
 
-  std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast<FlowFileRecord>(session->get());
+#ifndef WIN32
+  DirectoryHandles batch_handles;
+  std::vector<std::shared_ptr<FlowFileRecord>> written;
+#endif
+  for (uint64_t i = 0; i < batch_size_; i++) {
+    std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast<FlowFileRecord>(session->get());
+
+    // Do nothing if there are no incoming files
+    if (!flowFile) {
+      break;
+    }
+
+    std::string directory;
+
+    if (!context->getProperty(Directory, directory, flowFile)) {
+      logger_->log_error("Directory attribute is missing or invalid");
+    }
+
+    if (IsNullOrEmpty(directory)) {
+      logger_->log_error("Directory attribute evaluated to invalid value");
+      session->transfer(flowFile, Failure);
+      continue;
+    }
+
+#ifndef WIN32
+    std::string filename;
+    flowFile->getKeyedAttribute(FILENAME, filename);
+    logger_->log_debug("PutFile writing file %s into directory %s", filename, directory);
+
+    // a filename with separators is written into the subdirectory it names
+    std::string destFile = directory;
+    destFile += utils::file::FileUtils::get_separator();
+    destFile += filename;
+    const auto separator = destFile.find_last_of(utils::file::FileUtils::get_separator());
+    const std::string destDir = destFile.substr(0, std::max<size_t>(separator, 1));
+
+    std::shared_ptr<DirectoryHandle> handle = getDirectoryHandle(destDir, batch_handles);
+    if (handle == nullptr) {
+      session->transfer(flowFile, Failure);
+      continue;
+    }
+
+    core::Relationship relationship = putFileAt(session, flowFile, directory, *handle, destFile.substr(separator + 1));
+    if (relationship.getName() == Success.getName() && durability_ != DURABILITY_NONE) {
+      written.push_back(flowFile);
+    } else {
+      session->transfer(flowFile, relationship);
+    }
+#else
+    putFile(session, flowFile, directory);
+#endif
+  }
 
-  // Do nothing if there are no incoming files
-  if (!flowFile) {
+#ifndef WIN32
+  if (written.empty()) {
     return;
   }
+  // the FlowFiles are only acknowledged once what was written cannot be lost anymore
+  bool synced = true;
+  std::set<dev_t> synced_devices;
+  for (const auto &entry : batch_handles) {
+    if (durability_ == DURABILITY_BATCH) {
+      if (synced_devices.insert(entry.second->device).second && syncFileSystem(entry.second->fd) != 0) {
+        logger_->log_error("PutFile could not sync the file system of %s: %s", entry.first, strerror(errno));
+        synced = false;
+      }
+    } else if (fsync(entry.second->fd) != 0) {
+      // the data of the files is synced already, this makes their renames durable
+      logger_->log_error("PutFile could not sync directory %s: %s", entry.first, strerror(errno));
+      synced = false;
+    }
+  }
+  for (const auto &flowFile : written) {
+    session->transfer(flowFile, synced ? Success : Failure);
+  }
+#endif
+}
 
-  std::string directory;
+std::string PutFile::tmpWritePath(const std::string &filename, const std::string &directory) const {
+  utils::Identifier tmpFileUuid;
+  id_generator_->generate(tmpFileUuid);
+  std::string tmpFile = directory;
+  tmpFile += utils::file::FileUtils::get_separator();
+  auto lastSeparatorPos = filename.find_last_of(utils::file::FileUtils::get_separator());
 
-  if (!context->getProperty(Directory, directory, flowFile)) {
-    logger_->log_error("Directory attribute is missing or invalid");
+  if (lastSeparatorPos == std::string::npos) {
+    tmpFile += '.';
+    tmpFile += filename;
+  } else {
+    tmpFile.append(filename, 0, lastSeparatorPos + 1);
+    tmpFile += '.';
+    tmpFile.append(filename, lastSeparatorPos + 1, std::string::npos);
   }
 
-  if (IsNullOrEmpty(directory)) {
-    logger_->log_error("Directory attribute evaluated to invalid value");
-    session->transfer(flowFile, Failure);
-    return;
+  tmpFile += '.';
+  tmpFile += tmpFileUuid.to_string();
+  return tmpFile;
+}
+
+#ifndef WIN32
+std::shared_ptr<PutFile::DirectoryHandle> PutFile::getDirectoryHandle(const std::string &directory, DirectoryHandles &batch_handles) {
+  auto checked = batch_handles.find(directory);
+  if (checked != batch_handles.end()) {
+    return checked->second;
   }
 
+  struct stat dir_stat;
+  bool exists = stat(directory.c_str(), &dir_stat) == 0;
+  if (!exists && try_mkdirs_) {
+    logger_->log_debug("Destination directory does not exist; will attempt to create: %s", directory);
+    utils::file::FileUtils::create_dir(directory);
+    exists = stat(directory.c_str(), &dir_stat) == 0;
+  }
+  if (!exists || !S_ISDIR(dir_stat.st_mode)) {
+    logger_->log_error("PutFile cannot write into %s because it is not a directory", directory);
+    return nullptr;
+  }
+
+  std::shared_ptr<DirectoryHandle> handle;
+  {
+    std::lock_guard<std::mutex> lock(directory_handles_mutex_);
+    auto cached = directory_handles_.find(directory);
+    // a directory that was removed or replaced since it was opened is opened again
+    if (cached != directory_handles_.end() && cached->second->device == dir_stat.st_dev && cached->second->inode == dir_stat.st_ino) {
+      handle = cached->second;
+    }
+  }
+
+  if (handle == nullptr) {
+    handle = std::make_shared<DirectoryHandle>();
+    handle->fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (handle->fd < 0 || fstat(handle->fd, &dir_stat) != 0) {
+      logger_->log_error("PutFile could not open directory %s: %s", directory, strerror(errno));
+      return nullptr;
+    }
+    handle->device = dir_stat.st_dev;
+    handle->inode = dir_stat.st_ino;
+    std::lock_guard<std::mutex> lock(directory_handles_mutex_);
+    if (directory_handles_.size() >= MAX_DIRECTORY_HANDLES) {
+      directory_handles_.clear();
+    }
+    directory_handles_[directory] = handle;
+  }
+
+  if (max_dest_files_ != -1) {
+    handle->file_count = countFiles(handle->fd, max_dest_files_);
+  }
+  batch_handles[directory] = handle;
+  return handle;
+}
+
+core::Relationship PutFile::putFileAt(core::ProcessSession *session, const std::shared_ptr<FlowFileRecord> &flowFile, const std::string &directory, DirectoryHandle &handle,
+                                      const std::string &name) {
+  const std::string destFile = directory + utils::file::FileUtils::get_separator() + name;
+
+  if (max_dest_files_ != -1 && handle.file_count >= max_dest_files_) {
+    logger_->log_warn("Routing to failure because the output directory %s has at least %u files, which exceeds the "
+                      "configured max number of files", directory, max_dest_files_);
+    return Failure;
+  }
+
+  // If file exists, apply conflict resolution strategy
+  struct stat statResult;
+  const bool exists = fstatat(handle.fd, name.c_str(), &statResult, AT_SYMLINK_NOFOLLOW) == 0;
+  if (exists) {
+    logger_->log_warn("Destination file %s exists; applying Conflict Resolution Strategy: %s", destFile, conflict_resolution_);
+    if (conflict_resolution_ == CONFLICT_RESOLUTION_STRATEGY_IGNORE) {
+      return Success;
+    } else if (conflict_resolution_ != CONFLICT_RESOLUTION_STRATEGY_REPLACE) {
+      return Failure;
+    }
+  }
+
+  utils::Identifier tmpFileUuid;
+  id_generator_->generate(tmpFileUuid);
+  std::string tmpFile = ".";
+  tmpFile += name;
+  tmpFile += '.';
+  tmpFile += tmpFileUuid.to_string();
+  logger_->log_debug("PutFile using temporary file %s", tmpFile);
+
+  int fd = openat(handle.fd, tmpFile.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+  if (fd < 0) {
+    logger_->log_error("PutFile commit put file operation to %s failed because the temporary file could not be created: %s", destFile, strerror(errno));
+    return Failure;
+  }
+
+  bool write_succeeded = session->copyContent(flowFile, fd);
+  if (!write_succeeded && ftruncate(fd, 0) == 0 && lseek(fd, 0, SEEK_SET) == 0) {
+    FileDescriptorWriteCallback cb(fd);
+    session->read(flowFile, &cb);
+    write_succeeded = cb.succeeded();
+  }
+  if (write_succeeded && durability_ == DURABILITY_FILE && syncData(fd) != 0) {
+    logger_->log_error("PutFile could not sync %s: %s", destFile, strerror(errno));
+    write_succeeded = false;
+  }
+  if (close(fd) != 0) {
+    write_succeeded = false;
+  }
+  if (!write_succeeded) {
+    logger_->log_error("PutFile commit put file operation to %s failed because write failed", destFile);
+    unlinkat(handle.fd, tmpFile.c_str(), 0);
+    return Failure;
+  }
+
+  logger_->log_debug("PutFile committing put file operation to %s", destFile);
+  // without replacing, a file created since the check above is not overwritten
+  int renamed = conflict_resolution_ == CONFLICT_RESOLUTION_STRATEGY_REPLACE ?
+      renameat(handle.fd, tmpFile.c_str(), handle.fd, name.c_str()) : renameNoReplace(handle.fd, tmpFile.c_str(), name.c_str());
+  if (renamed != 0) {
+    const int error = errno;
+    unlinkat(handle.fd, tmpFile.c_str(), 0);
+    if (error == EEXIST) {
+      logger_->log_warn("Destination file %s exists; applying Conflict Resolution Strategy: %s", destFile, conflict_resolution_);
+      return conflict_resolution_ == CONFLICT_RESOLUTION_STRATEGY_IGNORE ? Success : Failure;
+    }
+    logger_->log_error("PutFile commit put file operation to %s failed because rename() call failed: %s", destFile, strerror(error));
+    return Failure;
+  }
+
+  if (!exists && max_dest_files_ != -1) {
+    handle.file_count++;
+  }
+  logger_->log_debug("PutFile commit put file operation to %s succeeded", destFile);
+  return Success;
+}
+
+int64_t PutFile::FileDescriptorWriteCallback::process(std::shared_ptr<io::BaseStream> stream) {
+  write_succeeded_ = false;
+  size_t size = 0;
+  uint8_t buffer[8192];
+
+  do {
+    int read = stream->read(buffer, sizeof(buffer));
+
+    if (read < 0) {
+      return -1;
+    }
+
+    if (read == 0) {
+      break;
+    }
+
+    int written = 0;
+    while (written < read) {
+      ssize_t ret = write(fd_, buffer + written, read - written);
+      if (ret < 0 && errno == EINTR) {
+        continue;
+      }
+      if (ret < 0) {
+        return -1;
+      }
+      written += ret;
+    }
+    size += read;
+  } while (size < stream->getSize());
+
+  write_succeeded_ = true;
+  return size;
+}
+#else
+void PutFile::putFile(core::ProcessSession *session, const std::shared_ptr<FlowFileRecord> &flowFile, const std::string &directory) {
   std::string filename;
   flowFile->getKeyedAttribute(FILENAME, filename);
   std::string tmpFile = tmpWritePath(filename, directory);
@@ -123,9 +490,7 @@ void PutFile::onTrigger(core::ProcessContext *context, core::ProcessSession *ses
   logger_->log_debug("PutFile using temporary file %s", tmpFile);
 
   // Determine dest full file paths
-  std::stringstream destFileSs;
-  destFileSs << directory << utils::file::FileUtils::get_separator() << filename;
-  std::string destFile = destFileSs.str();
+  std::string destFile = directory + utils::file::FileUtils::get_separator() + filename;
 
   logger_->log_debug("PutFile writing file %s into directory %s", filename, directory);
 
@@ -170,24 +535,6 @@ void PutFile::onTrigger(core::ProcessContext *context, core::ProcessSession *ses
   }
 }
 
-std::string PutFile::tmpWritePath(const std::string &filename, const std::string &directory) const {
-  utils::Identifier tmpFileUuid;
-  id_generator_->generate(tmpFileUuid);
-  std::stringstream tmpFileSs;
-  tmpFileSs << directory;
-  auto lastSeparatorPos = filename.find_last_of(utils::file::FileUtils::get_separator());
-
-  if (lastSeparatorPos == std::string::npos) {
-    tmpFileSs << utils::file::FileUtils::get_separator() << "." << filename;
-  } else {
-    tmpFileSs << utils::file::FileUtils::get_separator() << filename.substr(0, lastSeparatorPos) << utils::file::FileUtils::get_separator() << "." << filename.substr(lastSeparatorPos + 1);
-  }
-
-  tmpFileSs << "." << tmpFileUuid.to_string();
-  std::string tmpFile = tmpFileSs.str();
-  return tmpFile;
-}
-
 bool PutFile::putFile(core::ProcessSession *session, std::shared_ptr<FlowFileRecord> flowFile, const std::string &tmpFile, const std::string &destFile, const std::string &destDir) {
   struct stat dir_stat;
 
@@ -219,7 +566,11 @@ bool PutFile::putFile(core::ProcessSession *session, std::shared_ptr<FlowFileRec
   }
 
   ReadCallback cb(tmpFile, destFile);
-  session->read(flowFile, &cb);
+  if (session->copyContent(flowFile, tmpFile)) {
+    cb.setWriteSucceeded();
+  } else {
+    session->read(flowFile, &cb);
+  }
 
   logger_->log_debug("Committing %s", destFile);
   if (cb.commit()) {
@@ -230,6 +581,7 @@ bool PutFile::putFile(core::ProcessSession *session, std::shared_ptr<FlowFileRec
   }
   return false;
 }
+#endif
 
 PutFile::ReadCallback::ReadCallback(const std::string &tmp_file, const std::string &dest_file)
     : tmp_file_(tmp_file),
@@ -20,6 +20,14 @@
 #ifndef __PUT_FILE_H__
 #define __PUT_FILE_H__
 
+#ifndef WIN32
+#include <sys/types.h>
+#endif
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include "FlowFileRecord.h"
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
@@ -41,6 +49,10 @@ class PutFile : public core::Processor {
   static constexpr char const *CONFLICT_RESOLUTION_STRATEGY_IGNORE = "ignore";
   static constexpr char const *CONFLICT_RESOLUTION_STRATEGY_FAIL = "fail";
 
+  static constexpr char const *DURABILITY_NONE = "none";
+  static constexpr char const *DURABILITY_FILE = "file";
+  static constexpr char const *DURABILITY_BATCH = "batch";
+
   static constexpr char const *ProcessorName = "PutFile";
 
   /*!
@@ -58,6 +70,8 @@ class PutFile : public core::Processor {
   static core::Property ConflictResolution;
   static core::Property CreateDirs;
   static core::Property MaxDestFiles;
+  static core::Property BatchSize;
+  static core::Property Durability;
   // Supported Relationships
   static core::Relationship Success;
   static core::Relationship Failure;
@@ -72,6 +86,7 @@ class PutFile : public core::Processor {
 
   virtual void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
   virtual void initialize(void);
+  virtual void notifyStop();
 
   class ReadCallback : public InputStreamCallback {
    public:
@@ -80,6 +95,10 @@ class PutFile : public core::Processor {
     ~ReadCallback();
     virtual int64_t process(std::shared_ptr<io::BaseStream> stream);
     bool commit();
+    // Marks the tmp file as written when its content was copied without process()
+    void setWriteSucceeded() {
+      write_succeeded_ = true;
+    }
 
    private:
     std::shared_ptr<logging::Logger> logger_;
@@ -89,6 +108,24 @@ class PutFile : public core::Processor {
     std::string dest_dir_;
   };
 
+#ifndef WIN32
+  // Writes the content of a flow file to the current position of an open file
+  class FileDescriptorWriteCallback : public InputStreamCallback {
+   public:
+    explicit FileDescriptorWriteCallback(int fd)
+        : fd_(fd) {
+    }
+    virtual int64_t process(std::shared_ptr<io::BaseStream> stream);
+    bool succeeded() const {
+      return write_succeeded_;
+    }
+
+   private:
+    int fd_;
+    bool write_succeeded_ = false;
+  };
+#endif
+
   /**
    * Generate a safe (universally-unique) temporary filename on the same partition
    *
@@ -104,12 +141,50 @@ class PutFile : public core::Processor {
   std::string conflict_resolution_;
   bool try_mkdirs_ = true;
   int64_t max_dest_files_ = -1;
+  uint64_t batch_size_ = 100;
+  std::string durability_;
+
+#ifndef WIN32
+  /**
+   * Open output directory, kept across batches so that files are created and renamed relative
+   * to it instead of resolving the directory path for every file
+   */
+  struct DirectoryHandle {
+    ~DirectoryHandle();
+    int fd = -1;
+    dev_t device = 0;
+    ino_t inode = 0;
+    // files in the directory, counted when a batch first uses the directory and kept up to date within it
+    std::atomic<int64_t> file_count{-1};
+  };
+  typedef std::map<std::string, std::shared_ptr<DirectoryHandle>> DirectoryHandles;
+
+  /**
+   * Returns the handle of directory for the current batch, reopening a cached handle if the
+   * directory was replaced and creating the directory if allowed
+   * @param batch_handles handles already checked by the current batch
+   * @return nullptr if the directory cannot be opened
+   */
+  std::shared_ptr<DirectoryHandle> getDirectoryHandle(const std::string &directory, DirectoryHandles &batch_handles);
+
+  /**
+   * Writes flowFile as name into directory through a temporary file created relative to handle
+   * @return the relationship the flow file goes to
+   */
+  core::Relationship putFileAt(core::ProcessSession *session, const std::shared_ptr<FlowFileRecord> &flowFile, const std::string &directory, DirectoryHandle &handle,
+                               const std::string &name);
+
+  std::mutex directory_handles_mutex_;
+  DirectoryHandles directory_handles_;
+#else
+  void putFile(core::ProcessSession *session, const std::shared_ptr<FlowFileRecord> &flowFile, const std::string &directory);
 
   bool putFile(core::ProcessSession *session,
                std::shared_ptr<FlowFileRecord> flowFile,
                const std::string &tmpFile,
                const std::string &destFile,
                const std::string &destDir);
+#endif
   std::shared_ptr<logging::Logger> logger_;
   static std::shared_ptr<utils::IdGenerator> id_generator_;
 };
@@ -0,0 +1,129 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_RECORDCALLBACKS_H_
+#define EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_RECORDCALLBACKS_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include "FlowFileRecord.h"
+#include "Exception.h"
+#include "core/ProcessContext.h"
+#include "io/BaseStream.h"
+#include "../controllers/RecordSet.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+/**
+ * Returns the record reader or writer service named by a property of a processor.
+ * @throws Exception if the property does not name a service of the type
+ */
+template<typename T>
+std::shared_ptr<T> getRecordService(core::ProcessContext *context, const core::Property &property) {
+  std::string name;
+  if (!context->getProperty(property.getName(), name) || name.empty()) {
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, property.getName() + " must name a controller service");
+  }
+  auto service = std::dynamic_pointer_cast<T>(context->getControllerService(name));
+  if (service == nullptr) {
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, "The " + property.getName() + " " + name + " is not a controller service of the right type");
+  }
+  return service;
+}
+
+/**
+ * Hands a reader of the content to a function. Content without records never reaches the function.
+ */
+class RecordReadCallback : public InputStreamCallback {
+ public:
+  RecordReadCallback(const std::shared_ptr<controllers::RecordReaderFactory> &factory, uint64_t size, std::function<void(controllers::RecordReader&)> consume)
+      : factory_(factory),
+        size_(size),
+        consume_(std::move(consume)) {
+  }
+
+  int64_t process(std::shared_ptr<io::BaseStream> stream) {
+    auto reader = factory_->createRecordReader(stream, size_);
+    consume_(*reader);
+    error_ = reader->getError();
+    return size_;
+  }
+
+  /**
+   * @return why the content could not be read, empty if it was read
+   */
+  const std::string &getError() const {
+    return error_;
+  }
+
+ private:
+  std::shared_ptr<controllers::RecordReaderFactory> factory_;
+  uint64_t size_;
+  std::function<void(controllers::RecordReader&)> consume_;
+  std::string error_;
+};
+
+/**
+ * Hands a writer of the content to a function and finishes the writer when the function returns.
+ */
+class RecordWriteCallback : public OutputStreamCallback {
+ public:
+  RecordWriteCallback(const std::shared_ptr<controllers::RecordSetWriterFactory> &factory, std::function<bool(controllers::RecordSetWriter&)> produce)
+      : factory_(factory),
+        produce_(std::move(produce)),
+        success_(false),
+        record_count_(0) {
+  }
+
+  int64_t process(std::shared_ptr<io::BaseStream> stream) {
+    auto writer = factory_->createRecordSetWriter(stream);
+    success_ = produce_(*writer) && writer->finish();
+    record_count_ = writer->getRecordCount();
+    return stream->getSize();
+  }
+
+  /**
+   * @return false if the function failed or the content could not be written
+   */
+  bool isSuccess() const {
+    return success_;
+  }
+
+  uint64_t getRecordCount() const {
+    return record_count_;
+  }
+
+ private:
+  std::shared_ptr<controllers::RecordSetWriterFactory> factory_;
+  std::function<bool(controllers::RecordSetWriter&)> produce_;
+  bool success_;
+  uint64_t record_count_;
+};
+
+} /* namespace processors */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_RECORDCALLBACKS_H_ */
@@ -23,6 +23,7 @@
 #include <memory>
 #include <string>
 #include <set>
+#include <vector>
 
 namespace org {
 namespace apache {
@@ -30,11 +31,24 @@ namespace nifi {
 namespace minifi {
 namespace processors {
 
+const char *RouteOnAttribute::ROUTE_TO_PROPERTY_NAME = "Route to Property name";
+const char *RouteOnAttribute::ROUTE_TO_FIRST_MATCH = "Route to first matching Property name";
+
+core::Property RouteOnAttribute::RoutingStrategy(
+    core::PropertyBuilder::createProperty("Routing Strategy")->withDescription("Whether a FlowFile is routed to every route whose expression evaluates to true, "
+                                                                               "cloning it for each additional match, or only to the first of them in the order of their names")
+        ->withAllowableValue<std::string>(ROUTE_TO_PROPERTY_NAME)->withAllowableValue(ROUTE_TO_FIRST_MATCH)->withDefaultValue(ROUTE_TO_PROPERTY_NAME)->build());
+
+core::Property RouteOnAttribute::BatchSize(
+    core::PropertyBuilder::createProperty("Batch Size")->withDescription("The maximum number of FlowFiles routed in each invocation")->withDefaultValue<uint64_t>(100)->build());
+
 core::Relationship RouteOnAttribute::Unmatched("unmatched", "Files which do not match any expression are routed here");
 core::Relationship RouteOnAttribute::Failure("failure", "Failed files are transferred to failure");
 
 void RouteOnAttribute::initialize() {
   std::set<core::Property> properties;
+  properties.insert(RoutingStrategy);
+  properties.insert(BatchSize);
   setSupportedProperties(properties);
   std::set<core::Relationship> relationships;
   relationships.insert(Unmatched);
@@ -60,38 +74,58 @@ void RouteOnAttribute::onDynamicPropertyModified(const core::Property &orig_prop
   setSupportedRelationships(relationships);
 }
 
-void RouteOnAttribute::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
-  auto flow_file = session->get();
+void RouteOnAttribute::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
+  std::string strategy;
+  first_match_ = context->getProperty(RoutingStrategy.getName(), strategy) && strategy == ROUTE_TO_FIRST_MATCH;
+  if (!context->getProperty(BatchSize.getName(), batch_size_) || batch_size_ == 0) {
+    batch_size_ = 1;
+  }
 
-  // Do nothing if there are no incoming files
-  if (!flow_file) {
-    return;
+  routes_.clear();
+  for (const auto &route : route_properties_) {
+    routes_.push_back(Route { route.second, route_rels_[route.first] });
   }
+}
 
-  try {
-    bool did_match = false;
+void RouteOnAttribute::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
+  std::vector<const core::Relationship*> matches;
+  matches.reserve(routes_.size());
 
-    // Perform dynamic routing logic
-    for (const auto &route : route_properties_) {
-      std::string do_route;
-      context->getDynamicProperty(route.second, do_route, flow_file);
+  for (uint64_t i = 0; i < batch_size_; i++) {
+    auto flow_file = session->get();
 
-      if (do_route == "true") {
-        did_match = true;
-        auto clone = session->clone(flow_file);
-        session->transfer(clone, route_rels_[route.first]);
-      }
+    // Do nothing if there are no incoming files
+    if (!flow_file) {
+      return;
     }
 
-    if (!did_match) {
-      session->transfer(flow_file, Unmatched);
-    } else {
-      session->remove(flow_file);
+    try {
+      matches.clear();
+      for (const auto &route : routes_) {
+        bool matched = false;
+        if (context->getDynamicProperty(route.property, matched, flow_file) && matched) {
+          matches.push_back(&route.relationship);
+          if (first_match_) {
+            break;
+          }
+        }
+      }
+
+      if (matches.empty()) {
+        session->transfer(flow_file, Unmatched);
+      } else {
+        // only additional matches need a clone, the last route takes the flow file itself
+        for (size_t match = 0; match + 1 < matches.size(); match++) {
+          session->transfer(session->clone(flow_file), *matches[match]);
+        }
+        session->transfer(flow_file, *matches.back());
+      }
+    } catch (const std::exception &e) {
+      logger_->log_error("Caught exception while routing flow file %s: %s", flow_file->getUUIDStr(), e.what());
+      session->transfer(flow_file, Failure);
+      yield();
+      return;
     }
-  } catch (const std::exception &e) {
-    logger_->log_error("Caught exception while updating attributes: %s", e.what());
-    session->transfer(flow_file, Failure);
-    yield();
   }
 }
 
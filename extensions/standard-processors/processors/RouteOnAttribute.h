@@ -26,6 +26,10 @@
 #include "core/Core.h"
 #include "core/Resource.h"
 #include "core/logging/LoggerConfiguration.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace org {
 namespace apache {
@@ -38,9 +42,21 @@ class RouteOnAttribute : public core::Processor {
 
   RouteOnAttribute(std::string name, utils::Identifier uuid = utils::Identifier())
       : core::Processor(name, uuid),
-        logger_(logging::LoggerFactory<RouteOnAttribute>::getLogger()) {
+        logger_(logging::LoggerFactory<RouteOnAttribute>::getLogger()),
+        first_match_(false),
+        batch_size_(100) {
   }
 
+  static const char *ROUTE_TO_PROPERTY_NAME;
+  static const char *ROUTE_TO_FIRST_MATCH;
+
+  /**
+   * Properties
+   */
+
+  static core::Property RoutingStrategy;
+  static core::Property BatchSize;
+
   /**
    * Relationships
    */
@@ -62,13 +78,23 @@ class RouteOnAttribute : public core::Processor {
   }
 
   virtual void onDynamicPropertyModified(const core::Property &orig_property, const core::Property &new_property);
+  virtual void onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory);
   virtual void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
   virtual void initialize(void);
 
  private:
+  struct Route {
+    core::Property property;
+    core::Relationship relationship;
+  };
+
   std::shared_ptr<logging::Logger> logger_;
   std::map<std::string, core::Property> route_properties_;
   std::map<std::string, core::Relationship> route_rels_;
+  // the routes in the order of their names, fixed when scheduled
+  std::vector<Route> routes_;
+  bool first_match_;
+  uint64_t batch_size_;
 };
 
 REGISTER_RESOURCE(RouteOnAttribute, "Routes FlowFiles based on their Attributes using the Attribute Expression Language.");
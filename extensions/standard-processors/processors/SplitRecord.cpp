@@ -0,0 +1,130 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SplitRecord.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "RecordCallbacks.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+core::Property SplitRecord::RecordReader(
+    core::PropertyBuilder::createProperty("Record Reader")->withDescription("The controller service reading the records of incoming FlowFiles")->isRequired(true)
+        ->asType<controllers::RecordReaderFactory>()->build());
+
+core::Property SplitRecord::RecordWriter(
+    core::PropertyBuilder::createProperty("Record Writer")->withDescription("The controller service writing the records of outgoing FlowFiles")->isRequired(true)
+        ->asType<controllers::RecordSetWriterFactory>()->build());
+
+core::Property SplitRecord::RecordsPerSplit(
+    core::PropertyBuilder::createProperty("Records Per Split")->withDescription("The maximum number of records in each split")->isRequired(true)->withDefaultValue<uint64_t>(1000)
+        ->build());
+
+core::Relationship SplitRecord::Splits("splits", "The FlowFiles the records are split into");
+core::Relationship SplitRecord::Original("original", "The FlowFiles that were split");
+core::Relationship SplitRecord::Failure("failure", "FlowFiles whose records could not be read or written");
+
+void SplitRecord::initialize() {
+  std::set<core::Property> properties;
+  properties.insert(RecordReader);
+  properties.insert(RecordWriter);
+  properties.insert(RecordsPerSplit);
+  setSupportedProperties(properties);
+  std::set<core::Relationship> relationships;
+  relationships.insert(Splits);
+  relationships.insert(Original);
+  relationships.insert(Failure);
+  setSupportedRelationships(relationships);
+}
+
+void SplitRecord::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
+  reader_factory_ = getRecordService<controllers::RecordReaderFactory>(context, RecordReader);
+  writer_factory_ = getRecordService<controllers::RecordSetWriterFactory>(context, RecordWriter);
+  if (!context->getProperty(RecordsPerSplit.getName(), records_per_split_) || records_per_split_ == 0) {
+    throw Exception(PROCESS_SCHEDULE_EXCEPTION, "Records Per Split must be a positive number");
+  }
+}
+
+void SplitRecord::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
+  auto flow_file = session->get();
+  if (!flow_file) {
+    return;
+  }
+
+  std::vector<std::shared_ptr<core::FlowFile>> splits;
+  bool written = true;
+  RecordReadCallback read_callback(reader_factory_, flow_file->getSize(), [&](controllers::RecordReader &reader) {
+    controllers::Record record;
+    bool pending = reader.read(record);
+    while (pending && written) {
+      // the record read last starts the next split
+      RecordWriteCallback write_callback(writer_factory_, [&](controllers::RecordSetWriter &writer) {
+        uint64_t count = 0;
+        do {
+          if (!writer.write(record)) {
+            return false;
+          }
+          pending = reader.read(record);
+        } while (pending && ++count < records_per_split_);
+        return true;
+      });
+      auto split = session->create(flow_file);
+      splits.push_back(split);
+      session->write(split, &write_callback);
+      written = write_callback.isSuccess();
+      session->putAttribute(split, "record.count", std::to_string(write_callback.getRecordCount()));
+    }
+  });
+  session->read(flow_file, &read_callback);
+
+  if (!written || !read_callback.getError().empty()) {
+    logger_->log_error("Failed to split the records of %s: %s", flow_file->getUUIDStr(), written ? read_callback.getError() : "the records could not be written");
+    for (const auto &split : splits) {
+      session->remove(split);
+    }
+    session->transfer(flow_file, Failure);
+    return;
+  }
+
+  const std::string mime_type = writer_factory_->getMimeType();
+  std::string filename;
+  flow_file->getAttribute(FlowAttributeKey(FILENAME), filename);
+  for (size_t i = 0; i < splits.size(); i++) {
+    session->putAttribute(splits[i], FlowAttributeKey(MIME_TYPE), mime_type);
+    session->putAttribute(splits[i], "fragment.identifier", flow_file->getUUIDStr());
+    session->putAttribute(splits[i], "fragment.index", std::to_string(i));
+    session->putAttribute(splits[i], "fragment.count", std::to_string(splits.size()));
+    session->putAttribute(splits[i], "segment.original.filename", filename);
+    session->transfer(splits[i], Splits);
+  }
+  logger_->log_debug("Split the records of %s into %llu FlowFiles", flow_file->getUUIDStr(), splits.size());
+  session->transfer(flow_file, Original);
+}
+
+} /* namespace processors */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,79 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_SPLITRECORD_H_
+#define EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_SPLITRECORD_H_
+
+#include <memory>
+#include <string>
+#include "core/Processor.h"
+#include "core/ProcessSession.h"
+#include "core/Resource.h"
+#include "core/logging/LoggerConfiguration.h"
+#include "../controllers/RecordSet.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace processors {
+
+class SplitRecord : public core::Processor {
+ public:
+
+  explicit SplitRecord(std::string name, utils::Identifier uuid = utils::Identifier())
+      : core::Processor(name, uuid),
+        logger_(logging::LoggerFactory<SplitRecord>::getLogger()),
+        records_per_split_(1000) {
+  }
+
+  /**
+   * Properties
+   */
+
+  static core::Property RecordReader;
+  static core::Property RecordWriter;
+  static core::Property RecordsPerSplit;
+
+  /**
+   * Relationships
+   */
+
+  static core::Relationship Splits;
+  static core::Relationship Original;
+  static core::Relationship Failure;
+
+  virtual void onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory);
+  virtual void onTrigger(core::ProcessContext *context, core::ProcessSession *session);
+  virtual void initialize(void);
+
+ private:
+  std::shared_ptr<logging::Logger> logger_;
+  std::shared_ptr<controllers::RecordReaderFactory> reader_factory_;
+  std::shared_ptr<controllers::RecordSetWriterFactory> writer_factory_;
+  uint64_t records_per_split_;
+};
+
+REGISTER_RESOURCE(SplitRecord, "Splits the records of a FlowFile into FlowFiles holding up to a number of records each.");
+
+} /* namespace processors */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* EXTENSIONS_STANDARD_PROCESSORS_PROCESSORS_SPLITRECORD_H_ */
@@ -36,6 +36,7 @@
 #include <sstream>
 #include <string>
 #include <iostream>
+#include <unordered_map>
 #include "utils/file/FileUtils.h"
 #include "utils/file/PathUtils.h"
 #include "utils/TimeUtil.h"
@@ -72,6 +73,9 @@ core::Property TailFile::FileName("File to Tail", "Fully-qualified filename of t
 core::Property TailFile::StateFile("State File", "Specifies the file that should be used for storing state about"
                                    " what data has been ingested so that upon restart NiFi can resume from where it left off",
                                    "TailFileState");
+core::Property TailFile::StateManager(
+    core::PropertyBuilder::createProperty("State Manager")->withDescription("Name of the state manager controller service used to store the position of tailed files. "
+                                                                           "If not set, the state is stored in the State File.")->isRequired(false)->build());
 core::Property TailFile::Delimiter("Input Delimiter", "Specifies the character that should be used for delimiting the data being tailed"
                                    "from the incoming file."
                                    "If none is specified, data will be ingested as it becomes available.",
@@ -96,6 +100,7 @@ void TailFile::initialize() {
   std::set<core::Property> properties;
   properties.insert(FileName);
   properties.insert(StateFile);
+  properties.insert(StateManager);
   properties.insert(Delimiter);
   properties.insert(TailMode);
   properties.insert(BaseDirectory);
@@ -111,6 +116,8 @@ void TailFile::onSchedule(const std::shared_ptr<core::ProcessContext> &context,
 
   // can perform these in notifyStop, but this has the same outcome
   tail_states_.clear();
+  claimed_files_.clear();
+  next_file_.clear();
   state_recovered_ = false;
 
   std::string value;
@@ -119,6 +126,14 @@ void TailFile::onSchedule(const std::shared_ptr<core::ProcessContext> &context,
     delimiter_ = value;
   }
 
+  state_manager_ = nullptr;
+  if (context->getProperty(StateManager.getName(), value) && !value.empty()) {
+    state_manager_ = std::dynamic_pointer_cast<controllers::StateManagerService>(context->getControllerService(value));
+    if (state_manager_ == nullptr) {
+      throw minifi::Exception(ExceptionType::PROCESSOR_EXCEPTION, "State Manager " + value + " is not a state manager controller service");
+    }
+  }
+
   std::string mode;
   context->getProperty(TailMode.getName(), mode);
 
@@ -199,6 +214,10 @@ void TailFile::parseStateFileLine(char *buf) {
   key = trimRight(key);
   value = trimRight(value);
 
+  parseStateValue(key, value);
+}
+
+void TailFile::parseStateValue(const std::string &key, const std::string &value) {
   if (key == "FILENAME") {
     std::string fileLocation, fileName;
     if (utils::file::PathUtils::getFileNameAndPath(value, fileLocation, fileName)) {
@@ -232,11 +251,35 @@ void TailFile::parseStateFileLine(char *buf) {
     const auto file = key.substr(strlen(POSITION_STR));
     tail_states_[file].currentTailFilePosition_ = std::stoull(value);
   }
-
-  return;
 }
 
 bool TailFile::recoverState() {
+  if (state_manager_ == nullptr) {
+    return recoverStateFromFile();
+  }
+  std::unordered_map<std::string, std::string> state;
+  if (state_manager_->get(getUUIDStr(), state)) {
+    tail_states_.clear();
+    for (const auto &kv : state) {
+      parseStateValue(kv.first, kv.second);
+    }
+    validateState();
+    logger_->log_debug("load state succeeded from %s", state_manager_->getName());
+    return true;
+  }
+  // nothing stored yet: move the state of a previous State File over to the state manager
+  struct stat sb;
+  if (!state_file_.empty() && stat(state_file_.c_str(), &sb) == 0 && recoverStateFromFile()) {
+    storeState();
+    if (std::remove(state_file_.c_str()) != 0) {
+      logger_->log_warn("Unable to remove state file %s after moving it to %s", state_file_, state_manager_->getName());
+    }
+    return true;
+  }
+  return false;
+}
+
+bool TailFile::recoverStateFromFile() {
   std::ifstream file(state_file_.c_str(), std::ifstream::in);
   if (!file.good()) {
     logger_->log_error("load state file failed %s", state_file_);
@@ -248,6 +291,13 @@ bool TailFile::recoverState() {
     parseStateFileLine(buf);
   }
 
+  validateState();
+
+  logger_->log_debug("load state file succeeded for %s", state_file_);
+  return true;
+}
+
+void TailFile::validateState() {
   /**
    * recover times and validate that we have paths
    */
@@ -263,12 +313,20 @@ bool TailFile::recoverState() {
       state.second.currentTailFileModificationTime_ = ((uint64_t) (sb.st_mtime) * 1000);
     }
   }
-
-  logger_->log_debug("load state file succeeded for %s", state_file_);
-  return true;
 }
 
 void TailFile::storeState() {
+  if (state_manager_ != nullptr) {
+    std::unordered_map<std::string, std::string> state;
+    for (const auto &tail_state : tail_states_) {
+      state[CURRENT_STR + tail_state.first] = tail_state.second.path_ + utils::file::FileUtils::get_separator() + tail_state.second.current_file_name_;
+      state[POSITION_STR + tail_state.first] = std::to_string(tail_state.second.currentTailFilePosition_);
+    }
+    if (!state_manager_->set(getUUIDStr(), state)) {
+      logger_->log_error("store state failed in %s", state_manager_->getName());
+    }
+    return;
+  }
   std::ofstream file(state_file_.c_str());
   if (!file.is_open()) {
     logger_->log_error("store state file failed %s", state_file_);
@@ -302,7 +360,7 @@ void TailFile::checkRollOver(TailState &file, const std::string &base_file_name)
     auto lambda = [&](const std::string& path, const std::string& filename) -> bool {
       struct stat sb;
       std::string fileFullName = path + utils::file::FileUtils::get_separator() + filename;
-      if ((fileFullName.find(pattern) != std::string::npos) && stat(fileFullName.c_str(), &sb) == 0) {
+      if ((filename.find(pattern) != std::string::npos) && stat(fileFullName.c_str(), &sb) == 0) {
         uint64_t candidateModTime = ((uint64_t) (sb.st_mtime) * 1000);
         if (candidateModTime >= file.currentTailFileModificationTime_) {
           logging::LOG_TRACE(logger_) << "File " << filename << " (short name " << file.current_file_name_ <<
@@ -338,107 +396,168 @@ void TailFile::checkRollOver(TailState &file, const std::string &base_file_name)
     }
 
     file.current_file_name_ = item.fileName;
-
-    storeState();
   } else {
     return;
   }
 }
 
 void TailFile::onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
-  std::lock_guard<std::mutex> tail_lock(tail_file_mutex_);
-  std::string st_file;
-  if (context->getProperty(StateFile.getName(), st_file)) {
-    state_file_ = st_file + "." + getUUIDStr();
+  std::vector<std::pair<std::string, TailState>> claimed;
+  {
+    std::lock_guard<std::mutex> tail_lock(tail_file_mutex_);
+    std::string st_file;
+    if (context->getProperty(StateFile.getName(), st_file)) {
+      state_file_ = st_file + "." + getUUIDStr();
+    }
+    if (!this->state_recovered_) {
+      state_recovered_ = true;
+      // recover the state if we have not done so
+      this->recoverState();
+    }
+    claimFiles(claimed);
   }
-  if (!this->state_recovered_) {
-    state_recovered_ = true;
-    // recover the state if we have not done so
-    this->recoverState();
+
+  if (claimed.empty()) {
+    logger_->log_trace("All tailed files are owned by other tasks");
+    context->yield();
+    return;
   }
 
   /**
-   * iterate over file states. may modify them
+   * tail the files owned by this task. the states are copies, so other tasks may
+   * claim the remaining files meanwhile
    */
-  for (auto &state : tail_states_) {
-    auto fileLocation = state.second.path_;
-
-    logger_->log_debug("Tailing file %s from %llu", fileLocation, state.second.currentTailFilePosition_);
-    checkRollOver(state.second, state.first);
-    std::string fullPath = fileLocation + utils::file::FileUtils::get_separator() + state.second.current_file_name_;
-    struct stat statbuf;
-
-    logger_->log_debug("Tailing file %s from %llu", fullPath, state.second.currentTailFilePosition_);
-    if (stat(fullPath.c_str(), &statbuf) == 0) {
-      if ((uint64_t) statbuf.st_size <= state.second.currentTailFilePosition_) {
-        logger_->log_trace("Current pos: %llu", state.second.currentTailFilePosition_);
-        logger_->log_trace("%s", "there are no new input for the current tail file");
-        context->yield();
-        return;
+  bool found_data = false;
+  try {
+    for (auto &state : claimed) {
+      if (tailFile(session, state.first, state.second)) {
+        found_data = true;
       }
-      std::size_t found = state.first.find_last_of(".");
-      std::string baseName = state.first.substr(0, found);
-      std::string extension = state.first.substr(found + 1);
-
-      if (!delimiter_.empty()) {
-        char delim = delimiter_.c_str()[0];
-        if (delim == '\\') {
-          if (delimiter_.size() > 1) {
-            switch (delimiter_.c_str()[1]) {
-              case 'r':
-                delim = '\r';
-                break;
-              case 't':
-                delim = '\t';
-                break;
-              case 'n':
-                delim = '\n';
-                break;
-              case '\\':
-                delim = '\\';
-                break;
-              default:
-                // previous behavior
-                break;
-            }
-          }
-        }
-        logger_->log_debug("Looking for delimiter 0x%X", delim);
-        std::vector<std::shared_ptr<FlowFileRecord>> flowFiles;
-        session->import(fullPath, flowFiles, state.second.currentTailFilePosition_, delim);
-        logger_->log_info("%u flowfiles were received from TailFile input", flowFiles.size());
-
-        for (auto ffr : flowFiles) {
-          logger_->log_info("TailFile %s for %u bytes", state.first, ffr->getSize());
-          std::string logName = baseName + "." + std::to_string(state.second.currentTailFilePosition_) + "-" + std::to_string(state.second.currentTailFilePosition_ + ffr->getSize()) + "." + extension;
-          ffr->updateKeyedAttribute(PATH, fileLocation);
-          ffr->addKeyedAttribute(ABSOLUTE_PATH, fullPath);
-          ffr->updateKeyedAttribute(FILENAME, logName);
-          session->transfer(ffr, Success);
-          state.second.currentTailFilePosition_ += ffr->getSize() + 1;
-          storeState();
-        }
+    }
+  } catch (...) {
+    releaseFiles(claimed, false);
+    throw;
+  }
+  releaseFiles(claimed, true);
+
+  if (!found_data) {
+    logger_->log_trace("%s", "there are no new input for the tailed files");
+    context->yield();
+  }
+}
+
+void TailFile::claimFiles(std::vector<std::pair<std::string, TailState>> &claimed) {
+  if (tail_states_.empty()) {
+    return;
+  }
+  // spread the files over the concurrent tasks so that each task owns a group of files
+  const size_t tasks = std::max<size_t>(1, getMaxConcurrentTasks());
+  const size_t group_size = (tail_states_.size() + tasks - 1) / tasks;
+
+  auto it = tail_states_.upper_bound(next_file_);
+  for (size_t visited = 0; visited < tail_states_.size() && claimed.size() < group_size; ++visited, ++it) {
+    if (it == tail_states_.end()) {
+      it = tail_states_.begin();
+    }
+    if (claimed_files_.insert(it->first).second) {
+      claimed.emplace_back(it->first, it->second);
+      next_file_ = it->first;
+    }
+  }
+}
+
+void TailFile::releaseFiles(const std::vector<std::pair<std::string, TailState>> &claimed, bool update) {
+  std::lock_guard<std::mutex> tail_lock(tail_file_mutex_);
+  for (const auto &state : claimed) {
+    if (update) {
+      auto it = tail_states_.find(state.first);
+      if (it != tail_states_.end()) {
+        it->second = state.second;
+      }
+    }
+    claimed_files_.erase(state.first);
+  }
+  if (update) {
+    storeState();
+  }
+}
+
+bool TailFile::tailFile(const std::shared_ptr<core::ProcessSession> &session, const std::string &base_file_name, TailState &state) {
+  auto fileLocation = state.path_;
 
-      } else {
-        std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast<FlowFileRecord>(session->create());
-        if (flowFile) {
-          flowFile->updateKeyedAttribute(PATH, fileLocation);
-          flowFile->addKeyedAttribute(ABSOLUTE_PATH, fullPath);
-          session->import(fullPath, flowFile, true, state.second.currentTailFilePosition_);
-          session->transfer(flowFile, Success);
-          logger_->log_info("TailFile %s for %llu bytes", state.first, flowFile->getSize());
-          std::string logName = baseName + "." + std::to_string(state.second.currentTailFilePosition_) + "-" + std::to_string(state.second.currentTailFilePosition_ + flowFile->getSize()) + "."
-              + extension;
-          flowFile->updateKeyedAttribute(FILENAME, logName);
-          state.second.currentTailFilePosition_ += flowFile->getSize();
-          storeState();
+  logger_->log_debug("Tailing file %s from %llu", fileLocation, state.currentTailFilePosition_);
+  checkRollOver(state, base_file_name);
+  std::string fullPath = fileLocation + utils::file::FileUtils::get_separator() + state.current_file_name_;
+  struct stat statbuf;
+
+  logger_->log_debug("Tailing file %s from %llu", fullPath, state.currentTailFilePosition_);
+  if (stat(fullPath.c_str(), &statbuf) != 0) {
+    logger_->log_warn("Unable to stat file %s", fullPath);
+    return false;
+  }
+  if ((uint64_t) statbuf.st_size <= state.currentTailFilePosition_) {
+    logger_->log_trace("Current pos: %llu", state.currentTailFilePosition_);
+    logger_->log_trace("there are no new input for %s", fullPath);
+    return false;
+  }
+  std::size_t found = base_file_name.find_last_of(".");
+  std::string baseName = base_file_name.substr(0, found);
+  std::string extension = base_file_name.substr(found + 1);
+
+  if (!delimiter_.empty()) {
+    char delim = delimiter_.c_str()[0];
+    if (delim == '\\') {
+      if (delimiter_.size() > 1) {
+        switch (delimiter_.c_str()[1]) {
+          case 'r':
+            delim = '\r';
+            break;
+          case 't':
+            delim = '\t';
+            break;
+          case 'n':
+            delim = '\n';
+            break;
+          case '\\':
+            delim = '\\';
+            break;
+          default:
+            // previous behavior
+            break;
         }
       }
-      state.second.currentTailFileModificationTime_ = ((uint64_t) (statbuf.st_mtime) * 1000);
-    } else {
-      logger_->log_warn("Unable to stat file %s", fullPath);
+    }
+    logger_->log_debug("Looking for delimiter 0x%X", delim);
+    std::vector<std::shared_ptr<FlowFileRecord>> flowFiles;
+    session->import(fullPath, flowFiles, state.currentTailFilePosition_, delim);
+    logger_->log_info("%u flowfiles were received from TailFile input", flowFiles.size());
+
+    for (auto ffr : flowFiles) {
+      logger_->log_info("TailFile %s for %u bytes", base_file_name, ffr->getSize());
+      std::string logName = baseName + "." + std::to_string(state.currentTailFilePosition_) + "-" + std::to_string(state.currentTailFilePosition_ + ffr->getSize()) + "." + extension;
+      ffr->updateKeyedAttribute(PATH, fileLocation);
+      ffr->addKeyedAttribute(ABSOLUTE_PATH, fullPath);
+      ffr->updateKeyedAttribute(FILENAME, logName);
+      session->transfer(ffr, Success);
+      state.currentTailFilePosition_ += ffr->getSize() + 1;
+    }
+
+  } else {
+    std::shared_ptr<FlowFileRecord> flowFile = std::static_pointer_cast<FlowFileRecord>(session->create());
+    if (flowFile) {
+      flowFile->updateKeyedAttribute(PATH, fileLocation);
+      flowFile->addKeyedAttribute(ABSOLUTE_PATH, fullPath);
+      session->import(fullPath, flowFile, true, state.currentTailFilePosition_);
+      session->transfer(flowFile, Success);
+      logger_->log_info("TailFile %s for %llu bytes", base_file_name, flowFile->getSize());
+      std::string logName = baseName + "." + std::to_string(state.currentTailFilePosition_) + "-" + std::to_string(state.currentTailFilePosition_ + flowFile->getSize()) + "."
+          + extension;
+      flowFile->updateKeyedAttribute(FILENAME, logName);
+      state.currentTailFilePosition_ += flowFile->getSize();
     }
   }
+  state.currentTailFileModificationTime_ = ((uint64_t) (statbuf.st_mtime) * 1000);
+  return true;
 }
 
 } /* namespace processors */
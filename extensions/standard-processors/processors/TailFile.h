@@ -20,9 +20,15 @@
 #ifndef __TAIL_FILE_H__
 #define __TAIL_FILE_H__
 
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 #include "FlowFileRecord.h"
 #include "core/Processor.h"
 #include "core/ProcessSession.h"
+#include "controllers/StateManagerService.h"
 
 #include "core/Core.h"
 #include "core/Resource.h"
@@ -71,6 +77,7 @@ class TailFile : public core::Processor {
   // Supported Properties
   static core::Property FileName;
   static core::Property StateFile;
+  static core::Property StateManager;
   static core::Property Delimiter;
   static core::Property TailMode;
   static core::Property BaseDirectory;
@@ -103,12 +110,18 @@ class TailFile : public core::Processor {
   std::mutex tail_file_mutex_;
   // File to save state
   std::string state_file_;
+  // Service storing the state instead of the state file, if configured
+  std::shared_ptr<controllers::StateManagerService> state_manager_;
   // Delimiter for the data incoming from the tailed file.
   std::string delimiter_;
   // determine if state is recovered;
   bool state_recovered_;
 
   std::map<std::string, TailState> tail_states_;
+  // files currently owned by a running task
+  std::set<std::string> claimed_files_;
+  // last file claimed, the next task continues after it
+  std::string next_file_;
 
   static const int BUFFER_SIZE = 512;
 
@@ -116,10 +129,29 @@ class TailFile : public core::Processor {
   std::string trimLeft(const std::string& s);
   std::string trimRight(const std::string& s);
   void parseStateFileLine(char *buf);
+  void parseStateValue(const std::string &key, const std::string &value);
+  bool recoverStateFromFile();
+  // recovers modification times and validates that the recovered states have paths
+  void validateState();
   /**
    * Check roll over for the provided file.
    */
   void checkRollOver(TailState &file, const std::string &base_file_name);
+  /**
+   * Claims the group of files this task tails. Must be called with tail_file_mutex_ held.
+   * @param claimed receives copies of the states of the claimed files
+   */
+  void claimFiles(std::vector<std::pair<std::string, TailState>> &claimed);
+  /**
+   * Releases files claimed by claimFiles.
+   * @param update if true, the states of the files are replaced by the claimed copies and stored
+   */
+  void releaseFiles(const std::vector<std::pair<std::string, TailState>> &claimed, bool update);
+  /**
+   * Imports the data appended to the file since the position of its state.
+   * @return true if new data was found
+   */
+  bool tailFile(const std::shared_ptr<core::ProcessSession> &session, const std::string &base_file_name, TailState &state);
   std::shared_ptr<logging::Logger> logger_;
 };
 
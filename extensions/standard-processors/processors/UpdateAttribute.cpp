@@ -30,11 +30,15 @@ namespace nifi {
 namespace minifi {
 namespace processors {
 
+core::Property UpdateAttribute::BatchSize(
+    core::PropertyBuilder::createProperty("Batch Size")->withDescription("The maximum number of FlowFiles updated in each invocation")->withDefaultValue<uint64_t>(100)->build());
+
 core::Relationship UpdateAttribute::Success("success", "All files are routed to success");
 core::Relationship UpdateAttribute::Failure("failure", "Failed files are transferred to failure");
 
 void UpdateAttribute::initialize() {
   std::set<core::Property> properties;
+  properties.insert(BatchSize);
   setSupportedProperties(properties);
 
   std::set<core::Relationship> relationships;
@@ -44,6 +48,9 @@ void UpdateAttribute::initialize() {
 }
 
 void UpdateAttribute::onSchedule(core::ProcessContext *context, core::ProcessSessionFactory *sessionFactory) {
+  if (!context->getProperty(BatchSize.getName(), batch_size_) || batch_size_ == 0) {
+    batch_size_ = 1;
+  }
   attributes_.clear();
   const auto &dynamic_prop_keys = context->getDynamicPropertyKeys();
   logger_->log_info("UpdateAttribute registering %d keys", dynamic_prop_keys.size());
@@ -55,25 +62,28 @@ void UpdateAttribute::onSchedule(core::ProcessContext *context, core::ProcessSes
 }
 
 void UpdateAttribute::onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
-  auto flow_file = session->get();
+  for (uint64_t i = 0; i < batch_size_; i++) {
+    auto flow_file = session->get();
 
-  // Do nothing if there are no incoming files
-  if (!flow_file) {
-    return;
-  }
+    // Do nothing if there are no incoming files
+    if (!flow_file) {
+      return;
+    }
 
-  try {
-    for (const auto &attribute : attributes_) {
-      std::string value;
-      context->getDynamicProperty(attribute, value, flow_file);
-      flow_file->setAttribute(attribute.getName(), value);
-      logger_->log_info("Set attribute '%s' of flow file '%s' with value '%s'", attribute.getName(), flow_file->getUUIDStr(), value);
+    try {
+      for (const auto &attribute : attributes_) {
+        std::string value;
+        context->getDynamicProperty(attribute, value, flow_file);
+        flow_file->setAttribute(attribute.getName(), value);
+        logger_->log_debug("Set attribute '%s' of flow file '%s' with value '%s'", attribute.getName(), flow_file->getUUIDStr(), value);
+      }
+      session->transfer(flow_file, Success);
+    } catch (const std::exception &e) {
+      logger_->log_error("Caught exception while updating attributes: %s", e.what());
+      session->transfer(flow_file, Failure);
+      yield();
+      return;
     }
-    session->transfer(flow_file, Success);
-  } catch (const std::exception &e) {
-    logger_->log_error("Caught exception while updating attributes: %s", e.what());
-    session->transfer(flow_file, Failure);
-    yield();
   }
 }
 
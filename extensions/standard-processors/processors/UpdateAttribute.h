@@ -38,9 +38,16 @@ class UpdateAttribute : public core::Processor {
 
   UpdateAttribute(std::string name,  utils::Identifier uuid = utils::Identifier())
       : core::Processor(name, uuid),
-        logger_(logging::LoggerFactory<UpdateAttribute>::getLogger()) {
+        logger_(logging::LoggerFactory<UpdateAttribute>::getLogger()),
+        batch_size_(100) {
   }
 
+  /**
+   * Properties
+   */
+
+  static core::Property BatchSize;
+
   /**
    * Relationships
    */
@@ -65,6 +72,7 @@ class UpdateAttribute : public core::Processor {
  private:
   std::shared_ptr<logging::Logger> logger_;
   std::vector<core::Property> attributes_;
+  uint64_t batch_size_;
 };
 
 REGISTER_RESOURCE(UpdateAttribute, "This processor updates the attributes of a FlowFile using properties that are added by the user. "
@@ -0,0 +1,299 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "TestBase.h"
+#include "core/ProcessSession.h"
+#include "ChildProcess.h"
+#include "ExecuteProcess.h"
+#include "ExecuteStreamCommand.h"
+
+namespace {
+
+std::shared_ptr<minifi::io::BaseStream> createStream(const std::string &content) {
+  auto stream = std::make_shared<minifi::io::BaseStream>();
+  stream->writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(content.data())), content.size());
+  return stream;
+}
+
+std::string toString(const std::shared_ptr<minifi::io::BaseStream> &stream) {
+  return std::string(reinterpret_cast<const char*>(stream->getBuffer()), stream->getSize());
+}
+
+/**
+ * Creates a FlowFile for every content.
+ */
+class ContentSource : public core::Processor {
+ public:
+  explicit ContentSource(std::vector<std::string> contents)
+      : core::Processor("ContentSource"),
+        contents_(std::move(contents)) {
+  }
+
+  class WriteCallback : public minifi::OutputStreamCallback {
+   public:
+    explicit WriteCallback(const std::string &content)
+        : content_(content) {
+    }
+    int64_t process(std::shared_ptr<minifi::io::BaseStream> stream) {
+      return stream->writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(content_.data())), content_.size());
+    }
+   private:
+    const std::string &content_;
+  };
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override {
+    for (const auto &content : contents_) {
+      auto flow_file = session->create();
+      WriteCallback callback(content);
+      session->write(flow_file, &callback);
+      session->putAttribute(flow_file, "content", content);
+      session->transfer(flow_file, core::Relationship("success", "description"));
+    }
+  }
+
+ private:
+  std::vector<std::string> contents_;
+};
+
+/**
+ * Keeps the content and the attributes of the FlowFiles it takes.
+ */
+class ContentSink : public core::Processor {
+ public:
+  ContentSink()
+      : core::Processor("ContentSink") {
+  }
+
+  class ReadCallback : public minifi::InputStreamCallback {
+   public:
+    explicit ReadCallback(uint64_t size)
+        : content(size, '\0') {
+    }
+    int64_t process(std::shared_ptr<minifi::io::BaseStream> stream) {
+      return content.empty() ? 0 : stream->readData(reinterpret_cast<uint8_t*>(&content[0]), content.size());
+    }
+    std::string content;
+  };
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override {
+    while (auto flow_file = session->get()) {
+      ReadCallback callback(flow_file->getSize());
+      session->read(flow_file, &callback);
+      contents.push_back(callback.content);
+      attributes.push_back(flow_file->getAttributes());
+      session->remove(flow_file);
+    }
+  }
+
+  /**
+   * @return the content of the FlowFile created from the FlowFile with the content
+   */
+  std::string find(const std::string &content) {
+    for (size_t i = 0; i < attributes.size(); i++) {
+      if (attributes[i]["content"] == content) {
+        return contents[i];
+      }
+    }
+    FAIL("No FlowFile was created from " + content);
+    return "";
+  }
+
+  std::vector<std::string> contents;
+  std::vector<std::map<std::string, std::string>> attributes;
+};
+
+struct CommandFlow {
+  std::shared_ptr<TestPlan> plan;
+  std::shared_ptr<core::Processor> processor;
+  std::shared_ptr<ContentSink> sink;
+};
+
+/**
+ * ContentSource -> ExecuteStreamCommand -> ContentSink taking output.
+ */
+CommandFlow createFlow(TestController &testController, const std::vector<std::string> &contents, const std::map<std::string, std::string> &properties, const std::string &output) {
+  CommandFlow flow;
+  flow.plan = testController.createPlan();
+  flow.plan->addProcessor(std::make_shared<ContentSource>(contents), "source");
+  flow.processor = flow.plan->addProcessor("ExecuteStreamCommand", "processor", core::Relationship("success", "description"), true);
+  for (const auto &property : properties) {
+    flow.plan->setProperty(flow.processor, property.first, property.second);
+  }
+  std::set<core::Relationship> terminated = { minifi::processors::ExecuteStreamCommand::OutputStream, minifi::processors::ExecuteStreamCommand::Original,
+      minifi::processors::ExecuteStreamCommand::NonzeroStatus };
+  terminated.erase(core::Relationship(output, ""));
+  flow.processor->setAutoTerminatedRelationships(terminated);
+  flow.sink = std::make_shared<ContentSink>();
+  flow.plan->addProcessor(flow.sink, "sink", core::Relationship(output, "description"), true);
+  return flow;
+}
+
+void runFlow(CommandFlow &flow, size_t triggers) {
+  flow.plan->runNextProcessor();  // ContentSource
+  flow.plan->runNextProcessor();  // ExecuteStreamCommand
+  for (size_t i = 1; i < triggers; i++) {
+    flow.plan->runCurrentProcessor();
+  }
+  flow.plan->runNextProcessor();  // ContentSink
+}
+
+}  // namespace
+
+TEST_CASE("ChildProcessStreamsConcurrently", "[execute1]") {
+  // more than the pipes hold, so cat blocks on its output unless it is read while writing
+  std::string content;
+  for (int i = 0; i < 100000; i++) {
+    content += "line " + std::to_string(i) + "\n";
+  }
+  minifi::processors::ChildProcess process;
+  REQUIRE(process.start({ "cat" }, "", true, false));
+  auto output = std::make_shared<minifi::io::BaseStream>();
+  REQUIRE(process.transfer(createStream(content), content.size(), true, output, 0, false) == minifi::processors::ChildProcess::Result::OUTPUT_CLOSED);
+  REQUIRE(process.getTransferredSize() == content.size());
+  REQUIRE(toString(output) == content);
+  REQUIRE(process.wait() == 0);
+}
+
+TEST_CASE("ChildProcessErrorStream", "[execute2]") {
+  REQUIRE(minifi::processors::ChildProcess::splitArguments("sh -c \"echo a  b\" x") == std::vector<std::string>({ "sh", "-c", "echo a  b", "x" }));
+
+  minifi::processors::ChildProcess process;
+  REQUIRE(process.start({ "sh", "-c", "echo out; echo err >&2; exit 3" }, "/", false, false));
+  auto output = std::make_shared<minifi::io::BaseStream>();
+  REQUIRE(process.transfer(nullptr, 0, true, output, 0, false) == minifi::processors::ChildProcess::Result::OUTPUT_CLOSED);
+  REQUIRE(toString(output) == "out\n");
+  REQUIRE(process.getError() == "err\n");
+  REQUIRE(process.wait() == 3);
+
+  minifi::processors::ChildProcess redirected;
+  REQUIRE(redirected.start({ "sh", "-c", "echo err >&2; pwd" }, "/", false, true));
+  output = std::make_shared<minifi::io::BaseStream>();
+  REQUIRE(redirected.transfer(nullptr, 0, true, output, 0, false) == minifi::processors::ChildProcess::Result::OUTPUT_CLOSED);
+  REQUIRE(toString(output) == "err\n/\n");
+  REQUIRE(redirected.wait() == 0);
+
+  minifi::processors::ChildProcess missing;
+  REQUIRE_FALSE(missing.start({ "minifi-no-such-command" }, "", false, false));
+  REQUIRE(missing.getError().find("Could not run minifi-no-such-command") == 0);
+
+  minifi::processors::ChildProcess sleeping;
+  REQUIRE(sleeping.start({ "sleep", "10" }, "", false, false));
+  REQUIRE(sleeping.transfer(nullptr, 0, true, std::make_shared<minifi::io::BaseStream>(), 100, false) == minifi::processors::ChildProcess::Result::TIMED_OUT);
+  REQUIRE(sleeping.isRunning());
+  sleeping.terminate();
+  REQUIRE_FALSE(sleeping.isRunning());
+
+  minifi::processors::ChildProcess unknown_directory;
+  REQUIRE_FALSE(unknown_directory.start({ "pwd" }, "/minifi-no-such-directory", false, false));
+}
+
+TEST_CASE("ChildProcessKilledAfterGracePeriod", "[execute7]") {
+  minifi::processors::ChildProcess process;
+  REQUIRE(process.start({ "sh", "-c", "trap '' TERM; echo ready; exec sleep 30" }, "", false, false));
+  auto output = std::make_shared<minifi::io::BaseStream>();
+  REQUIRE(process.transfer(nullptr, 0, true, output, 500, false) == minifi::processors::ChildProcess::Result::TIMED_OUT);
+  REQUIRE(toString(output) == "ready\n");
+  const auto start = std::chrono::steady_clock::now();
+  process.terminate();
+  REQUIRE_FALSE(process.isRunning());
+  REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+}
+
+TEST_CASE("ChildProcessLineMode", "[execute3]") {
+  minifi::processors::ChildProcess process;
+  REQUIRE(process.start({ "sed", "-u", "s/a/b/" }, "", true, false));
+  for (const auto &lines : std::vector<std::pair<std::string, std::string>> { { "a1\na2", "b1\nb2\n" }, { "a3\n", "b3\n" }, { "", "" } }) {
+    auto output = std::make_shared<minifi::io::BaseStream>();
+    REQUIRE(process.transfer(createStream(lines.first), lines.first.size(), false, output, 5000, true) == minifi::processors::ChildProcess::Result::LINES_READ);
+    REQUIRE(toString(output) == lines.second);
+  }
+  REQUIRE(process.isRunning());
+  REQUIRE(process.wait() == 0);
+}
+
+TEST_CASE("ExecuteStreamCommand", "[execute4]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<minifi::processors::ExecuteStreamCommand>();
+
+  auto flow = createFlow(testController, { "abc", "", "line\nfeed\n" }, { { "Command Path", "tr" }, { "Command Arguments", "a-z;A-Z" } }, "output stream");
+  runFlow(flow, 3);
+  REQUIRE(flow.sink->contents.size() == 3);
+  REQUIRE(flow.sink->find("abc") == "ABC");
+  REQUIRE(flow.sink->find("") == "");
+  REQUIRE(flow.sink->find("line\nfeed\n") == "LINE\nFEED\n");
+  REQUIRE(flow.sink->attributes[0]["execution.command"] == "tr");
+  REQUIRE(flow.sink->attributes[0]["execution.command.args"] == "a-z;A-Z");
+  REQUIRE(flow.sink->attributes[0]["execution.status"] == "0");
+
+  auto failing = createFlow(testController, { "abc" }, { { "Command Path", "sh" }, { "Argument Delimiter", "" }, { "Command Arguments", "-c \"cat; echo failed >&2; exit 2\"" } },
+                            "nonzero status");
+  runFlow(failing, 1);
+  REQUIRE(failing.sink->contents == std::vector<std::string>({ "abc" }));
+  REQUIRE(failing.sink->attributes[0]["execution.status"] == "2");
+  REQUIRE(failing.sink->attributes[0]["execution.error"] == "failed\n");
+
+  auto original = createFlow(testController, { "abc" }, { { "Command Path", "true" } }, "original");
+  runFlow(original, 1);
+  REQUIRE(original.sink->contents == std::vector<std::string>({ "abc" }));
+  REQUIRE(original.sink->attributes[0]["execution.status"] == "0");
+}
+
+TEST_CASE("ExecuteStreamCommandKeepProcessRunning", "[execute5]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<minifi::processors::ExecuteStreamCommand>();
+
+  auto flow = createFlow(testController, { "a1\na2", "a3", "x" }, { { "Command Path", "sed" }, { "Command Arguments", "-u;s/a/b/" }, { "Keep Process Running", "true" } },
+                         "output stream");
+  runFlow(flow, 3);
+  REQUIRE(flow.sink->contents.size() == 3);
+  REQUIRE(flow.sink->find("a1\na2") == "b1\nb2\n");
+  REQUIRE(flow.sink->find("a3") == "b3\n");
+  REQUIRE(flow.sink->find("x") == "x\n");
+
+  // the process does not answer every line, so it is terminated after the timeout
+  auto silent = createFlow(testController, { "a" }, { { "Command Path", "sed" }, { "Command Arguments", "-n;s/b/c/p" }, { "Keep Process Running", "true" }, { "Response Timeout",
+      "200 ms" } }, "nonzero status");
+  runFlow(silent, 1);
+  REQUIRE(silent.sink->contents == std::vector<std::string>({ "" }));
+  REQUIRE(silent.sink->attributes[0]["execution.status"] == "-1");
+  REQUIRE(silent.sink->attributes[0]["execution.error"] == "the command timed out: ");
+}
+
+TEST_CASE("ExecuteProcess", "[execute6]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<minifi::processors::ExecuteProcess>();
+
+  auto plan = testController.createPlan();
+  auto processor = plan->addProcessor("ExecuteProcess", "processor");
+  plan->setProperty(processor, "Command", "sh");
+  plan->setProperty(processor, "Command Arguments", "-c \"head -c 100000 /dev/zero; pwd; echo error >&2\"");
+  plan->setProperty(processor, "Working Directory", "/");
+  auto sink = std::make_shared<ContentSink>();
+  plan->addProcessor(sink, "sink", core::Relationship("success", "description"), true);
+  plan->runNextProcessor();
+  plan->runNextProcessor();
+  REQUIRE(sink->contents == std::vector<std::string>({ std::string(100000, '\0') + "/\n" }));
+  REQUIRE(sink->attributes[0]["command"] == "sh");
+  REQUIRE(LogTestController::getInstance().contains("error stream: error"));
+}
@@ -115,12 +115,13 @@ TEST_CASE("Test Dependent", "[dependent]") {
   REQUIRE(proc_0.children.size() > 0);
   const auto &prop_descriptors = proc_0.children[0];
   REQUIRE(prop_descriptors.children.size() > 0);
-  const auto &prop_0 = prop_descriptors.children[1];
+  // properties are sorted by name: Batch Size, Conflict Resolution Strategy, Create Missing Directories, Directory, ...
+  const auto &prop_0 = prop_descriptors.children[2];
   REQUIRE(prop_0.children.size() >= 3);
   REQUIRE("required" == prop_0.children[3].name);
   REQUIRE("expressionLanguageScope" == prop_0.children[4].name);
   REQUIRE("defaultValue" == prop_0.children[5].name);
-  const auto &prop_0_dependent_0 = prop_descriptors.children[2];
+  const auto &prop_0_dependent_0 = prop_descriptors.children[3];
   REQUIRE("Directory" == prop_0_dependent_0.name);
 #endif
 }
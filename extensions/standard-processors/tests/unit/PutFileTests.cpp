@@ -23,6 +23,8 @@
 #include <vector>
 #include <set>
 #include <fstream>
+#include <chrono>
+#include <iostream>
 
 
 #include "utils/file/FileUtils.h"
@@ -30,6 +32,7 @@
 #include "processors/LogAttribute.h"
 #include "processors/GetFile.h"
 #include "processors/PutFile.h"
+#include "processors/GenerateFlowFile.h"
 #include "unit/ProvenanceTestHelper.h"
 #include "core/Core.h"
 #include "core/FlowFile.h"
@@ -392,3 +395,125 @@ TEST_CASE("PutFileMaxFileCountTest", "[getfileputpfilemaxcount]") {
 
   LogTestController::getInstance().reset();
 }
+
+namespace {
+
+// Counts the files in dir, temporary files included
+size_t countFiles(const std::string &dir, size_t *hidden = nullptr) {
+  size_t count = 0;
+  utils::file::FileUtils::list_dir(dir, [&](const std::string&, const std::string &filename) {
+    count++;
+    if (hidden != nullptr && filename[0] == '.') {
+      (*hidden)++;
+    }
+    return true;
+  }, logging::LoggerFactory<minifi::processors::PutFile>::getLogger(), false);
+  return count;
+}
+
+std::shared_ptr<TestPlan> createGenerateAndPutPlan(TestController &testController, const std::string &putfiledir, size_t count, std::shared_ptr<core::Processor> &putfile) {
+  std::shared_ptr<TestPlan> plan = testController.createPlan();
+  std::shared_ptr<core::Processor> generate = plan->addProcessor("GenerateFlowFile", "generate");
+  putfile = plan->addProcessor("PutFile", "putfile", core::Relationship("success", "description"), true);
+  plan->setProperty(generate, org::apache::nifi::minifi::processors::GenerateFlowFile::BatchSize.getName(), std::to_string(count));
+  plan->setProperty(generate, org::apache::nifi::minifi::processors::GenerateFlowFile::FileSize.getName(), "1 kB");
+  plan->setProperty(putfile, org::apache::nifi::minifi::processors::PutFile::Directory.getName(), putfiledir);
+  return plan;
+}
+
+}  // namespace
+
+TEST_CASE("PutFileBatchMaxFileCountTest", "[putfilebatch]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<minifi::processors::PutFile>();
+
+  char format[] = "/tmp/ft.XXXXXX";
+  auto putfiledir = testController.createTempDirectory(format);
+  std::shared_ptr<core::Processor> putfile;
+  auto plan = createGenerateAndPutPlan(testController, putfiledir, 5, putfile);
+  plan->setProperty(putfile, org::apache::nifi::minifi::processors::PutFile::MaxDestFiles.getName(), "3");
+  putfile->setAutoTerminatedRelationships({ minifi::processors::PutFile::Failure });
+
+  // all five FlowFiles are handled by one trigger, the count is kept up to date between them
+  plan->runNextProcessor();
+  plan->runNextProcessor();
+
+  REQUIRE(3 == countFiles(putfiledir));
+  REQUIRE(LogTestController::getInstance().contains("which exceeds the configured max number of files"));
+  LogTestController::getInstance().reset();
+}
+
+TEST_CASE("PutFileDurabilityTest", "[putfilebatch]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<minifi::processors::PutFile>();
+
+  for (const std::string durability : { minifi::processors::PutFile::DURABILITY_FILE, minifi::processors::PutFile::DURABILITY_BATCH }) {
+    char format[] = "/tmp/ft.XXXXXX";
+    auto putfiledir = testController.createTempDirectory(format);
+    std::shared_ptr<core::Processor> putfile;
+    auto plan = createGenerateAndPutPlan(testController, putfiledir, 20, putfile);
+    plan->setProperty(putfile, org::apache::nifi::minifi::processors::PutFile::Durability.getName(), durability);
+
+    plan->runNextProcessor();
+    plan->runNextProcessor();
+
+    size_t hidden = 0;
+    REQUIRE(20 == countFiles(putfiledir, &hidden));
+    REQUIRE(0 == hidden);
+  }
+  REQUIRE_FALSE(LogTestController::getInstance().contains("could not sync", std::chrono::seconds(0)));
+  LogTestController::getInstance().reset();
+}
+
+TEST_CASE("PutFileReplacedDirectoryTest", "[putfilebatch]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<minifi::processors::PutFile>();
+
+  char format[] = "/tmp/ft.XXXXXX";
+  auto putfiledir = testController.createTempDirectory(format);
+  const std::string outdir = putfiledir + utils::file::FileUtils::get_separator() + "out";
+  const std::string moved = putfiledir + utils::file::FileUtils::get_separator() + "moved";
+  std::shared_ptr<core::Processor> putfile;
+  auto plan = createGenerateAndPutPlan(testController, outdir, 2, putfile);
+
+  plan->runNextProcessor();
+  plan->runNextProcessor();
+  REQUIRE(2 == countFiles(outdir));
+
+  // the cached handle still refers to the moved directory, the next batch notices and opens the new one
+  REQUIRE(0 == rename(outdir.c_str(), moved.c_str()));
+  plan->reset();
+  plan->runNextProcessor();
+  plan->runNextProcessor();
+  REQUIRE(2 == countFiles(outdir));
+  REQUIRE(2 == countFiles(moved));
+  LogTestController::getInstance().reset();
+}
+
+TEST_CASE("PutFileBatchThroughput", "[putfilebatch][.][benchmark]") {
+  TestController testController;
+  LogTestController::getInstance().setWarn<minifi::processors::PutFile>();
+
+  const size_t count = 2000;
+  for (const std::string durability : { minifi::processors::PutFile::DURABILITY_NONE, minifi::processors::PutFile::DURABILITY_FILE, minifi::processors::PutFile::DURABILITY_BATCH }) {
+    char format[] = "/tmp/ft.XXXXXX";
+    auto putfiledir = testController.createTempDirectory(format);
+    std::shared_ptr<core::Processor> putfile;
+    auto plan = createGenerateAndPutPlan(testController, putfiledir, count, putfile);
+    plan->setProperty(putfile, org::apache::nifi::minifi::processors::PutFile::Durability.getName(), durability);
+    plan->setProperty(putfile, org::apache::nifi::minifi::processors::PutFile::BatchSize.getName(), "100");
+
+    plan->runNextProcessor();
+    auto start = std::chrono::steady_clock::now();
+    plan->runNextProcessor();
+    for (size_t batch = 1; batch < count / 100; batch++) {
+      plan->runCurrentProcessor();
+    }
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    REQUIRE(count == countFiles(putfiledir));
+    std::cout << "PutFile with durability " << durability << ": " << count << " files in " << micros / 1000 << " ms, "
+              << (micros > 0 ? count * 1000000 / micros : count) << " files/s" << std::endl;
+  }
+  LogTestController::getInstance().reset();
+}
@@ -0,0 +1,392 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "TestBase.h"
+#include "core/ProcessSession.h"
+#include "controllers/CSVReader.h"
+#include "controllers/CSVRecordSetWriter.h"
+#include "controllers/JsonLinesReader.h"
+#include "controllers/JsonLinesRecordSetWriter.h"
+#include "ConvertRecord.h"
+#include "FilterRecord.h"
+#include "MergeRecord.h"
+#include "SplitRecord.h"
+
+namespace {
+
+const char *CSV = "id,name,temperature\n"
+    "1,pump,21.5\n"
+    "2,\"valve, \"\"north\"\"\",19\r\n"
+    "3,\"multi\nline\",\n"
+    "\n"
+    "4,fan";
+
+template<typename T>
+std::shared_ptr<T> createService(const std::map<std::string, std::string> &properties) {
+  auto service = std::make_shared<T>("service");
+  service->initialize();
+  for (const auto &property : properties) {
+    REQUIRE(service->setProperty(property.first, property.second));
+  }
+  service->onEnable();
+  return service;
+}
+
+std::shared_ptr<minifi::io::BaseStream> createStream(const std::string &content) {
+  auto stream = std::make_shared<minifi::io::BaseStream>();
+  stream->writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(content.data())), content.size());
+  return stream;
+}
+
+std::string toString(const std::shared_ptr<minifi::io::BaseStream> &stream) {
+  return std::string(reinterpret_cast<const char*>(stream->getBuffer()), stream->getSize());
+}
+
+/**
+ * Reads the content with the reader and writes the records with the writer.
+ * @return the written content, or the error of the reader
+ */
+std::string convert(const std::shared_ptr<minifi::controllers::RecordReaderFactory> &reader_factory, const std::shared_ptr<minifi::controllers::RecordSetWriterFactory> &writer_factory,
+                    const std::string &content) {
+  auto reader = reader_factory->createRecordReader(createStream(content), content.size());
+  auto output = std::make_shared<minifi::io::BaseStream>();
+  auto writer = writer_factory->createRecordSetWriter(output);
+  minifi::controllers::Record record;
+  while (reader->read(record)) {
+    REQUIRE(writer->write(record));
+  }
+  REQUIRE(writer->finish());
+  return reader->getError().empty() ? toString(output) : reader->getError();
+}
+
+/**
+ * Creates a FlowFile for every content.
+ */
+class ContentSource : public core::Processor {
+ public:
+  explicit ContentSource(std::vector<std::string> contents)
+      : core::Processor("ContentSource"),
+        contents_(std::move(contents)) {
+  }
+
+  class WriteCallback : public minifi::OutputStreamCallback {
+   public:
+    explicit WriteCallback(const std::string &content)
+        : content_(content) {
+    }
+    int64_t process(std::shared_ptr<minifi::io::BaseStream> stream) {
+      return stream->writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(content_.data())), content_.size());
+    }
+   private:
+    const std::string &content_;
+  };
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override {
+    for (const auto &content : contents_) {
+      auto flow_file = session->create();
+      WriteCallback callback(content);
+      session->write(flow_file, &callback);
+      session->transfer(flow_file, core::Relationship("success", "description"));
+    }
+  }
+
+ private:
+  std::vector<std::string> contents_;
+};
+
+/**
+ * Keeps the content and the attributes of the FlowFiles it takes.
+ */
+class ContentSink : public core::Processor {
+ public:
+  ContentSink()
+      : core::Processor("ContentSink") {
+  }
+
+  class ReadCallback : public minifi::InputStreamCallback {
+   public:
+    explicit ReadCallback(uint64_t size)
+        : content(size, '\0') {
+    }
+    int64_t process(std::shared_ptr<minifi::io::BaseStream> stream) {
+      return content.empty() ? 0 : stream->readData(reinterpret_cast<uint8_t*>(&content[0]), content.size());
+    }
+    std::string content;
+  };
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override {
+    while (auto flow_file = session->get()) {
+      ReadCallback callback(flow_file->getSize());
+      session->read(flow_file, &callback);
+      contents.push_back(callback.content);
+      attributes.push_back(flow_file->getAttributes());
+      session->remove(flow_file);
+    }
+  }
+
+  /**
+   * @return the index of the FlowFile with the attribute value
+   */
+  size_t find(const std::string &attribute, const std::string &value) {
+    for (size_t i = 0; i < attributes.size(); i++) {
+      if (attributes[i][attribute] == value) {
+        return i;
+      }
+    }
+    FAIL("No FlowFile has " + attribute + " " + value);
+    return 0;
+  }
+
+  // in the order of the FlowFile UUIDs, which sessions transfer FlowFiles in
+  std::vector<std::string> contents;
+  std::vector<std::map<std::string, std::string>> attributes;
+};
+
+struct RecordFlow {
+  std::shared_ptr<TestPlan> plan;
+  std::shared_ptr<core::Processor> processor;
+  std::shared_ptr<ContentSink> sink;
+};
+
+/**
+ * ContentSource -> processor with a CSVReader and a JsonLinesRecordSetWriter -> ContentSink taking output.
+ */
+RecordFlow createFlow(TestController &testController, const std::vector<std::string> &contents, const std::string &processor, const std::string &output,
+                      const std::set<core::Relationship> &terminated) {
+  RecordFlow flow;
+  flow.plan = testController.createPlan();
+  flow.plan->addController("CSVReader", "reader");
+  flow.plan->addController("JsonLinesRecordSetWriter", "writer");
+  flow.plan->addProcessor(std::make_shared<ContentSource>(contents), "source");
+  flow.processor = flow.plan->addProcessor(processor, "processor", core::Relationship("success", "description"), true);
+  flow.plan->setProperty(flow.processor, "Record Reader", "reader");
+  flow.plan->setProperty(flow.processor, "Record Writer", "writer");
+  flow.processor->setAutoTerminatedRelationships(terminated);
+  flow.sink = std::make_shared<ContentSink>();
+  flow.plan->addProcessor(flow.sink, "sink", core::Relationship(output, "description"), true);
+  return flow;
+}
+
+void runFlow(RecordFlow &flow, size_t triggers = 1) {
+  flow.plan->runNextProcessor();  // ContentSource
+  flow.plan->runNextProcessor();  // processor
+  for (size_t i = 1; i < triggers; i++) {
+    flow.plan->runCurrentProcessor();
+  }
+  flow.plan->runNextProcessor();  // ContentSink
+}
+
+}  // namespace
+
+TEST_CASE("CSVToJsonLines", "[records1]") {
+  auto csv_reader = createService<minifi::controllers::CSVReader>({});
+  auto json_writer = createService<minifi::controllers::JsonLinesRecordSetWriter>({});
+  REQUIRE(convert(csv_reader, json_writer, CSV) == "{\"id\":\"1\",\"name\":\"pump\",\"temperature\":\"21.5\"}\n"
+          "{\"id\":\"2\",\"name\":\"valve, \\\"north\\\"\",\"temperature\":\"19\"}\n"
+          "{\"id\":\"3\",\"name\":\"multi\\nline\",\"temperature\":\"\"}\n"
+          "{\"id\":\"4\",\"name\":\"fan\",\"temperature\":null}\n");
+
+  auto suppressing_writer = createService<minifi::controllers::JsonLinesRecordSetWriter>({ { "Suppress Null Values", "true" } });
+  REQUIRE(convert(csv_reader, suppressing_writer, "a,b\n1\n") == "{\"a\":\"1\"}\n");
+
+  auto headless_reader = createService<minifi::controllers::CSVReader>({ { "Treat First Line as Header", "false" }, { "Value Separator", "\\t" } });
+  REQUIRE(convert(headless_reader, json_writer, "x\ty\nz\n") == "{\"field_0\":\"x\",\"field_1\":\"y\"}\n{\"field_0\":\"z\",\"field_1\":null}\n");
+}
+
+TEST_CASE("JsonLinesToCSV", "[records2]") {
+  auto json_reader = createService<minifi::controllers::JsonLinesReader>({});
+  auto csv_writer = createService<minifi::controllers::CSVRecordSetWriter>({});
+  const std::string json = "{\"id\": 1, \"name\": \"pump\", \"on\": true, \"tags\": [\"a\", {\"b\": 2.5e1}]}\n"
+      "\n"
+      "  {\"name\": \"fan\\u0021\", \"id\": -2, \"extra\": null}\r\n"
+      "{\"id\":3,\"name\":\"a,b\",\"on\":false,\"tags\":null}";
+  REQUIRE(convert(json_reader, csv_writer, json) == "id,name,on,tags\n"
+          "1,pump,true,\"[\"\"a\"\",{\"\"b\"\":2.5e1}]\"\n"
+          "-2,fan!,,\n"
+          "3,\"a,b\",false,\n");
+
+  // types read from JSON survive the round trip
+  auto json_writer = createService<minifi::controllers::JsonLinesRecordSetWriter>({});
+  REQUIRE(convert(json_reader, json_writer, json) == "{\"id\":1,\"name\":\"pump\",\"on\":true,\"tags\":[\"a\",{\"b\":2.5e1}]}\n"
+          "{\"name\":\"fan!\",\"id\":-2,\"extra\":null}\n"
+          "{\"id\":3,\"name\":\"a,b\",\"on\":false,\"tags\":null}\n");
+
+  auto semicolon_writer = createService<minifi::controllers::CSVRecordSetWriter>({ { "Value Separator", ";" }, { "Include Header Line", "false" } });
+  REQUIRE(convert(json_reader, semicolon_writer, "{\"a\":\"x;y\",\"b\":\"z\"}") == "\"x;y\";z\n");
+}
+
+TEST_CASE("MalformedRecords", "[records3]") {
+  auto csv_reader = createService<minifi::controllers::CSVReader>({});
+  auto json_reader = createService<minifi::controllers::JsonLinesReader>({});
+  auto json_writer = createService<minifi::controllers::JsonLinesRecordSetWriter>({});
+  REQUIRE(convert(csv_reader, json_writer, "a,b\n1,2,3\n") == "Record 1 has 3 values but the header names 2 fields");
+  REQUIRE(convert(csv_reader, json_writer, "a,b\n1,\"2\n") == "Record 1 has a quoted value without closing quote");
+  REQUIRE(convert(csv_reader, json_writer, "a,b\n\"1\"x,2\n") == "Record 1 has characters between a closing quote and the next separator");
+  REQUIRE(convert(json_reader, json_writer, "{\"a\":1}\n[1,2]\n") == "Record 2 is not a JSON object");
+  REQUIRE(convert(json_reader, json_writer, "{\"a\":1}\n{\"a\":}\n").find("Record 2 is invalid JSON") == 0);
+}
+
+TEST_CASE("RecordsLargerThanTheReadBuffer", "[records4]") {
+  auto csv_reader = createService<minifi::controllers::CSVReader>({});
+  auto csv_writer = createService<minifi::controllers::CSVRecordSetWriter>({});
+  std::string csv = "a,b\n";
+  for (int i = 0; i < 3; i++) {
+    csv += std::to_string(i) + ",\"" + std::string(100 * 1024, 'x') + "\n\"\"" + "\"\n";
+  }
+  REQUIRE(convert(csv_reader, csv_writer, csv) == csv);
+}
+
+TEST_CASE("ConvertRecord", "[records5]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<minifi::processors::ConvertRecord>();
+  auto flow = createFlow(testController, { CSV, "id\n", "id\n\"1\n" }, "ConvertRecord", "success", { core::Relationship("failure", "description") });
+  runFlow(flow, 3);
+  REQUIRE(2 == flow.sink->contents.size());
+  const size_t converted = flow.sink->find("record.count", "4");
+  REQUIRE(4 == std::count(flow.sink->contents[converted].begin(), flow.sink->contents[converted].end(), '\n'));
+  REQUIRE("application/json" == flow.sink->attributes[converted]["mime.type"]);
+  const size_t empty = flow.sink->find("record.count", "0");
+  REQUIRE(flow.sink->contents[empty].empty());
+  REQUIRE(LogTestController::getInstance().contains("has a quoted value without closing quote"));
+}
+
+TEST_CASE("FilterRecord", "[records6]") {
+  TestController testController;
+  std::string csv = "id,value\n";
+  for (int i = 0; i < 100; i++) {
+    csv += std::to_string(i) + "," + std::to_string(i % 10) + "\n";
+  }
+  const std::map<std::string, size_t> expected = { { "equals", 10 }, { "not equals", 90 }, { "contains", 19 }, { "matches", 20 }, { "less than", 70 }, { "greater than", 20 } };
+  for (const auto &comparison : expected) {
+    auto flow = createFlow(testController, { csv }, "FilterRecord", "success", { core::Relationship("original", "description"), core::Relationship("failure", "description") });
+    flow.plan->setProperty(flow.processor, minifi::processors::FilterRecord::Operator.getName(), comparison.first);
+    if (comparison.first == "contains") {
+      flow.plan->setProperty(flow.processor, minifi::processors::FilterRecord::FieldName.getName(), "id");
+      flow.plan->setProperty(flow.processor, minifi::processors::FilterRecord::Value.getName(), "7");
+    } else {
+      flow.plan->setProperty(flow.processor, minifi::processors::FilterRecord::FieldName.getName(), "value");
+      flow.plan->setProperty(flow.processor, minifi::processors::FilterRecord::Value.getName(), comparison.first == "matches" ? "[18]" : "7");
+    }
+    runFlow(flow);
+    REQUIRE(1 == flow.sink->contents.size());
+    REQUIRE(std::to_string(comparison.second) == flow.sink->attributes[0]["record.count"]);
+  }
+
+  auto flow = createFlow(testController, { csv }, "FilterRecord", "success", { core::Relationship("original", "description"), core::Relationship("failure", "description") });
+  flow.plan->setProperty(flow.processor, minifi::processors::FilterRecord::FieldName.getName(), "missing");
+  flow.plan->setProperty(flow.processor, minifi::processors::FilterRecord::Value.getName(), "7");
+  flow.plan->setProperty(flow.processor, minifi::processors::FilterRecord::IncludeZeroRecordFlowFiles.getName(), "false");
+  runFlow(flow);
+  REQUIRE(flow.sink->contents.empty());
+}
+
+TEST_CASE("SplitRecord", "[records7]") {
+  TestController testController;
+  auto flow = createFlow(testController, { CSV }, "SplitRecord", "splits", { core::Relationship("original", "description"), core::Relationship("failure", "description") });
+  flow.plan->setProperty(flow.processor, minifi::processors::SplitRecord::RecordsPerSplit.getName(), "3");
+  runFlow(flow);
+  REQUIRE(2 == flow.sink->contents.size());
+  const size_t first = flow.sink->find("fragment.index", "0");
+  const size_t second = flow.sink->find("fragment.index", "1");
+  REQUIRE("3" == flow.sink->attributes[first]["record.count"]);
+  REQUIRE("2" == flow.sink->attributes[first]["fragment.count"]);
+  REQUIRE(flow.sink->contents[second] == "{\"id\":\"4\",\"name\":\"fan\",\"temperature\":null}\n");
+  REQUIRE("1" == flow.sink->attributes[second]["record.count"]);
+  REQUIRE(flow.sink->attributes[first]["fragment.identifier"] == flow.sink->attributes[second]["fragment.identifier"]);
+}
+
+TEST_CASE("MergeRecord", "[records8]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<minifi::processors::MergeRecord>();
+  std::vector<std::string> contents;
+  for (int i = 0; i < 10; i++) {
+    contents.push_back("id\n" + std::to_string(2 * i) + "\n" + std::to_string(2 * i + 1) + "\n");
+  }
+  contents.insert(contents.begin() + 3, "id\n\"");
+  auto flow = createFlow(testController, contents, "MergeRecord", "merged", { core::Relationship("original", "description"), core::Relationship("failure", "description") });
+  flow.plan->setProperty(flow.processor, minifi::processors::MergeRecord::TargetNumberOfRecords.getName(), "5");
+  runFlow(flow);
+  // 2 records per FlowFile, so every merged FlowFile takes three of them
+  REQUIRE(4 == flow.sink->contents.size());
+  std::multiset<std::string> record_counts;
+  std::vector<std::string> records;
+  for (size_t i = 0; i < flow.sink->contents.size(); i++) {
+    record_counts.insert(flow.sink->attributes[i]["record.count"]);
+    std::stringstream content(flow.sink->contents[i]);
+    std::string line;
+    while (std::getline(content, line)) {
+      records.push_back(line);
+    }
+  }
+  REQUIRE((std::multiset<std::string> { "2", "6", "6", "6" } == record_counts));
+  std::vector<std::string> expected;
+  for (int i = 0; i < 20; i++) {
+    expected.push_back("{\"id\":\"" + std::to_string(i) + "\"}");
+  }
+  std::sort(records.begin(), records.end());
+  std::sort(expected.begin(), expected.end());
+  REQUIRE(expected == records);
+  REQUIRE(LogTestController::getInstance().contains("quoted value without closing quote"));
+}
+
+TEST_CASE("RecordBenchmark", "[records9][.][benchmark]") {
+  const size_t count = 200000;
+  std::stringstream csv;
+  std::stringstream json;
+  csv << "id,sensor,value,status\n";
+  for (size_t i = 0; i < count; i++) {
+    csv << i << ",sensor-" << i % 100 << "," << i * 0.25 << ",\"ok, " << i % 7 << "\"\n";
+    json << "{\"id\":" << i << ",\"sensor\":\"sensor-" << i % 100 << "\",\"value\":" << i * 0.25 << ",\"status\":\"ok, " << i % 7 << "\"}\n";
+  }
+
+  auto csv_reader = createService<minifi::controllers::CSVReader>({});
+  auto json_reader = createService<minifi::controllers::JsonLinesReader>({});
+  auto csv_writer = createService<minifi::controllers::CSVRecordSetWriter>({});
+  auto json_writer = createService<minifi::controllers::JsonLinesRecordSetWriter>({});
+  const std::vector<std::pair<std::string, std::pair<std::shared_ptr<minifi::controllers::RecordReaderFactory>, std::string>>> inputs = { { "CSV", { csv_reader, csv.str() } }, { "JSON Lines", {
+      json_reader, json.str() } } };
+  for (const auto &input : inputs) {
+    auto start = std::chrono::steady_clock::now();
+    auto reader = input.second.first->createRecordReader(createStream(input.second.second), input.second.second.size());
+    minifi::controllers::Record record;
+    while (reader->read(record)) {
+    }
+    REQUIRE(reader->getError().empty());
+    REQUIRE(count == reader->getRecordCount());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "read " << input.first << ": " << count / seconds << " records/s, " << input.second.second.size() / seconds / (1024 * 1024) << " MB/s" << std::endl;
+
+    for (const auto &writer : { std::make_pair(std::string("CSV"), std::static_pointer_cast<minifi::controllers::RecordSetWriterFactory>(csv_writer)), std::make_pair(std::string("JSON Lines"),
+        std::static_pointer_cast<minifi::controllers::RecordSetWriterFactory>(json_writer)) }) {
+      start = std::chrono::steady_clock::now();
+      convert(input.second.first, writer.second, input.second.second);
+      seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      std::cout << "convert " << input.first << " to " << writer.first << ": " << count / seconds << " records/s" << std::endl;
+    }
+  }
+}
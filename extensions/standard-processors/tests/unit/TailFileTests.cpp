@@ -25,6 +25,7 @@
 #include <string>
 #include <iostream>
 #include <set>
+#include <unordered_map>
 #include <algorithm>
 #include <random>
 #include <cstdlib>
@@ -40,6 +41,7 @@
 #include "core/ProcessorNode.h"
 #include "TailFile.h"
 #include "LogAttribute.h"
+#include "controllers/VolatileStateManagerService.h"
 
 static std::string NEWLINE_FILE = ""  // NOLINT
         "one,two,three\n"
@@ -727,3 +729,124 @@ TEST_CASE("TailFileWithMultileRolledOverFiles", "[tailfiletest2]") {
 
   REQUIRE(LogTestController::getInstance().contains(std::string("Logged 2 flow files")));
 }
+
+TEST_CASE("TailFileWithStateManager", "[tailfiletest3]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<processors::TailFile>();
+  LogTestController::getInstance().setTrace<processors::LogAttribute>();
+  auto plan = testController.createPlan();
+
+  char format[] = "/tmp/gt.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+
+  std::stringstream temp_file;
+  temp_file << dir << utils::file::FileUtils::get_separator() << TMP_FILE;
+  std::ofstream tmpfile(temp_file.str());
+  tmpfile << NEWLINE_FILE;
+  tmpfile.close();
+
+  std::stringstream state_file;
+  state_file << dir << utils::file::FileUtils::get_separator() << STATE_FILE;
+
+  auto state_manager_node = plan->addController("VolatileStateManagerService", "statemanager");
+  REQUIRE(nullptr != state_manager_node);
+  auto state_manager = std::dynamic_pointer_cast<minifi::controllers::StateManagerService>(state_manager_node->getControllerServiceImplementation());
+  REQUIRE(nullptr != state_manager);
+
+  auto tail_file = plan->addProcessor("TailFile", "Tail");
+  plan->setProperty(tail_file, processors::TailFile::FileName.getName(), temp_file.str());
+  plan->setProperty(tail_file, processors::TailFile::StateFile.getName(), state_file.str());
+  plan->setProperty(tail_file, processors::TailFile::StateManager.getName(), "statemanager");
+  plan->setProperty(tail_file, processors::TailFile::Delimiter.getName(), "\n");
+  auto log_attr = plan->addProcessor("LogAttribute", "Log", core::Relationship("success", "description"), true);
+
+  SECTION("state is stored in the state manager") {
+    plan->runNextProcessor();  // Tail
+    plan->runNextProcessor();  // Log
+    REQUIRE(LogTestController::getInstance().contains("Logged 1 flow files"));
+
+    std::unordered_map<std::string, std::string> state;
+    REQUIRE(state_manager->get(tail_file->getUUIDStr(), state));
+    REQUIRE(std::to_string(NEWLINE_FILE.find_first_of('\n') + 1) == state["POSITION." + std::string(TMP_FILE)]);
+    REQUIRE(temp_file.str() == state["CURRENT." + std::string(TMP_FILE)]);
+    std::ifstream legacy_state(state_file.str() + "." + tail_file->getUUIDStr());
+    REQUIRE(false == legacy_state.good());
+  }
+
+  SECTION("the state of a previous state file is moved to the state manager") {
+    std::ofstream legacy_state(state_file.str() + "." + tail_file->getUUIDStr());
+    legacy_state << "FILENAME=" << temp_file.str() << "\n";
+    legacy_state << "POSITION=" << NEWLINE_FILE.find_first_of('\n') + 1 << "\n";
+    legacy_state.close();
+
+    std::ofstream append_stream(temp_file.str(), std::ios_base::app);
+    append_stream << "\n";
+    append_stream.close();
+
+    plan->runNextProcessor();  // Tail
+    plan->runNextProcessor();  // Log
+    REQUIRE(LogTestController::getInstance().contains("minifi-tmpfile.14-34.txt"));
+
+    std::unordered_map<std::string, std::string> state;
+    REQUIRE(state_manager->get(tail_file->getUUIDStr(), state));
+    REQUIRE("35" == state["POSITION." + std::string(TMP_FILE)]);
+    std::ifstream removed_state(state_file.str() + "." + tail_file->getUUIDStr());
+    REQUIRE(false == removed_state.good());
+  }
+
+  LogTestController::getInstance().reset();
+}
+
+TEST_CASE("TailFileMultipleFilesSharedByTasks", "[tailfiletest4]") {
+  TestController testController;
+  LogTestController::getInstance().setTrace<processors::TailFile>();
+  LogTestController::getInstance().setTrace<processors::LogAttribute>();
+  auto plan = testController.createPlan();
+
+  char format[] = "/tmp/gt.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+  // the state file is kept apart, roll over detection would take it for a rolled over log otherwise
+  char state_format[] = "/tmp/gt.XXXXXX";
+  auto state_dir = testController.createTempDirectory(state_format);
+
+  // a.log has no data, which must not hold back the other files of its group
+  for (const std::string name : { "a", "b", "c", "d" }) {
+    std::ofstream in_file_stream(std::string(dir) + utils::file::FileUtils::get_separator() + name + ".log");
+    if (name != "a") {
+      in_file_stream << name << name << name << "\n";
+    }
+  }
+
+  auto tail_file = plan->addProcessor("TailFile", "Tail");
+  tail_file->setMaxConcurrentTasks(2);
+  plan->setProperty(tail_file, processors::TailFile::FileName.getName(), ".*\\.log");
+  plan->setProperty(tail_file, processors::TailFile::TailMode.getName(), "Multiple file");
+  plan->setProperty(tail_file, processors::TailFile::BaseDirectory.getName(), dir);
+  plan->setProperty(tail_file, processors::TailFile::StateFile.getName(), std::string(state_dir) + utils::file::FileUtils::get_separator() + STATE_FILE);
+  plan->setProperty(tail_file, processors::TailFile::Delimiter.getName(), "\n");
+  auto log_attr = plan->addProcessor("LogAttribute", "Log", core::Relationship("success", "description"), true);
+  plan->setProperty(log_attr, processors::LogAttribute::FlowFilesToLog.getName(), "0");
+
+  // with two tasks, each trigger owns half of the files
+  plan->runNextProcessor();  // Tail
+  plan->runNextProcessor();  // Log
+  REQUIRE(LogTestController::getInstance().contains("b.0-3.log"));
+  REQUIRE(false == LogTestController::getInstance().contains("c.0-3.log", std::chrono::seconds(0)));
+
+  plan->reset();
+  plan->runNextProcessor();  // Tail
+  plan->runNextProcessor();  // Log
+  REQUIRE(LogTestController::getInstance().contains("c.0-3.log"));
+  REQUIRE(LogTestController::getInstance().contains("d.0-3.log"));
+
+  // the next trigger starts over with the first group
+  std::ofstream append_stream(std::string(dir) + utils::file::FileUtils::get_separator() + "a.log", std::ios_base::app);
+  append_stream << "aaa\n";
+  append_stream.close();
+  plan->reset();
+  plan->runNextProcessor();  // Tail
+  plan->runNextProcessor();  // Log
+  REQUIRE(LogTestController::getInstance().contains("a.0-3.log"));
+
+  LogTestController::getInstance().reset();
+}
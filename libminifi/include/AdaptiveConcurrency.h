@@ -0,0 +1,152 @@
+/**
+ * @file AdaptiveConcurrency.h
+ * AdaptiveConcurrency class declaration
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_ADAPTIVECONCURRENCY_H_
+#define LIBMINIFI_INCLUDE_ADAPTIVECONCURRENCY_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+
+/**
+ * Purpose: Tracks the number of workers a threaded scheduling agent runs for a single processor
+ * and decides when that number should grow or shrink between a lower bound and the processor's
+ * max concurrent tasks.
+ *
+ * Design: Workers report the latency of each run. Once per evaluation period a single worker
+ * evaluates the incoming queue depth against the estimated time the current workers need to drain
+ * it. Workers are added while the backlog outpaces them and CPU is available; they are retired when
+ * the backlog is gone or the host is saturated. All state is atomic so workers never block here.
+ */
+class AdaptiveConcurrency {
+ public:
+  enum Decision {
+    HOLD,
+    GROW,
+    SHRINK
+  };
+
+  AdaptiveConcurrency(const std::string &name, uint8_t min_tasks, uint8_t max_tasks, uint64_t evaluation_period_ms);
+
+  /**
+   * Records the duration of a single run of the processor.
+   * @param latency_ms run duration in milliseconds.
+   */
+  void recordLatency(uint64_t latency_ms);
+
+  /**
+   * Returns true if the caller won the right to evaluate for the current period.
+   * @param now_ms current time in milliseconds.
+   */
+  bool shouldEvaluate(uint64_t now_ms);
+
+  /**
+   * Decides whether the number of workers should change.
+   * @param queued flow files queued in the incoming connections.
+   * @param cpu_available whether the host has idle CPU.
+   * @param can_increase whether thread management allows another thread.
+   * @return decision. GROW and SHRINK have already been applied to the target worker count.
+   */
+  Decision evaluate(uint64_t queued, bool cpu_available, bool can_increase);
+
+  /**
+   * Claims a pending retirement.
+   * @return true if the calling worker should stop.
+   */
+  bool retire();
+
+  /**
+   * Registers a worker that has been submitted to the thread pool.
+   */
+  void workerStarted() {
+    active_workers_++;
+  }
+
+  /**
+   * Returns true if the host has spare CPU capacity, based on the load average.
+   */
+  static bool isCpuAvailable();
+
+  const std::string &getName() const {
+    return name_;
+  }
+
+  uint8_t getMinTasks() const {
+    return min_tasks_;
+  }
+
+  uint8_t getMaxTasks() const {
+    return max_tasks_;
+  }
+
+  uint8_t getActiveWorkers() const {
+    return active_workers_;
+  }
+
+  uint64_t getAverageLatency() const {
+    return average_latency_ms_;
+  }
+
+  uint64_t getLastQueueDepth() const {
+    return last_queue_depth_;
+  }
+
+  uint64_t getGrowCount() const {
+    return grow_count_;
+  }
+
+  uint64_t getShrinkCount() const {
+    return shrink_count_;
+  }
+
+  Decision getLastDecision() const {
+    return last_decision_;
+  }
+
+  static const char *getDecisionName(Decision decision);
+
+ protected:
+  std::string name_;
+  uint8_t min_tasks_;
+  uint8_t max_tasks_;
+  uint64_t evaluation_period_ms_;
+  // workers currently submitted for this processor
+  std::atomic<uint8_t> active_workers_;
+  // workers asked to stop, but that have not yet done so
+  std::atomic<uint8_t> pending_retirements_;
+  // exponentially weighted moving average of run latency
+  std::atomic<uint64_t> average_latency_ms_;
+  std::atomic<uint64_t> next_evaluation_ms_;
+  std::atomic<uint64_t> last_queue_depth_;
+  std::atomic<uint32_t> idle_evaluations_;
+  std::atomic<uint64_t> grow_count_;
+  std::atomic<uint64_t> shrink_count_;
+  std::atomic<Decision> last_decision_;
+};
+
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+#endif /* LIBMINIFI_INCLUDE_ADAPTIVECONCURRENCY_H_ */
@@ -43,6 +43,9 @@ namespace minifi {
 
 class Connection : public core::Connectable, public std::enable_shared_from_this<Connection> {
  public:
+  // fill level of a queue at its back pressure threshold
+  static const uint32_t FILL_LEVEL_FULL;
+
   // Constructor
   /*
    * Create a new processor
@@ -144,10 +147,15 @@ class Connection : public core::Connectable, public std::enable_shared_from_this
   bool isEmpty();
   // Check whether the queue is full to apply back pressure
   bool isFull();
+  /**
+   * Returns how full the queue is relative to its back pressure thresholds, in tenths of a
+   * percent, so FILL_LEVEL_FULL or more means full. Reads no lock, so the level may lag
+   * concurrent puts and polls. Returns 0 if no threshold is set.
+   */
+  uint32_t getFillLevel() const;
   // Get queue size
   uint64_t getQueueSize() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return queue_.size();
+    return queued_count_;
   }
   // Get queue data size
   uint64_t getQueueDataSize() {
@@ -161,6 +169,8 @@ class Connection : public core::Connectable, public std::enable_shared_from_this
   }
   // Put the flow file into queue
   void put(std::shared_ptr<core::FlowFile> flow);
+  // Put the flow files into queue, taking the lock once
+  void multiPut(std::vector<std::shared_ptr<core::FlowFile>> &flows);
   // Poll the flow file from queue, the expired flow file record also being returned
   std::shared_ptr<core::FlowFile> poll(std::set<std::shared_ptr<core::FlowFile>> &expiredFlowRecords);
   // Drain the flow records
@@ -206,6 +216,8 @@ class Connection : public core::Connectable, public std::enable_shared_from_this
   std::mutex mutex_;
   // Queued data size
   std::atomic<uint64_t> queued_data_size_;
+  // Queued flow files, kept beside the queue so that it can be read without the lock
+  std::atomic<uint64_t> queued_count_;
   // Queue for the Flow File
   std::queue<std::shared_ptr<core::FlowFile>> queue_;
   // flow repository
@@ -340,6 +340,9 @@ class FlowController : public core::controller::ControllerServiceProvider, publi
   // function to load the flow file repo.
   void loadFlowRepo();
 
+  // creates the executor shared by the scheduling agents when nifi.flow.engine.shared.executor is set
+  void initializeSharedThreadPool(const std::shared_ptr<core::controller::ControllerServiceProvider> &provider);
+
   void initializeExternalComponents();
 
   /**
@@ -388,6 +391,8 @@ class FlowController : public core::controller::ControllerServiceProvider, publi
   std::shared_ptr<EventDrivenSchedulingAgent> event_scheduler_;
   // Cron Schedule
   std::shared_ptr<CronDrivenSchedulingAgent> cron_scheduler_;
+  // executor shared by the scheduling agents, if enabled
+  std::shared_ptr<utils::ThreadPool<uint64_t>> shared_thread_pool_;
   // Controller Service
   // Config
   // Site to Site Server Listener
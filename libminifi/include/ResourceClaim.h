@@ -65,16 +65,30 @@ class ResourceClaim : public std::enable_shared_from_this<ResourceClaim> {
   }
   // increaseFlowFileRecordOwnedCount
   void increaseFlowFileRecordOwnedCount() {
-    claim_manager_->incrementStreamCount(shared_from_this());
+    flow_file_record_owned_count_.fetch_add(1);
   }
-  // decreaseFlowFileRecordOwenedCount
-  void decreaseFlowFileRecordOwnedCount() {
-    claim_manager_->decrementStreamCount(shared_from_this());
-
+  // decreaseFlowFileRecordOwenedCount, returns true if this call released the last owner
+  bool decreaseFlowFileRecordOwnedCount() {
+    uint32_t count = flow_file_record_owned_count_.load();
+    do {
+      if ((count & ~CLAIM_REMOVED) == 0) {
+        return false;
+      }
+    } while (!flow_file_record_owned_count_.compare_exchange_weak(count, count - 1));
+    return count == 1;
   }
   // getFlowFileRecordOwenedCount
   uint64_t getFlowFileRecordOwnedCount() {
-    return claim_manager_->getStreamCount(shared_from_this());
+    return flow_file_record_owned_count_.load() & ~CLAIM_REMOVED;
+  }
+  /**
+   * Marks the content of an unowned claim for removal. Fails if the claim is owned or was
+   * already marked, so that exactly one caller removes the content and an owner added
+   * concurrently keeps it.
+   */
+  bool markRemoved() {
+    uint32_t unowned = 0;
+    return flow_file_record_owned_count_.compare_exchange_strong(unowned, CLAIM_REMOVED);
   }
   // Get the content full path
   std::string getContentFullPath() {
@@ -109,7 +123,12 @@ class ResourceClaim : public std::enable_shared_from_this<ResourceClaim> {
     return stream;
   }
  protected:
+  // Set in the owned count once the content of the claim has been removed
+  static const uint32_t CLAIM_REMOVED = 0x80000000;
+
   std::atomic<bool> deleted_;
+  // Number of flow file records referencing this claim
+  std::atomic<uint32_t> flow_file_record_owned_count_;
   // Full path to the content
   std::string _contentFullPath;
 
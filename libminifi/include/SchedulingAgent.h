@@ -27,6 +27,7 @@
 #include <atomic>
 #include <algorithm>
 #include <thread>
+#include <string>
 #include "utils/TimeUtil.h"
 #include "utils/ThreadPool.h"
 #include "utils/BackTrace.h"
@@ -114,24 +115,31 @@ class SchedulingAgent {
    * Create a new scheduling agent.
    */
   SchedulingAgent(std::shared_ptr<core::controller::ControllerServiceProvider> controller_service_provider, std::shared_ptr<core::Repository> repo, std::shared_ptr<core::Repository> flow_repo,
-                  std::shared_ptr<core::ContentRepository> content_repo, std::shared_ptr<Configure> configuration)
+                  std::shared_ptr<core::ContentRepository> content_repo, std::shared_ptr<Configure> configuration,
+                  const std::shared_ptr<utils::ThreadPool<uint64_t>> &thread_pool = nullptr)
       : admin_yield_duration_(0),
         bored_yield_duration_(0),
+        back_pressure_low_watermark_(Connection::FILL_LEVEL_FULL),
         configure_(configuration),
         content_repo_(content_repo),
+        shared_thread_pool_(thread_pool != nullptr),
         controller_service_provider_(controller_service_provider),
         logger_(logging::LoggerFactory<SchedulingAgent>::getLogger()) {
     running_ = false;
     repo_ = repo;
     flow_repo_ = flow_repo;
-    /**
-     * To facilitate traces we cannot use daemon threads -- this could potentially cause blocking on I/O; however, it's a better path
-     * to be able to debug why an agent doesn't work and still allow a restart via updates in these cases.
-     */
-    auto csThreads = configure_->getInt(Configure::nifi_flow_engine_threads, 2);
-    auto pool = utils::ThreadPool<uint64_t>(csThreads, false, controller_service_provider, "SchedulingAgent");
-    thread_pool_ = std::move(pool);
-    thread_pool_.start();
+    configureBackPressure();
+    if (shared_thread_pool_) {
+      thread_pool_ = thread_pool;
+    } else {
+      /**
+       * To facilitate traces we cannot use daemon threads -- this could potentially cause blocking on I/O; however, it's a better path
+       * to be able to debug why an agent doesn't work and still allow a restart via updates in these cases.
+       */
+      auto csThreads = configure_->getInt(Configure::nifi_flow_engine_threads, 2);
+      thread_pool_ = createThreadPool(configure_, controller_service_provider, csThreads, "SchedulingAgent");
+    }
+    thread_pool_->start();
   }
   // Destructor
   virtual ~SchedulingAgent() {
@@ -141,23 +149,51 @@ class SchedulingAgent {
   bool onTrigger(const std::shared_ptr<core::Processor> &processor, const std::shared_ptr<core::ProcessContext> &processContext, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory);
   // Whether agent has work to do
   bool hasWorkToDo(std::shared_ptr<core::Processor> processor);
-  // Whether the outgoing need to be backpressure
+  /**
+   * Whether the outgoing need to be backpressure. A processor whose outgoing connections fill up
+   * is held until they drain to the low watermark; between the low watermark and full it yields
+   * in proportion to the fill level, so that it slows down rather than stopping and starting.
+   * Without a configured low watermark it is held only while a connection is full.
+   */
   bool hasTooMuchOutGoing(std::shared_ptr<core::Processor> processor);
   // start
   void start() {
     running_ = true;
-    thread_pool_.start();
+    thread_pool_->start();
   }
   // stop
   virtual void stop() {
     running_ = false;
-    thread_pool_.shutdown();
+    // a shared pool is shut down by its owner
+    if (!shared_thread_pool_) {
+      thread_pool_->shutdown();
+    }
   }
 
   std::vector<BackTrace> getTraces() {
-    return thread_pool_.getTraces();
+    return thread_pool_->getTraces();
+  }
+
+  std::shared_ptr<utils::ThreadPool<uint64_t>> getThreadPool() const {
+    return thread_pool_;
   }
 
+  bool hasSharedThreadPool() const {
+    return shared_thread_pool_;
+  }
+
+  /**
+   * Creates a thread pool for scheduling agents, binding its threads to CPUs as configured
+   * by nifi.flow.engine.thread.affinity.
+   * @param configure agent configuration
+   * @param controller_service_provider provider used to locate a thread management service
+   * @param threads number of worker threads
+   * @param name thread pool name
+   */
+  static std::shared_ptr<utils::ThreadPool<uint64_t>> createThreadPool(const std::shared_ptr<Configure> &configure,
+                                                                       const std::shared_ptr<core::controller::ControllerServiceProvider> &controller_service_provider, int threads,
+                                                                       const std::string &name);
+
  public:
   virtual std::future<uint64_t> enableControllerService(std::shared_ptr<core::controller::ControllerServiceNode> &serviceNode);
   virtual std::future<uint64_t> disableControllerService(std::shared_ptr<core::controller::ControllerServiceNode> &serviceNode);
@@ -177,6 +213,8 @@ class SchedulingAgent {
   int64_t admin_yield_duration_;
   // BoredYieldDuration
   int64_t bored_yield_duration_;
+  // fill level, in tenths of a percent, below which back pressured processors run again
+  uint32_t back_pressure_low_watermark_;
 
   std::shared_ptr<Configure> configure_;
 
@@ -185,12 +223,16 @@ class SchedulingAgent {
   std::shared_ptr<core::Repository> flow_repo_;
 
   std::shared_ptr<core::ContentRepository> content_repo_;
+  // whether thread_pool_ is shared with other scheduling agents
+  bool shared_thread_pool_;
   // thread pool for components.
-  utils::ThreadPool<uint64_t> thread_pool_;
+  std::shared_ptr<utils::ThreadPool<uint64_t>> thread_pool_;
   // controller service provider reference
   std::shared_ptr<core::controller::ControllerServiceProvider> controller_service_provider_;
 
  private:
+  void configureBackPressure();
+
   // Logger
   std::shared_ptr<logging::Logger> logger_;
   // Prevent default copy constructor and assignment operation
@@ -21,18 +21,48 @@
 #define __THREADED_SCHEDULING_AGENT_H__
 
 #include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
 #include "properties/Configure.h"
 #include "core/logging/LoggerConfiguration.h"
 #include "core/Processor.h"
 #include "core/Repository.h"
 #include "core/ProcessContext.h"
 #include "SchedulingAgent.h"
+#include "AdaptiveConcurrency.h"
 
 namespace org {
 namespace apache {
 namespace nifi {
 namespace minifi {
 
+/**
+ * Monitor for workers of processors scheduled with adaptive concurrency. In addition to
+ * the timer aware behavior, a worker finishes when it claims a requested retirement.
+ */
+class AdaptiveWorkerMonitor : public TimerAwareMonitor {
+ public:
+  AdaptiveWorkerMonitor(std::atomic<bool> *run_monitor, const std::shared_ptr<core::Processor> &processor, const std::shared_ptr<AdaptiveConcurrency> &concurrency)
+      : TimerAwareMonitor(run_monitor),
+        processor_(processor),
+        concurrency_(concurrency) {
+  }
+  virtual bool isFinished(const uint64_t &result) {
+    if (TimerAwareMonitor::isFinished(result)) {
+      return true;
+    }
+    if (concurrency_->retire()) {
+      processor_->decrementActiveTask();
+      return true;
+    }
+    return false;
+  }
+ protected:
+  std::shared_ptr<core::Processor> processor_;
+  std::shared_ptr<AdaptiveConcurrency> concurrency_;
+};
 
 /**
  * An abstract scheduling agent which creates and manages a pool of threads for
@@ -45,9 +75,14 @@ class ThreadedSchedulingAgent : public SchedulingAgent {
    * Create a new threaded scheduling agent.
    */
   ThreadedSchedulingAgent(std::shared_ptr<core::controller::ControllerServiceProvider> controller_service_provider, std::shared_ptr<core::Repository> repo, std::shared_ptr<core::Repository> flow_repo,
-                          std::shared_ptr<core::ContentRepository> content_repo, std::shared_ptr<Configure> configuration)
-      : SchedulingAgent(controller_service_provider, repo, flow_repo, content_repo, configuration),
+                          std::shared_ptr<core::ContentRepository> content_repo, std::shared_ptr<Configure> configuration,
+                          const std::shared_ptr<utils::ThreadPool<uint64_t>> &thread_pool = nullptr)
+      : SchedulingAgent(controller_service_provider, repo, flow_repo, content_repo, configuration, thread_pool),
+        adaptive_enabled_(false),
+        adaptive_min_tasks_(1),
+        adaptive_evaluation_period_ms_(1000),
         logger_(logging::LoggerFactory<ThreadedSchedulingAgent>::getLogger()) {
+    configureAdaptiveConcurrency();
   }
   // Destructor
   virtual ~ThreadedSchedulingAgent() {
@@ -65,9 +100,45 @@ class ThreadedSchedulingAgent : public SchedulingAgent {
 
   virtual void stop();
 
+  /**
+   * Returns the adaptive concurrency state of every processor scheduled by this agent
+   * while adaptive concurrency is enabled.
+   */
+  std::vector<std::shared_ptr<AdaptiveConcurrency>> getAdaptiveConcurrency();
+
  protected:
 
+  /**
+   * Submits a single worker for the processor to the thread pool.
+   * @param concurrency adaptive state, or nullptr if the processor runs a fixed number of workers.
+   */
+  void submitWorker(const std::shared_ptr<core::Processor> &processor, const std::shared_ptr<core::ProcessContext> &processContext,
+                    const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory, const std::shared_ptr<AdaptiveConcurrency> &concurrency);
+
+  /**
+   * Evaluates the processor's backlog and grows or shrinks its workers if needed.
+   */
+  void adjustConcurrency(const std::shared_ptr<core::Processor> &processor, const std::shared_ptr<core::ProcessContext> &processContext,
+                         const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory, const std::shared_ptr<AdaptiveConcurrency> &concurrency);
+
+  /**
+   * Returns the CPU affinity group the processor's workers run on, so that processors of the
+   * same pipeline share a NUMA node. Returns -1 if the thread pool is not bound to CPUs.
+   */
+  int getAffinityGroup(const std::shared_ptr<core::Processor> &processor);
+
+  // whether processors with incoming connections scale their workers
+  bool adaptive_enabled_;
+  // lower bound of workers in adaptive mode
+  uint8_t adaptive_min_tasks_;
+  // period between concurrency decisions
+  uint64_t adaptive_evaluation_period_ms_;
+  std::mutex adaptive_mutex_;
+  std::map<std::string, std::shared_ptr<AdaptiveConcurrency>> adaptive_concurrency_;
+
  private:
+  void configureAdaptiveConcurrency();
+
   // Prevent default copy constructor and assignment operation
   // Only support pass by reference or pointer
   ThreadedSchedulingAgent(const ThreadedSchedulingAgent &parent);
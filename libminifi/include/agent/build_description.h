@@ -18,6 +18,8 @@
 #ifndef BUILD_DESCRPTION_H
 #define BUILD_DESCRPTION_H
 
+#include <functional>
+#include <mutex>
 #include <vector>
 #include "core/expect.h"
 
@@ -84,8 +86,41 @@ class ExternalBuildDescription {
     return external_mappings;
   }
 
+  static std::mutex &getDescriberMutex() {
+    static std::mutex describer_mutex;
+    return describer_mutex;
+  }
+
+  static std::vector<std::function<void()>> &getDeferredDescribers() {
+    static std::vector<std::function<void()>> deferred_describers;
+    return deferred_describers;
+  }
+
+  /**
+   * Runs the describers registered through addDeferredDescriber once.
+   */
+  static void runDeferredDescribers() {
+    std::vector<std::function<void()>> describers;
+    {
+      std::lock_guard<std::mutex> lock(getDescriberMutex());
+      describers.swap(getDeferredDescribers());
+    }
+    for (const auto &describer : describers) {
+      describer();
+    }
+  }
+
  public:
 
+  /**
+   * Registers a function that adds external components once they are first requested, for
+   * components that can only be described by loading them.
+   */
+  static void addDeferredDescriber(std::function<void()> describer) {
+    std::lock_guard<std::mutex> lock(getDescriberMutex());
+    getDeferredDescribers().emplace_back(std::move(describer));
+  }
+
   static void addExternalComponent(struct BundleDetails details, const ClassDescription &description) {
     bool found = false;
     for (const auto &d : getExternal()) {
@@ -105,10 +140,12 @@ class ExternalBuildDescription {
   }
 
   static struct Components getClassDescriptions(const std::string &group) {
+    runDeferredDescribers();
     return getExternalMappings()[group];
   }
 
   static std::vector<struct BundleDetails> getExternalGroups() {
+    runDeferredDescribers();
     return getExternal();
   }
 };
@@ -130,7 +167,8 @@ class BuildDescription {
           int nameLength = clazz.length() - lastOfIdx;
           class_name = clazz.substr(lastOfIdx, nameLength);
         }
-        auto obj = core::ClassLoader::getDefaultClassLoader().instantiate(class_name, class_name);
+        // describing a class does not need its extension's libraries, so don't initialize them
+        auto obj = core::ClassLoader::getDefaultClassLoader().instantiateWithoutInitializer(class_name, class_name);
 
         std::shared_ptr<core::ConfigurableComponent> component = std::dynamic_pointer_cast<core::ConfigurableComponent>(obj);
 
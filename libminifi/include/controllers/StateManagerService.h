@@ -0,0 +1,111 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CONTROLLERS_STATEMANAGERSERVICE_H_
+#define LIBMINIFI_INCLUDE_CONTROLLERS_STATEMANAGERSERVICE_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "core/controller/ControllerService.h"
+#include "core/logging/LoggerConfiguration.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+/**
+ * Purpose: StateManagerService provides processors with a key/value store for the state they
+ * must keep across restarts, such as file positions or listing timestamps.
+ *
+ * Design: State is stored per component id as a whole map of string keys and values, so that
+ * every update of a component's state is atomic. Implementations decide how and when state
+ * reaches durable storage; persist() forces any pending update out.
+ */
+class StateManagerService : public core::controller::ControllerService {
+ public:
+  explicit StateManagerService(const std::string &name, const std::string &id)
+      : ControllerService(name, id) {
+  }
+
+  explicit StateManagerService(const std::string &name, utils::Identifier uuid = utils::Identifier())
+      : ControllerService(name, uuid) {
+  }
+
+  virtual ~StateManagerService() {
+  }
+
+  virtual void yield() {
+  }
+
+  virtual bool isRunning() {
+    return getState() == core::controller::ControllerServiceState::ENABLED;
+  }
+
+  virtual bool isWorkAvailable() {
+    return false;
+  }
+
+  /**
+   * Replaces the state of the component.
+   * @param component_id uuid of the component owning the state
+   * @param state new state
+   * @return true if the update was accepted
+   */
+  virtual bool set(const std::string &component_id, const std::unordered_map<std::string, std::string> &state) = 0;
+
+  /**
+   * Retrieves the state of the component.
+   * @param component_id uuid of the component owning the state
+   * @param state output state
+   * @return true if state was found for the component
+   */
+  virtual bool get(const std::string &component_id, std::unordered_map<std::string, std::string> &state) = 0;
+
+  /**
+   * Removes the state of the component.
+   * @return true if the removal was accepted
+   */
+  virtual bool clear(const std::string &component_id) = 0;
+
+  /**
+   * Writes pending updates to durable storage.
+   * @return true if all pending updates were written
+   */
+  virtual bool persist() = 0;
+
+  /**
+   * Encodes a state map into a single value.
+   */
+  static std::string serialize(const std::unordered_map<std::string, std::string> &state);
+
+  /**
+   * Decodes a value produced by serialize.
+   * @return false if the value is not a valid encoded state
+   */
+  static bool deserialize(const std::string &serialized, std::unordered_map<std::string, std::string> &state);
+};
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_CONTROLLERS_STATEMANAGERSERVICE_H_ */
@@ -0,0 +1,76 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CONTROLLERS_VOLATILESTATEMANAGERSERVICE_H_
+#define LIBMINIFI_INCLUDE_CONTROLLERS_VOLATILESTATEMANAGERSERVICE_H_
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "core/Resource.h"
+#include "controllers/StateManagerService.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+/**
+ * Purpose: Keeps component state in memory. State does not survive a restart, so this
+ * implementation is meant for tests and for flows that do not need to resume.
+ */
+class VolatileStateManagerService : public StateManagerService {
+ public:
+  explicit VolatileStateManagerService(const std::string &name, const std::string &id)
+      : StateManagerService(name, id),
+        logger_(logging::LoggerFactory<VolatileStateManagerService>::getLogger()) {
+  }
+
+  explicit VolatileStateManagerService(const std::string &name, utils::Identifier uuid = utils::Identifier())
+      : StateManagerService(name, uuid),
+        logger_(logging::LoggerFactory<VolatileStateManagerService>::getLogger()) {
+  }
+
+  virtual void initialize();
+
+  virtual void onEnable();
+
+  virtual bool set(const std::string &component_id, const std::unordered_map<std::string, std::string> &state);
+
+  virtual bool get(const std::string &component_id, std::unordered_map<std::string, std::string> &state);
+
+  virtual bool clear(const std::string &component_id);
+
+  virtual bool persist();
+
+ private:
+  std::mutex mutex_;
+  std::map<std::string, std::unordered_map<std::string, std::string>> states_;
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+REGISTER_RESOURCE(VolatileStateManagerService, "Keeps the state of processors in memory. State is lost when MiNiFi restarts.");
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_CONTROLLERS_VOLATILESTATEMANAGERSERVICE_H_ */
@@ -18,6 +18,7 @@
 #ifndef LIBMINIFI_INCLUDE_CORE_CLASSLOADER_H_
 #define LIBMINIFI_INCLUDE_CORE_CLASSLOADER_H_
 
+#include <atomic>
 #include <mutex>
 #include <vector>
 #include <string>
@@ -313,6 +314,31 @@ class ClassLoader {
    */
   uint16_t registerResource(const std::string &resource, const std::string &resourceName);
 
+  /**
+   * Defers the initializers of factories registered through registerResource until one of the
+   * factory's classes is first instantiated, so that extensions the flow does not use never
+   * initialize their libraries. Disabled by default.
+   */
+  void setLazyInitialization(bool lazy) {
+    std::lock_guard<std::mutex> lock(internal_mutex_);
+    lazy_initialization_ = lazy;
+  }
+
+  bool isLazyInitialization() {
+    std::lock_guard<std::mutex> lock(internal_mutex_);
+    return lazy_initialization_;
+  }
+
+  /**
+   * Returns true if the initializer of the extension providing class_name has run, or if the
+   * extension has none.
+   */
+  bool isInitialized(const std::string &class_name) {
+    std::lock_guard<std::mutex> lock(internal_mutex_);
+    auto deferred = deferred_initializers_.find(class_name);
+    return deferred == deferred_initializers_.end() || deferred->second->initialized_.load();
+  }
+
   /**
    * Register a class with the give ProcessorFactory
    */
@@ -422,8 +448,43 @@ class ClassLoader {
   template<class T = CoreComponent>
   T *instantiateRaw(const std::string &class_name, utils::Identifier & uuid);
 
+  /**
+   * Instantiate object based on class_name without running the deferred initializer of its
+   * extension. The object may only be used to describe the class, e.g. for the agent manifest.
+   * @param class_name class to create
+   * @param name name of object
+   * @return nullptr or object created from class_name definition.
+   */
+  template<class T = CoreComponent>
+  std::shared_ptr<T> instantiateWithoutInitializer(const std::string &class_name, const std::string &name);
+
  protected:
 
+  /**
+   * Initializer of a factory whose classes have not been instantiated yet.
+   */
+  struct DeferredInitializer {
+    explicit DeferredInitializer(std::unique_ptr<ObjectFactoryInitializer> initializer)
+        : initializer_(std::move(initializer)),
+          initialized_(false) {
+    }
+    std::unique_ptr<ObjectFactoryInitializer> initializer_;
+    std::once_flag once_;
+    std::atomic<bool> initialized_;
+  };
+
+  /**
+   * Runs the deferred initializer of the extension providing class_name, if any. Must be called
+   * without internal_mutex_ held, as the initializer may instantiate classes itself.
+   * @return false if the initializer failed.
+   */
+  bool initializeDeferred(const std::string &class_name);
+
+  /**
+   * Returns the handle to the agent itself, opening it once.
+   */
+  void *getSelfHandle();
+
 #ifdef WIN32
 
   // base_object doesn't have a handle
@@ -576,6 +637,16 @@ class ClassLoader {
   std::vector<void *> dl_handles_;
 
   std::vector<std::unique_ptr<ObjectFactoryInitializer>> initializers_;
+
+  // initializers that run on first instantiation, keyed by class name
+  std::map<std::string, std::shared_ptr<DeferredInitializer>> deferred_initializers_;
+
+  bool lazy_initialization_;
+
+  std::once_flag self_handle_flag_;
+
+  // handle to the agent itself, shared by the extensions linked into it
+  void *self_handle_;
 };
 
 template<class T>
@@ -589,6 +660,9 @@ std::shared_ptr<T> ClassLoader::instantiate(const std::string &class_name, bool
 
 template<class T>
 std::shared_ptr<T> ClassLoader::instantiate(const std::string &class_name, const std::string &name) {
+  if (!initializeDeferred(class_name)) {
+    return nullptr;
+  }
   std::lock_guard<std::mutex> lock(internal_mutex_);
   auto factory_entry = loaded_factories_.find(class_name);
   if (factory_entry != loaded_factories_.end()) {
@@ -601,6 +675,9 @@ std::shared_ptr<T> ClassLoader::instantiate(const std::string &class_name, const
 
 template<class T>
 std::shared_ptr<T> ClassLoader::instantiate(const std::string &class_name, utils::Identifier &uuid) {
+  if (!initializeDeferred(class_name)) {
+    return nullptr;
+  }
   std::lock_guard<std::mutex> lock(internal_mutex_);
   auto factory_entry = loaded_factories_.find(class_name);
   if (factory_entry != loaded_factories_.end()) {
@@ -613,6 +690,9 @@ std::shared_ptr<T> ClassLoader::instantiate(const std::string &class_name, utils
 
 template<class T>
 T *ClassLoader::instantiateRaw(const std::string &class_name, const std::string &name) {
+  if (!initializeDeferred(class_name)) {
+    return nullptr;
+  }
   std::lock_guard<std::mutex> lock(internal_mutex_);
   auto factory_entry = loaded_factories_.find(class_name);
   if (factory_entry != loaded_factories_.end()) {
@@ -625,6 +705,9 @@ T *ClassLoader::instantiateRaw(const std::string &class_name, const std::string
 
 template<class T>
 T *ClassLoader::instantiateRaw(const std::string &class_name, utils::Identifier & uuid) {
+  if (!initializeDeferred(class_name)) {
+    return nullptr;
+  }
   std::lock_guard<std::mutex> lock(internal_mutex_);
   auto factory_entry = loaded_factories_.find(class_name);
   if (factory_entry != loaded_factories_.end()) {
@@ -635,6 +718,18 @@ T *ClassLoader::instantiateRaw(const std::string &class_name, utils::Identifier
   }
 }
 
+template<class T>
+std::shared_ptr<T> ClassLoader::instantiateWithoutInitializer(const std::string &class_name, const std::string &name) {
+  std::lock_guard<std::mutex> lock(internal_mutex_);
+  auto factory_entry = loaded_factories_.find(class_name);
+  if (factory_entry != loaded_factories_.end()) {
+    auto obj = factory_entry->second->create(name);
+    return std::dynamic_pointer_cast<T>(obj);
+  } else {
+    return nullptr;
+  }
+}
+
 }/* namespace core */
 } /* namespace minifi */
 } /* namespace nifi */
@@ -91,6 +91,14 @@ class Connectable : public CoreComponent {
     return (_incomingConnections.size() > 0);
   }
 
+  /**
+   * @return copy of the incoming connections
+   */
+  std::set<std::shared_ptr<Connectable>> getIncomingConnections() {
+    std::lock_guard<std::mutex> lock(relationship_mutex_);
+    return _incomingConnections;
+  }
+
   uint8_t getMaxConcurrentTasks() const {
     return max_concurrent_tasks_;
   }
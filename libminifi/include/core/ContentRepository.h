@@ -18,6 +18,8 @@
 #ifndef LIBMINIFI_INCLUDE_CORE_CONTENTREPOSITORY_H_
 #define LIBMINIFI_INCLUDE_CORE_CONTENTREPOSITORY_H_
 
+#include <memory>
+#include <string>
 #include "properties/Configure.h"
 #include "ResourceClaim.h"
 #include "io/DataStream.h"
@@ -55,66 +57,41 @@ class ContentRepository : public StreamManager<minifi::ResourceClaim> {
    */
   virtual void stop() = 0;
 
+  /**
+   * Returns the path of the file holding the content of the claim, or an empty string if
+   * this repository does not keep claims in plain files. Callers may use the path to move
+   * content with kernel copies instead of streaming it.
+   */
+  virtual std::string getContentPath(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+    return "";
+  }
+
   /**
    * Removes an item if it was orphan
    */
   virtual bool removeIfOrphaned(const std::shared_ptr<minifi::ResourceClaim> &streamId) {
-    std::lock_guard<std::mutex> lock(count_map_mutex_);
-    const std::string str = streamId->getContentFullPath();
-    auto count = count_map_.find(str);
-    if (count != count_map_.end()) {
-      if (count_map_[str] == 0) {
-        remove(streamId);
-        count_map_.erase(str);
-        return true;
-      } else {
-        return false;
-      }
-    } else {
-      remove(streamId);
-      return true;
+    if (!streamId->markRemoved()) {
+      return false;
     }
+    remove(streamId);
+    return true;
   }
 
   virtual uint32_t getStreamCount(const std::shared_ptr<minifi::ResourceClaim> &streamId) {
-    std::lock_guard<std::mutex> lock(count_map_mutex_);
-    auto cnt = count_map_.find(streamId->getContentFullPath());
-    if (cnt != count_map_.end()) {
-      return cnt->second;
-    } else {
-      return 0;
-    }
+    return streamId->getFlowFileRecordOwnedCount();
   }
 
   virtual void incrementStreamCount(const std::shared_ptr<minifi::ResourceClaim> &streamId) {
-    std::lock_guard<std::mutex> lock(count_map_mutex_);
-    const std::string str = streamId->getContentFullPath();
-    auto count = count_map_.find(str);
-    if (count != count_map_.end()) {
-      count_map_[str] = count->second + 1;
-    } else {
-      count_map_[str] = 1;
-    }
+    streamId->increaseFlowFileRecordOwnedCount();
   }
 
   virtual void decrementStreamCount(const std::shared_ptr<minifi::ResourceClaim> &streamId) {
-    std::lock_guard<std::mutex> lock(count_map_mutex_);
-    const std::string str = streamId->getContentFullPath();
-    auto count = count_map_.find(str);
-    if (count != count_map_.end() && count->second > 0) {
-      count_map_[str] = count->second - 1;
-    } else {
-	count_map_.erase(str);
-    }
+    streamId->decreaseFlowFileRecordOwnedCount();
   }
 
  protected:
 
   std::string directory_;
-
-  std::mutex count_map_mutex_;
-
-  std::map<std::string, uint32_t> count_map_;
 };
 
 } /* namespace core */
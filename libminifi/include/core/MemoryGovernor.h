@@ -0,0 +1,181 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_MEMORYGOVERNOR_H_
+#define LIBMINIFI_INCLUDE_CORE_MEMORYGOVERNOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "properties/Configure.h"
+#include "core/logging/Logger.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+/**
+ * Purpose: Keeps the memory use of the whole agent below one limit.
+ *
+ * Justification: Volatile repositories, connections and the receive queues of the listening
+ * processors each bound their own memory, but nothing bounds their sum, so a burst reaching all of
+ * them at once can exceed the memory of the device.
+ *
+ * Design: The governor is off unless nifi.memory.limit is set, either to a size or to cgroup for the
+ * limit of the memory cgroup of the agent. Usage is the resident size of the process, sampled once
+ * per sample period by the governor's own thread, plus what components reserved since the sample.
+ * Components buffering data they received reserve it with tryReserve, which fails above the high
+ * watermark, and release it once the data left their buffers. Above the low watermark the governor
+ * is under pressure: volatile content is spilled to disk and the governor's thread asks the
+ * reclaimers to shrink their caches. The fill level throttles source processors like a connection
+ * does and stops them at the high watermark.
+ */
+class MemoryGovernor {
+ public:
+  static MemoryGovernor &getInstance() {
+    static MemoryGovernor governor;
+    return governor;
+  }
+
+  MemoryGovernor();
+
+  ~MemoryGovernor();
+
+  /**
+   * Reads the limit and watermarks from the nifi.memory.* properties and starts sampling if a limit
+   * is set. Without a limit, or with a limit of 0, the governor is disabled; reservations are still
+   * counted.
+   */
+  void configure(const std::shared_ptr<Configure> &configure);
+
+  bool isEnabled() const {
+    return limit_ > 0;
+  }
+
+  /**
+   * Reserves memory for data about to be buffered.
+   * @return false if the reservation would take usage above the high watermark
+   */
+  bool tryReserve(uint64_t bytes);
+
+  void release(uint64_t bytes);
+
+  /**
+   * @return true if usage is above the low watermark
+   */
+  bool isUnderPressure();
+
+  /**
+   * Returns usage relative to the high watermark in the units of Connection::getFillLevel, so
+   * that Connection::FILL_LEVEL_FULL or more means the high watermark was reached. Returns 0 if
+   * the governor is disabled.
+   */
+  uint32_t getFillLevel();
+
+  uint64_t getUsage();
+
+  uint64_t getLimit() const {
+    return limit_;
+  }
+
+  uint64_t getLowWatermark() const {
+    return low_watermark_;
+  }
+
+  uint64_t getHighWatermark() const {
+    return high_watermark_;
+  }
+
+  /**
+   * @return the resident size of the process at the last sample
+   */
+  uint64_t getResidentSize() const {
+    return resident_size_;
+  }
+
+  uint64_t getReserved() const {
+    return reserved_;
+  }
+
+  uint64_t getRefusedCount() const {
+    return refused_count_;
+  }
+
+  /**
+   * Registers a function that frees cached memory. It is called on the governor's thread with the
+   * number of bytes usage exceeds the low watermark by after every sample above the low watermark,
+   * and once with 0 when usage fell back below it or the governor was disabled, so that the cache
+   * may grow again.
+   * @return identifier to unregister the reclaimer with
+   */
+  int registerReclaimer(std::function<void(uint64_t excess)> reclaimer);
+
+  void unregisterReclaimer(int id);
+
+ private:
+  uint64_t computeUsage() const;
+
+  // samples the resident size if the sample period passed since the last sample
+  void sample();
+
+  // calls the reclaimers if usage is above the low watermark, or was at the previous call
+  void reclaim();
+
+  void start();
+
+  void stop();
+
+  // samples and reclaims once per sample period, or when configure asks it to
+  void run();
+
+  std::atomic<uint64_t> limit_;
+  std::atomic<uint64_t> low_watermark_;
+  std::atomic<uint64_t> high_watermark_;
+  std::atomic<uint64_t> reserved_;
+  std::atomic<uint64_t> refused_count_;
+  std::atomic<uint64_t> resident_size_;
+  std::atomic<uint64_t> reserved_at_sample_;
+  std::atomic<uint64_t> sample_period_ms_;
+  std::atomic<uint64_t> last_sample_ms_;
+  std::mutex sample_mutex_;
+  std::mutex reclaim_mutex_;
+  bool reclaiming_;
+  std::mutex reclaimer_mutex_;
+  int next_reclaimer_id_;
+  std::map<int, std::function<void(uint64_t)>> reclaimers_;
+  std::mutex thread_mutex_;
+  std::condition_variable thread_condition_;
+  bool running_;
+  bool reclaim_requested_;
+  std::thread thread_;
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_CORE_MEMORYGOVERNOR_H_ */
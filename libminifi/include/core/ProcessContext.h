@@ -103,6 +103,17 @@ class ProcessContext : public controller::ControllerServiceLookup, public core::
   virtual bool getDynamicProperty(const Property &property, std::string &value, const std::shared_ptr<FlowFile> &flow_file) {
     return getDynamicProperty(property.getName(), value);
   }
+  /**
+   * Evaluates a dynamic property as a condition, which holds if the property evaluates to "true".
+   */
+  virtual bool getDynamicProperty(const Property &property, bool &value, const std::shared_ptr<FlowFile> &flow_file) {
+    std::string result;
+    if (!getDynamicProperty(property, result, flow_file)) {
+      return false;
+    }
+    value = result == "true";
+    return true;
+  }
   std::vector<std::string> getDynamicPropertyKeys() const {
     return processor_node_->getDynamicPropertyKeys();
   }
@@ -126,6 +126,26 @@ class ProcessSession : public ReferenceContainer {
   bool exportContent(const std::string &destination, const std::string &tmpFileName, const std::shared_ptr<core::FlowFile> &flow,
   bool keepContent);
 
+  /**
+   * Copies the content of the flow file into destination without streaming it through the
+   * session, using kernel copies or reflinks when the content repository keeps claims in files.
+   * @param destination file to create or truncate
+   * @param flow flow file
+   * @return false if the content has to be read through read() instead
+   */
+  bool copyContent(const std::shared_ptr<core::FlowFile> &flow, const std::string &destination);
+
+#ifndef WIN32
+  /**
+   * Copies the content of the flow file to the current position of an open file, like the
+   * copy above. On failure the file is left with unspecified contents for the caller to discard.
+   * @param destination_fd file opened for writing
+   * @param flow flow file
+   * @return false if the content has to be read through read() instead
+   */
+  bool copyContent(const std::shared_ptr<core::FlowFile> &flow, int destination_fd);
+#endif
+
   // Stash the content to a key
   void stash(const std::string &key, const std::shared_ptr<core::FlowFile> &flow);
   // Restore content previously stashed to a key
@@ -153,6 +173,10 @@ class ProcessSession : public ReferenceContainer {
  private:
 // Clone the flow file during transfer to multiple connections for a relationship
   std::shared_ptr<core::FlowFile> cloneDuringTransfer(std::shared_ptr<core::FlowFile> &parent);
+  // Moves or copies source into the file of a content claim, returns the imported size or -1 if it has to be streamed
+  int64_t importFile(const std::string &source, const std::string &content_path, bool keepSource, uint64_t offset);
+  // Path of the file holding the content of flow, empty if the content repository does not keep claims in files
+  std::string getContentPath(const std::shared_ptr<core::FlowFile> &flow);
   // ProcessContext
   std::shared_ptr<ProcessContext> process_context_;
   // Logger
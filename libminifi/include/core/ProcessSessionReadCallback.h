@@ -36,6 +36,10 @@ namespace core {
        ~ProcessSessionReadCallback();
     virtual int64_t process(std::shared_ptr<io::BaseStream> stream);
     bool commit();
+    // Marks the tmp file as written when its content was copied without process()
+    void setWriteSucceeded() {
+      _writeSucceeded = true;
+    }
 
    private:
     std::shared_ptr<logging::Logger> logger_;
@@ -210,8 +210,19 @@ class Processor : public Connectable, public ConfigurableComponent, public std::
   }
   // Whether flow file queued in incoming connection
   bool flowFilesQueued();
+  // Number of flow files queued across all incoming connections
+  uint64_t getFlowFilesQueuedCount();
   // Whether flow file queue full in any of the outgoin connection
   bool flowFilesOutGoingFull();
+  // Highest fill level of the outgoing connections, read without locking
+  uint32_t getOutgoingFillLevel();
+  // Whether back pressure holds the processor until its outgoing connections drain to the low watermark
+  bool isBackPressured() const {
+    return back_pressured_;
+  }
+  void setBackPressured(bool back_pressured) {
+    back_pressured_ = back_pressured;
+  }
 
   // Get outgoing connections based on relationship name
   std::set<std::shared_ptr<Connection> > getOutGoingConnections(std::string relationship);
@@ -294,8 +305,14 @@ class Processor : public Connectable, public ConfigurableComponent, public std::
 
  private:
 
+  // rebuilds outgoing_snapshot_, must be called with mutex_ held
+  void updateOutgoingSnapshot();
+
   // Mutex for protection
   std::mutex mutex_;
+  // outgoing connections, replaced as a whole so that back pressure checks need no lock
+  std::shared_ptr<const std::vector<std::shared_ptr<Connection>>> outgoing_snapshot_;
+  std::atomic<bool> back_pressured_;
   // Yield Expiration
   std::atomic<uint64_t> yield_expiration_;
 
@@ -0,0 +1,240 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_PROPERTYSNAPSHOT_H_
+#define LIBMINIFI_INCLUDE_CORE_PROPERTYSNAPSHOT_H_
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "core/FlowFile.h"
+#include "core/ProcessContext.h"
+#include "core/Property.h"
+#include "core/logging/LoggerConfiguration.h"
+#include "utils/StringUtils.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+/**
+ * Typed handle to a property bound into a PropertySnapshot. The handle carries the slot
+ * of the value within the snapshot, so that reading it is an index rather than a name lookup.
+ */
+template<typename T>
+class PropertyHandle {
+ public:
+  PropertyHandle()
+      : index_(-1),
+        expression_(false),
+        property_(nullptr) {
+  }
+
+  bool isBound() const {
+    return index_ >= 0;
+  }
+
+  // true if the property supports expression language and must be evaluated per flow file
+  bool isExpression() const {
+    return expression_;
+  }
+
+  const Property *getProperty() const {
+    return property_;
+  }
+
+ private:
+  friend class PropertySnapshot;
+
+  PropertyHandle(int index, bool expression, const Property *property)
+      : index_(index),
+        expression_(expression),
+        property_(property) {
+  }
+
+  int index_;
+  bool expression_;
+  const Property *property_;
+};
+
+/**
+ * Purpose: Immutable view of a processor's properties, read and converted to their typed values
+ * once when the processor is scheduled.
+ *
+ * Design: Processors bind the properties they read in onTrigger through a Builder in onSchedule
+ * and keep the returned handles. The snapshot is never modified once built, so reads neither lock
+ * the processor's configuration nor copy or parse values. Properties supporting expression language
+ * are not captured; reading them is delegated to the ProcessContext, which keeps the compiled
+ * expression.
+ */
+class PropertySnapshot {
+ public:
+  class Builder {
+   public:
+    explicit Builder(ProcessContext &context)
+        : context_(context),
+          snapshot_(new PropertySnapshot()) {
+    }
+
+    /**
+     * Binds a property into the snapshot.
+     * @param property property to bind. Must outlive the snapshot, which is the case for the
+     * static properties of a processor.
+     * @param default_value value used when the property is unset or cannot be converted.
+     * @return handle to the bound value.
+     */
+    template<typename T>
+    PropertyHandle<T> bind(const Property &property, const T &default_value = T()) {
+      const int index = snapshot_->slots_.size();
+      std::unique_ptr<TypedSlot<T>> slot(new TypedSlot<T>(default_value));
+      if (property.supportsExpressionLangauge()) {
+        snapshot_->slots_.push_back(std::move(slot));
+        return PropertyHandle<T>(index, true, &property);
+      }
+      std::string value;
+      if (context_.getProperty(property.getName(), value)) {
+        if (convert(value, slot->value_)) {
+          slot->set_ = true;
+        } else {
+          slot->value_ = default_value;
+          snapshot_->logger_->log_warn("Invalid value %s for property %s, using the default", value, property.getName());
+        }
+      }
+      snapshot_->slots_.push_back(std::move(slot));
+      return PropertyHandle<T>(index, false, &property);
+    }
+
+    std::shared_ptr<const PropertySnapshot> build() {
+      return std::shared_ptr<const PropertySnapshot>(snapshot_.release());
+    }
+
+   private:
+    ProcessContext &context_;
+    std::unique_ptr<PropertySnapshot> snapshot_;
+  };
+
+  /**
+   * Returns the value bound for the handle. Properties supporting expression language
+   * return their default value; use getProperty to evaluate them.
+   */
+  template<typename T>
+  const T &get(const PropertyHandle<T> &handle) const {
+    return static_cast<const TypedSlot<T>&>(*slots_[handle.index_]).value_;
+  }
+
+  /**
+   * Returns true if the property was set to a valid value when the snapshot was taken.
+   */
+  template<typename T>
+  bool isSet(const PropertyHandle<T> &handle) const {
+    return slots_[handle.index_]->set_;
+  }
+
+  /**
+   * Reads the value for the handle, evaluating expression language against the flow file if
+   * the property supports it.
+   * @return true if the property has a value.
+   */
+  template<typename T>
+  bool getProperty(ProcessContext &context, const PropertyHandle<T> &handle, T &value, const std::shared_ptr<FlowFile> &flow_file = nullptr) const {
+    if (!handle.isExpression()) {
+      value = get(handle);
+      return isSet(handle);
+    }
+    std::string evaluated;
+    if (!context.getProperty(*handle.getProperty(), evaluated, flow_file)) {
+      value = get(handle);
+      return false;
+    }
+    if (!convert(evaluated, value)) {
+      value = get(handle);
+      return false;
+    }
+    return true;
+  }
+
+  size_t size() const {
+    return slots_.size();
+  }
+
+  static bool convert(const std::string &input, std::string &output) {
+    output = input;
+    return true;
+  }
+
+  static bool convert(const std::string &input, bool &output) {
+    return utils::StringUtils::StringToBool(input, output);
+  }
+
+  static bool convert(const std::string &input, int &output) {
+    return Property::StringToInt(input, output);
+  }
+
+  static bool convert(const std::string &input, int64_t &output) {
+    return Property::StringToInt(input, output);
+  }
+
+  static bool convert(const std::string &input, uint64_t &output) {
+    return Property::StringToInt(input, output);
+  }
+
+  static bool convert(const std::string &input, std::chrono::milliseconds &output) {
+    int64_t value;
+    TimeUnit unit;
+    if (Property::StringToTime(input, value, unit) && Property::ConvertTimeUnitToMS(value, unit, value)) {
+      output = std::chrono::milliseconds(value);
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  struct Slot {
+    Slot()
+        : set_(false) {
+    }
+    virtual ~Slot() {
+    }
+    bool set_;
+  };
+
+  template<typename T>
+  struct TypedSlot : public Slot {
+    explicit TypedSlot(const T &value)
+        : value_(value) {
+    }
+    T value_;
+  };
+
+  PropertySnapshot()
+      : logger_(logging::LoggerFactory<PropertySnapshot>::getLogger()) {
+  }
+
+  std::vector<std::unique_ptr<Slot>> slots_;
+  std::shared_ptr<logging::Logger> logger_;
+};
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_CORE_PROPERTYSNAPSHOT_H_ */
@@ -66,6 +66,11 @@ class Repository : public virtual core::SerializableComponent, public core::Trac
       : core::SerializableComponent(repo_name),
         thread_(),
         repo_size_(0),
+        recovering_(false),
+        recovered_count_(0),
+        recovery_expected_(0),
+        recovery_start_ms_(0),
+        recovery_end_ms_(0),
         logger_(logging::LoggerFactory<Repository>::getLogger()) {
     directory_ = directory;
     max_partition_millis_ = maxPartitionMillis;
@@ -94,6 +99,13 @@ class Repository : public virtual core::SerializableComponent, public core::Trac
   virtual bool Delete(std::string key) {
     return true;
   }
+  /**
+   * Deletes the key of a flow file and removes its content once the flow file record
+   * no longer exists and no other flow file owns the claim.
+   */
+  virtual bool Delete(std::string key, const std::shared_ptr<minifi::ResourceClaim> &claim) {
+    return Delete(key);
+  }
 
   virtual bool Delete(std::vector<std::shared_ptr<core::SerializableComponent>> &storedValues) {
     bool found = true;
@@ -178,6 +190,37 @@ class Repository : public virtual core::SerializableComponent, public core::Trac
     return true;
   }
 
+  /**
+   * Deserializes up to max_size objects into record, one at a time, starting after the cursor
+   * persisted by DeleteAndAdvanceCursor and wrapping around to the first key, so that repeated
+   * scans resume where the last one stopped instead of starting over.
+   * @param max_size maximum number of objects to visit
+   * @param record object that each entry is deserialized into
+   * @param visitor called with the key of each deserialized object, returns false to stop the scan
+   * @return number of objects visited
+   *
+   * Base implementation visits nothing.
+   */
+  virtual size_t DeSerializeFromCursor(size_t max_size, const std::shared_ptr<core::SerializableComponent> &record, const std::function<bool(const std::string &key)> &visitor) {
+    return 0;
+  }
+
+  /**
+   * Deletes keys and persists cursor as the position DeSerializeFromCursor resumes after
+   * @param keys keys to delete
+   * @param cursor key of the last object visited
+   * @return status of this operation
+   *
+   * Base implementation deletes the keys one at a time.
+   */
+  virtual bool DeleteAndAdvanceCursor(const std::vector<std::string> &keys, const std::string &cursor) {
+    bool found = true;
+    for (const auto &key : keys) {
+      found &= Delete(key);
+    }
+    return found;
+  }
+
   /**
    * Base implementation returns true;
    */
@@ -213,6 +256,26 @@ class Repository : public virtual core::SerializableComponent, public core::Trac
 
   virtual uint64_t getRepoSize();
 
+  // whether flow files stored by a previous run are being recovered
+  bool isRecovering() const {
+    return recovering_;
+  }
+
+  // number of flow files recovered so far
+  uint64_t getRecoveredCount() const {
+    return recovered_count_;
+  }
+
+  // estimated number of flow files to recover
+  uint64_t getRecoveryExpected() const {
+    return recovery_expected_;
+  }
+
+  /**
+   * Returns the number of flow files recovered per second, 0 if nothing was recovered.
+   */
+  uint64_t getRecoveryRate() const;
+
   // Prevent default copy constructor and assignment operation
   // Only support pass by reference or pointer
   Repository(const Repository &parent) = delete;
@@ -240,6 +303,12 @@ class Repository : public virtual core::SerializableComponent, public core::Trac
 
   // size of the directory
   std::atomic<uint64_t> repo_size_;
+  // recovery of stored flow files
+  std::atomic<bool> recovering_;
+  std::atomic<uint64_t> recovered_count_;
+  std::atomic<uint64_t> recovery_expected_;
+  std::atomic<uint64_t> recovery_start_ms_;
+  std::atomic<uint64_t> recovery_end_ms_;
   // Run function for the thread
   void threadExecutor() {
     run();
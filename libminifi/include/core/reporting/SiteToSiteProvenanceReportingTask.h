@@ -49,6 +49,7 @@ class SiteToSiteProvenanceReportingTask : public minifi::RemoteProcessorGroupPor
         logger_(logging::LoggerFactory<SiteToSiteProvenanceReportingTask>::getLogger()) {
     this->setTriggerWhenEmpty(true);
     batch_size_ = 100;
+    max_packet_size_ = DefaultMaxPacketSize;
   }
   //! Destructor
   ~SiteToSiteProvenanceReportingTask() {
@@ -56,11 +57,24 @@ class SiteToSiteProvenanceReportingTask : public minifi::RemoteProcessorGroupPor
   //! Report Task Name
   static constexpr char const* ReportTaskName = "SiteToSiteProvenanceReportingTask";
   static const char *ProvenanceAppStr;
+  //! Size at which a report is cut into another packet of the transaction
+  static const size_t DefaultMaxPacketSize = 256 * 1024;
 
  public:
   //! Get provenance json report
   void getJsonReport(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session, std::vector<std::shared_ptr<core::SerializableComponent>> &records, std::string &report);
 
+  /**
+   * Streams up to the batch size of records from repo as compact JSON arrays, handing an array to
+   * send whenever it reaches the maximum packet size, so memory stays bounded by one packet
+   * @param repo provenance repository to read from
+   * @param send sends one packet
+   * @param keys receives the key of every record written
+   * @param cursor receives the key of the last record written
+   * @return false if a packet could not be sent
+   */
+  bool streamJsonReport(const std::shared_ptr<core::Repository> &repo, const sitetosite::PayloadSender &send, std::vector<std::string> &keys, std::string &cursor);
+
 
   void onSchedule(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory);
   //! OnTrigger method, implemented by NiFi SiteToSiteProvenanceReportingTask
@@ -81,6 +95,14 @@ class SiteToSiteProvenanceReportingTask : public minifi::RemoteProcessorGroupPor
   int getBatchSize(void) {
     return (batch_size_);
   }
+  //! Set Max Packet Size
+  void setMaxPacketSize(size_t size) {
+    max_packet_size_ = size;
+  }
+  //! Get Max Packet Size
+  size_t getMaxPacketSize(void) {
+    return (max_packet_size_);
+  }
   //! Get Port UUID
   void getPortUUID(utils::Identifier & port_uuid) {
     port_uuid = protocol_uuid_;
@@ -91,6 +113,8 @@ class SiteToSiteProvenanceReportingTask : public minifi::RemoteProcessorGroupPor
  private:
   int batch_size_;
 
+  size_t max_packet_size_;
+
   std::shared_ptr<logging::Logger> logger_;
 };
 
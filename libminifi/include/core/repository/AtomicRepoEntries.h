@@ -299,6 +299,22 @@ class AtomicEntry {
     return true;
   }
 
+  /**
+   * Calls reader with the value while leaving it in this atomic entry
+   * @param reader reads the value, must not call back into this entry
+   * @return  success of read operation based on whether or not this atomic entry has a value.
+   */
+  bool readValue(const std::function<void(RepoValue<T> &value)> &reader) {
+    try_lock();
+    if (!has_value_) {
+      try_unlock();
+      return false;
+    }
+    reader(value_);
+    try_unlock();
+    return true;
+  }
+
   void decrementOwnership() {
     try_lock();
     if (!has_value_) {
@@ -59,6 +59,10 @@ class FileSystemRepository : public core::ContentRepository, public core::CoreCo
 
   virtual bool remove(const std::shared_ptr<minifi::ResourceClaim> &claim);
 
+  virtual std::string getContentPath(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+    return claim->getContentFullPath();
+  }
+
  private:
 
   std::shared_ptr<logging::Logger> logger_;
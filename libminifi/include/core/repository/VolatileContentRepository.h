@@ -18,6 +18,8 @@
 #ifndef LIBMINIFI_INCLUDE_CORE_REPOSITORY_VolatileContentRepository_H_
 #define LIBMINIFI_INCLUDE_CORE_REPOSITORY_VolatileContentRepository_H_
 
+#include <set>
+#include <string>
 #include "core/Core.h"
 #include "AtomicRepoEntries.h"
 #include "io/AtomicEntryStream.h"
@@ -36,11 +38,16 @@ namespace repository {
 /**
  * Purpose: Stages content into a volatile area of memory. Note that   when the maximum number
  * of entries is consumed we will rollback a session to wait for others to be freed.
+ *
+ * With a spill directory, content is written to files in that directory instead while the
+ * MemoryGovernor is under pressure or the repository is full. Spilled content is volatile too:
+ * its files are removed with the claim and at the next start.
  */
 class VolatileContentRepository : public core::ContentRepository, public virtual core::repository::VolatileRepository<std::shared_ptr<minifi::ResourceClaim>> {
  public:
 
   static const char *minimal_locking;
+  static const char *spill_directory;
 
   explicit VolatileContentRepository(std::string name = getClassName<VolatileContentRepository>())
       : core::SerializableComponent(name),
@@ -108,6 +115,13 @@ class VolatileContentRepository : public core::ContentRepository, public virtual
 
   virtual void run();
 
+  /**
+   * Writes the claim to the spill directory. map_mutex_ must be held.
+   */
+  std::shared_ptr<io::BaseStream> spill(const std::shared_ptr<minifi::ResourceClaim> &claim, bool append);
+
+  std::string getSpillPath(const std::shared_ptr<minifi::ResourceClaim> &claim) const;
+
   template<typename T2>
   std::shared_ptr<T2> shared_from_parent() {
     return std::dynamic_pointer_cast<T2>(shared_from_this());
@@ -128,6 +142,10 @@ class VolatileContentRepository : public core::ContentRepository, public virtual
 
   std::map<std::string, AtomicEntry<std::shared_ptr<minifi::ResourceClaim>>*> master_list_;
 
+  std::string spill_directory_;
+  // content paths of the claims written to the spill directory, guarded by map_mutex_
+  std::set<std::string> spilled_claims_;
+
   // logger
   std::shared_ptr<logging::Logger> logger_;
 };
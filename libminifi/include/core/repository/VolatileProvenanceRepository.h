@@ -18,6 +18,12 @@
 #ifndef LIBMINIFI_INCLUDE_CORE_REPOSITORY_VOLATILEPROVENANCEREPOSITORY_H_
 #define LIBMINIFI_INCLUDE_CORE_REPOSITORY_VOLATILEPROVENANCEREPOSITORY_H_
 
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 #include "VolatileRepository.h"
 
 namespace org {
@@ -45,12 +51,65 @@ class VolatileProvenanceRepository : public VolatileRepository<std::string> {
   virtual void run() {
     repo_full_ = false;
   }
+
+  /**
+   * Visits the records slot by slot without taking them out of the repository, starting after
+   * the slot of the last cursor passed to DeleteAndAdvanceCursor and wrapping around
+   */
+  virtual size_t DeSerializeFromCursor(size_t max_size, const std::shared_ptr<core::SerializableComponent> &record, const std::function<bool(const std::string &key)> &visitor) {
+    std::lock_guard<std::mutex> lock(cursor_mutex_);
+    scanned_slots_.clear();
+    size_t visited = 0;
+    const size_t slots = value_vector_.size();
+    for (size_t i = 0; i < slots && visited < max_size; i++) {
+      const size_t slot = (cursor_ + i) % slots;
+      std::string key;
+      bool read = false;
+      value_vector_[slot]->readValue([&](RepoValue<std::string> &value) {
+        key = value.getKey();
+        read = record->DeSerialize(value.getBuffer(), value.getBufferSize());
+      });
+      if (read) {
+        visited++;
+        scanned_slots_[key] = slot;
+        if (!visitor(key)) {
+          break;
+        }
+      }
+    }
+    return visited;
+  }
+
+  virtual bool DeleteAndAdvanceCursor(const std::vector<std::string> &keys, const std::string &cursor) {
+    std::lock_guard<std::mutex> lock(cursor_mutex_);
+    bool found = true;
+    for (const auto &key : keys) {
+      auto slot = scanned_slots_.find(key);
+      RepoValue<std::string> value;
+      // the slot of a record may have been reused by a newer one since the scan, which is then kept
+      if (slot != scanned_slots_.end() && value_vector_[slot->second]->getValue(key, value)) {
+        current_size_ -= value.size();
+      } else {
+        found &= Delete(key);
+      }
+    }
+    auto cursor_slot = scanned_slots_.find(cursor);
+    if (cursor_slot != scanned_slots_.end()) {
+      cursor_ = cursor_slot->second + 1;
+    }
+    scanned_slots_.clear();
+    return found;
+  }
  protected:
   virtual void emplace(RepoValue<std::string> &old_value) {
     purge_list_.push_back(old_value.getKey());
   }
  private:
-
+  std::mutex cursor_mutex_;
+  // slot the next scan starts at
+  size_t cursor_ = 0;
+  // slots of the records visited by the last scan, by key
+  std::map<std::string, size_t> scanned_slots_;
 };
 
 } /* namespace repository */
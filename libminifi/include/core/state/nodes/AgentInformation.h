@@ -53,6 +53,7 @@
 #include "agent/agent_docs.h"
 #include "agent/build_description.h"
 #include "core/ClassLoader.h"
+#include "core/MemoryGovernor.h"
 #include "core/state/nodes/StateMonitor.h"
 #include "core/ProcessorConfig.h"
 #include "SchedulingNodes.h"
@@ -462,6 +463,44 @@ class AgentStatus : public StateMonitorNode {
 
     serialized.push_back(uptime);
 
+    auto &governor = core::MemoryGovernor::getInstance();
+    if (governor.isEnabled()) {
+      SerializedResponseNode memory;
+      memory.name = "memory";
+
+      SerializedResponseNode limit;
+      limit.name = "limit";
+      limit.value = governor.getLimit();
+
+      SerializedResponseNode usage;
+      usage.name = "usage";
+      usage.value = governor.getUsage();
+
+      SerializedResponseNode resident;
+      resident.name = "residentSize";
+      resident.value = governor.getResidentSize();
+
+      SerializedResponseNode reserved;
+      reserved.name = "reserved";
+      reserved.value = governor.getReserved();
+
+      SerializedResponseNode refused;
+      refused.name = "refusedReservations";
+      refused.value = governor.getRefusedCount();
+
+      SerializedResponseNode pressure;
+      pressure.name = "underPressure";
+      pressure.value = governor.isUnderPressure();
+
+      memory.children.push_back(limit);
+      memory.children.push_back(usage);
+      memory.children.push_back(resident);
+      memory.children.push_back(reserved);
+      memory.children.push_back(refused);
+      memory.children.push_back(pressure);
+      serialized.push_back(memory);
+    }
+
     if (nullptr != monitor_) {
       auto components = monitor_->getAllComponents();
       SerializedResponseNode componentsNode(false);
@@ -0,0 +1,129 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_STATE_NODES_CONCURRENCYMETRICS_H_
+#define LIBMINIFI_INCLUDE_CORE_STATE_NODES_CONCURRENCYMETRICS_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../nodes/MetricsBase.h"
+#include "ThreadedSchedulingAgent.h"
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace state {
+namespace response {
+
+/**
+ * Justification and Purpose: Provides the decisions made by adaptive concurrency for each
+ * processor, so that the C2 server can see how many workers a processor is running and why.
+ *
+ */
+class ConcurrencyMetrics : public ResponseNode {
+ public:
+
+  ConcurrencyMetrics(const std::string &name, utils::Identifier &uuid)
+      : ResponseNode(name, uuid) {
+  }
+
+  ConcurrencyMetrics(const std::string &name)
+      : ResponseNode(name) {
+  }
+
+  ConcurrencyMetrics()
+      : ResponseNode("ConcurrencyMetrics") {
+  }
+
+  virtual std::string getName() const {
+    return "ConcurrencyMetrics";
+  }
+
+  void addSchedulingAgent(const std::shared_ptr<minifi::ThreadedSchedulingAgent> &agent) {
+    if (nullptr != agent) {
+      agents_.push_back(agent);
+    }
+  }
+
+  std::vector<SerializedResponseNode> serialize() {
+    std::vector<SerializedResponseNode> serialized;
+    for (const auto &agent : agents_) {
+      for (const auto &concurrency : agent->getAdaptiveConcurrency()) {
+        SerializedResponseNode parent;
+        parent.name = concurrency->getName();
+
+        SerializedResponseNode activeWorkers;
+        activeWorkers.name = "activeWorkers";
+        activeWorkers.value = std::to_string(concurrency->getActiveWorkers());
+
+        SerializedResponseNode minWorkers;
+        minWorkers.name = "minWorkers";
+        minWorkers.value = std::to_string(concurrency->getMinTasks());
+
+        SerializedResponseNode maxWorkers;
+        maxWorkers.name = "maxWorkers";
+        maxWorkers.value = std::to_string(concurrency->getMaxTasks());
+
+        SerializedResponseNode queued;
+        queued.name = "queued";
+        queued.value = std::to_string(concurrency->getLastQueueDepth());
+
+        SerializedResponseNode latency;
+        latency.name = "averageLatencyMillis";
+        latency.value = std::to_string(concurrency->getAverageLatency());
+
+        SerializedResponseNode grown;
+        grown.name = "growCount";
+        grown.value = std::to_string(concurrency->getGrowCount());
+
+        SerializedResponseNode shrunk;
+        shrunk.name = "shrinkCount";
+        shrunk.value = std::to_string(concurrency->getShrinkCount());
+
+        SerializedResponseNode lastDecision;
+        lastDecision.name = "lastDecision";
+        lastDecision.value = minifi::AdaptiveConcurrency::getDecisionName(concurrency->getLastDecision());
+
+        parent.children.push_back(activeWorkers);
+        parent.children.push_back(minWorkers);
+        parent.children.push_back(maxWorkers);
+        parent.children.push_back(queued);
+        parent.children.push_back(latency);
+        parent.children.push_back(grown);
+        parent.children.push_back(shrunk);
+        parent.children.push_back(lastDecision);
+
+        serialized.push_back(parent);
+      }
+    }
+    return serialized;
+  }
+
+ protected:
+  std::vector<std::shared_ptr<minifi::ThreadedSchedulingAgent>> agents_;
+};
+
+} /* namespace metrics */
+} /* namespace state */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_CORE_STATE_NODES_CONCURRENCYMETRICS_H_ */
@@ -0,0 +1,124 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_CORE_STATE_NODES_EXECUTORMETRICS_H_
+#define LIBMINIFI_INCLUDE_CORE_STATE_NODES_EXECUTORMETRICS_H_
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../nodes/MetricsBase.h"
+#include "utils/ThreadPool.h"
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace state {
+namespace response {
+
+/**
+ * Justification and Purpose: Provides the time scheduling agent threads spent running tasks on
+ * each CPU, along with the utilization of that CPU since the previous report, so that thread
+ * affinity settings can be verified from the C2 server.
+ *
+ */
+class ExecutorMetrics : public ResponseNode {
+ public:
+
+  ExecutorMetrics(const std::string &name, utils::Identifier &uuid)
+      : ResponseNode(name, uuid),
+        last_report_(std::chrono::steady_clock::now()) {
+  }
+
+  ExecutorMetrics(const std::string &name)
+      : ResponseNode(name),
+        last_report_(std::chrono::steady_clock::now()) {
+  }
+
+  ExecutorMetrics()
+      : ResponseNode("ExecutorMetrics"),
+        last_report_(std::chrono::steady_clock::now()) {
+  }
+
+  virtual std::string getName() const {
+    return "ExecutorMetrics";
+  }
+
+  void addThreadPool(const std::shared_ptr<utils::ThreadPool<uint64_t>> &pool) {
+    // scheduling agents may share a single pool
+    if (nullptr != pool && std::find(pools_.begin(), pools_.end(), pool) == pools_.end()) {
+      pools_.push_back(pool);
+    }
+  }
+
+  std::vector<SerializedResponseNode> serialize() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<int, uint64_t> busy;
+    for (const auto &pool : pools_) {
+      for (const auto &cpu : pool->getCpuBusyTime()) {
+        busy[cpu.first] += cpu.second;
+      }
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_report_).count();
+    last_report_ = now;
+
+    std::vector<SerializedResponseNode> serialized;
+    for (const auto &cpu : busy) {
+      SerializedResponseNode parent;
+      parent.name = cpu.first < 0 ? "unknown" : "cpu" + std::to_string(cpu.first);
+
+      SerializedResponseNode busyTime;
+      busyTime.name = "busyMillis";
+      busyTime.value = std::to_string(cpu.second / 1000000);
+
+      // the totals only grow, unless the pool was replaced meanwhile
+      uint64_t previous = last_busy_[cpu.first];
+      uint64_t delta = cpu.second > previous ? cpu.second - previous : 0;
+      SerializedResponseNode utilization;
+      utilization.name = "utilizationPercent";
+      utilization.value = std::to_string(elapsed > 0 ? std::min<uint64_t>(100, delta * 100 / elapsed) : 0);
+
+      parent.children.push_back(busyTime);
+      parent.children.push_back(utilization);
+      serialized.push_back(parent);
+    }
+    last_busy_ = busy;
+    return serialized;
+  }
+
+ protected:
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<utils::ThreadPool<uint64_t>>> pools_;
+  std::map<int, uint64_t> last_busy_;
+  std::chrono::steady_clock::time_point last_report_;
+};
+
+} /* namespace metrics */
+} /* namespace state */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_CORE_STATE_NODES_EXECUTORMETRICS_H_ */
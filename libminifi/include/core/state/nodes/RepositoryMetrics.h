@@ -82,6 +82,30 @@ class RepositoryMetrics : public ResponseNode {
       parent.children.push_back(datasizemax);
       parent.children.push_back(queuesize);
 
+      // only repositories that recover stored flow files report recovery
+      if (repo->isRecovering() || repo->getRecoveredCount() > 0) {
+        SerializedResponseNode recovering;
+        recovering.name = "recovering";
+        recovering.value = repo->isRecovering();
+
+        SerializedResponseNode recovered;
+        recovered.name = "recovered";
+        recovered.value = std::to_string(repo->getRecoveredCount());
+
+        SerializedResponseNode expected;
+        expected.name = "recoveryExpected";
+        expected.value = std::to_string(repo->getRecoveryExpected());
+
+        SerializedResponseNode rate;
+        rate.name = "recoveryRatePerSecond";
+        rate.value = std::to_string(repo->getRecoveryRate());
+
+        parent.children.push_back(recovering);
+        parent.children.push_back(recovered);
+        parent.children.push_back(expected);
+        parent.children.push_back(rate);
+      }
+
       serialized.push_back(parent);
     }
     return serialized;
@@ -46,6 +46,14 @@ class Configure : public Properties {
   static const char *nifi_flow_configuration_file_exit_failure;
   static const char *nifi_flow_configuration_file_backup_update;
   static const char *nifi_flow_engine_threads;
+  static const char *nifi_flow_engine_adaptive_concurrency;
+  static const char *nifi_flow_engine_adaptive_min_tasks;
+  static const char *nifi_flow_engine_adaptive_evaluation_period;
+  static const char *nifi_flow_engine_shared_executor;
+  static const char *nifi_flow_engine_shared_executor_threads;
+  static const char *nifi_flow_engine_thread_affinity;
+  static const char *nifi_flow_engine_thread_affinity_cpus;
+  static const char *nifi_flow_engine_backpressure_low_watermark;
   static const char *nifi_administrative_yield_duration;
   static const char *nifi_bored_yield_duration;
   static const char *nifi_graceful_shutdown_seconds;
@@ -67,6 +75,18 @@ class Configure : public Properties {
   static const char *nifi_flowfile_repository_max_storage_size;
   static const char *nifi_flowfile_repository_directory_default;
   static const char *nifi_flowfile_repository_enable;
+  static const char *nifi_flowfile_repository_recovery_threads;
+  static const char *nifi_flowfile_repository_rocksdb_options;
+  static const char *nifi_provenance_repository_rocksdb_options;
+  static const char *nifi_dbcontent_repository_rocksdb_options;
+  static const char *nifi_rocksdb_memory_limit;
+  static const char *nifi_rocksdb_compaction_threads;
+  static const char *nifi_rocksdb_flush_threads;
+  static const char *nifi_rocksdb_statistics;
+  static const char *nifi_memory_limit;
+  static const char *nifi_memory_low_watermark;
+  static const char *nifi_memory_high_watermark;
+  static const char *nifi_memory_sample_period;
   static const char *nifi_remote_input_secure;
   static const char *nifi_remote_input_http;
   static const char *nifi_security_need_ClientAuth;
@@ -86,6 +106,9 @@ class Configure : public Properties {
   static const char *nifi_c2_flow_url;
   static const char *nifi_c2_flow_base_url;
 
+  // extension options
+  static const char *nifi_extension_lazy_initialization;
+
  private:
   std::string agent_identifier_;
   std::mutex mutex_;
@@ -161,6 +161,10 @@ class RawSiteToSiteClient : public sitetosite::SiteToSiteClient {
   virtual bool transmitPayload(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session, const std::string &payload,
                                std::map<std::string, std::string> attributes);
 
+  //! Transfer strings for the process session in a single transaction
+  virtual bool transmitPayloads(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session,
+                                const std::function<bool(const PayloadSender &send)> &producer, std::map<std::string, std::string> attributes);
+
   // bootstrap the protocol to the ready for transaction state by going through the state machine
   virtual bool bootstrap();
  protected:
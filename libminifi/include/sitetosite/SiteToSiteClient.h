@@ -19,6 +19,7 @@
 #ifndef LIBMINIFI_INCLUDE_CORE_SITETOSITE_SITETOSITECLIENT_H_
 #define LIBMINIFI_INCLUDE_CORE_SITETOSITE_SITETOSITECLIENT_H_
 
+#include <functional>
 #include "Peer.h"
 #include "SiteToSite.h"
 #include "core/ProcessSession.h"
@@ -51,6 +52,12 @@ class DataPacket {
   std::shared_ptr<logging::Logger> logger_reference_;
 };
 
+/**
+ * Sends one payload as its own packet of an open transaction. The payload may be
+ * reused as soon as the call returns.
+ */
+typedef std::function<bool(const std::string &payload)> PayloadSender;
+
 class SiteToSiteClient : public core::Connectable {
 
  public:
@@ -145,6 +152,30 @@ class SiteToSiteClient : public core::Connectable {
   virtual bool transmitPayload(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session, const std::string &payload,
                                std::map<std::string, std::string> attributes) = 0;
 
+  /**
+   * Transfers raw data and attributes to server as several packets of one transaction
+   * @param context process context
+   * @param session process session
+   * @param producer called once with a sender for each packet, returns false to abandon the transaction
+   * @param attributes attributes of every packet
+   * @returns true if a transaction was sent and confirmed, false if there was nothing to send,
+   * exception thrown otherwise
+   *
+   * Base implementation sends every packet in a transaction of its own.
+   */
+  virtual bool transmitPayloads(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session,
+                                const std::function<bool(const PayloadSender &send)> &producer, std::map<std::string, std::string> attributes) {
+    bool sent = false;
+    bool produced = producer([&](const std::string &payload) {
+      if (!transmitPayload(context, session, payload, attributes)) {
+        return false;
+      }
+      sent = true;
+      return true;
+    });
+    return produced && sent;
+  }
+
   void setPortId(utils::Identifier &id) {
     port_id_ = id;
     port_id_str_ = port_id_.to_string();
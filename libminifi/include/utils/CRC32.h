@@ -0,0 +1,57 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_UTILS_CRC32_H_
+#define LIBMINIFI_INCLUDE_UTILS_CRC32_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+namespace CRC32 {
+
+/**
+ * Continues the CRC-32 of zlib and java.util.zip.CRC32, which Site-to-Site confirms
+ * transfers with, over length bytes of data. Starts from 0 like crc32(0L, Z_NULL, 0).
+ *
+ * Uses carry-less multiplication on x86 and the CRC32 instructions of ARMv8 when
+ * the CPU supports them, and zlib otherwise.
+ */
+extern uint32_t update(uint32_t crc, const uint8_t *data, size_t length);
+
+/**
+ * The same checksum, always computed by zlib.
+ */
+extern uint32_t updatePortable(uint32_t crc, const uint8_t *data, size_t length);
+
+/**
+ * Names the implementation update uses on this CPU: "pclmul", "armv8-crc" or "zlib".
+ */
+extern const char *getImplementation();
+
+} /* namespace CRC32 */
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_UTILS_CRC32_H_ */
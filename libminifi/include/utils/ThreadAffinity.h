@@ -0,0 +1,67 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_UTILS_THREADAFFINITY_H_
+#define LIBMINIFI_INCLUDE_UTILS_THREADAFFINITY_H_
+
+#include <string>
+#include <vector>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+namespace ThreadAffinity {
+
+/**
+ * Parses a CPU list such as "0-3,8,10-11".
+ * @param list comma separated CPU numbers and ranges
+ * @return CPUs in the list, or an empty vector if the list is malformed.
+ */
+extern std::vector<int> parseCpuList(const std::string &list);
+
+/**
+ * Returns the CPUs this process may run on.
+ */
+extern std::vector<int> getAvailableCpus();
+
+/**
+ * Returns the CPUs of each NUMA node, restricted to the provided CPUs. Nodes without any of the
+ * provided CPUs are omitted. If NUMA topology cannot be determined a single node is returned.
+ * @param cpus CPUs to consider
+ */
+extern std::vector<std::vector<int>> getNumaNodes(const std::vector<int> &cpus);
+
+/**
+ * Binds the calling thread to the provided CPUs.
+ * @return true if the binding was applied.
+ */
+extern bool pinCurrentThread(const std::vector<int> &cpus);
+
+/**
+ * Returns the CPU the calling thread is running on, or -1 if unknown.
+ */
+extern int getCurrentCpu();
+
+} /* namespace ThreadAffinity */
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_UTILS_THREADAFFINITY_H_ */
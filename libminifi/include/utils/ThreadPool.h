@@ -30,6 +30,7 @@
 #include <functional>
 
 #include "BackTrace.h"
+#include "ThreadAffinity.h"
 #include "core/expect.h"
 #include "controllers/ThreadManagementService.h"
 #include "concurrentqueue.h"
@@ -79,6 +80,7 @@ class Worker {
   explicit Worker(std::function<T()> &task, const std::string &identifier, std::unique_ptr<AfterExecute<T>> run_determinant)
       : identifier_(identifier),
         time_slice_(0),
+        affinity_group_(-1),
         task(task),
         run_determinant_(std::move(run_determinant)) {
     promise = std::make_shared<std::promise<T>>();
@@ -87,6 +89,7 @@ class Worker {
   explicit Worker(std::function<T()> &task, const std::string &identifier)
       : identifier_(identifier),
         time_slice_(0),
+        affinity_group_(-1),
         task(task),
         run_determinant_(nullptr) {
     promise = std::make_shared<std::promise<T>>();
@@ -94,7 +97,8 @@ class Worker {
 
   explicit Worker(const std::string identifier = "")
       : identifier_(identifier),
-        time_slice_(0) {
+        time_slice_(0),
+        affinity_group_(-1) {
   }
 
   virtual ~Worker() {
@@ -107,6 +111,7 @@ class Worker {
   Worker(Worker &&other)
       : identifier_(std::move(other.identifier_)),
         time_slice_(std::move(other.time_slice_)),
+        affinity_group_(other.affinity_group_),
         task(std::move(other.task)),
         run_determinant_(std::move(other.run_determinant_)),
         promise(other.promise) {
@@ -141,6 +146,18 @@ class Worker {
     return run_determinant_->wait_time();
   }
 
+  /**
+   * Sets the affinity group of the thread pool this task prefers to run in.
+   * @param group affinity group, -1 if the task may run anywhere.
+   */
+  void setAffinityGroup(int group) {
+    affinity_group_ = group;
+  }
+
+  int getAffinityGroup() const {
+    return affinity_group_;
+  }
+
   Worker<T>(const Worker<T>&) = delete;
   Worker<T>& operator =(const Worker<T>&) = delete;
 
@@ -161,6 +178,7 @@ class Worker {
 
   std::string identifier_;
   uint64_t time_slice_;
+  int affinity_group_;
   std::function<T()> task;
   std::unique_ptr<AfterExecute<T>> run_determinant_;
   std::shared_ptr<std::promise<T>> promise;
@@ -179,6 +197,7 @@ Worker<T>& Worker<T>::operator =(Worker<T> && other) {
   task = std::move(other.task);
   promise = other.promise;
   time_slice_ = std::move(other.time_slice_);
+  affinity_group_ = other.affinity_group_;
   identifier_ = std::move(other.identifier_);
   run_determinant_ = std::move(other.run_determinant_);
   return *this;
@@ -194,17 +213,21 @@ class WorkerThread {
   explicit WorkerThread(std::thread thread, const std::string &name = "NamelessWorker")
       : is_running_(false),
         thread_(std::move(thread)),
-        name_(name) {
+        name_(name),
+        affinity_group_(-1) {
 
   }
   WorkerThread(const std::string &name = "NamelessWorker")
       : is_running_(false),
-        name_(name) {
+        name_(name),
+        affinity_group_(-1) {
 
   }
   std::atomic<bool> is_running_;
   std::thread thread_;
   std::string name_;
+  // affinity group this thread is bound to, -1 if unbound
+  int affinity_group_;
 };
 
 /**
@@ -224,6 +247,7 @@ class ThreadPool {
         max_worker_threads_(max_worker_threads),
         adjust_threads_(false),
         running_(false),
+        follow_task_affinity_(false),
         controller_service_provider_(controller_service_provider),
         name_(name) {
     current_workers_ = 0;
@@ -237,6 +261,8 @@ class ThreadPool {
         max_worker_threads_(std::move(other.max_worker_threads_)),
         adjust_threads_(false),
         running_(false),
+        follow_task_affinity_(other.follow_task_affinity_),
+        affinity_(std::move(other.affinity_)),
         controller_service_provider_(std::move(other.controller_service_provider_)),
         thread_manager_(std::move(other.thread_manager_)),
         name_(std::move(other.name_)) {
@@ -288,6 +314,33 @@ class ThreadPool {
     return traces;
   }
 
+  /**
+   * Binds worker threads to groups of CPUs. Thread i is bound to the group i modulo the number of groups.
+   * Must be called before the pool is started.
+   * @param cpu_sets groups of CPUs, for instance one per core or one per NUMA node.
+   * @param follow_task_affinity if true a thread re-binds itself to a task's affinity group before running it.
+   */
+  void setAffinity(const std::vector<std::vector<int>> &cpu_sets, bool follow_task_affinity) {
+    std::lock_guard<std::recursive_mutex> lock(manager_mutex_);
+    affinity_ = cpu_sets;
+    follow_task_affinity_ = follow_task_affinity;
+  }
+
+  /**
+   * Returns the number of affinity groups, zero if threads are unbound.
+   */
+  size_t getAffinityGroupCount() const {
+    return affinity_.size();
+  }
+
+  /**
+   * Returns the time worker threads spent running tasks, keyed by the CPU each task finished on.
+   */
+  std::map<int, uint64_t> getCpuBusyTime() {
+    std::lock_guard<std::mutex> lock(cpu_busy_mutex_);
+    return cpu_busy_nanos_;
+  }
+
   /**
    * Starts the Thread Pool
    */
@@ -334,6 +387,9 @@ class ThreadPool {
     controller_service_provider_ = std::move(other.controller_service_provider_);
     thread_manager_ = std::move(other.thread_manager_);
 
+    affinity_ = std::move(other.affinity_);
+    follow_task_affinity_ = other.follow_task_affinity_;
+
     adjust_threads_ = false;
 
     if (!running_) {
@@ -376,6 +432,10 @@ class ThreadPool {
   std::atomic<bool> adjust_threads_;
 // atomic running boolean
   std::atomic<bool> running_;
+// whether threads re-bind to the affinity group of the task they run
+  bool follow_task_affinity_;
+// CPU groups threads are bound to
+  std::vector<std::vector<int>> affinity_;
 // controller service provider
   std::shared_ptr<core::controller::ControllerServiceProvider> controller_service_provider_;
 // integrated power manager
@@ -393,6 +453,10 @@ class ThreadPool {
   std::recursive_mutex manager_mutex_;
 // work queue mutex
   std::mutex worker_queue_mutex_;
+  // guards the busy time of the CPUs
+  std::mutex cpu_busy_mutex_;
+  // time spent running tasks, keyed by the CPU each task finished on, -1 if unknown
+  std::map<int, uint64_t> cpu_busy_nanos_;
   // thread pool name
   std::string name_;
 
@@ -435,6 +499,9 @@ void ThreadPool<T>::manageWorkers() {
     std::stringstream thread_name;
     thread_name << name_ << " #" << i;
     auto worker_thread = std::make_shared<WorkerThread>(thread_name.str());
+    if (!affinity_.empty()) {
+      worker_thread->affinity_group_ = i % affinity_.size();
+    }
     worker_thread->thread_ = createThread(std::bind(&ThreadPool::run_tasks, this, worker_thread));
     thread_queue_.push_back(worker_thread);
     current_workers_++;
@@ -462,6 +529,9 @@ void ThreadPool<T>::manageWorkers() {
         } else if (thread_manager_->canIncrease() && max_worker_threads_ - current_workers_ > 0) {  // increase slowly
           std::unique_lock<std::mutex> lock(worker_queue_mutex_);
           auto worker_thread = std::make_shared<WorkerThread>();
+          if (!affinity_.empty()) {
+            worker_thread->affinity_group_ = thread_queue_.size() % affinity_.size();
+          }
           worker_thread->thread_ = createThread(std::bind(&ThreadPool::run_tasks, this, worker_thread));
           if (daemon_threads_) {
             worker_thread->thread_.detach();
@@ -492,6 +562,9 @@ template<typename T>
 void ThreadPool<T>::run_tasks(std::shared_ptr<WorkerThread> thread) {
   auto waitperiod = std::chrono::milliseconds(1) * 100;
   thread->is_running_ = true;
+  if (thread->affinity_group_ >= 0) {
+    ThreadAffinity::pinCurrentThread(affinity_[thread->affinity_group_]);
+  }
   uint64_t wait_decay_ = 0;
   uint64_t yield_backoff = 10;  // start at 10 ms
   while (running_.load()) {
@@ -583,7 +656,19 @@ void ThreadPool<T>::run_tasks(std::shared_ptr<WorkerThread> thread) {
         continue;
       }
     }
+    if (follow_task_affinity_ && task.getAffinityGroup() >= 0 && !affinity_.empty()) {
+      int group = task.getAffinityGroup() % affinity_.size();
+      if (group != thread->affinity_group_ && ThreadAffinity::pinCurrentThread(affinity_[group])) {
+        thread->affinity_group_ = group;
+      }
+    }
+    auto run_start = std::chrono::steady_clock::now();
     const bool task_renew = task.run();
+    const uint64_t run_nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - run_start).count();
+    {
+      std::lock_guard<std::mutex> lock(cpu_busy_mutex_);
+      cpu_busy_nanos_[ThreadAffinity::getCurrentCpu()] += run_nanos;
+    }
     wait_decay_ = 0;
     if (task_renew) {
 
@@ -0,0 +1,79 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_INCLUDE_UTILS_FILECOPY_H_
+#define LIBMINIFI_INCLUDE_UTILS_FILECOPY_H_
+
+#include <cstdint>
+#include <string>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+namespace file {
+namespace FileCopy {
+
+/**
+ * How the data of a copy was moved. The kernel based methods avoid copying the data
+ * through user space buffers; CLONE does not copy the data at all but shares the extents
+ * of the source on file systems supporting reflinks (btrfs, xfs).
+ */
+enum class Method {
+  NONE,
+  CLONE,
+  COPY_FILE_RANGE,
+  SENDFILE,
+  READ_WRITE
+};
+
+extern const char *methodName(Method method);
+
+/**
+ * Returns true if both paths are on the same device, so that a rename or link between them
+ * is possible. A path that does not exist yet is checked through its parent directory.
+ */
+extern bool sameDevice(const std::string &path, const std::string &other_path);
+
+/**
+ * Copies length bytes starting at offset of the source file into destination, which is
+ * created or truncated. A negative length copies everything up to the end of the source.
+ * The cheapest available method is used: a reflink when the whole file is copied, then
+ * copy_file_range, then sendfile and finally a plain read/write loop.
+ * @param method if not null, receives the method that copied the data
+ * @return the number of bytes copied, or -1 on failure, in which case destination is removed
+ */
+extern int64_t copy(const std::string &source, uint64_t offset, int64_t length, const std::string &destination, Method *method = nullptr);
+
+#ifndef WIN32
+/**
+ * Copies length bytes starting at offset of the source file to the current position of an
+ * open file, like the copy above. A reflink is only tried when destination_fd is empty.
+ * @return the number of bytes copied, or -1 on failure; destination_fd is left open either way
+ */
+extern int64_t copy(const std::string &source, uint64_t offset, int64_t length, int destination_fd, Method *method = nullptr);
+#endif
+
+} /* namespace FileCopy */
+} /* namespace file */
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
+
+#endif /* LIBMINIFI_INCLUDE_UTILS_FILECOPY_H_ */
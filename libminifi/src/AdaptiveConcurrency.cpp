@@ -0,0 +1,134 @@
+/**
+ * @file AdaptiveConcurrency.cpp
+ * AdaptiveConcurrency class implementation
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "AdaptiveConcurrency.h"
+#ifndef WIN32
+#include <stdlib.h>
+#endif
+#include <string>
+#include <thread>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+
+AdaptiveConcurrency::AdaptiveConcurrency(const std::string &name, uint8_t min_tasks, uint8_t max_tasks, uint64_t evaluation_period_ms)
+    : name_(name),
+      min_tasks_(min_tasks < 1 ? 1 : min_tasks),
+      max_tasks_(max_tasks < min_tasks_ ? min_tasks_ : max_tasks),
+      evaluation_period_ms_(evaluation_period_ms),
+      active_workers_(0),
+      pending_retirements_(0),
+      average_latency_ms_(0),
+      next_evaluation_ms_(0),
+      last_queue_depth_(0),
+      idle_evaluations_(0),
+      grow_count_(0),
+      shrink_count_(0),
+      last_decision_(HOLD) {
+}
+
+void AdaptiveConcurrency::recordLatency(uint64_t latency_ms) {
+  uint64_t average = average_latency_ms_.load();
+  // weight the newest sample by 1/8; races between workers only lose a sample
+  average_latency_ms_ = average == 0 ? latency_ms : (average * 7 + latency_ms) / 8;
+}
+
+bool AdaptiveConcurrency::shouldEvaluate(uint64_t now_ms) {
+  uint64_t next = next_evaluation_ms_.load();
+  if (now_ms < next) {
+    return false;
+  }
+  return next_evaluation_ms_.compare_exchange_strong(next, now_ms + evaluation_period_ms_);
+}
+
+AdaptiveConcurrency::Decision AdaptiveConcurrency::evaluate(uint64_t queued, bool cpu_available, bool can_increase) {
+  last_queue_depth_ = queued;
+  int workers = active_workers_.load() - pending_retirements_.load();
+  if (workers < 1) {
+    workers = 1;
+  }
+  const uint64_t latency = average_latency_ms_ > 0 ? average_latency_ms_.load() : 1;
+  // estimated time for the current workers to drain the backlog
+  const uint64_t drain_ms = queued * latency / workers;
+
+  Decision decision = HOLD;
+  if (queued == 0) {
+    if (++idle_evaluations_ >= 2 && workers > min_tasks_) {
+      decision = SHRINK;
+    }
+  } else {
+    idle_evaluations_ = 0;
+    if (!cpu_available && workers > min_tasks_) {
+      decision = SHRINK;
+    } else if (drain_ms > evaluation_period_ms_ && workers < max_tasks_ && cpu_available && can_increase) {
+      decision = GROW;
+    } else if (workers > min_tasks_ && queued * latency / (workers - 1) < evaluation_period_ms_ / 2) {
+      decision = SHRINK;
+    }
+  }
+
+  if (decision == GROW) {
+    active_workers_++;
+    grow_count_++;
+  } else if (decision == SHRINK) {
+    pending_retirements_++;
+    shrink_count_++;
+  }
+  last_decision_ = decision;
+  return decision;
+}
+
+bool AdaptiveConcurrency::retire() {
+  uint8_t pending = pending_retirements_.load();
+  while (pending > 0) {
+    if (pending_retirements_.compare_exchange_weak(pending, pending - 1)) {
+      active_workers_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool AdaptiveConcurrency::isCpuAvailable() {
+#ifndef WIN32
+  double load = 0;
+  if (getloadavg(&load, 1) == 1) {
+    return load < std::thread::hardware_concurrency();
+  }
+#endif
+  return true;
+}
+
+const char *AdaptiveConcurrency::getDecisionName(Decision decision) {
+  switch (decision) {
+    case GROW:
+      return "grow";
+    case SHRINK:
+      return "shrink";
+    default:
+      return "hold";
+  }
+}
+
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -28,6 +28,14 @@ const char *Configure::nifi_flow_configuration_file = "nifi.flow.configuration.f
 const char *Configure::nifi_flow_configuration_file_exit_failure = "nifi.flow.configuration.file.exit.onfailure";
 const char *Configure::nifi_flow_configuration_file_backup_update = "nifi.flow.configuration.backup.on.update";
 const char *Configure::nifi_flow_engine_threads = "nifi.flow.engine.threads";
+const char *Configure::nifi_flow_engine_adaptive_concurrency = "nifi.flow.engine.adaptive.concurrency";
+const char *Configure::nifi_flow_engine_adaptive_min_tasks = "nifi.flow.engine.adaptive.min.tasks";
+const char *Configure::nifi_flow_engine_adaptive_evaluation_period = "nifi.flow.engine.adaptive.evaluation.period";
+const char *Configure::nifi_flow_engine_shared_executor = "nifi.flow.engine.shared.executor";
+const char *Configure::nifi_flow_engine_shared_executor_threads = "nifi.flow.engine.shared.executor.threads";
+const char *Configure::nifi_flow_engine_thread_affinity = "nifi.flow.engine.thread.affinity";
+const char *Configure::nifi_flow_engine_thread_affinity_cpus = "nifi.flow.engine.thread.affinity.cpus";
+const char *Configure::nifi_flow_engine_backpressure_low_watermark = "nifi.flow.engine.backpressure.low.watermark";
 const char *Configure::nifi_administrative_yield_duration = "nifi.administrative.yield.duration";
 const char *Configure::nifi_bored_yield_duration = "nifi.bored.yield.duration";
 const char *Configure::nifi_graceful_shutdown_seconds = "nifi.flowcontroller.graceful.shutdown.period";
@@ -46,7 +54,19 @@ const char *Configure::nifi_provenance_repository_directory_default = "nifi.prov
 const char *Configure::nifi_flowfile_repository_max_storage_size = "nifi.flowfile.repository.max.storage.size";
 const char *Configure::nifi_flowfile_repository_max_storage_time = "nifi.flowfile.repository.max.storage.time";
 const char *Configure::nifi_flowfile_repository_directory_default = "nifi.flowfile.repository.directory.default";
+const char *Configure::nifi_flowfile_repository_recovery_threads = "nifi.flowfile.repository.recovery.threads";
 const char *Configure::nifi_dbcontent_repository_directory_default = "nifi.database.content.repository.directory.default";
+const char *Configure::nifi_flowfile_repository_rocksdb_options = "nifi.flowfile.repository.rocksdb.";
+const char *Configure::nifi_provenance_repository_rocksdb_options = "nifi.provenance.repository.rocksdb.";
+const char *Configure::nifi_dbcontent_repository_rocksdb_options = "nifi.database.content.repository.rocksdb.";
+const char *Configure::nifi_rocksdb_memory_limit = "nifi.rocksdb.memory.limit";
+const char *Configure::nifi_rocksdb_compaction_threads = "nifi.rocksdb.compaction.threads";
+const char *Configure::nifi_rocksdb_flush_threads = "nifi.rocksdb.flush.threads";
+const char *Configure::nifi_rocksdb_statistics = "nifi.rocksdb.statistics";
+const char *Configure::nifi_memory_limit = "nifi.memory.limit";
+const char *Configure::nifi_memory_low_watermark = "nifi.memory.low.watermark";
+const char *Configure::nifi_memory_high_watermark = "nifi.memory.high.watermark";
+const char *Configure::nifi_memory_sample_period = "nifi.memory.sample.period";
 const char *Configure::nifi_remote_input_secure = "nifi.remote.input.secure";
 const char *Configure::nifi_remote_input_http = "nifi.remote.input.http.enabled";
 const char *Configure::nifi_security_need_ClientAuth = "nifi.security.need.ClientAuth";
@@ -60,6 +80,7 @@ const char *Configure::nifi_c2_file_watch = "nifi.c2.file.watch";
 const char *Configure::nifi_c2_flow_id = "nifi.c2.flow.id";
 const char *Configure::nifi_c2_flow_url = "nifi.c2.flow.url";
 const char *Configure::nifi_c2_flow_base_url = "nifi.c2.flow.base.url";
+const char *Configure::nifi_extension_lazy_initialization = "nifi.extension.lazy.initialization";
 
 } /* namespace minifi */
 } /* namespace nifi */
@@ -28,6 +28,8 @@
 #include <chrono>
 #include <thread>
 #include <iostream>
+#include <algorithm>
+#include <limits>
 #include "core/FlowFile.h"
 #include "Connection.h"
 #include "core/Processor.h"
@@ -38,6 +40,8 @@ namespace apache {
 namespace nifi {
 namespace minifi {
 
+const uint32_t Connection::FILL_LEVEL_FULL = 1000;
+
 Connection::Connection(const std::shared_ptr<core::Repository> &flow_repository, const std::shared_ptr<core::ContentRepository> &content_repo, std::string name)
     : core::Connectable(name),
       flow_repository_(flow_repository),
@@ -49,6 +53,7 @@ Connection::Connection(const std::shared_ptr<core::Repository> &flow_repository,
   max_data_queue_size_ = 0;
   expired_duration_ = 0;
   queued_data_size_ = 0;
+  queued_count_ = 0;
   drop_empty_ = false;
 
   logger_->log_debug("Connection %s created", name_);
@@ -65,6 +70,7 @@ Connection::Connection(const std::shared_ptr<core::Repository> &flow_repository,
   max_data_queue_size_ = 0;
   expired_duration_ = 0;
   queued_data_size_ = 0;
+  queued_count_ = 0;
   drop_empty_ = false;
 
   logger_->log_debug("Connection %s created", name_);
@@ -85,6 +91,7 @@ Connection::Connection(const std::shared_ptr<core::Repository> &flow_repository,
   max_data_queue_size_ = 0;
   expired_duration_ = 0;
   queued_data_size_ = 0;
+  queued_count_ = 0;
   drop_empty_ = false;
 
   logger_->log_debug("Connection %s created", name_);
@@ -106,6 +113,7 @@ Connection::Connection(const std::shared_ptr<core::Repository> &flow_repository,
   max_data_queue_size_ = 0;
   expired_duration_ = 0;
   queued_data_size_ = 0;
+  queued_count_ = 0;
   drop_empty_ = false;
 
   logger_->log_debug("Connection %s created", name_);
@@ -118,19 +126,20 @@ bool Connection::isEmpty() {
 }
 
 bool Connection::isFull() {
-  std::lock_guard<std::mutex> lock(mutex_);
-
-  if (max_queue_size_ <= 0 && max_data_queue_size_ <= 0)
-    // No back pressure setting
-    return false;
-
-  if (max_queue_size_ > 0 && queue_.size() >= max_queue_size_)
-    return true;
-
-  if (max_data_queue_size_ > 0 && queued_data_size_ >= max_data_queue_size_)
-    return true;
+  return getFillLevel() >= FILL_LEVEL_FULL;
+}
 
-  return false;
+uint32_t Connection::getFillLevel() const {
+  uint64_t level = 0;
+  const uint64_t max_queue_size = max_queue_size_;
+  if (max_queue_size > 0) {
+    level = queued_count_ * FILL_LEVEL_FULL / max_queue_size;
+  }
+  const uint64_t max_data_queue_size = max_data_queue_size_;
+  if (max_data_queue_size > 0) {
+    level = std::max(level, queued_data_size_ * FILL_LEVEL_FULL / max_data_queue_size);
+  }
+  return static_cast<uint32_t>(std::min<uint64_t>(level, std::numeric_limits<uint32_t>::max()));
 }
 
 void Connection::put(std::shared_ptr<core::FlowFile> flow) {
@@ -144,6 +153,7 @@ void Connection::put(std::shared_ptr<core::FlowFile> flow) {
     queue_.push(flow);
 
     queued_data_size_ += flow->getSize();
+    queued_count_++;
 
     logger_->log_debug("Enqueue flow file UUID %s to connection %s", flow->getUUIDStr(), name_);
   }
@@ -163,6 +173,43 @@ void Connection::put(std::shared_ptr<core::FlowFile> flow) {
   }
 }
 
+void Connection::multiPut(std::vector<std::shared_ptr<core::FlowFile>> &flows) {
+  size_t dropped = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (const auto &flow : flows) {
+      if (drop_empty_ && flow->getSize() == 0) {
+        dropped++;
+        continue;
+      }
+      queue_.push(flow);
+      queued_data_size_ += flow->getSize();
+      queued_count_++;
+    }
+
+    logger_->log_debug("Enqueued %u flow files to connection %s", flows.size() - dropped, name_);
+  }
+  if (dropped > 0) {
+    logger_->log_info("Dropped %u empty flow files for connection %s", dropped, name_);
+  }
+
+  for (auto &flow : flows) {
+    if (!flow->isStored() && !(drop_empty_ && flow->getSize() == 0)) {
+      // Save to the flowfile repo
+      FlowFileRecord event(flow_repository_, content_repo_, flow, this->uuidStr_);
+      if (event.Serialize()) {
+        flow->setStoredToRepository(true);
+      }
+    }
+  }
+
+  // Notify receiving processor that work may be available
+  if (dest_connectable_ && flows.size() > dropped) {
+    dest_connectable_->notifyWork();
+  }
+}
+
 std::shared_ptr<core::FlowFile> Connection::poll(std::set<std::shared_ptr<core::FlowFile>> &expiredFlowRecords) {
   std::lock_guard<std::mutex> lock(mutex_);
 
@@ -170,6 +217,7 @@ std::shared_ptr<core::FlowFile> Connection::poll(std::set<std::shared_ptr<core::
     std::shared_ptr<core::FlowFile> item = queue_.front();
     queue_.pop();
     queued_data_size_ -= item->getSize();
+    queued_count_--;
 
     if (expired_duration_ > 0) {
       // We need to check for flow expiration
@@ -177,7 +225,7 @@ std::shared_ptr<core::FlowFile> Connection::poll(std::set<std::shared_ptr<core::
         // Flow record expired
         expiredFlowRecords.insert(item);
         logger_->log_debug("Delete flow file UUID %s from connection %s, because it expired", item->getUUIDStr(), name_);
-        if (flow_repository_->Delete(item->getUUIDStr())) {
+        if (flow_repository_->Delete(item->getUUIDStr(), item->getResourceClaim())) {
           item->setStoredToRepository(false);
         }
       } else {
@@ -186,6 +234,7 @@ std::shared_ptr<core::FlowFile> Connection::poll(std::set<std::shared_ptr<core::
           // Flow record was penalized
           queue_.push(item);
           queued_data_size_ += item->getSize();
+          queued_count_++;
           break;
         }
         std::shared_ptr<Connectable> connectable = std::static_pointer_cast<Connectable>(shared_from_this());
@@ -199,6 +248,7 @@ std::shared_ptr<core::FlowFile> Connection::poll(std::set<std::shared_ptr<core::
         // Flow record was penalized
         queue_.push(item);
         queued_data_size_ += item->getSize();
+        queued_count_++;
         break;
       }
       std::shared_ptr<Connectable> connectable = std::static_pointer_cast<Connectable>(shared_from_this());
@@ -218,11 +268,12 @@ void Connection::drain() {
     std::shared_ptr<core::FlowFile> item = queue_.front();
     queue_.pop();
     logger_->log_debug("Delete flow file UUID %s from connection %s, because it expired", item->getUUIDStr(), name_);
-    if (flow_repository_->Delete(item->getUUIDStr())) {
+    if (flow_repository_->Delete(item->getUUIDStr(), item->getResourceClaim())) {
       item->setStoredToRepository(false);
     }
   }
   queued_data_size_ = 0;
+  queued_count_ = 0;
   logger_->log_debug("Drain connection %s", name_);
 }
 
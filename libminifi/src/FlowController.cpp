@@ -38,6 +38,8 @@
 #include "core/state/nodes/FlowInformation.h"
 #include "core/state/nodes/ProcessMetrics.h"
 #include "core/state/nodes/QueueMetrics.h"
+#include "core/state/nodes/ConcurrencyMetrics.h"
+#include "core/state/nodes/ExecutorMetrics.h"
 #include "core/state/nodes/RepositoryMetrics.h"
 #include "core/state/nodes/SystemMetrics.h"
 #include "core/state/ProcessorController.h"
@@ -48,6 +50,7 @@
 #include "utils/StringUtils.h"
 #include "core/Core.h"
 #include "core/ClassLoader.h"
+#include "core/MemoryGovernor.h"
 #include "SchedulingAgent.h"
 #include "core/controller/ControllerServiceProvider.h"
 #include "core/logging/LoggerConfiguration.h"
@@ -99,6 +102,7 @@ FlowController::FlowController(std::shared_ptr<core::Repository> provenance_repo
   if (IsNullOrEmpty(configuration_)) {
     throw std::runtime_error("Must supply a configuration.");
   }
+  core::MemoryGovernor::getInstance().configure(configuration_);
   id_generator_->generate(uuid_);
   setUUID(uuid_);
 
@@ -247,6 +251,9 @@ int16_t FlowController::stop(bool force, uint64_t timeToWait) {
     this->timer_scheduler_->stop();
     this->event_scheduler_->stop();
     this->cron_scheduler_->stop();
+    if (nullptr != shared_thread_pool_) {
+      shared_thread_pool_->shutdown();
+    }
     running_ = false;
   }
   return 0;
@@ -289,6 +296,22 @@ void FlowController::unload() {
   return;
 }
 
+void FlowController::initializeSharedThreadPool(const std::shared_ptr<core::controller::ControllerServiceProvider> &provider) {
+  if (nullptr != shared_thread_pool_) {
+    shared_thread_pool_->shutdown();
+    shared_thread_pool_ = nullptr;
+  }
+  std::string value;
+  bool shared = false;
+  if (!configuration_->get(Configure::nifi_flow_engine_shared_executor, value) || !utils::StringUtils::StringToBool(value, shared) || !shared) {
+    return;
+  }
+  // by default the shared executor has as many threads as the three scheduling agents would have had
+  auto threads = configuration_->getInt(Configure::nifi_flow_engine_shared_executor_threads, 3 * configuration_->getInt(Configure::nifi_flow_engine_threads, 2));
+  shared_thread_pool_ = SchedulingAgent::createThreadPool(configuration_, provider, threads, "SharedExecutor");
+  logger_->log_info("Scheduling agents share an executor of %d threads", threads);
+}
+
 void FlowController::load(const std::shared_ptr<core::ProcessGroup> &root, bool reload) {
   std::lock_guard<std::recursive_mutex> flow_lock(mutex_);
   if (running_) {
@@ -313,21 +336,20 @@ void FlowController::load(const std::shared_ptr<core::ProcessGroup> &root, bool
 
     controller_service_provider_ = flow_configuration_->getControllerServiceProvider();
 
+    auto provider = std::static_pointer_cast<core::controller::ControllerServiceProvider>(std::dynamic_pointer_cast<FlowController>(shared_from_this()));
+    if (nullptr == timer_scheduler_ || reload) {
+      initializeSharedThreadPool(provider);
+    }
+
     if (nullptr == timer_scheduler_ || reload) {
-      timer_scheduler_ = std::make_shared<TimerDrivenSchedulingAgent>(
-          std::static_pointer_cast<core::controller::ControllerServiceProvider>(std::dynamic_pointer_cast<FlowController>(shared_from_this())), provenance_repo_, flow_file_repo_, content_repo_,
-          configuration_);
+      timer_scheduler_ = std::make_shared<TimerDrivenSchedulingAgent>(provider, provenance_repo_, flow_file_repo_, content_repo_, configuration_, shared_thread_pool_);
     }
     if (nullptr == event_scheduler_ || reload) {
-      event_scheduler_ = std::make_shared<EventDrivenSchedulingAgent>(
-          std::static_pointer_cast<core::controller::ControllerServiceProvider>(std::dynamic_pointer_cast<FlowController>(shared_from_this())), provenance_repo_, flow_file_repo_, content_repo_,
-          configuration_);
+      event_scheduler_ = std::make_shared<EventDrivenSchedulingAgent>(provider, provenance_repo_, flow_file_repo_, content_repo_, configuration_, shared_thread_pool_);
     }
 
     if (nullptr == cron_scheduler_ || reload) {
-      cron_scheduler_ = std::make_shared<CronDrivenSchedulingAgent>(
-          std::static_pointer_cast<core::controller::ControllerServiceProvider>(std::dynamic_pointer_cast<FlowController>(shared_from_this())), provenance_repo_, flow_file_repo_, content_repo_,
-          configuration_);
+      cron_scheduler_ = std::make_shared<CronDrivenSchedulingAgent>(provider, provenance_repo_, flow_file_repo_, content_repo_, configuration_, shared_thread_pool_);
     }
 
     std::static_pointer_cast<core::controller::StandardControllerServiceProvider>(controller_service_provider_)->setRootGroup(root_);
@@ -483,6 +505,22 @@ void FlowController::initializeC2() {
     repoMetrics->addRepository(flow_file_repo_);
 
     device_information_[repoMetrics->getName()] = repoMetrics;
+
+    std::shared_ptr<state::response::ConcurrencyMetrics> concurrencyMetrics = std::make_shared<state::response::ConcurrencyMetrics>();
+
+    concurrencyMetrics->addSchedulingAgent(timer_scheduler_);
+    concurrencyMetrics->addSchedulingAgent(event_scheduler_);
+    concurrencyMetrics->addSchedulingAgent(cron_scheduler_);
+
+    device_information_[concurrencyMetrics->getName()] = concurrencyMetrics;
+
+    std::shared_ptr<state::response::ExecutorMetrics> executorMetrics = std::make_shared<state::response::ExecutorMetrics>();
+
+    executorMetrics->addThreadPool(timer_scheduler_->getThreadPool());
+    executorMetrics->addThreadPool(event_scheduler_->getThreadPool());
+    executorMetrics->addThreadPool(cron_scheduler_->getThreadPool());
+
+    device_information_[executorMetrics->getName()] = executorMetrics;
   }
 
   if (configuration_->get("nifi.c2.root.classes", class_csv)) {
@@ -993,10 +1031,13 @@ std::vector<BackTrace> FlowController::getTraces() {
   std::vector<BackTrace> traces;
   auto timer_driven = timer_scheduler_->getTraces();
   traces.insert(traces.end(), std::make_move_iterator(timer_driven.begin()), std::make_move_iterator(timer_driven.end()));
-  auto event_driven = event_scheduler_->getTraces();
-  traces.insert(traces.end(), std::make_move_iterator(event_driven.begin()), std::make_move_iterator(event_driven.end()));
-  auto cron_driven = cron_scheduler_->getTraces();
-  traces.insert(traces.end(), std::make_move_iterator(cron_driven.begin()), std::make_move_iterator(cron_driven.end()));
+  // a shared executor has already been traced through the timer driven agent
+  if (nullptr == shared_thread_pool_) {
+    auto event_driven = event_scheduler_->getTraces();
+    traces.insert(traces.end(), std::make_move_iterator(event_driven.begin()), std::make_move_iterator(event_driven.end()));
+    auto cron_driven = cron_scheduler_->getTraces();
+    traces.insert(traces.end(), std::make_move_iterator(cron_driven.begin()), std::make_move_iterator(cron_driven.end()));
+  }
   // repositories
   auto prov_repo_trace = provenance_repo_->getTraces();
   traces.emplace_back(std::move(prov_repo_trace));
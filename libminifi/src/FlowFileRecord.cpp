@@ -132,14 +132,14 @@ FlowFileRecord::~FlowFileRecord() {
 
 void FlowFileRecord::releaseClaim(std::shared_ptr<ResourceClaim> claim) {
   // Decrease the flow file record owned count for the resource claim
-  claim_->decreaseFlowFileRecordOwnedCount();
+  bool released = claim->decreaseFlowFileRecordOwnedCount();
   std::string value;
-  logger_->log_debug("Delete Resource Claim %s, %s, attempt %llu", getUUIDStr(), claim_->getContentFullPath(), claim_->getFlowFileRecordOwnedCount());
-  if (claim_->getFlowFileRecordOwnedCount() <= 0) {
-    // we cannot rely on the stored variable here since we aren't guaranteed atomicity
+  logger_->log_debug("Delete Resource Claim %s, %s, attempt %llu", getUUIDStr(), claim->getContentFullPath(), claim->getFlowFileRecordOwnedCount());
+  // only the owner that released the claim may remove it; a persisted record keeps its content
+  if (released) {
     if (flow_repository_ != nullptr && !flow_repository_->Get(uuidStr_, value)) {
-      logger_->log_debug("Delete Resource Claim %s", claim_->getContentFullPath());
-      content_repo_->remove(claim_);
+      logger_->log_debug("Delete Resource Claim %s", claim->getContentFullPath());
+      content_repo_->removeIfOrphaned(claim);
     }
   }
 }
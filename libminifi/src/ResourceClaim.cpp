@@ -44,6 +44,7 @@ void setDefaultDirectory(std::string path) {
 ResourceClaim::ResourceClaim(std::shared_ptr<core::StreamManager<ResourceClaim>> claim_manager)
     : claim_manager_(claim_manager),
       deleted_(false),
+      flow_file_record_owned_count_(0),
       logger_(logging::LoggerFactory<ResourceClaim>::getLogger()) {
   auto contentDirectory = claim_manager_->getStoragePath();
   if (contentDirectory.empty())
@@ -56,7 +57,8 @@ ResourceClaim::ResourceClaim(std::shared_ptr<core::StreamManager<ResourceClaim>>
 
 ResourceClaim::ResourceClaim(const std::string path, std::shared_ptr<core::StreamManager<ResourceClaim>> claim_manager, bool deleted)
     : claim_manager_(claim_manager),
-      deleted_(deleted) {
+      deleted_(deleted),
+      flow_file_record_owned_count_(0) {
   _contentFullPath = path;
 }
 
@@ -23,7 +23,13 @@
 #include <utility>
 #include <memory>
 #include <iostream>
+#include <algorithm>
+#include <string>
+#include <vector>
 #include "Exception.h"
+#include "utils/StringUtils.h"
+#include "utils/ThreadAffinity.h"
+#include "core/MemoryGovernor.h"
 #include "core/Processor.h"
 
 namespace org {
@@ -31,6 +37,45 @@ namespace apache {
 namespace nifi {
 namespace minifi {
 
+std::shared_ptr<utils::ThreadPool<uint64_t>> SchedulingAgent::createThreadPool(const std::shared_ptr<Configure> &configure,
+                                                                              const std::shared_ptr<core::controller::ControllerServiceProvider> &controller_service_provider, int threads,
+                                                                              const std::string &name) {
+  auto pool = std::make_shared<utils::ThreadPool<uint64_t>>(threads, false, controller_service_provider, name);
+
+  std::string mode;
+  if (!configure->get(Configure::nifi_flow_engine_thread_affinity, mode)) {
+    return pool;
+  }
+  mode = utils::StringUtils::trim(mode);
+  std::transform(mode.begin(), mode.end(), mode.begin(), ::tolower);
+
+  std::vector<int> cpus = utils::ThreadAffinity::getAvailableCpus();
+  std::string cpu_list;
+  if (configure->get(Configure::nifi_flow_engine_thread_affinity_cpus, cpu_list)) {
+    auto listed = utils::ThreadAffinity::parseCpuList(cpu_list);
+    if (!listed.empty()) {
+      cpus = listed;
+    }
+  }
+
+  auto logger = logging::LoggerFactory<SchedulingAgent>::getLogger();
+  if (mode == "core") {
+    std::vector<std::vector<int>> cores;
+    for (int cpu : cpus) {
+      cores.push_back(std::vector<int> { cpu });
+    }
+    pool->setAffinity(cores, false);
+    logger->log_info("Binding %s threads to %d cores", name, cores.size());
+  } else if (mode == "numa") {
+    auto nodes = utils::ThreadAffinity::getNumaNodes(cpus);
+    pool->setAffinity(nodes, true);
+    logger->log_info("Binding %s threads to %d NUMA nodes", name, nodes.size());
+  } else if (mode != "none") {
+    logger->log_warn("Unknown thread affinity %s, threads will not be bound", mode);
+  }
+  return pool;
+}
+
 bool SchedulingAgent::hasWorkToDo(std::shared_ptr<core::Processor> processor) {
   // Whether it has work to do
   if (processor->getTriggerWhenEmpty() || !processor->hasIncomingConnections() || processor->flowFilesQueued())
@@ -53,7 +98,7 @@ std::future<uint64_t> SchedulingAgent::enableControllerService(std::shared_ptr<c
   // move the functor into the thread pool. While a future is returned
   // we aren't terribly concerned with the result.
   std::future<uint64_t> future;
-  thread_pool_.execute(std::move(functor), future);
+  thread_pool_->execute(std::move(functor), future);
   if (future.valid())
     future.wait();
   return future;
@@ -74,14 +119,46 @@ std::future<uint64_t> SchedulingAgent::disableControllerService(std::shared_ptr<
   // move the functor into the thread pool. While a future is returned
   // we aren't terribly concerned with the result.
   std::future<uint64_t> future;
-  thread_pool_.execute(std::move(functor), future);
+  thread_pool_->execute(std::move(functor), future);
   if (future.valid())
     future.wait();
   return future;
 }
 
 bool SchedulingAgent::hasTooMuchOutGoing(std::shared_ptr<core::Processor> processor) {
-  return processor->flowFilesOutGoingFull();
+  uint32_t fill_level = processor->getOutgoingFillLevel();
+  if (!processor->hasIncomingConnections()) {
+    // sources bring new data into the agent, so they are also held back when it runs out of memory
+    fill_level = std::max(fill_level, core::MemoryGovernor::getInstance().getFillLevel());
+  }
+  if (processor->isBackPressured()) {
+    if (fill_level > back_pressure_low_watermark_ || fill_level >= Connection::FILL_LEVEL_FULL) {
+      return true;
+    }
+    processor->setBackPressured(false);
+    logger_->log_debug("backpressure released for %s at fill level %u", processor->getUUIDStr(), fill_level);
+  } else if (fill_level >= Connection::FILL_LEVEL_FULL) {
+    processor->setBackPressured(true);
+    return true;
+  }
+  if (fill_level > back_pressure_low_watermark_) {
+    // run this time, but wait longer before the next run the closer the connections are to full
+    const uint64_t throttle_ms = processor->getYieldPeriodMsec() * (fill_level - back_pressure_low_watermark_) / (Connection::FILL_LEVEL_FULL - back_pressure_low_watermark_);
+    if (throttle_ms > 0) {
+      processor->yield(throttle_ms);
+    }
+  }
+  return false;
+}
+
+void SchedulingAgent::configureBackPressure() {
+  // the plain threshold unless a lower watermark is configured
+  int low_watermark = configure_->getInt(Configure::nifi_flow_engine_backpressure_low_watermark, 100);
+  if (low_watermark < 0 || low_watermark > 100) {
+    logger_->log_warn("%s must be a percentage, using 100", Configure::nifi_flow_engine_backpressure_low_watermark);
+    low_watermark = 100;
+  }
+  back_pressure_low_watermark_ = Connection::FILL_LEVEL_FULL * low_watermark / 100;
 }
 
 bool SchedulingAgent::onTrigger(const std::shared_ptr<core::Processor> &processor, const std::shared_ptr<core::ProcessContext> &processContext,
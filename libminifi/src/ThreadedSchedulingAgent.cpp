@@ -23,8 +23,11 @@
 #include <vector>
 #include <utility>
 #include <map>
+#include <set>
+#include <functional>
 #include <thread>
 #include <iostream>
+#include "Connection.h"
 #include "core/ClassLoader.h"
 #include "core/Connectable.h"
 #include "core/ProcessorNode.h"
@@ -32,6 +35,9 @@
 #include "core/ProcessContextBuilder.h"
 #include "core/ProcessSession.h"
 #include "core/ProcessSessionFactory.h"
+#include "controllers/ThreadManagementService.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtil.h"
 
 namespace org {
 namespace apache {
@@ -64,7 +70,7 @@ void ThreadedSchedulingAgent::schedule(std::shared_ptr<core::Processor> processo
     return;
   }
 
-  if (thread_pool_.isRunning(processor->getUUIDStr())) {
+  if (thread_pool_->isRunning(processor->getUUIDStr())) {
     logger_->log_warn("Can not schedule threads for processor %s because there are existing threads running", processor->getName());
     return;
   }
@@ -82,32 +88,141 @@ void ThreadedSchedulingAgent::schedule(std::shared_ptr<core::Processor> processo
 
   processor->onSchedule(processContext, sessionFactory);
 
-  std::vector<std::thread *> threads;
+  std::shared_ptr<AdaptiveConcurrency> concurrency = nullptr;
+  int initial_tasks = processor->getMaxConcurrentTasks();
+  // source and cron driven processors keep a fixed number of workers
+  if (adaptive_enabled_ && processor->hasIncomingConnections() && processor->getSchedulingStrategy() != core::CRON_DRIVEN
+      && processor->getMaxConcurrentTasks() > adaptive_min_tasks_) {
+    concurrency = std::make_shared<AdaptiveConcurrency>(processor->getName(), adaptive_min_tasks_, processor->getMaxConcurrentTasks(), adaptive_evaluation_period_ms_);
+    {
+      std::lock_guard<std::mutex> adaptive_lock(adaptive_mutex_);
+      adaptive_concurrency_[processor->getUUIDStr()] = concurrency;
+    }
+    initial_tasks = concurrency->getMinTasks();
+  }
 
-  ThreadedSchedulingAgent *agent = this;
-  for (int i = 0; i < processor->getMaxConcurrentTasks(); i++) {
-    // reference the disable function from serviceNode
-    processor->incrementActiveTasks();
+  for (int i = 0; i < initial_tasks; i++) {
+    if (concurrency != nullptr) {
+      concurrency->workerStarted();
+    }
+    submitWorker(processor, processContext, sessionFactory, concurrency);
+  }
+  logger_->log_debug("Scheduled thread %d concurrent workers for for process %s", initial_tasks, processor->getName());
+  return;
+}
+
+void ThreadedSchedulingAgent::submitWorker(const std::shared_ptr<core::Processor> &processor, const std::shared_ptr<core::ProcessContext> &processContext,
+                                           const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory, const std::shared_ptr<AdaptiveConcurrency> &concurrency) {
+  // reference the disable function from serviceNode
+  processor->incrementActiveTasks();
 
-    std::function<uint64_t()> f_ex = [agent, processor, processContext, sessionFactory] () {
+  ThreadedSchedulingAgent *agent = this;
+  std::function<uint64_t()> f_ex;
+  std::unique_ptr<TimerAwareMonitor> monitor;
+  if (concurrency == nullptr) {
+    f_ex = [agent, processor, processContext, sessionFactory] () {
       return agent->run(processor, processContext, sessionFactory);
     };
+    monitor = std::unique_ptr<TimerAwareMonitor>(new TimerAwareMonitor(&running_));
+  } else {
+    f_ex = [agent, processor, processContext, sessionFactory, concurrency] () {
+      auto start = std::chrono::steady_clock::now();
+      uint64_t wait = agent->run(processor, processContext, sessionFactory);
+      concurrency->recordLatency(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+      agent->adjustConcurrency(processor, processContext, sessionFactory, concurrency);
+      return wait;
+    };
+    monitor = std::unique_ptr<TimerAwareMonitor>(new AdaptiveWorkerMonitor(&running_, processor, concurrency));
+  }
 
-    // create a functor that will be submitted to the thread pool.
-    std::unique_ptr<TimerAwareMonitor> monitor = std::unique_ptr<TimerAwareMonitor>(new TimerAwareMonitor(&running_));
-    utils::Worker<uint64_t> functor(f_ex, processor->getUUIDStr(), std::move(monitor));
-    // move the functor into the thread pool. While a future is returned
-    // we aren't terribly concerned with the result.
-    std::future<uint64_t> future;
-    thread_pool_.execute(std::move(functor), future);
+  // create a functor that will be submitted to the thread pool.
+  utils::Worker<uint64_t> functor(f_ex, processor->getUUIDStr(), std::move(monitor));
+  functor.setAffinityGroup(getAffinityGroup(processor));
+  // move the functor into the thread pool. While a future is returned
+  // we aren't terribly concerned with the result.
+  std::future<uint64_t> future;
+  thread_pool_->execute(std::move(functor), future);
+}
+
+void ThreadedSchedulingAgent::adjustConcurrency(const std::shared_ptr<core::Processor> &processor, const std::shared_ptr<core::ProcessContext> &processContext,
+                                                const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory, const std::shared_ptr<AdaptiveConcurrency> &concurrency) {
+  if (!running_ || !processor->isRunning() || !concurrency->shouldEvaluate(getTimeMillis())) {
+    return;
+  }
+
+  bool can_increase = true;
+  if (nullptr != controller_service_provider_) {
+    auto thread_manager = std::dynamic_pointer_cast<controllers::ThreadManagementService>(controller_service_provider_->getControllerService("ThreadPoolManager"));
+    if (nullptr != thread_manager) {
+      can_increase = !thread_manager->isAboveMax(1) && thread_manager->canIncrease();
+    }
+  }
+
+  auto decision = concurrency->evaluate(processor->getFlowFilesQueuedCount(), AdaptiveConcurrency::isCpuAvailable(), can_increase);
+  if (decision != AdaptiveConcurrency::HOLD) {
+    logger_->log_debug("Adaptive concurrency for %s: %s to %d workers, %llu queued, %llu ms average latency", processor->getName(), AdaptiveConcurrency::getDecisionName(decision),
+                       concurrency->getActiveWorkers(), concurrency->getLastQueueDepth(), concurrency->getAverageLatency());
+  }
+  if (decision == AdaptiveConcurrency::GROW) {
+    submitWorker(processor, processContext, sessionFactory, concurrency);
   }
-  logger_->log_debug("Scheduled thread %d concurrent workers for for process %s", processor->getMaxConcurrentTasks(), processor->getName());
-  return;
+}
+
+int ThreadedSchedulingAgent::getAffinityGroup(const std::shared_ptr<core::Processor> &processor) {
+  const int groups = thread_pool_->getAffinityGroupCount();
+  if (groups <= 1) {
+    return -1;
+  }
+  // walk upstream to the source of the pipeline so that every processor fed by it lands on the same group
+  std::shared_ptr<core::Connectable> head = processor;
+  std::set<std::string> visited;
+  while (visited.insert(head->getUUIDStr()).second) {
+    auto incoming = head->getIncomingConnections();
+    if (incoming.empty()) {
+      break;
+    }
+    auto connection = std::dynamic_pointer_cast<Connection>(*incoming.begin());
+    if (nullptr == connection || nullptr == connection->getSource()) {
+      break;
+    }
+    head = connection->getSource();
+  }
+  return static_cast<int>(std::hash<std::string>()(head->getUUIDStr()) % groups);
+}
+
+std::vector<std::shared_ptr<AdaptiveConcurrency>> ThreadedSchedulingAgent::getAdaptiveConcurrency() {
+  std::vector<std::shared_ptr<AdaptiveConcurrency>> states;
+  std::lock_guard<std::mutex> lock(adaptive_mutex_);
+  for (const auto &state : adaptive_concurrency_) {
+    states.push_back(state.second);
+  }
+  return states;
+}
+
+void ThreadedSchedulingAgent::configureAdaptiveConcurrency() {
+  std::string value;
+  if (configure_->get(Configure::nifi_flow_engine_adaptive_concurrency, value)) {
+    utils::StringUtils::StringToBool(value, adaptive_enabled_);
+  }
+  if (!adaptive_enabled_) {
+    return;
+  }
+  auto min_tasks = configure_->getInt(Configure::nifi_flow_engine_adaptive_min_tasks, 1);
+  if (min_tasks > 0 && min_tasks <= 255) {
+    adaptive_min_tasks_ = static_cast<uint8_t>(min_tasks);
+  }
+  if (configure_->get(Configure::nifi_flow_engine_adaptive_evaluation_period, value)) {
+    int64_t period = 0;
+    core::TimeUnit unit;
+    if (core::Property::StringToTime(value, period, unit) && core::Property::ConvertTimeUnitToMS(period, unit, period) && period > 0) {
+      adaptive_evaluation_period_ms_ = period;
+    }
+  }
+  logger_->log_debug("Adaptive concurrency enabled with a minimum of %d tasks, evaluated every %llu ms", adaptive_min_tasks_, adaptive_evaluation_period_ms_);
 }
 
 void ThreadedSchedulingAgent::stop() {
   SchedulingAgent::stop();
-  thread_pool_.shutdown();
 }
 
 void ThreadedSchedulingAgent::unschedule(std::shared_ptr<core::Processor> processor) {
@@ -119,7 +234,12 @@ void ThreadedSchedulingAgent::unschedule(std::shared_ptr<core::Processor> proces
     return;
   }
 
-  thread_pool_.stopTasks(processor->getUUIDStr());
+  thread_pool_->stopTasks(processor->getUUIDStr());
+
+  {
+    std::lock_guard<std::mutex> adaptive_lock(adaptive_mutex_);
+    adaptive_concurrency_.erase(processor->getUUIDStr());
+  }
 
   processor->clearActiveTask();
 
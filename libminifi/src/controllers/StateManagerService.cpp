@@ -0,0 +1,63 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "controllers/StateManagerService.h"
+#include <string>
+#include <unordered_map>
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+std::string StateManagerService::serialize(const std::unordered_map<std::string, std::string> &state) {
+  rapidjson::Document doc(rapidjson::kObjectType);
+  rapidjson::Document::AllocatorType &alloc = doc.GetAllocator();
+  for (const auto &kv : state) {
+    doc.AddMember(rapidjson::Value(kv.first.c_str(), kv.first.size(), alloc), rapidjson::Value(kv.second.c_str(), kv.second.size(), alloc), alloc);
+  }
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  doc.Accept(writer);
+  return std::string(buffer.GetString(), buffer.GetSize());
+}
+
+bool StateManagerService::deserialize(const std::string &serialized, std::unordered_map<std::string, std::string> &state) {
+  rapidjson::Document doc;
+  rapidjson::ParseResult ok = doc.Parse(serialized.c_str(), serialized.size());
+  if (!ok || !doc.IsObject()) {
+    return false;
+  }
+  state.clear();
+  for (const auto &member : doc.GetObject()) {
+    if (!member.value.IsString()) {
+      return false;
+    }
+    state.emplace(std::string(member.name.GetString(), member.name.GetStringLength()), std::string(member.value.GetString(), member.value.GetStringLength()));
+  }
+  return true;
+}
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,68 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "controllers/VolatileStateManagerService.h"
+#include <set>
+#include <string>
+#include <unordered_map>
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace controllers {
+
+void VolatileStateManagerService::initialize() {
+  ControllerService::initialize();
+  setSupportedProperties(std::set<core::Property>());
+}
+
+void VolatileStateManagerService::onEnable() {
+  logger_->log_debug("Component state of %s is kept in memory", getName());
+}
+
+bool VolatileStateManagerService::set(const std::string &component_id, const std::unordered_map<std::string, std::string> &state) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  states_[component_id] = state;
+  return true;
+}
+
+bool VolatileStateManagerService::get(const std::string &component_id, std::unordered_map<std::string, std::string> &state) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = states_.find(component_id);
+  if (it == states_.end()) {
+    return false;
+  }
+  state = it->second;
+  return true;
+}
+
+bool VolatileStateManagerService::clear(const std::string &component_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  states_.erase(component_id);
+  return true;
+}
+
+bool VolatileStateManagerService::persist() {
+  return true;
+}
+
+} /* namespace controllers */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
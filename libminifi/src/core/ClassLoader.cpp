@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 #include "core/ClassLoader.h"
+#include "core/logging/LoggerConfiguration.h"
 
 namespace org {
 namespace apache {
@@ -25,7 +26,9 @@ namespace nifi {
 namespace minifi {
 namespace core {
 
-ClassLoader::ClassLoader() {
+ClassLoader::ClassLoader()
+    : lazy_initialization_(false),
+      self_handle_(nullptr) {
 }
 
 ClassLoader &ClassLoader::getDefaultClassLoader() {
@@ -37,17 +40,20 @@ ClassLoader &ClassLoader::getDefaultClassLoader() {
 uint16_t ClassLoader::registerResource(const std::string &resource, const std::string &resourceFunction) {
   void *resource_ptr = nullptr;
   if (resource.empty()) {
-    dlclose(dlopen(0, RTLD_LAZY | RTLD_GLOBAL));
-    resource_ptr = dlopen(0, RTLD_NOW | RTLD_GLOBAL);
+    // every extension linked into the agent shares the same handle
+    resource_ptr = getSelfHandle();
+    if (!resource_ptr) {
+      return RESOURCE_FAILURE;
+    }
   } else {
     dlclose(dlopen(resource.c_str(), RTLD_LAZY | RTLD_GLOBAL));
     resource_ptr = dlopen(resource.c_str(), RTLD_NOW | RTLD_GLOBAL);
-  }
-  if (!resource_ptr) {
-    return RESOURCE_FAILURE;
-  } else {
-    std::lock_guard<std::mutex> lock(internal_mutex_);
-    dl_handles_.push_back(resource_ptr);
+    if (!resource_ptr) {
+      return RESOURCE_FAILURE;
+    } else {
+      std::lock_guard<std::mutex> lock(internal_mutex_);
+      dl_handles_.push_back(resource_ptr);
+    }
   }
 
   // reset errors
@@ -65,7 +71,13 @@ uint16_t ClassLoader::registerResource(const std::string &resource, const std::s
   std::lock_guard<std::mutex> lock(internal_mutex_);
 
   auto initializer = factory->getInitializer();
-  if (initializer != nullptr) {
+  if (initializer != nullptr && lazy_initialization_) {
+    std::shared_ptr<DeferredInitializer> deferred = std::make_shared<DeferredInitializer>(std::move(initializer));
+    for (auto class_name : factory->getClassNames()) {
+      // keep the initializer of an earlier registration so that it never runs twice
+      deferred_initializers_.insert(std::make_pair(class_name, deferred));
+    }
+  } else if (initializer != nullptr) {
     if (!initializer->initialize()) {
       delete factory;
       return RESOURCE_FAILURE;
@@ -82,6 +94,41 @@ uint16_t ClassLoader::registerResource(const std::string &resource, const std::s
   return RESOURCE_SUCCESS;
 }
 
+bool ClassLoader::initializeDeferred(const std::string &class_name) {
+  std::shared_ptr<DeferredInitializer> deferred;
+  {
+    std::lock_guard<std::mutex> lock(internal_mutex_);
+    auto entry = deferred_initializers_.find(class_name);
+    if (entry == deferred_initializers_.end()) {
+      return true;
+    }
+    deferred = entry->second;
+  }
+  std::call_once(deferred->once_, [this, &deferred, &class_name]() {
+    if (!deferred->initializer_->initialize()) {
+      logging::LoggerFactory<ClassLoader>::getLogger()->log_error("Could not initialize the extension providing %s", class_name);
+      return;
+    }
+    deferred->initialized_ = true;
+    std::lock_guard<std::mutex> lock(internal_mutex_);
+    initializers_.emplace_back(std::move(deferred->initializer_));
+  });
+  return deferred->initialized_;
+}
+
+void *ClassLoader::getSelfHandle() {
+  std::call_once(self_handle_flag_, [this]() {
+    dlclose(dlopen(0, RTLD_LAZY | RTLD_GLOBAL));
+    void *handle = dlopen(0, RTLD_NOW | RTLD_GLOBAL);
+    if (handle) {
+      std::lock_guard<std::mutex> lock(internal_mutex_);
+      dl_handles_.push_back(handle);
+      self_handle_ = handle;
+    }
+  });
+  return self_handle_;
+}
+
 } /* namespace core */
 } /* namespace minifi */
 } /* namespace nifi */
@@ -0,0 +1,302 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/MemoryGovernor.h"
+#ifndef WIN32
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Connection.h"
+#include "core/Property.h"
+#include "core/logging/LoggerConfiguration.h"
+#include "utils/StringUtils.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace core {
+
+namespace {
+
+uint64_t getSteadyMillis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t readResidentSize() {
+#ifdef __linux__
+  std::ifstream statm("/proc/self/statm");
+  uint64_t size = 0;
+  uint64_t resident = 0;
+  if (statm >> size >> resident) {
+    return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  }
+#endif
+  return 0;
+}
+
+/**
+ * Returns the memory limit of the cgroup of the agent, or 0 if it is not limited.
+ */
+uint64_t readCgroupLimit() {
+#ifdef __linux__
+  std::string value;
+  std::ifstream v2("/sys/fs/cgroup/memory.max");
+  if (v2 >> value) {
+    uint64_t limit = 0;
+    return value != "max" && core::Property::StringToInt(value, limit) ? limit : 0;
+  }
+  std::ifstream v1("/sys/fs/cgroup/memory/memory.limit_in_bytes");
+  uint64_t limit = 0;
+  if (v1 >> limit) {
+    // an unlimited cgroup v1 reports a limit beyond the physical memory
+    const uint64_t physical = static_cast<uint64_t>(sysconf(_SC_PHYS_PAGES)) * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    return limit < physical ? limit : 0;
+  }
+#endif
+  return 0;
+}
+
+}  // namespace
+
+MemoryGovernor::MemoryGovernor()
+    : limit_(0),
+      low_watermark_(0),
+      high_watermark_(0),
+      reserved_(0),
+      refused_count_(0),
+      resident_size_(0),
+      reserved_at_sample_(0),
+      sample_period_ms_(100),
+      last_sample_ms_(0),
+      reclaiming_(false),
+      next_reclaimer_id_(0),
+      running_(false),
+      reclaim_requested_(false),
+      logger_(logging::LoggerFactory<MemoryGovernor>::getLogger()) {
+}
+
+MemoryGovernor::~MemoryGovernor() {
+  stop();
+}
+
+void MemoryGovernor::configure(const std::shared_ptr<Configure> &configure) {
+  std::string value;
+  uint64_t limit = 0;
+  if (configure->get(Configure::nifi_memory_limit, value)) {
+    if (utils::StringUtils::equalsIgnoreCase(value, "cgroup")) {
+      limit = readCgroupLimit();
+      if (limit == 0) {
+        logger_->log_warn("The memory cgroup of the agent is not limited, memory is not governed");
+      }
+    } else if (!core::Property::StringToInt(value, limit)) {
+      logger_->log_error("Invalid memory limit %s, memory is not governed", value);
+      limit = 0;
+    }
+  }
+
+  int low = configure->getInt(Configure::nifi_memory_low_watermark, 70);
+  int high = configure->getInt(Configure::nifi_memory_high_watermark, 90);
+  if (low <= 0 || high > 100 || low > high) {
+    logger_->log_warn("%s and %s must be percentages with the low watermark below the high watermark, using 70 and 90", Configure::nifi_memory_low_watermark,
+                      Configure::nifi_memory_high_watermark);
+    low = 70;
+    high = 90;
+  }
+  uint64_t sample_period = 100;
+  if (configure->get(Configure::nifi_memory_sample_period, value)) {
+    int64_t period = 0;
+    core::TimeUnit unit;
+    if (core::Property::StringToTime(value, period, unit) && core::Property::ConvertTimeUnitToMS(period, unit, period) && period > 0) {
+      sample_period = period;
+    } else {
+      logger_->log_warn("Invalid %s %s, sampling every 100 ms", Configure::nifi_memory_sample_period, value);
+    }
+  }
+  sample_period_ms_ = sample_period;
+  low_watermark_ = limit / 100 * low;
+  high_watermark_ = limit / 100 * high;
+  limit_ = limit;
+
+  last_sample_ms_ = 0;
+  sample();
+  if (limit > 0) {
+    logger_->log_info("Governing memory to %llu bytes, under pressure above %llu and refusing reservations above %llu, resident size %llu", limit, low_watermark_.load(),
+                      high_watermark_.load(), resident_size_.load());
+    start();
+  } else {
+    stop();
+    // gives the reclaimers their memory back if the governor was enabled before
+    reclaim();
+  }
+}
+
+bool MemoryGovernor::tryReserve(uint64_t bytes) {
+  if (limit_ > 0) {
+    if (computeUsage() + bytes > high_watermark_) {
+      refused_count_++;
+      return false;
+    }
+  }
+  reserved_ += bytes;
+  return true;
+}
+
+void MemoryGovernor::release(uint64_t bytes) {
+  reserved_ -= bytes;
+}
+
+bool MemoryGovernor::isUnderPressure() {
+  if (limit_ == 0) {
+    return false;
+  }
+  return computeUsage() > low_watermark_;
+}
+
+uint32_t MemoryGovernor::getFillLevel() {
+  const uint64_t high_watermark = high_watermark_;
+  if (limit_ == 0 || high_watermark == 0) {
+    return 0;
+  }
+  const uint64_t level = computeUsage() * Connection::FILL_LEVEL_FULL / high_watermark;
+  return static_cast<uint32_t>(std::min<uint64_t>(level, std::numeric_limits<uint32_t>::max()));
+}
+
+uint64_t MemoryGovernor::getUsage() {
+  return computeUsage();
+}
+
+int MemoryGovernor::registerReclaimer(std::function<void(uint64_t excess)> reclaimer) {
+  std::lock_guard<std::mutex> lock(reclaimer_mutex_);
+  const int id = next_reclaimer_id_++;
+  reclaimers_[id] = std::move(reclaimer);
+  return id;
+}
+
+void MemoryGovernor::unregisterReclaimer(int id) {
+  std::lock_guard<std::mutex> lock(reclaimer_mutex_);
+  reclaimers_.erase(id);
+}
+
+uint64_t MemoryGovernor::computeUsage() const {
+  // reservations made since the sample are not in the resident size yet
+  const int64_t usage = static_cast<int64_t>(resident_size_) + static_cast<int64_t>(reserved_ - reserved_at_sample_);
+  return usage > 0 ? static_cast<uint64_t>(usage) : 0;
+}
+
+void MemoryGovernor::sample() {
+  const uint64_t now = getSteadyMillis();
+  if (last_sample_ms_ != 0 && now - last_sample_ms_ < sample_period_ms_) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(sample_mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    // another thread is sampling, its sample will do
+    return;
+  }
+  last_sample_ms_ = now;
+  reserved_at_sample_ = reserved_.load();
+  resident_size_ = readResidentSize();
+}
+
+void MemoryGovernor::reclaim() {
+  uint64_t excess = 0;
+  {
+    std::lock_guard<std::mutex> lock(reclaim_mutex_);
+    const uint64_t usage = computeUsage();
+    if (limit_ > 0 && usage > low_watermark_) {
+      excess = usage - low_watermark_;
+      if (!reclaiming_) {
+        logger_->log_info("Memory usage %llu is above %llu, reclaiming memory", usage, low_watermark_.load());
+        reclaiming_ = true;
+      }
+    } else if (reclaiming_) {
+      if (limit_ > 0) {
+        logger_->log_info("Memory usage %llu is below %llu again", usage, low_watermark_.load());
+      }
+      reclaiming_ = false;
+    } else {
+      return;
+    }
+  }
+
+  std::vector<std::function<void(uint64_t)>> reclaimers;
+  {
+    std::lock_guard<std::mutex> reclaimer_lock(reclaimer_mutex_);
+    for (const auto &reclaimer : reclaimers_) {
+      reclaimers.push_back(reclaimer.second);
+    }
+  }
+  for (const auto &reclaimer : reclaimers) {
+    reclaimer(excess);
+  }
+}
+
+void MemoryGovernor::start() {
+  std::lock_guard<std::mutex> lock(thread_mutex_);
+  reclaim_requested_ = true;
+  if (running_) {
+    thread_condition_.notify_all();
+    return;
+  }
+  running_ = true;
+  thread_ = std::thread(&MemoryGovernor::run, this);
+  logger_->log_debug("Memory governor thread start");
+}
+
+void MemoryGovernor::stop() {
+  {
+    std::lock_guard<std::mutex> lock(thread_mutex_);
+    if (!running_) {
+      return;
+    }
+    running_ = false;
+    thread_condition_.notify_all();
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  logger_->log_debug("Memory governor thread stop");
+}
+
+void MemoryGovernor::run() {
+  std::unique_lock<std::mutex> lock(thread_mutex_);
+  while (running_) {
+    reclaim_requested_ = false;
+    lock.unlock();
+    sample();
+    reclaim();
+    lock.lock();
+    thread_condition_.wait_for(lock, std::chrono::milliseconds(sample_period_ms_.load()), [this]() {
+      return !running_ || reclaim_requested_;
+    });
+  }
+}
+
+} /* namespace core */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -30,6 +30,8 @@
 #include <thread>
 #include <iostream>
 #include <uuid/uuid.h>
+#include <sys/stat.h>
+#include "utils/file/FileCopy.h"
 /* This implementation is only for native Windows systems.  */
 #if (defined _WIN32 || defined __WIN32__) && !defined __CYGWIN__
 #define _WINSOCKAPI_
@@ -58,6 +60,9 @@ namespace core {
 
 std::shared_ptr<utils::IdGenerator> ProcessSession::id_generator_ = utils::IdGenerator::getIdGenerator();
 
+// files are imported with large sequential reads rather than page sized ones, which matters for large appends to tailed files
+static const size_t FILE_IMPORT_BUFFER_SIZE = 64 * 1024;
+
 ProcessSession::~ProcessSession() {
   removeReferences();
 }
@@ -214,7 +219,7 @@ void ProcessSession::remove(const std::shared_ptr<core::FlowFile> &flow) {
   } else {
     logger_->log_debug("Flow does not contain content. no resource claim to decrement.");
   }
-  process_context_->getFlowFileRepository()->Delete(flow->getUUIDStr());
+  process_context_->getFlowFileRepository()->Delete(flow->getUUIDStr(), flow->getResourceClaim());
   _deletedFlowFiles[flow->getUUIDStr()] = flow;
   std::string reason = process_context_->getProcessorNode()->getName() + " drop flow record " + flow->getUUIDStr();
   provenance_report_->drop(flow, reason);
@@ -449,11 +454,30 @@ void ProcessSession::importFrom(io::DataStream &stream, const std::shared_ptr<co
 
 void ProcessSession::import(std::string source, const std::shared_ptr<core::FlowFile> &flow, bool keepSource, uint64_t offset) {
   std::shared_ptr<ResourceClaim> claim = std::make_shared<ResourceClaim>(process_context_->getContentRepository());
-  size_t size = getpagesize();
+  size_t size = FILE_IMPORT_BUFFER_SIZE;
   std::vector<uint8_t> charBuffer(size);
 
   try {
     auto startTime = getTimeMillis();
+    const std::string content_path = process_context_->getContentRepository()->getContentPath(claim);
+    const int64_t imported = content_path.empty() ? -1 : importFile(source, content_path, keepSource, offset);
+    if (imported >= 0) {
+      claim->increaseFlowFileRecordOwnedCount();
+      flow->setSize(imported);
+      flow->setOffset(0);
+      if (flow->getResourceClaim() != nullptr) {
+        // Remove the old claim
+        flow->getResourceClaim()->decreaseFlowFileRecordOwnedCount();
+        flow->clearResourceClaim();
+      }
+      flow->setResourceClaim(claim);
+      logger_->log_debug("Import offset %llu length %llu into content %s for FlowFile UUID %s", flow->getOffset(), flow->getSize(), content_path, flow->getUUIDStr());
+      std::stringstream details;
+      details << process_context_->getProcessorNode()->getName() << " modify flow record content " << flow->getUUIDStr();
+      auto endTime = getTimeMillis();
+      provenance_report_->modifyContent(flow, details.str(), endTime - startTime);
+      return;
+    }
     std::ifstream input;
     input.open(source.c_str(), std::fstream::in | std::fstream::binary);
     claim->increaseFlowFileRecordOwnedCount();
@@ -534,12 +558,37 @@ void ProcessSession::import(std::string source, const std::shared_ptr<core::Flow
   }
 }
 
+int64_t ProcessSession::importFile(const std::string &source, const std::string &content_path, bool keepSource, uint64_t offset) {
+  struct stat source_stat;
+  // only a regular file is moved, renaming a link would move the link rather than its content into the repository
+#ifndef WIN32
+  const bool regular_file = lstat(source.c_str(), &source_stat) == 0 && S_ISREG(source_stat.st_mode);
+#else
+  const bool regular_file = stat(source.c_str(), &source_stat) == 0 && (source_stat.st_mode & _S_IFREG) != 0;
+#endif
+  if (!keepSource && offset == 0 && regular_file && utils::file::FileCopy::sameDevice(source, content_path) && rename(source.c_str(), content_path.c_str()) == 0) {
+    logger_->log_debug("Moved %s into content %s", source, content_path);
+    return source_stat.st_size;
+  }
+  utils::file::FileCopy::Method method;
+  const int64_t size = utils::file::FileCopy::copy(source, offset, -1, content_path, &method);
+  if (size < 0) {
+    logger_->log_debug("Could not copy %s into content %s, streaming it instead", source, content_path);
+    return -1;
+  }
+  logger_->log_debug("Copied %lld bytes of %s into content %s using %s", size, source, content_path, utils::file::FileCopy::methodName(method));
+  if (!keepSource) {
+    std::remove(source.c_str());
+  }
+  return size;
+}
+
 void ProcessSession::import(const std::string& source, std::vector<std::shared_ptr<FlowFileRecord>> &flows, uint64_t offset, char inputDelimiter) {
   std::shared_ptr<ResourceClaim> claim;
   std::shared_ptr<io::BaseStream> stream;
   std::shared_ptr<FlowFileRecord> flowFile;
 
-  std::vector<uint8_t> buffer(getpagesize());
+  std::vector<uint8_t> buffer(FILE_IMPORT_BUFFER_SIZE);
   try {
     try {
       std::ifstream input;
@@ -664,7 +713,11 @@ bool ProcessSession::exportContent(const std::string &destination, const std::st
   logger_->log_debug("Exporting content of %s to %s", flow->getUUIDStr(), destination);
 
   ProcessSessionReadCallback cb(tmpFile, destination, logger_);
-  read(flow, &cb);
+  if (copyContent(flow, tmpFile)) {
+    cb.setWriteSucceeded();
+  } else {
+    read(flow, &cb);
+  }
 
   logger_->log_info("Committing %s", destination);
   bool commit_ok = cb.commit();
@@ -687,6 +740,51 @@ bool ProcessSession::exportContent(const std::string &destination, const std::sh
   return exportContent(destination, tmpFileName, flow, keepContent);
 }
 
+std::string ProcessSession::getContentPath(const std::shared_ptr<core::FlowFile> &flow) {
+  std::shared_ptr<ResourceClaim> claim = flow->getResourceClaim();
+  if (claim == nullptr) {
+    return "";
+  }
+  return process_context_->getContentRepository()->getContentPath(claim);
+}
+
+bool ProcessSession::copyContent(const std::shared_ptr<core::FlowFile> &flow, const std::string &destination) {
+  const std::string content_path = getContentPath(flow);
+  if (content_path.empty()) {
+    return false;
+  }
+  utils::file::FileCopy::Method method;
+  const int64_t size = utils::file::FileCopy::copy(content_path, flow->getOffset(), flow->getSize(), destination, &method);
+  if (size != static_cast<int64_t>(flow->getSize())) {
+    if (size >= 0) {
+      logger_->log_warn("Content %s of %s is shorter than the expected %llu bytes", content_path, flow->getUUIDStr(), flow->getSize());
+      std::remove(destination.c_str());
+    }
+    return false;
+  }
+  logger_->log_debug("Copied content of %s to %s using %s", flow->getUUIDStr(), destination, utils::file::FileCopy::methodName(method));
+  return true;
+}
+
+#ifndef WIN32
+bool ProcessSession::copyContent(const std::shared_ptr<core::FlowFile> &flow, int destination_fd) {
+  const std::string content_path = getContentPath(flow);
+  if (content_path.empty()) {
+    return false;
+  }
+  utils::file::FileCopy::Method method;
+  const int64_t size = utils::file::FileCopy::copy(content_path, flow->getOffset(), flow->getSize(), destination_fd, &method);
+  if (size != static_cast<int64_t>(flow->getSize())) {
+    if (size >= 0) {
+      logger_->log_warn("Content %s of %s is shorter than the expected %llu bytes", content_path, flow->getUUIDStr(), flow->getSize());
+    }
+    return false;
+  }
+  logger_->log_debug("Copied content of %s using %s", flow->getUUIDStr(), utils::file::FileCopy::methodName(method));
+  return true;
+}
+#endif
+
 void ProcessSession::stash(const std::string &key, const std::shared_ptr<core::FlowFile> &flow) {
   logger_->log_debug("Stashing content from %s to key %s", flow->getUUIDStr(), key);
 
@@ -19,6 +19,7 @@
  */
 #include "core/Processor.h"
 #include <time.h>
+#include <algorithm>
 #include <vector>
 #include <queue>
 #include <map>
@@ -61,6 +62,7 @@ Processor::Processor(std::string name)
   max_concurrent_tasks_ = DEFAULT_MAX_CONCURRENT_TASKS;
   active_tasks_ = 0;
   yield_expiration_ = 0;
+  back_pressured_ = false;
   incoming_connections_Iter = this->_incomingConnections.begin();
   logger_->log_debug("Processor %s created UUID %s", name_, uuidStr_);
 }
@@ -82,6 +84,7 @@ Processor::Processor(std::string name, utils::Identifier &uuid)
   max_concurrent_tasks_ = DEFAULT_MAX_CONCURRENT_TASKS;
   active_tasks_ = 0;
   yield_expiration_ = 0;
+  back_pressured_ = false;
   incoming_connections_Iter = this->_incomingConnections.begin();
   logger_->log_debug("Processor %s created UUID %s with uuid %s", name_, uuidStr_, uuid.to_string());
 }
@@ -152,6 +155,7 @@ bool Processor::addConnection(std::shared_ptr<Connectable> conn) {
         ret = true;
       }
     }
+    updateOutgoingSnapshot();
   }
   return ret;
 }
@@ -196,9 +200,21 @@ void Processor::removeConnection(std::shared_ptr<Connectable> conn) {
         }
       }
     }
+    updateOutgoingSnapshot();
   }
 }
 
+void Processor::updateOutgoingSnapshot() {
+  std::set<std::shared_ptr<Connection>> connections;
+  for (const auto &relationship : out_going_connections_) {
+    for (const auto &conn : relationship.second) {
+      connections.insert(std::static_pointer_cast<Connection>(conn));
+    }
+  }
+  std::shared_ptr<const std::vector<std::shared_ptr<Connection>>> snapshot = std::make_shared<const std::vector<std::shared_ptr<Connection>>>(connections.begin(), connections.end());
+  std::atomic_store(&outgoing_snapshot_, snapshot);
+}
+
 bool Processor::flowFilesQueued() {
   std::lock_guard<std::mutex> lock(mutex_);
 
@@ -214,20 +230,31 @@ bool Processor::flowFilesQueued() {
   return false;
 }
 
-bool Processor::flowFilesOutGoingFull() {
+uint64_t Processor::getFlowFilesQueuedCount() {
   std::lock_guard<std::mutex> lock(mutex_);
 
-  for (auto &&connection : out_going_connections_) {
-    // We already has connection for this relationship
-    std::set<std::shared_ptr<Connectable>> existedConnection = connection.second;
-    for (const auto conn : existedConnection) {
-      std::shared_ptr<Connection> connection = std::static_pointer_cast<Connection>(conn);
-      if (connection->isFull())
-        return true;
-    }
+  uint64_t queued = 0;
+  for (auto &&conn : _incomingConnections) {
+    std::shared_ptr<Connection> connection = std::static_pointer_cast<Connection>(conn);
+    queued += connection->getQueueSize();
   }
 
-  return false;
+  return queued;
+}
+
+bool Processor::flowFilesOutGoingFull() {
+  return getOutgoingFillLevel() >= Connection::FILL_LEVEL_FULL;
+}
+
+uint32_t Processor::getOutgoingFillLevel() {
+  uint32_t level = 0;
+  auto snapshot = std::atomic_load(&outgoing_snapshot_);
+  if (snapshot) {
+    for (const auto &connection : *snapshot) {
+      level = std::max(level, connection->getFillLevel());
+    }
+  }
+  return level;
 }
 
 void Processor::onTrigger(ProcessContext *context, ProcessSessionFactory *sessionFactory) {
@@ -56,6 +56,16 @@ uint64_t Repository::getRepoSize() {
   return repo_size_;
 }
 
+uint64_t Repository::getRecoveryRate() const {
+  const uint64_t start = recovery_start_ms_;
+  if (start == 0) {
+    return 0;
+  }
+  const uint64_t end = recovering_ ? getTimeMillis() : recovery_end_ms_.load();
+  const uint64_t elapsed = end > start ? end - start : 1;
+  return recovered_count_ * 1000 / elapsed;
+}
+
 void Repository::flush() {
 }
 
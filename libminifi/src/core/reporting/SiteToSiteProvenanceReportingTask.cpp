@@ -27,6 +27,7 @@
 #include <functional>
 #include <iostream>
 #include <utility>
+#include <chrono>
 #include "core/Repository.h"
 #include "core/reporting/SiteToSiteProvenanceReportingTask.h"
 #include "../include/io/StreamFactory.h"
@@ -37,10 +38,7 @@
 #include "provenance/Provenance.h"
 #include "FlowController.h"
 
-#include "rapidjson/document.h"
 #include "rapidjson/writer.h"
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/prettywriter.h"
 
 
 namespace org {
@@ -56,92 +54,139 @@ void SiteToSiteProvenanceReportingTask::initialize() {
   RemoteProcessorGroupPort::initialize();
 }
 
-void setJsonStr(const std::string& key, const std::string& value, rapidjson::Value& parent, rapidjson::Document::AllocatorType& alloc) { // NOLINT
-  rapidjson::Value keyVal;
-  rapidjson::Value valueVal;
-  const char* c_key = key.c_str();
-  const char* c_val = value.c_str();
+/**
+ * rapidjson output stream that appends to a string, so that a packet buffer keeps its
+ * capacity from one packet to the next
+ */
+class StringOutputStream {
+ public:
+  typedef char Ch;
 
-  keyVal.SetString(c_key, key.length(), alloc);
-  valueVal.SetString(c_val, value.length(), alloc);
+  explicit StringOutputStream(std::string &str)
+      : str_(str) {
+  }
 
-  parent.AddMember(keyVal, valueVal, alloc);
-}
+  void Put(char c) {
+    str_.push_back(c);
+  }
+
+  void Flush() {
+  }
 
-rapidjson::Value getStringValue(const std::string& value, rapidjson::Document::AllocatorType& alloc) { // NOLINT
-  rapidjson::Value Val;
-  Val.SetString(value.c_str(), value.length(), alloc);
-  return Val;
+ private:
+  std::string &str_;
+};
+
+typedef rapidjson::Writer<StringOutputStream> JsonWriter;
+
+void writeJsonStr(JsonWriter &writer, const char *key, const std::string &value) {
+  writer.Key(key);
+  writer.String(value.c_str(), value.length());
 }
 
-void appendJsonStr(const std::string& value, rapidjson::Value& parent, rapidjson::Document::AllocatorType& alloc) { // NOLINT
-  rapidjson::Value valueVal;
-  const char* c_val = value.c_str();
-  valueVal.SetString(c_val, value.length(), alloc);
-  parent.PushBack(valueVal, alloc);
+void writeJsonRecord(JsonWriter &writer, provenance::ProvenanceEventRecord &record) {
+  writer.StartObject();
+
+  writer.Key("timestampMillis");
+  writer.Uint64(record.getEventTime());
+  writer.Key("durationMillis");
+  writer.Uint64(record.getEventDuration());
+  writer.Key("lineageStart");
+  writer.Uint64(record.getlineageStartDate());
+  writer.Key("entitySize");
+  writer.Uint64(record.getFileSize());
+  writer.Key("entityOffset");
+  writer.Uint64(record.getFileOffset());
+
+  writer.Key("entityType");
+  writer.String("org.apache.nifi.flowfile.FlowFile");
+
+  writeJsonStr(writer, "eventId", record.getEventId());
+  writeJsonStr(writer, "eventType", provenance::ProvenanceEventRecord::ProvenanceEventTypeStr[record.getEventType()]);
+  writeJsonStr(writer, "details", record.getDetails());
+  writeJsonStr(writer, "componentId", record.getComponentId());
+  writeJsonStr(writer, "componentType", record.getComponentType());
+  writeJsonStr(writer, "entityId", record.getFlowFileUuid());
+  writeJsonStr(writer, "transitUri", record.getTransitUri());
+  writeJsonStr(writer, "remoteIdentifier", record.getSourceSystemFlowFileIdentifier());
+  writeJsonStr(writer, "alternateIdentifier", record.getAlternateIdentifierUri());
+
+  writer.Key("updatedAttributes");
+  writer.StartObject();
+  for (const auto &attr : record.getAttributes()) {
+    writer.Key(attr.first.c_str(), attr.first.length());
+    writer.String(attr.second.c_str(), attr.second.length());
+  }
+  writer.EndObject();
+
+  writer.Key("parentIds");
+  writer.StartArray();
+  for (const auto &parentUUID : record.getParentUuids()) {
+    writer.String(parentUUID.c_str(), parentUUID.length());
+  }
+  writer.EndArray();
+
+  writer.Key("childIds");
+  writer.StartArray();
+  for (const auto &childUUID : record.getChildrenUuids()) {
+    writer.String(childUUID.c_str(), childUUID.length());
+  }
+  writer.EndArray();
+
+  writer.Key("application");
+  writer.String(SiteToSiteProvenanceReportingTask::ProvenanceAppStr);
+
+  writer.EndObject();
 }
 
 void SiteToSiteProvenanceReportingTask::getJsonReport(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session,
                                                       std::vector<std::shared_ptr<core::SerializableComponent>> &records, std::string &report) {
-  rapidjson::Document array(rapidjson::kArrayType);
-  rapidjson::Document::AllocatorType &alloc = array.GetAllocator();
+  report.clear();
+  StringOutputStream stream(report);
+  JsonWriter writer(stream);
 
+  writer.StartArray();
   for (auto sercomp : records) {
     std::shared_ptr<provenance::ProvenanceEventRecord> record = std::dynamic_pointer_cast<provenance::ProvenanceEventRecord>(sercomp);
     if (nullptr == record) {
       break;
     }
+    writeJsonRecord(writer, *record);
+  }
+  writer.EndArray();
+}
 
-    rapidjson::Value recordJson(rapidjson::kObjectType);
-    rapidjson::Value updatedAttributesJson(rapidjson::kObjectType);
-    rapidjson::Value parentUuidJson(rapidjson::kArrayType);
-    rapidjson::Value childUuidJson(rapidjson::kArrayType);
-
-    recordJson.AddMember("timestampMillis", record->getEventTime(), alloc);
-    recordJson.AddMember("durationMillis", record->getEventDuration(), alloc);
-    recordJson.AddMember("lineageStart", record->getlineageStartDate(), alloc);
-    recordJson.AddMember("entitySize", record->getFileSize(), alloc);
-    recordJson.AddMember("entityOffset", record->getFileOffset(), alloc);
-
-    recordJson.AddMember("entityType", "org.apache.nifi.flowfile.FlowFile", alloc);
-
-    recordJson.AddMember("eventId", getStringValue(record->getEventId(), alloc), alloc);
-    recordJson.AddMember("eventType", getStringValue(provenance::ProvenanceEventRecord::ProvenanceEventTypeStr[record->getEventType()], alloc), alloc);
-    recordJson.AddMember("details", getStringValue(record->getDetails(), alloc), alloc);
-    recordJson.AddMember("componentId", getStringValue(record->getComponentId(), alloc), alloc);
-    recordJson.AddMember("componentType", getStringValue(record->getComponentType(), alloc), alloc);
-    recordJson.AddMember("entityId", getStringValue(record->getFlowFileUuid(), alloc), alloc);
-    recordJson.AddMember("transitUri", getStringValue(record->getTransitUri(), alloc), alloc);
-    recordJson.AddMember("remoteIdentifier", getStringValue(record->getSourceSystemFlowFileIdentifier(), alloc), alloc);
-    recordJson.AddMember("alternateIdentifier", getStringValue(record->getAlternateIdentifierUri(), alloc), alloc);
-
-    for (auto attr : record->getAttributes()) {
-      setJsonStr(attr.first, attr.second, updatedAttributesJson, alloc);
-    }
-    recordJson.AddMember("updatedAttributes", updatedAttributesJson, alloc);
-
-    for (auto parentUUID : record->getParentUuids()) {
-      appendJsonStr(parentUUID, parentUuidJson, alloc);
-    }
-    recordJson.AddMember("parentIds", parentUuidJson, alloc);
-
-    for (auto childUUID : record->getChildrenUuids()) {
-      appendJsonStr(childUUID, childUuidJson, alloc);
+bool SiteToSiteProvenanceReportingTask::streamJsonReport(const std::shared_ptr<core::Repository> &repo, const sitetosite::PayloadSender &send, std::vector<std::string> &keys,
+                                                         std::string &cursor) {
+  std::string payload;
+  StringOutputStream stream(payload);
+  JsonWriter writer(stream);
+  auto record = std::make_shared<provenance::ProvenanceEventRecord>();
+  size_t records_in_packet = 0;
+  bool sent = true;
+
+  writer.StartArray();
+  repo->DeSerializeFromCursor(batch_size_, record, [&](const std::string &key) {
+    writeJsonRecord(writer, *record);
+    keys.push_back(key);
+    cursor = key;
+    records_in_packet++;
+    if (payload.length() >= max_packet_size_) {
+      writer.EndArray();
+      sent = send(payload);
+      payload.clear();
+      writer.Reset(stream);
+      writer.StartArray();
+      records_in_packet = 0;
     }
-    recordJson.AddMember("childIds", childUuidJson, alloc);
-
-    rapidjson::Value applicationVal;
-    applicationVal.SetString(ProvenanceAppStr, std::strlen(ProvenanceAppStr));
-    recordJson.AddMember("application", applicationVal, alloc);
+    return sent;
+  });
+  writer.EndArray();
 
-    array.PushBack(recordJson, alloc);
+  if (sent && records_in_packet > 0) {
+    sent = send(payload);
   }
-
-  rapidjson::StringBuffer buffer;
-  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
-  array.Accept(writer);
-
-  report = buffer.GetString();
+  return sent;
 }
 
 void SiteToSiteProvenanceReportingTask::onSchedule(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSessionFactory> &sessionFactory) {
@@ -149,18 +194,10 @@ void SiteToSiteProvenanceReportingTask::onSchedule(const std::shared_ptr<core::P
 
 void SiteToSiteProvenanceReportingTask::onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) {
   logger_->log_debug("SiteToSiteProvenanceReportingTask -- onTrigger");
-  std::vector<std::shared_ptr<core::SerializableComponent>> records;
   logging::LOG_DEBUG(logger_) << "batch size " << batch_size_ << " records";
-  size_t deserialized = batch_size_;
   std::shared_ptr<core::Repository> repo = context->getProvenanceRepository();
-  std::function<std::shared_ptr<core::SerializableComponent>()> constructor = []() {return std::make_shared<provenance::ProvenanceEventRecord>();};
-  if (!repo->DeSerialize(records, deserialized, constructor) && deserialized == 0) {
-    return;
-  }
-  logging::LOG_DEBUG(logger_) << "Captured " << deserialized << " records";
-  std::string jsonStr;
-  this->getJsonReport(context, session, records, jsonStr);
-  if (jsonStr.length() <= 0) {
+  auto probe = std::make_shared<provenance::ProvenanceEventRecord>();
+  if (repo->DeSerializeFromCursor(1, probe, [](const std::string &key) {return true;}) == 0) {
     return;
   }
 
@@ -171,18 +208,28 @@ void SiteToSiteProvenanceReportingTask::onTrigger(const std::shared_ptr<core::Pr
     return;
   }
 
+  std::vector<std::string> keys;
+  std::string cursor;
+  auto start = std::chrono::steady_clock::now();
   try {
     std::map<std::string, std::string> attributes;
-    if (!protocol_->transmitPayload(context, session, jsonStr, attributes)) {
+    bool sent = protocol_->transmitPayloads(context, session, [&](const sitetosite::PayloadSender &send) {
+      return streamJsonReport(repo, send, keys, cursor);
+    }, attributes);
+    if (!sent) {
       context->yield();
+      returnProtocol(std::move(protocol_));
+      return;
     }
   } catch (...) {
     // if transfer bytes failed, return instead of purge the provenance records
     return;
   }
 
-  // we transfer the record, purge the record from DB
-  repo->Delete(records);
+  // we transferred the records, purge them from DB together with moving the cursor past them
+  repo->DeleteAndAdvanceCursor(keys, cursor);
+  uint64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  logger_->log_info("Reported %llu provenance records in %llu ms, %llu records/s", keys.size(), elapsed, keys.size() * 1000 / (elapsed > 0 ? elapsed : 1));
   returnProtocol(std::move(protocol_));
 }
 
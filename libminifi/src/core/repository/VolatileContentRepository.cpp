@@ -24,6 +24,8 @@
 #include <thread>
 #include "utils/StringUtils.h"
 #include "io/FileStream.h"
+#include "core/MemoryGovernor.h"
+#include "utils/file/FileUtils.h"
 
 namespace org {
 namespace apache {
@@ -33,6 +35,7 @@ namespace core {
 namespace repository {
 
 const char *VolatileContentRepository::minimal_locking = "minimal.locking";
+const char *VolatileContentRepository::spill_directory = "spill.directory";
 
 bool VolatileContentRepository::initialize(const std::shared_ptr<Configure> &configure) {
   VolatileRepository::initialize(configure);
@@ -57,6 +60,19 @@ bool VolatileContentRepository::initialize(const std::shared_ptr<Configure> &con
       utils::StringUtils::StringToBool(value, minimize_locking);
       minimize_locking_ = minimize_locking;
     }
+    std::stringstream spill_option;
+    spill_option << Configure::nifi_volatile_repository_options << getName() << "." << spill_directory;
+    if (configure->get(spill_option.str(), value) && !value.empty()) {
+      spill_directory_ = value;
+      utils::file::FileUtils::create_dir(spill_directory_);
+      // the claims of content spilled before a restart are gone
+      utils::file::FileUtils::list_dir(spill_directory_, [](const std::string &dir, const std::string &filename) {
+        if (utils::StringUtils::endsWith(filename, ".spill")) {
+          std::remove((dir + "/" + filename).c_str());
+        }
+        return true;
+      }, logger_, false);
+    }
   }
   if (!minimize_locking_) {
     for (auto ent : value_vector_) {
@@ -100,6 +116,9 @@ std::shared_ptr<io::BaseStream> VolatileContentRepository::write(const std::shar
       }
       return std::make_shared<io::AtomicEntryStream<std::shared_ptr<minifi::ResourceClaim>>>(claim, ent);
     }
+    if (!spill_directory_.empty() && (spilled_claims_.find(claim->getContentFullPath()) != spilled_claims_.end() || core::MemoryGovernor::getInstance().isUnderPressure())) {
+      return spill(claim, append);
+    }
   }
 
   int size = 0;
@@ -126,10 +145,24 @@ std::shared_ptr<io::BaseStream> VolatileContentRepository::write(const std::shar
       }
     }
   }
+  if (!spill_directory_.empty()) {
+    std::lock_guard<std::mutex> lock(map_mutex_);
+    return spill(claim, append);
+  }
   logger_->log_info("Cannot write %s %d, returning nullptr to roll back session. Repo is either full or locked", claim->getContentFullPath(), size);
   return nullptr;
 }
 
+std::shared_ptr<io::BaseStream> VolatileContentRepository::spill(const std::shared_ptr<minifi::ResourceClaim> &claim, bool append) {
+  logger_->log_debug("Spilling %s to %s", claim->getContentFullPath(), spill_directory_);
+  spilled_claims_.insert(claim->getContentFullPath());
+  return std::make_shared<io::FileStream>(getSpillPath(claim), append);
+}
+
+std::string VolatileContentRepository::getSpillPath(const std::shared_ptr<minifi::ResourceClaim> &claim) const {
+  return spill_directory_ + "/" + utils::file::FileUtils::get_child_path(claim->getContentFullPath()) + ".spill";
+}
+
 bool VolatileContentRepository::exists(const std::shared_ptr<minifi::ResourceClaim> &claim) {
   std::lock_guard<std::mutex> lock(map_mutex_);
   auto claim_check = master_list_.find(claim->getContentFullPath());
@@ -141,7 +174,7 @@ bool VolatileContentRepository::exists(const std::shared_ptr<minifi::ResourceCla
     return true;
   }
 
-  return false;
+  return spilled_claims_.find(claim->getContentFullPath()) != spilled_claims_.end();
 }
 
 std::shared_ptr<io::BaseStream> VolatileContentRepository::read(const std::shared_ptr<minifi::ResourceClaim> &claim) {
@@ -154,11 +187,21 @@ std::shared_ptr<io::BaseStream> VolatileContentRepository::read(const std::share
     }
     return std::make_shared<io::AtomicEntryStream<std::shared_ptr<minifi::ResourceClaim>>>(claim, ent);
   }
+  if (spilled_claims_.find(claim->getContentFullPath()) != spilled_claims_.end()) {
+    return std::make_shared<io::FileStream>(getSpillPath(claim), 0, false);
+  }
 
   return nullptr;
 }
 
 bool VolatileContentRepository::remove(const std::shared_ptr<minifi::ResourceClaim> &claim) {
+  if (!spill_directory_.empty()) {
+    std::lock_guard<std::mutex> lock(map_mutex_);
+    if (spilled_claims_.erase(claim->getContentFullPath()) > 0) {
+      std::remove(getSpillPath(claim).c_str());
+      return true;
+    }
+  }
   if (LIKELY(minimize_locking_ == true)) {
     std::lock_guard<std::mutex> lock(map_mutex_);
     auto ent = master_list_.find(claim->getContentFullPath());
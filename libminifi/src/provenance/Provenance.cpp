@@ -227,6 +227,13 @@ bool ProvenanceEventRecord::Serialize(const std::shared_ptr<core::SerializableCo
 bool ProvenanceEventRecord::DeSerialize(const uint8_t *buffer, const size_t bufferSize) {
   int ret;
 
+  // a record may be deserialized into repeatedly, so clear the fields that not every event sets
+  _attributes.clear();
+  _parentUuids.clear();
+  _childrenUuids.clear();
+  _transitUri.clear();
+  _sourceSystemFlowFileIdentifier.clear();
+
   org::apache::nifi::minifi::io::DataStream outStream(buffer, bufferSize);
 
   ret = readUTF(this->uuidStr_, &outStream);
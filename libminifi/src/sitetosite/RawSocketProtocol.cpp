@@ -537,41 +537,64 @@ std::shared_ptr<Transaction> RawSiteToSiteClient::createTransaction(std::string
 
 bool RawSiteToSiteClient::transmitPayload(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session, const std::string &payload,
                                           std::map<std::string, std::string> attributes) {
-  std::shared_ptr<Transaction> transaction = NULL;
-
   if (payload.length() <= 0)
     return false;
 
-  if (peer_state_ != READY) {
-    if (!bootstrap()) {
-      return false;
-    }
-  }
-
-  if (peer_state_ != READY) {
-    context->yield();
-    tearDown();
-    throw Exception(SITE2SITE_EXCEPTION, "Can not establish handshake with peer");
-  }
+  return transmitPayloads(context, session, [&payload](const PayloadSender &send) {
+    return send(payload);
+  }, attributes);
+}
 
-  // Create the transaction
+bool RawSiteToSiteClient::transmitPayloads(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session,
+                                           const std::function<bool(const PayloadSender &send)> &producer, std::map<std::string, std::string> attributes) {
+  std::shared_ptr<Transaction> transaction = NULL;
   std::string transactionID;
-  transaction = createTransaction(transactionID, SEND);
-
-  if (transaction == NULL) {
-    context->yield();
-    tearDown();
-    throw Exception(SITE2SITE_EXCEPTION, "Can not create transaction");
-  }
+  uint64_t packets = 0;
+  bool unavailable = false;
 
   try {
-    DataPacket packet(getLogger(), transaction, attributes, payload);
+    // the transaction is opened with the first packet, so a producer with nothing to send costs no round trip
+    PayloadSender send = [&](const std::string &payload) {
+      if (transaction == NULL) {
+        if (peer_state_ != READY) {
+          if (!bootstrap()) {
+            unavailable = true;
+            return false;
+          }
+        }
+
+        if (peer_state_ != READY) {
+          throw Exception(SITE2SITE_EXCEPTION, "Can not establish handshake with peer");
+        }
+
+        transaction = createTransaction(transactionID, SEND);
+
+        if (transaction == NULL) {
+          throw Exception(SITE2SITE_EXCEPTION, "Can not create transaction");
+        }
+      }
+
+      DataPacket packet(getLogger(), transaction, attributes, payload);
 
-    int16_t resp = send(transactionID, &packet, nullptr, session);
-    if (resp == -1) {
-      throw Exception(SITE2SITE_EXCEPTION, "Send Failed in transaction " + transactionID);
+      int16_t resp = this->send(transactionID, &packet, nullptr, session);
+      if (resp == -1) {
+        throw Exception(SITE2SITE_EXCEPTION, "Send Failed in transaction " + transactionID);
+      }
+      packets++;
+      return true;
+    };
+
+    if (!producer(send)) {
+      if (unavailable) {
+        return false;
+      }
+      throw Exception(SITE2SITE_EXCEPTION, "Payload could not be produced for transaction " + transactionID);
+    }
+
+    if (transaction == NULL) {
+      return false;
     }
-    logging::LOG_INFO(logger_) << "Site2Site transaction " << transactionID << " sent bytes length" << payload.length();
+    logging::LOG_INFO(logger_) << "Site2Site transaction " << transactionID << " sent " << packets << " packets, bytes length " << transaction->_bytes;
 
     if (!confirm(transactionID)) {
       throw Exception(SITE2SITE_EXCEPTION, "Confirm Failed in transaction " + transactionID);
@@ -0,0 +1,261 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/CRC32.h"
+#include <zlib.h>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CRC32_PCLMUL
+#include <emmintrin.h>
+#include <smmintrin.h>
+#include <wmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CRC32_TARGET_PCLMUL
+#else
+#include <cpuid.h>
+#define CRC32_TARGET_PCLMUL __attribute__((target("pclmul,sse4.1")))
+#endif
+#elif (defined(__aarch64__) && defined(__linux__)) || (defined(__aarch64__) && defined(__APPLE__))
+#define CRC32_ARMV8
+#ifdef __linux__
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#include <arm_acle.h>
+#ifdef __ARM_FEATURE_CRC32
+#define CRC32_TARGET_ARMV8
+#else
+#define CRC32_TARGET_ARMV8 __attribute__((target("+crc")))
+#endif
+#endif
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+namespace CRC32 {
+
+namespace {
+
+typedef uint32_t (*Kernel)(uint32_t crc, const uint8_t *data, size_t length);
+
+uint32_t zlibKernel(uint32_t crc, const uint8_t *data, size_t length) {
+  // zlib takes the length as unsigned int
+  while (length > 0) {
+    const uInt chunk = length > std::numeric_limits<uInt>::max() ? std::numeric_limits<uInt>::max() : static_cast<uInt>(length);
+    crc = static_cast<uint32_t>(crc32(crc, data, chunk));
+    data += chunk;
+    length -= chunk;
+  }
+  return crc;
+}
+
+#ifdef CRC32_PCLMUL
+
+/**
+ * Folds 64 byte blocks with carry-less multiplication and Barrett reduces the remainder, as described in
+ * "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" (Gopal et al., Intel, 2009).
+ * The constants are powers of x modulo the bit reflected CRC-32 polynomial. Operates on the inverted crc
+ * and takes a length of at least 64 that is a multiple of 16.
+ */
+CRC32_TARGET_PCLMUL uint32_t foldBlocks(uint32_t crc, const uint8_t *data, size_t length) {
+  alignas(16) static const uint64_t k1k2[] = { 0x0154442bd4, 0x01c6e41596 };
+  alignas(16) static const uint64_t k3k4[] = { 0x01751997d0, 0x00ccaa009e };
+  alignas(16) static const uint64_t k5k0[] = { 0x0163cd6124, 0x0000000000 };
+  alignas(16) static const uint64_t poly[] = { 0x01db710641, 0x01f7011641 };
+
+  __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+  __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16));
+  __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32));
+  __m128i x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48));
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+  __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+  data += 64;
+  length -= 64;
+
+  while (length >= 64) {
+    __m128i x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+    __m128i x6 = _mm_clmulepi64_si128(x2, k, 0x00);
+    __m128i x7 = _mm_clmulepi64_si128(x3, k, 0x00);
+    __m128i x8 = _mm_clmulepi64_si128(x4, k, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, k, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, k, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, k, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)));
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32)));
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48)));
+    data += 64;
+    length -= 64;
+  }
+
+  // fold the four lanes into one
+  k = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+  __m128i x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+  x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+  x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+  x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+  x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+  while (length >= 16) {
+    x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data))), x5);
+    data += 16;
+    length -= 16;
+  }
+
+  // 128 to 64 bits
+  const __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+  x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduction to 32 bits
+  k = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x10);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), k, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+uint32_t pclmulKernel(uint32_t crc, const uint8_t *data, size_t length) {
+  if (length >= 64) {
+    const size_t blocks = length & ~static_cast<size_t>(15);
+    crc = ~foldBlocks(~crc, data, blocks);
+    data += blocks;
+    length -= blocks;
+  }
+  return length > 0 ? zlibKernel(crc, data, length) : crc;
+}
+
+bool hasPclmul() {
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 1);
+  const unsigned int ecx = static_cast<unsigned int>(info[2]);
+#else
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+    return false;
+  }
+#endif
+  // PCLMULQDQ and SSE4.1
+  return (ecx & (1u << 1)) && (ecx & (1u << 19));
+}
+
+#endif
+
+#ifdef CRC32_ARMV8
+
+CRC32_TARGET_ARMV8 uint32_t armv8Kernel(uint32_t crc, const uint8_t *data, size_t length) {
+  crc = ~crc;
+  while (length > 0 && (reinterpret_cast<uintptr_t>(data) & 7)) {
+    crc = __crc32b(crc, *data++);
+    length--;
+  }
+  while (length >= 32) {
+    uint64_t words[4];
+    std::memcpy(words, data, sizeof(words));
+    crc = __crc32d(crc, words[0]);
+    crc = __crc32d(crc, words[1]);
+    crc = __crc32d(crc, words[2]);
+    crc = __crc32d(crc, words[3]);
+    data += 32;
+    length -= 32;
+  }
+  while (length >= 8) {
+    uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    crc = __crc32d(crc, word);
+    data += 8;
+    length -= 8;
+  }
+  while (length > 0) {
+    crc = __crc32b(crc, *data++);
+    length--;
+  }
+  return ~crc;
+}
+
+bool hasArmv8Crc() {
+#ifdef __linux__
+  return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#else
+  return true;
+#endif
+}
+
+#endif
+
+struct Implementation {
+  Kernel kernel;
+  const char *name;
+};
+
+Implementation select() {
+#ifdef CRC32_PCLMUL
+  if (hasPclmul()) {
+    return Implementation { pclmulKernel, "pclmul" };
+  }
+#endif
+#ifdef CRC32_ARMV8
+  if (hasArmv8Crc()) {
+    return Implementation { armv8Kernel, "armv8-crc" };
+  }
+#endif
+  return Implementation { zlibKernel, "zlib" };
+}
+
+const Implementation &getSelected() {
+  static const Implementation selected = select();
+  return selected;
+}
+
+}  // namespace
+
+uint32_t update(uint32_t crc, const uint8_t *data, size_t length) {
+  return getSelected().kernel(crc, data, length);
+}
+
+uint32_t updatePortable(uint32_t crc, const uint8_t *data, size_t length) {
+  return zlibKernel(crc, data, length);
+}
+
+const char *getImplementation() {
+  return getSelected().name;
+}
+
+} /* namespace CRC32 */
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,146 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/ThreadAffinity.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "utils/StringUtils.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+
+std::vector<int> ThreadAffinity::parseCpuList(const std::string &list) {
+  std::vector<int> cpus;
+  for (const auto &range : StringUtils::split(list, ",")) {
+    std::string trimmed = StringUtils::trim(range);
+    if (trimmed.empty()) {
+      continue;
+    }
+    try {
+      auto dash = trimmed.find('-');
+      if (dash == std::string::npos) {
+        cpus.push_back(std::stoi(trimmed));
+      } else {
+        int first = std::stoi(trimmed.substr(0, dash));
+        int last = std::stoi(trimmed.substr(dash + 1));
+        for (int cpu = first; cpu <= last; cpu++) {
+          cpus.push_back(cpu);
+        }
+      }
+    } catch (...) {
+      return std::vector<int>();
+    }
+  }
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  return cpus;
+}
+
+std::vector<int> ThreadAffinity::getAvailableCpus() {
+  std::vector<int> cpus;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &set)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+#endif
+  if (cpus.empty()) {
+    unsigned int count = std::thread::hardware_concurrency();
+    for (unsigned int cpu = 0; cpu < count; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+std::vector<std::vector<int>> ThreadAffinity::getNumaNodes(const std::vector<int> &cpus) {
+  std::vector<std::vector<int>> nodes;
+#ifdef __linux__
+  for (int node = 0;; node++) {
+    std::stringstream path;
+    path << "/sys/devices/system/node/node" << node << "/cpulist";
+    std::ifstream cpulist(path.str());
+    if (!cpulist.is_open()) {
+      break;
+    }
+    std::string list;
+    std::getline(cpulist, list);
+    std::vector<int> node_cpus;
+    for (int cpu : parseCpuList(list)) {
+      if (std::find(cpus.begin(), cpus.end(), cpu) != cpus.end()) {
+        node_cpus.push_back(cpu);
+      }
+    }
+    if (!node_cpus.empty()) {
+      nodes.push_back(node_cpus);
+    }
+  }
+#endif
+  if (nodes.empty() && !cpus.empty()) {
+    nodes.push_back(cpus);
+  }
+  return nodes;
+}
+
+bool ThreadAffinity::pinCurrentThread(const std::vector<int> &cpus) {
+#ifdef __linux__
+  if (cpus.empty()) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  return false;
+#endif
+}
+
+int ThreadAffinity::getCurrentCpu() {
+#ifdef __linux__
+  return sched_getcpu();
+#else
+  return -1;
+#endif
+}
+
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
@@ -0,0 +1,228 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/file/FileCopy.h"
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#ifndef WIN32
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#include <linux/fs.h>
+#endif
+#include "utils/file/FileUtils.h"
+
+namespace org {
+namespace apache {
+namespace nifi {
+namespace minifi {
+namespace utils {
+namespace file {
+namespace FileCopy {
+
+namespace {
+
+const size_t COPY_BUFFER_SIZE = 64 * 1024;
+
+#ifndef WIN32
+// upper bound of a single copy_file_range or sendfile call
+const size_t MAX_KERNEL_COPY_SIZE = 0x7ffff000;
+
+/**
+ * Copies remaining bytes starting at offset of in to the current position of out, trying the
+ * cheaper methods first. A method failing part way is continued by the next one.
+ */
+int64_t copyRange(int in, uint64_t offset, uint64_t remaining, int out, bool whole_file, Method &method) {
+#if defined(__linux__) && defined(FICLONE)
+  if (whole_file && ioctl(out, FICLONE, in) == 0) {
+    method = Method::CLONE;
+    return remaining;
+  }
+#endif
+  uint64_t done = 0;
+#if defined(__linux__) && defined(__NR_copy_file_range)
+  loff_t range_offset = offset;
+  while (done < remaining) {
+    ssize_t copied = syscall(__NR_copy_file_range, in, &range_offset, out, nullptr, std::min<uint64_t>(remaining - done, MAX_KERNEL_COPY_SIZE), 0);
+    if (copied < 0 && errno == EINTR) {
+      continue;
+    }
+    if (copied <= 0) {
+      break;
+    }
+    method = Method::COPY_FILE_RANGE;
+    done += copied;
+  }
+#endif
+#ifdef __linux__
+  off_t sendfile_offset = offset + done;
+  while (done < remaining) {
+    ssize_t copied = sendfile(out, in, &sendfile_offset, std::min<uint64_t>(remaining - done, MAX_KERNEL_COPY_SIZE));
+    if (copied < 0 && errno == EINTR) {
+      continue;
+    }
+    if (copied <= 0) {
+      break;
+    }
+    method = Method::SENDFILE;
+    done += copied;
+  }
+#endif
+  std::vector<char> buffer(COPY_BUFFER_SIZE);
+  while (done < remaining) {
+    ssize_t read = pread(in, buffer.data(), std::min<uint64_t>(remaining - done, buffer.size()), offset + done);
+    if (read < 0 && errno == EINTR) {
+      continue;
+    }
+    if (read < 0) {
+      return -1;
+    }
+    if (read == 0) {
+      break;
+    }
+    ssize_t written = 0;
+    while (written < read) {
+      ssize_t ret = write(out, buffer.data() + written, read - written);
+      if (ret < 0 && errno == EINTR) {
+        continue;
+      }
+      if (ret < 0) {
+        return -1;
+      }
+      written += ret;
+    }
+    method = Method::READ_WRITE;
+    done += read;
+  }
+  return done;
+}
+#endif
+
+}  // namespace
+
+const char *methodName(Method method) {
+  switch (method) {
+    case Method::CLONE:
+      return "clone";
+    case Method::COPY_FILE_RANGE:
+      return "copy_file_range";
+    case Method::SENDFILE:
+      return "sendfile";
+    case Method::READ_WRITE:
+      return "read/write";
+    default:
+      return "none";
+  }
+}
+
+bool sameDevice(const std::string &path, const std::string &other_path) {
+  struct stat path_stat;
+  struct stat other_stat;
+  auto stat_or_parent = [](const std::string &file, struct stat &result) {
+    if (stat(file.c_str(), &result) == 0) {
+      return true;
+    }
+    const std::size_t separator = file.find_last_of(FileUtils::get_separator());
+    std::string parent = separator == std::string::npos ? "." : file.substr(0, std::max<std::size_t>(separator, 1));
+    return stat(parent.c_str(), &result) == 0;
+  };
+  return stat_or_parent(path, path_stat) && stat_or_parent(other_path, other_stat) && path_stat.st_dev == other_stat.st_dev;
+}
+
+#ifndef WIN32
+int64_t copy(const std::string &source, uint64_t offset, int64_t length, int destination_fd, Method *method) {
+  int in = open(source.c_str(), O_RDONLY | O_CLOEXEC);
+  if (in < 0) {
+    return -1;
+  }
+  struct stat source_stat;
+  struct stat destination_stat;
+  if (fstat(in, &source_stat) != 0 || offset > static_cast<uint64_t>(source_stat.st_size) || fstat(destination_fd, &destination_stat) != 0) {
+    close(in);
+    return -1;
+  }
+  uint64_t available = source_stat.st_size - offset;
+  uint64_t remaining = length < 0 ? available : std::min<uint64_t>(length, available);
+  Method used = Method::NONE;
+  int64_t copied = copyRange(in, offset, remaining, destination_fd, offset == 0 && remaining == available && destination_stat.st_size == 0, used);
+  close(in);
+  if (copied >= 0 && method != nullptr) {
+    *method = used;
+  }
+  return copied;
+}
+#endif
+
+int64_t copy(const std::string &source, uint64_t offset, int64_t length, const std::string &destination, Method *method) {
+  Method used = Method::NONE;
+  int64_t copied = -1;
+#ifndef WIN32
+  int out = open(destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+  if (out < 0) {
+    return -1;
+  }
+  copied = copy(source, offset, length, out, &used);
+  if (close(out) != 0) {
+    copied = -1;
+  }
+#else
+  std::ifstream input(source, std::ios::in | std::ios::binary);
+  std::ofstream output(destination, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (input.is_open() && output.is_open() && input.seekg(offset)) {
+    std::vector<char> buffer(COPY_BUFFER_SIZE);
+    copied = 0;
+    while (length < 0 || copied < length) {
+      std::streamsize chunk = length < 0 ? buffer.size() : std::min<int64_t>(length - copied, buffer.size());
+      input.read(buffer.data(), chunk);
+      if (input.gcount() <= 0 || !output.write(buffer.data(), input.gcount())) {
+        break;
+      }
+      copied += input.gcount();
+    }
+    used = Method::READ_WRITE;
+    output.close();
+    if (!output || input.bad()) {
+      copied = -1;
+    }
+  }
+#endif
+  if (copied < 0) {
+    std::remove(destination.c_str());
+  } else if (method != nullptr) {
+    *method = used;
+  }
+  return copied;
+}
+
+} /* namespace FileCopy */
+} /* namespace file */
+} /* namespace utils */
+} /* namespace minifi */
+} /* namespace nifi */
+} /* namespace apache */
+} /* namespace org */
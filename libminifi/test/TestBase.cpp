@@ -24,6 +24,8 @@ TestPlan::TestPlan(std::shared_ptr<core::ContentRepository> content_repo, std::s
       content_repo_(content_repo),
       flow_repo_(flow_repo),
       prov_repo_(prov_repo),
+      controller_services_(std::make_shared<core::controller::ControllerServiceMap>()),
+      controller_services_provider_(std::make_shared<core::controller::StandardControllerServiceProvider>(controller_services_, nullptr, configuration)),
       finalized(false),
       location(-1),
       current_flowfile_(nullptr),
@@ -258,8 +260,34 @@ std::shared_ptr<minifi::Connection> TestPlan::buildFinalConnection(std::shared_p
   return connection;
 }
 
+std::shared_ptr<core::controller::ControllerServiceNode> TestPlan::addController(const std::string &controller_name, const std::string &name) {
+  std::lock_guard<std::recursive_mutex> guard(mutex);
+  if (finalized) {
+    return nullptr;
+  }
+  utils::Identifier uuid;
+  utils::IdGenerator::getIdGenerator()->generate(uuid);
+  std::shared_ptr<core::controller::ControllerServiceNode> controller_service_node = controller_services_provider_->createControllerService(controller_name, controller_name, uuid.to_string(), true);
+  if (controller_service_node == nullptr) {
+    return nullptr;
+  }
+  controller_service_node->initialize();
+  controller_service_node->setUUID(uuid);
+  controller_service_node->setName(name);
+  controller_services_->put(name, controller_service_node);
+  return controller_service_node;
+}
+
+bool TestPlan::setProperty(const std::shared_ptr<core::controller::ControllerServiceNode> &controller_service_node, const std::string &prop, const std::string &value) {
+  std::lock_guard<std::recursive_mutex> guard(mutex);
+  return controller_service_node->getControllerServiceImplementation()->setProperty(prop, value);
+}
+
 void TestPlan::finalize() {
   std::lock_guard<std::recursive_mutex> guard(mutex);
+  for (const auto &controller_service_node : controller_services_->getAllControllerServices()) {
+    controller_service_node->enable();
+  }
   if (relationships_.size() > 0) {
     relationships_.push_back(buildFinalConnection(processor_queue_.back()));
   } else {
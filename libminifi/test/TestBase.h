@@ -43,6 +43,8 @@
 #include "core/ProcessContextBuilder.h"
 #include "core/ProcessSession.h"
 #include "core/ProcessorNode.h"
+#include "core/controller/ControllerServiceMap.h"
+#include "core/controller/StandardControllerServiceProvider.h"
 #include "core/reporting/SiteToSiteProvenanceReportingTask.h"
 #include "core/state/nodes/FlowInformation.h"
 #include "properties/Configure.h"
@@ -262,6 +264,14 @@ class TestPlan {
 
   bool setProperty(const std::shared_ptr<core::Processor> proc, const std::string &prop, const std::string &value, bool dynamic = false);
 
+  /**
+   * Adds a controller service that processors of the plan can reference by name. Controller
+   * services are enabled when the plan is finalized.
+   */
+  std::shared_ptr<core::controller::ControllerServiceNode> addController(const std::string &controller_name, const std::string &name);
+
+  bool setProperty(const std::shared_ptr<core::controller::ControllerServiceNode> &controller_service_node, const std::string &prop, const std::string &value);
+
   void reset(bool reschedule = false);
 
   bool runNextProcessor(std::function<void(const std::shared_ptr<core::ProcessContext>, const std::shared_ptr<core::ProcessSession>)> verify = nullptr);
@@ -299,6 +309,7 @@ class TestPlan {
   std::shared_ptr<core::Repository> flow_repo_;
   std::shared_ptr<core::Repository> prov_repo_;
 
+  std::shared_ptr<core::controller::ControllerServiceMap> controller_services_;
   std::shared_ptr<core::controller::ControllerServiceProvider> controller_services_provider_;
 
   std::recursive_mutex mutex;
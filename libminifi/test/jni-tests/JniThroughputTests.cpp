@@ -0,0 +1,198 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../TestBase.h"
+#include "core/ProcessSession.h"
+#include "ExecuteJavaProcessor.h"
+#include "JVMCreator.h"
+#include "jvm/JVMLoader.h"
+#include "jvm/JniReferenceObjects.h"
+
+namespace {
+
+const size_t CHUNK_SIZE = 64 * 1024;
+const size_t CHUNK_COUNT = 1024;
+const size_t ATTRIBUTE_LOOKUPS = 100000;
+
+/**
+ * Services the JNI objects straight from the JVM loader, which is all a session needs.
+ */
+class LoaderServicer : public minifi::jni::JavaServicer {
+ public:
+  JNIEnv *attach() override {
+    return minifi::jni::JVMLoader::getInstance()->attach();
+  }
+  void detach() override {
+    minifi::jni::JVMLoader::getInstance()->detach();
+  }
+  jobject getClassLoader() override {
+    return minifi::jni::JVMLoader::getInstance()->getClassLoader();
+  }
+  minifi::jni::JavaClass loadClass(const std::string &class_name) override {
+    return minifi::jni::JVMLoader::getInstance()->load_class(class_name);
+  }
+};
+
+/**
+ * Exposes the native method signatures ExecuteJavaProcessor registers.
+ */
+class JavaSignatureAccess : public minifi::jni::processors::ExecuteJavaProcessor {
+ public:
+  using ExecuteJavaProcessor::getFlowFileSignatures;
+  using ExecuteJavaProcessor::getInputStreamSignatures;
+  using ExecuteJavaProcessor::getProcessSessionSignatures;
+};
+
+double megabytesPerSecond(size_t bytes, std::chrono::steady_clock::duration elapsed) {
+  const double seconds = std::chrono::duration_cast<std::chrono::duration<double>>(elapsed).count();
+  return bytes / (1024.0 * 1024.0) / seconds;
+}
+
+/**
+ * Drives the Java side of a process session from native code the way a NiFi processor would:
+ * writes content through the session's OutputStream, reads it back through its InputStream
+ * and looks up an attribute, timing each.
+ */
+class JavaSessionDriver : public core::Processor {
+ public:
+  explicit JavaSessionDriver(const std::shared_ptr<minifi::jni::JavaServicer> &servicer)
+      : core::Processor("JavaSessionDriver"),
+        servicer_(servicer),
+        bytes_written(0),
+        bytes_read(0),
+        attribute_lookups(0) {
+  }
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override {
+    auto loader = minifi::jni::JVMLoader::getInstance();
+    JNIEnv *env = loader->attach();
+    auto session_class = loader->load_class("org/apache/nifi/processor/JniProcessSession", env);
+    auto flow_file_class = loader->load_class("org/apache/nifi/processor/JniFlowFile", env);
+    jobject session_instance = session_class.newInstance(env);
+    auto jni_session = std::make_shared<minifi::jni::JniSession>(session, session_instance, servicer_);
+    session->addReference(jni_session);
+    loader->setReference(session_instance, env, jni_session.get());
+
+    jobject flow_file = env->CallObjectMethod(session_instance, session_class.getClassMethod(env, "create", "()Lorg/apache/nifi/flowfile/FlowFile;"));
+    minifi::jni::ThrowIf(env);
+    jobject key = env->NewStringUTF("benchmark");
+    jobject value = env->NewStringUTF("value");
+    jobject updated = env->CallObjectMethod(session_instance, session_class.getClassMethod(env, "putAttribute", "(Lorg/apache/nifi/flowfile/FlowFile;Ljava/lang/String;Ljava/lang/String;)Lorg/apache/nifi/flowfile/FlowFile;"),
+                                            flow_file, key, value);
+    minifi::jni::ThrowIf(env);
+    env->DeleteLocalRef(updated);
+
+    jbyteArray chunk = env->NewByteArray(CHUNK_SIZE);
+    std::vector<jbyte> content(CHUNK_SIZE, 'a');
+    env->SetByteArrayRegion(chunk, 0, CHUNK_SIZE, content.data());
+
+    jclass output_stream_class = env->FindClass("java/io/OutputStream");
+    jmethodID output_write = env->GetMethodID(output_stream_class, "write", "([B)V");
+    jmethodID output_close = env->GetMethodID(output_stream_class, "close", "()V");
+    auto start = std::chrono::steady_clock::now();
+    jobject output = env->CallObjectMethod(session_instance, session_class.getClassMethod(env, "write", "(Lorg/apache/nifi/flowfile/FlowFile;)Ljava/io/OutputStream;"), flow_file);
+    minifi::jni::ThrowIf(env);
+    for (size_t i = 0; i < CHUNK_COUNT; i++) {
+      env->CallVoidMethod(output, output_write, chunk);
+      minifi::jni::ThrowIf(env);
+      bytes_written += CHUNK_SIZE;
+    }
+    env->CallVoidMethod(output, output_close);
+    minifi::jni::ThrowIf(env);
+    write_time = std::chrono::steady_clock::now() - start;
+
+    jclass input_stream_class = env->FindClass("java/io/InputStream");
+    jmethodID input_read = env->GetMethodID(input_stream_class, "read", "([B)I");
+    start = std::chrono::steady_clock::now();
+    jobject input = env->CallObjectMethod(session_instance, session_class.getClassMethod(env, "read", "(Lorg/apache/nifi/flowfile/FlowFile;)Ljava/io/InputStream;"), flow_file);
+    minifi::jni::ThrowIf(env);
+    jint read;
+    while ((read = env->CallIntMethod(input, input_read, chunk)) > 0) {
+      bytes_read += read;
+    }
+    minifi::jni::ThrowIf(env);
+    read_time = std::chrono::steady_clock::now() - start;
+
+    jmethodID get_attribute = flow_file_class.getClassMethod(env, "getAttribute", "(Ljava/lang/String;)Ljava/lang/String;");
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ATTRIBUTE_LOOKUPS; i++) {
+      jobject attribute = env->CallObjectMethod(flow_file, get_attribute, key);
+      minifi::jni::ThrowIf(env);
+      if (attribute != nullptr) {
+        attribute_lookups++;
+        env->DeleteLocalRef(attribute);
+      }
+    }
+    attribute_time = std::chrono::steady_clock::now() - start;
+
+    env->CallVoidMethod(session_instance, session_class.getClassMethod(env, "remove", "(Lorg/apache/nifi/flowfile/FlowFile;)V"), flow_file);
+    minifi::jni::ThrowIf(env);
+    env->DeleteLocalRef(input);
+    env->DeleteLocalRef(output);
+    env->DeleteLocalRef(chunk);
+    env->DeleteLocalRef(key);
+    env->DeleteLocalRef(value);
+  }
+
+  std::shared_ptr<minifi::jni::JavaServicer> servicer_;
+  size_t bytes_written;
+  size_t bytes_read;
+  size_t attribute_lookups;
+  std::chrono::steady_clock::duration write_time;
+  std::chrono::steady_clock::duration read_time;
+  std::chrono::steady_clock::duration attribute_time;
+};
+
+}  // namespace
+
+TEST_CASE("JniSessionThroughput", "[jni1][.][benchmark]") {
+  // the JVM needs the NiFi API and the framework jar built from extensions/jni/nifi-framework-jni
+  const char *framework_dir = std::getenv("MINIFI_JNI_FRAMEWORK_DIR");
+  if (framework_dir == nullptr) {
+    WARN("MINIFI_JNI_FRAMEWORK_DIR is not set, skipping the JNI benchmark");
+    return;
+  }
+  TestController testController;
+  minifi::jni::JVMCreator creator("JVMCreator");
+  creator.configure(std::vector<std::string> { framework_dir });
+  creator.initializeJVM();
+
+  auto loader = minifi::jni::JVMLoader::getInstance();
+  JNIEnv *env = loader->attach();
+  loader->load_class("org/apache/nifi/processor/JniFlowFile", env).registerMethods(env, JavaSignatureAccess::getFlowFileSignatures());
+  loader->load_class("org/apache/nifi/processor/JniInputStream", env).registerMethods(env, JavaSignatureAccess::getInputStreamSignatures());
+  loader->load_class("org/apache/nifi/processor/JniProcessSession", env).registerMethods(env, JavaSignatureAccess::getProcessSessionSignatures());
+
+  auto plan = testController.createPlan();
+  auto driver = std::make_shared<JavaSessionDriver>(std::make_shared<LoaderServicer>());
+  plan->addProcessor(driver, "driver");
+  plan->runNextProcessor();
+
+  REQUIRE(driver->bytes_written == CHUNK_SIZE * CHUNK_COUNT);
+  REQUIRE(driver->bytes_read == driver->bytes_written);
+  REQUIRE(driver->attribute_lookups == ATTRIBUTE_LOOKUPS);
+  std::cout << "Wrote " << megabytesPerSecond(driver->bytes_written, driver->write_time) << " MB/s through the Java session" << std::endl;
+  std::cout << "Read " << megabytesPerSecond(driver->bytes_read, driver->read_time) << " MB/s through the Java session" << std::endl;
+  std::cout << "Looked up " << ATTRIBUTE_LOOKUPS << " attributes in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(driver->attribute_time).count() << " ms" << std::endl;
+}
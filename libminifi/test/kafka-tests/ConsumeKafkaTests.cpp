@@ -0,0 +1,289 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "../TestBase.h"
+#include "core/ProcessSession.h"
+#include "processors/PutFile.h"
+#include "utils/file/FileUtils.h"
+#include "ConsumeKafka.h"
+#include "PublishKafka.h"
+#include "MockKafkaCluster.h"
+
+namespace {
+
+const char *TOPIC = "minifi-test";
+
+/**
+ * Exposes turning polled messages into flow files, so that it runs without a broker.
+ */
+class ConsumeKafkaWithoutBroker : public minifi::processors::ConsumeKafka {
+ public:
+  ConsumeKafkaWithoutBroker()
+      : ConsumeKafka("consumeKafka") {
+  }
+
+  using ConsumeKafka::transferMessages;
+};
+
+/**
+ * Builds messages of a topic the way a poll returns them. The topic handle is created on a
+ * producer that never connects, which every librdkafka version supports.
+ */
+class OfflineTopic {
+ public:
+  explicit OfflineTopic(const std::string &topic)
+      : handle_(nullptr),
+        topic_(nullptr) {
+    std::array<char, 512U> errstr;
+    handle_ = rd_kafka_new(RD_KAFKA_PRODUCER, rd_kafka_conf_new(), errstr.data(), errstr.size());
+    REQUIRE(nullptr != handle_);
+    topic_ = rd_kafka_topic_new(handle_, topic.c_str(), nullptr);
+    REQUIRE(nullptr != topic_);
+  }
+
+  ~OfflineTopic() {
+    rd_kafka_topic_destroy(topic_);
+    rd_kafka_destroy(handle_);
+  }
+
+  /**
+   * @return a message pointing into payload and key, which have to outlive it
+   */
+  rd_kafka_message_t message(int32_t partition, int64_t offset, const std::string &payload, const std::string &key = "") const {
+    rd_kafka_message_t message;
+    std::memset(&message, 0, sizeof(message));
+    message.err = RD_KAFKA_RESP_ERR_NO_ERROR;
+    message.rkt = topic_;
+    message.partition = partition;
+    message.offset = offset;
+    message.payload = const_cast<char*>(payload.data());
+    message.len = payload.size();
+    message.key = key.empty() ? nullptr : const_cast<char*>(key.data());
+    message.key_len = key.size();
+    return message;
+  }
+
+ private:
+  rd_kafka_t *handle_;
+  rd_kafka_topic_t *topic_;
+};
+
+/**
+ * Keeps the content and the attributes of the flow files it takes.
+ */
+class ContentSink : public core::Processor {
+ public:
+  ContentSink()
+      : core::Processor("ContentSink") {
+  }
+
+  class ReadCallback : public minifi::InputStreamCallback {
+   public:
+    explicit ReadCallback(uint64_t size)
+        : content(size, '\0') {
+    }
+    int64_t process(std::shared_ptr<minifi::io::BaseStream> stream) {
+      return content.empty() ? 0 : stream->readData(reinterpret_cast<uint8_t*>(&content[0]), content.size());
+    }
+    std::string content;
+  };
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override {
+    while (auto flow_file = session->get()) {
+      ReadCallback callback(flow_file->getSize());
+      session->read(flow_file, &callback);
+      contents[callback.content] = flow_file->getAttributes();
+      session->remove(flow_file);
+    }
+  }
+
+  std::map<std::string, std::map<std::string, std::string>> contents;
+};
+
+/**
+ * Transfers the messages with a consumer scheduled against a broker that is never reached and
+ * returns the flow files created from them by content.
+ */
+std::map<std::string, std::map<std::string, std::string>> transferMessages(const std::vector<rd_kafka_message_t*> &messages, const std::string &demarcator) {
+  TestController testController;
+  auto plan = testController.createPlan();
+  auto consumer = std::make_shared<ConsumeKafkaWithoutBroker>();
+  plan->addProcessor(consumer, "consumeKafka");
+  plan->setProperty(consumer, minifi::processors::ConsumeKafka::SeedBrokers.getName(), "localhost:9");
+  plan->setProperty(consumer, minifi::processors::ConsumeKafka::TopicNames.getName(), TOPIC);
+  plan->setProperty(consumer, minifi::processors::ConsumeKafka::GroupID.getName(), "minifi");
+  if (!demarcator.empty()) {
+    plan->setProperty(consumer, minifi::processors::ConsumeKafka::MessageDemarcator.getName(), demarcator);
+  }
+  auto sink = std::make_shared<ContentSink>();
+  plan->addProcessor(sink, "sink", core::Relationship("success", "description"), true);
+  plan->runNextProcessor([&consumer, &messages](const std::shared_ptr<core::ProcessContext>, const std::shared_ptr<core::ProcessSession> session) {
+    consumer->transferMessages(messages, session);
+  });
+  plan->runNextProcessor();
+  consumer->notifyStop();
+  return sink->contents;
+}
+
+}  // namespace
+
+TEST_CASE("ConsumeKafkaMergesMessagesOfAPartition", "[consumekafka3]") {
+  OfflineTopic topic(TOPIC);
+  const std::vector<std::string> payloads = { "a", "b", "c", "d", "e" };
+  std::vector<rd_kafka_message_t> messages = { topic.message(0, 10, payloads[0]), topic.message(1, 3, payloads[1]), topic.message(0, 11, payloads[2]),
+      topic.message(1, 4, payloads[3]), topic.message(0, 12, payloads[4]) };
+  std::vector<rd_kafka_message_t*> polled;
+  for (auto &message : messages) {
+    polled.push_back(&message);
+  }
+
+  auto flow_files = transferMessages(polled, "|");
+  REQUIRE(2U == flow_files.size());
+  REQUIRE(1U == flow_files.count("a|c|e"));
+  REQUIRE(TOPIC == flow_files["a|c|e"][KAFKA_TOPIC_ATTRIBUTE]);
+  REQUIRE("0" == flow_files["a|c|e"][KAFKA_PARTITION_ATTRIBUTE]);
+  REQUIRE("10" == flow_files["a|c|e"][KAFKA_OFFSET_ATTRIBUTE]);
+  REQUIRE("3" == flow_files["a|c|e"][KAFKA_COUNT_ATTRIBUTE]);
+  REQUIRE(1U == flow_files.count("b|d"));
+  REQUIRE("1" == flow_files["b|d"][KAFKA_PARTITION_ATTRIBUTE]);
+  REQUIRE("3" == flow_files["b|d"][KAFKA_OFFSET_ATTRIBUTE]);
+  REQUIRE("2" == flow_files["b|d"][KAFKA_COUNT_ATTRIBUTE]);
+}
+
+TEST_CASE("ConsumeKafkaTransfersEveryMessage", "[consumekafka4]") {
+  OfflineTopic topic(TOPIC);
+  const std::vector<std::string> payloads = { "first", "second" };
+  const std::string key = "key";
+  std::vector<rd_kafka_message_t> messages = { topic.message(2, 7, payloads[0], key), topic.message(2, 8, payloads[1]) };
+  std::vector<rd_kafka_message_t*> polled = { &messages[0], &messages[1] };
+
+  auto flow_files = transferMessages(polled, "");
+  REQUIRE(2U == flow_files.size());
+  REQUIRE("2" == flow_files["first"][KAFKA_PARTITION_ATTRIBUTE]);
+  REQUIRE("7" == flow_files["first"][KAFKA_OFFSET_ATTRIBUTE]);
+  REQUIRE("key" == flow_files["first"][KAFKA_KEY_ATTRIBUTE]);
+  REQUIRE("8" == flow_files["second"][KAFKA_OFFSET_ATTRIBUTE]);
+  REQUIRE(0U == flow_files["second"].count(KAFKA_KEY_ATTRIBUTE));
+}
+
+namespace {
+
+std::shared_ptr<core::Processor> addConsumer(const std::shared_ptr<TestPlan> &plan, const MockKafkaCluster &cluster, const std::string &demarcator) {
+  auto consumer = plan->addProcessor("ConsumeKafka", "consumeKafka");
+  plan->setProperty(consumer, minifi::processors::ConsumeKafka::SeedBrokers.getName(), cluster.bootstraps());
+  plan->setProperty(consumer, minifi::processors::ConsumeKafka::TopicNames.getName(), TOPIC);
+  plan->setProperty(consumer, minifi::processors::ConsumeKafka::GroupID.getName(), "minifi");
+  plan->setProperty(consumer, minifi::processors::ConsumeKafka::OffsetReset.getName(), OFFSET_RESET_EARLIEST);
+  plan->setProperty(consumer, minifi::processors::ConsumeKafka::MaxPollTime.getName(), "5 sec");
+  if (!demarcator.empty()) {
+    plan->setProperty(consumer, minifi::processors::ConsumeKafka::MessageDemarcator.getName(), demarcator);
+  }
+  return consumer;
+}
+
+/**
+ * Runs the consumer with a session factory, the way the scheduler does.
+ */
+void runConsumer(const std::shared_ptr<TestPlan> &plan, const std::shared_ptr<core::Processor> &consumer) {
+  plan->runNextProcessor([&consumer](const std::shared_ptr<core::ProcessContext> context, const std::shared_ptr<core::ProcessSession>) {
+    consumer->onTrigger(context, std::make_shared<core::ProcessSessionFactory>(context));
+  });
+}
+
+std::set<std::string> readFiles(const std::string &dir) {
+  std::set<std::string> contents;
+  utils::file::FileUtils::list_dir(dir, [&contents](const std::string &path, const std::string &filename) {
+    std::ifstream file(path + "/" + filename);
+    contents.insert(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+    return true;
+  }, logging::LoggerFactory<TestPlan>::getLogger(), false);
+  return contents;
+}
+
+}  // namespace
+
+TEST_CASE("ConsumeKafkaMergesPartitionMessages", "[consumekafka1]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<minifi::processors::ConsumeKafka>();
+  MockKafkaCluster cluster(TOPIC, 2);
+  cluster.produce(TOPIC, 0, {"a", "b", "c"});
+  cluster.produce(TOPIC, 1, {"d", "e"});
+
+  char format[] = "/tmp/gt.XXXXXX";
+  const std::string dir = testController.createTempDirectory(format);
+  auto plan = testController.createPlan();
+  auto consumer = addConsumer(plan, cluster, "|");
+  auto putfile = plan->addProcessor("PutFile", "putfile", core::Relationship("success", "description"), true);
+  plan->setProperty(putfile, minifi::processors::PutFile::Directory.getName(), dir);
+
+  // the first polls may only serve the group join and the partition assignment
+  std::set<std::string> contents;
+  for (int i = 0; i < 5 && contents.size() < 2; i++) {
+    runConsumer(plan, consumer);
+    plan->runNextProcessor();
+    plan->reset();
+    contents = readFiles(dir);
+  }
+  REQUIRE((std::set<std::string>{"a|b|c", "d|e"}) == contents);
+}
+
+TEST_CASE("ConsumeKafkaCommitsOffsets", "[consumekafka2]") {
+  TestController testController;
+  MockKafkaCluster cluster(TOPIC, 2);
+  cluster.produce(TOPIC, 0, {"1", "2", "3"});
+
+  char format[] = "/tmp/gt.XXXXXX";
+  const std::string dir = testController.createTempDirectory(format);
+  {
+    auto plan = testController.createPlan();
+    auto consumer = addConsumer(plan, cluster, "");
+    auto putfile = plan->addProcessor("PutFile", "putfile", core::Relationship("success", "description"), true);
+    plan->setProperty(putfile, minifi::processors::PutFile::Directory.getName(), dir);
+    for (int i = 0; i < 5 && readFiles(dir).size() < 3; i++) {
+      runConsumer(plan, consumer);
+      plan->runNextProcessor();
+      plan->reset();
+    }
+    REQUIRE(3U == readFiles(dir).size());
+    // leaves the group, so that the next member gets the partition right away
+    std::static_pointer_cast<minifi::processors::ConsumeKafka>(consumer)->notifyStop();
+  }
+
+  // a new member of the group continues after the committed offsets
+  cluster.produce(TOPIC, 0, {"4"});
+  char format2[] = "/tmp/gt.XXXXXX";
+  const std::string dir2 = testController.createTempDirectory(format2);
+  auto plan = testController.createPlan();
+  auto consumer = addConsumer(plan, cluster, "");
+  auto putfile = plan->addProcessor("PutFile", "putfile", core::Relationship("success", "description"), true);
+  plan->setProperty(putfile, minifi::processors::PutFile::Directory.getName(), dir2);
+  for (int i = 0; i < 5 && readFiles(dir2).empty(); i++) {
+    runConsumer(plan, consumer);
+    plan->runNextProcessor();
+    plan->reset();
+  }
+  REQUIRE((std::set<std::string>{"4"}) == readFiles(dir2));
+}
@@ -0,0 +1,115 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef LIBMINIFI_TEST_KAFKA_TESTS_MOCKKAFKACLUSTER_H_
+#define LIBMINIFI_TEST_KAFKA_TESTS_MOCKKAFKACLUSTER_H_
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "../TestBase.h"
+#include "rdkafka.h"
+
+#include "rdkafka_mock.h"
+
+/**
+ * A single broker Kafka cluster running in this process.
+ */
+class MockKafkaCluster {
+ public:
+  MockKafkaCluster(const std::string &topic, int partitions)
+      : handle_(nullptr),
+        cluster_(nullptr) {
+    std::array<char, 512U> errstr;
+    // the handle the cluster runs on
+    handle_ = rd_kafka_new(RD_KAFKA_PRODUCER, rd_kafka_conf_new(), errstr.data(), errstr.size());
+    REQUIRE(nullptr != handle_);
+    cluster_ = rd_kafka_mock_cluster_new(handle_, 1);
+    REQUIRE(nullptr != cluster_);
+    REQUIRE(RD_KAFKA_RESP_ERR_NO_ERROR == rd_kafka_mock_topic_create(cluster_, topic.c_str(), partitions, 1));
+  }
+
+  ~MockKafkaCluster() {
+    rd_kafka_mock_cluster_destroy(cluster_);
+    rd_kafka_destroy(handle_);
+  }
+
+  std::string bootstraps() const {
+    return rd_kafka_mock_cluster_bootstraps(cluster_);
+  }
+
+  /**
+   * Produces the messages through a producer of its own, connected to the cluster.
+   */
+  void produce(const std::string &topic, int32_t partition, const std::vector<std::string> &messages) {
+    std::array<char, 512U> errstr;
+    rd_kafka_conf_t *conf = rd_kafka_conf_new();
+    rd_kafka_conf_set(conf, "bootstrap.servers", bootstraps().c_str(), errstr.data(), errstr.size());
+    rd_kafka_t *producer = rd_kafka_new(RD_KAFKA_PRODUCER, conf, errstr.data(), errstr.size());
+    REQUIRE(nullptr != producer);
+    for (const auto &message : messages) {
+      REQUIRE(RD_KAFKA_RESP_ERR_NO_ERROR == rd_kafka_producev(producer, RD_KAFKA_V_TOPIC(topic.c_str()), RD_KAFKA_V_PARTITION(partition),
+                                                               RD_KAFKA_V_VALUE(const_cast<char*>(message.data()), message.size()),
+                                                               RD_KAFKA_V_MSGFLAGS(RD_KAFKA_MSG_F_COPY), RD_KAFKA_V_END));
+    }
+    REQUIRE(RD_KAFKA_RESP_ERR_NO_ERROR == rd_kafka_flush(producer, 10000));
+    rd_kafka_destroy(producer);
+  }
+
+  /**
+   * Reads the committed messages of the topic from the beginning until count messages arrived
+   * or nothing arrived for a while.
+   */
+  std::vector<std::string> consume(const std::string &topic, size_t count) {
+    std::array<char, 512U> errstr;
+    rd_kafka_conf_t *conf = rd_kafka_conf_new();
+    rd_kafka_conf_set(conf, "bootstrap.servers", bootstraps().c_str(), errstr.data(), errstr.size());
+    rd_kafka_conf_set(conf, "group.id", "mock-cluster-reader", errstr.data(), errstr.size());
+    rd_kafka_conf_set(conf, "auto.offset.reset", "earliest", errstr.data(), errstr.size());
+    rd_kafka_conf_set(conf, "isolation.level", "read_committed", errstr.data(), errstr.size());
+    rd_kafka_t *consumer = rd_kafka_new(RD_KAFKA_CONSUMER, conf, errstr.data(), errstr.size());
+    REQUIRE(nullptr != consumer);
+    rd_kafka_poll_set_consumer(consumer);
+    rd_kafka_topic_partition_list_t *subscription = rd_kafka_topic_partition_list_new(1);
+    rd_kafka_topic_partition_list_add(subscription, topic.c_str(), RD_KAFKA_PARTITION_UA);
+    REQUIRE(RD_KAFKA_RESP_ERR_NO_ERROR == rd_kafka_subscribe(consumer, subscription));
+    rd_kafka_topic_partition_list_destroy(subscription);
+
+    std::vector<std::string> messages;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (messages.size() < count && std::chrono::steady_clock::now() < deadline) {
+      rd_kafka_message_t *message = rd_kafka_consumer_poll(consumer, 100);
+      if (message == nullptr) {
+        continue;
+      }
+      if (message->err == RD_KAFKA_RESP_ERR_NO_ERROR) {
+        messages.emplace_back(static_cast<const char*>(message->payload), message->len);
+      }
+      rd_kafka_message_destroy(message);
+    }
+    rd_kafka_consumer_close(consumer);
+    rd_kafka_destroy(consumer);
+    return messages;
+  }
+
+ private:
+  rd_kafka_t *handle_;
+  rd_kafka_mock_cluster_t *cluster_;
+};
+
+#endif  // LIBMINIFI_TEST_KAFKA_TESTS_MOCKKAFKACLUSTER_H_
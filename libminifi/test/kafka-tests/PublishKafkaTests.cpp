@@ -0,0 +1,160 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TestBase.h"
+#include "core/ProcessSession.h"
+#include "processors/GenerateFlowFile.h"
+#include "PublishKafka.h"
+#include "MockKafkaCluster.h"
+
+TEST_CASE("PublishKafkaOffersTransactions", "[publishkafka4]") {
+  auto publisher = std::make_shared<minifi::processors::PublishKafka>("publishKafka");
+  publisher->initialize();
+  const auto properties = publisher->getProperties();
+  REQUIRE(1U == properties.count(minifi::processors::PublishKafka::EnableIdempotence.getName()));
+  REQUIRE(1U == properties.count(minifi::processors::PublishKafka::UseTransactions.getName()));
+  REQUIRE(1U == properties.count(minifi::processors::PublishKafka::TransactionalIDPrefix.getName()));
+}
+
+namespace {
+
+const char *TOPIC = "minifi-publish";
+
+/**
+ * Takes the flow files that PublishKafka routed to success.
+ */
+class CountingProcessor : public core::Processor {
+ public:
+  CountingProcessor()
+      : core::Processor("CountingProcessor"),
+        count_(0) {
+  }
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override {
+    while (auto flowFile = session->get()) {
+      session->remove(flowFile);
+      count_++;
+    }
+  }
+
+  size_t count() const {
+    return count_;
+  }
+
+ private:
+  std::atomic<size_t> count_;
+};
+
+struct PublishFlow {
+  std::shared_ptr<TestPlan> plan;
+  std::shared_ptr<core::Processor> publisher;
+  std::shared_ptr<CountingProcessor> counter;
+};
+
+PublishFlow createFlow(TestController &testController, const MockKafkaCluster &cluster, size_t flow_files, bool transactional) {
+  PublishFlow flow;
+  flow.plan = testController.createPlan();
+  auto generator = flow.plan->addProcessor("GenerateFlowFile", "generate");
+  flow.plan->setProperty(generator, minifi::processors::GenerateFlowFile::BatchSize.getName(), std::to_string(flow_files));
+  flow.plan->setProperty(generator, minifi::processors::GenerateFlowFile::FileSize.getName(), "1 kB");
+  flow.plan->setProperty(generator, minifi::processors::GenerateFlowFile::DataFormat.getName(), "Text");
+  flow.publisher = flow.plan->addProcessor("PublishKafka", "publishKafka", core::Relationship("success", "description"), true);
+  flow.plan->setProperty(flow.publisher, minifi::processors::PublishKafka::SeedBrokers.getName(), cluster.bootstraps());
+  flow.plan->setProperty(flow.publisher, minifi::processors::PublishKafka::Topic.getName(), TOPIC);
+  flow.plan->setProperty(flow.publisher, minifi::processors::PublishKafka::ClientName.getName(), "minifi");
+  flow.plan->setProperty(flow.publisher, minifi::processors::PublishKafka::BatchSize.getName(), "100");
+  flow.plan->setProperty(flow.publisher, minifi::processors::PublishKafka::TargetBatchPayloadSize.getName(), "0 B");
+  flow.plan->setProperty(flow.publisher, minifi::processors::PublishKafka::DeliveryGuarantee.getName(), DELIVERY_REPLICATED);
+  flow.plan->setProperty(flow.publisher, minifi::processors::PublishKafka::EnableIdempotence.getName(), "true");
+  if (transactional) {
+    flow.plan->setProperty(flow.publisher, minifi::processors::PublishKafka::UseTransactions.getName(), "true");
+  }
+  flow.counter = std::make_shared<CountingProcessor>();
+  flow.plan->addProcessor(flow.counter, "counter", core::Relationship("success", "description"), true);
+  return flow;
+}
+
+/**
+ * Triggers PublishKafka until every flow file was routed to success.
+ * Returns the time onTrigger took and the time until every flow file was routed to success.
+ */
+std::pair<double, double> publish(PublishFlow &flow, size_t flow_files) {
+  flow.plan->runNextProcessor();  // GenerateFlowFile
+  auto start = std::chrono::steady_clock::now();
+  double trigger_time = 0;
+  auto deadline = start + std::chrono::seconds(30);
+  while (flow.counter->count() < flow_files && std::chrono::steady_clock::now() < deadline) {
+    auto trigger_start = std::chrono::steady_clock::now();
+    flow.plan->runNextProcessor();  // PublishKafka
+    trigger_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - trigger_start).count();
+    flow.plan->runNextProcessor();  // CountingProcessor
+    flow.plan->reset();
+    flow.plan->runNextProcessor([](const std::shared_ptr<core::ProcessContext>, const std::shared_ptr<core::ProcessSession>) {});  // skip GenerateFlowFile
+    if (flow.publisher->isYield()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(flow.publisher->getYieldTime()));
+    }
+  }
+  return std::make_pair(trigger_time, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
+
+}  // namespace
+
+TEST_CASE("PublishKafkaIdempotent", "[publishkafka1]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<minifi::processors::PublishKafka>();
+  MockKafkaCluster cluster(TOPIC, 1);
+  auto flow = createFlow(testController, cluster, 250, false);
+
+  publish(flow, 250);
+  REQUIRE(250U == flow.counter->count());
+  REQUIRE(250U == cluster.consume(TOPIC, 250).size());
+}
+
+TEST_CASE("PublishKafkaTransactional", "[publishkafka2]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<minifi::processors::PublishKafka>();
+  MockKafkaCluster cluster(TOPIC, 2);
+  auto flow = createFlow(testController, cluster, 250, true);
+
+  publish(flow, 250);
+  REQUIRE(250U == flow.counter->count());
+  // only committed messages are read
+  auto messages = cluster.consume(TOPIC, 251);
+  REQUIRE(250U == messages.size());
+}
+
+TEST_CASE("PublishKafkaBenchmark", "[publishkafka3][.][benchmark]") {
+  TestController testController;
+  const size_t count = 5000;
+  for (bool transactional : {false, true}) {
+    MockKafkaCluster cluster(TOPIC, 4);
+    auto flow = createFlow(testController, cluster, count, transactional);
+    auto times = publish(flow, count);
+    REQUIRE(count == flow.counter->count());
+    std::cout << (transactional ? "transactional" : "idempotent") << ": " << count / times.second << " flow files/s, "
+              << "onTrigger busy for " << times.first * 1000 << " ms of " << times.second * 1000 << " ms" << std::endl;
+  }
+}
@@ -0,0 +1,357 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../TestBase.h"
+#include "core/ProcessSession.h"
+#include "PublishMQTT.h"
+
+namespace {
+
+/**
+ * Stand-in for an MQTT broker: keeps the payloads published to it and acknowledges QoS 1 and 2
+ * after a delay, like a broker across a network would.
+ */
+class BrokerStandIn {
+ public:
+  explicit BrokerStandIn(std::chrono::milliseconds ack_delay = std::chrono::milliseconds(0))
+      : ack_delay_(ack_delay),
+        acknowledge_(true),
+        running_(true) {
+    server_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in address = { };
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    REQUIRE(bind(server_fd_, reinterpret_cast<struct sockaddr*>(&address), length) == 0);
+    REQUIRE(listen(server_fd_, 4) == 0);
+    getsockname(server_fd_, reinterpret_cast<struct sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+    acceptor_ = std::thread([this] {accept();});
+    writer_ = std::thread([this] {write();});
+  }
+
+  ~BrokerStandIn() {
+    running_ = false;
+    shutdown(server_fd_, SHUT_RDWR);
+    close(server_fd_);
+    acceptor_.join();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (int fd : clients_) {
+        shutdown(fd, SHUT_RDWR);
+      }
+      condition_.notify_all();
+    }
+    for (auto &reader : readers_) {
+      reader.join();
+    }
+    writer_.join();
+  }
+
+  std::string getURI() const {
+    return "tcp://127.0.0.1:" + std::to_string(port_);
+  }
+
+  void setAcknowledge(bool acknowledge) {
+    acknowledge_ = acknowledge;
+  }
+
+  std::multiset<std::string> getPayloads() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return payloads_;
+  }
+
+ private:
+  struct Response {
+    std::chrono::steady_clock::time_point due;
+    int fd;
+    std::string packet;
+  };
+
+  bool readFully(int fd, uint8_t *data, size_t size) {
+    while (size > 0) {
+      const ssize_t ret = recv(fd, data, size, 0);
+      if (ret <= 0) {
+        return false;
+      }
+      data += ret;
+      size -= ret;
+    }
+    return true;
+  }
+
+  void respond(int fd, uint8_t type, const uint8_t *message_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint8_t packet[] = { type, 2, message_id[0], message_id[1] };
+    responses_.push_back(Response { std::chrono::steady_clock::now() + ack_delay_, fd, std::string(reinterpret_cast<const char*>(packet), sizeof(packet)) });
+    condition_.notify_all();
+  }
+
+  void accept() {
+    while (running_) {
+      const int fd = ::accept(server_fd_, nullptr, nullptr);
+      if (fd < 0) {
+        return;
+      }
+      // brokers answer without waiting to coalesce small packets
+      int no_delay = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+      std::lock_guard<std::mutex> lock(mutex_);
+      clients_.insert(fd);
+      readers_.emplace_back([this, fd] {read(fd);});
+    }
+  }
+
+  void read(int fd) {
+    uint8_t header;
+    while (readFully(fd, &header, 1)) {
+      uint32_t length = 0;
+      uint8_t byte = 0;
+      int shift = 0;
+      do {
+        if (!readFully(fd, &byte, 1)) {
+          break;
+        }
+        length |= (byte & 0x7F) << shift;
+        shift += 7;
+      } while (byte & 0x80);
+      std::vector<uint8_t> body(length);
+      if (length > 0 && !readFully(fd, body.data(), length)) {
+        break;
+      }
+      const uint8_t type = header >> 4;
+      if (type == 1) {  // CONNECT
+        const uint8_t connack[] = { 0x20, 2, 0, 0 };
+        send(fd, connack, sizeof(connack), MSG_NOSIGNAL);
+      } else if (type == 3) {  // PUBLISH
+        const int qos = (header >> 1) & 3;
+        const size_t topic_length = (body[0] << 8) | body[1];
+        const size_t payload_offset = 2 + topic_length + (qos > 0 ? 2 : 0);
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          payloads_.insert(std::string(body.begin() + payload_offset, body.end()));
+        }
+        if (qos > 0 && acknowledge_) {
+          respond(fd, qos == 1 ? 0x40 : 0x50, &body[2 + topic_length]);
+        }
+      } else if (type == 6) {  // PUBREL
+        respond(fd, 0x70, body.data());
+      } else if (type == 12) {  // PINGREQ
+        const uint8_t pingresp[] = { 0xD0, 0 };
+        send(fd, pingresp, sizeof(pingresp), MSG_NOSIGNAL);
+      } else if (type == 14) {  // DISCONNECT
+        break;
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    clients_.erase(fd);
+    for (auto &response : responses_) {
+      if (response.fd == fd) {
+        response.fd = -1;
+      }
+    }
+    close(fd);
+  }
+
+  void write() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+      if (responses_.empty()) {
+        condition_.wait(lock);
+      } else if (responses_.front().due > std::chrono::steady_clock::now()) {
+        condition_.wait_until(lock, responses_.front().due);
+      } else {
+        if (responses_.front().fd >= 0) {
+          send(responses_.front().fd, responses_.front().packet.data(), responses_.front().packet.size(), MSG_NOSIGNAL);
+        }
+        responses_.pop_front();
+      }
+    }
+  }
+
+  std::chrono::milliseconds ack_delay_;
+  std::atomic<bool> acknowledge_;
+  std::atomic<bool> running_;
+  int server_fd_;
+  uint16_t port_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::set<int> clients_;
+  std::deque<Response> responses_;
+  std::multiset<std::string> payloads_;
+  std::thread acceptor_;
+  std::vector<std::thread> readers_;
+  std::thread writer_;
+};
+
+/**
+ * Creates count FlowFiles.
+ */
+class MessageSource : public core::Processor {
+ public:
+  explicit MessageSource(size_t count)
+      : core::Processor("MessageSource"),
+        count_(count) {
+  }
+
+  class WriteCallback : public minifi::OutputStreamCallback {
+   public:
+    explicit WriteCallback(const std::string &content)
+        : content_(content) {
+    }
+    int64_t process(std::shared_ptr<minifi::io::BaseStream> stream) {
+      return stream->writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(content_.data())), content_.size());
+    }
+   private:
+    const std::string &content_;
+  };
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override {
+    for (size_t i = 0; i < count_; i++) {
+      auto flow_file = session->create();
+      const std::string content = "message " + std::to_string(i);
+      WriteCallback callback(content);
+      session->write(flow_file, &callback);
+      session->transfer(flow_file, core::Relationship("success", "description"));
+    }
+  }
+
+ private:
+  size_t count_;
+};
+
+/**
+ * Counts the FlowFiles it takes.
+ */
+class CountingSink : public core::Processor {
+ public:
+  CountingSink()
+      : core::Processor("CountingSink"),
+        count(0) {
+  }
+
+  void onTrigger(const std::shared_ptr<core::ProcessContext> &context, const std::shared_ptr<core::ProcessSession> &session) override {
+    while (auto flow_file = session->get()) {
+      count++;
+      session->remove(flow_file);
+    }
+  }
+
+  size_t count;
+};
+
+struct PublishPlan {
+  std::shared_ptr<TestPlan> plan;
+  std::shared_ptr<CountingSink> sink;
+};
+
+PublishPlan createPublishPlan(TestController &testController, const BrokerStandIn &broker, size_t count, size_t batch_size, const std::string &qos,
+                              const std::string &max_in_flight, const std::string &output, const std::string &delivery_timeout) {
+  auto plan = testController.createPlan();
+  plan->addProcessor(std::make_shared<MessageSource>(count), "source");
+  auto processor = plan->addProcessor("PublishMQTT", "publish", core::Relationship("success", "description"), true);
+  plan->setProperty(processor, "Broker URI", broker.getURI());
+  plan->setProperty(processor, "Client ID", "publisher");
+  plan->setProperty(processor, "Topic", "test");
+  plan->setProperty(processor, "Quality of Service", qos);
+  plan->setProperty(processor, "Max In-Flight Messages", max_in_flight);
+  plan->setProperty(processor, "Batch Size", std::to_string(batch_size));
+  plan->setProperty(processor, "Delivery Timeout", delivery_timeout);
+  std::set<core::Relationship> terminated = { minifi::processors::PublishMQTT::Success, minifi::processors::PublishMQTT::Failure };
+  terminated.erase(core::Relationship(output, ""));
+  processor->setAutoTerminatedRelationships(terminated);
+  auto sink = std::make_shared<CountingSink>();
+  plan->addProcessor(sink, "sink", core::Relationship(output, "description"), true);
+  return PublishPlan { plan, sink };
+}
+
+/**
+ * Publishes count FlowFiles to the broker in a single trigger and counts those routed to output.
+ * @return the FlowFiles routed to output
+ */
+size_t publish(TestController &testController, const BrokerStandIn &broker, size_t count, const std::string &qos, const std::string &max_in_flight, const std::string &output,
+               const std::string &delivery_timeout = "10 sec") {
+  auto publish_plan = createPublishPlan(testController, broker, count, count, qos, max_in_flight, output, delivery_timeout);
+  publish_plan.plan->runNextProcessor();  // MessageSource
+  publish_plan.plan->runNextProcessor();  // PublishMQTT
+  publish_plan.plan->runNextProcessor();  // CountingSink
+  return publish_plan.sink->count;
+}
+
+}  // namespace
+
+TEST_CASE("PublishMQTTWaitsForAcknowledgements", "[mqtt1]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<minifi::processors::PublishMQTT>();
+  BrokerStandIn broker(std::chrono::milliseconds(1));
+
+  REQUIRE(publish(testController, broker, 25, "1", "10", "success") == 25);
+  std::multiset<std::string> expected;
+  for (int i = 0; i < 25; i++) {
+    expected.insert("message " + std::to_string(i));
+  }
+  REQUIRE(broker.getPayloads() == expected);
+
+  REQUIRE(publish(testController, broker, 5, "2", "3", "success") == 5);
+  REQUIRE(publish(testController, broker, 5, "0", "10", "success") == 5);
+}
+
+TEST_CASE("PublishMQTTFailsUnacknowledged", "[mqtt2]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<minifi::processors::PublishMQTT>();
+  BrokerStandIn broker;
+  broker.setAcknowledge(false);
+
+  // the window fills, the third FlowFile can not be sent and the rest of the batch stays queued
+  REQUIRE(publish(testController, broker, 5, "1", "2", "failure", "200 ms") == 3);
+  REQUIRE(broker.getPayloads().size() == 2);
+}
+
+TEST_CASE("PublishMQTTBenchmark", "[mqtt3][.][benchmark]") {
+  TestController testController;
+  BrokerStandIn broker(std::chrono::milliseconds(2));
+  const size_t count = 500;
+  for (const std::string window : { "1", "10" }) {
+    // the first trigger connects to the broker, only the second one is timed
+    auto publish_plan = createPublishPlan(testController, broker, 2 * count, count, "1", window, "success", "10 sec");
+    publish_plan.plan->runNextProcessor();  // MessageSource
+    publish_plan.plan->runNextProcessor();  // PublishMQTT
+    const auto start = std::chrono::steady_clock::now();
+    publish_plan.plan->runCurrentProcessor();
+    const auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    publish_plan.plan->runNextProcessor();  // CountingSink
+    REQUIRE(publish_plan.sink->count == 2 * count);
+    std::cout << "Published " << count << " messages of QoS 1 with " << window << " in flight, 2 ms acknowledgement delay: " << millis << " ms" << std::endl;
+  }
+}
@@ -0,0 +1,188 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TestBase.h"
+#include "opc.h"
+#include "open62541/server.h"
+#include "open62541/server_config_default.h"
+
+namespace opc = org::apache::nifi::minifi::opc;
+
+namespace {
+
+const UA_UInt16 SERVER_PORT = 48410;
+
+/**
+ * An open62541 server running in this process with a folder of Int32 variables
+ * named tag0, tag1, ... holding their index.
+ */
+class TestServer {
+ public:
+  explicit TestServer(size_t variables)
+      : server_(UA_Server_new()),
+        running_(true) {
+    UA_ServerConfig_setMinimal(UA_Server_getConfig(server_), SERVER_PORT, nullptr);
+
+    UA_ObjectAttributes folderAttributes = UA_ObjectAttributes_default;
+    UA_Server_addObjectNode(server_, UA_NODEID_STRING(1, const_cast<char*>("Tags")), UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                            UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES), UA_QUALIFIEDNAME(1, const_cast<char*>("Tags")),
+                            UA_NODEID_NUMERIC(0, UA_NS0ID_FOLDERTYPE), folderAttributes, nullptr, nullptr);
+    for (size_t i = 0; i < variables; ++i) {
+      std::string name = "tag" + std::to_string(i);
+      UA_VariableAttributes attributes = UA_VariableAttributes_default;
+      UA_Int32 value = static_cast<UA_Int32>(i);
+      UA_Variant_setScalar(&attributes.value, &value, &UA_TYPES[UA_TYPES_INT32]);
+      attributes.accessLevel = UA_ACCESSLEVELMASK_READ | UA_ACCESSLEVELMASK_WRITE;
+      UA_Server_addVariableNode(server_, UA_NODEID_STRING(1, &name[0]), UA_NODEID_STRING(1, const_cast<char*>("Tags")),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT), UA_QUALIFIEDNAME(1, &name[0]),
+                                UA_NODEID_NUMERIC(0, UA_NS0ID_BASEDATAVARIABLETYPE), attributes, nullptr, nullptr);
+    }
+
+    UA_Server_run_startup(server_);
+    thread_ = std::thread([this]() {
+      while (running_) {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          UA_Server_run_iterate(server_, false);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+  }
+
+  ~TestServer() {
+    running_ = false;
+    thread_.join();
+    UA_Server_run_shutdown(server_);
+    UA_Server_delete(server_);
+  }
+
+  void setValue(size_t variable, UA_Int32 value) {
+    std::string name = "tag" + std::to_string(variable);
+    UA_Variant variant;
+    UA_Variant_setScalar(&variant, &value, &UA_TYPES[UA_TYPES_INT32]);
+    std::lock_guard<std::mutex> lock(mutex_);
+    UA_Server_writeValue(server_, UA_NODEID_STRING(1, &name[0]), variant);
+  }
+
+  static std::string url() {
+    return "opc.tcp://localhost:" + std::to_string(SERVER_PORT);
+  }
+
+ private:
+  UA_Server *server_;
+  std::atomic<bool> running_;
+  std::mutex mutex_;
+  std::thread thread_;
+};
+
+std::unique_ptr<opc::Client> connect() {
+  auto client = opc::Client::createClient(logging::LoggerFactory<opc::Client>::getLogger(), "", {}, {}, {});
+  REQUIRE(nullptr != client);
+  REQUIRE(UA_STATUSCODE_GOOD == client->connect(TestServer::url()));
+  return client;
+}
+
+std::vector<opc::NodeReference> browseVariables(opc::Client &client) {
+  std::vector<opc::NodeReference> variables;
+  client.traverse(UA_NODEID_STRING(1, const_cast<char*>("Tags")), [&variables](opc::Client&, const UA_ReferenceDescription *ref, const std::string&) {
+    if (ref->nodeClass == UA_NODECLASS_VARIABLE) {
+      variables.push_back(opc::copyNodeReference(ref));
+    }
+    return true;
+  });
+  return variables;
+}
+
+std::map<std::string, std::string> toValues(const std::vector<opc::NodeData> &nodes) {
+  std::map<std::string, std::string> values;
+  for (const auto &node : nodes) {
+    values[node.attributes.at("Browsename")] = opc::nodeValue2String(node);
+  }
+  return values;
+}
+
+/**
+ * Collects the changed values until count values arrived or the time is up.
+ */
+std::map<std::string, std::string> waitForChanges(opc::Client &client, size_t count) {
+  std::map<std::string, std::string> values;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (values.size() < count && std::chrono::steady_clock::now() < deadline) {
+    for (const auto &value : toValues(client.getChangedNodeData(100))) {
+      values[value.first] = value.second;
+    }
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST_CASE("OPCBatchedRead", "[opc1]") {
+  TestServer server(20);
+  auto client = connect();
+
+  auto variables = browseVariables(*client);
+  REQUIRE(20U == variables.size());
+
+  // more nodes than fit into a single request
+  auto values = toValues(client->readNodeData(variables, "", 7));
+  REQUIRE(20U == values.size());
+  for (size_t i = 0; i < 20; ++i) {
+    REQUIRE(std::to_string(i) == values["tag" + std::to_string(i)]);
+  }
+
+  server.setValue(3, 42);
+  values = toValues(client->readNodeData(variables));
+  REQUIRE(20U == values.size());
+  REQUIRE("42" == values["tag3"]);
+}
+
+TEST_CASE("OPCSubscriptionOnlyReportsChanges", "[opc2]") {
+  TestServer server(20);
+  auto client = connect();
+
+  auto variables = browseVariables(*client);
+  REQUIRE(UA_STATUSCODE_GOOD == client->subscribe(variables, 50, 8));
+  REQUIRE(client->isSubscribed());
+
+  // every item reports its current value first
+  auto values = waitForChanges(*client, 20);
+  REQUIRE(20U == values.size());
+  REQUIRE("7" == values["tag7"]);
+
+  server.setValue(5, 105);
+  server.setValue(11, 111);
+  values = waitForChanges(*client, 2);
+  REQUIRE(2U == values.size());
+  REQUIRE("105" == values["tag5"]);
+  REQUIRE("111" == values["tag11"]);
+
+  REQUIRE(client->getChangedNodeData(200).empty());
+
+  client->unsubscribe();
+  REQUIRE_FALSE(client->isSubscribed());
+}
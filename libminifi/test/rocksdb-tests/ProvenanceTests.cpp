@@ -21,6 +21,11 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <set>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include "rapidjson/document.h"
 #include "../unit/ProvenanceTestHelper.h"
 #include "provenance/Provenance.h"
 #include "FlowFileRecord.h"
@@ -28,6 +33,7 @@
 #include "core/repository/AtomicRepoEntries.h"
 #include "FlowFileRepository.h"
 #include "core/repository/VolatileProvenanceRepository.h"
+#include "ProvenanceRepository.h"
 
 TEST_CASE("Test Provenance record create", "[Testprovenance::ProvenanceEventRecord]") {
   provenance::ProvenanceEventRecord record1(provenance::ProvenanceEventRecord::ProvenanceEventType::CREATE, "blah", "blahblah");
@@ -162,3 +168,251 @@ TEST_CASE("Test Provenance record serialization NoOp", "[Testprovenance::Provena
   record2.setEventId(eventId);
   REQUIRE(record2.DeSerialize(testRepository) == false);
 }
+
+namespace {
+
+std::shared_ptr<minifi::provenance::ProvenanceRepository> createProvenanceRepository(TestController &testController, std::set<std::string> &keys, int count, std::string *directory = nullptr) {
+  char format[] = "/tmp/testRepo.XXXXXX";
+  const std::string dir = testController.createTempDirectory(format);
+  if (directory != nullptr) {
+    *directory = dir;
+  }
+  auto repo = std::make_shared<minifi::provenance::ProvenanceRepository>("prov", dir, 0, 0, 1);
+  REQUIRE(repo->initialize(std::make_shared<minifi::Configure>()));
+  for (int i = 0; i < count; i++) {
+    provenance::ProvenanceEventRecord record(provenance::ProvenanceEventRecord::ProvenanceEventType::CLONE, "componentid", "componenttype");
+    record.setDetails("record " + std::to_string(i));
+    // only every other record has a parent, so fields left over from the previous record would show
+    if (i % 2 == 0) {
+      record.addParentUuid("parent" + std::to_string(i));
+    }
+    REQUIRE(record.Serialize(repo));
+    keys.insert(record.getEventId());
+  }
+  return repo;
+}
+
+}  // namespace
+
+TEST_CASE("Test Provenance cursor resumes and wraps around", "[TestProvenanceCursor]") {
+  TestController testController;
+  std::set<std::string> remaining;
+  auto repo = createProvenanceRepository(testController, remaining, 10);
+  auto record = std::make_shared<provenance::ProvenanceEventRecord>();
+
+  std::vector<std::string> first;
+  size_t visited = repo->DeSerializeFromCursor(4, record, [&](const std::string &key) {
+    first.push_back(key);
+    return true;
+  });
+  REQUIRE(4 == visited);
+  REQUIRE(repo->DeleteAndAdvanceCursor(first, first.back()));
+  for (const auto &key : first) {
+    remaining.erase(key);
+  }
+
+  // the stored cursor is not a record to any of the other readers
+  std::vector<std::shared_ptr<core::SerializableComponent>> records;
+  size_t max_size = 100;
+  bool found = repo->DeSerialize(records, max_size, []() {return std::make_shared<provenance::ProvenanceEventRecord>();});
+  REQUIRE(found);
+  REQUIRE(remaining.size() == records.size());
+  for (const auto &read : records) {
+    REQUIRE(1 == remaining.count(std::static_pointer_cast<provenance::ProvenanceEventRecord>(read)->getEventId()));
+  }
+  std::vector<std::shared_ptr<provenance::ProvenanceEventRecord>> events;
+  repo->getProvenanceRecord(events, 100);
+  REQUIRE(remaining.size() == events.size());
+
+  // a new record may sort on either side of the cursor, it is picked up in both cases
+  provenance::ProvenanceEventRecord late(provenance::ProvenanceEventRecord::ProvenanceEventType::CREATE, "componentid", "componenttype");
+  REQUIRE(late.Serialize(repo));
+  remaining.insert(late.getEventId());
+
+  std::vector<std::string> second;
+  visited = repo->DeSerializeFromCursor(100, record, [&](const std::string &key) {
+    second.push_back(key);
+    return true;
+  });
+  REQUIRE(7 == visited);
+  REQUIRE(remaining == std::set<std::string>(second.begin(), second.end()));
+  // the scan starts after the cursor, so it is in order up to the wrap and in order after it
+  size_t wraps = 0;
+  for (size_t i = 1; i < second.size(); i++) {
+    if (second[i] < second[i - 1]) {
+      wraps++;
+    }
+  }
+  REQUIRE(wraps <= 1);
+  if (second.front() < first.back()) {
+    REQUIRE(0 == wraps);
+  }
+
+  // the visitor stops the scan
+  size_t calls = 0;
+  visited = repo->DeSerializeFromCursor(100, record, [&](const std::string &key) {
+    return ++calls < 2;
+  });
+  REQUIRE(2 == visited);
+  repo->stop();
+}
+
+TEST_CASE("Test Provenance cursor survives reopening the repository", "[TestProvenanceCursorReopen]") {
+  TestController testController;
+  std::set<std::string> keys;
+  std::string dir;
+  auto repo = createProvenanceRepository(testController, keys, 6, &dir);
+  const std::vector<std::string> sorted(keys.begin(), keys.end());
+  auto record = std::make_shared<provenance::ProvenanceEventRecord>();
+
+  std::vector<std::string> first;
+  size_t visited = repo->DeSerializeFromCursor(3, record, [&](const std::string &key) {
+    first.push_back(key);
+    return true;
+  });
+  REQUIRE(3 == visited);
+  REQUIRE(std::vector<std::string>(sorted.begin(), sorted.begin() + 3) == first);
+  // nothing is deleted, only the position is stored
+  REQUIRE(repo->DeleteAndAdvanceCursor(std::vector<std::string>(), first.back()));
+  repo->stop();
+  repo->destroy();
+
+  auto reopened = std::make_shared<minifi::provenance::ProvenanceRepository>("prov", dir, 0, 0, 1);
+  REQUIRE(reopened->initialize(std::make_shared<minifi::Configure>()));
+  std::vector<std::string> second;
+  visited = reopened->DeSerializeFromCursor(3, record, [&](const std::string &key) {
+    second.push_back(key);
+    return true;
+  });
+  REQUIRE(3 == visited);
+  REQUIRE(std::vector<std::string>(sorted.begin() + 3, sorted.end()) == second);
+
+  // the cursor is not one of the records
+  std::vector<std::shared_ptr<provenance::ProvenanceEventRecord>> events;
+  reopened->getProvenanceRecord(events, 100);
+  REQUIRE(6 == events.size());
+  reopened->stop();
+}
+
+TEST_CASE("Test Provenance report is streamed in bounded packets", "[TestProvenanceStreamedReport]") {
+  TestController testController;
+  std::set<std::string> expected;
+  auto repo = createProvenanceRepository(testController, expected, 50);
+  auto configure = std::make_shared<minifi::Configure>();
+  core::reporting::SiteToSiteProvenanceReportingTask task(minifi::io::StreamFactory::getInstance(configure), configure);
+  task.setBatchSize(40);
+  task.setMaxPacketSize(2048);
+
+  std::vector<std::string> packets;
+  std::vector<std::string> keys;
+  std::string cursor;
+  bool sent = task.streamJsonReport(repo, [&](const std::string &payload) {
+    packets.push_back(payload);
+    return true;
+  }, keys, cursor);
+  REQUIRE(sent);
+
+  REQUIRE(40 == keys.size());
+  REQUIRE(keys.back() == cursor);
+  REQUIRE(packets.size() > 1);
+  std::set<std::string> reported;
+  for (const auto &packet : packets) {
+    rapidjson::Document array;
+    REQUIRE_FALSE(array.Parse(packet.c_str()).HasParseError());
+    REQUIRE(array.IsArray());
+    REQUIRE(array.Size() > 0);
+    for (const auto &event : array.GetArray()) {
+      std::string details = event["details"].GetString();
+      int i = std::stoi(details.substr(details.find(' ') + 1));
+      REQUIRE((i % 2 == 0 ? 1U : 0U) == event["parentIds"].Size());
+      reported.insert(event["eventId"].GetString());
+    }
+  }
+  REQUIRE(std::set<std::string>(keys.begin(), keys.end()) == reported);
+
+  // a failing send stops the scan
+  keys.clear();
+  size_t sends = 0;
+  sent = task.streamJsonReport(repo, [&](const std::string &payload) {
+    sends++;
+    return false;
+  }, keys, cursor);
+  REQUIRE_FALSE(sent);
+  REQUIRE(1 == sends);
+  REQUIRE(keys.size() < 40);
+  repo->stop();
+}
+
+TEST_CASE("Test Provenance report streamed from the volatile repository", "[TestProvenanceStreamedReport]") {
+  auto repo = std::make_shared<core::repository::VolatileProvenanceRepository>();
+  auto configure = std::make_shared<minifi::Configure>();
+  configure->set(std::string(minifi::Configure::nifi_volatile_repository_options) + repo->getName() + ".max.count", "64");
+  REQUIRE(repo->initialize(configure));
+  std::set<std::string> remaining;
+  for (int i = 0; i < 30; i++) {
+    provenance::ProvenanceEventRecord record(provenance::ProvenanceEventRecord::ProvenanceEventType::CREATE, "componentid", "componenttype");
+    REQUIRE(record.Serialize(repo));
+    remaining.insert(record.getEventId());
+  }
+  core::reporting::SiteToSiteProvenanceReportingTask task(minifi::io::StreamFactory::getInstance(configure), configure);
+  task.setBatchSize(20);
+
+  // a report that could not be sent leaves the records in place
+  std::vector<std::string> keys;
+  std::string cursor;
+  bool sent = task.streamJsonReport(repo, [](const std::string &payload) {
+    return false;
+  }, keys, cursor);
+  REQUIRE_FALSE(sent);
+
+  std::set<std::string> reported;
+  for (int report = 0; report < 2; report++) {
+    keys.clear();
+    sent = task.streamJsonReport(repo, [&](const std::string &payload) {
+      rapidjson::Document array;
+      REQUIRE_FALSE(array.Parse(payload.c_str()).HasParseError());
+      for (const auto &event : array.GetArray()) {
+        reported.insert(event["eventId"].GetString());
+      }
+      return true;
+    }, keys, cursor);
+    REQUIRE(sent);
+    REQUIRE(repo->DeleteAndAdvanceCursor(keys, cursor));
+  }
+  REQUIRE(remaining == reported);
+
+  // everything was reported once and removed
+  auto record = std::make_shared<provenance::ProvenanceEventRecord>();
+  size_t visited = repo->DeSerializeFromCursor(100, record, [](const std::string &key) {return true;});
+  REQUIRE(0 == visited);
+}
+
+TEST_CASE("Test Provenance streamed report throughput", "[TestProvenanceStreamedReport][.][benchmark]") {
+  TestController testController;
+  std::set<std::string> expected;
+  const int count = 20000;
+  auto repo = createProvenanceRepository(testController, expected, count);
+  auto configure = std::make_shared<minifi::Configure>();
+  core::reporting::SiteToSiteProvenanceReportingTask task(minifi::io::StreamFactory::getInstance(configure), configure);
+  task.setBatchSize(count);
+
+  std::vector<std::string> keys;
+  std::string cursor;
+  size_t packets = 0;
+  size_t largest = 0;
+  auto start = std::chrono::steady_clock::now();
+  bool sent = task.streamJsonReport(repo, [&](const std::string &payload) {
+    packets++;
+    largest = std::max(largest, payload.length());
+    return true;
+  }, keys, cursor);
+  REQUIRE(sent);
+  REQUIRE(repo->DeleteAndAdvanceCursor(keys, cursor));
+  auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+  REQUIRE(count == keys.size());
+  REQUIRE(largest < core::reporting::SiteToSiteProvenanceReportingTask::DefaultMaxPacketSize + 4096);
+  std::cout << "streamed " << count << " records in " << packets << " packets (largest " << largest << " bytes) in " << millis << " ms, "
+            << (millis > 0 ? count * 1000 / millis : count) << " records/s" << std::endl;
+  repo->stop();
+}
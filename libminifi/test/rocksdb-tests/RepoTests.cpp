@@ -250,3 +250,103 @@ TEST_CASE("Test Validate Checkpoint ", "[TestFFR5]") {
   LogTestController::getInstance().reset();
 }
 
+
+TEST_CASE("Test Parallel Recovery After Clean Shutdown", "[TestFFR6]") {
+  TestController testController;
+  utils::file::FileUtils::delete_dir(FLOWFILE_CHECKPOINT_DIRECTORY, true);
+  char format[] = "/tmp/testRepo.XXXXXX";
+  auto dir = testController.createTempDirectory(format);
+
+  std::shared_ptr<minifi::Configure> configure = std::make_shared<minifi::Configure>();
+  configure->set(minifi::Configure::nifi_flowfile_repository_recovery_threads, "4");
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::FileSystemRepository>();
+  utils::Identifier uuid;
+  std::string connection_uuid;
+
+  {
+    std::shared_ptr<core::repository::FlowFileRepository> repository = std::make_shared<core::repository::FlowFileRepository>("ff", dir, 0, 0, 1);
+    REQUIRE(true == repository->initialize(configure));
+    repository->loadComponent(content_repo);
+    repository->start();
+
+    std::shared_ptr<minifi::Connection> connection = std::make_shared<minifi::Connection>(repository, content_repo, "recovered");
+    connection->getUUID(uuid);
+    connection_uuid = connection->getUUIDStr();
+    std::map<std::string, std::string> attributes;
+    for (int i = 0; i < 100; i++) {
+      std::shared_ptr<core::FlowFile> flow_file = std::make_shared<minifi::FlowFileRecord>(repository, content_repo, attributes);
+      connection->put(flow_file);
+    }
+    repository->stop();
+  }
+
+  std::shared_ptr<core::repository::FlowFileRepository> repository = std::make_shared<core::repository::FlowFileRepository>("ff", dir, 0, 0, 1);
+  REQUIRE(true == repository->initialize(configure));
+  std::shared_ptr<minifi::Connection> connection = std::make_shared<minifi::Connection>(repository, content_repo, "recovered", uuid);
+  std::map<std::string, std::shared_ptr<core::Connectable>> connectionMap;
+  connectionMap[connection_uuid] = connection;
+  repository->setConnectionMap(connectionMap);
+  repository->loadComponent(content_repo);
+  repository->start();
+
+  for (int i = 0; i < 50 && repository->getRecoveredCount() < 100; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  repository->stop();
+
+  REQUIRE(100 == repository->getRecoveredCount());
+  REQUIRE(100 == connection->getQueueSize());
+  REQUIRE(false == repository->isRecovering());
+
+  utils::file::FileUtils::delete_dir(FLOWFILE_CHECKPOINT_DIRECTORY, true);
+}
+
+TEST_CASE("Test Delete Keeps Content Owned By A Clone", "[TestFFR7]") {
+  TestController testController;
+  char format[] = "/tmp/testRepo.XXXXXX";
+
+  auto dir = testController.createTempDirectory(format);
+
+  std::shared_ptr<core::repository::FlowFileRepository> repository = std::make_shared<core::repository::FlowFileRepository>("ff", dir, 0, 0, 1);
+
+  std::map<std::string, std::string> attributes;
+
+  std::fstream file;
+  std::stringstream ss;
+  ss << dir << utils::file::FileUtils::get_separator() << "tstFile.ext";
+  file.open(ss.str(), std::ios::out);
+  file << "tempFile";
+  file.close();
+
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::FileSystemRepository>();
+
+  repository->initialize(std::make_shared<minifi::Configure>());
+
+  repository->loadComponent(content_repo);
+
+  std::shared_ptr<minifi::ResourceClaim> claim = std::make_shared<minifi::ResourceClaim>(ss.str(), content_repo);
+
+  std::shared_ptr<minifi::FlowFileRecord> record = std::make_shared<minifi::FlowFileRecord>(repository, content_repo, attributes, claim);
+  std::shared_ptr<minifi::FlowFileRecord> clone = std::make_shared<minifi::FlowFileRecord>(repository, content_repo, attributes, claim);
+
+  REQUIRE(true == record->Serialize());
+
+  repository->Delete(record->getUUIDStr(), claim);
+  record = nullptr;
+
+  repository->flush();
+
+  std::ifstream owned(ss.str(), std::ios::in);
+  REQUIRE(true == owned.good());
+  owned.close();
+
+  // the clone was never stored, so dropping it removes the content
+  clone = nullptr;
+
+  repository->stop();
+
+  std::ifstream released(ss.str(), std::ios::in);
+  REQUIRE(false == released.good());
+
+  utils::file::FileUtils::delete_dir(FLOWFILE_CHECKPOINT_DIRECTORY, true);
+}
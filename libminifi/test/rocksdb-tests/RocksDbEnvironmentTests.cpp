@@ -0,0 +1,99 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "../TestBase.h"
+#include "properties/Configure.h"
+#include "FlowFileRepository.h"
+#include "ProvenanceRepository.h"
+#include "RocksDbEnvironment.h"
+#include "RocksDbMetrics.h"
+
+namespace {
+
+const minifi::state::response::SerializedResponseNode *findNode(const std::vector<minifi::state::response::SerializedResponseNode> &nodes, const std::string &name) {
+  for (const auto &node : nodes) {
+    if (node.name == name) {
+      return &node;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+// the environment is configured once per process, so everything is checked in one test case
+TEST_CASE("RepositoriesShareTheRocksDbEnvironment", "[rocksdbenv1]") {
+  TestController testController;
+  LogTestController::getInstance().setDebug<core::repository::RocksDbEnvironment>();
+  char format[] = "/tmp/testRepo.XXXXXX";
+  const std::string flowfile_dir = testController.createTempDirectory(format);
+  char format2[] = "/tmp/testRepo.XXXXXX";
+  const std::string provenance_dir = testController.createTempDirectory(format2);
+
+  auto configure = std::make_shared<minifi::Configure>();
+  configure->set(minifi::Configure::nifi_rocksdb_memory_limit, "16 MB");
+  configure->set(minifi::Configure::nifi_rocksdb_statistics, "true");
+  configure->set(std::string(minifi::Configure::nifi_flowfile_repository_rocksdb_options) + "compression", "none");
+  configure->set(std::string(minifi::Configure::nifi_flowfile_repository_rocksdb_options) + "bloom.filter.bits", "10");
+  configure->set(std::string(minifi::Configure::nifi_provenance_repository_rocksdb_options) + "compaction.style", "universal");
+  // not built into the bundled RocksDB, the repository still opens uncompressed
+  configure->set(std::string(minifi::Configure::nifi_provenance_repository_rocksdb_options) + "compression", "bzip2");
+
+  auto flowfile_repo = std::make_shared<core::repository::FlowFileRepository>("ff", flowfile_dir, 0, 0, 1);
+  REQUIRE(flowfile_repo->initialize(configure));
+  auto provenance_repo = std::make_shared<minifi::provenance::ProvenanceRepository>("prov", provenance_dir, 0, 0, 1);
+  REQUIRE(provenance_repo->initialize(configure));
+
+  auto &environment = core::repository::RocksDbEnvironment::getInstance();
+  REQUIRE(16U * 1024 * 1024 == environment.getBlockCache()->GetCapacity());
+  REQUIRE(environment.getWriteBufferManager()->enabled());
+  REQUIRE(8U * 1024 * 1024 == environment.getWriteBufferManager()->buffer_size());
+  REQUIRE(nullptr != environment.getStatistics());
+
+  const std::string value(1024, 'x');
+  for (int i = 0; i < 100; i++) {
+    REQUIRE(flowfile_repo->Put("ff" + std::to_string(i), reinterpret_cast<const uint8_t*>(value.data()), value.size()));
+    REQUIRE(provenance_repo->Put("prov" + std::to_string(i), reinterpret_cast<const uint8_t*>(value.data()), value.size()));
+  }
+  std::string read;
+  REQUIRE(flowfile_repo->Get("ff42", read));
+  REQUIRE(value == read);
+  REQUIRE(provenance_repo->Get("prov42", read));
+  REQUIRE(value == read);
+
+  // the memtables of both databases are charged to the one budget
+  REQUIRE(environment.getWriteBufferManager()->memory_usage() > 0);
+  REQUIRE(environment.getBlockCache()->GetUsage() >= environment.getWriteBufferManager()->memory_usage());
+
+  auto metrics = std::make_shared<minifi::state::response::RocksDbMetrics>();
+  auto nodes = metrics->serialize();
+  REQUIRE(nullptr != findNode(nodes, "blockCacheUsage"));
+  REQUIRE(nullptr != findNode(nodes, "memtableUsage"));
+  auto statistics = findNode(nodes, "statistics");
+  REQUIRE(nullptr != statistics);
+  auto keys_written = findNode(statistics->children, "rocksdb.number.keys.written");
+  REQUIRE(nullptr != keys_written);
+  REQUIRE("200" == keys_written->value.to_string());
+
+  flowfile_repo->stop();
+  provenance_repo->stop();
+  utils::file::FileUtils::delete_dir(FLOWFILE_CHECKPOINT_DIRECTORY, true);
+}
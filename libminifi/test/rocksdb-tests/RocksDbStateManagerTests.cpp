@@ -0,0 +1,99 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "../TestBase.h"
+#include "RocksDbStateManagerService.h"
+
+static std::shared_ptr<minifi::controllers::RocksDbStateManagerService> createStateManager(const std::string &directory, bool always_persist) {
+  auto state_manager = std::make_shared<minifi::controllers::RocksDbStateManagerService>("statemanager");
+  state_manager->initialize();
+  state_manager->setProperty(minifi::controllers::RocksDbStateManagerService::Directory, directory);
+  state_manager->setProperty(minifi::controllers::RocksDbStateManagerService::AlwaysPersist, always_persist ? "true" : "false");
+  state_manager->setProperty(minifi::controllers::RocksDbStateManagerService::AutoPersistenceInterval, "1 hour");
+  state_manager->onEnable();
+  return state_manager;
+}
+
+TEST_CASE("RocksDbStateManagerSurvivesRestart", "[rocksdbstatemanager1]") {
+  TestController testController;
+  char format[] = "/tmp/state.XXXXXX";
+  std::string dir = testController.createTempDirectory(format);
+
+  std::unordered_map<std::string, std::string> state;
+  state["listing.timestamp"] = "1000";
+  {
+    auto state_manager = createStateManager(dir, false);
+    REQUIRE(true == state_manager->set("component", state));
+    REQUIRE(true == state_manager->set("removed", state));
+    REQUIRE(true == state_manager->clear("removed"));
+    std::unordered_map<std::string, std::string> stored;
+    // updates are visible before the write ahead log is synced
+    REQUIRE(true == state_manager->get("component", stored));
+    REQUIRE(false == state_manager->get("removed", stored));
+    // disabling syncs the write ahead log
+    state_manager->notifyStop();
+  }
+
+  auto state_manager = createStateManager(dir, false);
+  std::unordered_map<std::string, std::string> stored;
+  REQUIRE(true == state_manager->get("component", stored));
+  REQUIRE(state == stored);
+  REQUIRE(false == state_manager->get("removed", stored));
+}
+
+TEST_CASE("RocksDbStateManagerAlwaysPersist", "[rocksdbstatemanager2]") {
+  TestController testController;
+  char format[] = "/tmp/state.XXXXXX";
+  std::string dir = testController.createTempDirectory(format);
+
+  auto state_manager = createStateManager(dir, true);
+  std::unordered_map<std::string, std::string> state;
+  for (int i = 0; i < 100; i++) {
+    state["position"] = std::to_string(i);
+    REQUIRE(true == state_manager->set("component", state));
+  }
+  REQUIRE(true == state_manager->persist());
+
+  std::unordered_map<std::string, std::string> stored;
+  REQUIRE(true == state_manager->get("component", stored));
+  REQUIRE("99" == stored["position"]);
+  REQUIRE(true == state_manager->clear("component"));
+  REQUIRE(false == state_manager->get("component", stored));
+}
+
+TEST_CASE("RocksDbStateManagerWritesEveryUpdateThrough", "[rocksdbstatemanager3]") {
+  TestController testController;
+  char format[] = "/tmp/state.XXXXXX";
+  std::string dir = testController.createTempDirectory(format);
+
+  auto state_manager = createStateManager(dir, false);
+  std::unordered_map<std::string, std::string> state;
+  state["position"] = "42";
+  REQUIRE(true == state_manager->set("component", state));
+
+  // without waiting for the periodic sync, the update is already in the database files
+  rocksdb::DB *database = nullptr;
+  REQUIRE(rocksdb::DB::OpenForReadOnly(rocksdb::Options(), dir, &database).ok());
+  std::unique_ptr<rocksdb::DB> stored_database(database);
+  std::string value;
+  REQUIRE(stored_database->Get(rocksdb::ReadOptions(), "component", &value).ok());
+  REQUIRE(false == value.empty());
+}
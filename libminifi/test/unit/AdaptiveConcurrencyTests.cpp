@@ -0,0 +1,72 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../TestBase.h"
+#include "AdaptiveConcurrency.h"
+
+TEST_CASE("AdaptiveConcurrencyGrowsWithBacklog", "[adaptive1]") {
+  minifi::AdaptiveConcurrency concurrency("processor", 1, 4, 1000);
+  concurrency.workerStarted();
+  concurrency.recordLatency(10);
+
+  // 500 flow files at 10 ms each cannot be drained by one worker within a second
+  REQUIRE(minifi::AdaptiveConcurrency::GROW == concurrency.evaluate(500, true, true));
+  REQUIRE(2 == concurrency.getActiveWorkers());
+  REQUIRE(minifi::AdaptiveConcurrency::GROW == concurrency.evaluate(500, true, true));
+  REQUIRE(minifi::AdaptiveConcurrency::GROW == concurrency.evaluate(500, true, true));
+  REQUIRE(4 == concurrency.getActiveWorkers());
+  // bounded by max concurrent tasks
+  REQUIRE(minifi::AdaptiveConcurrency::HOLD == concurrency.evaluate(500, true, true));
+  REQUIRE(3 == concurrency.getGrowCount());
+}
+
+TEST_CASE("AdaptiveConcurrencyRespectsLimits", "[adaptive2]") {
+  minifi::AdaptiveConcurrency concurrency("processor", 1, 4, 1000);
+  concurrency.workerStarted();
+  concurrency.recordLatency(10);
+
+  // thread management or a saturated host prevents growth
+  REQUIRE(minifi::AdaptiveConcurrency::HOLD == concurrency.evaluate(500, true, false));
+  REQUIRE(minifi::AdaptiveConcurrency::HOLD == concurrency.evaluate(500, false, true));
+  REQUIRE(1 == concurrency.getActiveWorkers());
+}
+
+TEST_CASE("AdaptiveConcurrencyShrinksWhenIdle", "[adaptive3]") {
+  minifi::AdaptiveConcurrency concurrency("processor", 1, 4, 1000);
+  concurrency.workerStarted();
+  concurrency.workerStarted();
+  concurrency.recordLatency(10);
+
+  // a single empty evaluation is not enough to shrink
+  REQUIRE(minifi::AdaptiveConcurrency::HOLD == concurrency.evaluate(0, true, true));
+  REQUIRE(minifi::AdaptiveConcurrency::SHRINK == concurrency.evaluate(0, true, true));
+  // never below the minimum
+  REQUIRE(minifi::AdaptiveConcurrency::HOLD == concurrency.evaluate(0, true, true));
+
+  REQUIRE(true == concurrency.retire());
+  REQUIRE(false == concurrency.retire());
+  REQUIRE(1 == concurrency.getActiveWorkers());
+  REQUIRE(1 == concurrency.getShrinkCount());
+}
+
+TEST_CASE("AdaptiveConcurrencyEvaluatesOncePerPeriod", "[adaptive4]") {
+  minifi::AdaptiveConcurrency concurrency("processor", 1, 4, 1000);
+  REQUIRE(true == concurrency.shouldEvaluate(5000));
+  REQUIRE(false == concurrency.shouldEvaluate(5500));
+  REQUIRE(true == concurrency.shouldEvaluate(6000));
+}
@@ -0,0 +1,202 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TestBase.h"
+#include "MockClasses.h"
+#include "ProvenanceTestHelper.h"
+#include "Connection.h"
+#include "FlowFileRecord.h"
+#include "TimerDrivenSchedulingAgent.h"
+#include "core/repository/VolatileContentRepository.h"
+
+struct BackPressureFixture {
+  BackPressureFixture()
+      : repo(std::make_shared<TestRepository>()),
+        content_repo(std::make_shared<core::repository::VolatileContentRepository>()),
+        processor(std::make_shared<MockProcessor>("producer")),
+        connection(std::make_shared<minifi::Connection>(repo, content_repo, "outgoing")) {
+    utils::Identifier uuid;
+    processor->getUUID(uuid);
+    connection->setSourceUUID(uuid);
+    connection->addRelationship(core::Relationship("success", "description"));
+    connection->setMaxQueueSize(10);
+    processor->addConnection(connection);
+  }
+
+  void put(int count) {
+    std::map<std::string, std::string> attributes;
+    for (int i = 0; i < count; i++) {
+      std::shared_ptr<core::FlowFile> flow_file = std::make_shared<minifi::FlowFileRecord>(repo, content_repo, attributes);
+      connection->put(flow_file);
+    }
+  }
+
+  void poll(int count) {
+    std::set<std::shared_ptr<core::FlowFile>> expired;
+    for (int i = 0; i < count; i++) {
+      connection->poll(expired);
+    }
+  }
+
+  std::shared_ptr<core::Repository> repo;
+  std::shared_ptr<core::ContentRepository> content_repo;
+  std::shared_ptr<core::Processor> processor;
+  std::shared_ptr<minifi::Connection> connection;
+};
+
+TEST_CASE("ConnectionFillLevel", "[backpressure1]") {
+  BackPressureFixture fixture;
+  REQUIRE(0 == fixture.connection->getFillLevel());
+  fixture.put(5);
+  REQUIRE(500 == fixture.connection->getFillLevel());
+  REQUIRE(500 == fixture.processor->getOutgoingFillLevel());
+  REQUIRE(false == fixture.connection->isFull());
+  fixture.put(5);
+  REQUIRE(true == fixture.connection->isFull());
+  REQUIRE(true == fixture.processor->flowFilesOutGoingFull());
+
+  // without thresholds there is no back pressure
+  fixture.connection->setMaxQueueSize(0);
+  REQUIRE(0 == fixture.connection->getFillLevel());
+  fixture.poll(10);
+  REQUIRE(0 == fixture.connection->getQueueSize());
+}
+
+TEST_CASE("BackPressureHysteresis", "[backpressure2]") {
+  BackPressureFixture fixture;
+  std::shared_ptr<minifi::Configure> configure = std::make_shared<minifi::Configure>();
+  configure->set(minifi::Configure::nifi_flow_engine_backpressure_low_watermark, "50");
+  minifi::TimerDrivenSchedulingAgent agent(nullptr, fixture.repo, fixture.repo, fixture.content_repo, configure);
+  fixture.processor->setYieldPeriodMsec(1000);
+
+  fixture.put(4);
+  REQUIRE(false == agent.hasTooMuchOutGoing(fixture.processor));
+  REQUIRE(false == fixture.processor->isYield());
+
+  // above the low watermark the processor runs, but yields in proportion to the fill level
+  fixture.put(3);
+  REQUIRE(false == agent.hasTooMuchOutGoing(fixture.processor));
+  REQUIRE(true == fixture.processor->isYield());
+  REQUIRE(fixture.processor->getYieldTime() <= 400);
+  fixture.processor->clearYield();
+
+  fixture.put(3);
+  REQUIRE(true == agent.hasTooMuchOutGoing(fixture.processor));
+  REQUIRE(true == fixture.processor->isBackPressured());
+
+  // no longer full, but still held until the low watermark
+  fixture.poll(3);
+  REQUIRE(true == agent.hasTooMuchOutGoing(fixture.processor));
+  fixture.poll(2);
+  REQUIRE(false == agent.hasTooMuchOutGoing(fixture.processor));
+  REQUIRE(false == fixture.processor->isBackPressured());
+}
+
+TEST_CASE("BackPressureDefaultsToThreshold", "[backpressure4]") {
+  BackPressureFixture fixture;
+  minifi::TimerDrivenSchedulingAgent agent(nullptr, fixture.repo, fixture.repo, fixture.content_repo, std::make_shared<minifi::Configure>());
+  fixture.processor->setYieldPeriodMsec(1000);
+
+  // without a low watermark a filling connection does not slow the processor down
+  fixture.put(9);
+  REQUIRE(false == agent.hasTooMuchOutGoing(fixture.processor));
+  REQUIRE(false == fixture.processor->isYield());
+
+  fixture.put(1);
+  REQUIRE(true == agent.hasTooMuchOutGoing(fixture.processor));
+  REQUIRE(true == agent.hasTooMuchOutGoing(fixture.processor));
+
+  // runs again as soon as the connection is no longer full
+  fixture.poll(1);
+  REQUIRE(false == agent.hasTooMuchOutGoing(fixture.processor));
+  REQUIRE(false == fixture.processor->isYield());
+}
+
+TEST_CASE("BackPressureOverloadBenchmark", "[backpressure3][.][benchmark]") {
+  // a producer running as fast as back pressure allows into a consumer taking one flow file per ms
+  auto runOverload = [](const std::string &low_watermark) {
+    BackPressureFixture fixture;
+    fixture.connection->setMaxQueueSize(100);
+    fixture.processor->setYieldPeriodMsec(20);
+    std::shared_ptr<minifi::Configure> configure = std::make_shared<minifi::Configure>();
+    configure->set(minifi::Configure::nifi_flow_engine_backpressure_low_watermark, low_watermark);
+    minifi::TimerDrivenSchedulingAgent agent(nullptr, fixture.repo, fixture.repo, fixture.content_repo, configure);
+
+    std::atomic<bool> running(true);
+    std::vector<uint64_t> gaps;
+    std::thread producer([&]() {
+      auto last_put = std::chrono::steady_clock::now();
+      while (running) {
+        if (fixture.processor->isYield()) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(fixture.processor->getYieldTime()));
+        } else if (agent.hasTooMuchOutGoing(fixture.processor)) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        } else {
+          fixture.put(1);
+          auto now = std::chrono::steady_clock::now();
+          gaps.push_back(std::chrono::duration_cast<std::chrono::microseconds>(now - last_put).count());
+          last_put = now;
+        }
+      }
+    });
+
+    std::vector<uint64_t> latencies;
+    std::set<std::shared_ptr<core::FlowFile>> expired;
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(1000);
+    while (std::chrono::steady_clock::now() < end) {
+      auto flow_file = fixture.connection->poll(expired);
+      if (flow_file) {
+        latencies.push_back(getTimeMillis() - flow_file->getEntryDate());
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    running = false;
+    producer.join();
+
+    auto stddev = [](const std::vector<uint64_t> &values, double &mean) {
+      mean = 0;
+      for (auto value : values) {
+        mean += value;
+      }
+      mean /= values.empty() ? 1 : values.size();
+      double variance = 0;
+      for (auto value : values) {
+        variance += (value - mean) * (value - mean);
+      }
+      return std::sqrt(variance / (values.empty() ? 1 : values.size()));
+    };
+    double latency_mean, gap_mean;
+    const double latency_stddev = stddev(latencies, latency_mean);
+    const double gap_stddev = stddev(gaps, gap_mean);
+    std::cout << "low watermark " << low_watermark << "%: " << latencies.size() << " flow files/s, latency mean " << latency_mean << " ms, stddev " << latency_stddev
+              << " ms, producer gap mean " << gap_mean << " us, stddev " << gap_stddev << " us" << std::endl;
+    return latencies.size();
+  };
+
+  REQUIRE(0 < runOverload("100"));
+  REQUIRE(0 < runOverload("80"));
+}
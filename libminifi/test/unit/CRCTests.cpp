@@ -16,10 +16,15 @@
  * limitations under the License.
  */
 
+#include <zlib.h>
+#include <chrono>
+#include <iostream>
+#include <random>
 #include <string>
 #include <vector>
 #include "io/CRCStream.h"
 #include "io/DataStream.h"
+#include "utils/CRC32.h"
 #include "../TestBase.h"
 
 TEST_CASE("Test CRC1", "[testcrc1]") {
@@ -61,3 +66,76 @@ TEST_CASE("Test CRC5", "[testcrc5]") {
   test.write(number);
   REQUIRE(3753740124 == test.getCRC());
 }
+
+TEST_CASE("Test CRC matches zlib", "[testcrc6]") {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::vector<uint8_t> data(64 * 1024 + 64);
+  for (auto &b : data) {
+    b = static_cast<uint8_t>(byte(gen));
+  }
+  // every length around the block sizes of the folding, at every alignment
+  for (size_t offset = 0; offset < 16; offset++) {
+    for (size_t length = 0; length < 300; length++) {
+      const uint32_t expected = static_cast<uint32_t>(crc32(0L, data.data() + offset, length));
+      REQUIRE(expected == utils::CRC32::update(0, data.data() + offset, length));
+      REQUIRE(expected == utils::CRC32::updatePortable(0, data.data() + offset, length));
+    }
+  }
+  // continued over random chunks
+  std::uniform_int_distribution<size_t> chunk(0, 5000);
+  uint32_t expected = static_cast<uint32_t>(crc32(0L, Z_NULL, 0));
+  uint32_t crc = 0;
+  size_t position = 0;
+  while (position < data.size()) {
+    const size_t length = std::min(chunk(gen), data.size() - position);
+    expected = static_cast<uint32_t>(crc32(expected, data.data() + position, length));
+    crc = utils::CRC32::update(crc, data.data() + position, length);
+    REQUIRE(expected == crc);
+    position += length;
+  }
+}
+
+TEST_CASE("Test CRC stream matches zlib", "[testcrc7]") {
+  std::vector<uint8_t> data(100000);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<uint8_t>(i * 31 + (i >> 8));
+  }
+  org::apache::nifi::minifi::io::BaseStream base;
+  org::apache::nifi::minifi::io::CRCStream<org::apache::nifi::minifi::io::BaseStream> test(&base);
+  test.writeData(data.data(), 777);
+  test.writeData(data.data() + 777, static_cast<int>(data.size() - 777));
+  REQUIRE(crc32(0L, data.data(), data.size()) == test.getCRC());
+  test.reset();
+  REQUIRE(0U == test.getCRC());
+}
+
+TEST_CASE("Test CRC benchmark", "[testcrc8][.][benchmark]") {
+  std::vector<uint8_t> data(16 * 1024 * 1024);
+  for (size_t i = 0; i < data.size(); i++) {
+    data[i] = static_cast<uint8_t>(i ^ (i >> 11));
+  }
+  const int rounds = 8;
+  for (size_t block : {64, 1024, 65536}) {
+    auto start = std::chrono::steady_clock::now();
+    uLong zlib_crc = 0;
+    for (int round = 0; round < rounds; round++) {
+      for (size_t position = 0; position < data.size(); position += block) {
+        zlib_crc = crc32(zlib_crc, data.data() + position, block);
+      }
+    }
+    const double zlib_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    uint32_t crc = 0;
+    for (int round = 0; round < rounds; round++) {
+      for (size_t position = 0; position < data.size(); position += block) {
+        crc = utils::CRC32::update(crc, data.data() + position, block);
+      }
+    }
+    const double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    REQUIRE(zlib_crc == crc);
+    const double megabytes = rounds * data.size() / (1024.0 * 1024.0);
+    std::cout << block << " byte blocks: zlib " << megabytes / zlib_time << " MB/s, " << utils::CRC32::getImplementation() << " "
+              << megabytes / time << " MB/s" << std::endl;
+  }
+}
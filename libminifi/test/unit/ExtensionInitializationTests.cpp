@@ -0,0 +1,196 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TestBase.h"
+#include "core/ClassLoader.h"
+
+static int initializations = 0;
+
+class LazyComponent : public core::CoreComponent {
+ public:
+  explicit LazyComponent(const std::string &name, utils::Identifier uuid = utils::Identifier())
+      : core::CoreComponent(name, uuid) {
+  }
+};
+
+// stands in for an extension whose library takes a while to initialize
+class SlowInitializer : public core::ObjectFactoryInitializer {
+ public:
+  virtual bool initialize() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    initializations++;
+    return true;
+  }
+  virtual void deinitialize() {
+  }
+};
+
+class LazyTestFactory : public core::ObjectFactory {
+ public:
+  virtual std::string getName() {
+    return "LazyTestFactory";
+  }
+
+  virtual std::string getClassName() {
+    return "LazyTestFactory";
+  }
+
+  virtual std::vector<std::string> getClassNames() {
+    std::vector<std::string> class_names;
+    class_names.push_back("LazyComponent");
+    return class_names;
+  }
+
+  virtual std::unique_ptr<ObjectFactory> assign(const std::string &class_name) {
+    if (utils::StringUtils::equalsIgnoreCase(class_name, "LazyComponent")) {
+      return std::unique_ptr<ObjectFactory>(new core::DefautObjectFactory<LazyComponent>());
+    }
+    return nullptr;
+  }
+
+  virtual std::unique_ptr<core::ObjectFactoryInitializer> getInitializer() {
+    return std::unique_ptr<core::ObjectFactoryInitializer>(new SlowInitializer());
+  }
+};
+
+static core::ClassLoader *reentrant_loader = nullptr;
+
+class ReentrantComponent : public core::CoreComponent {
+ public:
+  explicit ReentrantComponent(const std::string &name, utils::Identifier uuid = utils::Identifier())
+      : core::CoreComponent(name, uuid) {
+  }
+};
+
+// instantiates a class of another extension while it initializes
+class ReentrantInitializer : public core::ObjectFactoryInitializer {
+ public:
+  virtual bool initialize() {
+    return nullptr != reentrant_loader->instantiate<LazyComponent>("LazyComponent", "dependency");
+  }
+  virtual void deinitialize() {
+  }
+};
+
+class ReentrantTestFactory : public core::ObjectFactory {
+ public:
+  virtual std::string getName() {
+    return "ReentrantTestFactory";
+  }
+
+  virtual std::string getClassName() {
+    return "ReentrantTestFactory";
+  }
+
+  virtual std::vector<std::string> getClassNames() {
+    std::vector<std::string> class_names;
+    class_names.push_back("ReentrantComponent");
+    return class_names;
+  }
+
+  virtual std::unique_ptr<ObjectFactory> assign(const std::string &class_name) {
+    if (utils::StringUtils::equalsIgnoreCase(class_name, "ReentrantComponent")) {
+      return std::unique_ptr<ObjectFactory>(new core::DefautObjectFactory<ReentrantComponent>());
+    }
+    return nullptr;
+  }
+
+  virtual std::unique_ptr<core::ObjectFactoryInitializer> getInitializer() {
+    return std::unique_ptr<core::ObjectFactoryInitializer>(new ReentrantInitializer());
+  }
+};
+
+extern "C" {
+DLL_EXPORT void *createLazyTestFactory(void) {
+  return new LazyTestFactory();
+}
+
+DLL_EXPORT void *createReentrantTestFactory(void) {
+  return new ReentrantTestFactory();
+}
+}
+
+TEST_CASE("ClassLoaderDefersInitializers", "[classloader1]") {
+  initializations = 0;
+  core::ClassLoader loader;
+  loader.setLazyInitialization(true);
+  REQUIRE(RESOURCE_SUCCESS == loader.registerResource("", "createLazyTestFactory"));
+  REQUIRE(0 == initializations);
+  REQUIRE(false == loader.isInitialized("LazyComponent"));
+
+  // describing the class must not initialize the extension
+  REQUIRE(nullptr != loader.instantiateWithoutInitializer<LazyComponent>("LazyComponent", "described"));
+  REQUIRE(0 == initializations);
+
+  REQUIRE(nullptr != loader.instantiate<LazyComponent>("LazyComponent", "first"));
+  REQUIRE(nullptr != loader.instantiate<LazyComponent>("LazyComponent", "second"));
+  REQUIRE(1 == initializations);
+  REQUIRE(true == loader.isInitialized("LazyComponent"));
+
+  // registering the extension again keeps the initializer that already ran
+  REQUIRE(RESOURCE_SUCCESS == loader.registerResource("", "createLazyTestFactory"));
+  REQUIRE(nullptr != loader.instantiate<LazyComponent>("LazyComponent", "third"));
+  REQUIRE(1 == initializations);
+}
+
+TEST_CASE("ClassLoaderEagerInitializers", "[classloader2]") {
+  initializations = 0;
+  core::ClassLoader loader;
+  REQUIRE(RESOURCE_SUCCESS == loader.registerResource("", "createLazyTestFactory"));
+  REQUIRE(1 == initializations);
+  REQUIRE(true == loader.isInitialized("LazyComponent"));
+}
+
+TEST_CASE("ClassLoaderDeferredInitializerInstantiates", "[classloader4]") {
+  initializations = 0;
+  core::ClassLoader loader;
+  loader.setLazyInitialization(true);
+  reentrant_loader = &loader;
+  REQUIRE(RESOURCE_SUCCESS == loader.registerResource("", "createLazyTestFactory"));
+  REQUIRE(RESOURCE_SUCCESS == loader.registerResource("", "createReentrantTestFactory"));
+
+  REQUIRE(nullptr != loader.instantiate<ReentrantComponent>("ReentrantComponent", "reentrant"));
+  REQUIRE(true == loader.isInitialized("ReentrantComponent"));
+  REQUIRE(true == loader.isInitialized("LazyComponent"));
+  REQUIRE(1 == initializations);
+  reentrant_loader = nullptr;
+}
+
+TEST_CASE("ClassLoaderStartupBenchmark", "[classloader3][.][benchmark]") {
+  const int extensions = 5;
+  auto registerAll = [&](bool lazy) {
+    core::ClassLoader loader;
+    loader.setLazyInitialization(lazy);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < extensions; i++) {
+      loader.registerResource("", "createLazyTestFactory");
+    }
+    // a flow using no extension classes is ready at this point
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  const auto eager_ms = registerAll(false);
+  const auto lazy_ms = registerAll(true);
+  std::cout << "registering " << extensions << " extensions took " << eager_ms << " ms eagerly and " << lazy_ms << " ms lazily" << std::endl;
+  REQUIRE(lazy_ms < eager_ms);
+}
@@ -0,0 +1,212 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../TestBase.h"
+#include "MockClasses.h"
+#include "ProvenanceTestHelper.h"
+#include "core/repository/FileSystemRepository.h"
+#include "utils/file/FileCopy.h"
+#include "utils/file/FileUtils.h"
+
+namespace FileCopy = org::apache::nifi::minifi::utils::file::FileCopy;
+using org::apache::nifi::minifi::utils::file::FileUtils;
+
+namespace {
+
+std::string readAll(const std::string &path) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+void writeFile(const std::string &path, const std::string &contents) {
+  std::ofstream file(path, std::ios::out | std::ios::binary);
+  file << contents;
+}
+
+double cpuSeconds() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+}  // namespace
+
+TEST_CASE("FileCopyWholeAndRange", "[filecopy1]") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  std::string dir = testController.createTempDirectory(format);
+  const std::string source = FileUtils::concat_path(dir, "source");
+  const std::string destination = FileUtils::concat_path(dir, "destination");
+  writeFile(source, "0123456789abcdef");
+  writeFile(destination, "previous contents which are longer");
+
+  FileCopy::Method method = FileCopy::Method::NONE;
+  REQUIRE(16 == FileCopy::copy(source, 0, -1, destination, &method));
+  REQUIRE("0123456789abcdef" == readAll(destination));
+  REQUIRE(FileCopy::Method::NONE != method);
+
+  REQUIRE(6 == FileCopy::copy(source, 4, 6, destination));
+  REQUIRE("456789" == readAll(destination));
+
+  // ranges past the end are cut at the end of the source
+  REQUIRE(6 == FileCopy::copy(source, 10, 100, destination));
+  REQUIRE("abcdef" == readAll(destination));
+
+  REQUIRE(0 == FileCopy::copy(source, 16, -1, destination));
+  REQUIRE("" == readAll(destination));
+}
+
+TEST_CASE("FileCopyFailures", "[filecopy2]") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  std::string dir = testController.createTempDirectory(format);
+  const std::string source = FileUtils::concat_path(dir, "source");
+  const std::string destination = FileUtils::concat_path(dir, "destination");
+  writeFile(source, "contents");
+
+  REQUIRE(-1 == FileCopy::copy(FileUtils::concat_path(dir, "missing"), 0, -1, destination));
+  REQUIRE(-1 == FileCopy::copy(source, 9, -1, destination));
+  std::ifstream removed(destination);
+  REQUIRE(false == removed.good());
+  REQUIRE(-1 == FileCopy::copy(source, 0, -1, FileUtils::concat_path(FileUtils::concat_path(dir, "missing"), "destination")));
+
+  REQUIRE(true == FileCopy::sameDevice(source, dir));
+  REQUIRE(true == FileCopy::sameDevice(source, destination));
+}
+
+TEST_CASE("FileCopyToOpenFile", "[filecopy4]") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  std::string dir = testController.createTempDirectory(format);
+  const std::string source = FileUtils::concat_path(dir, "source");
+  const std::string destination = FileUtils::concat_path(dir, "destination");
+  writeFile(source, "0123456789abcdef");
+
+  int fd = open(destination.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  REQUIRE(fd >= 0);
+  FileCopy::Method method = FileCopy::Method::NONE;
+  REQUIRE(16 == FileCopy::copy(source, 0, -1, fd, &method));
+  REQUIRE(FileCopy::Method::NONE != method);
+  // the second copy is appended at the position the first one left, so it cannot be a reflink
+  REQUIRE(4 == FileCopy::copy(source, 0, 4, fd, &method));
+  REQUIRE(FileCopy::Method::CLONE != method);
+  REQUIRE(-1 == FileCopy::copy(FileUtils::concat_path(dir, "missing"), 0, -1, fd));
+  REQUIRE(0 == close(fd));
+  REQUIRE("0123456789abcdef0123" == readAll(destination));
+}
+
+TEST_CASE("ImportMovesOnlyRegularFiles", "[filecopy5]") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  std::string dir = testController.createTempDirectory(format);
+  auto configuration = std::make_shared<minifi::Configure>();
+  configuration->set(minifi::Configure::nifi_dbcontent_repository_directory_default, FileUtils::concat_path(dir, "content"));
+  auto content_repo = std::make_shared<core::repository::FileSystemRepository>();
+  REQUIRE(content_repo->initialize(configuration));
+  auto repo = std::make_shared<TestRepository>();
+  auto node = std::make_shared<core::ProcessorNode>(std::make_shared<MockProcessor>("import"));
+  std::shared_ptr<core::controller::ControllerServiceProvider> controller_services_provider = nullptr;
+  auto context = std::make_shared<core::ProcessContext>(node, controller_services_provider, repo, repo, content_repo);
+  core::ProcessSession session(context);
+
+  // a link is copied, so the repository holds the content and the target stays
+  const std::string target = FileUtils::concat_path(dir, "target");
+  const std::string link = FileUtils::concat_path(dir, "link");
+  writeFile(target, "linked content");
+  REQUIRE(0 == symlink(target.c_str(), link.c_str()));
+  std::shared_ptr<core::FlowFile> linked = session.create();
+  session.import(link, linked, false);
+  struct stat claim_stat;
+  REQUIRE(0 == lstat(linked->getResourceClaim()->getContentFullPath().c_str(), &claim_stat));
+  REQUIRE(S_ISREG(claim_stat.st_mode));
+  REQUIRE("linked content" == readAll(linked->getResourceClaim()->getContentFullPath()));
+  REQUIRE("linked content" == readAll(target));
+  struct stat link_stat;
+  REQUIRE(0 != lstat(link.c_str(), &link_stat));
+
+  const std::string regular = FileUtils::concat_path(dir, "regular");
+  writeFile(regular, "regular content");
+  std::shared_ptr<core::FlowFile> moved = session.create();
+  session.import(regular, moved, false);
+  REQUIRE("regular content" == readAll(moved->getResourceClaim()->getContentFullPath()));
+  std::ifstream removed(regular);
+  REQUIRE(false == removed.good());
+}
+
+TEST_CASE("FileCopyThroughputBenchmark", "[filecopy3][.][benchmark]") {
+  TestController testController;
+  char format[] = "/tmp/gt.XXXXXX";
+  std::string dir = testController.createTempDirectory(format);
+  const std::string source = FileUtils::concat_path(dir, "source");
+  const std::string destination = FileUtils::concat_path(dir, "destination");
+  const size_t size = 128 * 1024 * 1024;
+  {
+    std::ofstream file(source, std::ios::out | std::ios::binary);
+    std::vector<char> block(1024 * 1024);
+    for (size_t i = 0; i < block.size(); i++) {
+      block[i] = static_cast<char>(i * 31);
+    }
+    for (size_t written = 0; written < size; written += block.size()) {
+      file.write(block.data(), block.size());
+    }
+  }
+
+  auto report = [](const std::string &name, size_t size, const std::function<int64_t()> &copy) {
+    const double cpu_start = cpuSeconds();
+    auto start = std::chrono::steady_clock::now();
+    REQUIRE(static_cast<int64_t>(size) == copy());
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double gigabytes = size / (1024.0 * 1024.0 * 1024.0);
+    std::cout << name << ": " << gigabytes / elapsed << " GB/s, " << (cpuSeconds() - cpu_start) / gigabytes << " CPU s/GB" << std::endl;
+  };
+
+  report("stream copy", size, [&]() {
+    std::ifstream input(source, std::ios::in | std::ios::binary);
+    std::ofstream output(destination, std::ios::out | std::ios::binary | std::ios::trunc);
+    std::vector<char> buffer(64 * 1024);
+    int64_t copied = 0;
+    while (input.read(buffer.data(), buffer.size()) || input.gcount() > 0) {
+      output.write(buffer.data(), input.gcount());
+      copied += input.gcount();
+    }
+    return copied;
+  });
+  FileCopy::Method method = FileCopy::Method::NONE;
+  report("file copy", size, [&]() {
+    return FileCopy::copy(source, 0, -1, destination, &method);
+  });
+  std::cout << "file copy used " << FileCopy::methodName(method) << std::endl;
+  // a range cannot be cloned, so this measures the kernel copy
+  report("file copy of a range", size - 1, [&]() {
+    return FileCopy::copy(source, 1, -1, destination, &method);
+  });
+  std::cout << "file copy of a range used " << FileCopy::methodName(method) << std::endl;
+}
@@ -0,0 +1,228 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TestBase.h"
+#include "Connection.h"
+#include "ResourceClaim.h"
+#include "core/MemoryGovernor.h"
+#include "core/repository/VolatileContentRepository.h"
+#include "utils/file/FileUtils.h"
+
+namespace {
+
+/**
+ * Configures the governor with a limit relative to the resident size of the test. The resident
+ * size is not sampled again, so reservations are the only change in usage.
+ */
+uint64_t configureLimit(core::MemoryGovernor &governor, const std::function<uint64_t(uint64_t)> &limit_for_resident_size) {
+  auto configure = std::make_shared<minifi::Configure>();
+  configure->set(minifi::Configure::nifi_memory_sample_period, "60 min");
+  configure->set(minifi::Configure::nifi_memory_limit, std::to_string(1ULL << 40));
+  governor.configure(configure);
+  const uint64_t limit = limit_for_resident_size(governor.getResidentSize());
+  configure->set(minifi::Configure::nifi_memory_limit, std::to_string(limit));
+  governor.configure(configure);
+  return limit;
+}
+
+void disable(core::MemoryGovernor &governor) {
+  auto configure = std::make_shared<minifi::Configure>();
+  configure->set(minifi::Configure::nifi_memory_limit, "0");
+  governor.configure(configure);
+}
+
+/**
+ * Reclaimers run on the governor's thread, so the calls are collected under a lock.
+ */
+class ReclaimerCalls {
+ public:
+  std::function<void(uint64_t)> reclaimer() {
+    return [this](uint64_t excess) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      calls_.push_back(excess);
+    };
+  }
+
+  std::vector<uint64_t> get() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return calls_;
+  }
+
+  bool waitFor(size_t count) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (get().size() < count && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return get().size() >= count;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<uint64_t> calls_;
+};
+
+std::vector<std::string> listSpilled(const std::string &dir) {
+  std::vector<std::string> files;
+  for (const auto &file : utils::file::FileUtils::list_dir_all(dir, logging::LoggerFactory<core::MemoryGovernor>::getLogger(), false)) {
+    files.push_back(file.second);
+  }
+  return files;
+}
+
+}  // namespace
+
+TEST_CASE("MemoryGovernorReservations", "[memory1]") {
+  core::MemoryGovernor governor;
+  // the governor is only enabled by nifi.memory.limit
+  governor.configure(std::make_shared<minifi::Configure>());
+  REQUIRE(false == governor.isEnabled());
+  disable(governor);
+  REQUIRE(false == governor.isEnabled());
+  // without a limit reservations are only counted
+  REQUIRE(governor.tryReserve(1ULL << 40));
+  REQUIRE(false == governor.isUnderPressure());
+  REQUIRE(0 == governor.getFillLevel());
+  governor.release(1ULL << 40);
+  REQUIRE(0 == governor.getReserved());
+
+  const uint64_t limit = configureLimit(governor, [](uint64_t resident_size) {
+    return 2 * resident_size + 256 * 1024 * 1024;
+  });
+  REQUIRE(governor.isEnabled());
+  REQUIRE(limit / 100 * 70 == governor.getLowWatermark());
+  REQUIRE(limit / 100 * 90 == governor.getHighWatermark());
+  const uint64_t resident_size = governor.getResidentSize();
+  REQUIRE(resident_size > 0);
+  REQUIRE(resident_size == governor.getUsage());
+  REQUIRE(false == governor.isUnderPressure());
+  REQUIRE(governor.getFillLevel() < minifi::Connection::FILL_LEVEL_FULL);
+
+  const uint64_t to_low_watermark = governor.getLowWatermark() - resident_size;
+  REQUIRE(governor.tryReserve(to_low_watermark));
+  REQUIRE(false == governor.isUnderPressure());
+  REQUIRE(governor.tryReserve(1));
+  REQUIRE(true == governor.isUnderPressure());
+
+  // up to the high watermark, but not beyond
+  const uint64_t to_high_watermark = governor.getHighWatermark() - governor.getUsage();
+  REQUIRE(false == governor.tryReserve(to_high_watermark + 1));
+  REQUIRE(1 == governor.getRefusedCount());
+  REQUIRE(governor.getFillLevel() < minifi::Connection::FILL_LEVEL_FULL);
+  REQUIRE(governor.tryReserve(to_high_watermark));
+  REQUIRE(minifi::Connection::FILL_LEVEL_FULL == governor.getFillLevel());
+  REQUIRE(false == governor.tryReserve(1));
+
+  governor.release(to_low_watermark + 1 + to_high_watermark);
+  REQUIRE(0 == governor.getReserved());
+  REQUIRE(resident_size == governor.getUsage());
+  REQUIRE(false == governor.isUnderPressure());
+}
+
+TEST_CASE("MemoryGovernorReclaimers", "[memory2]") {
+  core::MemoryGovernor governor;
+  ReclaimerCalls calls;
+  const int id = governor.registerReclaimer(calls.reclaimer());
+
+  configureLimit(governor, [](uint64_t resident_size) {
+    return 2 * resident_size + 256 * 1024 * 1024;
+  });
+  REQUIRE(calls.get().empty());
+
+  // the resident size alone is above the low watermark
+  configureLimit(governor, [](uint64_t resident_size) {
+    return resident_size;
+  });
+  REQUIRE(true == governor.isUnderPressure());
+  REQUIRE(calls.waitFor(1));
+  REQUIRE(calls.get()[0] > 0);
+  REQUIRE(calls.get()[0] <= governor.getUsage() - governor.getLowWatermark() + 1024 * 1024);
+
+  // told once that the memory may be used again
+  disable(governor);
+  auto after_disable = calls.get();
+  REQUIRE(0 == after_disable.back());
+  REQUIRE(after_disable.end() - 1 == std::find(after_disable.begin(), after_disable.end(), 0));
+  disable(governor);
+  REQUIRE(after_disable.size() == calls.get().size());
+
+  governor.unregisterReclaimer(id);
+  configureLimit(governor, [](uint64_t resident_size) {
+    return resident_size;
+  });
+  disable(governor);
+  REQUIRE(after_disable.size() == calls.get().size());
+}
+
+TEST_CASE("VolatileContentSpillsUnderPressure", "[memory3]") {
+  TestController testController;
+  char format[] = "/tmp/spill.XXXXXX";
+  const std::string spill_dir = testController.createTempDirectory(format);
+  // left by an earlier run
+  std::ofstream(spill_dir + "/stale.spill") << "stale";
+
+  auto configure = std::make_shared<minifi::Configure>();
+  configure->set(std::string(minifi::Configure::nifi_volatile_repository_options) + "content.spill.directory", spill_dir);
+  auto content_repo = std::make_shared<core::repository::VolatileContentRepository>("content");
+  content_repo->initialize(configure);
+  REQUIRE(listSpilled(spill_dir).empty());
+
+  auto &governor = core::MemoryGovernor::getInstance();
+  configureLimit(governor, [](uint64_t resident_size) {
+    return resident_size;
+  });
+  REQUIRE(true == governor.isUnderPressure());
+
+  const std::string content = "spilled content";
+  auto spilled = std::make_shared<minifi::ResourceClaim>(content_repo);
+  {
+    auto stream = content_repo->write(spilled, false);
+    REQUIRE(nullptr != stream);
+    REQUIRE(static_cast<int>(content.size()) == stream->writeData(reinterpret_cast<uint8_t*>(const_cast<char*>(content.data())), content.size()));
+  }
+  REQUIRE(1 == listSpilled(spill_dir).size());
+  REQUIRE(content_repo->exists(spilled));
+  {
+    auto stream = content_repo->read(spilled);
+    REQUIRE(nullptr != stream);
+    std::vector<uint8_t> buffer(content.size());
+    REQUIRE(static_cast<int>(content.size()) == stream->readData(buffer, content.size()));
+    REQUIRE(content == std::string(buffer.begin(), buffer.end()));
+  }
+
+  // without pressure content stays in memory
+  disable(governor);
+  auto in_memory = std::make_shared<minifi::ResourceClaim>(content_repo);
+  REQUIRE(nullptr != content_repo->write(in_memory, false));
+  REQUIRE(1 == listSpilled(spill_dir).size());
+  // content spilled earlier stays on disk until it is removed
+  REQUIRE(content_repo->exists(spilled));
+
+  REQUIRE(content_repo->remove(spilled));
+  REQUIRE(listSpilled(spill_dir).empty());
+  REQUIRE(false == content_repo->exists(spilled));
+  content_repo->remove(in_memory);
+}
@@ -0,0 +1,103 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include "../TestBase.h"
+#include "core/Processor.h"
+#include "core/ProcessContext.h"
+#include "core/PropertySnapshot.h"
+#include "core/TypedValues.h"
+
+class SnapshotProcessor : public core::Processor {
+ public:
+  explicit SnapshotProcessor(const std::string &name)
+      : Processor(name) {
+  }
+
+  static core::Property Size;
+  static core::Property Period;
+  static core::Property Enabled;
+  static core::Property Label;
+  static core::Property Expression;
+
+  virtual void initialize() {
+    std::set<core::Property> properties;
+    properties.insert(Size);
+    properties.insert(Period);
+    properties.insert(Enabled);
+    properties.insert(Label);
+    properties.insert(Expression);
+    setSupportedProperties(properties);
+  }
+
+  virtual void onTrigger(core::ProcessContext *context, core::ProcessSession *session) {
+  }
+};
+
+core::Property SnapshotProcessor::Size(core::PropertyBuilder::createProperty("Size")->withDefaultValue<core::DataSizeValue>("1 kB")->build());
+core::Property SnapshotProcessor::Period(core::PropertyBuilder::createProperty("Period")->withDefaultValue<core::TimePeriodValue>("2 sec")->build());
+core::Property SnapshotProcessor::Enabled(core::PropertyBuilder::createProperty("Enabled")->withDefaultValue<bool>(false)->build());
+core::Property SnapshotProcessor::Label(core::PropertyBuilder::createProperty("Label")->build());
+core::Property SnapshotProcessor::Expression(core::PropertyBuilder::createProperty("Expression")->supportsExpressionLanguage(true)->withDefaultValue("value")->build());
+
+TEST_CASE("PropertySnapshotBindsTypedValues", "[snapshot1]") {
+  auto processor = std::make_shared<SnapshotProcessor>("snapshot");
+  processor->initialize();
+  processor->setProperty(SnapshotProcessor::Enabled, "true");
+  auto node = std::make_shared<core::ProcessorNode>(processor);
+  std::shared_ptr<core::controller::ControllerServiceProvider> provider = nullptr;
+  core::ProcessContext context(node, provider, nullptr, nullptr);
+
+  core::PropertySnapshot::Builder builder(context);
+  auto size = builder.bind<uint64_t>(SnapshotProcessor::Size);
+  auto period = builder.bind<std::chrono::milliseconds>(SnapshotProcessor::Period);
+  auto enabled = builder.bind<bool>(SnapshotProcessor::Enabled);
+  auto label = builder.bind<std::string>(SnapshotProcessor::Label, "unset");
+  auto snapshot = builder.build();
+
+  REQUIRE(4 == snapshot->size());
+  REQUIRE(1024 == snapshot->get(size));
+  REQUIRE(2000 == snapshot->get(period).count());
+  REQUIRE(true == snapshot->get(enabled));
+  REQUIRE(false == snapshot->isSet(label));
+  REQUIRE("unset" == snapshot->get(label));
+
+  // later changes do not affect a snapshot that has been taken
+  processor->setProperty(SnapshotProcessor::Enabled, "false");
+  REQUIRE(true == snapshot->get(enabled));
+}
+
+TEST_CASE("PropertySnapshotDefersExpressions", "[snapshot2]") {
+  auto processor = std::make_shared<SnapshotProcessor>("snapshot");
+  processor->initialize();
+  auto node = std::make_shared<core::ProcessorNode>(processor);
+  std::shared_ptr<core::controller::ControllerServiceProvider> provider = nullptr;
+  core::ProcessContext context(node, provider, nullptr, nullptr);
+
+  core::PropertySnapshot::Builder builder(context);
+  auto expression = builder.bind<std::string>(SnapshotProcessor::Expression);
+  auto snapshot = builder.build();
+
+  REQUIRE(true == expression.isExpression());
+  std::string value;
+  REQUIRE(true == snapshot->getProperty(context, expression, value));
+  REQUIRE("value" == value);
+}
@@ -0,0 +1,120 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TestBase.h"
+#include "FlowFileRecord.h"
+#include "ResourceClaim.h"
+#include "core/repository/VolatileContentRepository.h"
+
+TEST_CASE("ResourceClaimOwnedCount", "[claim1]") {
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::VolatileContentRepository>();
+  content_repo->initialize(std::make_shared<minifi::Configure>());
+
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  REQUIRE(0 == claim->getFlowFileRecordOwnedCount());
+  claim->increaseFlowFileRecordOwnedCount();
+  content_repo->incrementStreamCount(claim);
+  REQUIRE(2 == content_repo->getStreamCount(claim));
+  claim->decreaseFlowFileRecordOwnedCount();
+  claim->decreaseFlowFileRecordOwnedCount();
+  // never drops below zero
+  claim->decreaseFlowFileRecordOwnedCount();
+  REQUIRE(0 == claim->getFlowFileRecordOwnedCount());
+  REQUIRE(true == content_repo->removeIfOrphaned(claim));
+}
+
+TEST_CASE("ResourceClaimOwnedContentIsNotRemoved", "[claim2]") {
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::VolatileContentRepository>();
+  content_repo->initialize(std::make_shared<minifi::Configure>());
+
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  claim->increaseFlowFileRecordOwnedCount();
+  REQUIRE(false == content_repo->removeIfOrphaned(claim));
+
+  REQUIRE(true == claim->decreaseFlowFileRecordOwnedCount());
+  REQUIRE(true == content_repo->removeIfOrphaned(claim));
+  // the content is removed exactly once
+  REQUIRE(false == content_repo->removeIfOrphaned(claim));
+}
+
+TEST_CASE("ResourceClaimContention", "[claim3]") {
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::VolatileContentRepository>();
+  content_repo->initialize(std::make_shared<minifi::Configure>());
+
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+  claim->increaseFlowFileRecordOwnedCount();
+
+  // the owned count is only right if no concurrent increment or decrement got lost
+  const int thread_count = 8;
+  const int iterations = 1000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_count; i++) {
+    threads.emplace_back([&content_repo, &claim, iterations]() {
+      for (int j = 0; j < iterations; j++) {
+        // cloning a flow file takes a reference, dropping it releases the reference
+        std::shared_ptr<minifi::FlowFileRecord> clone = std::make_shared<minifi::FlowFileRecord>(nullptr, content_repo, std::map<std::string, std::string>(), claim);
+        clone = nullptr;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE(1 == claim->getFlowFileRecordOwnedCount());
+  REQUIRE(false == content_repo->removeIfOrphaned(claim));
+  claim->decreaseFlowFileRecordOwnedCount();
+  REQUIRE(true == content_repo->removeIfOrphaned(claim));
+}
+
+TEST_CASE("ResourceClaimOwnedAndReleasedRepeatedly", "[claim4]") {
+  std::shared_ptr<core::ContentRepository> content_repo = std::make_shared<core::repository::VolatileContentRepository>();
+  content_repo->initialize(std::make_shared<minifi::Configure>());
+
+  auto claim = std::make_shared<minifi::ResourceClaim>(content_repo);
+
+  // every owner goes through 0 -> 1 -> 0, and every drop to zero is reported to exactly one owner
+  const int thread_count = 8;
+  const int iterations = 1000;
+  std::atomic<int> released(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_count; i++) {
+    threads.emplace_back([&claim, &released, iterations]() {
+      for (int j = 0; j < iterations; j++) {
+        claim->increaseFlowFileRecordOwnedCount();
+        if (claim->decreaseFlowFileRecordOwnedCount()) {
+          released++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE(0 == claim->getFlowFileRecordOwnedCount());
+  REQUIRE(released > 0);
+  REQUIRE(released <= thread_count * iterations);
+  REQUIRE(true == content_repo->removeIfOrphaned(claim));
+}
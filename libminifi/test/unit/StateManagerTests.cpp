@@ -0,0 +1,61 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "../TestBase.h"
+#include "controllers/VolatileStateManagerService.h"
+
+TEST_CASE("StateManagerSerialization", "[statemanager1]") {
+  std::unordered_map<std::string, std::string> state;
+  state["position"] = "42";
+  state["path"] = "/var/log/\"quoted\"\n";
+  state[""] = "";
+
+  std::unordered_map<std::string, std::string> decoded;
+  REQUIRE(true == minifi::controllers::StateManagerService::deserialize(minifi::controllers::StateManagerService::serialize(state), decoded));
+  REQUIRE(state == decoded);
+
+  REQUIRE(false == minifi::controllers::StateManagerService::deserialize("not json", decoded));
+  REQUIRE(false == minifi::controllers::StateManagerService::deserialize("{\"position\": 42}", decoded));
+}
+
+TEST_CASE("VolatileStateManager", "[statemanager2]") {
+  auto state_manager = std::make_shared<minifi::controllers::VolatileStateManagerService>("statemanager");
+  state_manager->initialize();
+  state_manager->onEnable();
+
+  std::unordered_map<std::string, std::string> state;
+  REQUIRE(false == state_manager->get("component", state));
+
+  state["position"] = "42";
+  REQUIRE(true == state_manager->set("component", state));
+  state["position"] = "43";
+  REQUIRE(true == state_manager->set("other", state));
+
+  std::unordered_map<std::string, std::string> stored;
+  REQUIRE(true == state_manager->get("component", stored));
+  REQUIRE("42" == stored["position"]);
+  REQUIRE(true == state_manager->persist());
+
+  REQUIRE(true == state_manager->clear("component"));
+  REQUIRE(false == state_manager->get("component", stored));
+  REQUIRE(true == state_manager->get("other", stored));
+  REQUIRE("43" == stored["position"]);
+}
@@ -0,0 +1,111 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../TestBase.h"
+#include "utils/ThreadAffinity.h"
+#include "utils/ThreadPool.h"
+
+TEST_CASE("ThreadAffinityParsesCpuList", "[affinity1]") {
+  std::vector<int> expected = { 0, 1, 2, 3, 8 };
+  REQUIRE(expected == utils::ThreadAffinity::parseCpuList("0-3,8"));
+  REQUIRE(std::vector<int> { 5 } == utils::ThreadAffinity::parseCpuList(" 5 "));
+  REQUIRE(utils::ThreadAffinity::parseCpuList("3-1").empty());
+  REQUIRE(utils::ThreadAffinity::parseCpuList("a,b").empty());
+}
+
+TEST_CASE("ThreadAffinityNumaNodesCoverCpus", "[affinity2]") {
+  auto cpus = utils::ThreadAffinity::getAvailableCpus();
+  REQUIRE(false == cpus.empty());
+  size_t covered = 0;
+  for (const auto &node : utils::ThreadAffinity::getNumaNodes(cpus)) {
+    REQUIRE(false == node.empty());
+    covered += node.size();
+  }
+  REQUIRE(cpus.size() == covered);
+}
+
+TEST_CASE("ThreadAffinityPoolRecordsBusyTime", "[affinity3]") {
+  auto cpus = utils::ThreadAffinity::getAvailableCpus();
+  utils::ThreadPool<int> pool(2);
+  pool.setAffinity(std::vector<std::vector<int>> { cpus }, true);
+  pool.start();
+  REQUIRE(1 == pool.getAffinityGroupCount());
+
+  std::function<int()> f_ex = []() {
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20)) {
+    }
+    return 1;
+  };
+  utils::Worker<int> functor(f_ex, "id");
+  functor.setAffinityGroup(0);
+  std::future<int> fut;
+  pool.execute(std::move(functor), fut);
+  REQUIRE(1 == fut.get());
+
+  // busy time is recorded once the task returns, which may be after the future is satisfied
+  uint64_t busy = 0;
+  for (int i = 0; i < 100 && busy == 0; i++) {
+    for (const auto &cpu : pool.getCpuBusyTime()) {
+      busy += cpu.second;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  REQUIRE(busy > 0);
+  pool.shutdown();
+}
+
+TEST_CASE("ThreadAffinityPoolAttributesBusyTimePerTask", "[affinity4]") {
+  auto cpus = utils::ThreadAffinity::getAvailableCpus();
+  if (cpus.size() < 2) {
+    return;
+  }
+  // a single thread that follows the tasks from the first to the last CPU
+  utils::ThreadPool<int> pool(1);
+  pool.setAffinity(std::vector<std::vector<int>> { { cpus.front() }, { cpus.back() } }, true);
+  pool.start();
+
+  std::function<int()> f_ex = []() {
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20)) {
+    }
+    return 1;
+  };
+  for (int group : { 0, 1 }) {
+    utils::Worker<int> functor(f_ex, "id" + std::to_string(group));
+    functor.setAffinityGroup(group);
+    std::future<int> fut;
+    pool.execute(std::move(functor), fut);
+    REQUIRE(1 == fut.get());
+  }
+
+  // each CPU keeps the time of the task that ran on it
+  std::map<int, uint64_t> busy;
+  for (int i = 0; i < 100 && busy.size() < 2; i++) {
+    busy = pool.getCpuBusyTime();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  REQUIRE(busy[cpus.front()] >= 20000000U);
+  REQUIRE(busy[cpus.back()] >= 20000000U);
+  pool.shutdown();
+}
@@ -110,9 +110,6 @@ int main(int argc, char **argv) {
 
 	uint16_t stop_wait_time = STOP_WAIT_TIME_MS;
 
-	// initialize static functions that were defined apriori
-	core::FlowConfiguration::initialize_static_functions();
-
 	std::string graceful_shutdown_seconds = "";
 	std::string prov_repo_class = "provenancerepository";
 	std::string flow_repo_class = "flowfilerepository";
@@ -234,6 +231,16 @@ int main(int argc, char **argv) {
 	configure->setHome(minifiHome);
 	configure->loadConfigureFile(DEFAULT_NIFI_PROPERTIES_FILE);
 
+	// when enabled, extensions initialize their libraries when the flow first uses one of their classes
+	std::string lazy_initialization = "false";
+	bool lazy = false;
+	configure->get(minifi::Configure::nifi_extension_lazy_initialization, lazy_initialization);
+	utils::StringUtils::StringToBool(lazy_initialization, lazy);
+	core::ClassLoader::getDefaultClassLoader().setLazyInitialization(lazy);
+
+	// initialize static functions that were defined apriori
+	core::FlowConfiguration::initialize_static_functions();
+
 
 	if (configure->get(minifi::Configure::nifi_graceful_shutdown_seconds, graceful_shutdown_seconds)) {
 		try {
@@ -46,37 +46,21 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    setup_signal_action();
-    nifi_proc_params params = setup_nifi_processor(&input_params, "LogAggregator", on_trigger_logaggregator);
+    char delim;
+    if (parse_delimiter(input_params.delimiter, &delim) != 0) {
+        printf("Delimiter not specified or it is empty\n");
+        return 1;
+    }
 
-    set_standalone_property(params.processor, "file_path", input_params.file);
-    set_standalone_property(params.processor, "delimiter", input_params.delimiter);
+    setup_signal_action();
 
     struct CRawSiteToSiteClient * client = createClient(input_params.instance, port_num, input_params.nifi_port_uuid);
 
-    char uuid_str[37];
-    get_proc_uuid_from_processor(params.processor, uuid_str);
-
-    while (!stopped) {
-        flow_file_record * new_ff = invoke(params.processor);
-        struct processor_params * pp = NULL;
-        HASH_FIND_STR(procparams, uuid_str, pp);
-        if (pp) {
-            transmit_payload(client, pp->ff_list, 0);
-            delete_all_flow_files_from_proc(uuid_str);
-        }
-        free_flowfile(new_ff);
-        sleep(intrvl);
-    }
+    tail_and_transmit(input_params.file, delim, 0, intrvl * 1000, client);
 
-    printf("log aggregator processor stopped\n");
+    printf("log aggregator stopped\n");
     if (client) {
         destroyClient(client);
     }
-    clear_content_repo(params.instance);
-    delete_all_flow_files_from_proc(uuid_str);
-    free_standalone_processor(params.processor);
-    free_instance(params.instance);
-    free_proc_params(uuid_str);
     return 0;
 }
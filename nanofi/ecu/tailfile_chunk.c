@@ -41,37 +41,22 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    setup_signal_action();
-    nifi_proc_params params = setup_nifi_processor(&input_params, "TailFileChunk", on_trigger_tailfilechunk);
+    errno = 0;
+    uint64_t chunk_size = strtoul(input_params.chunk_size, NULL, 10);
+    if (errno != 0 || chunk_size == 0) {
+        printf("Invalid chunk size specified\n");
+        return 1;
+    }
 
-    set_standalone_property(params.processor, "file_path", input_params.file);
-    set_standalone_property(params.processor, "chunk_size", input_params.chunk_size);
+    setup_signal_action();
 
     struct CRawSiteToSiteClient * client = createClient(input_params.instance, port_num, input_params.nifi_port_uuid);
 
-    char uuid_str[37];
-    get_proc_uuid_from_processor(params.processor, uuid_str);
-
-    while (!stopped) {
-        flow_file_record * new_ff = invoke(params.processor);
-        struct processor_params * pp = NULL;
-        HASH_FIND_STR(procparams, uuid_str, pp);
-        if (pp) {
-            transmit_payload(client, pp->ff_list, 0);
-            delete_all_flow_files_from_proc(uuid_str);
-        }
-        free_flowfile(new_ff);
-        sleep(intrvl);
-    }
+    tail_and_transmit(input_params.file, 0, chunk_size, intrvl * 1000, client);
 
-    printf("processor stopped\n");
+    printf("tailfile chunk stopped\n");
     if (client) {
         destroyClient(client);
     }
-    clear_content_repo(params.instance);
-    delete_all_flow_files_from_proc(uuid_str);
-    free_standalone_processor(params.processor);
-    free_instance(params.instance);
-    free_proc_params(uuid_str);
     return 0;
 }
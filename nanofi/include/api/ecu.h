@@ -21,6 +21,7 @@
 
 #include <signal.h>
 #include "api/nanofi.h"
+#include "core/file_tailer.h"
 #include "uthash.h"
 #include "utlist.h"
 
@@ -60,6 +61,26 @@ typedef struct nifi_proc_params {
     standalone_processor * processor;
 } nifi_proc_params;
 
+struct CRawSiteToSiteClient;
+
+/**
+ * Collects tailed tokens so that they are sent in one Site-to-Site
+ * transaction. All storage is allocated up front; the payloads point into
+ * the tailer's buffer, so a batch must be flushed before the tailer is
+ * called again.
+ */
+typedef struct payload_batch {
+    struct CRawSiteToSiteClient * client;
+    const char * file_path;
+    const char ** payloads;
+    uint64_t * sizes;
+    attribute_set * attribute_sets;
+    attribute * attributes;
+    char (* offsets)[21];
+    size_t count;
+    size_t capacity;
+} payload_batch;
+
 /**
  * Tails a delimited file starting from an offset up to the end of file
  * @param file the path to the file to tail
@@ -84,10 +105,45 @@ tailfile_input_params init_logaggregate_input(char ** args);
 tailfile_input_params init_tailfile_chunk_input(char ** args);
 
 int validate_input_params(tailfile_input_params * params, uint64_t * intrvl, uint64_t * port_num);
+
+/**
+ * Converts a delimiter argument, which may be an escape such as \n, to a character
+ * @return 0 if successful, -1 if the delimiter is empty
+ */
+int parse_delimiter(const char * delimiter, char * delim);
 void setup_signal_action();
 nifi_proc_params setup_nifi_processor(tailfile_input_params * input_params, const char * processor_name, void(*callback)(processor_session *, processor_context *));
 void free_proc_params(const char * uuid);
 
+/**
+ * Allocates a batch for up to capacity payloads
+ * @param batch the batch to initialize
+ * @param client the client the batch is sent with
+ * @param file_path the tailed file, sent as the "tailfile path" attribute
+ * @param capacity the number of payloads sent per transaction
+ */
+void init_payload_batch(payload_batch * batch, struct CRawSiteToSiteClient * client, const char * file_path, size_t capacity);
+
+/**
+ * A tailer_callback that adds a token to the payload_batch given as user,
+ * sending the batch first when it is full
+ */
+void add_to_payload_batch(const char * data, size_t len, uint64_t offset, void * user);
+
+/**
+ * Sends the collected payloads in a single transaction and empties the batch
+ * @return 0 if the transaction succeeded or there was nothing to send
+ */
+int flush_payload_batch(payload_batch * batch);
+void free_payload_batch(payload_batch * batch);
+
+/**
+ * Tails the file until stopped, sending delimited tokens (chunk_size == 0)
+ * or fixed size chunks in batched transactions. Between reads it sleeps
+ * until the file changes or interval_ms elapses.
+ */
+void tail_and_transmit(const char * file_path, char delim, uint64_t chunk_size, uint64_t interval_ms, struct CRawSiteToSiteClient * client);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,118 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NANOFI_INCLUDE_CORE_FILE_TAILER_H_
+#define NANOFI_INCLUDE_CORE_FILE_TAILER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Keeps a file open between reads and hands out its content in place.
+ *
+ * Data is read into a buffer that is allocated once and reused; complete
+ * tokens are passed to a callback without being copied, while a partial
+ * trailing token is moved to the front of the buffer until the rest of it
+ * arrives. The file is identified by device and inode so that a rotated
+ * file is drained before its replacement is opened, and a truncated file
+ * is read again from the beginning.
+ */
+typedef struct file_tailer {
+    char * file_path;
+    int fd;
+    dev_t device;
+    ino_t inode;
+    uint64_t offset; /**< file offset of the first byte that has not been handed out */
+    int notify_fd;
+    int file_watch;
+    int dir_watch;
+    char * buffer;
+    size_t capacity;
+    size_t begin;
+    size_t end;
+} file_tailer;
+
+/**
+ * Receives a token tailed from the file
+ * @param data the token, valid until the next call on the tailer. Delimited
+ * tokens are NUL terminated in place of their delimiter, chunks are not.
+ * @param len the length of the token
+ * @param offset the file offset just past the token and its delimiter
+ * @param user the pointer given to the tailing function
+ */
+typedef void (*tailer_callback)(const char * data, size_t len, uint64_t offset, void * user);
+
+/**
+ * Opens a file for tailing from its beginning
+ * @param tailer the tailer to initialize
+ * @param file_path the path to the file to tail
+ * @param capacity the size of the read buffer, which bounds the longest token
+ * @return 0 if successful else -1
+ */
+int init_file_tailer(file_tailer * tailer, const char * file_path, size_t capacity);
+
+/**
+ * Closes the file and releases the buffer
+ * @param tailer the tailer to free
+ */
+void free_file_tailer(file_tailer * tailer);
+
+/**
+ * Reads newly appended data and hands out every complete delimited token.
+ * Empty tokens are skipped and a token longer than the buffer is handed out
+ * in buffer sized pieces.
+ * @param tailer the tailer
+ * @param delim the delimiter character
+ * @param callback invoked for each token
+ * @param user passed to the callback
+ * @return 1 if data was consumed and the call should be repeated, 0 if the
+ * end of the file was reached, -1 on error
+ */
+int tail_delimited(file_tailer * tailer, char delim, tailer_callback callback, void * user);
+
+/**
+ * Reads newly appended data and hands out every complete chunk. A trailing
+ * chunk is held back until it is complete.
+ * @param tailer the tailer
+ * @param chunk_size the size of each chunk, at most the capacity of the tailer
+ * @param callback invoked for each chunk
+ * @param user passed to the callback
+ * @return 1 if data was consumed and the call should be repeated, 0 if the
+ * end of the file was reached, -1 on error
+ */
+int tail_chunks(file_tailer * tailer, size_t chunk_size, tailer_callback callback, void * user);
+
+/**
+ * Blocks until the file is written to, created or renamed into place, or
+ * the timeout expires. Without inotify support this simply sleeps.
+ * @param tailer the tailer
+ * @param timeout_ms the longest time to wait in milliseconds
+ * @return 1 if the file changed, 0 on timeout or interruption, -1 on error
+ */
+int wait_for_file_change(file_tailer * tailer, uint64_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NANOFI_INCLUDE_CORE_FILE_TAILER_H_ */
@@ -73,6 +73,16 @@ int confirm(struct CRawSiteToSiteClient * client, const char * transactionID);
 
 int transmitPayload(struct CRawSiteToSiteClient * client, const char * payload, const attribute_set * attributes);
 
+/**
+ * Sends several payloads in a single transaction
+ * @param payloads the payloads to send, which need not be NUL terminated
+ * @param sizes the size of each payload
+ * @param attributes the attributes of each payload, or NULL to send none
+ * @param count the number of payloads
+ * @return 0 if the transaction was completed
+ */
+int transmitPayloads(struct CRawSiteToSiteClient * client, const char * const * payloads, const uint64_t * sizes, const attribute_set * attributes, size_t count);
+
 int16_t sendPacket(struct CRawSiteToSiteClient * client, const char * transactionID, CDataPacket *packet, flow_file_record * ff);
 
 CTransaction* createTransaction(struct CRawSiteToSiteClient * client, TransferDirection direction);
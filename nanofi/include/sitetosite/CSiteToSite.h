@@ -18,12 +18,12 @@
 #ifndef LIBMINIFI_INCLUDE_CORE_CSITETOSITE_CSITETOSITE_H_
 #define LIBMINIFI_INCLUDE_CORE_CSITETOSITE_CSITETOSITE_H_
 
-#include <zlib.h>
 #include <string.h>
 #include "uthash.h"
 #include "CPeer.h"
 #include "core/cstream.h"
 #include "core/cuuid.h"
+#include "core/crc.h"
 
 #ifdef WIN32
 #include <winsock2.h>
@@ -319,19 +319,23 @@ static const char * getUUIDStr(const CTransaction * transation) {
 }
 
 static void updateCRC(CTransaction * transaction, const uint8_t *buffer, uint32_t length) {
-  transaction->_crc = crc32(transaction->_crc, buffer, length);
+  transaction->_crc = update_crc32((uint32_t)transaction->_crc, buffer, length);
 }
 
 static int writeData(CTransaction * transaction, const uint8_t *value, int size) {
   int ret = write_buffer(value, size, transaction->_stream);
-  transaction->_crc = crc32(transaction->_crc, value, size);
+  if (size > 0) {
+    transaction->_crc = update_crc32((uint32_t)transaction->_crc, value, size);
+  }
   return ret;
 }
 
 static int readData(CTransaction * transaction, uint8_t *buf, int buflen) {
   //int ret = transaction->_stream->read(buf, buflen);
   int ret = read_buffer(buf, buflen, transaction->_stream);
-  transaction->_crc = crc32(transaction->_crc, buf, ret);
+  if (ret > 0) {
+    transaction->_crc = update_crc32((uint32_t)transaction->_crc, buf, ret);
+  }
   return ret;
 }
 
@@ -396,10 +400,12 @@ typedef struct {
   const attribute_set * _attributes;
   CTransaction* transaction_;
   const char * payload_;
+  uint64_t payload_size_;
 } CDataPacket;
 
 static void initPacket(CDataPacket * packet, CTransaction* transaction, const attribute_set * attributes, const char * payload) {
   packet->payload_ = payload;
+  packet->payload_size_ = payload != NULL ? strlen(payload) : 0;
   packet->transaction_ = transaction;
   packet->_attributes = attributes;
 }
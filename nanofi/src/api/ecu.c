@@ -98,6 +98,34 @@ int validate_input_params(tailfile_input_params * params, uint64_t * intrvl, uin
     return 0;
 }
 
+int parse_delimiter(const char * delimiter, char * delim) {
+    if (!delimiter || strlen(delimiter) == 0) {
+        return -1;
+    }
+
+    *delim = delimiter[0];
+
+    if (*delim == '\\' && strlen(delimiter) > 1) {
+        switch (delimiter[1]) {
+            case 'r':
+                *delim = '\r';
+                break;
+            case 't':
+                *delim = '\t';
+                break;
+            case 'n':
+                *delim = '\n';
+                break;
+            case '\\':
+                *delim = '\\';
+                break;
+            default:
+                break;
+        }
+    }
+    return 0;
+}
+
 void setup_signal_action() {
     struct sigaction action;
     memset(&action, 0, sizeof(sigaction));
@@ -368,7 +396,8 @@ struct proc_properties * get_properties(const char * uuid, processor_context * c
         return props;
     }
 
-    if (strlen(delimiter) == 0) {
+    char delim;
+    if (parse_delimiter(delimiter, &delim) != 0) {
         printf("Delimiter not specified or it is empty\n");
         return props;
     }
@@ -376,29 +405,6 @@ struct proc_properties * get_properties(const char * uuid, processor_context * c
     props = (struct proc_properties *)malloc(sizeof(struct proc_properties));
     memset(props, 0, sizeof(struct proc_properties));
 
-    char delim = delimiter[0];
-
-    if (delim == '\\') {
-          if (strlen(delimiter) > 1) {
-            switch (delimiter[1]) {
-              case 'r':
-                delim = '\r';
-                break;
-              case 't':
-                delim = '\t';
-                break;
-              case 'n':
-                delim = '\n';
-                break;
-              case '\\':
-                delim = '\\';
-                break;
-              default:
-                break;
-            }
-        }
-    }
-
     int len = strlen(file_path);
     props->file_path = (char *)malloc((len + 1) * sizeof(char));
     strncpy(props->file_path, file_path, len);
@@ -528,3 +534,102 @@ void on_trigger_tailfiledelimited(processor_session * ps, processor_context * ct
     }
     fclose(fp);
 }
+
+#define TAILER_BUFFER_SIZE 65536
+#define PAYLOAD_BATCH_SIZE 256
+
+void init_payload_batch(payload_batch * batch, struct CRawSiteToSiteClient * client, const char * file_path, size_t capacity) {
+    memset(batch, 0, sizeof(payload_batch));
+    batch->client = client;
+    batch->file_path = file_path;
+    batch->capacity = capacity;
+    batch->payloads = (const char **)malloc(capacity * sizeof(const char *));
+    batch->sizes = (uint64_t *)malloc(capacity * sizeof(uint64_t));
+    batch->attribute_sets = (attribute_set *)malloc(capacity * sizeof(attribute_set));
+    batch->attributes = (attribute *)malloc(2 * capacity * sizeof(attribute));
+    batch->offsets = (char (*)[21])malloc(capacity * sizeof(*batch->offsets));
+
+    // only the offset differs between payloads, everything else is set up once
+    size_t i;
+    for (i = 0; i < capacity; ++i) {
+        attribute * attrs = &batch->attributes[2 * i];
+        attrs[0].key = "current offset";
+        attrs[0].value = batch->offsets[i];
+        attrs[1].key = "tailfile path";
+        attrs[1].value = (void *)file_path;
+        attrs[1].value_size = strlen(file_path);
+        batch->attribute_sets[i].attributes = attrs;
+        batch->attribute_sets[i].size = 2;
+    }
+}
+
+void add_to_payload_batch(const char * data, size_t len, uint64_t offset, void * user) {
+    payload_batch * batch = (payload_batch *)user;
+    if (batch->count == batch->capacity) {
+        flush_payload_batch(batch);
+    }
+    size_t i = batch->count++;
+    batch->payloads[i] = data;
+    batch->sizes[i] = len;
+    int offset_len = snprintf(batch->offsets[i], sizeof(batch->offsets[i]), "%llu", (unsigned long long)offset);
+    batch->attributes[2 * i].value_size = offset_len;
+}
+
+int flush_payload_batch(payload_batch * batch) {
+    if (batch->count == 0) {
+        return 0;
+    }
+    int ret = -1;
+    if (batch->client) {
+        ret = transmitPayloads(batch->client, (const char * const *)batch->payloads, batch->sizes, batch->attribute_sets, batch->count);
+    }
+    if (ret != 0) {
+        printf("Failed to send %zu payloads from %s\n", batch->count, batch->file_path);
+    }
+    batch->count = 0;
+    return ret;
+}
+
+void free_payload_batch(payload_batch * batch) {
+    free(batch->payloads);
+    free(batch->sizes);
+    free(batch->attribute_sets);
+    free(batch->attributes);
+    free(batch->offsets);
+    memset(batch, 0, sizeof(payload_batch));
+}
+
+void tail_and_transmit(const char * file_path, char delim, uint64_t chunk_size, uint64_t interval_ms, struct CRawSiteToSiteClient * client) {
+    file_tailer tailer;
+    size_t capacity = chunk_size > TAILER_BUFFER_SIZE ? chunk_size : TAILER_BUFFER_SIZE;
+    if (init_file_tailer(&tailer, file_path, capacity) < 0) {
+        printf("Unable to open file. {file: %s, reason: %s}\n", file_path, strerror(errno));
+        return;
+    }
+
+    payload_batch batch;
+    init_payload_batch(&batch, client, file_path, PAYLOAD_BATCH_SIZE);
+
+    while (!stopped) {
+        int ret;
+        // the batch points into the tailer's buffer, so it is sent after every read
+        do {
+            if (chunk_size > 0) {
+                ret = tail_chunks(&tailer, chunk_size, add_to_payload_batch, &batch);
+            } else {
+                ret = tail_delimited(&tailer, delim, add_to_payload_batch, &batch);
+            }
+            flush_payload_batch(&batch);
+        } while (ret > 0 && !stopped);
+
+        if (ret < 0) {
+            printf("Error reading file. {file: %s, reason: %s}\n", file_path, strerror(errno));
+        }
+        if (!stopped) {
+            wait_for_file_change(&tailer, interval_ms);
+        }
+    }
+
+    free_payload_batch(&batch);
+    free_file_tailer(&tailer);
+}
@@ -0,0 +1,273 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+#include "core/file_tailer.h"
+
+static const char * file_name(const char * path) {
+    const char * sep = strrchr(path, '/');
+    return sep ? sep + 1 : path;
+}
+
+static int open_tailed_file(file_tailer * tailer) {
+    int fd = open(tailer->file_path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat stats;
+    if (fstat(fd, &stats) < 0) {
+        close(fd);
+        return -1;
+    }
+    tailer->fd = fd;
+    tailer->device = stats.st_dev;
+    tailer->inode = stats.st_ino;
+    tailer->offset = 0;
+    tailer->begin = 0;
+    tailer->end = 0;
+#ifdef __linux__
+    if (tailer->notify_fd >= 0) {
+        if (tailer->file_watch >= 0) {
+            inotify_rm_watch(tailer->notify_fd, tailer->file_watch);
+        }
+        tailer->file_watch = inotify_add_watch(tailer->notify_fd, tailer->file_path, IN_MODIFY);
+    }
+#endif
+    return 0;
+}
+
+int init_file_tailer(file_tailer * tailer, const char * file_path, size_t capacity) {
+    memset(tailer, 0, sizeof(file_tailer));
+    tailer->fd = -1;
+    tailer->notify_fd = -1;
+    tailer->file_watch = -1;
+    tailer->dir_watch = -1;
+    if (!file_path || capacity == 0) {
+        return -1;
+    }
+
+    size_t len = strlen(file_path);
+    tailer->file_path = (char *)malloc(len + 1);
+    strcpy(tailer->file_path, file_path);
+    // one spare byte so that a token filling the whole buffer can be terminated
+    tailer->buffer = (char *)malloc(capacity + 1);
+    tailer->capacity = capacity;
+
+#ifdef __linux__
+    tailer->notify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (tailer->notify_fd >= 0) {
+        // the directory is watched so that a rotated file's replacement wakes us up
+        const char * name = file_name(file_path);
+        size_t dir_len = name - file_path;
+        char * dir = (char *)malloc(dir_len + 2);
+        if (dir_len == 0) {
+            strcpy(dir, ".");
+        } else {
+            memcpy(dir, file_path, dir_len);
+            dir[dir_len] = '\0';
+        }
+        tailer->dir_watch = inotify_add_watch(tailer->notify_fd, dir, IN_CREATE | IN_MOVED_TO);
+        free(dir);
+    }
+#endif
+
+    if (open_tailed_file(tailer) < 0) {
+        free_file_tailer(tailer);
+        return -1;
+    }
+    return 0;
+}
+
+void free_file_tailer(file_tailer * tailer) {
+    if (tailer->fd >= 0) {
+        close(tailer->fd);
+        tailer->fd = -1;
+    }
+    if (tailer->notify_fd >= 0) {
+        close(tailer->notify_fd);
+        tailer->notify_fd = -1;
+    }
+    free(tailer->buffer);
+    tailer->buffer = NULL;
+    free(tailer->file_path);
+    tailer->file_path = NULL;
+}
+
+static void compact(file_tailer * tailer) {
+    if (tailer->begin > 0) {
+        memmove(tailer->buffer, tailer->buffer + tailer->begin, tailer->end - tailer->begin);
+        tailer->end -= tailer->begin;
+        tailer->begin = 0;
+    }
+}
+
+static ssize_t read_available(file_tailer * tailer) {
+    ssize_t bytes;
+    do {
+        bytes = read(tailer->fd, tailer->buffer + tailer->end, tailer->capacity - tailer->end);
+    } while (bytes < 0 && errno == EINTR);
+    return bytes;
+}
+
+static void flush_remaining(file_tailer * tailer, tailer_callback callback, void * user) {
+    size_t len = tailer->end - tailer->begin;
+    if (len > 0) {
+        tailer->buffer[tailer->end] = '\0';
+        tailer->offset += len;
+        callback(tailer->buffer + tailer->begin, len, tailer->offset, user);
+    }
+    tailer->begin = tailer->end = 0;
+}
+
+/**
+ * Called once the open file is drained. A file whose path now names another
+ * inode has been rotated and can no longer grow, so whatever it still holds
+ * is handed out before the new file is opened. A file that shrank below what
+ * was already read has been truncated and is read again from the beginning.
+ */
+static int reopen_if_rotated(file_tailer * tailer, tailer_callback callback, void * user) {
+    struct stat current;
+    if (fstat(tailer->fd, &current) < 0) {
+        return -1;
+    }
+    struct stat named;
+    int rotated = stat(tailer->file_path, &named) == 0 && (named.st_ino != tailer->inode || named.st_dev != tailer->device);
+    uint64_t read_position = tailer->offset + (tailer->end - tailer->begin);
+    if (!rotated && (uint64_t)current.st_size >= read_position) {
+        return 0;
+    }
+
+    flush_remaining(tailer, callback, user);
+    if (rotated) {
+        int old_fd = tailer->fd;
+        if (open_tailed_file(tailer) < 0) {
+            return -1;
+        }
+        close(old_fd);
+    } else {
+        if (lseek(tailer->fd, 0, SEEK_SET) < 0) {
+            return -1;
+        }
+        tailer->offset = 0;
+    }
+    return 1;
+}
+
+int tail_delimited(file_tailer * tailer, char delim, tailer_callback callback, void * user) {
+    compact(tailer);
+    if (tailer->end == tailer->capacity) {
+        // no delimiter in a full buffer, hand it out rather than stall
+        flush_remaining(tailer, callback, user);
+        return 1;
+    }
+
+    ssize_t bytes = read_available(tailer);
+    if (bytes < 0) {
+        return -1;
+    }
+    if (bytes == 0) {
+        return reopen_if_rotated(tailer, callback, user);
+    }
+
+    char * scan = tailer->buffer + tailer->end;
+    char * last = scan + bytes;
+    tailer->end += bytes;
+    char * delimiter;
+    while ((delimiter = (char *)memchr(scan, delim, last - scan)) != NULL) {
+        char * token = tailer->buffer + tailer->begin;
+        size_t len = delimiter - token;
+        *delimiter = '\0';
+        tailer->begin += len + 1;
+        tailer->offset += len + 1;
+        if (len > 0) {
+            callback(token, len, tailer->offset, user);
+        }
+        scan = delimiter + 1;
+    }
+    return 1;
+}
+
+int tail_chunks(file_tailer * tailer, size_t chunk_size, tailer_callback callback, void * user) {
+    if (chunk_size == 0 || chunk_size > tailer->capacity) {
+        return -1;
+    }
+    compact(tailer);
+
+    ssize_t bytes = read_available(tailer);
+    if (bytes < 0) {
+        return -1;
+    }
+    if (bytes == 0) {
+        return reopen_if_rotated(tailer, callback, user);
+    }
+
+    tailer->end += bytes;
+    while (tailer->end - tailer->begin >= chunk_size) {
+        const char * chunk = tailer->buffer + tailer->begin;
+        tailer->begin += chunk_size;
+        tailer->offset += chunk_size;
+        callback(chunk, chunk_size, tailer->offset, user);
+    }
+    return 1;
+}
+
+int wait_for_file_change(file_tailer * tailer, uint64_t timeout_ms) {
+    int timeout = timeout_ms > INT_MAX ? INT_MAX : (int)timeout_ms;
+#ifdef __linux__
+    if (tailer->notify_fd >= 0) {
+        struct pollfd pfd;
+        pfd.fd = tailer->notify_fd;
+        pfd.events = POLLIN;
+        int ret = poll(&pfd, 1, timeout);
+        if (ret <= 0) {
+            return ret < 0 && errno != EINTR ? -1 : 0;
+        }
+
+        char events[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+        ssize_t len = read(tailer->notify_fd, events, sizeof(events));
+        if (len < 0) {
+            return errno == EAGAIN || errno == EINTR ? 0 : -1;
+        }
+
+        // the directory watch reports every file in it, only ours counts
+        int changed = 0;
+        const char * name = file_name(tailer->file_path);
+        const char * ptr;
+        for (ptr = events; ptr < events + len; ptr += sizeof(struct inotify_event) + ((const struct inotify_event *)ptr)->len) {
+            const struct inotify_event * event = (const struct inotify_event *)ptr;
+            if (event->wd != tailer->dir_watch || (event->len > 0 && strcmp(event->name, name) == 0)) {
+                changed = 1;
+            }
+        }
+        return changed;
+    }
+#endif
+    poll(NULL, 0, timeout);
+    return 0;
+}
@@ -389,12 +389,22 @@ CTransaction* createTransaction(struct CRawSiteToSiteClient * client, TransferDi
 }
 
 int transmitPayload(struct CRawSiteToSiteClient * client, const char * payload, const attribute_set * attributes) {
-  CTransaction* transaction = NULL;
-
   if (payload == NULL && attributes == NULL) {
     return -1;
   }
 
+  uint64_t size = payload != NULL ? strlen(payload) : 0;
+  return transmitPayloads(client, &payload, &size, attributes, 1);
+}
+
+int transmitPayloads(struct CRawSiteToSiteClient * client, const char * const * payloads, const uint64_t * sizes, const attribute_set * attributes, size_t count) {
+  CTransaction* transaction = NULL;
+  attribute_set no_attributes = { NULL, 0 };
+
+  if (count == 0) {
+    return 0;
+  }
+
   if (client->_peer_state != READY) {
     if (bootstrap(client) != 0) {
       return -1;
@@ -416,18 +426,25 @@ int transmitPayload(struct CRawSiteToSiteClient * client, const char * payload,
 
   transactionID = getUUIDStr(transaction);
 
-  CDataPacket packet;
-
-  initPacket(&packet, transaction, attributes, payload);
-
-  int16_t resp = sendPacket(client, transactionID, &packet, NULL);
-  if (resp != 0) {
-    deleteTransaction(client, transactionID);
-    tearDown(client);
-    return resp;
+  // every packet after the first continues the same transaction, so the
+  // confirmation round trip is paid once per batch
+  uint64_t bytes = 0;
+  size_t i;
+  for (i = 0; i < count; ++i) {
+    CDataPacket packet;
+    initPacket(&packet, transaction, attributes != NULL ? &attributes[i] : &no_attributes, NULL);
+    packet.payload_ = payloads[i];
+    packet.payload_size_ = sizes[i];
+
+    int16_t resp = sendPacket(client, transactionID, &packet, NULL);
+    if (resp != 0) {
+      deleteTransaction(client, transactionID);
+      tearDown(client);
+      return resp;
+    }
+    bytes += sizes[i];
   }
-  logc(info, "Site2Site transaction %s sent bytes length %lu", transactionID, strlen(payload));
-
+  logc(info, "Site2Site transaction %s sent %lu packets, bytes length %llu", transactionID, count, bytes);
 
   int ret = confirm(client, transactionID);
 
@@ -735,8 +752,8 @@ int confirm(struct CRawSiteToSiteClient * client, const char * transactionID) {
         writeData(transaction, content_buf, len);
       }
 
-    } else if (packet->payload_ != NULL && strlen(packet->payload_) > 0) {
-      len = strlen(packet->payload_);
+    } else if (packet->payload_ != NULL && packet->payload_size_ > 0) {
+      len = packet->payload_size_;
 
       ret = write_uint64t(transaction, len);
       if (ret != 8) {
@@ -0,0 +1,292 @@
+/**
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The ASF licenses this file to You under the Apache License, Version 2.0
+ * (the "License"); you may not use this file except in compliance with
+ * the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "catch.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+#include "CTestsBase.h"
+#include "core/file_tailer.h"
+#include "core/string_utils.h"
+
+#ifdef __GLIBC__
+/**
+ * Counts heap allocations so that the benchmark can report allocations per
+ * line; everything is forwarded to the glibc allocator.
+ */
+static volatile uint64_t allocations = 0;
+
+extern "C" {
+void * __libc_malloc(size_t size);
+void * __libc_calloc(size_t count, size_t size);
+void * __libc_realloc(void * ptr, size_t size);
+void __libc_free(void * ptr);
+
+void * malloc(size_t size) {
+    allocations = allocations + 1;
+    return __libc_malloc(size);
+}
+
+void * calloc(size_t count, size_t size) {
+    allocations = allocations + 1;
+    return __libc_calloc(count, size);
+}
+
+void * realloc(void * ptr, size_t size) {
+    allocations = allocations + 1;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void * ptr) {
+    __libc_free(ptr);
+}
+}
+#endif
+
+/****
+ * ##################################################################
+ *  FILE TAILER TESTS
+ * ##################################################################
+ */
+
+typedef std::vector<std::pair<std::string, uint64_t>> tokens;
+
+static void collect(const char * data, size_t len, uint64_t offset, void * user) {
+    static_cast<tokens *>(user)->emplace_back(std::string(data, len), offset);
+}
+
+static void tail_all(file_tailer * tailer, char delim, tokens * out) {
+    int ret;
+    while ((ret = tail_delimited(tailer, delim, collect, out)) > 0) {
+    }
+    REQUIRE(ret == 0);
+}
+
+TEST_CASE("Test file tailer hands out delimited tokens", "[fileTailerDelimited]") {
+    const char * file = "./tailer.txt";
+    FileManager fm(file);
+    fm.Write("aaa;bb;;c");
+    fm.CloseStream();
+
+    file_tailer tailer;
+    REQUIRE(init_file_tailer(&tailer, file, 64) == 0);
+
+    tokens out;
+    tail_all(&tailer, ';', &out);
+    REQUIRE(out.size() == 2);
+    REQUIRE(out[0] == std::make_pair(std::string("aaa"), (uint64_t)4));
+    REQUIRE(out[1] == std::make_pair(std::string("bb"), (uint64_t)7));
+
+    // the partial token is held until its delimiter arrives
+    fm.OpenStream();
+    fm.Write("cc;");
+    fm.CloseStream();
+    tail_all(&tailer, ';', &out);
+    REQUIRE(out.size() == 3);
+    REQUIRE(out[2] == std::make_pair(std::string("ccc"), (uint64_t)12));
+
+    free_file_tailer(&tailer);
+}
+
+TEST_CASE("Test file tailer splits tokens longer than its buffer", "[fileTailerLongToken]") {
+    const char * file = "./tailer.txt";
+    FileManager fm(file);
+    fm.WriteNChars(20, 'a');
+    fm.Write(";");
+    fm.CloseStream();
+
+    file_tailer tailer;
+    REQUIRE(init_file_tailer(&tailer, file, 8) == 0);
+
+    tokens out;
+    tail_all(&tailer, ';', &out);
+    REQUIRE(out.size() == 3);
+    REQUIRE(out[0].first == std::string(8, 'a'));
+    REQUIRE(out[1].first == std::string(8, 'a'));
+    REQUIRE(out[2] == std::make_pair(std::string(4, 'a'), (uint64_t)21));
+
+    free_file_tailer(&tailer);
+}
+
+TEST_CASE("Test file tailer follows a rotated file", "[fileTailerRotation]") {
+    const char * file = "./tailer.txt";
+    const char * rotated = "./tailer.txt.1";
+    FileManager fm(file);
+    fm.Write("one\ntwo");
+    fm.CloseStream();
+
+    file_tailer tailer;
+    REQUIRE(init_file_tailer(&tailer, file, 64) == 0);
+
+    tokens out;
+    tail_all(&tailer, '\n', &out);
+    REQUIRE(out.size() == 1);
+
+    REQUIRE(rename(file, rotated) == 0);
+    FileManager replacement(file);
+    replacement.Write("three\n");
+    replacement.CloseStream();
+
+    // the rotated file can no longer grow, so its trailing token is handed out
+    tail_all(&tailer, '\n', &out);
+    REQUIRE(out.size() == 3);
+    REQUIRE(out[1] == std::make_pair(std::string("two"), (uint64_t)7));
+    REQUIRE(out[2] == std::make_pair(std::string("three"), (uint64_t)6));
+
+    free_file_tailer(&tailer);
+    remove(rotated);
+}
+
+TEST_CASE("Test file tailer restarts a truncated file", "[fileTailerTruncation]") {
+    const char * file = "./tailer.txt";
+    FileManager fm(file);
+    fm.Write("abc;def;");
+    fm.CloseStream();
+
+    file_tailer tailer;
+    REQUIRE(init_file_tailer(&tailer, file, 64) == 0);
+
+    tokens out;
+    tail_all(&tailer, ';', &out);
+    REQUIRE(out.size() == 2);
+
+    REQUIRE(truncate(file, 0) == 0);
+    fm.OpenStream();
+    fm.Write("x;");
+    fm.CloseStream();
+
+    tail_all(&tailer, ';', &out);
+    REQUIRE(out.size() == 3);
+    REQUIRE(out[2] == std::make_pair(std::string("x"), (uint64_t)2));
+
+    free_file_tailer(&tailer);
+}
+
+TEST_CASE("Test file tailer hands out complete chunks", "[fileTailerChunks]") {
+    const char * file = "./tailer.txt";
+    FileManager fm(file);
+    fm.Write("0123456789");
+    fm.CloseStream();
+
+    file_tailer tailer;
+    REQUIRE(init_file_tailer(&tailer, file, 16) == 0);
+
+    tokens out;
+    while (tail_chunks(&tailer, 4, collect, &out) > 0) {
+    }
+    REQUIRE(out.size() == 2);
+    REQUIRE(out[0] == std::make_pair(std::string("0123"), (uint64_t)4));
+    REQUIRE(out[1] == std::make_pair(std::string("4567"), (uint64_t)8));
+
+    fm.OpenStream();
+    fm.Write("ab");
+    fm.CloseStream();
+    while (tail_chunks(&tailer, 4, collect, &out) > 0) {
+    }
+    REQUIRE(out.size() == 3);
+    REQUIRE(out[2] == std::make_pair(std::string("89ab"), (uint64_t)12));
+
+    REQUIRE(tail_chunks(&tailer, 17, collect, &out) == -1);
+    free_file_tailer(&tailer);
+}
+
+#ifdef __linux__
+TEST_CASE("Test file tailer wakes up when the file changes", "[fileTailerWait]") {
+    const char * file = "./tailer.txt";
+    FileManager fm(file);
+    fm.CloseStream();
+
+    file_tailer tailer;
+    REQUIRE(init_file_tailer(&tailer, file, 64) == 0);
+
+    REQUIRE(wait_for_file_change(&tailer, 10) == 0);
+
+    fm.OpenStream();
+    fm.Write("line\n");
+    fm.CloseStream();
+
+    auto before = std::chrono::steady_clock::now();
+    REQUIRE(wait_for_file_change(&tailer, 10000) == 1);
+    REQUIRE(std::chrono::steady_clock::now() - before < std::chrono::seconds(5));
+
+    free_file_tailer(&tailer);
+}
+#endif
+
+static void count_line(const char * data, size_t len, uint64_t offset, void * user) {
+    ++*static_cast<uint64_t *>(user);
+}
+
+TEST_CASE("Test file tailer throughput", "[fileTailerBenchmark][.][benchmark]") {
+    const char * file = "./tailer.txt";
+    const uint64_t lines = 200000;
+    FileManager fm(file);
+    std::string line = std::string(79, 'x') + ";";
+    for (uint64_t i = 0; i < lines; ++i) {
+        fm.Write(line);
+    }
+    fm.CloseStream();
+
+    // tailed in place into a preallocated batch, as the ECU tools send them
+    file_tailer tailer;
+    REQUIRE(init_file_tailer(&tailer, file, 65536) == 0);
+    payload_batch batch;
+    init_payload_batch(&batch, NULL, file, 1024);
+
+    uint64_t tailed = 0;
+    uint64_t allocations_before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    while (tail_delimited(&tailer, ';', add_to_payload_batch, &batch) > 0) {
+        tailed += batch.count;
+        batch.count = 0;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t tailer_allocations = allocations - allocations_before;
+    free_payload_batch(&batch);
+    free_file_tailer(&tailer);
+    REQUIRE(tailed == lines);
+
+    // the processor path the ECU tools used before, on a tenth of the file
+    TailFileTestResourceManager mgr("TailFileDelimited", on_trigger_tailfiledelimited);
+    const uint64_t legacy_lines = lines / 10;
+    FileManager legacy_fm(file);
+    for (uint64_t i = 0; i < legacy_lines; ++i) {
+        legacy_fm.Write(line);
+    }
+    legacy_fm.CloseStream();
+
+    allocations_before = allocations;
+    start = std::chrono::steady_clock::now();
+    auto pp = invoke_processor(mgr, file);
+    double legacy_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t legacy_allocations = allocations - allocations_before;
+    REQUIRE(pp != NULL);
+    REQUIRE(flow_files_size(pp->ff_list) == legacy_lines);
+
+    printf("file tailer: %.0f lines/s, %.4f allocations/line\n", lines / seconds, (double)tailer_allocations / lines);
+    printf("tailfile delimited processor: %.0f lines/s, %.4f allocations/line\n", legacy_lines / legacy_seconds,
+           (double)legacy_allocations / legacy_lines);
+#ifdef __GLIBC__
+    REQUIRE(tailer_allocations == 0);
+#endif
+}